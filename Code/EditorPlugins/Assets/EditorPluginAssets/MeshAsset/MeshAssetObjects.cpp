@@ -19,6 +19,9 @@ EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezMeshAssetProperties, 3, ezRTTIDefaultAllocator
     EZ_MEMBER_PROPERTY("RecalculateTangents", m_bRecalculateTrangents)->AddAttributes(new ezDefaultValueAttribute(true)),
     EZ_ENUM_MEMBER_PROPERTY("NormalPrecision", ezMeshNormalPrecision, m_NormalPrecision),
     EZ_ENUM_MEMBER_PROPERTY("TexCoordPrecision", ezMeshTexCoordPrecision, m_TexCoordPrecision),
+    EZ_MEMBER_PROPERTY("OptimizeMesh", m_bOptimizeMesh)->AddAttributes(new ezDefaultValueAttribute(true)),
+    EZ_MEMBER_PROPERTY("QuantizeVertices", m_bQuantizeVertices),
+    EZ_MEMBER_PROPERTY("Lods", m_uiNumLods)->AddAttributes(new ezDefaultValueAttribute(1), new ezClampValueAttribute(1, 8)),
     EZ_MEMBER_PROPERTY("ImportMaterials", m_bImportMaterials)->AddAttributes(new ezDefaultValueAttribute(true)),
     EZ_MEMBER_PROPERTY("Radius", m_fRadius)->AddAttributes(new ezDefaultValueAttribute(0.5f), new ezClampValueAttribute(0.0f, ezVariant())),
     EZ_MEMBER_PROPERTY("Radius2", m_fRadius2)->AddAttributes(new ezDefaultValueAttribute(0.5f), new ezClampValueAttribute(0.0f, ezVariant())),
@@ -87,12 +90,18 @@ void ezMeshAssetProperties::PropertyMetaStateEventHandler(ezPropertyMetaStateEve
     props["Cap2"].m_Visibility = ezPropertyUiState::Invisible;
     props["Angle"].m_Visibility = ezPropertyUiState::Invisible;
     props["ImportMaterials"].m_Visibility = ezPropertyUiState::Invisible;
+    props["OptimizeMesh"].m_Visibility = ezPropertyUiState::Invisible;
+    props["QuantizeVertices"].m_Visibility = ezPropertyUiState::Invisible;
+    props["Lods"].m_Visibility = ezPropertyUiState::Invisible;
 
     switch (primType)
     {
       case ezMeshPrimitive::File:
         props["MeshFile"].m_Visibility = ezPropertyUiState::Default;
         props["ImportMaterials"].m_Visibility = ezPropertyUiState::Default;
+        props["OptimizeMesh"].m_Visibility = ezPropertyUiState::Default;
+        props["QuantizeVertices"].m_Visibility = ezPropertyUiState::Default;
+        props["Lods"].m_Visibility = ezPropertyUiState::Default;
         break;
 
       case ezMeshPrimitive::Box:
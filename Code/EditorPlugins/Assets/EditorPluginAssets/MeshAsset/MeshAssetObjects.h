@@ -66,6 +66,10 @@ public:
   ezEnum<ezMeshNormalPrecision> m_NormalPrecision;
   ezEnum<ezMeshTexCoordPrecision> m_TexCoordPrecision;
 
+  bool m_bOptimizeMesh = true;
+  bool m_bQuantizeVertices = false;
+  ezUInt32 m_uiNumLods = 1;
+
   ezHybridArray<ezMaterialResourceSlot, 8> m_Slots;
 
   ezUInt32 m_uiVertices = 0;
@@ -4,6 +4,7 @@
 
 #include <Core/Assets/AssetFileHeader.h>
 #include <EditorEngineProcessFramework/EngineProcess/EngineProcessDocumentContext.h>
+#include <Foundation/IO/FileSystem/FileReader.h>
 #include <Foundation/IO/FileSystem/FileWriter.h>
 #include <Foundation/Utilities/Progress.h>
 
@@ -39,7 +40,19 @@ ezResult ezLongOpWorker_BuildNavMesh::Execute(ezProgress& progress, ezStreamWrit
   if (!pgRange.BeginNextStep("Building NavMesh"))
     return EZ_FAILURE;
 
-  EZ_SUCCEED_OR_RETURN(NavMeshBuilder.Build(m_NavMeshConfig, m_ExtractedObjects, desc, progress));
+  // tiles of the previous build whose input did not change are reused, instead of generating them again
+  ezRecastNavMeshResourceDescriptor previousDesc;
+  bool bHasPreviousBuild = false;
+  {
+    ezFileReader previousFile;
+    if (previousFile.Open(m_sOutputPath).Succeeded())
+    {
+      ezAssetFileHeader header;
+      bHasPreviousBuild = header.Read(previousFile).Succeeded() && previousDesc.Deserialize(previousFile).Succeeded();
+    }
+  }
+
+  EZ_SUCCEED_OR_RETURN(NavMeshBuilder.Build(m_NavMeshConfig, m_ExtractedObjects, desc, progress, bHasPreviousBuild ? &previousDesc : nullptr));
 
   if (!pgRange.BeginNextStep("Writing Result"))
     return EZ_FAILURE;
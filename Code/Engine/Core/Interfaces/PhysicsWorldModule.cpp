@@ -59,5 +59,37 @@ EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezMsgBuildStaticMesh, 1, ezRTTIDefaultAllocator<
 EZ_END_DYNAMIC_REFLECTED_TYPE;
 // clang-format on
 
+//////////////////////////////////////////////////////////////////////////
+
+ezUInt32 ezPhysicsWorldModuleInterface::RaycastBatch(ezArrayPtr<const ezPhysicsRaycastRequest> rays, ezArrayPtr<ezPhysicsCastResult> out_Results, ezArrayPtr<bool> out_Hits, const ezPhysicsQueryParameters& params, ezPhysicsHitCollection collection) const
+{
+  EZ_ASSERT_DEV(out_Results.GetCount() == rays.GetCount() && out_Hits.GetCount() == rays.GetCount(), "Result arrays must have the same size as the ray array");
+
+  ezUInt32 uiNumHits = 0;
+  for (ezUInt32 i = 0; i < rays.GetCount(); ++i)
+  {
+    const ezPhysicsRaycastRequest& ray = rays[i];
+    out_Hits[i] = Raycast(out_Results[i], ray.m_vStart, ray.m_vDir, ray.m_fDistance, params, collection);
+    uiNumHits += out_Hits[i] ? 1 : 0;
+  }
+
+  return uiNumHits;
+}
+
+ezUInt32 ezPhysicsWorldModuleInterface::SweepTestSphereBatch(ezArrayPtr<const ezPhysicsSweepSphereRequest> sweeps, ezArrayPtr<ezPhysicsCastResult> out_Results, ezArrayPtr<bool> out_Hits, const ezPhysicsQueryParameters& params, ezPhysicsHitCollection collection) const
+{
+  EZ_ASSERT_DEV(out_Results.GetCount() == sweeps.GetCount() && out_Hits.GetCount() == sweeps.GetCount(), "Result arrays must have the same size as the sweep array");
+
+  ezUInt32 uiNumHits = 0;
+  for (ezUInt32 i = 0; i < sweeps.GetCount(); ++i)
+  {
+    const ezPhysicsSweepSphereRequest& sweep = sweeps[i];
+    out_Hits[i] = SweepTestSphere(out_Results[i], sweep.m_fSphereRadius, sweep.m_vStart, sweep.m_vDir, sweep.m_fDistance, params, collection);
+    uiNumHits += out_Hits[i] ? 1 : 0;
+  }
+
+  return uiNumHits;
+}
+
 
 EZ_STATICLINK_FILE(Core, Core_Interfaces_PhysicsWorldModule);
@@ -87,6 +87,27 @@ enum class ezPhysicsHitCollection
   Any
 };
 
+/// \brief A single ray for ezPhysicsWorldModuleInterface::RaycastBatch()
+struct ezPhysicsRaycastRequest
+{
+  EZ_DECLARE_POD_TYPE();
+
+  ezVec3 m_vStart;
+  ezVec3 m_vDir; ///< Must be normalized.
+  float m_fDistance;
+};
+
+/// \brief A single sphere sweep for ezPhysicsWorldModuleInterface::SweepTestSphereBatch()
+struct ezPhysicsSweepSphereRequest
+{
+  EZ_DECLARE_POD_TYPE();
+
+  ezVec3 m_vStart;
+  ezVec3 m_vDir; ///< Must be normalized.
+  float m_fDistance;
+  float m_fSphereRadius;
+};
+
 class EZ_CORE_DLL ezPhysicsWorldModuleInterface : public ezWorldModule
 {
   EZ_ADD_DYNAMIC_REFLECTION(ezPhysicsWorldModuleInterface, ezWorldModule);
@@ -114,6 +135,19 @@ public:
 
   virtual void QueryShapesInSphere(ezPhysicsOverlapResultArray& out_Results, float fSphereRadius, const ezVec3& vPosition, const ezPhysicsQueryParameters& params) const = 0;
 
+  /// \brief Casts many rays with the same query parameters at once.
+  ///
+  /// out_Results and out_Hits must have the same size as \a rays. For every ray that hits something, out_Hits is set to true and
+  /// out_Results holds the hit, otherwise out_Hits is set to false and the result is left untouched.
+  /// Returns the number of rays that hit something.
+  ///
+  /// The default implementation calls Raycast() for every ray. Physics integrations should override this to share the query setup
+  /// between rays and to distribute large batches across worker threads.
+  virtual ezUInt32 RaycastBatch(ezArrayPtr<const ezPhysicsRaycastRequest> rays, ezArrayPtr<ezPhysicsCastResult> out_Results, ezArrayPtr<bool> out_Hits, const ezPhysicsQueryParameters& params, ezPhysicsHitCollection collection = ezPhysicsHitCollection::Closest) const;
+
+  /// \brief Same as RaycastBatch(), but sweeps spheres instead. The default implementation calls SweepTestSphere() for every sweep.
+  virtual ezUInt32 SweepTestSphereBatch(ezArrayPtr<const ezPhysicsSweepSphereRequest> sweeps, ezArrayPtr<ezPhysicsCastResult> out_Results, ezArrayPtr<bool> out_Hits, const ezPhysicsQueryParameters& params, ezPhysicsHitCollection collection = ezPhysicsHitCollection::Closest) const;
+
   virtual ezVec3 GetGravity() const = 0;
 
   virtual void AddStaticCollisionBox(ezGameObject* pObject, ezVec3 boxSize) {}
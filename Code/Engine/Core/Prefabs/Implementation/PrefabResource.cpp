@@ -47,7 +47,49 @@ void ezPrefabResource::InstantiatePrefab(ezWorld& world, const ezTransform& root
   }
 }
 
-void ezPrefabResource::ApplyExposedParameterValues(const ezArrayMap<ezHashedString, ezVariant>* pExposedParamValues, const ezDynamicArray<ezGameObject*>& createdChildObjects, const ezDynamicArray<ezGameObject*>& createdRootObjects) const
+void ezPrefabResource::InstantiatePrefabs(ezWorld& world, ezArrayPtr<const ezTransform> rootTransforms, ezPrefabInstantiationOptions options, const ezArrayMap<ezHashedString, ezVariant>* pExposedParamValues)
+{
+  if (GetLoadingState() != ezResourceState::Loaded)
+    return;
+
+  if (pExposedParamValues != nullptr && !pExposedParamValues->IsEmpty())
+  {
+    ezDynamicArray<ezGameObject*> createdRootObjects;
+    ezDynamicArray<ezGameObject*> createdChildObjects;
+
+    if (options.m_pCreatedRootObjectsOut == nullptr)
+    {
+      options.m_pCreatedRootObjectsOut = &createdRootObjects;
+    }
+
+    if (options.m_pCreatedChildObjectsOut == nullptr)
+    {
+      options.m_pCreatedChildObjectsOut = &createdChildObjects;
+    }
+
+    const ezUInt32 uiFirstRootObject = options.m_pCreatedRootObjectsOut->GetCount();
+    const ezUInt32 uiFirstChildObject = options.m_pCreatedChildObjectsOut->GetCount();
+
+    m_WorldReader.InstantiatePrefabs(world, rootTransforms, options);
+
+    const ezUInt32 uiNumRootObjects = m_WorldReader.GetRootObjectCount();
+    const ezUInt32 uiNumChildObjects = m_WorldReader.GetChildObjectCount();
+
+    for (ezUInt32 i = 0; i < rootTransforms.GetCount(); ++i)
+    {
+      const ezArrayPtr<ezGameObject* const> rootObjects = options.m_pCreatedRootObjectsOut->GetArrayPtr().GetSubArray(uiFirstRootObject + i * uiNumRootObjects, uiNumRootObjects);
+      const ezArrayPtr<ezGameObject* const> childObjects = options.m_pCreatedChildObjectsOut->GetArrayPtr().GetSubArray(uiFirstChildObject + i * uiNumChildObjects, uiNumChildObjects);
+
+      ApplyExposedParameterValues(pExposedParamValues, childObjects, rootObjects);
+    }
+  }
+  else
+  {
+    m_WorldReader.InstantiatePrefabs(world, rootTransforms, options);
+  }
+}
+
+void ezPrefabResource::ApplyExposedParameterValues(const ezArrayMap<ezHashedString, ezVariant>* pExposedParamValues, ezArrayPtr<ezGameObject* const> createdChildObjects, ezArrayPtr<ezGameObject* const> createdRootObjects) const
 {
   const ezUInt32 uiNumParamDescs = m_PrefabParamDescs.GetCount();
 
@@ -5,10 +5,12 @@
 #include <Core/CoreDLL.h>
 #include <Foundation/Strings/HashedString.h>
 #include <Foundation/Strings/String.h>
+#include <Foundation/Time/Time.h>
 #include <Foundation/Types/Bitflags.h>
 
 class ezResource;
 class ezResourceManager;
+class ezRTTI;
 class ezResourceTypeLoader;
 class ezStreamReader;
 
@@ -44,9 +46,19 @@ struct ezResourceManagerEvent
   {
     ManagerShuttingDown,      ///< Sent first thing by ezResourceManager::OnEngineShutdown().
     ReloadAllResources,       ///< Sent by ezResourceManager::ReloadAllResources() if any resource got unloaded (not yet reloaded)
+    MemoryBudgetExceeded,     ///< A memory budget was exceeded and resource data is being evicted. See ezResourceManager::SetMemoryBudget().
+                              ///< Sent once when the budget gets exceeded, not every frame.
+    MemoryBudgetRelieved,     ///< The memory usage dropped below the eviction target of a budget that was exceeded before.
   };
 
   Type m_Type;
+
+  /// For the memory budget events: The resource type whose budget is affected, nullptr for the global budget.
+  const ezRTTI* m_pResourceType = nullptr;
+
+  /// For the memory budget events: The memory used by resources that the budget applies to, at the time of the event.
+  ezUInt64 m_uiMemoryUsageCPU = 0;
+  ezUInt64 m_uiMemoryUsageGPU = 0;
 };
 
 /// \brief The flags of an ezResource instance.
@@ -68,6 +80,7 @@ struct ezResourceFlags
     PreventFileReload       = EZ_BIT(7),  ///< Once this flag is set, no reloading from file is done, until the flag is manually removed. Automatically set when a custom loader is used. To restore a file to the disk state, this flag must be removed and then the resource can be reloaded.
     HasLowResData           = EZ_BIT(8),  ///< Whether low resolution data was set on a resource once before
     IsCreatedResource       = EZ_BIT(9),  ///< When this is set, the resource was created and not loaded from file
+    PreventEviction         = EZ_BIT(10), ///< The resource is never evicted to meet a memory budget. See ezResourceManager::SetPreventEviction().
     Default                 = 0,
   };
 
@@ -83,6 +96,7 @@ struct ezResourceFlags
     StorageType PreventFileReload       : 1;
     StorageType HasLowResData           : 1;
     StorageType IsCreatedResource       : 1;
+    StorageType PreventEviction         : 1;
   };
 };
 
@@ -150,3 +164,65 @@ enum class ezResourcePriority
 };
 
 // clang-format on
+
+/// \brief Configures how the ezResourceManager schedules resource loading. See ezResourceManager::SetStreamingSettings().
+///
+/// Loading a resource goes through two stages. In the I/O stage the ezResourceTypeLoader reads the data, in the decode stage the resource
+/// creates its content from that data (ezResource::UpdateContent()). Both stages have a budget. No further I/O is started while a budget
+/// is exhausted, so that the queued requests can still be reordered when more important resources are requested in the meantime.
+struct EZ_CORE_DLL ezResourceStreamingSettings
+{
+  /// How many resources may read their data at the same time.
+  ezUInt32 m_uiMaxIoRequestsInFlight = 4;
+
+  /// How many resources may wait for or run their UpdateContent() step at the same time.
+  ezUInt32 m_uiMaxDecodeRequestsInFlight = 16;
+
+  /// How many bytes of loaded data may wait for or be in the decode stage at the same time.
+  /// Only counts data for which the loader reports a size (ezResourceLoadData::m_uiDataSize). A single request is always let through.
+  ezUInt64 m_uiMaxDecodeBytesInFlight = 256 * 1024 * 1024;
+
+  /// By how much the loading priority of a queued request improves for every second that it waits.
+  /// Ten correspond to one ezResourcePriority step. Waiting requests never overtake ezResourcePriority::Critical requests.
+  float m_fPriorityAgingPerSecond = 5.0f;
+
+  /// Queued requests for resources that have not been acquired for this long, and that have been waiting for at least as long, are
+  /// dropped from the queue. They are requested again once the resource gets acquired. Zero disables this.
+  /// Requests with ezResourcePriority::Critical are never dropped.
+  ezTime m_StaleRequestTimeout = ezTime::Seconds(10);
+};
+
+/// \brief A memory budget for resources. See ezResourceManager::SetMemoryBudget() and ezResourceManager::SetMemoryBudgetForResourceType().
+///
+/// Once the memory usage exceeds the budget, the resource manager evicts resource data until the usage is below m_fEvictionTarget times
+/// the budget. Resources that have the lowest priority and have not been acquired for the longest time are evicted first. First quality
+/// levels are discarded, then resources that are not referenced anymore are deleted. Resources that are currently loading or have been
+/// excluded with ezResourceManager::SetPreventEviction() are left alone. Loading of further quality levels is held back
+/// while the usage is above the eviction target, so that the same data isn't loaded and evicted over and over.
+struct EZ_CORE_DLL ezResourceMemoryBudget
+{
+  ezUInt64 m_uiMaxMemoryCPU = 0; ///< Zero means unlimited.
+  ezUInt64 m_uiMaxMemoryGPU = 0; ///< Zero means unlimited.
+
+  /// Fraction of the budget down to which resources get evicted once the budget was exceeded.
+  float m_fEvictionTarget = 0.9f;
+
+  bool IsSet() const { return m_uiMaxMemoryCPU > 0 || m_uiMaxMemoryGPU > 0; }
+};
+
+/// \brief Statistics about resource loading. See ezResourceManager::GetStreamingStats().
+///
+/// The values are also published through ezStats under 'ResourceManager/Streaming/'.
+struct EZ_CORE_DLL ezResourceStreamingStats
+{
+  ezUInt32 m_uiQueueDepth = 0;              ///< Number of requests waiting in the loading queue.
+  ezUInt32 m_uiIoRequestsInFlight = 0;      ///< Number of requests in the I/O stage.
+  ezUInt32 m_uiDecodeRequestsInFlight = 0;  ///< Number of requests in the decode stage.
+  ezUInt64 m_uiDecodeBytesInFlight = 0;     ///< Bytes of loaded data in the decode stage.
+  double m_fBytesPerSecond = 0.0;           ///< Bytes that finished loading per second, measured over the last second.
+  ezTime m_LatencyMedian;                   ///< Median time from queuing a request until the resource is updated, over the last 256 requests.
+  ezTime m_Latency90;                       ///< 90th percentile of the request latency.
+  ezTime m_Latency99;                       ///< 99th percentile of the request latency.
+  ezUInt64 m_uiNumRequestsFinished = 0;     ///< Total number of finished requests.
+  ezUInt64 m_uiNumRequestsDropped = 0;      ///< Total number of stale requests that were dropped from the queue.
+};
@@ -140,6 +140,22 @@ void ezResource::CallUnloadData(Unload WhatToUnload)
   m_LoadingState = ld.m_State;
   m_uiQualityLevelsDiscardable = ld.m_uiQualityLevelsDiscardable;
   m_uiQualityLevelsLoadable = ld.m_uiQualityLevelsLoadable;
+
+  // the memory budgets rely on this being up to date, also when only some quality levels were unloaded
+  CallUpdateMemoryUsage();
+}
+
+void ezResource::CallUpdateMemoryUsage()
+{
+  MemoryUsage MemUsage;
+  MemUsage.m_uiMemoryCPU = 0xFFFFFFFF;
+  MemUsage.m_uiMemoryGPU = 0xFFFFFFFF;
+  UpdateMemoryUsage(MemUsage);
+
+  EZ_ASSERT_DEV(MemUsage.m_uiMemoryCPU != 0xFFFFFFFF, "Resource '{0}' did not properly update its CPU memory usage", GetResourceID());
+  EZ_ASSERT_DEV(MemUsage.m_uiMemoryGPU != 0xFFFFFFFF, "Resource '{0}' did not properly update its GPU memory usage", GetResourceID());
+
+  m_MemoryUsage = MemUsage;
 }
 
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
@@ -265,18 +281,7 @@ void ezResource::VerifyAfterCreateResource(const ezResourceLoadDesc& ld)
   m_uiQualityLevelsDiscardable = ld.m_uiQualityLevelsDiscardable;
   m_uiQualityLevelsLoadable = ld.m_uiQualityLevelsLoadable;
 
-  /* Update Memory Usage*/
-  {
-    ezResource::MemoryUsage MemUsage;
-    MemUsage.m_uiMemoryCPU = 0xFFFFFFFF;
-    MemUsage.m_uiMemoryGPU = 0xFFFFFFFF;
-    UpdateMemoryUsage(MemUsage);
-
-    EZ_ASSERT_DEV(MemUsage.m_uiMemoryCPU != 0xFFFFFFFF, "Resource '{0}' did not properly update its CPU memory usage", GetResourceID());
-    EZ_ASSERT_DEV(MemUsage.m_uiMemoryGPU != 0xFFFFFFFF, "Resource '{0}' did not properly update its GPU memory usage", GetResourceID());
-
-    m_MemoryUsage = MemUsage;
-  }
+  CallUpdateMemoryUsage();
 
   ezResourceEvent e;
   e.m_pResource = this;
@@ -3,6 +3,7 @@
 #include <Core/ResourceManager/Implementation/ResourceManagerState.h>
 #include <Core/ResourceManager/ResourceManager.h>
 #include <Foundation/Profiling/Profiling.h>
+#include <Foundation/Utilities/Stats.h>
 
 ezTypelessResourceHandle ezResourceManager::LoadResourceByType(const ezRTTI* pResourceType, const char* szResourceID)
 {
@@ -16,6 +17,11 @@ void ezResourceManager::InternalPreloadResource(ezResource* pResource, bool bHig
   if (s_State->s_bShutdown)
     return;
 
+  // Resources that are still loading are acquired over and over, don't take the lock just to find out that they are queued already.
+  // The flag is checked again below, while holding the lock.
+  if (!bHighestPriority && IsQueuedForLoading(pResource))
+    return;
+
   EZ_PROFILE_SCOPE("InternalPreloadResource");
 
   EZ_LOCK(s_ResourceMutex);
@@ -31,6 +37,10 @@ void ezResourceManager::InternalPreloadResource(ezResource* pResource, bool bHig
 
   EZ_ASSERT_DEV(!s_State->s_bExportMode, "Resources should not be loaded in export mode");
 
+  // don't load more quality levels while the memory budget is (nearly) exhausted, they would just get evicted again
+  if (!bHighestPriority && pResource->GetLoadingState() == ezResourceState::Loaded && !IsQueuedForLoading(pResource) && !IsQualityUpgradeAllowed(pResource))
+    return;
+
   // if we are already loading this resource, early out
   if (IsQueuedForLoading(pResource))
   {
@@ -42,6 +52,7 @@ void ezResourceManager::InternalPreloadResource(ezResource* pResource, bool bHig
       if (RemoveFromLoadingQueue(pResource).Succeeded())
       {
         AddToLoadingQueue(pResource, bHighestPriority);
+        RunWorkerTask(true);
       }
     }
 
@@ -51,12 +62,9 @@ void ezResourceManager::InternalPreloadResource(ezResource* pResource, bool bHig
   {
     AddToLoadingQueue(pResource, bHighestPriority);
 
-    if (bHighestPriority && ezTaskSystem::GetCurrentThreadWorkerType() == ezWorkerThreadType::FileAccess)
-    {
-      ezResourceManager::s_State->s_bAllowLaunchDataLoadTask = true;
-    }
-
-    RunWorkerTask(pResource);
+    // Someone is (or will be) blocked waiting for this resource, possibly a loading task itself.
+    // Start loading it right away, even if the streaming budgets are exhausted, otherwise this could dead-lock.
+    RunWorkerTask(bHighestPriority);
   }
 }
 
@@ -93,7 +101,7 @@ void ezResourceManager::SetupWorkerTasks()
   }
 }
 
-void ezResourceManager::RunWorkerTask(ezResource* pResource)
+void ezResourceManager::RunWorkerTask(bool bIgnoreBudget)
 {
   if (s_State->s_bShutdown)
     return;
@@ -102,22 +110,43 @@ void ezResourceManager::RunWorkerTask(ezResource* pResource)
 
   SetupWorkerTasks();
 
-  if (s_State->s_bAllowLaunchDataLoadTask && !s_State->s_LoadingQueue.IsEmpty())
+  if (!s_State->s_bAllowLaunchDataLoadTask)
+    return;
+
+  const ezResourceStreamingSettings& settings = s_State->m_StreamingSettings;
+
+  // every data load task takes one request from the queue, start as many as there are requests and the budgets allow
+  while (s_State->m_uiIoTasksStarting < s_State->s_LoadingQueue.GetCount())
   {
-    s_State->s_bAllowLaunchDataLoadTask = false;
+    if (!bIgnoreBudget)
+    {
+      if (s_State->m_uiIoTasksStarting + s_State->m_uiIoRequestsInFlight >= ezMath::Max(settings.m_uiMaxIoRequestsInFlight, 1u))
+        return;
+
+      // a single request can always be decoded, otherwise resources that are larger than the budget would never be loaded
+      if (s_State->m_uiDecodeRequestsInFlight > 0 &&
+          (s_State->m_uiDecodeRequestsInFlight >= settings.m_uiMaxDecodeRequestsInFlight || s_State->m_uiDecodeBytesInFlight >= settings.m_uiMaxDecodeBytesInFlight))
+        return;
+    }
 
+    bIgnoreBudget = false;
+    ++s_State->m_uiIoTasksStarting;
+
+    bool bStarted = false;
     for (ezUInt32 i = 0; i < s_State->s_WorkerTasksDataLoad.GetCount(); ++i)
     {
       if (s_State->s_WorkerTasksDataLoad[i].m_pTask->IsTaskFinished())
       {
         s_State->s_WorkerTasksDataLoad[i].m_GroupId =
           ezTaskSystem::StartSingleTask(s_State->s_WorkerTasksDataLoad[i].m_pTask, ezTaskPriority::FileAccess);
-        return;
+        bStarted = true;
+        break;
       }
     }
 
-    // could not find any unused task -> need to create a new one
+    if (!bStarted)
     {
+      // could not find any unused task -> need to create a new one
       ezStringBuilder s;
       s.Format("Resource Data Loader {0}", s_State->s_WorkerTasksDataLoad.GetCount());
       auto& data = s_State->s_WorkerTasksDataLoad.ExpandAndGetRef();
@@ -128,27 +157,67 @@ void ezResourceManager::RunWorkerTask(ezResource* pResource)
   }
 }
 
-void ezResourceManager::ReverseBubbleSortStep(ezDeque<LoadingInfo>& data)
+bool ezResourceManager::TakeNextLoadingRequest(LoadingInfo& out_request)
 {
-  // Yep, it's really bubble sort!
-  // This will move the entry with the smallest value to the front and move all other values closer to their correct position,
-  // which is exactly what we need for the priority queue.
-  // We do this once a frame, which gives us nice iterative sorting, with relatively deterministic performance characteristics.
-
   EZ_ASSERT_DEBUG(s_ResourceMutex.IsLocked(), "Calling code must acquire s_ResourceMutex");
 
-  const ezUInt32 uiCount = data.GetCount();
+  UpdateLoadingDeadlines();
+
+  ezDeque<LoadingInfo>& queue = s_State->s_LoadingQueue;
 
-  for (ezUInt32 i = uiCount; i > 1; --i)
+  if (queue.IsEmpty())
+    return false;
+
+  EZ_PROFILE_SCOPE("TakeNextLoadingRequest");
+
+  const ezTime tNow = ezTime::Now();
+  const float fAgingPerSecond = s_State->m_StreamingSettings.m_fPriorityAgingPerSecond;
+
+  // The stored priorities are refreshed incrementally by UpdateLoadingDeadlines(), only the aging is applied here.
+  // Critical requests have priority zero, everything else can improve to at most one, so waiting requests never overtake them.
+  ezUInt32 uiBest = 0;
+  float fBestPriority = ezMath::MaxValue<float>();
+
+  for (ezUInt32 i = 0; i < queue.GetCount(); ++i)
   {
-    const ezUInt32 idx2 = i - 1;
-    const ezUInt32 idx1 = i - 2;
+    const LoadingInfo& li = queue[i];
 
-    if (data[idx1].m_fPriority > data[idx1].m_fPriority)
+    float fPriority = li.m_fPriority;
+    if (fPriority > 0.0f)
     {
-      ezMath::Swap(data[idx1], data[idx2]);
+      fPriority = ezMath::Max(1.0f, fPriority - fAgingPerSecond * static_cast<float>((tNow - li.m_QueuedTime).GetSeconds()));
+    }
+
+    if (fPriority < fBestPriority)
+    {
+      fBestPriority = fPriority;
+      uiBest = i;
     }
   }
+
+  out_request = queue[uiBest];
+  queue.RemoveAtAndSwap(uiBest);
+
+  return true;
+}
+
+void ezResourceManager::FinishLoadingRequest(ezTime queuedTime, ezUInt64 uiDataSize)
+{
+  EZ_ASSERT_DEBUG(s_ResourceMutex.IsLocked(), "Calling code must acquire s_ResourceMutex");
+
+  if (s_State->s_bShutdown)
+    return;
+
+  --s_State->m_uiDecodeRequestsInFlight;
+  s_State->m_uiDecodeBytesInFlight -= uiDataSize;
+  s_State->m_uiBytesFinishedSinceStatsUpdate += uiDataSize;
+  ++s_State->m_StreamingStats.m_uiNumRequestsFinished;
+
+  s_State->m_RequestLatencies[s_State->m_uiNumRequestLatencies % ezResourceManagerState::NumTrackedLatencies] = ezTime::Now() - queuedTime;
+  ++s_State->m_uiNumRequestLatencies;
+
+  // the decode budget might allow more loading now
+  RunWorkerTask();
 }
 
 void ezResourceManager::UpdateLoadingDeadlines()
@@ -160,7 +229,9 @@ void ezResourceManager::UpdateLoadingDeadlines()
 
   EZ_PROFILE_SCOPE("UpdateLoadingDeadlines");
 
-  const ezUInt32 uiCount = s_State->s_LoadingQueue.GetCount();
+  ezDeque<LoadingInfo>& queue = s_State->s_LoadingQueue;
+
+  const ezUInt32 uiCount = queue.GetCount();
   s_State->s_uiLastResourcePriorityUpdateIdx = ezMath::Min(s_State->s_uiLastResourcePriorityUpdateIdx, uiCount);
 
   ezUInt32 uiUpdateCount = ezMath::Min(50u, uiCount - s_State->s_uiLastResourcePriorityUpdateIdx);
@@ -171,26 +242,110 @@ void ezResourceManager::UpdateLoadingDeadlines()
     uiUpdateCount = ezMath::Min(50u, uiCount - s_State->s_uiLastResourcePriorityUpdateIdx);
   }
 
-  if (uiUpdateCount > 0)
+  EZ_PROFILE_SCOPE("EvalLoadingDeadlines");
+
+  const ezTime tNow = ezTime::Now();
+  const ezTime staleTimeout = s_State->m_StreamingSettings.m_StaleRequestTimeout;
+
+  for (ezUInt32 i = 0; i < uiUpdateCount && s_State->s_uiLastResourcePriorityUpdateIdx < queue.GetCount(); ++i)
   {
-    {
-      EZ_PROFILE_SCOPE("EvalLoadingDeadlines");
+    auto& element = queue[s_State->s_uiLastResourcePriorityUpdateIdx];
+    ezResource* pResource = element.m_pResource;
 
-      const ezTime tNow = ezTime::Now();
+    if (staleTimeout.IsPositive() && pResource->GetPriority() != ezResourcePriority::Critical && tNow - element.m_QueuedTime > staleTimeout)
+    {
+      // Nobody can acquire a resource without a handle and nobody needs a better quality level of a resource that is not used anymore.
+      // Requests for resources that are not loaded yet are kept, they might have been preloaded for later use.
+      const bool bUnreferenced = pResource->GetReferenceCount() == 0;
+      const bool bUnusedUpgrade = pResource->GetLoadingState() == ezResourceState::Loaded && s_State->s_LastFrameUpdate - pResource->GetLastAcquireTime() > staleTimeout;
 
-      for (ezUInt32 i = 0; i < uiUpdateCount; ++i)
+      if (bUnreferenced || bUnusedUpgrade)
       {
-        auto& element = s_State->s_LoadingQueue[s_State->s_uiLastResourcePriorityUpdateIdx];
-        element.m_fPriority = element.m_pResource->GetLoadingPriority(tNow);
-        ++s_State->s_uiLastResourcePriorityUpdateIdx;
+        pResource->m_Flags.Remove(ezResourceFlags::IsQueuedForLoading);
+        queue.RemoveAtAndSwap(s_State->s_uiLastResourcePriorityUpdateIdx);
+        ++s_State->m_StreamingStats.m_uiNumRequestsDropped;
+
+        // the element that was swapped into this place is looked at next
+        continue;
       }
     }
 
+    element.m_fPriority = pResource->GetLoadingPriority(tNow);
+    ++s_State->s_uiLastResourcePriorityUpdateIdx;
+  }
+}
+
+void ezResourceManager::SetStreamingSettings(const ezResourceStreamingSettings& settings)
+{
+  EZ_LOCK(s_ResourceMutex);
+  s_State->m_StreamingSettings = settings;
+
+  // the budgets may have been raised
+  RunWorkerTask();
+}
+
+ezResourceStreamingSettings ezResourceManager::GetStreamingSettings()
+{
+  EZ_LOCK(s_ResourceMutex);
+  return s_State->m_StreamingSettings;
+}
+
+ezResourceStreamingStats ezResourceManager::GetStreamingStats()
+{
+  EZ_LOCK(s_ResourceMutex);
+
+  ezResourceStreamingStats stats = s_State->m_StreamingStats;
+  stats.m_uiQueueDepth = s_State->s_LoadingQueue.GetCount();
+  stats.m_uiIoRequestsInFlight = s_State->m_uiIoRequestsInFlight;
+  stats.m_uiDecodeRequestsInFlight = s_State->m_uiDecodeRequestsInFlight;
+  stats.m_uiDecodeBytesInFlight = s_State->m_uiDecodeBytesInFlight;
+
+  return stats;
+}
+
+void ezResourceManager::UpdateStreamingStats()
+{
+  const ezTime tNow = ezTime::Now();
+
+  {
+    EZ_LOCK(s_ResourceMutex);
+
+    const ezTime tElapsed = tNow - s_State->m_LastStreamingStatsUpdate;
+    if (tElapsed < ezTime::Seconds(1.0))
+      return;
+
+    ezResourceStreamingStats& stats = s_State->m_StreamingStats;
+
+    stats.m_fBytesPerSecond = s_State->m_uiBytesFinishedSinceStatsUpdate / tElapsed.GetSeconds();
+    s_State->m_uiBytesFinishedSinceStatsUpdate = 0;
+    s_State->m_LastStreamingStatsUpdate = tNow;
+
+    const ezUInt32 uiNumLatencies = ezMath::Min(s_State->m_uiNumRequestLatencies, ezResourceManagerState::NumTrackedLatencies);
+
+    if (uiNumLatencies > 0)
     {
-      EZ_PROFILE_SCOPE("SortLoadingDeadlines");
-      ReverseBubbleSortStep(s_State->s_LoadingQueue);
+      ezHybridArray<ezTime, ezResourceManagerState::NumTrackedLatencies> latencies;
+      latencies.SetCountUninitialized(uiNumLatencies);
+      ezMemoryUtils::Copy(latencies.GetData(), s_State->m_RequestLatencies, uiNumLatencies);
+      latencies.Sort();
+
+      stats.m_LatencyMedian = latencies[uiNumLatencies * 50 / 100];
+      stats.m_Latency90 = latencies[uiNumLatencies * 90 / 100];
+      stats.m_Latency99 = latencies[uiNumLatencies * 99 / 100];
     }
   }
+
+  const ezResourceStreamingStats stats = GetStreamingStats();
+
+  ezStats::SetStat("ResourceManager/Streaming/Queue Depth", stats.m_uiQueueDepth);
+  ezStats::SetStat("ResourceManager/Streaming/IO Requests", stats.m_uiIoRequestsInFlight);
+  ezStats::SetStat("ResourceManager/Streaming/Decode Requests", stats.m_uiDecodeRequestsInFlight);
+  ezStats::SetStat("ResourceManager/Streaming/Decode MB", stats.m_uiDecodeBytesInFlight / (1024.0 * 1024.0));
+  ezStats::SetStat("ResourceManager/Streaming/MB per Second", stats.m_fBytesPerSecond / (1024.0 * 1024.0));
+  ezStats::SetStat("ResourceManager/Streaming/Latency Median", stats.m_LatencyMedian);
+  ezStats::SetStat("ResourceManager/Streaming/Latency 90%", stats.m_Latency90);
+  ezStats::SetStat("ResourceManager/Streaming/Latency 99%", stats.m_Latency99);
+  ezStats::SetStat("ResourceManager/Streaming/Dropped Requests", stats.m_uiNumRequestsDropped);
 }
 
 void ezResourceManager::PreloadResource(ezResource* pResource)
@@ -242,6 +397,7 @@ void ezResourceManager::AddToLoadingQueue(ezResource* pResource, bool bHighestPr
 
   LoadingInfo li;
   li.m_pResource = pResource;
+  li.m_QueuedTime = ezTime::Now();
 
   if (bHighestPriority)
   {
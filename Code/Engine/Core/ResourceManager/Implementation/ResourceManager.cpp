@@ -448,6 +448,8 @@ void ezResourceManager::PerFrameUpdate()
 
   s_State->s_LastFrameUpdate = ezTime::Now();
 
+  UpdateStreamingStats();
+
   if (s_State->s_bBroadcastExistsEvent)
   {
     EZ_LOCK(s_ResourceMutex);
@@ -498,6 +500,8 @@ void ezResourceManager::PerFrameUpdate()
     s_State->s_ResourcesToUnloadOnMainThread.Clear();
   }
 
+  EnforceMemoryBudgets();
+
   if (s_State->m_AutoFreeUnusedTimeout.IsPositive())
   {
     FreeUnusedResources(s_State->m_AutoFreeUnusedTimeout, s_State->m_AutoFreeUnusedThreshold);
@@ -884,18 +888,7 @@ void ezResourceManager::SetResourceLowResData(const ezTypelessResourceHandle& hR
 
   EZ_ASSERT_DEV(pResource->GetLoadingState() != ezResourceState::Unloaded, "The resource should have changed its loading state.");
 
-  // Update Memory Usage
-  {
-    ezResource::MemoryUsage MemUsage;
-    MemUsage.m_uiMemoryCPU = 0xFFFFFFFF;
-    MemUsage.m_uiMemoryGPU = 0xFFFFFFFF;
-    pResource->UpdateMemoryUsage(MemUsage);
-
-    EZ_ASSERT_DEV(MemUsage.m_uiMemoryCPU != 0xFFFFFFFF, "Resource '{0}' did not properly update its CPU memory usage", pResource->GetResourceID());
-    EZ_ASSERT_DEV(MemUsage.m_uiMemoryGPU != 0xFFFFFFFF, "Resource '{0}' did not properly update its GPU memory usage", pResource->GetResourceID());
-
-    pResource->m_MemoryUsage = MemUsage;
-  }
+  pResource->CallUpdateMemoryUsage();
 }
 
 ezResourceTypeLoader* ezResourceManager::GetDefaultResourceLoader()
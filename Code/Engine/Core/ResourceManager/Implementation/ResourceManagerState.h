@@ -64,6 +64,23 @@ private:
   ezTime s_LastFrameUpdate;
   ezUInt32 s_uiLastResourcePriorityUpdateIdx = 0;
 
+  // Streaming, all protected by s_ResourceMutex
+
+  ezResourceStreamingSettings m_StreamingSettings;
+  ezResourceStreamingStats m_StreamingStats;
+
+  ezUInt32 m_uiIoTasksStarting = 0; // data load tasks that have been started, but did not take a request from the queue yet
+  ezUInt32 m_uiIoRequestsInFlight = 0;
+  ezUInt32 m_uiDecodeRequestsInFlight = 0;
+  ezUInt64 m_uiDecodeBytesInFlight = 0;
+
+  ezUInt64 m_uiBytesFinishedSinceStatsUpdate = 0;
+  ezTime m_LastStreamingStatsUpdate;
+
+  static constexpr ezUInt32 NumTrackedLatencies = 256;
+  ezTime m_RequestLatencies[NumTrackedLatencies];
+  ezUInt32 m_uiNumRequestLatencies = 0;
+
   ezDynamicArray<ezResource*> s_LoadedResourceOfTypeTempContainer;
   ezHashTable<ezTempHashedString, const ezRTTI*> s_ResourcesToUnloadOnMainThread;
 
@@ -102,4 +119,8 @@ private:
   ezTime m_AutoFreeUnusedThreshold = ezTime::Zero();
 
   ezMap<const ezRTTI*, ezResourceManager::ResourceTypeInfo> m_TypeInfo;
+
+  // Memory budgets
+
+  ezResourceManager::MemoryBudgetState m_GlobalMemoryBudget;
 };
@@ -140,45 +140,49 @@ ResourceType* ezResourceManager::BeginAcquireResource(const ezTypedResourceHandl
 
   // only set the last accessed time stamp, if it is actually needed, pointer-only access might not mean that the resource is used
   // productively
-  pResource->m_LastAcquire = GetLastFrameUpdate();
+  const bool bFirstAcquireThisFrame = pResource->UpdateLastAcquireTime(GetLastFrameUpdate());
 
-  if (pResource->GetLoadingState() != ezResourceState::LoadedResourceMissing)
+  if (pResource->GetLoadingState() == ezResourceState::Loaded)
   {
-    if (pResource->GetLoadingState() != ezResourceState::Loaded)
-    {
-      // if BlockTillLoaded is specified, it will prepended to the preload array, thus will be loaded immediately
-      InternalPreloadResource(pResource, mode >= ezResourceAcquireMode::BlockTillLoaded);
+    // Fast path for resources that are already loaded, this only touches the resource itself and never the global resource mutex.
+    // As long as there are more quality levels available, schedule the resource for more loading, but only once per frame.
+    // Accessing IsQueuedForLoading without a lock here is safe because InternalPreloadResource() will lock and early out if necessary
+    // and accidentally skipping InternalPreloadResource() is no problem, the next frame will try again.
+    if (bFirstAcquireThisFrame && IsQueuedForLoading(pResource) == false && pResource->GetNumQualityLevelsLoadable() > 0)
+      InternalPreloadResource(pResource, false);
 
-      if (mode == ezResourceAcquireMode::AllowLoadingFallback &&
-          (pResource->m_hLoadingFallback.IsValid() || hFallbackResource.IsValid() || GetResourceTypeLoadingFallback<ResourceType>().IsValid()))
-      {
-        // return the fallback resource for now, if there is one
-        if (out_AcquireResult)
-          *out_AcquireResult = ezResourceAcquireResult::LoadingFallback;
-
-        // Fallback order is as follows:
-        //  1) Prefer any resource specific fallback resource
-        //  2) If not available, use the fallback that is given to BeginAcquireResource, as that is at least specific to the situation
-        //  3) If nothing else is available, take the fallback for the whole resource type
-
-        if (pResource->m_hLoadingFallback.IsValid())
-          return (ResourceType*)BeginAcquireResource(pResource->m_hLoadingFallback, ezResourceAcquireMode::BlockTillLoaded);
-        else if (hFallbackResource.IsValid())
-          return (ResourceType*)BeginAcquireResource(hFallbackResource, ezResourceAcquireMode::BlockTillLoaded);
-        else
-          return (ResourceType*)BeginAcquireResource(GetResourceTypeLoadingFallback<ResourceType>(), ezResourceAcquireMode::BlockTillLoaded);
-      }
+    if (out_AcquireResult)
+      *out_AcquireResult = ezResourceAcquireResult::Final;
 
-      EnsureResourceLoadingState(pResource, ezResourceState::Loaded);
-    }
-    else
+    return pResource;
+  }
+
+  if (pResource->GetLoadingState() != ezResourceState::LoadedResourceMissing)
+  {
+    // if BlockTillLoaded is specified, it will prepended to the preload array, thus will be loaded immediately
+    InternalPreloadResource(pResource, mode >= ezResourceAcquireMode::BlockTillLoaded);
+
+    if (mode == ezResourceAcquireMode::AllowLoadingFallback &&
+        (pResource->m_hLoadingFallback.IsValid() || hFallbackResource.IsValid() || GetResourceTypeLoadingFallback<ResourceType>().IsValid()))
     {
-      // as long as there are more quality levels available, schedule the resource for more loading
-      // accessing IsQueuedForLoading without a lock here is save because InternalPreloadResource() will lock and early out if necessary
-      // and accidentally skipping InternalPreloadResource() is no problem
-      if (IsQueuedForLoading(pResource) == false && pResource->GetNumQualityLevelsLoadable() > 0)
-        InternalPreloadResource(pResource, false);
+      // return the fallback resource for now, if there is one
+      if (out_AcquireResult)
+        *out_AcquireResult = ezResourceAcquireResult::LoadingFallback;
+
+      // Fallback order is as follows:
+      //  1) Prefer any resource specific fallback resource
+      //  2) If not available, use the fallback that is given to BeginAcquireResource, as that is at least specific to the situation
+      //  3) If nothing else is available, take the fallback for the whole resource type
+
+      if (pResource->m_hLoadingFallback.IsValid())
+        return (ResourceType*)BeginAcquireResource(pResource->m_hLoadingFallback, ezResourceAcquireMode::BlockTillLoaded);
+      else if (hFallbackResource.IsValid())
+        return (ResourceType*)BeginAcquireResource(hFallbackResource, ezResourceAcquireMode::BlockTillLoaded);
+      else
+        return (ResourceType*)BeginAcquireResource(GetResourceTypeLoadingFallback<ResourceType>(), ezResourceAcquireMode::BlockTillLoaded);
     }
+
+    EnsureResourceLoadingState(pResource, ezResourceState::Loaded);
   }
 
   if (pResource->GetLoadingState() == ezResourceState::LoadedResourceMissing)
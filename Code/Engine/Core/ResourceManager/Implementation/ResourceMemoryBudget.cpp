@@ -0,0 +1,239 @@
+#include <Core/CorePCH.h>
+
+#include <Core/ResourceManager/Implementation/ResourceManagerState.h>
+#include <Core/ResourceManager/ResourceManager.h>
+#include <Foundation/Profiling/Profiling.h>
+
+namespace
+{
+  bool IsAboveBudget(const ezResource::MemoryUsage& usage, const ezResourceMemoryBudget& budget, float fFraction)
+  {
+    if (budget.m_uiMaxMemoryCPU > 0 && usage.m_uiMemoryCPU > static_cast<ezUInt64>(budget.m_uiMaxMemoryCPU * static_cast<double>(fFraction)))
+      return true;
+
+    if (budget.m_uiMaxMemoryGPU > 0 && usage.m_uiMemoryGPU > static_cast<ezUInt64>(budget.m_uiMaxMemoryGPU * static_cast<double>(fFraction)))
+      return true;
+
+    return false;
+  }
+
+  void SubtractMemoryUsage(ezResource::MemoryUsage& inout_Usage, const ezResource::MemoryUsage& before, const ezResource::MemoryUsage& after)
+  {
+    inout_Usage.m_uiMemoryCPU -= ezMath::Min(inout_Usage.m_uiMemoryCPU, before.m_uiMemoryCPU - ezMath::Min(before.m_uiMemoryCPU, after.m_uiMemoryCPU));
+    inout_Usage.m_uiMemoryGPU -= ezMath::Min(inout_Usage.m_uiMemoryGPU, before.m_uiMemoryGPU - ezMath::Min(before.m_uiMemoryGPU, after.m_uiMemoryGPU));
+  }
+} // namespace
+
+void ezResourceManager::SetMemoryBudget(const ezResourceMemoryBudget& budget)
+{
+  EZ_LOCK(s_ResourceMutex);
+  s_State->m_GlobalMemoryBudget.m_Budget = budget;
+}
+
+ezResourceMemoryBudget ezResourceManager::GetMemoryBudget()
+{
+  EZ_LOCK(s_ResourceMutex);
+  return s_State->m_GlobalMemoryBudget.m_Budget;
+}
+
+void ezResourceManager::SetMemoryBudgetForResourceType(const ezRTTI* pResourceType, const ezResourceMemoryBudget& budget)
+{
+  EZ_LOCK(s_ResourceMutex);
+  GetResourceTypeInfo(pResourceType).m_MemoryBudget.m_Budget = budget;
+}
+
+void ezResourceManager::SetPreventEviction(const ezTypelessResourceHandle& hResource, bool bPrevent)
+{
+  EZ_ASSERT_DEV(hResource.IsValid(), "Cannot access an invalid resource");
+
+  EZ_LOCK(s_ResourceMutex);
+  hResource.m_pResource->m_Flags.AddOrRemove(ezResourceFlags::PreventEviction, bPrevent);
+}
+
+ezResource::MemoryUsage ezResourceManager::GetMemoryUsage(const ezRTTI* pResourceType)
+{
+  EZ_LOCK(s_ResourceMutex);
+  return ComputeMemoryUsage(pResourceType);
+}
+
+ezResource::MemoryUsage ezResourceManager::ComputeMemoryUsage(const ezRTTI* pResourceType)
+{
+  EZ_ASSERT_DEBUG(s_ResourceMutex.IsLocked(), "Calling code must acquire s_ResourceMutex");
+
+  ezResource::MemoryUsage usage;
+
+  for (auto itType = s_State->s_LoadedResources.GetIterator(); itType.IsValid(); ++itType)
+  {
+    if (pResourceType != nullptr && itType.Key() != pResourceType)
+      continue;
+
+    for (auto it = itType.Value().m_Resources.GetIterator(); it.IsValid(); ++it)
+    {
+      const ezResource::MemoryUsage& resourceUsage = it.Value()->GetMemoryUsage();
+      usage.m_uiMemoryCPU += resourceUsage.m_uiMemoryCPU;
+      usage.m_uiMemoryGPU += resourceUsage.m_uiMemoryGPU;
+    }
+  }
+
+  return usage;
+}
+
+bool ezResourceManager::IsQualityUpgradeAllowed(const ezResource* pResource)
+{
+  EZ_ASSERT_DEBUG(s_ResourceMutex.IsLocked(), "Calling code must acquire s_ResourceMutex");
+
+  if (!s_State->m_GlobalMemoryBudget.m_bAllowQualityUpgrades)
+    return false;
+
+  auto it = s_State->m_TypeInfo.Find(pResource->GetDynamicRTTI());
+  return !it.IsValid() || it.Value().m_MemoryBudget.m_bAllowQualityUpgrades;
+}
+
+ezUInt32 ezResourceManager::EnforceMemoryBudgets()
+{
+  EZ_LOCK(s_ResourceMutex);
+
+  ezUInt32 uiEvicted = 0;
+
+  // type budgets first, what they evict also counts towards the global budget
+  for (auto it = s_State->m_TypeInfo.GetIterator(); it.IsValid(); ++it)
+  {
+    uiEvicted += EnforceMemoryBudget(it.Key(), it.Value().m_MemoryBudget);
+  }
+
+  uiEvicted += EnforceMemoryBudget(nullptr, s_State->m_GlobalMemoryBudget);
+
+  return uiEvicted;
+}
+
+ezUInt32 ezResourceManager::EnforceMemoryBudget(const ezRTTI* pResourceType, MemoryBudgetState& state)
+{
+  if (!state.m_Budget.IsSet())
+  {
+    state.m_bExceeded = false;
+    state.m_bAllowQualityUpgrades = true;
+    return 0;
+  }
+
+  EZ_PROFILE_SCOPE("EnforceMemoryBudget");
+
+  const float fTarget = ezMath::Clamp(state.m_Budget.m_fEvictionTarget, 0.0f, 1.0f);
+
+  ezResource::MemoryUsage usage = ComputeMemoryUsage(pResourceType);
+
+  auto BroadcastBudgetEvent = [&](ezResourceManagerEvent::Type type) {
+    ezResourceManagerEvent e;
+    e.m_Type = type;
+    e.m_pResourceType = pResourceType;
+    e.m_uiMemoryUsageCPU = usage.m_uiMemoryCPU;
+    e.m_uiMemoryUsageGPU = usage.m_uiMemoryGPU;
+
+    s_State->s_ManagerEvents.Broadcast(e);
+  };
+
+  if (!state.m_bExceeded)
+  {
+    state.m_bAllowQualityUpgrades = !IsAboveBudget(usage, state.m_Budget, fTarget);
+
+    if (!IsAboveBudget(usage, state.m_Budget, 1.0f))
+      return 0;
+
+    state.m_bExceeded = true;
+    BroadcastBudgetEvent(ezResourceManagerEvent::Type::MemoryBudgetExceeded);
+  }
+
+  ezUInt32 uiEvicted = 0;
+
+  if (IsAboveBudget(usage, state.m_Budget, fTarget))
+  {
+    // Collect everything that could be evicted and order it by priority and then by the time it was used last.
+    // Resources that are loading right now, or were explicitly excluded from eviction, are left alone.
+    // The priority is not used for that, blocking acquires raise it to critical on any resource.
+    ezDynamicArray<ezResource*> candidates;
+
+    const bool bIsMainThread = ezThreadUtils::IsMainThread();
+
+    for (auto itType = s_State->s_LoadedResources.GetIterator(); itType.IsValid(); ++itType)
+    {
+      if (pResourceType != nullptr && itType.Key() != pResourceType)
+        continue;
+
+      for (auto it = itType.Value().m_Resources.GetIterator(); it.IsValid(); ++it)
+      {
+        ezResource* pResource = it.Value();
+
+        if (pResource->GetBaseResourceFlags().IsSet(ezResourceFlags::PreventEviction) || IsQueuedForLoading(pResource))
+          continue;
+
+        if (pResource->GetReferenceCount() > 0 && pResource->GetNumQualityLevelsDiscardable() == 0)
+          continue;
+
+        if (!bIsMainThread && pResource->GetBaseResourceFlags().IsSet(ezResourceFlags::UpdateOnMainThread))
+          continue;
+
+        candidates.PushBack(pResource);
+      }
+    }
+
+    candidates.Sort([](const ezResource* a, const ezResource* b) {
+      if (a->GetPriority() != b->GetPriority())
+        return a->GetPriority() > b->GetPriority();
+
+      return a->GetLastAcquireTime() < b->GetLastAcquireTime();
+    });
+
+    // first reduce the quality of resources that are still in use
+    for (ezResource* pResource : candidates)
+    {
+      if (pResource->GetReferenceCount() == 0)
+        continue;
+
+      while (pResource->GetNumQualityLevelsDiscardable() > 0 && IsAboveBudget(usage, state.m_Budget, fTarget))
+      {
+        const ezResource::MemoryUsage before = pResource->GetMemoryUsage();
+        pResource->CallUnloadData(ezResource::Unload::OneQualityLevel);
+        SubtractMemoryUsage(usage, before, pResource->GetMemoryUsage());
+
+        ++uiEvicted;
+      }
+
+      if (!IsAboveBudget(usage, state.m_Budget, fTarget))
+        break;
+    }
+
+    // then delete resources that are not used anymore
+    for (ezResource* pResource : candidates)
+    {
+      if (!IsAboveBudget(usage, state.m_Budget, fTarget))
+        break;
+
+      if (pResource->GetReferenceCount() > 0)
+        continue;
+
+      const ezResource::MemoryUsage before = pResource->GetMemoryUsage();
+      const ezRTTI* pRtti = pResource->GetDynamicRTTI();
+      const ezTempHashedString sResourceID(pResource->GetResourceID().GetData());
+
+      if (DeallocateResource(pResource).Succeeded())
+      {
+        s_State->s_LoadedResources[pRtti].m_Resources.Remove(sResourceID);
+        SubtractMemoryUsage(usage, before, ezResource::MemoryUsage());
+
+        ++uiEvicted;
+      }
+    }
+  }
+
+  state.m_bAllowQualityUpgrades = !IsAboveBudget(usage, state.m_Budget, fTarget);
+
+  if (state.m_bAllowQualityUpgrades)
+  {
+    state.m_bExceeded = false;
+    BroadcastBudgetEvent(ezResourceManagerEvent::Type::MemoryBudgetRelieved);
+  }
+
+  return uiEvicted;
+}
+
+
+EZ_STATICLINK_FILE(Core, Core_ResourceManager_Implementation_ResourceMemoryBudget);
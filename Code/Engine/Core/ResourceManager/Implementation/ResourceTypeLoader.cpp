@@ -56,6 +56,7 @@ ezResourceLoadData ezResourceLoaderFromFile::OpenDataStream(const ezResource* pR
   pData->m_Reader.Reset(pBlobPtr, w.GetNumWrittenBytes() + uiFileSize);
   res.m_pDataStream = &pData->m_Reader;
   res.m_pCustomLoaderData = pData;
+  res.m_uiDataSize = uiFileSize;
 
   return res;
 }
@@ -102,6 +103,7 @@ ezResourceLoadData ezResourceLoaderFromMemory::OpenDataStream(const ezResource*
   res.m_LoadedFileModificationDate = m_ModificationTimestamp;
   res.m_pDataStream = &m_Reader;
   res.m_pCustomLoaderData = nullptr;
+  res.m_uiDataSize = m_CustomData.GetStorageSize64();
 
   return res;
 }
@@ -15,21 +15,19 @@ void ezResourceManagerWorkerDataLoad::Execute()
   ezResource* pResourceToLoad = nullptr;
   ezResourceTypeLoader* pLoader = nullptr;
   ezUniquePtr<ezResourceTypeLoader> pCustomLoader;
+  ezResourceManager::LoadingInfo request;
 
   {
     EZ_LOCK(ezResourceManager::s_ResourceMutex);
 
-    if (ezResourceManager::s_State->s_LoadingQueue.IsEmpty())
-    {
-      ezResourceManager::s_State->s_bAllowLaunchDataLoadTask = true;
-      return;
-    }
+    --ezResourceManager::s_State->m_uiIoTasksStarting;
 
-    ezResourceManager::UpdateLoadingDeadlines();
+    // the request is picked only now, so that requests which came in while this task was waiting to run are considered as well
+    if (!ezResourceManager::TakeNextLoadingRequest(request))
+      return;
 
-    auto it = ezResourceManager::s_State->s_LoadingQueue.PeekFront();
-    pResourceToLoad = it.m_pResource;
-    ezResourceManager::s_State->s_LoadingQueue.PopFront();
+    ++ezResourceManager::s_State->m_uiIoRequestsInFlight;
+    pResourceToLoad = request.m_pResource;
 
     if (pResourceToLoad->m_Flags.IsSet(ezResourceFlags::HasCustomDataLoader))
     {
@@ -58,6 +56,11 @@ void ezResourceManagerWorkerDataLoad::Execute()
 
   EZ_LOCK(ezResourceManager::s_ResourceMutex);
 
+  // the data has been read, move the request from the I/O stage to the decode stage
+  --ezResourceManager::s_State->m_uiIoRequestsInFlight;
+  ++ezResourceManager::s_State->m_uiDecodeRequestsInFlight;
+  ezResourceManager::s_State->m_uiDecodeBytesInFlight += LoaderData.m_uiDataSize;
+
   // try to find an update content task that has finished and can be reused
   for (ezUInt32 i = 0; i < ezResourceManager::s_State->s_WorkerTasksUpdateContent.GetCount(); ++i)
   {
@@ -94,14 +97,14 @@ void ezResourceManagerWorkerDataLoad::Execute()
     pUpdateContentTask->m_pLoader = pLoader;
     pUpdateContentTask->m_pCustomLoader = std::move(pCustomLoader);
     pUpdateContentTask->m_pResourceToLoad = pResourceToLoad;
+    pUpdateContentTask->m_RequestQueuedTime = request.m_QueuedTime;
 
     // schedule the task to run, either on the main thread or on some other thread
     *pUpdateContentGroup = ezTaskSystem::StartSingleTask(
       pUpdateContentTask, bResourceIsLoadedOnMainThread ? ezTaskPriority::SomeFrameMainThread : ezTaskPriority::LateNextFrame);
 
-    // restart the next loading task (this one is about to finish)
-    ezResourceManager::s_State->s_bAllowLaunchDataLoadTask = true;
-    ezResourceManager::RunWorkerTask(nullptr);
+    // start the next loading task, if the budgets allow it (this one is about to finish)
+    ezResourceManager::RunWorkerTask();
 
     pCustomLoader.Clear();
   }
@@ -132,20 +135,7 @@ void ezResourceManagerWorkerUpdateContent::Execute()
 
   EZ_ASSERT_DEV(m_pResourceToLoad->GetLoadingState() != ezResourceState::Unloaded, "The resource should have changed its loading state.");
 
-  // Update Memory Usage
-  {
-    ezResource::MemoryUsage MemUsage;
-    MemUsage.m_uiMemoryCPU = 0xFFFFFFFF;
-    MemUsage.m_uiMemoryGPU = 0xFFFFFFFF;
-    m_pResourceToLoad->UpdateMemoryUsage(MemUsage);
-
-    EZ_ASSERT_DEV(
-      MemUsage.m_uiMemoryCPU != 0xFFFFFFFF, "Resource '{0}' did not properly update its CPU memory usage", m_pResourceToLoad->GetResourceID());
-    EZ_ASSERT_DEV(
-      MemUsage.m_uiMemoryGPU != 0xFFFFFFFF, "Resource '{0}' did not properly update its GPU memory usage", m_pResourceToLoad->GetResourceID());
-
-    m_pResourceToLoad->m_MemoryUsage = MemUsage;
-  }
+  m_pResourceToLoad->CallUpdateMemoryUsage();
 
   m_pLoader->CloseDataStream(m_pResourceToLoad, m_LoaderData);
 
@@ -153,7 +143,9 @@ void ezResourceManagerWorkerUpdateContent::Execute()
     EZ_LOCK(ezResourceManager::s_ResourceMutex);
     EZ_ASSERT_DEV(ezResourceManager::IsQueuedForLoading(m_pResourceToLoad), "Multi-threaded access detected");
     m_pResourceToLoad->m_Flags.Remove(ezResourceFlags::IsQueuedForLoading);
-    m_pResourceToLoad->m_LastAcquire = ezResourceManager::GetLastFrameUpdate();
+    m_pResourceToLoad->UpdateLastAcquireTime(ezResourceManager::GetLastFrameUpdate());
+
+    ezResourceManager::FinishLoadingRequest(m_RequestQueuedTime, m_LoaderData.m_uiDataSize);
   }
 
   m_pLoader = nullptr;
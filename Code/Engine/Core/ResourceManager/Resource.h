@@ -98,7 +98,7 @@ public:
   /// \brief Returns the time at which the resource was (tried to be) acquired last.
   /// If a resource is acquired using ezResourceAcquireMode::PointerOnly, this does not update the last acquired time, since the resource is
   /// not acquired for full use.
-  EZ_ALWAYS_INLINE ezTime GetLastAcquireTime() const { return m_LastAcquire; }
+  EZ_ALWAYS_INLINE ezTime GetLastAcquireTime() const { return ezTime::Nanoseconds(static_cast<double>(m_iLastAcquireNanoseconds)); }
 
   /// \brief Returns the reference count of this resource.
   EZ_ALWAYS_INLINE ezInt32 GetReferenceCount() const { return m_iReferenceCount; }
@@ -147,6 +147,9 @@ private:
 
   void CallUpdateContent(ezStreamReader* Stream);
 
+  /// \brief Calls UpdateMemoryUsage() and stores the result.
+  void CallUpdateMemoryUsage();
+
   /// \brief Called whenever more data for the resource is available. The resource must read the stream to update it's data.
   ///
   /// pStream may be nullptr in case the resource data could not be found.
@@ -225,7 +228,19 @@ private:
   MemoryUsage m_MemoryUsage;
   ezBitflags<ezResourceFlags> m_Flags;
 
-  ezTime m_LastAcquire;
+  /// \brief Stores the last acquire time. Returns false, if it was already set to this time, i.e. the resource was already acquired in the same frame.
+  ///
+  /// The value is only written when it changes, so acquiring a resource from many threads doesn't keep invalidating the cache line.
+  EZ_ALWAYS_INLINE bool UpdateLastAcquireTime(ezTime now)
+  {
+    const ezInt64 iNow = static_cast<ezInt64>(now.GetNanoseconds());
+    if (m_iLastAcquireNanoseconds == iNow)
+      return false;
+
+    return m_iLastAcquireNanoseconds.Set(iNow) != iNow;
+  }
+
+  ezAtomicInteger64 m_iLastAcquireNanoseconds;
   ezResourcePriority m_Priority = ezResourcePriority::Medium;
   ezTimestamp m_LoadedFileModificationTime;
 
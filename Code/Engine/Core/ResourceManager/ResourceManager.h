@@ -231,6 +231,71 @@ public:
 private:
   static ezResult DeallocateResource(ezResource* pResource);
 
+  ///@}
+  /// \name Memory budgets
+  ///@{
+
+public:
+  /// \brief Sets a memory budget for all resources together. An unset budget (the default) means no limit.
+  ///
+  /// The budgets are enforced once per frame in PerFrameUpdate(). See ezResourceMemoryBudget for details.
+  static void SetMemoryBudget(const ezResourceMemoryBudget& budget);
+
+  /// \brief Returns the memory budget for all resources together.
+  static ezResourceMemoryBudget GetMemoryBudget();
+
+  /// \brief Sets a memory budget for all resources of the given type. Each derived type has its own budget.
+  template <typename ResourceType>
+  static void SetMemoryBudgetForResourceType(const ezResourceMemoryBudget& budget)
+  {
+    SetMemoryBudgetForResourceType(ezGetStaticRTTI<ResourceType>(), budget);
+  }
+
+  /// \brief Sets a memory budget for all resources of the given type. Each derived type has its own budget.
+  static void SetMemoryBudgetForResourceType(const ezRTTI* pResourceType, const ezResourceMemoryBudget& budget);
+
+  /// \brief Returns the memory used by all resources of the given type, or by all resources, if nullptr is given.
+  static ezResource::MemoryUsage GetMemoryUsage(const ezRTTI* pResourceType = nullptr);
+
+  /// \brief Evicts resource data until all memory budgets are met. Returns how many quality levels and resources were evicted.
+  ///
+  /// This is called by PerFrameUpdate() and only needs to be called manually to apply changed budgets right away.
+  static ezUInt32 EnforceMemoryBudgets();
+
+  /// \brief Excludes a resource from being evicted to meet memory budgets, or allows it again.
+  ///
+  /// The resource priority has no influence on whether a resource may be evicted, it only decides the order.
+  static void SetPreventEviction(const ezTypelessResourceHandle& hResource, bool bPrevent);
+
+private:
+  struct MemoryBudgetState
+  {
+    ezResourceMemoryBudget m_Budget;
+    bool m_bExceeded = false;             ///< Set from exceeding the budget until getting below the eviction target again.
+    bool m_bAllowQualityUpgrades = true;  ///< False while the usage is above the eviction target.
+  };
+
+  static ezUInt32 EnforceMemoryBudget(const ezRTTI* pResourceType, MemoryBudgetState& state);
+  static ezResource::MemoryUsage ComputeMemoryUsage(const ezRTTI* pResourceType);
+  static bool IsQualityUpgradeAllowed(const ezResource* pResource);
+
+  ///@}
+  /// \name Streaming
+  ///@{
+
+public:
+  /// \brief Configures the budgets and the prioritization of resource loading.
+  static void SetStreamingSettings(const ezResourceStreamingSettings& settings);
+
+  /// \brief Returns the current streaming settings.
+  static ezResourceStreamingSettings GetStreamingSettings();
+
+  /// \brief Returns statistics about resource loading. Rates and latencies are updated once per second in PerFrameUpdate().
+  static ezResourceStreamingStats GetStreamingStats();
+
+private:
+  static void UpdateStreamingStats();
+
   ///@}
   /// \name Miscellaneous
   ///@{
@@ -450,6 +515,7 @@ private:
   {
     float m_fPriority = 0;
     ezResource* m_pResource = nullptr;
+    ezTime m_QueuedTime;
 
     EZ_ALWAYS_INLINE bool operator==(const LoadingInfo& rhs) const { return m_pResource == rhs.m_pResource; }
     EZ_ALWAYS_INLINE bool operator<(const LoadingInfo& rhs) const { return m_fPriority < rhs.m_fPriority; }
@@ -461,9 +527,10 @@ private:
   template <typename ResourceType>
   static ResourceType* GetResource(const char* szResourceID, bool bIsReloadable);
   static ezResource* GetResource(const ezRTTI* pRtti, const char* szResourceID, bool bIsReloadable);
-  static void RunWorkerTask(ezResource* pResource);
+  static void RunWorkerTask(bool bIgnoreBudget = false);
   static void UpdateLoadingDeadlines();
-  static void ReverseBubbleSortStep(ezDeque<LoadingInfo>& data);
+  static bool TakeNextLoadingRequest(LoadingInfo& out_request);
+  static void FinishLoadingRequest(ezTime queuedTime, ezUInt64 uiDataSize);
   static bool ReloadResource(ezResource* pResource, bool bForce);
 
   static void SetupWorkerTasks();
@@ -480,6 +547,8 @@ private:
     bool m_bIncrementalUnload = true;
     bool m_bAllowNestedAcquireCached = false;
 
+    MemoryBudgetState m_MemoryBudget;
+
     ezHybridArray<const ezRTTI*, 8> m_NestedTypes;
   };
 
@@ -19,6 +19,9 @@ struct EZ_CORE_DLL ezResourceLoadData
 
   /// Custom loader data, e.g. a pointer to a custom memory block, that needs to be freed when the resource is done updating.
   void* m_pCustomLoaderData = nullptr;
+
+  /// Number of bytes that were loaded, if known. Used for the streaming budget and statistics, see ezResourceStreamingSettings.
+  ezUInt64 m_uiDataSize = 0;
 };
 
 /// \brief Base class for all resource loaders.
@@ -0,0 +1,981 @@
+#include <Core/CorePCH.h>
+
+#include <Core/World/SpatialSystem_Bvh.h>
+#include <Foundation/Algorithm/Sorting.h>
+#include <Foundation/Profiling/Profiling.h>
+#include <Foundation/SimdMath/SimdConversion.h>
+#include <Foundation/Time/Stopwatch.h>
+
+namespace
+{
+  enum
+  {
+    OBJECT_FLAG = 0x80000000u,
+    MIN_NUM_CHANGES_FOR_REBUILD = 64
+  };
+
+  EZ_ALWAYS_INLINE bool IsObject(ezUInt32 uiChild)
+  {
+    return (uiChild & OBJECT_FLAG) != 0;
+  }
+
+  EZ_ALWAYS_INLINE bool FilterByTags(const ezTagSet& tags, const ezTagSet& includeTags, const ezTagSet& excludeTags)
+  {
+    if (!excludeTags.IsEmpty() && excludeTags.IsAnySet(tags))
+      return true;
+
+    if (!includeTags.IsEmpty() && !includeTags.IsAnySet(tags))
+      return true;
+
+    return false;
+  }
+
+  EZ_ALWAYS_INLINE ezSimdVec4b GetLaneMask(ezUInt32 uiSlot)
+  {
+    return ezSimdVec4b(uiSlot == 0, uiSlot == 1, uiSlot == 2, uiSlot == 3);
+  }
+
+  EZ_ALWAYS_INLINE ezUInt32 GetBitmask(const ezSimdVec4b& b)
+  {
+    return (b.x() ? 1u : 0u) | (b.y() ? 2u : 0u) | (b.z() ? 4u : 0u) | (b.w() ? 8u : 0u);
+  }
+
+  EZ_ALWAYS_INLINE float GetLane(const ezSimdVec4f& v, ezUInt32 uiSlot)
+  {
+    float values[4];
+    v.Store<4>(values);
+    return values[uiSlot];
+  }
+
+  EZ_ALWAYS_INLINE float GetHalfSurfaceArea(const ezSimdBBox& box)
+  {
+    const ezSimdVec4f e = box.GetExtents();
+    return e.x() * e.y() + e.y() * e.z() + e.z() * e.x();
+  }
+
+  /// Objects are tested with their bounding spheres, so the tree has to contain these rather than the bounding boxes.
+  EZ_ALWAYS_INLINE ezSimdBBox GetNodeBoxForObject(const ezSimdBSphere& sphere, const ezSimdVec4f& vMargin)
+  {
+    ezSimdBBox box;
+    box.SetCenterAndHalfExtents(sphere.m_CenterAndRadius, sphere.m_CenterAndRadius.Get<ezSwizzle::WWWW>() + vMargin);
+    return box;
+  }
+
+  struct CenterComparer
+  {
+    EZ_ALWAYS_INLINE bool Less(ezUInt32 a, ezUInt32 b) const { return m_pCenters[a].GetData()[m_uiAxis] < m_pCenters[b].GetData()[m_uiAxis]; }
+    EZ_ALWAYS_INLINE bool Equal(ezUInt32 a, ezUInt32 b) const { return m_pCenters[a].GetData()[m_uiAxis] == m_pCenters[b].GetData()[m_uiAxis]; }
+
+    const ezVec3* m_pCenters;
+    ezUInt32 m_uiAxis;
+  };
+
+  /// Sorts the objects along the longest axis of their centers and returns the index at which the array should be split.
+  ezUInt32 SplitObjects(ezArrayPtr<ezUInt32> objects, ezArrayPtr<const ezVec3> centers)
+  {
+    ezBoundingBox centerBounds;
+    centerBounds.SetInvalid();
+
+    for (ezUInt32 uiObject : objects)
+    {
+      centerBounds.ExpandToInclude(centers[uiObject]);
+    }
+
+    const ezVec3 vExtents = centerBounds.GetExtents();
+
+    CenterComparer comparer;
+    comparer.m_pCenters = centers.GetPtr();
+    comparer.m_uiAxis = (vExtents.x >= vExtents.y && vExtents.x >= vExtents.z) ? 0 : (vExtents.y >= vExtents.z ? 1 : 2);
+
+    ezSorting::QuickSort(objects, comparer);
+
+    return objects.GetCount() / 2;
+  }
+} // namespace
+
+//////////////////////////////////////////////////////////////////////////
+
+template <typename Functor>
+void ezSpatialSystem_Bvh::ForEachAlwaysVisibleObject(const QueryParams& queryParams, Functor func) const
+{
+  for (ezUInt32 uiObject : m_AlwaysVisibleData)
+  {
+    if ((m_DataTable.GetValueUnchecked(uiObject).m_uiCategoryBitmask & queryParams.m_uiCategoryBitmask) == 0)
+      continue;
+
+    if (FilterByTags(m_TagSets[uiObject], queryParams.m_IncludeTags, queryParams.m_ExcludeTags))
+      continue;
+
+    if (func(uiObject) == ezVisitorExecution::Stop)
+      return;
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+namespace ezInternal
+{
+  struct BvhQueryHelper
+  {
+    using Node = ezSpatialSystem_Bvh::Node;
+
+    struct Stats
+    {
+      ezUInt32 m_uiNumObjectsTested = 0;
+      ezUInt32 m_uiNumObjectsPassed = 0;
+    };
+
+    struct SphereShape
+    {
+      explicit SphereShape(const ezSimdBSphere& sphere)
+        : m_Sphere(sphere)
+        , m_CenterX(sphere.m_CenterAndRadius.Get<ezSwizzle::XXXX>())
+        , m_CenterY(sphere.m_CenterAndRadius.Get<ezSwizzle::YYYY>())
+        , m_CenterZ(sphere.m_CenterAndRadius.Get<ezSwizzle::ZZZZ>())
+        , m_RadiusSquared(sphere.m_CenterAndRadius.Get<ezSwizzle::WWWW>().CompMul(sphere.m_CenterAndRadius.Get<ezSwizzle::WWWW>()))
+      {
+      }
+
+      EZ_FORCE_INLINE ezUInt32 TestNode(const Node& node) const
+      {
+        const ezSimdVec4f zero = ezSimdVec4f::ZeroVector();
+
+        // distance from the sphere center to the closest point of each box
+        const ezSimdVec4f dx = (node.m_MinX - m_CenterX).CompMax(m_CenterX - node.m_MaxX).CompMax(zero);
+        const ezSimdVec4f dy = (node.m_MinY - m_CenterY).CompMax(m_CenterY - node.m_MaxY).CompMax(zero);
+        const ezSimdVec4f dz = (node.m_MinZ - m_CenterZ).CompMax(m_CenterZ - node.m_MaxZ).CompMax(zero);
+
+        ezSimdVec4f distSquared = dx.CompMul(dx);
+        distSquared = ezSimdVec4f::MulAdd(dy, dy, distSquared);
+        distSquared = ezSimdVec4f::MulAdd(dz, dz, distSquared);
+
+        return GetBitmask(distSquared <= m_RadiusSquared);
+      }
+
+      EZ_ALWAYS_INLINE bool TestObject(const ezSimdBSphere& sphere) const { return m_Sphere.Overlaps(sphere); }
+
+      ezSimdBSphere m_Sphere;
+      ezSimdVec4f m_CenterX;
+      ezSimdVec4f m_CenterY;
+      ezSimdVec4f m_CenterZ;
+      ezSimdVec4f m_RadiusSquared;
+    };
+
+    struct BoxShape
+    {
+      explicit BoxShape(const ezSimdBBox& box)
+        : m_Box(box)
+        , m_MinX(box.m_Min.Get<ezSwizzle::XXXX>())
+        , m_MinY(box.m_Min.Get<ezSwizzle::YYYY>())
+        , m_MinZ(box.m_Min.Get<ezSwizzle::ZZZZ>())
+        , m_MaxX(box.m_Max.Get<ezSwizzle::XXXX>())
+        , m_MaxY(box.m_Max.Get<ezSwizzle::YYYY>())
+        , m_MaxZ(box.m_Max.Get<ezSwizzle::ZZZZ>())
+      {
+      }
+
+      EZ_FORCE_INLINE ezUInt32 TestNode(const Node& node) const
+      {
+        const ezSimdVec4b overlapsX = (node.m_MinX <= m_MaxX) && (node.m_MaxX >= m_MinX);
+        const ezSimdVec4b overlapsY = (node.m_MinY <= m_MaxY) && (node.m_MaxY >= m_MinY);
+        const ezSimdVec4b overlapsZ = (node.m_MinZ <= m_MaxZ) && (node.m_MaxZ >= m_MinZ);
+
+        return GetBitmask(overlapsX && overlapsY && overlapsZ);
+      }
+
+      EZ_ALWAYS_INLINE bool TestObject(const ezSimdBSphere& sphere) const { return m_Box.Overlaps(sphere); }
+
+      ezSimdBBox m_Box;
+      ezSimdVec4f m_MinX;
+      ezSimdVec4f m_MinY;
+      ezSimdVec4f m_MinZ;
+      ezSimdVec4f m_MaxX;
+      ezSimdVec4f m_MaxY;
+      ezSimdVec4f m_MaxZ;
+    };
+
+    struct FrustumShape
+    {
+      explicit FrustumShape(const ezFrustum& frustum)
+      {
+        ezSimdVec4f planes[6];
+        for (ezUInt32 i = 0; i < 6; ++i)
+        {
+          const ezPlane& plane = frustum.GetPlane(i);
+          planes[i] = ezSimdVec4f(plane.m_vNormal.x, plane.m_vNormal.y, plane.m_vNormal.z, plane.m_fNegDistance);
+
+          m_PlaneX[i] = planes[i].Get<ezSwizzle::XXXX>();
+          m_PlaneY[i] = planes[i].Get<ezSwizzle::YYYY>();
+          m_PlaneZ[i] = planes[i].Get<ezSwizzle::ZZZZ>();
+          m_PlaneW[i] = planes[i].Get<ezSwizzle::WWWW>();
+        }
+
+        // transposed planes for testing one sphere against all planes at once, the last two planes are duplicated to fill four lanes
+        ezSimdMat4f helperMat;
+        helperMat.SetRows(planes[0], planes[1], planes[2], planes[3]);
+        m_Planes0123[0] = helperMat.m_col0;
+        m_Planes0123[1] = helperMat.m_col1;
+        m_Planes0123[2] = helperMat.m_col2;
+        m_Planes0123[3] = helperMat.m_col3;
+
+        helperMat.SetRows(planes[4], planes[5], planes[4], planes[5]);
+        m_Planes4545[0] = helperMat.m_col0;
+        m_Planes4545[1] = helperMat.m_col1;
+        m_Planes4545[2] = helperMat.m_col2;
+        m_Planes4545[3] = helperMat.m_col3;
+      }
+
+      EZ_FORCE_INLINE ezUInt32 TestNode(const Node& node) const
+      {
+        const ezSimdFloat half(0.5f);
+
+        const ezSimdVec4f centerX = (node.m_MinX + node.m_MaxX) * half;
+        const ezSimdVec4f centerY = (node.m_MinY + node.m_MaxY) * half;
+        const ezSimdVec4f centerZ = (node.m_MinZ + node.m_MaxZ) * half;
+        const ezSimdVec4f halfExtentsX = (node.m_MaxX - node.m_MinX) * half;
+        const ezSimdVec4f halfExtentsY = (node.m_MaxY - node.m_MinY) * half;
+        const ezSimdVec4f halfExtentsZ = (node.m_MaxZ - node.m_MinZ) * half;
+
+        ezSimdVec4b outside(false);
+
+        for (ezUInt32 i = 0; i < 6; ++i)
+        {
+          // a box is outside of a plane if the box corner closest to the plane is outside
+          ezSimdVec4f dist = ezSimdVec4f::MulAdd(centerX, m_PlaneX[i], m_PlaneW[i]);
+          dist = ezSimdVec4f::MulAdd(centerY, m_PlaneY[i], dist);
+          dist = ezSimdVec4f::MulAdd(centerZ, m_PlaneZ[i], dist);
+
+          ezSimdVec4f radius = halfExtentsX.CompMul(m_PlaneX[i].Abs());
+          radius = ezSimdVec4f::MulAdd(halfExtentsY, m_PlaneY[i].Abs(), radius);
+          radius = ezSimdVec4f::MulAdd(halfExtentsZ, m_PlaneZ[i].Abs(), radius);
+
+          outside = outside || (dist > radius);
+        }
+
+        return GetBitmask(!outside);
+      }
+
+      EZ_FORCE_INLINE bool TestObject(const ezSimdBSphere& sphere) const
+      {
+        const ezSimdVec4f x = sphere.m_CenterAndRadius.Get<ezSwizzle::XXXX>();
+        const ezSimdVec4f y = sphere.m_CenterAndRadius.Get<ezSwizzle::YYYY>();
+        const ezSimdVec4f z = sphere.m_CenterAndRadius.Get<ezSwizzle::ZZZZ>();
+        const ezSimdVec4f r = sphere.m_CenterAndRadius.Get<ezSwizzle::WWWW>();
+
+        ezSimdVec4f dist0123 = ezSimdVec4f::MulAdd(x, m_Planes0123[0], m_Planes0123[3]);
+        dist0123 = ezSimdVec4f::MulAdd(y, m_Planes0123[1], dist0123);
+        dist0123 = ezSimdVec4f::MulAdd(z, m_Planes0123[2], dist0123);
+
+        ezSimdVec4f dist4545 = ezSimdVec4f::MulAdd(x, m_Planes4545[0], m_Planes4545[3]);
+        dist4545 = ezSimdVec4f::MulAdd(y, m_Planes4545[1], dist4545);
+        dist4545 = ezSimdVec4f::MulAdd(z, m_Planes4545[2], dist4545);
+
+        return ((dist0123 > r) || (dist4545 > r)).NoneSet<4>();
+      }
+
+      // plane components broadcast to all lanes, for testing the four children of a node against one plane at a time
+      ezSimdVec4f m_PlaneX[6];
+      ezSimdVec4f m_PlaneY[6];
+      ezSimdVec4f m_PlaneZ[6];
+      ezSimdVec4f m_PlaneW[6];
+
+      ezSimdVec4f m_Planes0123[4];
+      ezSimdVec4f m_Planes4545[4];
+    };
+
+    template <typename Shape, bool UseTagsFilter, typename Visitor>
+    static ezVisitorExecution::Enum Traverse(const ezSpatialSystem_Bvh& system, const Shape& shape, const ezSpatialSystem::QueryParams& queryParams, Stats& stats, Visitor visitor)
+    {
+      if (system.m_uiRootNode == ezInvalidIndex)
+        return ezVisitorExecution::Continue;
+
+      ezHybridArray<ezUInt32, 64> nodeStack;
+      nodeStack.PushBack(system.m_uiRootNode);
+
+      while (!nodeStack.IsEmpty())
+      {
+        const Node& node = system.m_Nodes[nodeStack.PeekBack()];
+        nodeStack.PopBack();
+
+        ezUInt32 uiMask = shape.TestNode(node) & ((1u << node.m_uiNumChildren) - 1);
+
+        while (uiMask > 0)
+        {
+          const ezUInt32 i = ezMath::FirstBitLow(uiMask);
+          uiMask &= uiMask - 1;
+
+          if ((node.m_CategoryBitmasks[i] & queryParams.m_uiCategoryBitmask) == 0)
+            continue;
+
+          const ezUInt32 uiChild = node.m_Children[i];
+          if (!IsObject(uiChild))
+          {
+            nodeStack.PushBack(uiChild);
+            continue;
+          }
+
+          const ezUInt32 uiObject = uiChild & ~OBJECT_FLAG;
+          stats.m_uiNumObjectsTested++;
+
+          if (!shape.TestObject(system.m_BoundingSpheres[uiObject]))
+            continue;
+
+          if (UseTagsFilter)
+          {
+            if (FilterByTags(system.m_TagSets[uiObject], queryParams.m_IncludeTags, queryParams.m_ExcludeTags))
+              continue;
+          }
+
+          stats.m_uiNumObjectsPassed++;
+
+          if (visitor(uiObject) == ezVisitorExecution::Stop)
+            return ezVisitorExecution::Stop;
+        }
+      }
+
+      return ezVisitorExecution::Continue;
+    }
+
+    template <typename Shape, typename Visitor>
+    static void Query(const ezSpatialSystem_Bvh& system, const Shape& shape, const ezSpatialSystem::QueryParams& queryParams, Visitor visitor)
+    {
+      Stats stats;
+
+      const bool useTagsFilter = queryParams.m_IncludeTags.IsEmpty() == false || queryParams.m_ExcludeTags.IsEmpty() == false;
+      const ezVisitorExecution::Enum result = useTagsFilter ? Traverse<Shape, true>(system, shape, queryParams, stats, visitor) : Traverse<Shape, false>(system, shape, queryParams, stats, visitor);
+
+      // always visible data is not part of the tree, it passes every shape test
+      if (result == ezVisitorExecution::Continue)
+      {
+        system.ForEachAlwaysVisibleObject(queryParams, visitor);
+      }
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+      if (queryParams.m_pStats != nullptr)
+      {
+        queryParams.m_pStats->m_uiTotalNumObjects = system.m_DataTable.GetCount();
+        queryParams.m_pStats->m_uiNumObjectsTested += stats.m_uiNumObjectsTested;
+        queryParams.m_pStats->m_uiNumObjectsPassed += stats.m_uiNumObjectsPassed;
+      }
+#endif
+    }
+  };
+} // namespace ezInternal
+
+//////////////////////////////////////////////////////////////////////////
+
+EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezSpatialSystem_Bvh, 1, ezRTTINoAllocator)
+EZ_END_DYNAMIC_REFLECTED_TYPE;
+
+ezSpatialSystem_Bvh::ezSpatialSystem_Bvh(float fBoundsMargin /*= 1.0f*/)
+  : m_AlignedAllocator("Spatial System Aligned", ezFoundation::GetAlignedAllocator())
+  , m_vBoundsMargin(ezMath::Max(fBoundsMargin, 0.0f))
+  , m_Nodes(&m_AlignedAllocator)
+  , m_FreeNodes(&m_Allocator)
+  , m_NodeBoxes(&m_AlignedAllocator)
+  , m_BoundingSpheres(&m_AlignedAllocator)
+  , m_TagSets(&m_Allocator)
+  , m_ObjectPointers(&m_Allocator)
+  , m_LastVisibleFrames(&m_Allocator)
+  , m_ObjectLocations(&m_Allocator)
+  , m_AlwaysVisibleData(&m_Allocator)
+  , m_DataTable(&m_Allocator)
+{
+  EZ_CHECK_AT_COMPILETIME(sizeof(Data) == 8);
+}
+
+ezSpatialSystem_Bvh::~ezSpatialSystem_Bvh() = default;
+
+void ezSpatialSystem_Bvh::GetAllNodeBoxes(ezDynamicArray<ezBoundingBox>& out_BoundingBoxes) const
+{
+  if (m_uiRootNode == ezInvalidIndex)
+    return;
+
+  ezHybridArray<ezUInt32, 64> nodeStack;
+  nodeStack.PushBack(m_uiRootNode);
+
+  while (!nodeStack.IsEmpty())
+  {
+    const ezUInt32 uiNode = nodeStack.PeekBack();
+    nodeStack.PopBack();
+
+    const ezSimdBBox box = GetNodeBox(uiNode);
+    out_BoundingBoxes.ExpandAndGetRef() = ezBoundingBox(ezSimdConversion::ToVec3(box.m_Min), ezSimdConversion::ToVec3(box.m_Max));
+
+    const Node& node = m_Nodes[uiNode];
+    for (ezUInt32 i = 0; i < node.m_uiNumChildren; ++i)
+    {
+      if (!IsObject(node.m_Children[i]))
+      {
+        nodeStack.PushBack(node.m_Children[i]);
+      }
+    }
+  }
+}
+
+ezUInt32 ezSpatialSystem_Bvh::GetTreeDepth() const
+{
+  if (m_uiRootNode == ezInvalidIndex)
+    return 0;
+
+  ezUInt32 uiMaxDepth = 0;
+
+  ezHybridArray<ezUInt64, 64> nodeStack;
+  nodeStack.PushBack((1ull << 32) | m_uiRootNode);
+
+  while (!nodeStack.IsEmpty())
+  {
+    const ezUInt32 uiNode = static_cast<ezUInt32>(nodeStack.PeekBack());
+    const ezUInt32 uiDepth = static_cast<ezUInt32>(nodeStack.PeekBack() >> 32);
+    nodeStack.PopBack();
+
+    uiMaxDepth = ezMath::Max(uiMaxDepth, uiDepth);
+
+    const Node& node = m_Nodes[uiNode];
+    for (ezUInt32 i = 0; i < node.m_uiNumChildren; ++i)
+    {
+      if (!IsObject(node.m_Children[i]))
+      {
+        nodeStack.PushBack((static_cast<ezUInt64>(uiDepth + 1) << 32) | node.m_Children[i]);
+      }
+    }
+  }
+
+  return uiMaxDepth;
+}
+
+void ezSpatialSystem_Bvh::StartNewFrame()
+{
+  SUPER::StartNewFrame();
+
+  // Moving objects are only re-inserted, which keeps the tree in a reasonable shape. Adding or removing many objects, e.g. while a scene is loaded,
+  // can result in a badly balanced tree though, so it is rebuilt in that case.
+  const ezUInt32 uiNumObjectsInTree = m_DataTable.GetCount() - m_AlwaysVisibleData.GetCount();
+  if (m_uiNumChangesSinceRebuild >= MIN_NUM_CHANGES_FOR_REBUILD && m_uiNumChangesSinceRebuild * 4 >= uiNumObjectsInTree)
+  {
+    Rebuild();
+  }
+}
+
+ezSpatialDataHandle ezSpatialSystem_Bvh::CreateSpatialData(const ezSimdBBoxSphere& bounds, ezGameObject* pObject, ezUInt32 uiCategoryBitmask, const ezTagSet& tags)
+{
+  if (uiCategoryBitmask == 0)
+    return ezSpatialDataHandle();
+
+  return AddSpatialData(bounds, pObject, uiCategoryBitmask, tags, false);
+}
+
+ezSpatialDataHandle ezSpatialSystem_Bvh::CreateSpatialDataAlwaysVisible(ezGameObject* pObject, ezUInt32 uiCategoryBitmask, const ezTagSet& tags)
+{
+  if (uiCategoryBitmask == 0)
+    return ezSpatialDataHandle();
+
+  return AddSpatialData(ezSimdBBoxSphere(ezSimdVec4f::ZeroVector(), ezSimdVec4f::ZeroVector(), 0.0f), pObject, uiCategoryBitmask, tags, true);
+}
+
+void ezSpatialSystem_Bvh::DeleteSpatialData(const ezSpatialDataHandle& hData)
+{
+  Data oldData;
+  EZ_VERIFY(m_DataTable.Remove(hData.GetInternalID(), &oldData), "Invalid spatial data handle");
+
+  const ezUInt32 uiObject = hData.GetInternalID().m_InstanceIndex;
+
+  if (oldData.m_uiAlwaysVisible != 0)
+  {
+    const ezUInt32 uiIndex = m_ObjectLocations[uiObject].m_uiSlot;
+    m_AlwaysVisibleData.RemoveAtAndSwap(uiIndex);
+
+    if (uiIndex < m_AlwaysVisibleData.GetCount())
+    {
+      m_ObjectLocations[m_AlwaysVisibleData[uiIndex]].m_uiSlot = uiIndex;
+    }
+
+    m_ObjectLocations[uiObject] = {};
+  }
+  else
+  {
+    RemoveObject(uiObject);
+    ++m_uiNumChangesSinceRebuild;
+  }
+
+  m_TagSets[uiObject].Clear();
+  m_ObjectPointers[uiObject] = nullptr;
+}
+
+void ezSpatialSystem_Bvh::UpdateSpatialDataBounds(const ezSpatialDataHandle& hData, const ezSimdBBoxSphere& bounds)
+{
+  Data* pData = nullptr;
+  EZ_VERIFY(m_DataTable.TryGetValue(hData.GetInternalID(), pData), "Invalid spatial data handle");
+
+  // No need to update bounds for always visible data
+  if (pData->m_uiAlwaysVisible != 0)
+    return;
+
+  const ezUInt32 uiObject = hData.GetInternalID().m_InstanceIndex;
+  const ezSimdBSphere sphere = bounds.GetSphere();
+  m_BoundingSpheres[uiObject] = sphere;
+
+  if (m_NodeBoxes[uiObject].Contains(sphere))
+    return;
+
+  RemoveObject(uiObject);
+
+  m_NodeBoxes[uiObject] = GetNodeBoxForObject(sphere, m_vBoundsMargin);
+
+  InsertObject(uiObject, pData->m_uiCategoryBitmask);
+}
+
+void ezSpatialSystem_Bvh::UpdateSpatialDataObject(const ezSpatialDataHandle& hData, ezGameObject* pObject)
+{
+  EZ_VERIFY(m_DataTable.Contains(hData.GetInternalID()), "Invalid spatial data handle");
+
+  m_ObjectPointers[hData.GetInternalID().m_InstanceIndex] = pObject;
+}
+
+void ezSpatialSystem_Bvh::FindObjectsInSphere(const ezBoundingSphere& sphere, const QueryParams& queryParams, QueryCallback callback) const
+{
+  EZ_PROFILE_SCOPE("FindObjectsInSphere");
+
+  const ezInternal::BvhQueryHelper::SphereShape shape(ezSimdBSphere(ezSimdConversion::ToVec3(sphere.m_vCenter), sphere.m_fRadius));
+
+  auto visitor = [&](ezUInt32 uiObject) {
+    return callback(m_ObjectPointers[uiObject]);
+  };
+
+  ezInternal::BvhQueryHelper::Query(*this, shape, queryParams, visitor);
+}
+
+void ezSpatialSystem_Bvh::FindObjectsInBox(const ezBoundingBox& box, const QueryParams& queryParams, QueryCallback callback) const
+{
+  EZ_PROFILE_SCOPE("FindObjectsInBox");
+
+  const ezInternal::BvhQueryHelper::BoxShape shape(ezSimdBBox(ezSimdConversion::ToVec3(box.m_vMin), ezSimdConversion::ToVec3(box.m_vMax)));
+
+  auto visitor = [&](ezUInt32 uiObject) {
+    return callback(m_ObjectPointers[uiObject]);
+  };
+
+  ezInternal::BvhQueryHelper::Query(*this, shape, queryParams, visitor);
+}
+
+void ezSpatialSystem_Bvh::FindVisibleObjects(const ezFrustum& frustum, const QueryParams& queryParams, ezDynamicArray<const ezGameObject*>& out_Objects) const
+{
+  EZ_PROFILE_SCOPE("FindVisibleObjects");
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+  ezStopwatch timer;
+#endif
+
+  const ezInternal::BvhQueryHelper::FrustumShape shape(frustum);
+
+  auto visitor = [&](ezUInt32 uiObject) {
+    m_LastVisibleFrames[uiObject] = m_uiFrameCounter;
+    out_Objects.PushBack(m_ObjectPointers[uiObject]);
+    return ezVisitorExecution::Continue;
+  };
+
+  ezInternal::BvhQueryHelper::Query(*this, shape, queryParams, visitor);
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+  if (queryParams.m_pStats != nullptr)
+  {
+    queryParams.m_pStats->m_TimeTaken = timer.GetRunningTotal();
+  }
+#endif
+}
+
+ezUInt64 ezSpatialSystem_Bvh::GetNumFramesSinceVisible(const ezSpatialDataHandle& hData) const
+{
+  Data* pData = nullptr;
+  EZ_VERIFY(m_DataTable.TryGetValue(hData.GetInternalID(), pData), "Invalid spatial data handle");
+
+  if (pData->m_uiAlwaysVisible != 0)
+    return 0;
+
+  const ezUInt64 uiLastFrameVisible = m_LastVisibleFrames[hData.GetInternalID().m_InstanceIndex];
+  return (m_uiFrameCounter > uiLastFrameVisible) ? m_uiFrameCounter - uiLastFrameVisible : 0;
+}
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+void ezSpatialSystem_Bvh::GetInternalStats(ezStringBuilder& sb) const
+{
+  sb.Format("Objects: {}\nAlways Visible: {}\nNodes: {}\nTree Depth: {}\nRebuilds: {}\nChanges since last Rebuild: {}",
+    m_DataTable.GetCount(), m_AlwaysVisibleData.GetCount(), m_Nodes.GetCount() - m_FreeNodes.GetCount(), GetTreeDepth(), m_uiNumRebuilds, m_uiNumChangesSinceRebuild);
+}
+#endif
+
+ezSpatialDataHandle ezSpatialSystem_Bvh::AddSpatialData(const ezSimdBBoxSphere& bounds, ezGameObject* pObject, ezUInt32 uiCategoryBitmask, const ezTagSet& tags, bool bAlwaysVisible)
+{
+  Data data;
+  data.m_uiCategoryBitmask = uiCategoryBitmask;
+  data.m_uiAlwaysVisible = bAlwaysVisible ? 1 : 0;
+
+  auto hData = ezSpatialDataHandle(m_DataTable.Insert(data));
+  const ezUInt32 uiObject = hData.GetInternalID().m_InstanceIndex;
+
+  if (uiObject >= m_ObjectLocations.GetCount())
+  {
+    const ezUInt32 uiNewCount = uiObject + 1;
+    m_NodeBoxes.SetCountUninitialized(uiNewCount);
+    m_BoundingSpheres.SetCountUninitialized(uiNewCount);
+    m_TagSets.SetCount(uiNewCount);
+    m_ObjectPointers.SetCount(uiNewCount);
+    m_LastVisibleFrames.SetCount(uiNewCount);
+    m_ObjectLocations.SetCount(uiNewCount);
+  }
+
+  m_BoundingSpheres[uiObject] = bounds.GetSphere();
+  m_TagSets[uiObject] = tags;
+  m_ObjectPointers[uiObject] = pObject;
+  m_LastVisibleFrames[uiObject] = m_uiFrameCounter;
+
+  if (bAlwaysVisible)
+  {
+    m_ObjectLocations[uiObject] = {ezInvalidIndex, m_AlwaysVisibleData.GetCount()};
+    m_AlwaysVisibleData.PushBack(uiObject);
+  }
+  else
+  {
+    m_NodeBoxes[uiObject] = GetNodeBoxForObject(bounds.GetSphere(), m_vBoundsMargin);
+
+    InsertObject(uiObject, uiCategoryBitmask);
+    ++m_uiNumChangesSinceRebuild;
+  }
+
+  return hData;
+}
+
+ezUInt32 ezSpatialSystem_Bvh::AllocateNode(ezUInt32 uiParent, ezUInt32 uiSlotInParent)
+{
+  ezUInt32 uiNode = 0;
+  if (!m_FreeNodes.IsEmpty())
+  {
+    uiNode = m_FreeNodes.PeekBack();
+    m_FreeNodes.PopBack();
+  }
+  else
+  {
+    uiNode = m_Nodes.GetCount();
+    m_Nodes.ExpandAndGetRef();
+  }
+
+  const ezSimdVec4f vMax(ezMath::MaxValue<float>());
+
+  Node& node = m_Nodes[uiNode];
+  node.m_MinX = vMax;
+  node.m_MinY = vMax;
+  node.m_MinZ = vMax;
+  node.m_MaxX = -vMax;
+  node.m_MaxY = -vMax;
+  node.m_MaxZ = -vMax;
+
+  for (ezUInt32 i = 0; i < 4; ++i)
+  {
+    node.m_Children[i] = ezInvalidIndex;
+    node.m_CategoryBitmasks[i] = 0;
+  }
+
+  node.m_uiParent = uiParent;
+  node.m_uiSlotInParent = uiSlotInParent;
+  node.m_uiNumChildren = 0;
+
+  return uiNode;
+}
+
+void ezSpatialSystem_Bvh::FreeNode(ezUInt32 uiNode)
+{
+  m_Nodes[uiNode].m_uiNumChildren = 0;
+  m_FreeNodes.PushBack(uiNode);
+}
+
+void ezSpatialSystem_Bvh::SetChild(ezUInt32 uiNode, ezUInt32 uiSlot, ezUInt32 uiChild, const ezSimdBBox& box, ezUInt32 uiCategoryBitmask)
+{
+  const ezSimdVec4b lane = GetLaneMask(uiSlot);
+
+  Node& node = m_Nodes[uiNode];
+  node.m_MinX = ezSimdVec4f::Select(lane, box.m_Min.Get<ezSwizzle::XXXX>(), node.m_MinX);
+  node.m_MinY = ezSimdVec4f::Select(lane, box.m_Min.Get<ezSwizzle::YYYY>(), node.m_MinY);
+  node.m_MinZ = ezSimdVec4f::Select(lane, box.m_Min.Get<ezSwizzle::ZZZZ>(), node.m_MinZ);
+  node.m_MaxX = ezSimdVec4f::Select(lane, box.m_Max.Get<ezSwizzle::XXXX>(), node.m_MaxX);
+  node.m_MaxY = ezSimdVec4f::Select(lane, box.m_Max.Get<ezSwizzle::YYYY>(), node.m_MaxY);
+  node.m_MaxZ = ezSimdVec4f::Select(lane, box.m_Max.Get<ezSwizzle::ZZZZ>(), node.m_MaxZ);
+  node.m_Children[uiSlot] = uiChild;
+  node.m_CategoryBitmasks[uiSlot] = uiCategoryBitmask;
+
+  if (IsObject(uiChild))
+  {
+    m_ObjectLocations[uiChild & ~OBJECT_FLAG] = {uiNode, uiSlot};
+  }
+  else
+  {
+    Node& childNode = m_Nodes[uiChild];
+    childNode.m_uiParent = uiNode;
+    childNode.m_uiSlotInParent = uiSlot;
+  }
+}
+
+void ezSpatialSystem_Bvh::ClearChild(ezUInt32 uiNode, ezUInt32 uiSlot)
+{
+  const ezSimdVec4b lane = GetLaneMask(uiSlot);
+  const ezSimdVec4f vMax(ezMath::MaxValue<float>());
+
+  Node& node = m_Nodes[uiNode];
+  node.m_MinX = ezSimdVec4f::Select(lane, vMax, node.m_MinX);
+  node.m_MinY = ezSimdVec4f::Select(lane, vMax, node.m_MinY);
+  node.m_MinZ = ezSimdVec4f::Select(lane, vMax, node.m_MinZ);
+  node.m_MaxX = ezSimdVec4f::Select(lane, -vMax, node.m_MaxX);
+  node.m_MaxY = ezSimdVec4f::Select(lane, -vMax, node.m_MaxY);
+  node.m_MaxZ = ezSimdVec4f::Select(lane, -vMax, node.m_MaxZ);
+  node.m_Children[uiSlot] = ezInvalidIndex;
+  node.m_CategoryBitmasks[uiSlot] = 0;
+}
+
+ezSimdBBox ezSpatialSystem_Bvh::GetChildBox(ezUInt32 uiNode, ezUInt32 uiSlot) const
+{
+  const Node& node = m_Nodes[uiNode];
+
+  const ezSimdVec4f vMin(GetLane(node.m_MinX, uiSlot), GetLane(node.m_MinY, uiSlot), GetLane(node.m_MinZ, uiSlot));
+  const ezSimdVec4f vMax(GetLane(node.m_MaxX, uiSlot), GetLane(node.m_MaxY, uiSlot), GetLane(node.m_MaxZ, uiSlot));
+
+  return ezSimdBBox(vMin, vMax);
+}
+
+ezSimdBBox ezSpatialSystem_Bvh::GetNodeBox(ezUInt32 uiNode) const
+{
+  const Node& node = m_Nodes[uiNode];
+
+  // empty children have inverted bounds and thus don't contribute
+  const ezSimdVec4f vMin(node.m_MinX.HorizontalMin<4>(), node.m_MinY.HorizontalMin<4>(), node.m_MinZ.HorizontalMin<4>());
+  const ezSimdVec4f vMax(node.m_MaxX.HorizontalMax<4>(), node.m_MaxY.HorizontalMax<4>(), node.m_MaxZ.HorizontalMax<4>());
+
+  return ezSimdBBox(vMin, vMax);
+}
+
+ezUInt32 ezSpatialSystem_Bvh::GetNodeCategoryBitmask(ezUInt32 uiNode) const
+{
+  const Node& node = m_Nodes[uiNode];
+  return node.m_CategoryBitmasks[0] | node.m_CategoryBitmasks[1] | node.m_CategoryBitmasks[2] | node.m_CategoryBitmasks[3];
+}
+
+void ezSpatialSystem_Bvh::InsertObject(ezUInt32 uiObject, ezUInt32 uiCategoryBitmask)
+{
+  const ezSimdBBox box = m_NodeBoxes[uiObject];
+  const ezUInt32 uiChild = uiObject | OBJECT_FLAG;
+
+  if (m_uiRootNode == ezInvalidIndex)
+  {
+    m_uiRootNode = AllocateNode(ezInvalidIndex, ezInvalidIndex);
+  }
+
+  ezUInt32 uiNode = m_uiRootNode;
+  while (true)
+  {
+    const ezUInt32 uiNumChildren = m_Nodes[uiNode].m_uiNumChildren;
+    if (uiNumChildren < 4)
+    {
+      SetChild(uiNode, uiNumChildren, uiChild, box, uiCategoryBitmask);
+      m_Nodes[uiNode].m_uiNumChildren = uiNumChildren + 1;
+      return;
+    }
+
+    // descend into the child whose bounds grow the least, prefer smaller children if several don't need to grow at all
+    ezUInt32 uiBestSlot = 0;
+    float fBestCost = ezMath::MaxValue<float>();
+    float fBestArea = ezMath::MaxValue<float>();
+    ezSimdBBox bestMergedBox;
+
+    for (ezUInt32 i = 0; i < 4; ++i)
+    {
+      const ezSimdBBox childBox = GetChildBox(uiNode, i);
+      const float fArea = GetHalfSurfaceArea(childBox);
+
+      ezSimdBBox mergedBox = childBox;
+      mergedBox.ExpandToInclude(box);
+      const float fCost = GetHalfSurfaceArea(mergedBox) - fArea;
+
+      if (fCost < fBestCost || (fCost == fBestCost && fArea < fBestArea))
+      {
+        uiBestSlot = i;
+        fBestCost = fCost;
+        fBestArea = fArea;
+        bestMergedBox = mergedBox;
+      }
+    }
+
+    const ezUInt32 uiBestChild = m_Nodes[uiNode].m_Children[uiBestSlot];
+    const ezUInt32 uiBestCategoryBitmask = m_Nodes[uiNode].m_CategoryBitmasks[uiBestSlot];
+
+    if (!IsObject(uiBestChild))
+    {
+      // the object ends up somewhere below this child, so its bounds can be refitted on the way down
+      SetChild(uiNode, uiBestSlot, uiBestChild, bestMergedBox, uiBestCategoryBitmask | uiCategoryBitmask);
+      uiNode = uiBestChild;
+      continue;
+    }
+
+    // pair the existing object with the new one in a new node
+    const ezSimdBBox bestChildBox = GetChildBox(uiNode, uiBestSlot);
+    const ezUInt32 uiNewNode = AllocateNode(uiNode, uiBestSlot);
+
+    SetChild(uiNewNode, 0, uiBestChild, bestChildBox, uiBestCategoryBitmask);
+    SetChild(uiNewNode, 1, uiChild, box, uiCategoryBitmask);
+    m_Nodes[uiNewNode].m_uiNumChildren = 2;
+
+    SetChild(uiNode, uiBestSlot, uiNewNode, bestMergedBox, uiBestCategoryBitmask | uiCategoryBitmask);
+    return;
+  }
+}
+
+void ezSpatialSystem_Bvh::RemoveObject(ezUInt32 uiObject)
+{
+  const ObjectLocation location = m_ObjectLocations[uiObject];
+  EZ_ASSERT_DEBUG(location.m_uiNode != ezInvalidIndex && m_Nodes[location.m_uiNode].m_Children[location.m_uiSlot] == (uiObject | OBJECT_FLAG), "Implementation error");
+
+  m_ObjectLocations[uiObject] = {};
+
+  RemoveChildAndRefit(location.m_uiNode, location.m_uiSlot);
+}
+
+void ezSpatialSystem_Bvh::RemoveChildAndRefit(ezUInt32 uiNode, ezUInt32 uiSlot)
+{
+  const ezUInt32 uiLastSlot = m_Nodes[uiNode].m_uiNumChildren - 1;
+  if (uiSlot != uiLastSlot)
+  {
+    const Node& node = m_Nodes[uiNode];
+    SetChild(uiNode, uiSlot, node.m_Children[uiLastSlot], GetChildBox(uiNode, uiLastSlot), node.m_CategoryBitmasks[uiLastSlot]);
+  }
+
+  ClearChild(uiNode, uiLastSlot);
+
+  Node& node = m_Nodes[uiNode];
+  node.m_uiNumChildren = uiLastSlot;
+
+  if (node.m_uiParent == ezInvalidIndex)
+  {
+    if (node.m_uiNumChildren == 0)
+    {
+      FreeNode(uiNode);
+      m_uiRootNode = ezInvalidIndex;
+    }
+    else if (node.m_uiNumChildren == 1 && !IsObject(node.m_Children[0]))
+    {
+      // the only child becomes the new root
+      m_uiRootNode = node.m_Children[0];
+      m_Nodes[m_uiRootNode].m_uiParent = ezInvalidIndex;
+      m_Nodes[m_uiRootNode].m_uiSlotInParent = ezInvalidIndex;
+      FreeNode(uiNode);
+    }
+
+    return;
+  }
+
+  if (node.m_uiNumChildren == 1)
+  {
+    // a node with a single child is replaced by that child
+    const ezUInt32 uiParent = node.m_uiParent;
+    SetChild(uiParent, node.m_uiSlotInParent, node.m_Children[0], GetChildBox(uiNode, 0), node.m_CategoryBitmasks[0]);
+    FreeNode(uiNode);
+
+    Refit(uiParent);
+    return;
+  }
+
+  Refit(uiNode);
+}
+
+void ezSpatialSystem_Bvh::Refit(ezUInt32 uiNode)
+{
+  while (m_Nodes[uiNode].m_uiParent != ezInvalidIndex)
+  {
+    const ezUInt32 uiParent = m_Nodes[uiNode].m_uiParent;
+    const ezUInt32 uiSlot = m_Nodes[uiNode].m_uiSlotInParent;
+
+    const ezSimdBBox box = GetNodeBox(uiNode);
+    const ezUInt32 uiCategoryBitmask = GetNodeCategoryBitmask(uiNode);
+
+    // nothing changes further up
+    if (box == GetChildBox(uiParent, uiSlot) && uiCategoryBitmask == m_Nodes[uiParent].m_CategoryBitmasks[uiSlot])
+      return;
+
+    SetChild(uiParent, uiSlot, uiNode, box, uiCategoryBitmask);
+    uiNode = uiParent;
+  }
+}
+
+void ezSpatialSystem_Bvh::Rebuild()
+{
+  EZ_PROFILE_SCOPE("Rebuild BVH");
+
+  ezDynamicArray<ezUInt32> objects;
+  ezDynamicArray<ezVec3> centers;
+  centers.SetCountUninitialized(m_ObjectLocations.GetCount());
+
+  for (ezUInt32 i = 0; i < m_ObjectLocations.GetCount(); ++i)
+  {
+    if (m_ObjectLocations[i].m_uiNode != ezInvalidIndex)
+    {
+      objects.PushBack(i);
+      centers[i] = ezSimdConversion::ToVec3(m_NodeBoxes[i].GetCenter());
+    }
+  }
+
+  m_Nodes.Clear();
+  m_FreeNodes.Clear();
+  m_uiRootNode = ezInvalidIndex;
+
+  if (!objects.IsEmpty())
+  {
+    m_Nodes.Reserve(objects.GetCount() / 2);
+    m_uiRootNode = BuildNode(objects.GetArrayPtr(), centers.GetArrayPtr(), ezInvalidIndex, ezInvalidIndex);
+  }
+
+  m_uiNumChangesSinceRebuild = 0;
+  ++m_uiNumRebuilds;
+}
+
+ezUInt32 ezSpatialSystem_Bvh::BuildNode(ezArrayPtr<ezUInt32> objects, ezArrayPtr<const ezVec3> centers, ezUInt32 uiParent, ezUInt32 uiSlotInParent)
+{
+  const ezUInt32 uiNode = AllocateNode(uiParent, uiSlotInParent);
+  const ezUInt32 uiNumObjects = objects.GetCount();
+
+  if (uiNumObjects <= 4)
+  {
+    for (ezUInt32 i = 0; i < uiNumObjects; ++i)
+    {
+      const ezUInt32 uiObject = objects[i];
+      SetChild(uiNode, i, uiObject | OBJECT_FLAG, m_NodeBoxes[uiObject], m_DataTable.GetValueUnchecked(uiObject).m_uiCategoryBitmask);
+    }
+
+    m_Nodes[uiNode].m_uiNumChildren = uiNumObjects;
+    return uiNode;
+  }
+
+  // split into two halves along the longest axis and then split each half again
+  const ezUInt32 uiHalf = SplitObjects(objects, centers);
+  ezArrayPtr<ezUInt32> left = objects.GetSubArray(0, uiHalf);
+  ezArrayPtr<ezUInt32> right = objects.GetSubArray(uiHalf);
+
+  const ezUInt32 uiLeftHalf = SplitObjects(left, centers);
+  const ezUInt32 uiRightHalf = SplitObjects(right, centers);
+
+  ezArrayPtr<ezUInt32> ranges[4] = {left.GetSubArray(0, uiLeftHalf), left.GetSubArray(uiLeftHalf), right.GetSubArray(0, uiRightHalf), right.GetSubArray(uiRightHalf)};
+
+  for (ezUInt32 i = 0; i < 4; ++i)
+  {
+    if (ranges[i].GetCount() == 1)
+    {
+      const ezUInt32 uiObject = ranges[i][0];
+      SetChild(uiNode, i, uiObject | OBJECT_FLAG, m_NodeBoxes[uiObject], m_DataTable.GetValueUnchecked(uiObject).m_uiCategoryBitmask);
+    }
+    else
+    {
+      const ezUInt32 uiChildNode = BuildNode(ranges[i], centers, uiNode, i);
+      SetChild(uiNode, i, uiChildNode, GetNodeBox(uiChildNode), GetNodeCategoryBitmask(uiChildNode));
+    }
+  }
+
+  m_Nodes[uiNode].m_uiNumChildren = 4;
+  return uiNode;
+}
+
+EZ_STATICLINK_FILE(Core, Core_World_Implementation_SpatialSystem_Bvh);
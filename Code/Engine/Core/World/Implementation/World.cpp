@@ -369,19 +369,7 @@ void ezWorld::PostMessage(const ezGameObjectHandle& receiverObject, const ezMess
   metaData.m_uiReceiverIsComponent = false;
   metaData.m_uiRecursive = bRecursive;
 
-  ezRTTIAllocator* pMsgRTTIAllocator = msg.GetDynamicRTTI()->GetAllocator();
-  if (delay.GetSeconds() > 0.0)
-  {
-    ezMessage* pMsgCopy = pMsgRTTIAllocator->Clone<ezMessage>(&msg, &m_Data.m_Allocator);
-
-    metaData.m_Due = m_Data.m_Clock.GetAccumulatedTime() + delay;
-    m_Data.m_TimedMessageQueues[queueType].Enqueue(pMsgCopy, metaData);
-  }
-  else
-  {
-    ezMessage* pMsgCopy = pMsgRTTIAllocator->Clone<ezMessage>(&msg, m_Data.m_StackAllocator.GetCurrentAllocator());
-    m_Data.m_MessageQueues[queueType].Enqueue(pMsgCopy, metaData);
-  }
+  PostMessage(msg, metaData, queueType, delay);
 }
 
 void ezWorld::PostMessage(const ezComponentHandle& receiverComponent, const ezMessage& msg, ezTime delay, ezObjectMsgQueueType::Enum queueType) const
@@ -395,19 +383,34 @@ void ezWorld::PostMessage(const ezComponentHandle& receiverComponent, const ezMe
   metaData.m_uiReceiverIsComponent = true;
   metaData.m_uiRecursive = false;
 
+  PostMessage(msg, metaData, queueType, delay);
+}
+
+void ezWorld::PostMessage(const ezMessage& msg, QueuedMsgMetaData& metaData, ezObjectMsgQueueType::Enum queueType, ezTime delay) const
+{
+  // The message goes into the post buffer of the calling thread, which is merged into the message queues before they are processed.
+  ezInternal::WorldData::PostBuffer* pBuffer = m_Data.BeginPosting();
+
+  ezInternal::WorldData::PostBuffer::Entry& entry = pBuffer->m_Entries.ExpandAndGetRef();
+  entry.m_uiQueueType = static_cast<ezUInt8>(queueType);
+
   ezRTTIAllocator* pMsgRTTIAllocator = msg.GetDynamicRTTI()->GetAllocator();
   if (delay.GetSeconds() > 0.0)
   {
-    ezMessage* pMsgCopy = pMsgRTTIAllocator->Clone<ezMessage>(&msg, &m_Data.m_Allocator);
+    entry.m_pMessage = pMsgRTTIAllocator->Clone<ezMessage>(&msg, &m_Data.m_Allocator);
+    entry.m_bTimed = true;
 
     metaData.m_Due = m_Data.m_Clock.GetAccumulatedTime() + delay;
-    m_Data.m_TimedMessageQueues[queueType].Enqueue(pMsgCopy, metaData);
   }
   else
   {
-    ezMessage* pMsgCopy = pMsgRTTIAllocator->Clone<ezMessage>(&msg, m_Data.m_StackAllocator.GetCurrentAllocator());
-    m_Data.m_MessageQueues[queueType].Enqueue(pMsgCopy, metaData);
+    entry.m_pMessage = pMsgRTTIAllocator->Clone<ezMessage>(&msg, pBuffer);
+    entry.m_bTimed = false;
   }
+
+  entry.m_MetaData = metaData;
+
+  m_Data.EndPosting(pBuffer);
 }
 
 void ezWorld::FindEventMsgHandlers(ezEventMessage& msg, const ezGameObject* pSearchObject, ezDynamicArray<const ezComponent*>& out_components) const
@@ -516,7 +519,7 @@ void ezWorld::Update()
   {
     EZ_PROFILE_SCOPE("Pre-Async Phase");
     ProcessQueuedMessages(ezObjectMsgQueueType::NextFrame);
-    UpdateSynchronous(m_Data.m_UpdateFunctions[ezComponentManagerBase::UpdateFunctionDesc::Phase::PreAsync]);
+    UpdateSynchronous(ezComponentManagerBase::UpdateFunctionDesc::Phase::PreAsync);
   }
 
   // async phase
@@ -535,7 +538,7 @@ void ezWorld::Update()
   {
     EZ_PROFILE_SCOPE("Post-Async Phase");
     ProcessQueuedMessages(ezObjectMsgQueueType::PostAsync);
-    UpdateSynchronous(m_Data.m_UpdateFunctions[ezComponentManagerBase::UpdateFunctionDesc::Phase::PostAsync]);
+    UpdateSynchronous(ezComponentManagerBase::UpdateFunctionDesc::Phase::PostAsync);
   }
 
   // delete dead objects and update the object hierarchy
@@ -562,7 +565,7 @@ void ezWorld::Update()
   {
     EZ_PROFILE_SCOPE("Post-Transform Phase");
     ProcessQueuedMessages(ezObjectMsgQueueType::PostTransform);
-    UpdateSynchronous(m_Data.m_UpdateFunctions[ezComponentManagerBase::UpdateFunctionDesc::Phase::PostTransform]);
+    UpdateSynchronous(ezComponentManagerBase::UpdateFunctionDesc::Phase::PostTransform);
   }
 
   // Process again so new component can receive render messages, otherwise we introduce a frame delay.
@@ -575,6 +578,9 @@ void ezWorld::Update()
     ProcessQueuedMessages(ezObjectMsgQueueType::AfterInitialized);
   }
 
+  // Messages that were posted after the last queue was processed still live in the current stack allocator
+  m_Data.MergePostedMessages();
+
   // Swap our double buffered stack allocator
   m_Data.m_StackAllocator.Swap();
 }
@@ -849,6 +855,8 @@ void ezWorld::ProcessQueuedMessages(ezObjectMsgQueueType::Enum queueType)
 {
   EZ_PROFILE_SCOPE("Process Queued Messages");
 
+  m_Data.MergePostedMessages();
+
   struct MessageComparer
   {
     EZ_FORCE_INLINE bool Less(const ezInternal::WorldData::MessageQueue::Entry& a, const ezInternal::WorldData::MessageQueue::Entry& b) const
@@ -886,11 +894,21 @@ void ezWorld::ProcessQueuedMessages(ezObjectMsgQueueType::Enum queueType)
     ezInternal::WorldData::MessageQueue& queue = m_Data.m_MessageQueues[queueType];
     queue.Sort(MessageComparer());
 
-    for (ezUInt32 i = 0; i < queue.GetCount(); ++i)
+    ezUInt32 i = 0;
+    while (true)
     {
-      ProcessQueuedMessage(queue[i]);
+      for (; i < queue.GetCount(); ++i)
+      {
+        ProcessQueuedMessage(queue[i]);
+
+        // no need to deallocate these messages, they are allocated through a frame allocator
+      }
 
-      // no need to deallocate these messages, they are allocated through a frame allocator
+      // messages that were posted to this queue while processing it are handled in the same pass
+      m_Data.MergePostedMessages();
+
+      if (i == queue.GetCount())
+        break;
     }
 
     queue.Clear();
@@ -942,6 +960,7 @@ void ezWorld::DeregisterUpdateFunction(const ezComponentManagerBase::UpdateFunct
     if (updateFunctions[i].m_Function.IsEqualIfComparable(desc.m_Function))
     {
       updateFunctions.RemoveAtAndCopy(i);
+      m_Data.m_UpdateSchedules[desc.m_Phase.GetValue()].m_bNeedsRebuild = true;
     }
   }
 }
@@ -959,6 +978,7 @@ void ezWorld::DeregisterUpdateFunctions(ezWorldModule* pModule)
       if (updateFunctions[i].m_Function.GetClassInstance() == pModule)
       {
         updateFunctions.RemoveAtAndCopy(i);
+        m_Data.m_UpdateSchedules[phase].m_bNeedsRebuild = true;
       }
     }
   }
@@ -976,21 +996,75 @@ void ezWorld::UpdateFromThread()
   Update();
 }
 
-void ezWorld::UpdateSynchronous(const ezArrayPtr<ezInternal::WorldData::RegisteredUpdateFunction>& updateFunctions)
+void ezWorld::UpdateSynchronous(ezWorldModule::UpdateFunctionDesc::Phase::Enum phase)
 {
+  const ezDynamicArrayBase<ezInternal::WorldData::RegisteredUpdateFunction>& updateFunctions = m_Data.m_UpdateFunctions[phase];
+  ezInternal::WorldData::UpdateSchedule& schedule = m_Data.m_UpdateSchedules[phase];
+
+  if (schedule.m_bNeedsRebuild)
+  {
+    schedule.Build(updateFunctions);
+  }
+
   ezWorldModule::UpdateContext context;
   context.m_uiFirstComponentIndex = 0;
   context.m_uiComponentCount = ezInvalidIndex;
 
-  for (auto& updateFunction : updateFunctions)
+  for (ezUInt32 uiLevel = 0; uiLevel < schedule.GetLevelCount(); ++uiLevel)
   {
-    if (updateFunction.m_bOnlyUpdateWhenSimulating && !m_Data.m_bSimulateWorld)
-      continue;
+    const ezUInt32 uiFirstIndex = schedule.m_LevelStartIndices[uiLevel];
+    const ezUInt32 uiEndIndex = schedule.m_LevelStartIndices[uiLevel + 1];
 
+    // a function that doesn't declare its data accesses is always alone in its level and keeps write access to the world
+    if (!updateFunctions[schedule.m_FunctionIndices[uiFirstIndex]].DeclaresDataAccess())
     {
+      auto& updateFunction = updateFunctions[schedule.m_FunctionIndices[uiFirstIndex]];
+      if (updateFunction.m_bOnlyUpdateWhenSimulating && !m_Data.m_bSimulateWorld)
+        continue;
+
       EZ_PROFILE_SCOPE(updateFunction.m_sFunctionName);
       updateFunction.m_Function(context);
+      continue;
+    }
+
+    // the functions in this level don't access conflicting data, they are only allowed to read the world like asynchronous functions
+    m_Data.m_WriteThreadID = (ezThreadID)0;
+
+    if (uiEndIndex - uiFirstIndex == 1)
+    {
+      auto& updateFunction = updateFunctions[schedule.m_FunctionIndices[uiFirstIndex]];
+      if (!updateFunction.m_bOnlyUpdateWhenSimulating || m_Data.m_bSimulateWorld)
+      {
+        EZ_PROFILE_SCOPE(updateFunction.m_sFunctionName);
+        updateFunction.m_Function(context);
+      }
     }
+    else
+    {
+      ezTaskGroupID taskGroupId = ezTaskSystem::CreateTaskGroup(ezTaskPriority::EarlyThisFrame);
+
+      ezUInt32 uiCurrentTaskIndex = 0;
+      for (ezUInt32 i = uiFirstIndex; i < uiEndIndex; ++i)
+      {
+        auto& updateFunction = updateFunctions[schedule.m_FunctionIndices[i]];
+        if (updateFunction.m_bOnlyUpdateWhenSimulating && !m_Data.m_bSimulateWorld)
+          continue;
+
+        const ezSharedPtr<ezInternal::WorldData::UpdateTask>& pTask = m_Data.GetOrCreateUpdateTask(uiCurrentTaskIndex);
+        pTask->ConfigureTask(updateFunction.m_sFunctionName, ezTaskNesting::Maybe);
+        pTask->m_Function = updateFunction.m_Function;
+        pTask->m_uiStartIndex = 0;
+        pTask->m_uiCount = ezInvalidIndex;
+        ezTaskSystem::AddTaskToGroup(taskGroupId, pTask);
+
+        ++uiCurrentTaskIndex;
+      }
+
+      ezTaskSystem::StartTaskGroup(taskGroupId);
+      ezTaskSystem::WaitForGroup(taskGroupId);
+    }
+
+    m_Data.m_WriteThreadID = ezThreadUtils::GetCurrentThreadID();
   }
 }
 
@@ -1016,16 +1090,7 @@ void ezWorld::UpdateAsynchronous()
     ezUInt32 uiStartIndex = 0;
     while (uiStartIndex < uiTotalCount)
     {
-      ezSharedPtr<ezInternal::WorldData::UpdateTask> pTask;
-      if (uiCurrentTaskIndex < m_Data.m_UpdateTasks.GetCount())
-      {
-        pTask = m_Data.m_UpdateTasks[uiCurrentTaskIndex];
-      }
-      else
-      {
-        pTask = EZ_NEW(&m_Data.m_Allocator, ezInternal::WorldData::UpdateTask);
-        m_Data.m_UpdateTasks.PushBack(pTask);
-      }
+      const ezSharedPtr<ezInternal::WorldData::UpdateTask>& pTask = m_Data.GetOrCreateUpdateTask(uiCurrentTaskIndex);
 
       pTask->ConfigureTask(updateFunction.m_sFunctionName, ezTaskNesting::Maybe);
       pTask->m_Function = updateFunction.m_Function;
@@ -1239,6 +1304,7 @@ ezResult ezWorld::RegisterUpdateFunctionInternal(const ezWorldModule::UpdateFunc
   }
 
   updateFunctions.Insert(newFunction, uiInsertionIndex);
+  m_Data.m_UpdateSchedules[desc.m_Phase.GetValue()].m_bNeedsRebuild = true;
 
   return EZ_SUCCESS;
 }
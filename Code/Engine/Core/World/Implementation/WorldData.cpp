@@ -36,6 +36,338 @@ namespace ezInternal
 
   ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+  bool WorldData::RegisteredUpdateFunction::MustRunAfter(const RegisteredUpdateFunction& earlierFunction) const
+  {
+    // functions that don't declare which data they access may touch anything
+    if (!DeclaresDataAccess() || !earlierFunction.DeclaresDataAccess())
+      return true;
+
+    if (m_DependsOn.Contains(earlierFunction.m_sFunctionName))
+      return true;
+
+    for (const ezHashedString& sData : m_WritesTo)
+    {
+      if (earlierFunction.m_ReadsFrom.Contains(sData) || earlierFunction.m_WritesTo.Contains(sData))
+        return true;
+    }
+
+    for (const ezHashedString& sData : m_ReadsFrom)
+    {
+      if (earlierFunction.m_WritesTo.Contains(sData))
+        return true;
+    }
+
+    return false;
+  }
+
+  void WorldData::UpdateSchedule::Build(ezArrayPtr<const RegisteredUpdateFunction> updateFunctions)
+  {
+    const ezUInt32 uiNumFunctions = updateFunctions.GetCount();
+
+    // every function goes into the level after the last function it conflicts with,
+    // thus conflicting functions keep their priority order
+    ezHybridArray<ezUInt32, 64> levels;
+    levels.SetCountUninitialized(uiNumFunctions);
+
+    ezUInt32 uiNumLevels = 0;
+    for (ezUInt32 i = 0; i < uiNumFunctions; ++i)
+    {
+      ezUInt32 uiLevel = 0;
+      for (ezUInt32 j = 0; j < i; ++j)
+      {
+        if (levels[j] >= uiLevel && updateFunctions[i].MustRunAfter(updateFunctions[j]))
+        {
+          uiLevel = levels[j] + 1;
+        }
+      }
+
+      levels[i] = uiLevel;
+      uiNumLevels = ezMath::Max(uiNumLevels, uiLevel + 1);
+    }
+
+    // counting sort by level, this keeps the priority order within a level
+    m_LevelStartIndices.Clear();
+    m_LevelStartIndices.SetCount(uiNumLevels + 1);
+
+    for (ezUInt32 i = 0; i < uiNumFunctions; ++i)
+    {
+      ++m_LevelStartIndices[levels[i] + 1];
+    }
+
+    for (ezUInt32 uiLevel = 1; uiLevel <= uiNumLevels; ++uiLevel)
+    {
+      m_LevelStartIndices[uiLevel] += m_LevelStartIndices[uiLevel - 1];
+    }
+
+    ezHybridArray<ezUInt32, 16> insertionIndices;
+    insertionIndices = m_LevelStartIndices.GetArrayPtr();
+
+    m_FunctionIndices.SetCountUninitialized(uiNumFunctions);
+    for (ezUInt32 i = 0; i < uiNumFunctions; ++i)
+    {
+      m_FunctionIndices[insertionIndices[levels[i]]++] = i;
+    }
+
+    m_bNeedsRebuild = false;
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+
+  const ezSharedPtr<WorldData::UpdateTask>& WorldData::GetOrCreateUpdateTask(ezUInt32 uiIndex)
+  {
+    while (uiIndex >= m_UpdateTasks.GetCount())
+    {
+      m_UpdateTasks.PushBack(EZ_NEW(&m_Allocator, UpdateTask));
+    }
+
+    return m_UpdateTasks[uiIndex];
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+
+  namespace
+  {
+    enum
+    {
+      POST_BUFFER_CHUNK_SIZE = 16 * 1024,
+      POST_BUFFER_MAX_SHARED_ALLOCATION_SIZE = POST_BUFFER_CHUNK_SIZE / 4
+    };
+
+    struct PostBufferChunkHeader
+    {
+      ezUInt32 m_uiNumDestructors;
+    };
+
+    struct PostBufferDestructData
+    {
+      ezMemoryUtils::DestructorFunction m_Func;
+      void* m_Ptr;
+    };
+
+    struct PostBufferCache
+    {
+      enum
+      {
+        NUM_ENTRIES = 4
+      };
+
+      struct Entry
+      {
+        ezUInt64 m_uiWorldSerial = 0;
+        ezInt32 m_iGeneration = 0;
+        void* m_pBuffer = nullptr;
+      };
+
+      Entry m_Entries[NUM_ENTRIES];
+      ezUInt32 m_uiNextEntry = 0;
+    };
+
+    ezAtomicInteger64 s_iNextPostBufferSerial;
+
+    // every thread remembers the post buffers it got last, so it only needs to look them up once per generation
+    thread_local PostBufferCache tl_PostBufferCache;
+  } // namespace
+
+  WorldData::PostBuffer::PostBuffer(WorldData& data)
+    : m_Data(data)
+    , m_Entries(&data.m_Allocator)
+  {
+  }
+
+  WorldData::PostBuffer::~PostBuffer() = default;
+
+  void* WorldData::PostBuffer::Allocate(size_t uiSize, size_t uiAlign, ezMemoryUtils::DestructorFunction destructorFunc)
+  {
+    const size_t uiDestructSize = destructorFunc != nullptr ? sizeof(PostBufferDestructData) : 0;
+
+    ezUInt8* pMemory = m_pChunkCur != nullptr ? ezMemoryUtils::AlignForwards(m_pChunkCur, uiAlign) : nullptr;
+    if (pMemory == nullptr || pMemory + uiSize + uiDestructSize > m_pChunkEnd)
+    {
+      if (uiSize + uiAlign + uiDestructSize > POST_BUFFER_MAX_SHARED_ALLOCATION_SIZE)
+      {
+        // rare large message, not worth to waste the rest of a chunk
+        return m_Data.m_StackAllocator.GetCurrentAllocator()->Allocate(uiSize, uiAlign, destructorFunc);
+      }
+
+      m_pChunkStart = static_cast<ezUInt8*>(m_Data.m_StackAllocator.GetCurrentAllocator()->Allocate(POST_BUFFER_CHUNK_SIZE, EZ_ALIGNMENT_MINIMUM, &DestructChunk));
+      reinterpret_cast<PostBufferChunkHeader*>(m_pChunkStart)->m_uiNumDestructors = 0;
+
+      m_pChunkCur = m_pChunkStart + sizeof(PostBufferChunkHeader);
+      m_pChunkEnd = m_pChunkStart + POST_BUFFER_CHUNK_SIZE;
+
+      pMemory = ezMemoryUtils::AlignForwards(m_pChunkCur, uiAlign);
+    }
+
+    m_pChunkCur = pMemory + uiSize;
+
+    if (destructorFunc != nullptr)
+    {
+      m_pChunkEnd -= sizeof(PostBufferDestructData);
+
+      PostBufferDestructData* pData = reinterpret_cast<PostBufferDestructData*>(m_pChunkEnd);
+      pData->m_Func = destructorFunc;
+      pData->m_Ptr = pMemory;
+
+      reinterpret_cast<PostBufferChunkHeader*>(m_pChunkStart)->m_uiNumDestructors++;
+    }
+
+    return pMemory;
+  }
+
+  void WorldData::PostBuffer::Deallocate(void* ptr)
+  {
+    // nothing to do here, the memory is released when the stack allocator is reset
+  }
+
+  size_t WorldData::PostBuffer::AllocatedSize(const void* ptr)
+  {
+    return 0;
+  }
+
+  ezAllocatorId WorldData::PostBuffer::GetId() const
+  {
+    return ezAllocatorId();
+  }
+
+  ezAllocatorBase::Stats WorldData::PostBuffer::GetStats() const
+  {
+    return Stats();
+  }
+
+  void WorldData::PostBuffer::MoveToQueues()
+  {
+    for (const Entry& entry : m_Entries)
+    {
+      MessageQueue& queue = entry.m_bTimed ? m_Data.m_TimedMessageQueues[entry.m_uiQueueType] : m_Data.m_MessageQueues[entry.m_uiQueueType];
+      queue.Enqueue(entry.m_pMessage, entry.m_MetaData);
+    }
+
+    m_Entries.Clear();
+
+    // the stack allocator might be swapped before the next allocation, so always start a new chunk
+    m_pChunkStart = nullptr;
+    m_pChunkCur = nullptr;
+    m_pChunkEnd = nullptr;
+  }
+
+  // static
+  void WorldData::PostBuffer::DestructChunk(void* pChunk)
+  {
+    const ezUInt32 uiNumDestructors = static_cast<PostBufferChunkHeader*>(pChunk)->m_uiNumDestructors;
+
+    // the last allocation is stored first, thus the messages are destructed in reverse order like in the stack allocator
+    PostBufferDestructData* pData = reinterpret_cast<PostBufferDestructData*>(static_cast<ezUInt8*>(pChunk) + POST_BUFFER_CHUNK_SIZE) - uiNumDestructors;
+    for (ezUInt32 i = 0; i < uiNumDestructors; ++i)
+    {
+      pData[i].m_Func(pData[i].m_Ptr);
+    }
+  }
+
+  WorldData::PostBuffer* WorldData::BeginPosting() const
+  {
+    PostBufferCache& cache = tl_PostBufferCache;
+
+    while (true)
+    {
+      const ezInt32 iGeneration = m_iPostBufferGeneration;
+
+      PostBuffer* pBuffer = nullptr;
+      for (const PostBufferCache::Entry& entry : cache.m_Entries)
+      {
+        if (entry.m_uiWorldSerial == m_uiPostBufferSerial && entry.m_iGeneration == iGeneration)
+        {
+          pBuffer = static_cast<PostBuffer*>(entry.m_pBuffer);
+          break;
+        }
+      }
+
+      if (pBuffer == nullptr)
+      {
+        pBuffer = AcquirePostBuffer(iGeneration);
+        if (pBuffer == nullptr)
+          continue;
+
+        PostBufferCache::Entry& entry = cache.m_Entries[cache.m_uiNextEntry];
+        entry.m_uiWorldSerial = m_uiPostBufferSerial;
+        entry.m_iGeneration = iGeneration;
+        entry.m_pBuffer = pBuffer;
+
+        cache.m_uiNextEntry = (cache.m_uiNextEntry + 1) % PostBufferCache::NUM_ENTRIES;
+      }
+
+      pBuffer->m_iIsPosting.Increment();
+
+      // If a merge started in the meantime, the buffer may already be taken out of the active list and handed to another thread.
+      // Otherwise the merge waits until we are done.
+      if (m_iPostBufferGeneration == iGeneration)
+        return pBuffer;
+
+      pBuffer->m_iIsPosting.Decrement();
+    }
+  }
+
+  void WorldData::EndPosting(PostBuffer* pBuffer) const
+  {
+    pBuffer->m_iIsPosting.Decrement();
+  }
+
+  WorldData::PostBuffer* WorldData::AcquirePostBuffer(ezInt32 iGeneration) const
+  {
+    EZ_LOCK(m_PostBufferMutex);
+
+    if (m_iPostBufferGeneration != iGeneration)
+      return nullptr;
+
+    PostBuffer* pBuffer = nullptr;
+    if (!m_FreePostBuffers.IsEmpty())
+    {
+      pBuffer = m_FreePostBuffers.PeekBack();
+      m_FreePostBuffers.PopBack();
+    }
+    else
+    {
+      pBuffer = EZ_NEW(&m_Allocator, PostBuffer, const_cast<WorldData&>(*this));
+      m_AllPostBuffers.PushBack(pBuffer);
+    }
+
+    m_ActivePostBuffers.PushBack(pBuffer);
+    return pBuffer;
+  }
+
+  void WorldData::MergePostedMessages()
+  {
+    ezHybridArray<PostBuffer*, 32> buffers;
+
+    {
+      EZ_LOCK(m_PostBufferMutex);
+
+      if (m_ActivePostBuffers.IsEmpty())
+        return;
+
+      // invalidates all thread local cache entries, new posts go to different buffers from now on
+      m_iPostBufferGeneration.Increment();
+
+      buffers = m_ActivePostBuffers;
+      m_ActivePostBuffers.Clear();
+    }
+
+    // The order in which the buffers are merged doesn't matter since the queues are sorted before they are processed.
+    for (PostBuffer* pBuffer : buffers)
+    {
+      while (pBuffer->m_iIsPosting > 0)
+      {
+        ezThreadUtils::YieldTimeSlice();
+      }
+
+      pBuffer->MoveToQueues();
+    }
+
+    EZ_LOCK(m_PostBufferMutex);
+    m_FreePostBuffers.PushBackRange(buffers);
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+
   WorldData::WorldData(ezWorldDesc& desc)
     : m_sName(desc.m_sName)
     , m_Allocator(desc.m_sName, ezFoundation::GetDefaultAllocator())
@@ -45,6 +377,7 @@ namespace ezInternal
     , m_ObjectStorage(&m_BlockAllocator, &m_Allocator)
     , m_MaxInitializationTimePerFrame(desc.m_MaxComponentInitializationTimePerFrame)
     , m_Clock(desc.m_sName)
+    , m_uiPostBufferSerial(static_cast<ezUInt64>(s_iNextPostBufferSerial.Increment()))
     , m_WriteThreadID((ezThreadID)0)
     , m_iWriteCounter(0)
     , m_bSimulateWorld(true)
@@ -164,6 +497,15 @@ namespace ezInternal
     m_UpdateTasks.Clear();
 
     // delete queued messages
+    MergePostedMessages();
+
+    for (PostBuffer* pBuffer : m_AllPostBuffers)
+    {
+      EZ_DELETE(&m_Allocator, pBuffer);
+    }
+    m_AllPostBuffers.Clear();
+    m_FreePostBuffers.Clear();
+
     for (ezUInt32 i = 0; i < ezObjectMsgQueueType::COUNT; ++i)
     {
       {
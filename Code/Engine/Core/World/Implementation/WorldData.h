@@ -175,12 +175,35 @@ namespace ezInternal
     {
       ezWorldModule::UpdateFunction m_Function;
       ezHashedString m_sFunctionName;
+      ezHybridArray<ezHashedString, 4> m_DependsOn;
+      ezHybridArray<ezHashedString, 2> m_ReadsFrom;
+      ezHybridArray<ezHashedString, 2> m_WritesTo;
       float m_fPriority;
       ezUInt16 m_uiGranularity;
       bool m_bOnlyUpdateWhenSimulating;
 
       void FillFromDesc(const ezWorldModule::UpdateFunctionDesc& desc);
       bool operator<(const RegisteredUpdateFunction& other) const;
+
+      EZ_ALWAYS_INLINE bool DeclaresDataAccess() const { return !m_ReadsFrom.IsEmpty() || !m_WritesTo.IsEmpty(); }
+
+      /// \brief Returns true if this function must not run in parallel to the given function, which is called earlier in the same phase.
+      bool MustRunAfter(const RegisteredUpdateFunction& earlierFunction) const;
+    };
+
+    /// \brief Execution order of the synchronous update functions of one phase.
+    ///
+    /// The functions are grouped into levels. Functions in the same level don't conflict with each other and can run in parallel,
+    /// the levels are executed one after the other.
+    struct UpdateSchedule
+    {
+      void Build(ezArrayPtr<const RegisteredUpdateFunction> updateFunctions);
+
+      EZ_ALWAYS_INLINE ezUInt32 GetLevelCount() const { return m_LevelStartIndices.GetCount() - 1; }
+
+      ezDynamicArray<ezUInt32, ezLocalAllocatorWrapper> m_FunctionIndices;   ///< Indices into the update functions array, sorted by level and then by priority.
+      ezDynamicArray<ezUInt32, ezLocalAllocatorWrapper> m_LevelStartIndices; ///< Start of every level in m_FunctionIndices, plus the total count as the last entry.
+      bool m_bNeedsRebuild = true;
     };
 
     struct UpdateTask final : public ezTask
@@ -194,9 +217,12 @@ namespace ezInternal
 
     ezDynamicArray<RegisteredUpdateFunction, ezLocalAllocatorWrapper> m_UpdateFunctions[ezWorldModule::UpdateFunctionDesc::Phase::COUNT];
     ezDynamicArray<ezWorldModule::UpdateFunctionDesc, ezLocalAllocatorWrapper> m_UpdateFunctionsToRegister;
+    UpdateSchedule m_UpdateSchedules[ezWorldModule::UpdateFunctionDesc::Phase::COUNT];
 
     ezDynamicArray<ezSharedPtr<UpdateTask>, ezLocalAllocatorWrapper> m_UpdateTasks;
 
+    const ezSharedPtr<UpdateTask>& GetOrCreateUpdateTask(ezUInt32 uiIndex);
+
     ezUniquePtr<ezSpatialSystem> m_pSpatialSystem;
     ezSharedPtr<ezCoordinateSystemProvider> m_pCoordinateSystemProvider;
     ezUniquePtr<ezTimeStepSmoothing> m_pTimeStepSmoothing;
@@ -232,6 +258,67 @@ namespace ezInternal
     mutable MessageQueue m_MessageQueues[ezObjectMsgQueueType::COUNT];
     mutable MessageQueue m_TimedMessageQueues[ezObjectMsgQueueType::COUNT];
 
+    /// \brief Collects the messages that one thread posts until they are merged into the message queues.
+    ///
+    /// Every posting thread gets its own buffer, thus posting a message doesn't need any locks. Messages without delay are cloned
+    /// into chunks that are taken from the world's stack allocator, so they have the same lifetime as before. The buffer itself acts
+    /// as the allocator for these clones.
+    class PostBuffer final : public ezAllocatorBase
+    {
+    public:
+      PostBuffer(WorldData& data);
+      ~PostBuffer();
+
+      virtual void* Allocate(size_t uiSize, size_t uiAlign, ezMemoryUtils::DestructorFunction destructorFunc) override;
+      virtual void Deallocate(void* ptr) override;
+      virtual size_t AllocatedSize(const void* ptr) override;
+      virtual ezAllocatorId GetId() const override;
+      virtual Stats GetStats() const override;
+
+      struct Entry
+      {
+        EZ_DECLARE_POD_TYPE();
+
+        ezMessage* m_pMessage;
+        QueuedMsgMetaData m_MetaData;
+        ezUInt8 m_uiQueueType;
+        bool m_bTimed;
+      };
+
+      /// \brief Moves all entries into the message queues of the world and starts a new chunk on the next allocation.
+      void MoveToQueues();
+
+    private:
+      friend class ::ezWorld;
+      friend class ::ezInternal::WorldData;
+
+      static void DestructChunk(void* pChunk);
+
+      WorldData& m_Data;
+      ezDynamicArray<Entry> m_Entries;
+
+      ezUInt8* m_pChunkStart = nullptr;
+      ezUInt8* m_pChunkCur = nullptr;
+      ezUInt8* m_pChunkEnd = nullptr; ///< Destructor data of the messages is stored at the end of the chunk, growing downwards.
+      ezAtomicInteger32 m_iIsPosting; ///< Number of threads that currently use this buffer.
+    };
+
+    /// \brief Returns the post buffer of the calling thread and marks it as in use until EndPosting() is called.
+    PostBuffer* BeginPosting() const;
+    void EndPosting(PostBuffer* pBuffer) const;
+
+    /// \brief Moves the messages of all post buffers into the message queues. Must not be called from multiple threads at the same time.
+    void MergePostedMessages();
+
+    PostBuffer* AcquirePostBuffer(ezInt32 iGeneration) const;
+
+    const ezUInt64 m_uiPostBufferSerial; ///< Unique for every world data, identifies the post buffers in the thread local cache.
+    mutable ezAtomicInteger32 m_iPostBufferGeneration;
+    mutable ezMutex m_PostBufferMutex;
+    mutable ezDynamicArray<PostBuffer*> m_ActivePostBuffers; ///< Buffers that were handed out in the current generation.
+    mutable ezDynamicArray<PostBuffer*> m_FreePostBuffers;
+    mutable ezDynamicArray<PostBuffer*> m_AllPostBuffers;
+
     ezThreadID m_WriteThreadID;
     ezInt32 m_iWriteCounter;
     mutable ezAtomicInteger32 m_iReadCounter;
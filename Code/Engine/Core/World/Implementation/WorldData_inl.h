@@ -172,6 +172,9 @@ namespace ezInternal
     m_Function = desc.m_Function;
     m_sFunctionName = desc.m_sFunctionName;
     m_fPriority = desc.m_fPriority;
+    m_DependsOn = desc.m_DependsOn;
+    m_ReadsFrom = desc.m_ReadsFrom;
+    m_WritesTo = desc.m_WritesTo;
     m_uiGranularity = desc.m_uiGranularity;
     m_bOnlyUpdateWhenSimulating = desc.m_bOnlyUpdateWhenSimulating;
   }
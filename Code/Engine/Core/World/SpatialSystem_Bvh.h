@@ -0,0 +1,141 @@
+#pragma once
+
+#include <Core/World/SpatialSystem.h>
+#include <Foundation/Containers/IdTable.h>
+
+namespace ezInternal
+{
+  struct BvhQueryHelper;
+}
+
+/// \brief A spatial system that stores all spatial data in a bounding volume hierarchy with four children per node.
+///
+/// Every node stores the bounding boxes of its four children in SoA layout, so a query tests all children of a node at once with a few SIMD instructions.
+/// All categories share the same tree. Each node also stores the category bitmasks of its children, which allows to skip whole subtrees that don't contain
+/// any of the queried categories.
+///
+/// The tree is updated incrementally. Objects are stored with slightly enlarged bounds, as long as the new bounds of an object still fit into these
+/// only its bounding sphere is updated. Otherwise the object is removed and inserted again and the nodes along its path are refitted.
+/// When many objects have been added or removed since the tree was built, it is rebuilt from scratch at the start of the next frame.
+///
+/// Compared to ezSpatialSystem_RegularGrid this adapts to the distribution and size of the objects, so it is better suited for scenes with a very
+/// uneven object density or objects of very different sizes. Moving objects are more expensive to update, though.
+class EZ_CORE_DLL ezSpatialSystem_Bvh : public ezSpatialSystem
+{
+  EZ_ADD_DYNAMIC_REFLECTION(ezSpatialSystem_Bvh, ezSpatialSystem);
+
+public:
+  /// \brief fBoundsMargin is added to the bounds of every object in the tree. Objects that move less than this don't need to be re-inserted.
+  ezSpatialSystem_Bvh(float fBoundsMargin = 1.0f);
+  ~ezSpatialSystem_Bvh();
+
+  /// \brief Returns the bounding boxes of all nodes in the tree. Useful for debug visualizations.
+  void GetAllNodeBoxes(ezDynamicArray<ezBoundingBox>& out_BoundingBoxes) const;
+
+  /// \brief Returns the number of nodes along the longest path from the root to an object.
+  ezUInt32 GetTreeDepth() const;
+
+private:
+  friend ezInternal::BvhQueryHelper;
+
+  // ezSpatialSystem implementation
+  virtual void StartNewFrame() override;
+
+  ezSpatialDataHandle CreateSpatialData(const ezSimdBBoxSphere& bounds, ezGameObject* pObject, ezUInt32 uiCategoryBitmask, const ezTagSet& tags) override;
+  ezSpatialDataHandle CreateSpatialDataAlwaysVisible(ezGameObject* pObject, ezUInt32 uiCategoryBitmask, const ezTagSet& tags) override;
+
+  void DeleteSpatialData(const ezSpatialDataHandle& hData) override;
+
+  void UpdateSpatialDataBounds(const ezSpatialDataHandle& hData, const ezSimdBBoxSphere& bounds) override;
+  void UpdateSpatialDataObject(const ezSpatialDataHandle& hData, ezGameObject* pObject) override;
+
+  void FindObjectsInSphere(const ezBoundingSphere& sphere, const QueryParams& queryParams, QueryCallback callback) const override;
+  void FindObjectsInBox(const ezBoundingBox& box, const QueryParams& queryParams, QueryCallback callback) const override;
+
+  void FindVisibleObjects(const ezFrustum& frustum, const QueryParams& queryParams, ezDynamicArray<const ezGameObject*>& out_Objects) const override;
+
+  ezUInt64 GetNumFramesSinceVisible(const ezSpatialDataHandle& hData) const override;
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+  virtual void GetInternalStats(ezStringBuilder& sb) const override;
+#endif
+
+  ezProxyAllocator m_AlignedAllocator;
+
+  ezSimdVec4f m_vBoundsMargin;
+
+  struct Node
+  {
+    // bounds of the four children, empty children have inverted bounds so that they never overlap anything
+    ezSimdVec4f m_MinX;
+    ezSimdVec4f m_MinY;
+    ezSimdVec4f m_MinZ;
+    ezSimdVec4f m_MaxX;
+    ezSimdVec4f m_MaxY;
+    ezSimdVec4f m_MaxZ;
+
+    ezUInt32 m_Children[4];         ///< Either a node index or an object index with OBJECT_FLAG set.
+    ezUInt32 m_CategoryBitmasks[4]; ///< The combined category bitmask of everything below each child.
+
+    ezUInt32 m_uiParent;
+    ezUInt32 m_uiSlotInParent;
+    ezUInt32 m_uiNumChildren;
+  };
+
+  ezDynamicArray<Node> m_Nodes;
+  ezDynamicArray<ezUInt32> m_FreeNodes;
+  ezUInt32 m_uiRootNode = ezInvalidIndex;
+
+  struct ObjectLocation
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezUInt32 m_uiNode = ezInvalidIndex; ///< The node that contains the object, ezInvalidIndex for always visible data.
+    ezUInt32 m_uiSlot = ezInvalidIndex; ///< The child slot in the node or the index in m_AlwaysVisibleData.
+  };
+
+  // per object data, indexed by the instance index of the spatial data id
+  ezDynamicArray<ezSimdBBox> m_NodeBoxes; ///< The enlarged box around the bounding sphere of every object, as stored in the tree.
+  ezDynamicArray<ezSimdBSphere> m_BoundingSpheres;
+  ezDynamicArray<ezTagSet> m_TagSets;
+  ezDynamicArray<ezGameObject*> m_ObjectPointers;
+  mutable ezDynamicArray<ezUInt64> m_LastVisibleFrames; // multi-threaded access is ok, since all threads will set the same value
+  ezDynamicArray<ObjectLocation> m_ObjectLocations;
+
+  ezDynamicArray<ezUInt32> m_AlwaysVisibleData;
+
+  struct Data
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezUInt32 m_uiCategoryBitmask;
+    ezUInt32 m_uiAlwaysVisible;
+  };
+
+  ezIdTable<ezSpatialDataId, Data, ezLocalAllocatorWrapper> m_DataTable;
+
+  ezUInt32 m_uiNumChangesSinceRebuild = 0;
+  ezUInt32 m_uiNumRebuilds = 0;
+
+  ezSpatialDataHandle AddSpatialData(const ezSimdBBoxSphere& bounds, ezGameObject* pObject, ezUInt32 uiCategoryBitmask, const ezTagSet& tags, bool bAlwaysVisible);
+
+  ezUInt32 AllocateNode(ezUInt32 uiParent, ezUInt32 uiSlotInParent);
+  void FreeNode(ezUInt32 uiNode);
+
+  void SetChild(ezUInt32 uiNode, ezUInt32 uiSlot, ezUInt32 uiChild, const ezSimdBBox& box, ezUInt32 uiCategoryBitmask);
+  void ClearChild(ezUInt32 uiNode, ezUInt32 uiSlot);
+  ezSimdBBox GetChildBox(ezUInt32 uiNode, ezUInt32 uiSlot) const;
+  ezSimdBBox GetNodeBox(ezUInt32 uiNode) const;
+  ezUInt32 GetNodeCategoryBitmask(ezUInt32 uiNode) const;
+
+  void InsertObject(ezUInt32 uiObject, ezUInt32 uiCategoryBitmask);
+  void RemoveObject(ezUInt32 uiObject);
+  void RemoveChildAndRefit(ezUInt32 uiNode, ezUInt32 uiSlot);
+  void Refit(ezUInt32 uiNode);
+
+  void Rebuild();
+  ezUInt32 BuildNode(ezArrayPtr<ezUInt32> objects, ezArrayPtr<const ezVec3> centers, ezUInt32 uiParent, ezUInt32 uiSlotInParent);
+
+  template <typename Functor>
+  void ForEachAlwaysVisibleObject(const QueryParams& queryParams, Functor func) const;
+};
@@ -365,6 +365,7 @@ private:
   const char* GetObjectGlobalKey(const ezGameObject* pObject) const;
 
   void PostMessage(const ezGameObjectHandle& receiverObject, const ezMessage& msg, ezObjectMsgQueueType::Enum queueType, ezTime delay, bool bRecursive) const;
+  void PostMessage(const ezMessage& msg, ezInternal::WorldData::QueuedMsgMetaData& metaData, ezObjectMsgQueueType::Enum queueType, ezTime delay) const;
   void ProcessQueuedMessage(const ezInternal::WorldData::MessageQueue::Entry& entry);
   void ProcessQueuedMessages(ezObjectMsgQueueType::Enum queueType);
 
@@ -376,7 +377,7 @@ private:
   void AddComponentToInitialize(ezComponentHandle hComponent);
 
   void UpdateFromThread();
-  void UpdateSynchronous(const ezArrayPtr<ezInternal::WorldData::RegisteredUpdateFunction>& updateFunctions);
+  void UpdateSynchronous(ezWorldModule::UpdateFunctionDesc::Phase::Enum phase);
   void UpdateAsynchronous();
 
   // returns if the batch was completely initialized
@@ -74,6 +74,19 @@ protected:
     ezUInt16 m_uiGranularity = 0;                 ///< The granularity in which batch updates should happen during the asynchronous phase. Has to be 0 for
                                                   ///< synchronous functions.
     float m_fPriority = 0.0f;                     ///< Higher priority (higher number) means that this function is called earlier than a function with lower priority.
+
+    /// \brief Names of the data that this function reads, e.g. the type names of the components it accesses or any other named resource.
+    ///
+    /// Synchronous update functions that declare their data accesses (through m_ReadsFrom or m_WritesTo) are allowed to run in parallel to other
+    /// such functions of the same phase, as long as neither of them writes data that the other one accesses and neither depends on the other
+    /// through m_DependsOn. Conflicting functions are still called one after the other in priority order.
+    /// While running in parallel, these functions have the same restrictions as asynchronous update functions: the world is only marked for
+    /// reading, so they must not create or delete objects or components. Use messages for that.
+    /// Functions that don't declare anything always run on their own on the updating thread, exactly as before.
+    ezHybridArray<ezHashedString, 2> m_ReadsFrom;
+
+    /// \brief Names of the data that this function modifies. See m_ReadsFrom.
+    ezHybridArray<ezHashedString, 2> m_WritesTo;
   };
 
   /// \brief Registers the given update function at the world.
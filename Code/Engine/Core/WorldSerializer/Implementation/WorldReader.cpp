@@ -93,6 +93,46 @@ ezUniquePtr<ezWorldReader::InstantiationContextBase> ezWorldReader::InstantiateP
   return Instantiate(world, true, rootTransform, options);
 }
 
+void ezWorldReader::InstantiatePrefabs(ezWorld& world, ezArrayPtr<const ezTransform> rootTransforms, const ezPrefabInstantiationOptions& options)
+{
+  EZ_ASSERT_DEV(options.m_MaxStepTime.IsZeroOrNegative() && options.m_pProgress == nullptr, "Batched prefab instantiation does not support time slicing or progress tracking.");
+
+  if (rootTransforms.IsEmpty())
+    return;
+
+  EZ_PROFILE_SCOPE("ezWorldReader::InstantiatePrefabs");
+
+  EZ_LOCK(world.GetWriteMarker());
+
+  m_pWorld = &world;
+  ClearComponentManagers();
+
+  const ezUInt32 uiNumInstances = rootTransforms.GetCount();
+
+  if (options.m_pCreatedRootObjectsOut != nullptr)
+  {
+    options.m_pCreatedRootObjectsOut->Reserve(options.m_pCreatedRootObjectsOut->GetCount() + uiNumInstances * m_RootObjectsToCreate.GetCount());
+  }
+
+  if (options.m_pCreatedChildObjectsOut != nullptr)
+  {
+    options.m_pCreatedChildObjectsOut->Reserve(options.m_pCreatedChildObjectsOut->GetCount() + uiNumInstances * m_ChildObjectsToCreate.GetCount());
+  }
+
+  ezPrefabInstantiationOptions instanceOptions = options;
+
+  for (const ezTransform& rootTransform : rootTransforms)
+  {
+    ClearHandles();
+
+    InstantiationContext context = InstantiationContext(*this, true, rootTransform, instanceOptions);
+    EZ_VERIFY(context.Step() == InstantiationContextBase::StepResult::Finished, "Instantiation should be completed after this call");
+
+    // continue the seed sequence, otherwise all instances would get the same random seeds
+    instanceOptions.m_uiCustomRandomSeedRootValue = context.m_Options.m_uiCustomRandomSeedRootValue;
+  }
+}
+
 ezGameObjectHandle ezWorldReader::ReadGameObjectHandle()
 {
   ezUInt32 idx = 0;
@@ -146,16 +186,19 @@ void ezWorldReader::ClearAndCompact()
   m_ComponentTypeVersions.Clear();
   m_ComponentTypeVersions.Compact();
 
-  m_ComponentCreationStream.Clear();
-  m_ComponentCreationStream.Compact();
-
   m_ComponentDataStream.Clear();
   m_ComponentDataStream.Compact();
 }
 
 ezUInt64 ezWorldReader::GetHeapMemoryUsage() const
 {
-  return m_IndexToGameObjectHandle.GetHeapMemoryUsage() + m_RootObjectsToCreate.GetHeapMemoryUsage() + m_ChildObjectsToCreate.GetHeapMemoryUsage() + m_ComponentTypes.GetHeapMemoryUsage() + m_ComponentTypeVersions.GetHeapMemoryUsage() + m_ComponentCreationStream.GetHeapMemoryUsage() +
+  ezUInt64 uiComponentsMemory = 0;
+  for (auto& compTypeInfo : m_ComponentTypes)
+  {
+    uiComponentsMemory += compTypeInfo.m_ComponentIndexToHandle.GetHeapMemoryUsage() + compTypeInfo.m_ComponentsToCreate.GetHeapMemoryUsage();
+  }
+
+  return m_IndexToGameObjectHandle.GetHeapMemoryUsage() + m_RootObjectsToCreate.GetHeapMemoryUsage() + m_ChildObjectsToCreate.GetHeapMemoryUsage() + m_ComponentTypes.GetHeapMemoryUsage() + m_ComponentTypeVersions.GetHeapMemoryUsage() + uiComponentsMemory +
          m_ComponentDataStream.GetHeapMemoryUsage();
 }
 
@@ -280,8 +323,15 @@ void ezWorldReader::ReadComponentDataToMemStream()
   };
 
   {
-    ezMemoryStreamWriter writer(&m_ComponentCreationStream);
-    WriteToMemStream(writer, true);
+    ezDefaultMemoryStreamStorage componentCreationStream;
+
+    {
+      ezMemoryStreamWriter writer(&componentCreationStream);
+      WriteToMemStream(writer, true);
+    }
+
+    ezMemoryStreamReader reader(&componentCreationStream);
+    ReadComponentCreationData(reader);
   }
 
   {
@@ -290,6 +340,33 @@ void ezWorldReader::ReadComponentDataToMemStream()
   }
 }
 
+void ezWorldReader::ReadComponentCreationData(ezStreamReader& stream)
+{
+  for (auto& compTypeInfo : m_ComponentTypes)
+  {
+    compTypeInfo.m_ComponentsToCreate.Clear();
+
+    if (compTypeInfo.m_pRtti == nullptr)
+      continue;
+
+    compTypeInfo.m_ComponentsToCreate.SetCount(compTypeInfo.m_uiNumComponents);
+
+    for (ezUInt32 i = 0; i < compTypeInfo.m_uiNumComponents; ++i)
+    {
+      ComponentToCreate& compDesc = compTypeInfo.m_ComponentsToCreate[i];
+
+      ezUInt32 uiComponentIdx = 0;
+
+      stream >> compDesc.m_uiOwnerHandleIdx;
+      stream >> uiComponentIdx;
+      stream >> compDesc.m_bActive;
+      stream >> compDesc.m_uiUserFlags;
+
+      EZ_ASSERT_DEBUG(uiComponentIdx == i + 1, "Component index doesn't match");
+    }
+  }
+}
+
 void ezWorldReader::ClearHandles()
 {
   m_IndexToGameObjectHandle.Clear();
@@ -302,11 +379,20 @@ void ezWorldReader::ClearHandles()
   }
 }
 
+void ezWorldReader::ClearComponentManagers()
+{
+  for (auto& compTypeInfo : m_ComponentTypes)
+  {
+    compTypeInfo.m_pManager = nullptr;
+  }
+}
+
 ezUniquePtr<ezWorldReader::InstantiationContextBase> ezWorldReader::Instantiate(ezWorld& world, bool bUseTransform, const ezTransform& rootTransform, const ezPrefabInstantiationOptions& options)
 {
   m_pWorld = &world;
 
   ClearHandles();
+  ClearComponentManagers();
 
   if (options.m_MaxStepTime <= ezTime::Zero())
   {
@@ -328,6 +414,7 @@ ezWorldReader::InstantiationContext::InstantiationContext(ezWorldReader& worldRe
   , m_Options(options)
 {
   m_Phase = Phase::CreateRootObjects;
+  m_bTimeSliced = m_Options.m_MaxStepTime.IsPositive();
 
   if (m_Options.m_MaxStepTime.IsZeroOrNegative())
   {
@@ -394,25 +481,14 @@ ezWorldReader::InstantiationContext::StepResult ezWorldReader::InstantiationCont
     if (!CreateGameObjects<false>(m_WorldReader.m_ChildObjectsToCreate, ezGameObjectHandle(), m_Options.m_pCreatedChildObjectsOut, endTime))
       return StepResult::Continue;
 
-    m_CurrentReader.SetStorage(&m_WorldReader.m_ComponentCreationStream);
     m_Phase = Phase::CreateComponents;
     BeginNextProgressStep("CreateComponents");
   }
 
   if (m_Phase == Phase::CreateComponents)
   {
-    if (m_WorldReader.m_ComponentCreationStream.GetStorageSize64() > 0)
-    {
-      m_WorldReader.m_pStringDedupReadContext->SetActive(true);
-
-      ezStreamReader* pPrevReader = m_WorldReader.m_pStream;
-      m_WorldReader.m_pStream = &m_CurrentReader;
-
-      EZ_SCOPE_EXIT(m_WorldReader.m_pStream = pPrevReader; m_WorldReader.m_pStringDedupReadContext->SetActive(false););
-
-      if (!CreateComponents(endTime))
-        return StepResult::Continue;
-    }
+    if (!CreateComponents(endTime))
+      return StepResult::Continue;
 
     m_CurrentReader.SetStorage(&m_WorldReader.m_ComponentDataStream);
     m_Phase = Phase::DeserializeComponents;
@@ -552,7 +628,7 @@ bool ezWorldReader::InstantiationContext::CreateGameObjects(const ezDynamicArray
     ++m_uiCurrentIndex;
 
     // exit here to ensure that we at least did some work
-    if (ezTime::Now() >= endTime)
+    if (IsStepTimeExceeded(endTime))
     {
       SetSubProgressCompletion(static_cast<double>(m_uiCurrentIndex) / objects.GetCount());
       return false;
@@ -568,31 +644,29 @@ bool ezWorldReader::InstantiationContext::CreateComponents(ezTime endTime)
 {
   EZ_PROFILE_SCOPE("ezWorldReader::CreateComponents");
 
-  ezStreamReader& s = *m_WorldReader.m_pStream;
-
   for (; m_uiCurrentComponentTypeIndex < m_WorldReader.m_ComponentTypes.GetCount(); ++m_uiCurrentComponentTypeIndex)
   {
     auto& compTypeInfo = m_WorldReader.m_ComponentTypes[m_uiCurrentComponentTypeIndex];
 
     // will be the case for all abstract component types
-    if (compTypeInfo.m_pRtti == nullptr || compTypeInfo.m_uiNumComponents == 0)
+    if (compTypeInfo.m_pRtti == nullptr || compTypeInfo.m_ComponentsToCreate.IsEmpty())
       continue;
 
-    ezComponentManagerBase* pManager = m_WorldReader.m_pWorld->GetOrCreateManagerForComponentType(compTypeInfo.m_pRtti);
-    EZ_ASSERT_DEV(pManager != nullptr, "Cannot create components of type '{0}', manager is not available.", compTypeInfo.m_pRtti->GetTypeName());
-
-    while (m_uiCurrentIndex < compTypeInfo.m_uiNumComponents)
+    if (compTypeInfo.m_pManager == nullptr)
     {
-      const ezGameObjectHandle hOwner = m_WorldReader.ReadGameObjectHandle();
+      compTypeInfo.m_pManager = m_WorldReader.m_pWorld->GetOrCreateManagerForComponentType(compTypeInfo.m_pRtti);
+      EZ_ASSERT_DEV(compTypeInfo.m_pManager != nullptr, "Cannot create components of type '{0}', manager is not available.", compTypeInfo.m_pRtti->GetTypeName());
+    }
 
-      ezUInt32 uiComponentIdx = 0;
-      s >> uiComponentIdx;
+    ezComponentManagerBase* pManager = compTypeInfo.m_pManager;
+    const ezUInt32 uiNumComponents = compTypeInfo.m_ComponentsToCreate.GetCount();
 
-      bool bActive = true;
-      s >> bActive;
+    compTypeInfo.m_ComponentIndexToHandle.Reserve(uiNumComponents + 1);
 
-      ezUInt8 userFlags = 0;
-      s >> userFlags;
+    while (m_uiCurrentIndex < uiNumComponents)
+    {
+      const ComponentToCreate& compDesc = compTypeInfo.m_ComponentsToCreate[m_uiCurrentIndex];
+      const ezGameObjectHandle hOwner = m_WorldReader.m_IndexToGameObjectHandle[compDesc.m_uiOwnerHandleIdx];
 
       ezGameObject* pOwnerObject = nullptr;
       if (!m_WorldReader.m_pWorld->TryGetObject(hOwner, pOwnerObject))
@@ -603,21 +677,20 @@ bool ezWorldReader::InstantiationContext::CreateComponents(ezTime endTime)
       ezComponent* pComponent = nullptr;
       auto hComponent = pManager->CreateComponentNoInit(pOwnerObject, pComponent);
 
-      pComponent->SetActiveFlag(bActive);
+      pComponent->SetActiveFlag(compDesc.m_bActive);
 
       for (ezUInt8 j = 0; j < 8; ++j)
       {
-        pComponent->SetUserFlag(j, (userFlags & EZ_BIT(j)) != 0);
+        pComponent->SetUserFlag(j, (compDesc.m_uiUserFlags & EZ_BIT(j)) != 0);
       }
 
-      EZ_ASSERT_DEBUG(uiComponentIdx == compTypeInfo.m_ComponentIndexToHandle.GetCount(), "Component index doesn't match");
       compTypeInfo.m_ComponentIndexToHandle.PushBack(hComponent);
 
       ++m_uiCurrentIndex;
       ++m_uiCurrentNumComponentsProcessed;
 
       // exit here to ensure that we at least did some work
-      if (ezTime::Now() >= endTime)
+      if (IsStepTimeExceeded(endTime))
       {
         SetSubProgressCompletion((double)m_uiCurrentNumComponentsProcessed / m_WorldReader.m_uiTotalNumComponents);
         return false;
@@ -656,7 +729,7 @@ bool ezWorldReader::InstantiationContext::DeserializeComponents(ezTime endTime)
         ++m_uiCurrentNumComponentsProcessed;
 
         // exit here to ensure that we at least did some work
-        if (ezTime::Now() >= endTime)
+        if (IsStepTimeExceeded(endTime))
         {
           SetSubProgressCompletion((double)m_uiCurrentNumComponentsProcessed / m_WorldReader.m_uiTotalNumComponents);
           return false;
@@ -702,7 +775,7 @@ bool ezWorldReader::InstantiationContext::AddComponentsToBatch(ezTime endTime)
         ++m_uiCurrentNumComponentsProcessed;
 
         // exit here to ensure that we at least did some work
-        if (ezTime::Now() >= endTime)
+        if (IsStepTimeExceeded(endTime))
         {
           SetSubProgressCompletion((double)m_uiCurrentNumComponentsProcessed / m_WorldReader.m_uiTotalNumComponents);
 
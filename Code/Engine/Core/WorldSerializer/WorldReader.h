@@ -112,6 +112,18 @@ public:
   /// has to be valid as long as the instantiation is in progress.
   ezUniquePtr<InstantiationContextBase> InstantiatePrefab(ezWorld& world, const ezTransform& rootTransform, const ezPrefabInstantiationOptions& options);
 
+  /// \brief Creates one instance of the world for every transform in \a rootTransforms.
+  ///
+  /// This gives the same result as calling InstantiatePrefab() once per transform, but is a lot cheaper when many copies are needed
+  /// at once, e.g. for spawning projectiles or debris. The world is locked only once, component managers are looked up only once
+  /// and the output arrays are reserved for all instances up front.
+  ///
+  /// The created objects of all instances are appended to the output arrays in \a options, one instance after the other.
+  /// With RandomSeedMode::CustomRootValue the seed sequence continues from one instance to the next.
+  ///
+  /// The instantiation is always finished when this function returns, so \a options must not specify a max step time or a progress.
+  void InstantiatePrefabs(ezWorld& world, ezArrayPtr<const ezTransform> rootTransforms, const ezPrefabInstantiationOptions& options);
+
   /// \brief Gives access to the stream of data. Use this inside component deserialization functions to read data.
   ezStreamReader& GetStream() const { return *m_pStream; }
 
@@ -161,7 +173,9 @@ private:
   void ReadGameObjectDesc(GameObjectToCreate& godesc);
   void ReadComponentTypeInfo(ezUInt32 uiComponentTypeIdx);
   void ReadComponentDataToMemStream();
+  void ReadComponentCreationData(ezStreamReader& stream);
   void ClearHandles();
+  void ClearComponentManagers();
   ezUniquePtr<InstantiationContextBase> Instantiate(ezWorld& world, bool bUseTransform, const ezTransform& rootTransform, const ezPrefabInstantiationOptions& options);
 
   ezStreamReader* m_pStream = nullptr;
@@ -173,16 +187,25 @@ private:
   ezDynamicArray<GameObjectToCreate> m_RootObjectsToCreate;
   ezDynamicArray<GameObjectToCreate> m_ChildObjectsToCreate;
 
+  /// \brief The creation data of a component is decoded once in ReadWorldDescription() and then reused for every instantiation.
+  struct ComponentToCreate
+  {
+    ezUInt32 m_uiOwnerHandleIdx = 0;
+    bool m_bActive = true;
+    ezUInt8 m_uiUserFlags = 0;
+  };
+
   struct ComponentTypeInfo
   {
     const ezRTTI* m_pRtti = nullptr;
+    ezComponentManagerBase* m_pManager = nullptr; // only valid for m_pWorld during an instantiation
     ezDynamicArray<ezComponentHandle> m_ComponentIndexToHandle;
+    ezDynamicArray<ComponentToCreate> m_ComponentsToCreate;
     ezUInt32 m_uiNumComponents = 0;
   };
 
   ezDynamicArray<ComponentTypeInfo> m_ComponentTypes;
   ezHashTable<const ezRTTI*, ezUInt32> m_ComponentTypeVersions;
-  ezDefaultMemoryStreamStorage m_ComponentCreationStream;
   ezDefaultMemoryStreamStorage m_ComponentDataStream;
   ezUInt64 m_uiTotalNumComponents = 0;
 
@@ -208,6 +231,8 @@ private:
     ezTime GetMaxStepTime() const;
 
   private:
+    EZ_ALWAYS_INLINE bool IsStepTimeExceeded(ezTime endTime) const { return m_bTimeSliced && ezTime::Now() >= endTime; }
+
     void BeginNextProgressStep(const char* szName);
     void SetSubProgressCompletion(double fCompletion);
 
@@ -215,6 +240,7 @@ private:
     ezWorldReader& m_WorldReader;
 
     bool m_bUseTransform = false;
+    bool m_bTimeSliced = false; // whether the instantiation may be distributed over multiple steps, otherwise there is no need to query the time
     ezTransform m_RootTransform;
 
     ezPrefabInstantiationOptions m_Options;
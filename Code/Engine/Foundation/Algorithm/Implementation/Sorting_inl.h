@@ -274,3 +274,74 @@ void ezSorting::InsertionSort(ezArrayPtr<T>& arrayPtr, ezUInt32 uiStartIndex, ez
     }
   }
 }
+
+template <typename T, typename KeyFunc>
+void ezSorting::RadixSort(ezArrayPtr<T> elements, ezArrayPtr<T> scratch, KeyFunc keyFunc)
+{
+  const ezUInt32 uiCount = elements.GetCount();
+  EZ_ASSERT_DEV(scratch.GetCount() >= uiCount, "Scratch buffer is too small ({} elements, {} required)", scratch.GetCount(), uiCount);
+
+  if (uiCount <= 1)
+    return;
+
+  // compute the histograms of all four 8 bit digits in a single pass
+  ezUInt32 histograms[4][256] = {};
+
+  for (ezUInt32 i = 0; i < uiCount; ++i)
+  {
+    const ezUInt32 uiKey = keyFunc(elements[i]);
+
+    ++histograms[0][uiKey & 0xFF];
+    ++histograms[1][(uiKey >> 8) & 0xFF];
+    ++histograms[2][(uiKey >> 16) & 0xFF];
+    ++histograms[3][uiKey >> 24];
+  }
+
+  T* pSrc = elements.GetPtr();
+  T* pDst = scratch.GetPtr();
+
+  for (ezUInt32 uiDigit = 0; uiDigit < 4; ++uiDigit)
+  {
+    ezUInt32* pHistogram = histograms[uiDigit];
+    const ezUInt32 uiShift = uiDigit * 8;
+
+    // all elements are in the same bucket, this pass would not change the order
+    if (pHistogram[(keyFunc(pSrc[0]) >> uiShift) & 0xFF] == uiCount)
+      continue;
+
+    // convert the counts to the start offsets of the buckets
+    ezUInt32 uiOffset = 0;
+    for (ezUInt32 b = 0; b < 256; ++b)
+    {
+      const ezUInt32 uiBucketCount = pHistogram[b];
+      pHistogram[b] = uiOffset;
+      uiOffset += uiBucketCount;
+    }
+
+    for (ezUInt32 i = 0; i < uiCount; ++i)
+    {
+      const ezUInt32 uiBucket = (keyFunc(pSrc[i]) >> uiShift) & 0xFF;
+      pDst[pHistogram[uiBucket]++] = std::move(pSrc[i]);
+    }
+
+    ezMath::Swap(pSrc, pDst);
+  }
+
+  if (pSrc != elements.GetPtr())
+  {
+    for (ezUInt32 i = 0; i < uiCount; ++i)
+    {
+      elements[i] = std::move(pSrc[i]);
+    }
+  }
+}
+
+inline ezUInt32 ezSorting::FloatToRadixKey(float f)
+{
+  const ezUInt32 uiBits = ezIntFloatUnion(f).i;
+
+  // positive numbers only need the sign bit to be set to sort after all negative numbers,
+  // negative numbers additionally need all other bits flipped, because larger magnitudes have to sort first
+  const ezUInt32 uiMask = static_cast<ezUInt32>(-static_cast<ezInt32>(uiBits >> 31)) | 0x80000000u;
+  return uiBits ^ uiMask;
+}
@@ -27,6 +27,21 @@ public:
   template <typename T, typename Comparer>
   static void InsertionSort(ezArrayPtr<T>& arrayPtr, const Comparer& comparer = Comparer()); // [tested]
 
+
+  /// \brief Sorts the elements in ascending order of a 32 bit key using a least significant digit radix sort (stable, not in-place).
+  ///
+  /// \a scratch must hold at least as many elements as \a elements, the sorted result is always written back to \a elements.
+  /// \a keyFunc is called with an element and has to return its key as ezUInt32. It is called multiple times per element,
+  /// so it should be cheap. Use FloatToRadixKey() to sort by float values.
+  /// Digits that are identical for all elements are skipped, so sorting keys from a small value range only takes one or two passes.
+  template <typename T, typename KeyFunc>
+  static void RadixSort(ezArrayPtr<T> elements, ezArrayPtr<T> scratch, KeyFunc keyFunc); // [tested]
+
+  /// \brief Maps a float to an unsigned integer, such that the integers sort in the same order as the floats. NaNs are not supported.
+  ///
+  /// Use ~FloatToRadixKey(f) to sort in descending order.
+  static ezUInt32 FloatToRadixKey(float f); // [tested]
+
 private:
   enum
   {
@@ -6,6 +6,10 @@
 typedef ezGuardedAllocator DefaultHeapType;
 typedef ezGuardedAllocator DefaultAlignedHeapType;
 typedef ezGuardedAllocator DefaultStaticHeapType;
+#elif EZ_ENABLED(EZ_USE_THREAD_CACHING_ALLOCATIONS)
+typedef ezThreadCachingHeapAllocator DefaultHeapType;
+typedef ezThreadCachingHeapAllocator DefaultAlignedHeapType;
+typedef ezHeapAllocator DefaultStaticHeapType;
 #else
 typedef ezHeapAllocator DefaultHeapType;
 typedef ezAlignedHeapAllocator DefaultAlignedHeapType;
@@ -6,6 +6,7 @@
 #include <Foundation/DataProcessing/Stream/ProcessingStreamProcessor.h>
 #include <Foundation/Logging/Log.h>
 #include <Foundation/Memory/MemoryUtils.h>
+#include <Foundation/Threading/TaskSystem.h>
 
 ezProcessingStreamGroup::ezProcessingStreamGroup()
 {
@@ -161,10 +162,25 @@ void ezProcessingStreamGroup::Process()
 {
   EnsureStreamAssignmentValid();
 
-  // TODO: Identify which processors work on which streams and find independent groups and use separate tasks for them?
-  for (ezProcessingStreamProcessor* pStreamProcessor : m_Processors)
+  const bool bProcessInParallel = m_uiNumActiveElements >= m_uiParallelProcessingMinElements;
+
+  for (ezUInt32 i = 0; i < m_Processors.GetCount();)
   {
-    pStreamProcessor->Process(m_uiNumActiveElements);
+    if (!bProcessInParallel || !m_Processors[i]->SupportsParallelProcessing())
+    {
+      m_Processors[i]->Process(m_uiNumActiveElements);
+      ++i;
+      continue;
+    }
+
+    ezUInt32 uiEnd = i + 1;
+    while (uiEnd < m_Processors.GetCount() && m_Processors[uiEnd]->SupportsParallelProcessing())
+    {
+      ++uiEnd;
+    }
+
+    ProcessRangesInParallel(i, uiEnd);
+    i = uiEnd;
   }
 
   // Run any pending deletions which happened due to stream processor execution
@@ -175,6 +191,25 @@ void ezProcessingStreamGroup::Process()
   RunPendingSpawns();
 }
 
+void ezProcessingStreamGroup::ProcessRangesInParallel(ezUInt32 uiFirstProcessor, ezUInt32 uiEndProcessor)
+{
+  ezParallelForParams params;
+  params.uiBinSize = m_uiParallelProcessingElementsPerTask;
+  params.uiMaxTasksPerThread = 2;
+
+  // all processors of the run are executed on one range before the next range is processed,
+  // this is equivalent to running them one after another, since every processor only touches the elements of its range,
+  // but the data of a range stays in the cache
+  ezTaskSystem::ParallelForIndexed(
+    0, static_cast<ezUInt32>(m_uiNumActiveElements),
+    [this, uiFirstProcessor, uiEndProcessor](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) {
+      for (ezUInt32 p = uiFirstProcessor; p < uiEndProcessor; ++p)
+      {
+        m_Processors[p]->ProcessRange(uiStartIndex, uiEndIndex - uiStartIndex);
+      }
+    },
+    "ezProcessingStreamGroup::Process", params);
+}
 
 void ezProcessingStreamGroup::RunPendingDeletions()
 {
@@ -65,8 +65,19 @@ public:
   void InitializeElements(ezUInt64 uiNumElements);
 
   /// \brief Runs the stream processors which have been added to the stream group.
+  ///
+  /// If there are at least as many active elements as the parallel processing threshold, consecutive processors that support parallel
+  /// processing (see ezProcessingStreamProcessor::SupportsParallelProcessing()) are executed on sub-ranges of the elements in parallel.
   void Process();
 
+  /// \brief Sets how many active elements there need to be, before processors are executed in parallel and how many elements each task
+  /// processes at least.
+  void SetParallelProcessing(ezUInt64 uiMinElements, ezUInt32 uiElementsPerTask)
+  {
+    m_uiParallelProcessingMinElements = uiMinElements;
+    m_uiParallelProcessingElementsPerTask = ezMath::Max(1u, uiElementsPerTask);
+  }
+
   /// \brief Returns the number of elements the streams store.
   inline ezUInt64 GetNumElements() const { return m_uiNumElements; }
 
@@ -89,6 +100,8 @@ private:
 
   void SortProcessorsByPriority();
 
+  void ProcessRangesInParallel(ezUInt32 uiFirstProcessor, ezUInt32 uiEndProcessor);
+
   ezHybridArray<ezProcessingStreamProcessor*, 8> m_Processors;
 
   ezHybridArray<ezProcessingStream*, 8> m_DataStreams;
@@ -104,4 +117,8 @@ private:
   ezUInt64 m_uiHighestNumActiveElements;
 
   bool m_bStreamAssignmentDirty;
+
+  ezUInt64 m_uiParallelProcessingMinElements = 16 * 1024;
+
+  ezUInt32 m_uiParallelProcessingElementsPerTask = 4 * 1024;
 };
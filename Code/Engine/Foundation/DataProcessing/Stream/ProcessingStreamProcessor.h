@@ -35,6 +35,17 @@ protected:
   /// \brief The actual method which processes the data, will be called with the number of elements to process.
   virtual void Process(ezUInt64 uiNumElements) = 0;
 
+  /// \brief Return true, if ProcessRange() is implemented and may be called concurrently for disjoint element ranges.
+  ///
+  /// Such processors must only read and write the elements inside the given range and must not modify any other state,
+  /// e.g. they must not remove elements. All per-frame preparations have to happen outside of ProcessRange().
+  virtual bool SupportsParallelProcessing() const { return false; }
+
+  /// \brief Processes the elements in the range [uiStartIndex; uiStartIndex + uiNumElements).
+  ///
+  /// Only called by ezProcessingStreamGroup if SupportsParallelProcessing() returns true. In that case, Process() is not called for that frame.
+  virtual void ProcessRange(ezUInt64 uiStartIndex, ezUInt64 uiNumElements) {}
+
   /// \brief Back pointer to the stream group - will be set to the owner stream group when adding the stream processor to the group.
   /// Can be used to get stream pointers in UpdateStreamBindings();
   ezProcessingStreamGroup* m_pStreamGroup;
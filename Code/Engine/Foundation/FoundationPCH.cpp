@@ -75,6 +75,7 @@ EZ_STATICLINK_LIBRARY(Foundation)
   EZ_STATICLINK_REFERENCE(Foundation_IO_Implementation_DeduplicationContext);
   EZ_STATICLINK_REFERENCE(Foundation_IO_Implementation_DependencyFile);
   EZ_STATICLINK_REFERENCE(Foundation_IO_Implementation_DirectoryWatcher);
+  EZ_STATICLINK_REFERENCE(Foundation_IO_Implementation_JSONDocument);
   EZ_STATICLINK_REFERENCE(Foundation_IO_Implementation_JSONParser);
   EZ_STATICLINK_REFERENCE(Foundation_IO_Implementation_JSONReader);
   EZ_STATICLINK_REFERENCE(Foundation_IO_Implementation_JSONWriter);
@@ -111,11 +112,13 @@ EZ_STATICLINK_LIBRARY(Foundation)
   EZ_STATICLINK_REFERENCE(Foundation_Memory_Implementation_MemoryUtils);
   EZ_STATICLINK_REFERENCE(Foundation_Memory_Implementation_PageAllocator);
   EZ_STATICLINK_REFERENCE(Foundation_Memory_Policies_GuardedAllocation);
+  EZ_STATICLINK_REFERENCE(Foundation_Memory_Policies_ThreadCachingAllocation);
   EZ_STATICLINK_REFERENCE(Foundation_Profiling_Implementation_Profiling);
   EZ_STATICLINK_REFERENCE(Foundation_Reflection_Implementation_PropertyAttributes);
   EZ_STATICLINK_REFERENCE(Foundation_Reflection_Implementation_PropertyPath);
   EZ_STATICLINK_REFERENCE(Foundation_Reflection_Implementation_RTTI);
   EZ_STATICLINK_REFERENCE(Foundation_Reflection_Implementation_ReflectionUtils);
+  EZ_STATICLINK_REFERENCE(Foundation_Reflection_Implementation_SerializationPlan);
   EZ_STATICLINK_REFERENCE(Foundation_Reflection_Implementation_StandardTypes);
   EZ_STATICLINK_REFERENCE(Foundation_Serialization_Implementation_AbstractObjectGraph);
   EZ_STATICLINK_REFERENCE(Foundation_Serialization_Implementation_BinarySerializer);
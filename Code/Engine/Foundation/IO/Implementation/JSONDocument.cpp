@@ -0,0 +1,930 @@
+#include <Foundation/FoundationPCH.h>
+
+#include <Foundation/IO/JSONDocument.h>
+#include <Foundation/Logging/Log.h>
+#include <Foundation/SimdMath/SimdTypes.h>
+#include <Foundation/Strings/StringBuilder.h>
+#include <Foundation/Utilities/ConversionUtils.h>
+
+namespace
+{
+  EZ_ALWAYS_INLINE bool IsWhitespace(char c)
+  {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+  }
+
+  EZ_ALWAYS_INLINE bool IsDigit(char c)
+  {
+    return c >= '0' && c <= '9';
+  }
+
+  /// Returns the position of the first character at or after uiPos that is not whitespace, or uiSize.
+  EZ_ALWAYS_INLINE ezUInt64 FindNonWhitespace(const char* pText, ezUInt64 uiPos, ezUInt64 uiSize)
+  {
+    // most of the time there is no or only a single whitespace character
+    if (uiPos < uiSize && !IsWhitespace(pText[uiPos]))
+      return uiPos;
+
+#if EZ_SIMD_IMPLEMENTATION == EZ_SIMD_IMPLEMENTATION_SSE
+    // indentation comes in long runs, check 16 characters at once
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i newLine = _mm_set1_epi8('\n');
+    const __m128i carriageReturn = _mm_set1_epi8('\r');
+    const __m128i tab = _mm_set1_epi8('\t');
+
+    while (uiPos + 16 <= uiSize)
+    {
+      const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pText + uiPos));
+      const __m128i whitespace = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, space), _mm_cmpeq_epi8(chunk, newLine)), _mm_or_si128(_mm_cmpeq_epi8(chunk, carriageReturn), _mm_cmpeq_epi8(chunk, tab)));
+      const ezUInt32 uiMask = ~static_cast<ezUInt32>(_mm_movemask_epi8(whitespace)) & 0xFFFF;
+
+      if (uiMask != 0)
+        return uiPos + ezMath::FirstBitLow(uiMask);
+
+      uiPos += 16;
+    }
+#endif
+
+    while (uiPos < uiSize && IsWhitespace(pText[uiPos]))
+    {
+      ++uiPos;
+    }
+
+    return uiPos;
+  }
+
+  /// Returns the position of the first quote, backslash or control character at or after uiPos, or uiSize.
+  /// This is where most of the parsing time is spent.
+  EZ_ALWAYS_INLINE ezUInt64 FindStringSpecialCharacter(const char* pText, ezUInt64 uiPos, ezUInt64 uiSize)
+  {
+#if EZ_SIMD_IMPLEMENTATION == EZ_SIMD_IMPLEMENTATION_SSE
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i lastControl = _mm_set1_epi8(0x1F);
+
+    while (uiPos + 16 <= uiSize)
+    {
+      const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pText + uiPos));
+
+      // there is no unsigned byte comparison, but a byte is a control character exactly when the unsigned minimum with 0x1F doesn't change it
+      const __m128i control = _mm_cmpeq_epi8(_mm_min_epu8(chunk, lastControl), chunk);
+      const __m128i special = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)), control);
+      const ezUInt32 uiMask = static_cast<ezUInt32>(_mm_movemask_epi8(special));
+
+      if (uiMask != 0)
+        return uiPos + ezMath::FirstBitLow(uiMask);
+
+      uiPos += 16;
+    }
+#elif EZ_ENABLED(EZ_PLATFORM_LITTLE_ENDIAN)
+    // without SIMD instructions, check 8 characters at once in a 64 bit register
+    constexpr ezUInt64 uiOnes = 0x0101010101010101ull;
+    constexpr ezUInt64 uiHighBits = 0x8080808080808080ull;
+    constexpr ezUInt64 uiQuotes = uiOnes * '"';
+    constexpr ezUInt64 uiBackslashes = uiOnes * '\\';
+    constexpr ezUInt64 uiSpaces = uiOnes * ' ';
+
+    while (uiPos + 8 <= uiSize)
+    {
+      ezUInt64 uiChunk;
+      ezMemoryUtils::RawByteCopy(&uiChunk, pText + uiPos, sizeof(uiChunk));
+
+      // sets the high bit of every byte that is zero after the xor, or below a space for the control characters,
+      // the lowest one is always exact
+      const ezUInt64 uiQuoteBytes = uiChunk ^ uiQuotes;
+      const ezUInt64 uiBackslashBytes = uiChunk ^ uiBackslashes;
+      const ezUInt64 uiMask =
+        (((uiQuoteBytes - uiOnes) & ~uiQuoteBytes) | ((uiBackslashBytes - uiOnes) & ~uiBackslashBytes) | ((uiChunk - uiSpaces) & ~uiChunk)) & uiHighBits;
+
+      if (uiMask != 0)
+        return uiPos + ezMath::FirstBitLow(uiMask) / 8;
+
+      uiPos += 8;
+    }
+#endif
+
+    while (uiPos < uiSize && pText[uiPos] != '"' && pText[uiPos] != '\\' && static_cast<ezUInt8>(pText[uiPos]) >= 0x20)
+    {
+      ++uiPos;
+    }
+
+    return uiPos;
+  }
+
+  bool ReadHexCodeUnit(const char* pText, ezUInt32& out_uiCodeUnit)
+  {
+    out_uiCodeUnit = 0;
+
+    for (ezUInt32 i = 0; i < 4; ++i)
+    {
+      const ezInt8 iValue = ezConversionUtils::HexCharacterToIntValue(pText[i]);
+      if (iValue < 0)
+        return false;
+
+      out_uiCodeUnit = (out_uiCodeUnit << 4) | iValue;
+    }
+
+    return true;
+  }
+} // namespace
+
+//////////////////////////////////////////////////////////////////////////
+
+class ezJSONDocument::Parser
+{
+public:
+  Parser(ezStringView sText, ezDynamicArray<TapeEntry>& ref_tape, ezLogInterface* pLog)
+    : m_pText(sText.GetStartPointer())
+    , m_uiSize(sText.GetElementCount())
+    , m_Tape(ref_tape)
+    , m_pLog(pLog)
+  {
+  }
+
+  ezResult Parse()
+  {
+    m_Tape.Clear();
+    m_Tape.Reserve(static_cast<ezUInt32>(ezMath::Min<ezUInt64>(m_uiSize / 32 + 16, 0xFFFFFFFF)));
+
+    EZ_SUCCEED_OR_RETURN(SkipWhitespace());
+
+    // like ezJSONParser, accept empty documents
+    if (m_uiPos == m_uiSize)
+      return EZ_SUCCESS;
+
+    State state = State::Value;
+
+    while (state != State::Done)
+    {
+      switch (state)
+      {
+        case State::Value:
+          EZ_SUCCEED_OR_RETURN(ParseValue(state));
+          break;
+
+        case State::MemberName:
+          EZ_SUCCEED_OR_RETURN(ParseMemberName());
+          state = State::Value;
+          break;
+
+        case State::AfterValue:
+          EZ_SUCCEED_OR_RETURN(ParseAfterValue(state));
+          break;
+
+        case State::Done:
+          break;
+      }
+    }
+
+    return EZ_SUCCESS;
+  }
+
+private:
+  enum class State
+  {
+    Value,
+    MemberName,
+    AfterValue,
+    Done,
+  };
+
+  struct OpenContainer
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezUInt32 m_uiTapeIndex;
+    ezUInt32 m_uiCount;
+    bool m_bIsObject;
+  };
+
+  ezResult Error(const char* szMessage)
+  {
+    // the position is only computed when it is needed
+    ezUInt32 uiLine = 1;
+    ezUInt64 uiLineStart = 0;
+    const ezUInt64 uiEnd = ezMath::Min(m_uiPos, m_uiSize);
+
+    for (ezUInt64 i = 0; i < uiEnd; ++i)
+    {
+      if (m_pText[i] == '\n')
+      {
+        ++uiLine;
+        uiLineStart = i + 1;
+      }
+    }
+
+    ezLog::Error(m_pLog, "Line {0} ({1}): {2}", uiLine, uiEnd - uiLineStart + 1, szMessage);
+    m_Tape.Clear();
+    return EZ_FAILURE;
+  }
+
+  EZ_ALWAYS_INLINE char Peek() const { return m_uiPos < m_uiSize ? m_pText[m_uiPos] : '\0'; }
+
+  EZ_ALWAYS_INLINE TapeEntry& AddEntry(ValueType type)
+  {
+    EZ_ASSERT_DEV(m_Tape.GetCount() < 0xFFFFFFFF, "JSON document has too many values.");
+
+    TapeEntry& entry = m_Tape.ExpandAndGetRef();
+    entry.m_Type = type;
+    entry.m_uiFlags = 0;
+    entry.m_uiCount = 0;
+    entry.m_uiPayload = 0;
+    return entry;
+  }
+
+  EZ_ALWAYS_INLINE ezResult SkipWhitespace()
+  {
+    while (true)
+    {
+      m_uiPos = FindNonWhitespace(m_pText, m_uiPos, m_uiSize);
+
+      if (m_uiPos + 1 >= m_uiSize || m_pText[m_uiPos] != '/')
+        return EZ_SUCCESS;
+
+      EZ_SUCCEED_OR_RETURN(SkipComment());
+    }
+  }
+
+  ezResult SkipComment()
+  {
+    if (m_pText[m_uiPos + 1] == '/')
+    {
+      while (m_uiPos < m_uiSize && m_pText[m_uiPos] != '\n')
+      {
+        ++m_uiPos;
+      }
+
+      return EZ_SUCCESS;
+    }
+
+    if (m_pText[m_uiPos + 1] == '*')
+    {
+      for (m_uiPos += 2; m_uiPos + 1 < m_uiSize; ++m_uiPos)
+      {
+        if (m_pText[m_uiPos] == '*' && m_pText[m_uiPos + 1] == '/')
+        {
+          m_uiPos += 2;
+          return EZ_SUCCESS;
+        }
+      }
+
+      return Error("Reached the end of the document before the end of a block comment.");
+    }
+
+    return Error("Expected a comment after '/'.");
+  }
+
+  ezResult ParseValue(State& out_NextState)
+  {
+    switch (Peek())
+    {
+      case '{':
+      case '[':
+      {
+        const bool bIsObject = Peek() == '{';
+
+        auto& container = m_OpenContainers.ExpandAndGetRef();
+        container.m_uiTapeIndex = m_Tape.GetCount();
+        container.m_uiCount = 0;
+        container.m_bIsObject = bIsObject;
+
+        AddEntry(bIsObject ? ValueType::Object : ValueType::Array);
+
+        ++m_uiPos;
+        EZ_SUCCEED_OR_RETURN(SkipWhitespace());
+
+        if (Peek() == (bIsObject ? '}' : ']'))
+        {
+          ++m_uiPos;
+          CloseContainer(false);
+          out_NextState = State::AfterValue;
+        }
+        else
+        {
+          out_NextState = bIsObject ? State::MemberName : State::Value;
+        }
+
+        return EZ_SUCCESS;
+      }
+
+      case '"':
+        out_NextState = State::AfterValue;
+        return ParseString(0);
+
+      case 't':
+        out_NextState = State::AfterValue;
+        return ParseLiteral("true", ValueType::Bool, 1);
+
+      case 'f':
+        out_NextState = State::AfterValue;
+        return ParseLiteral("false", ValueType::Bool, 0);
+
+      case 'n':
+        out_NextState = State::AfterValue;
+        return ParseLiteral("null", ValueType::Null, 0);
+
+      default:
+        if (Peek() == '-' || IsDigit(Peek()))
+        {
+          out_NextState = State::AfterValue;
+          return ParseNumber();
+        }
+
+        return Error("Expected a value.");
+    }
+  }
+
+  ezResult ParseMemberName()
+  {
+    if (Peek() != '"')
+      return Error("Expected a member name.");
+
+    EZ_SUCCEED_OR_RETURN(ParseString(IsMemberName));
+    EZ_SUCCEED_OR_RETURN(SkipWhitespace());
+
+    if (Peek() != ':')
+      return Error("Expected a ':' after the member name.");
+
+    ++m_uiPos;
+    return SkipWhitespace();
+  }
+
+  ezResult ParseAfterValue(State& out_NextState)
+  {
+    EZ_SUCCEED_OR_RETURN(SkipWhitespace());
+
+    if (m_OpenContainers.IsEmpty())
+    {
+      if (m_uiPos != m_uiSize)
+        return Error("Expected the end of the document after the top level value.");
+
+      out_NextState = State::Done;
+      return EZ_SUCCESS;
+    }
+
+    OpenContainer& container = m_OpenContainers.PeekBack();
+
+    const char c = Peek();
+    if (c == ',')
+    {
+      ++m_uiPos;
+      ++container.m_uiCount;
+      out_NextState = container.m_bIsObject ? State::MemberName : State::Value;
+      return SkipWhitespace();
+    }
+
+    if (c == (container.m_bIsObject ? '}' : ']'))
+    {
+      ++m_uiPos;
+      CloseContainer(true);
+      out_NextState = State::AfterValue;
+      return EZ_SUCCESS;
+    }
+
+    return Error(container.m_bIsObject ? "Expected a ',' or a '}' after an object member." : "Expected a ',' or a ']' after an array element.");
+  }
+
+  void CloseContainer(bool bHasContent)
+  {
+    const OpenContainer& container = m_OpenContainers.PeekBack();
+
+    TapeEntry& entry = m_Tape[container.m_uiTapeIndex];
+    entry.m_uiCount = container.m_uiCount + (bHasContent ? 1 : 0);
+    entry.m_uiPayload = m_Tape.GetCount();
+
+    m_OpenContainers.PopBack();
+  }
+
+  ezResult ParseString(ezUInt8 uiFlags)
+  {
+    const ezUInt64 uiStart = ++m_uiPos;
+
+    while (true)
+    {
+      m_uiPos = FindStringSpecialCharacter(m_pText, m_uiPos, m_uiSize);
+
+      if (m_uiPos >= m_uiSize)
+        return Error("Reached the end of the document before the end of a string.");
+
+      if (m_pText[m_uiPos] == '"')
+        break;
+
+      if (static_cast<ezUInt8>(m_pText[m_uiPos]) < 0x20)
+        return Error("Control characters in strings must be escaped.");
+
+      // escape sequences are rare, they are only validated here and decoded later
+      uiFlags |= HasEscapes;
+
+      if (m_uiPos + 1 >= m_uiSize)
+        return Error("Reached the end of the document in an escape sequence.");
+
+      switch (m_pText[m_uiPos + 1])
+      {
+        case '"':
+        case '\\':
+        case '/':
+        case 'b':
+        case 'f':
+        case 'n':
+        case 'r':
+        case 't':
+          m_uiPos += 2;
+          break;
+
+        case 'u':
+        {
+          ezUInt32 uiCodeUnit;
+          if (m_uiPos + 6 > m_uiSize || !ReadHexCodeUnit(m_pText + m_uiPos + 2, uiCodeUnit))
+            return Error("A unicode escape sequence must have 4 hex characters.");
+
+          m_uiPos += 6;
+        }
+        break;
+
+        default:
+          return Error("Unknown escape sequence.");
+      }
+    }
+
+    if (m_uiPos - uiStart > 0xFFFFFFFF)
+      return Error("String is too long.");
+
+    TapeEntry& entry = AddEntry(ValueType::String);
+    entry.m_uiFlags = uiFlags;
+    entry.m_uiCount = static_cast<ezUInt32>(m_uiPos - uiStart);
+    entry.m_uiPayload = uiStart;
+
+    ++m_uiPos;
+    return EZ_SUCCESS;
+  }
+
+  ezResult ParseNumber()
+  {
+    const ezUInt64 uiStart = m_uiPos;
+    ezUInt8 uiFlags = 0;
+
+    if (Peek() == '-')
+      ++m_uiPos;
+
+    if (Peek() == '0')
+    {
+      ++m_uiPos;
+    }
+    else if (IsDigit(Peek()))
+    {
+      while (IsDigit(Peek()))
+        ++m_uiPos;
+    }
+    else
+    {
+      return Error("Expected a digit in a number.");
+    }
+
+    if (Peek() == '.')
+    {
+      uiFlags |= IsFloat;
+      ++m_uiPos;
+
+      if (!IsDigit(Peek()))
+        return Error("Expected a digit after the decimal point.");
+
+      while (IsDigit(Peek()))
+        ++m_uiPos;
+    }
+
+    if (Peek() == 'e' || Peek() == 'E')
+    {
+      uiFlags |= IsFloat;
+      ++m_uiPos;
+
+      if (Peek() == '+' || Peek() == '-')
+        ++m_uiPos;
+
+      if (!IsDigit(Peek()))
+        return Error("Expected a digit in the exponent.");
+
+      while (IsDigit(Peek()))
+        ++m_uiPos;
+    }
+
+    TapeEntry& entry = AddEntry(ValueType::Number);
+    entry.m_uiFlags = uiFlags;
+    entry.m_uiCount = static_cast<ezUInt32>(m_uiPos - uiStart);
+    entry.m_uiPayload = uiStart;
+
+    return EZ_SUCCESS;
+  }
+
+  ezResult ParseLiteral(const char* szLiteral, ValueType type, ezUInt64 uiValue)
+  {
+    const ezUInt32 uiLength = ezStringUtils::GetStringElementCount(szLiteral);
+
+    if (m_uiPos + uiLength > m_uiSize || !ezStringUtils::IsEqualN(m_pText + m_uiPos, szLiteral, uiLength, m_pText + m_uiSize))
+      return Error("Expected 'true', 'false' or 'null'.");
+
+    m_uiPos += uiLength;
+
+    TapeEntry& entry = AddEntry(type);
+    entry.m_uiPayload = uiValue;
+
+    return EZ_SUCCESS;
+  }
+
+  const char* m_pText = nullptr;
+  ezUInt64 m_uiSize = 0;
+  ezUInt64 m_uiPos = 0;
+
+  ezDynamicArray<TapeEntry>& m_Tape;
+  ezHybridArray<OpenContainer, 32> m_OpenContainers;
+  ezLogInterface* m_pLog = nullptr;
+};
+
+//////////////////////////////////////////////////////////////////////////
+
+ezJSONDocument::ezJSONDocument() = default;
+ezJSONDocument::~ezJSONDocument() = default;
+
+ezResult ezJSONDocument::Parse(ezStringView sText, ezLogInterface* pLog)
+{
+  m_OwnedText.Clear();
+  m_OwnedText.Compact();
+  m_sText = sText;
+
+  return ParseText(pLog);
+}
+
+ezResult ezJSONDocument::Parse(ezStreamReader& inout_stream, ezLogInterface* pLog)
+{
+  m_OwnedText.Clear();
+
+  constexpr ezUInt32 uiChunkSize = 1024 * 64;
+  while (true)
+  {
+    const ezUInt32 uiOldCount = m_OwnedText.GetCount();
+    m_OwnedText.SetCountUninitialized(uiOldCount + uiChunkSize);
+
+    const ezUInt32 uiRead = static_cast<ezUInt32>(inout_stream.ReadBytes(m_OwnedText.GetData() + uiOldCount, uiChunkSize));
+    m_OwnedText.SetCountUninitialized(uiOldCount + uiRead);
+
+    if (uiRead < uiChunkSize)
+      break;
+  }
+
+  m_sText = ezStringView(m_OwnedText.GetData(), m_OwnedText.GetData() + m_OwnedText.GetCount());
+
+  return ParseText(pLog);
+}
+
+void ezJSONDocument::Clear()
+{
+  m_sText = ezStringView();
+  m_OwnedText.Clear();
+  m_OwnedText.Compact();
+  m_Tape.Clear();
+  m_Tape.Compact();
+}
+
+ezJSONDocument::Value ezJSONDocument::GetRoot() const
+{
+  if (m_Tape.IsEmpty())
+    return Value();
+
+  return Value(this, 0, m_Tape.GetCount());
+}
+
+ezResult ezJSONDocument::ParseText(ezLogInterface* pLog)
+{
+  Parser parser(m_sText, m_Tape, pLog);
+  return parser.Parse();
+}
+
+ezStringView ezJSONDocument::GetText(const TapeEntry& entry) const
+{
+  const char* pStart = m_sText.GetStartPointer() + entry.m_uiPayload;
+  return ezStringView(pStart, pStart + entry.m_uiCount);
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+const ezJSONDocument::TapeEntry* ezJSONDocument::Value::GetEntry() const
+{
+  if (m_pDocument == nullptr || m_uiIndex >= m_uiParentEnd)
+    return nullptr;
+
+  return &m_pDocument->m_Tape[m_uiIndex];
+}
+
+ezJSONDocument::ValueType ezJSONDocument::Value::GetType() const
+{
+  const TapeEntry* pEntry = GetEntry();
+  return pEntry ? pEntry->m_Type : ValueType::Invalid;
+}
+
+bool ezJSONDocument::Value::GetBool(bool bFallback) const
+{
+  const TapeEntry* pEntry = GetEntry();
+  if (pEntry == nullptr || pEntry->m_Type != ValueType::Bool)
+    return bFallback;
+
+  return pEntry->m_uiPayload != 0;
+}
+
+double ezJSONDocument::Value::GetDouble(double fFallback) const
+{
+  const TapeEntry* pEntry = GetEntry();
+  if (pEntry == nullptr || pEntry->m_Type != ValueType::Number)
+    return fFallback;
+
+  const ezStringView sText = m_pDocument->GetText(*pEntry);
+
+  // integers that fit into the mantissa are converted exactly without going through the string conversion
+  if ((pEntry->m_uiFlags & IsFloat) == 0 && pEntry->m_uiCount <= 15)
+    return static_cast<double>(GetInt64(0));
+
+  // the text isn't zero terminated, the number is followed by whatever comes next in the document
+  ezStringBuilder sTemp = sText;
+
+  double fResult = fFallback;
+  if (ezConversionUtils::StringToFloat(sTemp, fResult).Failed())
+    return fFallback;
+
+  return fResult;
+}
+
+ezInt64 ezJSONDocument::Value::GetInt64(ezInt64 iFallback) const
+{
+  const TapeEntry* pEntry = GetEntry();
+  if (pEntry == nullptr || pEntry->m_Type != ValueType::Number)
+    return iFallback;
+
+  // 18 digits always fit into 63 bits, longer numbers might not
+  if ((pEntry->m_uiFlags & IsFloat) != 0 || pEntry->m_uiCount > 18)
+  {
+    const double fValue = GetDouble(static_cast<double>(iFallback));
+
+    // converting a double outside of the int64 range is undefined, so saturate instead, -2^63 itself is exact
+    if (fValue >= 9223372036854775808.0)
+      return ezMath::MaxValue<ezInt64>();
+    if (fValue < -9223372036854775808.0)
+      return ezMath::MinValue<ezInt64>();
+    if (ezMath::IsNaN(fValue))
+      return iFallback;
+
+    return static_cast<ezInt64>(fValue);
+  }
+
+  const char* pText = m_pDocument->m_sText.GetStartPointer() + pEntry->m_uiPayload;
+  const char* pEnd = pText + pEntry->m_uiCount;
+
+  const bool bNegative = *pText == '-';
+  if (bNegative)
+    ++pText;
+
+  ezInt64 iResult = 0;
+  for (; pText < pEnd; ++pText)
+  {
+    iResult = iResult * 10 + (*pText - '0');
+  }
+
+  return bNegative ? -iResult : iResult;
+}
+
+bool ezJSONDocument::Value::IsInteger() const
+{
+  const TapeEntry* pEntry = GetEntry();
+  return pEntry != nullptr && pEntry->m_Type == ValueType::Number && (pEntry->m_uiFlags & IsFloat) == 0;
+}
+
+ezStringView ezJSONDocument::Value::GetRawString() const
+{
+  const TapeEntry* pEntry = GetEntry();
+  if (pEntry == nullptr || (pEntry->m_Type != ValueType::String && pEntry->m_Type != ValueType::Number))
+    return ezStringView();
+
+  return m_pDocument->GetText(*pEntry);
+}
+
+bool ezJSONDocument::Value::HasEscapeSequences() const
+{
+  const TapeEntry* pEntry = GetEntry();
+  return pEntry != nullptr && (pEntry->m_uiFlags & HasEscapes) != 0;
+}
+
+ezStringView ezJSONDocument::Value::GetString(ezStringBuilder& out_sStorage) const
+{
+  const TapeEntry* pEntry = GetEntry();
+  if (pEntry == nullptr || pEntry->m_Type != ValueType::String)
+    return ezStringView();
+
+  const ezStringView sRaw = m_pDocument->GetText(*pEntry);
+
+  if ((pEntry->m_uiFlags & HasEscapes) == 0)
+    return sRaw;
+
+  out_sStorage.Clear();
+
+  // the escape sequences were validated while parsing
+  const char* pText = sRaw.GetStartPointer();
+  const char* pEnd = sRaw.GetEndPointer();
+
+  while (pText < pEnd)
+  {
+    const char* pBackslash = pText;
+    while (pBackslash < pEnd && *pBackslash != '\\')
+    {
+      ++pBackslash;
+    }
+
+    out_sStorage.Append(ezStringView(pText, pBackslash));
+
+    if (pBackslash == pEnd)
+      break;
+
+    pText = pBackslash + 2;
+
+    switch (pBackslash[1])
+    {
+      case 'b':
+        out_sStorage.Append(ezUInt32('\b'));
+        break;
+      case 'f':
+        out_sStorage.Append(ezUInt32('\f'));
+        break;
+      case 'n':
+        out_sStorage.Append(ezUInt32('\n'));
+        break;
+      case 'r':
+        out_sStorage.Append(ezUInt32('\r'));
+        break;
+      case 't':
+        out_sStorage.Append(ezUInt32('\t'));
+        break;
+
+      case 'u':
+      {
+        ezUInt32 uiCodePoint = 0;
+        ReadHexCodeUnit(pText, uiCodePoint);
+        pText += 4;
+
+        // characters outside of the basic multilingual plane are encoded as utf16 surrogate pairs
+        if (uiCodePoint >= 0xD800 && uiCodePoint <= 0xDBFF)
+        {
+          ezUInt32 uiLowSurrogate = 0;
+          if (pText + 6 <= pEnd && pText[0] == '\\' && pText[1] == 'u' && ReadHexCodeUnit(pText + 2, uiLowSurrogate) && uiLowSurrogate >= 0xDC00 && uiLowSurrogate <= 0xDFFF)
+          {
+            uiCodePoint = 0x10000 + ((uiCodePoint - 0xD800) << 10) + (uiLowSurrogate - 0xDC00);
+            pText += 6;
+          }
+          else
+          {
+            uiCodePoint = 0xFFFD;
+          }
+        }
+        else if (uiCodePoint >= 0xDC00 && uiCodePoint <= 0xDFFF)
+        {
+          uiCodePoint = 0xFFFD;
+        }
+
+        out_sStorage.Append(uiCodePoint);
+      }
+      break;
+
+      default: // '"', '\\' and '/'
+        out_sStorage.Append(ezUInt32(pBackslash[1]));
+        break;
+    }
+  }
+
+  return out_sStorage;
+}
+
+ezUInt32 ezJSONDocument::Value::GetCount() const
+{
+  const TapeEntry* pEntry = GetEntry();
+  if (pEntry == nullptr || (pEntry->m_Type != ValueType::Object && pEntry->m_Type != ValueType::Array))
+    return 0;
+
+  return pEntry->m_uiCount;
+}
+
+ezJSONDocument::Value ezJSONDocument::Value::GetFirstChild() const
+{
+  const TapeEntry* pEntry = GetEntry();
+  if (pEntry == nullptr || (pEntry->m_Type != ValueType::Object && pEntry->m_Type != ValueType::Array) || pEntry->m_uiCount == 0)
+    return Value();
+
+  // skip the name of the first member
+  const ezUInt32 uiFirstChild = m_uiIndex + (pEntry->m_Type == ValueType::Object ? 2 : 1);
+  return Value(m_pDocument, uiFirstChild, static_cast<ezUInt32>(pEntry->m_uiPayload));
+}
+
+ezJSONDocument::Value ezJSONDocument::Value::GetNextSibling() const
+{
+  const TapeEntry* pEntry = GetEntry();
+  if (pEntry == nullptr)
+    return Value();
+
+  ezUInt32 uiNext = m_uiIndex + 1;
+  if (pEntry->m_Type == ValueType::Object || pEntry->m_Type == ValueType::Array)
+  {
+    uiNext = static_cast<ezUInt32>(pEntry->m_uiPayload);
+  }
+
+  if (uiNext >= m_uiParentEnd)
+    return Value();
+
+  if ((m_pDocument->m_Tape[uiNext].m_uiFlags & IsMemberName) != 0)
+    ++uiNext;
+
+  return Value(m_pDocument, uiNext, m_uiParentEnd);
+}
+
+ezJSONDocument::Value ezJSONDocument::Value::GetMemberName() const
+{
+  // a value is a member, if the entry before it is a member name
+  if (GetEntry() == nullptr || m_uiIndex == 0)
+    return Value();
+
+  if ((m_pDocument->m_Tape[m_uiIndex - 1].m_uiFlags & IsMemberName) == 0)
+    return Value();
+
+  return Value(m_pDocument, m_uiIndex - 1, m_uiIndex);
+}
+
+ezJSONDocument::Value ezJSONDocument::Value::GetElement(ezUInt32 uiIndex) const
+{
+  Value child = GetFirstChild();
+
+  for (ezUInt32 i = 0; i < uiIndex && child.IsValid(); ++i)
+  {
+    child = child.GetNextSibling();
+  }
+
+  return child;
+}
+
+ezJSONDocument::Value ezJSONDocument::Value::FindMember(ezStringView sName) const
+{
+  if (!IsObject())
+    return Value();
+
+  ezStringBuilder sTemp;
+
+  for (Value child = GetFirstChild(); child.IsValid(); child = child.GetNextSibling())
+  {
+    if (child.GetMemberName().GetString(sTemp) == sName)
+      return child;
+  }
+
+  return Value();
+}
+
+ezVariant ezJSONDocument::Value::ConvertToVariant() const
+{
+  switch (GetType())
+  {
+    case ValueType::Bool:
+      return ezVariant(GetBool());
+
+    case ValueType::Number:
+      return ezVariant(GetDouble());
+
+    case ValueType::String:
+    {
+      ezStringBuilder sTemp;
+      return ezVariant(ezString(GetString(sTemp)));
+    }
+
+    case ValueType::Object:
+    {
+      ezVariantDictionary dictionary;
+      dictionary.Reserve(GetCount());
+
+      ezStringBuilder sTemp;
+      for (Value child = GetFirstChild(); child.IsValid(); child = child.GetNextSibling())
+      {
+        dictionary[child.GetMemberName().GetString(sTemp)] = child.ConvertToVariant();
+      }
+
+      return ezVariant(dictionary);
+    }
+
+    case ValueType::Array:
+    {
+      ezVariantArray array;
+      array.Reserve(GetCount());
+
+      for (Value child = GetFirstChild(); child.IsValid(); child = child.GetNextSibling())
+      {
+        array.PushBack(child.ConvertToVariant());
+      }
+
+      return ezVariant(array);
+    }
+
+    default:
+      return ezVariant();
+  }
+}
+
+EZ_STATICLINK_FILE(Foundation, Foundation_IO_Implementation_JSONDocument);
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <Foundation/Basics.h>
+#include <Foundation/Containers/DynamicArray.h>
+#include <Foundation/IO/Stream.h>
+#include <Foundation/Strings/StringView.h>
+#include <Foundation/Types/Variant.h>
+
+class ezLogInterface;
+class ezStringBuilder;
+
+/// \brief Parses an entire JSON document from memory into a compact, flat representation.
+///
+/// In contrast to ezJSONReader, no object is allocated per JSON value. Every value is stored as one fixed size entry in a single array
+/// (the 'tape'), in the order in which it appears in the document. Objects and arrays store where their content ends, so they can
+/// be skipped in constant time. Strings and numbers are not converted while parsing, the tape only stores where they are in the text.
+/// They are decoded when they are accessed, so parsing large documents of which only a small part is needed is very cheap.
+///
+/// Parse(ezStringView) doesn't copy the text, it must stay valid for as long as the document is used. This allows to parse
+/// memory mapped files (see ezMemoryMappedFile) directly. Parse(ezStreamReader&) reads the whole stream into an internal buffer first.
+///
+/// Like ezJSONParser, the parser accepts C and C++ style comments. Any JSON value may be at the top level of the document.
+class EZ_FOUNDATION_DLL ezJSONDocument
+{
+  struct TapeEntry;
+
+public:
+  enum class ValueType : ezUInt8
+  {
+    Invalid, ///< Returned for values that don't exist, e.g. when a member wasn't found.
+    Null,
+    Bool,
+    Number,
+    String,
+    Object,
+    Array,
+  };
+
+  /// \brief A lightweight reference to one value in the document. Only valid as long as the document isn't modified or destroyed.
+  class EZ_FOUNDATION_DLL Value
+  {
+  public:
+    Value() = default;
+
+    ValueType GetType() const;
+
+    bool IsValid() const { return GetType() != ValueType::Invalid; }
+    bool IsNull() const { return GetType() == ValueType::Null; }
+    bool IsBool() const { return GetType() == ValueType::Bool; }
+    bool IsNumber() const { return GetType() == ValueType::Number; }
+    bool IsString() const { return GetType() == ValueType::String; }
+    bool IsObject() const { return GetType() == ValueType::Object; }
+    bool IsArray() const { return GetType() == ValueType::Array; }
+
+    /// \brief Returns the value of a bool, or the fallback value for any other type.
+    bool GetBool(bool bFallback = false) const;
+
+    /// \brief Converts a number to double. Returns the fallback value for any other type.
+    double GetDouble(double fFallback = 0.0) const;
+
+    /// \brief Converts a number to an integer. Numbers with a fractional part or an exponent are converted via double.
+    ///
+    /// Numbers outside of the int64 range are clamped to the smallest or largest int64 value.
+    ezInt64 GetInt64(ezInt64 iFallback = 0) const;
+
+    /// \brief Returns whether a number is written without a fractional part and exponent.
+    bool IsInteger() const;
+
+    /// \brief Returns the text of a string or number as it is in the document, i.e. escape sequences in strings are not decoded.
+    ///
+    /// This doesn't allocate anything. If HasEscapeSequences() returns false, this is the final string.
+    ezStringView GetRawString() const;
+
+    /// \brief Returns whether a string contains escape sequences, which GetString() has to decode.
+    bool HasEscapeSequences() const;
+
+    /// \brief Decodes a string, including all escape sequences, and returns it as UTF-8.
+    ezStringView GetString(ezStringBuilder& out_sStorage) const;
+
+    /// \brief Returns the number of elements of an array or the number of members of an object, otherwise 0.
+    ezUInt32 GetCount() const;
+
+    /// \brief Returns the first element of an array or the first member value of an object, or an invalid value if it is empty.
+    Value GetFirstChild() const;
+
+    /// \brief Returns the value that follows this one in the same array or object, or an invalid value if this is the last one.
+    ///
+    /// For members of objects, this returns the next member value, skipping the member name.
+    Value GetNextSibling() const;
+
+    /// \brief Returns the name of a member of an object, if this value is one.
+    Value GetMemberName() const;
+
+    /// \brief Returns the element with the given index. This is linear in the index, use GetFirstChild() and GetNextSibling() to iterate.
+    Value GetElement(ezUInt32 uiIndex) const;
+
+    /// \brief Searches an object for a member with the given name. This is linear in the number of members.
+    ///
+    /// Member names with escape sequences are compared in their decoded form.
+    Value FindMember(ezStringView sName) const;
+
+    /// \brief Converts this value and everything in it to the same representation that ezJSONReader uses.
+    ///
+    /// Numbers are converted to double, objects to ezVariantDictionary and arrays to ezVariantArray.
+    ezVariant ConvertToVariant() const;
+
+  private:
+    friend class ezJSONDocument;
+
+    Value(const ezJSONDocument* pDocument, ezUInt32 uiIndex, ezUInt32 uiParentEnd)
+      : m_pDocument(pDocument)
+      , m_uiIndex(uiIndex)
+      , m_uiParentEnd(uiParentEnd)
+    {
+    }
+
+    const TapeEntry* GetEntry() const;
+
+    const ezJSONDocument* m_pDocument = nullptr;
+    ezUInt32 m_uiIndex = ezInvalidIndex;
+    ezUInt32 m_uiParentEnd = 0; ///< The end of the content of the object or array that contains this value.
+  };
+
+  ezJSONDocument();
+  ~ezJSONDocument();
+
+  /// \brief Parses the text without copying it. The text must stay valid for as long as the document is used.
+  ///
+  /// Returns EZ_FAILURE and logs an error with the line and column, if the text isn't valid JSON.
+  ezResult Parse(ezStringView sText, ezLogInterface* pLog = nullptr);
+
+  /// \brief Reads the whole stream into an internal buffer and parses that.
+  ezResult Parse(ezStreamReader& inout_stream, ezLogInterface* pLog = nullptr);
+
+  /// \brief Removes all values and frees the internal buffer.
+  void Clear();
+
+  /// \brief Returns the top level value of the document. Invalid, if nothing was parsed successfully.
+  Value GetRoot() const;
+
+  /// \brief Returns the number of values (including member names) in the document.
+  ezUInt32 GetNumValues() const { return m_Tape.GetCount(); }
+
+private:
+  /// One value in the document. Containers are followed by their content, members of objects are stored as a name string followed by the value.
+  struct TapeEntry
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ValueType m_Type;
+    ezUInt8 m_uiFlags;
+
+    /// Strings and numbers: the length of the text. Objects and arrays: the number of members or elements.
+    ezUInt32 m_uiCount;
+
+    /// Strings and numbers: the offset of the text. Objects and arrays: the index of the first entry after the content. Bools: the value.
+    ezUInt64 m_uiPayload;
+  };
+
+  enum TapeFlags : ezUInt8
+  {
+    HasEscapes = EZ_BIT(0),   ///< The string contains escape sequences.
+    IsFloat = EZ_BIT(1),      ///< The number has a fractional part or an exponent.
+    IsMemberName = EZ_BIT(2), ///< The string is the name of an object member, the member value follows it.
+  };
+
+  class Parser;
+
+  ezResult ParseText(ezLogInterface* pLog);
+  ezStringView GetText(const TapeEntry& entry) const;
+
+  ezStringView m_sText;
+  ezDynamicArray<char> m_OwnedText;
+  ezDynamicArray<TapeEntry> m_Tape;
+};
@@ -6,6 +6,7 @@
 #include <Foundation/Threading/ThreadUtils.h>
 
 EZ_MAKE_MEMBERFUNCTION_CHECKER(Reallocate, ezHasReallocate);
+EZ_MAKE_MEMBERFUNCTION_CHECKER(AddStats, ezHasAddStats);
 
 #include <Foundation/Memory/Implementation/Allocator_inl.h>
 
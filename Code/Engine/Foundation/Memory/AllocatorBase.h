@@ -32,6 +32,9 @@ public:
 
     ezUInt64 m_uiPerFrameAllocationSize = 0; ///< allocation size in bytes in this frame
     ezTime m_PerFrameAllocationTime;         ///< time spend on allocations in this frame
+
+    ezUInt64 m_uiReservedSize = 0; ///< memory in bytes that the allocator reserved from the system, only set by allocators that manage their own pages
+    ezUInt64 m_uiCachedSize = 0;   ///< part of the reserved memory that is currently unused but kept for reuse
   };
 
   ezAllocatorBase();
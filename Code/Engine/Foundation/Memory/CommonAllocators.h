@@ -9,6 +9,7 @@
 #include <Foundation/Memory/Policies/GuardedAllocation.h>
 #include <Foundation/Memory/Policies/HeapAllocation.h>
 #include <Foundation/Memory/Policies/ProxyAllocation.h>
+#include <Foundation/Memory/Policies/ThreadCachingAllocation.h>
 
 
 /// \brief Default heap allocator
@@ -20,5 +21,8 @@ typedef ezAllocator<ezMemoryPolicies::ezHeapAllocation> ezHeapAllocator;
 /// \brief Guarded allocator
 typedef ezAllocator<ezMemoryPolicies::ezGuardedAllocation> ezGuardedAllocator;
 
+/// \brief Heap allocator with thread local caches, optimized for small allocations from many threads
+typedef ezAllocator<ezMemoryPolicies::ezThreadCachingAllocation> ezThreadCachingHeapAllocator;
+
 /// \brief Proxy allocator
 typedef ezAllocator<ezMemoryPolicies::ezProxyAllocation> ezProxyAllocator;
@@ -17,6 +17,9 @@ namespace ezInternal
     ezAllocatorBase* GetParent() const;
 
   protected:
+    void AddPolicyStats(Stats& inout_Stats, ezTraitInt<1>) const;
+    void AddPolicyStats(Stats& inout_Stats, ezTraitInt<0>) const;
+
     AllocationPolicy m_allocator;
 
     ezAllocatorId m_Id;
@@ -73,18 +76,24 @@ void* ezInternal::ezAllocatorImpl<A, TrackingFlags>::Allocate(size_t uiSize, siz
 
   EZ_ASSERT_DEBUG(ezMath::IsPowerOf2((ezUInt32)uiAlign), "Alignment must be power of two");
 
-  ezTime fAllocationTime = ezTime::Now();
+  if ((TrackingFlags & ezMemoryTrackingFlags::EnableAllocationTracking) == 0)
+  {
+    void* ptr = m_allocator.Allocate(uiSize, uiAlign);
+    EZ_ASSERT_DEV(ptr != nullptr, "Could not allocate {0} bytes. Out of memory?", uiSize);
+
+    return ptr;
+  }
+
+  const bool bMeasureTime = ezMemoryTracker::IsMeasuringAllocationTime();
+  const ezTime fAllocationTime = bMeasureTime ? ezTime::Now() : ezTime::Zero();
 
   void* ptr = m_allocator.Allocate(uiSize, uiAlign);
   EZ_ASSERT_DEV(ptr != nullptr, "Could not allocate {0} bytes. Out of memory?", uiSize);
 
-  if ((TrackingFlags & ezMemoryTrackingFlags::EnableAllocationTracking) != 0)
-  {
-    ezBitflags<ezMemoryTrackingFlags> flags;
-    flags.SetValue(TrackingFlags);
+  ezBitflags<ezMemoryTrackingFlags> flags;
+  flags.SetValue(TrackingFlags);
 
-    ezMemoryTracker::AddAllocation(this->m_Id, flags, ptr, uiSize, uiAlign, ezTime::Now() - fAllocationTime);
-  }
+  ezMemoryTracker::AddAllocation(this->m_Id, flags, ptr, uiSize, uiAlign, bMeasureTime ? ezTime::Now() - fAllocationTime : ezTime::Zero());
 
   return ptr;
 }
@@ -120,12 +129,27 @@ ezAllocatorId ezInternal::ezAllocatorImpl<A, TrackingFlags>::GetId() const
 template <typename A, ezUInt32 TrackingFlags>
 ezAllocatorBase::Stats ezInternal::ezAllocatorImpl<A, TrackingFlags>::GetStats() const
 {
+  Stats stats;
+
   if ((TrackingFlags & ezMemoryTrackingFlags::RegisterAllocator) != 0)
   {
-    return ezMemoryTracker::GetAllocatorStats(this->m_Id);
+    stats = ezMemoryTracker::GetAllocatorStats(this->m_Id);
   }
 
-  return Stats();
+  AddPolicyStats(stats, ezTraitInt<ezHasAddStats<A, void (A::*)(ezAllocatorBase::Stats&) const>::value>());
+
+  return stats;
+}
+
+template <typename A, ezUInt32 TrackingFlags>
+EZ_ALWAYS_INLINE void ezInternal::ezAllocatorImpl<A, TrackingFlags>::AddPolicyStats(Stats& inout_Stats, ezTraitInt<1>) const
+{
+  m_allocator.AddStats(inout_Stats);
+}
+
+template <typename A, ezUInt32 TrackingFlags>
+EZ_ALWAYS_INLINE void ezInternal::ezAllocatorImpl<A, TrackingFlags>::AddPolicyStats(Stats& inout_Stats, ezTraitInt<0>) const
+{
 }
 
 template <typename A, ezUInt32 TrackingFlags>
@@ -154,7 +178,8 @@ void* ezInternal::ezAllocatorMixinReallocate<A, TrackingFlags, true>::Reallocate
     ezMemoryTracker::RemoveAllocation(this->m_Id, ptr);
   }
 
-  ezTime fAllocationTime = ezTime::Now();
+  const bool bMeasureTime = (TrackingFlags & ezMemoryTrackingFlags::EnableAllocationTracking) != 0 && ezMemoryTracker::IsMeasuringAllocationTime();
+  const ezTime fAllocationTime = bMeasureTime ? ezTime::Now() : ezTime::Zero();
 
   void* pNewMem = this->m_allocator.Reallocate(ptr, uiCurrentSize, uiNewSize, uiAlign);
 
@@ -163,7 +188,7 @@ void* ezInternal::ezAllocatorMixinReallocate<A, TrackingFlags, true>::Reallocate
     ezBitflags<ezMemoryTrackingFlags> flags;
     flags.SetValue(TrackingFlags);
 
-    ezMemoryTracker::AddAllocation(this->m_Id, flags, pNewMem, uiNewSize, uiAlign, ezTime::Now() - fAllocationTime);
+    ezMemoryTracker::AddAllocation(this->m_Id, flags, pNewMem, uiNewSize, uiAlign, bMeasureTime ? ezTime::Now() - fAllocationTime : ezTime::Zero());
   }
   return pNewMem;
 }
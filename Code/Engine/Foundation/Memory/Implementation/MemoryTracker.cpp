@@ -7,6 +7,7 @@
 #include <Foundation/Memory/Policies/HeapAllocation.h>
 #include <Foundation/Strings/String.h>
 #include <Foundation/System/StackTracer.h>
+#include <Foundation/Threading/AtomicInteger.h>
 #include <Foundation/Threading/Lock.h>
 #include <Foundation/Threading/Mutex.h>
 
@@ -37,10 +38,58 @@ namespace
     ezAllocatorId m_ParentId;
 
     ezAllocatorBase::Stats m_Stats;
+  };
+
+  struct AllocationEntry
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezMemoryTracker::AllocationInfo m_Info;
+    ezAllocatorId m_AllocatorId;
+  };
+
+  /// Stats of one allocator that were collected by one shard. Everything except the number of live entries is added to
+  /// AllocatorData::m_Stats and reset whenever the stats are queried.
+  struct ShardStats
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezUInt64 m_uiNumAllocations = 0;
+    ezUInt64 m_uiNumDeallocations = 0;
+    ezInt64 m_iAllocationSize = 0;
+    ezUInt64 m_uiPerFrameAllocationSize = 0;
+    ezTime m_PerFrameAllocationTime;
 
-    ezHashTable<const void*, ezMemoryTracker::AllocationInfo, ezHashHelper<const void*>, TrackerDataAllocatorWrapper> m_Allocations;
+    ezUInt64 m_uiNumLiveEntries = 0;
   };
 
+  /// Allocations are distributed over the shards by their address, so alloc and free of the same memory always go to the same shard.
+  struct EZ_ALIGN(AllocationShard, 64)
+  {
+    EZ_ALWAYS_INLINE void Lock() { m_Mutex.Lock(); }
+    EZ_ALWAYS_INLINE void Unlock() { m_Mutex.Unlock(); }
+
+    EZ_FORCE_INLINE ShardStats& GetStats(ezAllocatorId allocatorId)
+    {
+      const ezUInt32 uiIndex = allocatorId.m_InstanceIndex;
+      if (uiIndex >= m_Stats.GetCount())
+      {
+        m_Stats.SetCount(uiIndex + 1);
+      }
+
+      return m_Stats[uiIndex];
+    }
+
+    ezMutex m_Mutex;
+
+    ezHashTable<const void*, AllocationEntry, ezHashHelper<const void*>, TrackerDataAllocatorWrapper> m_Allocations;
+    ezDynamicArray<ShardStats, TrackerDataAllocatorWrapper> m_Stats; ///< indexed by the instance index of the allocator id
+  };
+
+  static constexpr ezUInt32 s_uiNumAllocationShards = 32;
+
+  /// The lock of the tracker data protects the allocator table and has to be acquired before any shard lock.
+  /// Adding and removing allocations only locks the corresponding shard.
   struct TrackerData
   {
     EZ_ALWAYS_INLINE void Lock() { m_Mutex.Lock(); }
@@ -52,12 +101,21 @@ namespace
     AllocatorTable m_AllocatorData;
 
     ezAllocatorId m_StaticAllocatorId;
+
+    AllocationShard m_Shards[s_uiNumAllocationShards];
   };
 
   static TrackerData* s_pTrackerData;
   static bool s_bIsInitialized = false;
   static bool s_bIsInitializing = false;
 
+  // The tracking settings are read by every allocation on every thread, so they are stored as individual atomic values.
+  // They are constant initialized, so they are valid even for allocations made by other static initializers.
+  static volatile ezInt32 s_iSampleInterval = ezMemoryTracker::TrackingSettings().m_uiSampleInterval;
+  static volatile ezInt64 s_iAlwaysSampledSize = ezMemoryTracker::TrackingSettings().m_uiAlwaysSampledSize;
+  static volatile ezInt32 s_iMeasureAllocationTime = ezMemoryTracker::TrackingSettings().m_bMeasureAllocationTime ? 1 : 0;
+  thread_local ezUInt32 tl_uiAllocationSampleCounter = 0;
+
   static void Initialize()
   {
     if (s_bIsInitialized)
@@ -84,6 +142,113 @@ namespace
     s_bIsInitializing = false;
   }
 
+  EZ_FORCE_INLINE AllocationShard& GetShard(const void* ptr)
+  {
+    // the lowest bits are the same for most allocations due to alignment, mix in higher bits so that consecutive allocations end up in different shards
+    size_t uiAddress = reinterpret_cast<size_t>(ptr) >> 4;
+    uiAddress ^= uiAddress >> 9;
+    return s_pTrackerData->m_Shards[uiAddress % s_uiNumAllocationShards];
+  }
+
+  EZ_FORCE_INLINE bool IsSampled(size_t uiSize)
+  {
+    const ezUInt32 uiSampleInterval = static_cast<ezUInt32>(ezAtomicUtils::Read(s_iSampleInterval));
+    if (uiSampleInterval <= 1 || uiSize >= static_cast<size_t>(ezAtomicUtils::Read(s_iAlwaysSampledSize)))
+      return true;
+
+    if (++tl_uiAllocationSampleCounter >= uiSampleInterval)
+    {
+      tl_uiAllocationSampleCounter = 0;
+      return true;
+    }
+
+    return false;
+  }
+
+  static void MoveShardStats(ShardStats& shardStats, AllocatorData& data)
+  {
+    data.m_Stats.m_uiNumAllocations += shardStats.m_uiNumAllocations;
+    data.m_Stats.m_uiNumDeallocations += shardStats.m_uiNumDeallocations;
+    data.m_Stats.m_uiAllocationSize += shardStats.m_iAllocationSize;
+    data.m_Stats.m_uiPerFrameAllocationSize += shardStats.m_uiPerFrameAllocationSize;
+    data.m_Stats.m_PerFrameAllocationTime += shardStats.m_PerFrameAllocationTime;
+
+    const ezUInt64 uiNumLiveEntries = shardStats.m_uiNumLiveEntries;
+    shardStats = ShardStats();
+    shardStats.m_uiNumLiveEntries = uiNumLiveEntries;
+  }
+
+  /// Adds the stats collected by the shards to the allocator data. The tracker data must be locked.
+  static void CollectShardStats(ezAllocatorId allocatorId, AllocatorData& data)
+  {
+    const ezUInt32 uiIndex = allocatorId.m_InstanceIndex;
+
+    for (AllocationShard& shard : s_pTrackerData->m_Shards)
+    {
+      EZ_LOCK(shard);
+
+      if (uiIndex < shard.m_Stats.GetCount())
+      {
+        MoveShardStats(shard.m_Stats[uiIndex], data);
+      }
+    }
+  }
+
+  static void CollectAllShardStats()
+  {
+    for (AllocationShard& shard : s_pTrackerData->m_Shards)
+    {
+      EZ_LOCK(shard);
+
+      for (auto it = s_pTrackerData->m_AllocatorData.GetIterator(); it.IsValid(); ++it)
+      {
+        const ezUInt32 uiIndex = it.Id().m_InstanceIndex;
+        if (uiIndex < shard.m_Stats.GetCount())
+        {
+          MoveShardStats(shard.m_Stats[uiIndex], it.Value());
+        }
+      }
+    }
+  }
+
+  /// Removes all allocations of the given allocator from the shards and calls func for each of them. The tracker data must be locked.
+  template <typename Func>
+  static void RemoveShardAllocations(ezAllocatorId allocatorId, Func func)
+  {
+    const ezUInt32 uiIndex = allocatorId.m_InstanceIndex;
+
+    for (AllocationShard& shard : s_pTrackerData->m_Shards)
+    {
+      EZ_LOCK(shard);
+
+      if (uiIndex >= shard.m_Stats.GetCount() || shard.m_Stats[uiIndex].m_uiNumLiveEntries == 0)
+        continue;
+
+      ShardStats& shardStats = shard.m_Stats[uiIndex];
+      for (auto it = shard.m_Allocations.GetIterator(); it.IsValid();)
+      {
+        if (it.Value().m_AllocatorId == allocatorId)
+        {
+          const ezMemoryTracker::AllocationInfo& info = it.Value().m_Info;
+          func(info);
+
+          shardStats.m_uiNumDeallocations++;
+          shardStats.m_iAllocationSize -= info.m_uiSize;
+          shardStats.m_uiNumLiveEntries--;
+
+          ezArrayPtr<void*> stackTrace = info.GetStackTrace();
+          EZ_DELETE_ARRAY(s_pTrackerDataAllocator, stackTrace);
+
+          it = shard.m_Allocations.Remove(it);
+        }
+        else
+        {
+          ++it;
+        }
+      }
+    }
+  }
+
   static void DumpLeak(const ezMemoryTracker::AllocationInfo& info, const char* szAllocatorName)
   {
     char szBuffer[512];
@@ -171,15 +336,27 @@ void ezMemoryTracker::DeregisterAllocator(ezAllocatorId allocatorId)
 
   const AllocatorData& data = s_pTrackerData->m_AllocatorData[allocatorId];
 
-  ezUInt32 uiLiveAllocations = data.m_Allocations.GetCount();
+  ezUInt32 uiLiveAllocations = 0;
+  RemoveShardAllocations(allocatorId, [&](const AllocationInfo& info) {
+    DumpLeak(info, data.m_sName.GetData());
+    ++uiLiveAllocations;
+  });
+
   if (uiLiveAllocations != 0)
   {
-    for (auto it = data.m_Allocations.GetIterator(); it.IsValid(); ++it)
+    EZ_REPORT_FAILURE("Allocator '{0}' leaked {1} allocation(s)", data.m_sName.GetData(), uiLiveAllocations);
+  }
+
+  // the instance index might be re-used by the next allocator, so the shards must not keep any stats of this one
+  const ezUInt32 uiIndex = allocatorId.m_InstanceIndex;
+  for (AllocationShard& shard : s_pTrackerData->m_Shards)
+  {
+    EZ_LOCK(shard);
+
+    if (uiIndex < shard.m_Stats.GetCount())
     {
-      DumpLeak(it.Value(), data.m_sName.GetData());
+      shard.m_Stats[uiIndex] = ShardStats();
     }
-
-    EZ_REPORT_FAILURE("Allocator '{0}' leaked {1} allocation(s)", data.m_sName.GetData(), uiLiveAllocations);
   }
 
   s_pTrackerData->m_AllocatorData.Remove(allocatorId);
@@ -192,7 +369,7 @@ void ezMemoryTracker::AddAllocation(
   EZ_ASSERT_DEV(uiAlign < 0xFFFF, "Alignment too big");
 
   ezArrayPtr<void*> stackTrace;
-  if (flags.IsSet(ezMemoryTrackingFlags::EnableStackTrace))
+  if (flags.IsSet(ezMemoryTrackingFlags::EnableStackTrace) && IsSampled(uiSize))
   {
     void* pBuffer[64];
     ezArrayPtr<void*> tempTrace(pBuffer);
@@ -202,20 +379,23 @@ void ezMemoryTracker::AddAllocation(
     ezMemoryUtils::Copy(stackTrace.GetPtr(), pBuffer, uiNumTraces);
   }
 
-  {
-    EZ_LOCK(*s_pTrackerData);
+  AllocationShard& shard = GetShard(ptr);
 
-    AllocatorData& data = s_pTrackerData->m_AllocatorData[allocatorId];
-    data.m_Stats.m_uiNumAllocations++;
-    data.m_Stats.m_uiAllocationSize += uiSize;
-    data.m_Stats.m_uiPerFrameAllocationSize += uiSize;
-    data.m_Stats.m_PerFrameAllocationTime += allocationTime;
-
-    EZ_ASSERT_DEBUG(data.m_Flags == flags, "Given flags have to be identical to allocator flags");
-    auto pInfo = &data.m_Allocations[ptr];
-    pInfo->m_uiSize = uiSize;
-    pInfo->m_uiAlignment = (ezUInt16)uiAlign;
-    pInfo->SetStackTrace(stackTrace);
+  {
+    EZ_LOCK(shard);
+
+    ShardStats& stats = shard.GetStats(allocatorId);
+    stats.m_uiNumAllocations++;
+    stats.m_iAllocationSize += uiSize;
+    stats.m_uiPerFrameAllocationSize += uiSize;
+    stats.m_PerFrameAllocationTime += allocationTime;
+    stats.m_uiNumLiveEntries++;
+
+    auto pEntry = &shard.m_Allocations[ptr];
+    pEntry->m_AllocatorId = allocatorId;
+    pEntry->m_Info.m_uiSize = uiSize;
+    pEntry->m_Info.m_uiAlignment = (ezUInt16)uiAlign;
+    pEntry->m_Info.SetStackTrace(stackTrace);
   }
 }
 
@@ -224,18 +404,23 @@ void ezMemoryTracker::RemoveAllocation(ezAllocatorId allocatorId, const void* pt
 {
   ezArrayPtr<void*> stackTrace;
 
+  AllocationShard& shard = GetShard(ptr);
+
   {
-    EZ_LOCK(*s_pTrackerData);
+    EZ_LOCK(shard);
 
-    AllocatorData& data = s_pTrackerData->m_AllocatorData[allocatorId];
+    ShardStats& stats = shard.GetStats(allocatorId);
 
-    AllocationInfo info;
-    if (data.m_Allocations.Remove(ptr, &info))
+    AllocationEntry entry;
+    if (shard.m_Allocations.Remove(ptr, &entry))
     {
-      data.m_Stats.m_uiNumDeallocations++;
-      data.m_Stats.m_uiAllocationSize -= info.m_uiSize;
+      EZ_ASSERT_DEV(entry.m_AllocatorId == allocatorId, "Allocation '{0}' is freed by a different allocator than it was allocated with", ezArgP(ptr));
 
-      stackTrace = info.GetStackTrace();
+      stats.m_uiNumDeallocations++;
+      stats.m_iAllocationSize -= entry.m_Info.m_uiSize;
+      stats.m_uiNumLiveEntries--;
+
+      stackTrace = entry.m_Info.GetStackTrace();
     }
     else
     {
@@ -250,16 +435,8 @@ void ezMemoryTracker::RemoveAllocation(ezAllocatorId allocatorId, const void* pt
 void ezMemoryTracker::RemoveAllAllocations(ezAllocatorId allocatorId)
 {
   EZ_LOCK(*s_pTrackerData);
-  AllocatorData& data = s_pTrackerData->m_AllocatorData[allocatorId];
-  for (auto it = data.m_Allocations.GetIterator(); it.IsValid(); ++it)
-  {
-    auto& info = it.Value();
-    data.m_Stats.m_uiNumDeallocations++;
-    data.m_Stats.m_uiAllocationSize -= info.m_uiSize;
 
-    EZ_DELETE_ARRAY(s_pTrackerDataAllocator, info.GetStackTrace());
-  }
-  data.m_Allocations.Clear();
+  RemoveShardAllocations(allocatorId, [](const AllocationInfo& info) {});
 }
 
 // static
@@ -267,7 +444,11 @@ void ezMemoryTracker::SetAllocatorStats(ezAllocatorId allocatorId, const ezAlloc
 {
   EZ_LOCK(*s_pTrackerData);
 
-  s_pTrackerData->m_AllocatorData[allocatorId].m_Stats = stats;
+  AllocatorData& data = s_pTrackerData->m_AllocatorData[allocatorId];
+
+  // discard what the shards collected so far, the given stats replace everything
+  CollectShardStats(allocatorId, data);
+  data.m_Stats = stats;
 }
 
 // static
@@ -275,6 +456,8 @@ void ezMemoryTracker::ResetPerFrameAllocatorStats()
 {
   EZ_LOCK(*s_pTrackerData);
 
+  CollectAllShardStats();
+
   for (auto it = s_pTrackerData->m_AllocatorData.GetIterator(); it.IsValid(); ++it)
   {
     AllocatorData& data = it.Value();
@@ -296,7 +479,10 @@ const ezAllocatorBase::Stats& ezMemoryTracker::GetAllocatorStats(ezAllocatorId a
 {
   EZ_LOCK(*s_pTrackerData);
 
-  return s_pTrackerData->m_AllocatorData[allocatorId].m_Stats;
+  AllocatorData& data = s_pTrackerData->m_AllocatorData[allocatorId];
+  CollectShardStats(allocatorId, data);
+
+  return data.m_Stats;
 }
 
 // static
@@ -310,13 +496,16 @@ ezAllocatorId ezMemoryTracker::GetAllocatorParentId(ezAllocatorId allocatorId)
 // static
 const ezMemoryTracker::AllocationInfo& ezMemoryTracker::GetAllocationInfo(ezAllocatorId allocatorId, const void* ptr)
 {
-  EZ_LOCK(*s_pTrackerData);
+  AllocationShard& shard = GetShard(ptr);
 
-  const AllocatorData& data = s_pTrackerData->m_AllocatorData[allocatorId];
-  const AllocationInfo* info = nullptr;
-  if (data.m_Allocations.TryGetValue(ptr, info))
   {
-    return *info;
+    EZ_LOCK(shard);
+
+    const AllocationEntry* pEntry = nullptr;
+    if (shard.m_Allocations.TryGetValue(ptr, pEntry) && pEntry->m_AllocatorId == allocatorId)
+    {
+      return pEntry->m_Info;
+    }
   }
 
   static AllocationInfo invalidInfo;
@@ -325,13 +514,39 @@ const ezMemoryTracker::AllocationInfo& ezMemoryTracker::GetAllocationInfo(ezAllo
   return invalidInfo;
 }
 
+// static
+void ezMemoryTracker::SetTrackingSettings(const TrackingSettings& settings)
+{
+  EZ_ASSERT_DEV(settings.m_uiSampleInterval <= static_cast<ezUInt32>(ezMath::MaxValue<ezInt32>()), "Invalid sample interval");
+
+  ezAtomicUtils::Set(s_iSampleInterval, static_cast<ezInt32>(settings.m_uiSampleInterval));
+  ezAtomicUtils::Set(s_iAlwaysSampledSize, static_cast<ezInt64>(ezMath::Min<size_t>(settings.m_uiAlwaysSampledSize, ezMath::MaxValue<ezInt64>())));
+  ezAtomicUtils::Set(s_iMeasureAllocationTime, settings.m_bMeasureAllocationTime ? 1 : 0);
+}
+
+// static
+ezMemoryTracker::TrackingSettings ezMemoryTracker::GetTrackingSettings()
+{
+  TrackingSettings settings;
+  settings.m_uiSampleInterval = static_cast<ezUInt32>(ezAtomicUtils::Read(s_iSampleInterval));
+  settings.m_uiAlwaysSampledSize = static_cast<size_t>(ezAtomicUtils::Read(s_iAlwaysSampledSize));
+  settings.m_bMeasureAllocationTime = ezAtomicUtils::Read(s_iMeasureAllocationTime) != 0;
+  return settings;
+}
+
+// static
+bool ezMemoryTracker::IsMeasuringAllocationTime()
+{
+  return ezAtomicUtils::Read(s_iMeasureAllocationTime) != 0;
+}
+
 
 struct LeakInfo
 {
   EZ_DECLARE_POD_TYPE();
 
   ezAllocatorId m_AllocatorId;
-  size_t m_uiSize = 0;
+  ezMemoryTracker::AllocationInfo m_Info;
   const void* m_pParentLeak = nullptr;
 
   EZ_ALWAYS_INLINE bool IsRootLeak() const { return m_pParentLeak == nullptr && m_AllocatorId != s_pTrackerData->m_StaticAllocatorId; }
@@ -348,17 +563,18 @@ void ezMemoryTracker::DumpMemoryLeaks()
   leakTable.Clear();
 
   // first collect all leaks
-  for (auto it = s_pTrackerData->m_AllocatorData.GetIterator(); it.IsValid(); ++it)
+  for (AllocationShard& shard : s_pTrackerData->m_Shards)
   {
-    const AllocatorData& data = it.Value();
-    for (auto it2 = data.m_Allocations.GetIterator(); it2.IsValid(); ++it2)
+    EZ_LOCK(shard);
+
+    for (auto it = shard.m_Allocations.GetIterator(); it.IsValid(); ++it)
     {
       LeakInfo leak;
-      leak.m_AllocatorId = it.Id();
-      leak.m_uiSize = it2.Value().m_uiSize;
+      leak.m_AllocatorId = it.Value().m_AllocatorId;
+      leak.m_Info = it.Value().m_Info;
       leak.m_pParentLeak = nullptr;
 
-      leakTable.Insert(it2.Key(), leak);
+      leakTable.Insert(it.Key(), leak);
     }
   }
 
@@ -369,7 +585,7 @@ void ezMemoryTracker::DumpMemoryLeaks()
     const LeakInfo& leak = it.Value();
 
     const void* curPtr = ptr;
-    const void* endPtr = ezMemoryUtils::AddByteOffset(ptr, leak.m_uiSize);
+    const void* endPtr = ezMemoryUtils::AddByteOffset(ptr, leak.m_Info.m_uiSize);
 
     while (curPtr < endPtr)
     {
@@ -390,7 +606,6 @@ void ezMemoryTracker::DumpMemoryLeaks()
 
   for (auto it = leakTable.GetIterator(); it.IsValid(); ++it)
   {
-    const void* ptr = it.Key();
     const LeakInfo& leak = it.Value();
 
     if (leak.IsRootLeak())
@@ -402,11 +617,7 @@ void ezMemoryTracker::DumpMemoryLeaks()
                      "\n--------------------------------------------------------------------\n\n");
       }
 
-      const AllocatorData& data = s_pTrackerData->m_AllocatorData[leak.m_AllocatorId];
-      ezMemoryTracker::AllocationInfo info;
-      data.m_Allocations.TryGetValue(ptr, info);
-
-      DumpLeak(info, data.m_sName.GetData());
+      DumpLeak(leak.m_Info, s_pTrackerData->m_AllocatorData[leak.m_AllocatorId].m_sName.GetData());
 
       ++uiNumLeaks;
     }
@@ -426,6 +637,11 @@ void ezMemoryTracker::DumpMemoryLeaks()
 // static
 ezMemoryTracker::Iterator ezMemoryTracker::GetIterator()
 {
+  {
+    EZ_LOCK(*s_pTrackerData);
+    CollectAllShardStats();
+  }
+
   auto pInnerIt = EZ_NEW(s_pTrackerDataAllocator, TrackerData::AllocatorTable::Iterator, s_pTrackerData->m_AllocatorData.GetIterator());
   return Iterator(pInnerIt);
 }
@@ -2,27 +2,35 @@
 #include <Foundation/Time/Time.h>
 
 // static
-void* ezPageAllocator::AllocatePage(size_t uiSize)
+void* ezPageAllocator::AllocatePage(size_t uiSize, size_t uiAlign, bool bTracked)
 {
+  EZ_ASSERT_DEBUG(uiAlign <= 64 * 1024, "Page alignment is limited to 64 KB");
+
   ezTime fAllocationTime = ezTime::Now();
 
   void* ptr = nullptr;
-  size_t uiAlign = ezSystemInformation::Get().GetMemoryPageSize();
+  uiAlign = ezMath::Max<size_t>(uiAlign, ezSystemInformation::Get().GetMemoryPageSize());
   const int res = posix_memalign(&ptr, uiAlign, uiSize);
   EZ_ASSERT_DEBUG(res == 0, "Failed to align pointer");
   EZ_IGNORE_UNUSED(res);
 
   EZ_CHECK_ALIGNMENT(ptr, uiAlign);
 
-  ezMemoryTracker::AddAllocation(GetPageAllocatorId(), ezMemoryTrackingFlags::Default, ptr, uiSize, uiAlign, ezTime::Now() - fAllocationTime);
+  if (bTracked)
+  {
+    ezMemoryTracker::AddAllocation(GetPageAllocatorId(), ezMemoryTrackingFlags::Default, ptr, uiSize, uiAlign, ezTime::Now() - fAllocationTime);
+  }
 
   return ptr;
 }
 
 // static
-void ezPageAllocator::DeallocatePage(void* ptr)
+void ezPageAllocator::DeallocatePage(void* ptr, bool bTracked)
 {
-  ezMemoryTracker::RemoveAllocation(GetPageAllocatorId(), ptr);
+  if (bTracked)
+  {
+    ezMemoryTracker::RemoveAllocation(GetPageAllocatorId(), ptr);
+  }
 
   free(ptr);
 }
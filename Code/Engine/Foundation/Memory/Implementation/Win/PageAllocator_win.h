@@ -5,25 +5,34 @@ EZ_FOUNDATION_INTERNAL_HEADER
 #include <Foundation/Time/Time.h>
 
 // static
-void* ezPageAllocator::AllocatePage(size_t uiSize)
+void* ezPageAllocator::AllocatePage(size_t uiSize, size_t uiAlign, bool bTracked)
 {
+  // VirtualAlloc returns addresses that are aligned to the allocation granularity, which is 64 KB
+  EZ_ASSERT_DEBUG(uiAlign <= 64 * 1024, "Page alignment is limited to 64 KB");
+
   ezTime fAllocationTime = ezTime::Now();
 
   void* ptr = ::VirtualAlloc(nullptr, uiSize, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
   EZ_ASSERT_DEV(ptr != nullptr, "Could not allocate memory pages. Error Code '{0}'", ezArgErrorCode(::GetLastError()));
 
-  size_t uiAlign = ezSystemInformation::Get().GetMemoryPageSize();
+  uiAlign = ezMath::Max<size_t>(uiAlign, ezSystemInformation::Get().GetMemoryPageSize());
   EZ_CHECK_ALIGNMENT(ptr, uiAlign);
 
-  ezMemoryTracker::AddAllocation(GetPageAllocatorId(), ezMemoryTrackingFlags::Default, ptr, uiSize, uiAlign, ezTime::Now() - fAllocationTime);
+  if (bTracked)
+  {
+    ezMemoryTracker::AddAllocation(GetPageAllocatorId(), ezMemoryTrackingFlags::Default, ptr, uiSize, uiAlign, ezTime::Now() - fAllocationTime);
+  }
 
   return ptr;
 }
 
 // static
-void ezPageAllocator::DeallocatePage(void* ptr)
+void ezPageAllocator::DeallocatePage(void* ptr, bool bTracked)
 {
-  ezMemoryTracker::RemoveAllocation(GetPageAllocatorId(), ptr);
+  if (bTracked)
+  {
+    ezMemoryTracker::RemoveAllocation(GetPageAllocatorId(), ptr);
+  }
 
   EZ_VERIFY(::VirtualFree(ptr, 0, MEM_RELEASE), "Could not free memory pages. Error Code '{0}'", ezArgErrorCode(::GetLastError()));
 }
@@ -40,9 +40,31 @@ struct ezMemoryTrackingFlags
 #define EZ_STATIC_ALLOCATOR_NAME "Statics"
 
 /// \brief Memory tracker which keeps track of all allocations and constructions
+///
+/// Allocations are stored in several tables that are selected by the allocation address, each protected by its own lock,
+/// so threads that allocate concurrently rarely have to wait for each other. See TrackingSettings for how to reduce the
+/// tracking overhead further.
 class EZ_FOUNDATION_DLL ezMemoryTracker
 {
 public:
+  /// \brief Controls how much detail is recorded for allocators that use ezMemoryTrackingFlags::EnableAllocationTracking.
+  ///
+  /// Every allocation is always recorded with its size, so stats, leak detection and ezAllocatorBase::AllocatedSize() stay exact.
+  /// Sampling only affects allocators that use ezMemoryTrackingFlags::EnableStackTrace, where capturing the stack trace is by far
+  /// the most expensive part of tracking. Allocations that are not sampled have no stack trace, so leaks are reported without one.
+  /// This is meant for load tests of development builds, where the tracking overhead would otherwise distort the results.
+  struct TrackingSettings
+  {
+    /// \brief Only every n-th allocation of a thread records a stack trace. 1 records a stack trace for every allocation.
+    ezUInt32 m_uiSampleInterval = 1;
+
+    /// \brief Allocations of at least this many bytes always record a stack trace, independent of m_uiSampleInterval.
+    size_t m_uiAlwaysSampledSize = 64 * 1024;
+
+    /// \brief Whether the time spent in the allocation policy is measured for ezAllocatorBase::Stats::m_PerFrameAllocationTime.
+    bool m_bMeasureAllocationTime = true;
+  };
+
   struct AllocationInfo
   {
     EZ_DECLARE_POD_TYPE();
@@ -116,5 +138,14 @@ public:
 
   static void DumpMemoryLeaks();
 
+  /// \brief Changes the tracking settings. Can be called at any time from any thread.
+  ///
+  /// Each setting is updated atomically, so allocations that happen concurrently may see a mix of the old and the new settings.
+  static void SetTrackingSettings(const TrackingSettings& settings);
+  static TrackingSettings GetTrackingSettings();
+
+  /// \brief Same as GetTrackingSettings().m_bMeasureAllocationTime, but cheaper. Called by the allocators for every allocation.
+  static bool IsMeasuringAllocationTime();
+
   static Iterator GetIterator();
 };
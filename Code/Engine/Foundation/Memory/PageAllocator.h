@@ -6,8 +6,14 @@
 class EZ_FOUNDATION_DLL ezPageAllocator
 {
 public:
-  static void* AllocatePage(size_t uiSize);
-  static void DeallocatePage(void* ptr);
+  /// \brief Allocates the given number of bytes. The memory is aligned to at least the memory page size.
+  ///
+  /// A larger alignment of up to 64 KB can be requested with \a uiAlign.
+  /// Pages that are allocated with \a bTracked set to false are not recorded by the memory tracker. This is meant for allocators that
+  /// track the allocations they hand out themselves, so that those don't show up a second time as 'Page' allocations.
+  /// They have to be deallocated with the same value for \a bTracked.
+  static void* AllocatePage(size_t uiSize, size_t uiAlign = 0, bool bTracked = true);
+  static void DeallocatePage(void* ptr, bool bTracked = true);
 
   static ezAllocatorId GetId();
 };
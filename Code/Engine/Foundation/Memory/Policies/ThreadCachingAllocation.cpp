@@ -0,0 +1,569 @@
+#include <Foundation/FoundationPCH.h>
+
+#include <Foundation/Memory/PageAllocator.h>
+#include <Foundation/Memory/Policies/ThreadCachingAllocation.h>
+#include <Foundation/System/SystemInformation.h>
+#include <Foundation/Threading/AtomicInteger.h>
+#include <Foundation/Threading/Lock.h>
+#include <Foundation/Threading/Mutex.h>
+
+namespace
+{
+  constexpr size_t s_uiSpanSize = 64 * 1024;
+  constexpr size_t s_uiSpanHeaderSize = 64;
+  constexpr size_t s_uiMinAlignment = 16;
+  constexpr size_t s_uiMaxSmallAlignment = 64;
+  constexpr size_t s_uiMaxSmallSize = 8 * 1024;
+  constexpr ezUInt32 s_uiNumSizeClasses = 32;
+  constexpr ezUInt32 s_uiMaxEmptySpans = 16;
+
+  // one bit per 64 KB of address space, split into a root array and leaves of 64K bits (8 KB) each
+  constexpr ezUInt32 s_uiAddressBits = sizeof(void*) == 8 ? 48 : 32;
+  constexpr ezUInt32 s_uiSpanBits = 16;
+  constexpr ezUInt32 s_uiPageMapLeafBits = 16;
+  constexpr ezUInt32 s_uiPageMapRootSize = 1u << (s_uiAddressBits - s_uiSpanBits - s_uiPageMapLeafBits);
+  constexpr ezUInt32 s_uiPageMapLeafSize = (1u << s_uiPageMapLeafBits) / 32;
+
+  static_assert((size_t(1) << s_uiSpanBits) == s_uiSpanSize, "Span size and span bits don't match");
+
+  struct FreeBlock
+  {
+    FreeBlock* m_pNext;
+  };
+
+  /// Located at the start of every span, so it can be found by masking the pointer.
+  struct SpanHeader
+  {
+    ezUInt32 m_uiSizeClass;
+    ezUInt32 m_uiNumFreeBlocks; ///< blocks in the free list plus blocks that have not been carved yet
+    ezUInt32 m_uiNumCarvedBlocks;
+    FreeBlock* m_pFreeList;
+    SpanHeader* m_pPrev;
+    SpanHeader* m_pNext;
+  };
+
+  static_assert(sizeof(SpanHeader) <= s_uiSpanHeaderSize, "Span header is too large");
+
+  /// Located directly in front of the pointer of every large allocation.
+  struct LargeHeader
+  {
+    void* m_pPages;
+    size_t m_uiAllocationSize;
+  };
+
+  static_assert(sizeof(LargeHeader) <= s_uiMinAlignment, "Large allocation header doesn't fit into the minimum alignment");
+
+  // 16 byte steps up to 128 bytes, then 4 size classes per power of two
+  constexpr ezUInt32 GetClassSize(ezUInt32 uiSizeClass)
+  {
+    return uiSizeClass < 8 ? (uiSizeClass + 1) * 16 : (1u << (7 + (uiSizeClass - 8) / 4)) + (((uiSizeClass - 8) % 4 + 1) << (5 + (uiSizeClass - 8) / 4));
+  }
+
+  static_assert(GetClassSize(s_uiNumSizeClasses - 1) == s_uiMaxSmallSize, "Size classes don't match the max small size");
+
+  EZ_ALWAYS_INLINE ezUInt32 GetSizeClass(size_t uiSize)
+  {
+    if (uiSize <= 128)
+      return (static_cast<ezUInt32>(uiSize) + 15) / 16 - 1;
+
+    const ezUInt32 uiValue = static_cast<ezUInt32>(uiSize) - 1;
+    const ezUInt32 uiHighBit = ezMath::FirstBitHigh(uiValue);
+    return 8 + (uiHighBit - 7) * 4 + ((uiValue >> (uiHighBit - 2)) & 3);
+  }
+
+  EZ_ALWAYS_INLINE ezUInt32 GetNumBlocksPerSpan(ezUInt32 uiSizeClass)
+  {
+    return static_cast<ezUInt32>((s_uiSpanSize - s_uiSpanHeaderSize) / GetClassSize(uiSizeClass));
+  }
+
+  /// Number of blocks that are moved between a thread cache and the shared pool at once.
+  EZ_ALWAYS_INLINE ezUInt32 GetBatchSize(ezUInt32 uiSizeClass)
+  {
+    return ezMath::Clamp<ezUInt32>(16 * 1024 / GetClassSize(uiSizeClass), 4, 64);
+  }
+
+  EZ_ALWAYS_INLINE SpanHeader* GetSpan(void* ptr)
+  {
+    return reinterpret_cast<SpanHeader*>(reinterpret_cast<size_t>(ptr) & ~(s_uiSpanSize - 1));
+  }
+
+  struct alignas(64) CentralSizeClass
+  {
+    ezMutex m_Mutex;
+    SpanHeader* m_pSpans = nullptr; ///< spans that have free blocks
+  };
+
+  struct SharedHeap
+  {
+    CentralSizeClass m_SizeClasses[s_uiNumSizeClasses];
+
+    ezMutex m_EmptySpansMutex;
+    SpanHeader* m_pEmptySpans = nullptr;
+    ezUInt32 m_uiNumEmptySpans = 0;
+
+    ezAtomicInteger64 m_iReservedSize;
+    ezAtomicInteger64 m_iCachedSize;
+    ezAtomicInteger32 m_iNumInstances;
+
+    /// Marks which 64 KB blocks of the address space are spans. Large allocations are only page aligned, so masking their pointer can
+    /// end up anywhere and this is the only way to tell them apart from small blocks without touching that memory.
+    /// Leaves are created on demand and never freed.
+    ezInt32* volatile m_PageMap[s_uiPageMapRootSize] = {};
+  };
+
+  SharedHeap& GetSharedHeap()
+  {
+    // never destroyed, since allocators using this policy might still be in use during static deinitialization
+    alignas(SharedHeap) static ezUInt8 s_HeapBuffer[sizeof(SharedHeap)];
+    static SharedHeap* s_pHeap = new (s_HeapBuffer) SharedHeap();
+    return *s_pHeap;
+  }
+
+  EZ_ALWAYS_INLINE size_t GetSpanIndex(const void* ptr)
+  {
+    const size_t uiSpanIndex = reinterpret_cast<size_t>(ptr) >> s_uiSpanBits;
+    EZ_ASSERT_DEBUG((uiSpanIndex >> s_uiPageMapLeafBits) < s_uiPageMapRootSize, "Address is outside of the supported address range");
+    return uiSpanIndex;
+  }
+
+  bool IsSpan(const SharedHeap& heap, const void* ptr)
+  {
+    const size_t uiSpanIndex = GetSpanIndex(ptr);
+
+    const ezInt32* pLeaf = heap.m_PageMap[uiSpanIndex >> s_uiPageMapLeafBits];
+    if (pLeaf == nullptr)
+      return false;
+
+    const ezUInt32 uiBit = static_cast<ezUInt32>(uiSpanIndex & ((1u << s_uiPageMapLeafBits) - 1));
+    return (ezAtomicUtils::Read(pLeaf[uiBit / 32]) & (1 << (uiBit % 32))) != 0;
+  }
+
+  void MarkSpan(SharedHeap& heap, const SpanHeader* pSpan, bool bIsSpan)
+  {
+    const size_t uiSpanIndex = GetSpanIndex(pSpan);
+
+    ezInt32* volatile& pLeaf = heap.m_PageMap[uiSpanIndex >> s_uiPageMapLeafBits];
+    if (pLeaf == nullptr)
+    {
+      ezInt32* pNewLeaf = static_cast<ezInt32*>(ezPageAllocator::AllocatePage(s_uiPageMapLeafSize * sizeof(ezInt32), 0, false));
+      ezMemoryUtils::ZeroFill(pNewLeaf, s_uiPageMapLeafSize);
+
+      if (!ezAtomicUtils::TestAndSet(reinterpret_cast<void** volatile>(const_cast<ezInt32**>(&pLeaf)), nullptr, pNewLeaf))
+      {
+        // another thread created the leaf in the meantime
+        ezPageAllocator::DeallocatePage(pNewLeaf, false);
+      }
+    }
+
+    const ezUInt32 uiBit = static_cast<ezUInt32>(uiSpanIndex & ((1u << s_uiPageMapLeafBits) - 1));
+    if (bIsSpan)
+    {
+      ezAtomicUtils::Or(pLeaf[uiBit / 32], 1 << (uiBit % 32));
+    }
+    else
+    {
+      ezAtomicUtils::And(pLeaf[uiBit / 32], ~(1 << (uiBit % 32)));
+    }
+  }
+
+  void FreeSpanPages(SharedHeap& heap, SpanHeader* pSpan)
+  {
+    heap.m_iReservedSize.Subtract(s_uiSpanSize);
+
+    MarkSpan(heap, pSpan, false);
+    ezPageAllocator::DeallocatePage(pSpan, false);
+  }
+
+  void LinkSpan(CentralSizeClass& sizeClass, SpanHeader* pSpan)
+  {
+    pSpan->m_pPrev = nullptr;
+    pSpan->m_pNext = sizeClass.m_pSpans;
+    if (sizeClass.m_pSpans != nullptr)
+    {
+      sizeClass.m_pSpans->m_pPrev = pSpan;
+    }
+    sizeClass.m_pSpans = pSpan;
+  }
+
+  void UnlinkSpan(CentralSizeClass& sizeClass, SpanHeader* pSpan)
+  {
+    if (pSpan->m_pPrev != nullptr)
+      pSpan->m_pPrev->m_pNext = pSpan->m_pNext;
+    else
+      sizeClass.m_pSpans = pSpan->m_pNext;
+
+    if (pSpan->m_pNext != nullptr)
+      pSpan->m_pNext->m_pPrev = pSpan->m_pPrev;
+  }
+
+  SpanHeader* AcquireSpan(SharedHeap& heap, ezUInt32 uiSizeClass)
+  {
+    SpanHeader* pSpan = nullptr;
+    {
+      EZ_LOCK(heap.m_EmptySpansMutex);
+      if (heap.m_pEmptySpans != nullptr)
+      {
+        pSpan = heap.m_pEmptySpans;
+        heap.m_pEmptySpans = pSpan->m_pNext;
+        --heap.m_uiNumEmptySpans;
+      }
+    }
+
+    if (pSpan != nullptr)
+    {
+      heap.m_iCachedSize.Subtract(s_uiSpanSize - s_uiSpanHeaderSize);
+    }
+    else
+    {
+      // the blocks in the span are tracked by the allocators that hand them out, not as pages
+      pSpan = static_cast<SpanHeader*>(ezPageAllocator::AllocatePage(s_uiSpanSize, s_uiSpanSize, false));
+      heap.m_iReservedSize.Add(s_uiSpanSize);
+
+      MarkSpan(heap, pSpan, true);
+    }
+
+    pSpan->m_uiSizeClass = uiSizeClass;
+    pSpan->m_uiNumFreeBlocks = GetNumBlocksPerSpan(uiSizeClass);
+    pSpan->m_uiNumCarvedBlocks = 0;
+    pSpan->m_pFreeList = nullptr;
+    heap.m_iCachedSize.Add(pSpan->m_uiNumFreeBlocks * GetClassSize(uiSizeClass));
+
+    return pSpan;
+  }
+
+  void ReleaseSpan(SharedHeap& heap, SpanHeader* pSpan)
+  {
+    heap.m_iCachedSize.Subtract(GetNumBlocksPerSpan(pSpan->m_uiSizeClass) * GetClassSize(pSpan->m_uiSizeClass));
+
+    {
+      EZ_LOCK(heap.m_EmptySpansMutex);
+      if (heap.m_uiNumEmptySpans < s_uiMaxEmptySpans)
+      {
+        pSpan->m_pNext = heap.m_pEmptySpans;
+        heap.m_pEmptySpans = pSpan;
+        ++heap.m_uiNumEmptySpans;
+        heap.m_iCachedSize.Add(s_uiSpanSize - s_uiSpanHeaderSize);
+        return;
+      }
+    }
+
+    FreeSpanPages(heap, pSpan);
+  }
+
+  /// Moves up to uiMaxBlocks free blocks of the given size class from the shared pool into out_pBlocks. Returns the number of blocks.
+  ezUInt32 TakeBlocks(SharedHeap& heap, ezUInt32 uiSizeClass, ezUInt32 uiMaxBlocks, FreeBlock*& out_pBlocks)
+  {
+    CentralSizeClass& sizeClass = heap.m_SizeClasses[uiSizeClass];
+    const ezUInt32 uiClassSize = GetClassSize(uiSizeClass);
+
+    FreeBlock* pBlocks = nullptr;
+    ezUInt32 uiNumBlocks = 0;
+
+    {
+      EZ_LOCK(sizeClass.m_Mutex);
+
+      while (uiNumBlocks < uiMaxBlocks)
+      {
+        SpanHeader* pSpan = sizeClass.m_pSpans;
+        if (pSpan == nullptr)
+        {
+          pSpan = AcquireSpan(heap, uiSizeClass);
+          LinkSpan(sizeClass, pSpan);
+        }
+
+        while (uiNumBlocks < uiMaxBlocks && pSpan->m_uiNumFreeBlocks > 0)
+        {
+          FreeBlock* pBlock = pSpan->m_pFreeList;
+          if (pBlock != nullptr)
+          {
+            pSpan->m_pFreeList = pBlock->m_pNext;
+          }
+          else
+          {
+            pBlock = reinterpret_cast<FreeBlock*>(reinterpret_cast<ezUInt8*>(pSpan) + s_uiSpanHeaderSize + pSpan->m_uiNumCarvedBlocks * uiClassSize);
+            ++pSpan->m_uiNumCarvedBlocks;
+          }
+
+          --pSpan->m_uiNumFreeBlocks;
+
+          pBlock->m_pNext = pBlocks;
+          pBlocks = pBlock;
+          ++uiNumBlocks;
+        }
+
+        if (pSpan->m_uiNumFreeBlocks == 0)
+        {
+          UnlinkSpan(sizeClass, pSpan);
+        }
+      }
+    }
+
+    heap.m_iCachedSize.Subtract(uiNumBlocks * uiClassSize);
+
+    out_pBlocks = pBlocks;
+    return uiNumBlocks;
+  }
+
+  /// Returns a list of blocks of the given size class to the shared pool and releases spans that became empty.
+  void ReturnBlocks(SharedHeap& heap, ezUInt32 uiSizeClass, FreeBlock* pBlocks)
+  {
+    CentralSizeClass& sizeClass = heap.m_SizeClasses[uiSizeClass];
+    const ezUInt32 uiClassSize = GetClassSize(uiSizeClass);
+    const ezUInt32 uiNumBlocksPerSpan = GetNumBlocksPerSpan(uiSizeClass);
+
+    SpanHeader* pEmptySpans = nullptr;
+    ezUInt32 uiNumBlocks = 0;
+
+    {
+      EZ_LOCK(sizeClass.m_Mutex);
+
+      while (pBlocks != nullptr)
+      {
+        FreeBlock* pBlock = pBlocks;
+        pBlocks = pBlocks->m_pNext;
+        ++uiNumBlocks;
+
+        SpanHeader* pSpan = GetSpan(pBlock);
+        pBlock->m_pNext = pSpan->m_pFreeList;
+        pSpan->m_pFreeList = pBlock;
+
+        if (pSpan->m_uiNumFreeBlocks++ == 0)
+        {
+          LinkSpan(sizeClass, pSpan);
+        }
+
+        if (pSpan->m_uiNumFreeBlocks == uiNumBlocksPerSpan)
+        {
+          UnlinkSpan(sizeClass, pSpan);
+          pSpan->m_pNext = pEmptySpans;
+          pEmptySpans = pSpan;
+        }
+      }
+    }
+
+    heap.m_iCachedSize.Add(uiNumBlocks * uiClassSize);
+
+    while (pEmptySpans != nullptr)
+    {
+      SpanHeader* pSpan = pEmptySpans;
+      pEmptySpans = pEmptySpans->m_pNext;
+      ReleaseSpan(heap, pSpan);
+    }
+  }
+
+  struct ThreadCache
+  {
+    ~ThreadCache();
+
+    void Flush()
+    {
+      for (ezUInt32 i = 0; i < s_uiNumSizeClasses; ++i)
+      {
+        Bin& bin = m_Bins[i];
+        if (bin.m_pBlocks != nullptr)
+        {
+          ReturnBlocks(GetSharedHeap(), i, bin.m_pBlocks);
+          bin.m_pBlocks = nullptr;
+          bin.m_uiNumBlocks = 0;
+        }
+      }
+    }
+
+    struct Bin
+    {
+      FreeBlock* m_pBlocks = nullptr;
+      ezUInt32 m_uiNumBlocks = 0;
+    };
+
+    Bin m_Bins[s_uiNumSizeClasses];
+  };
+
+  thread_local ThreadCache tl_ThreadCache;
+
+  // allocations can still happen on a thread after its cache has been destroyed, e.g. from other thread local destructors
+  thread_local bool tl_bThreadCacheDestroyed = false;
+
+  ThreadCache::~ThreadCache()
+  {
+    tl_bThreadCacheDestroyed = true;
+    Flush();
+  }
+
+  void* AllocateSmall(ezUInt32 uiSizeClass)
+  {
+    if (tl_bThreadCacheDestroyed)
+    {
+      FreeBlock* pBlock = nullptr;
+      TakeBlocks(GetSharedHeap(), uiSizeClass, 1, pBlock);
+      return pBlock;
+    }
+
+    ThreadCache::Bin& bin = tl_ThreadCache.m_Bins[uiSizeClass];
+    if (bin.m_pBlocks == nullptr)
+    {
+      bin.m_uiNumBlocks = TakeBlocks(GetSharedHeap(), uiSizeClass, GetBatchSize(uiSizeClass), bin.m_pBlocks);
+    }
+
+    FreeBlock* pBlock = bin.m_pBlocks;
+    bin.m_pBlocks = pBlock->m_pNext;
+    --bin.m_uiNumBlocks;
+
+    return pBlock;
+  }
+
+  void DeallocateSmall(ezUInt32 uiSizeClass, void* ptr)
+  {
+    FreeBlock* pBlock = static_cast<FreeBlock*>(ptr);
+
+    if (tl_bThreadCacheDestroyed)
+    {
+      pBlock->m_pNext = nullptr;
+      ReturnBlocks(GetSharedHeap(), uiSizeClass, pBlock);
+      return;
+    }
+
+    ThreadCache::Bin& bin = tl_ThreadCache.m_Bins[uiSizeClass];
+    pBlock->m_pNext = bin.m_pBlocks;
+    bin.m_pBlocks = pBlock;
+    ++bin.m_uiNumBlocks;
+
+    // keep the most recently freed blocks, they are the most likely ones to still be in the CPU cache
+    const ezUInt32 uiBatchSize = GetBatchSize(uiSizeClass);
+    if (bin.m_uiNumBlocks > 2 * uiBatchSize)
+    {
+      FreeBlock* pLastKept = bin.m_pBlocks;
+      for (ezUInt32 i = 1; i < uiBatchSize; ++i)
+      {
+        pLastKept = pLastKept->m_pNext;
+      }
+
+      FreeBlock* pBlocksToReturn = pLastKept->m_pNext;
+      pLastKept->m_pNext = nullptr;
+      bin.m_uiNumBlocks = uiBatchSize;
+
+      ReturnBlocks(GetSharedHeap(), uiSizeClass, pBlocksToReturn);
+    }
+  }
+
+  void* AllocateLarge(size_t uiSize, size_t uiAlign)
+  {
+    EZ_ASSERT_DEV(uiAlign <= s_uiSpanSize, "Alignment of {0} bytes is not supported", uiAlign);
+
+    // only rounded up to the page size, the header goes into the alignment padding in front of the user pointer
+    const size_t uiPageSize = ezSystemInformation::Get().GetMemoryPageSize();
+    const size_t uiAllocationSize = ezMemoryUtils::AlignSize(uiAlign + uiSize, uiPageSize);
+
+    // the allocation is tracked by the allocator that hands it out, not as pages
+    ezUInt8* pPages = static_cast<ezUInt8*>(ezPageAllocator::AllocatePage(uiAllocationSize, uiAlign > uiPageSize ? uiAlign : 0, false));
+    ezUInt8* pMemory = pPages + uiAlign;
+
+    LargeHeader* pHeader = reinterpret_cast<LargeHeader*>(pMemory) - 1;
+    pHeader->m_pPages = pPages;
+    pHeader->m_uiAllocationSize = uiAllocationSize;
+
+    GetSharedHeap().m_iReservedSize.Add(uiAllocationSize);
+
+    return pMemory;
+  }
+
+  void DeallocateLarge(void* ptr)
+  {
+    const LargeHeader* pHeader = static_cast<const LargeHeader*>(ptr) - 1;
+
+    GetSharedHeap().m_iReservedSize.Subtract(pHeader->m_uiAllocationSize);
+
+    ezPageAllocator::DeallocatePage(pHeader->m_pPages, false);
+  }
+} // namespace
+
+namespace ezMemoryPolicies
+{
+  ezThreadCachingAllocation::ezThreadCachingAllocation(ezAllocatorBase* pParent)
+  {
+    GetSharedHeap().m_iNumInstances.Increment();
+  }
+
+  ezThreadCachingAllocation::~ezThreadCachingAllocation()
+  {
+    if (GetSharedHeap().m_iNumInstances.Decrement() == 0)
+    {
+      ReleaseCachedMemory();
+    }
+  }
+
+  void* ezThreadCachingAllocation::Allocate(size_t uiSize, size_t uiAlign)
+  {
+    uiSize = ezMath::Max<size_t>(uiSize, 1);
+    uiAlign = ezMath::Max(uiAlign, s_uiMinAlignment);
+
+    if (uiSize <= s_uiMaxSmallSize && uiAlign <= s_uiMaxSmallAlignment)
+    {
+      // blocks start at a multiple of the class size after the 64 byte header,
+      // so larger alignments are satisfied by size classes that are a multiple of the alignment
+      ezUInt32 uiSizeClass = GetSizeClass(uiSize);
+      while (uiSizeClass < s_uiNumSizeClasses && GetClassSize(uiSizeClass) % uiAlign != 0)
+      {
+        ++uiSizeClass;
+      }
+
+      if (uiSizeClass < s_uiNumSizeClasses)
+      {
+        return AllocateSmall(uiSizeClass);
+      }
+    }
+
+    return AllocateLarge(uiSize, uiAlign);
+  }
+
+  void ezThreadCachingAllocation::Deallocate(void* ptr)
+  {
+    if (ptr == nullptr)
+      return;
+
+    if (IsSpan(GetSharedHeap(), ptr))
+    {
+      DeallocateSmall(GetSpan(ptr)->m_uiSizeClass, ptr);
+    }
+    else
+    {
+      DeallocateLarge(ptr);
+    }
+  }
+
+  void ezThreadCachingAllocation::AddStats(ezAllocatorBase::Stats& inout_Stats) const
+  {
+    const SharedHeap& heap = GetSharedHeap();
+    inout_Stats.m_uiReservedSize += heap.m_iReservedSize;
+    inout_Stats.m_uiCachedSize += heap.m_iCachedSize;
+  }
+
+  // static
+  void ezThreadCachingAllocation::ReleaseCachedMemory()
+  {
+    if (!tl_bThreadCacheDestroyed)
+    {
+      tl_ThreadCache.Flush();
+    }
+
+    SharedHeap& heap = GetSharedHeap();
+
+    SpanHeader* pEmptySpans = nullptr;
+    {
+      EZ_LOCK(heap.m_EmptySpansMutex);
+      pEmptySpans = heap.m_pEmptySpans;
+      heap.m_pEmptySpans = nullptr;
+      heap.m_uiNumEmptySpans = 0;
+    }
+
+    while (pEmptySpans != nullptr)
+    {
+      SpanHeader* pSpan = pEmptySpans;
+      pEmptySpans = pEmptySpans->m_pNext;
+
+      heap.m_iCachedSize.Subtract(s_uiSpanSize - s_uiSpanHeaderSize);
+      FreeSpanPages(heap, pSpan);
+    }
+  }
+} // namespace ezMemoryPolicies
+
+EZ_STATICLINK_FILE(Foundation, Foundation_Memory_Policies_ThreadCachingAllocation);
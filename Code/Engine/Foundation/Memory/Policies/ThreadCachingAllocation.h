@@ -0,0 +1,43 @@
+#pragma once
+
+#include <Foundation/Basics.h>
+
+namespace ezMemoryPolicies
+{
+  /// \brief Allocation policy that is optimized for many small allocations from many threads.
+  ///
+  /// Small allocations are rounded up to a size class. Every thread keeps a cache of free blocks per size class, so most allocations
+  /// and deallocations don't need any synchronization. Blocks are carved out of 64 KB spans, which are allocated with ezPageAllocator
+  /// and shared between all allocators that use this policy. Blocks that a thread frees go into its own cache, no matter which thread
+  /// allocated them. Once a cache grows too large, a batch of blocks is returned to the shared pool and spans that become completely
+  /// empty are given back to the system.
+  ///
+  /// Allocations larger than the biggest size class (8 KB) get their own pages, rounded up to the page size. Alignments of up to 64 bytes
+  /// are supported for small allocations, larger alignments of up to 64 KB use their own pages as well.
+  ///
+  /// The pages are not recorded by the memory tracker, all allocations show up at the allocator that uses this policy.
+  ///
+  /// The memory reserved from the system and the part of it that is held for reuse is reported through ezAllocatorBase::GetStats().
+  /// Note that these numbers are shared by all allocators that use this policy.
+  ///
+  /// \see ezAllocator
+  class EZ_FOUNDATION_DLL ezThreadCachingAllocation
+  {
+  public:
+    ezThreadCachingAllocation(ezAllocatorBase* pParent);
+    ~ezThreadCachingAllocation();
+
+    void* Allocate(size_t uiSize, size_t uiAlign);
+    void Deallocate(void* ptr);
+
+    /// \brief Adds the reserved and cached memory of the shared pool to the given stats.
+    void AddStats(ezAllocatorBase::Stats& inout_Stats) const;
+
+    EZ_ALWAYS_INLINE ezAllocatorBase* GetParent() const { return nullptr; }
+
+    /// \brief Returns all blocks that are cached by the calling thread and all empty spans that are kept for reuse to the system.
+    ///
+    /// This is done automatically when a thread exits and when the last allocator that uses this policy is destroyed.
+    static void ReleaseCachedMemory();
+  };
+} // namespace ezMemoryPolicies
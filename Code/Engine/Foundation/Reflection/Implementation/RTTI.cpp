@@ -2,6 +2,7 @@
 
 #include <Foundation/Reflection/Implementation/AbstractProperty.h>
 #include <Foundation/Reflection/Implementation/MessageHandler.h>
+#include <Foundation/Reflection/Implementation/SerializationPlan.h>
 
 #include <Foundation/Communication/Message.h>
 #include <Foundation/Configuration/Startup.h>
@@ -18,7 +19,7 @@ ezTypeHashTable* GetTypeHashTable()
   // Prevent static initialization hazard between first ezRTTI instance
   // and the hash table and also make sure it is sufficiently sized before first use.
   auto CreateTable = []() -> ezTypeHashTable* {
-    ezTypeHashTable* table = new ezTypeHashTable();
+    ezTypeHashTable* table = EZ_NEW(ezStaticAllocatorWrapper::GetAllocator(), ezTypeHashTable);
     table->m_Table.Reserve(512);
     return table;
   };
@@ -26,6 +27,29 @@ ezTypeHashTable* GetTypeHashTable()
   return table;
 }
 
+struct ezRTTI::PropertyCache
+{
+  /// Contains the properties of all base types as well, derived types take precedence.
+  ezHashTable<const char*, ezAbstractProperty*, ezHashHelper<const char*>, ezStaticAllocatorWrapper> m_PropertiesByName;
+  ezSerializationPlan m_SerializationPlan;
+};
+
+namespace
+{
+  struct ezPropertyCacheState
+  {
+    ezMutex m_Mutex;
+    ezUInt32 m_uiNumCaches = 0;
+  };
+
+  ezPropertyCacheState& GetPropertyCacheState()
+  {
+    // Types are constructed during static initialization, so this has to be created on first use.
+    static ezPropertyCacheState* pState = EZ_NEW(ezStaticAllocatorWrapper::GetAllocator(), ezPropertyCacheState);
+    return *pState;
+  }
+} // namespace
+
 EZ_ENUMERABLE_CLASS_IMPLEMENTATION(ezRTTI);
 
 // clang-format off
@@ -89,6 +113,9 @@ ezRTTI::~ezRTTI()
 {
   if (m_szTypeName)
     UnregisterType();
+
+  EZ_LOCK(GetPropertyCacheState().m_Mutex);
+  ClearPropertyCache();
 }
 
 void ezRTTI::GatherDynamicMessageHandlers()
@@ -145,6 +172,12 @@ void ezRTTI::GatherDynamicMessageHandlers()
 
 void ezRTTI::SetupParentHierarchy()
 {
+  {
+    // derived types have already been invalidated by UpdateType, when the hierarchy actually changed
+    EZ_LOCK(GetPropertyCacheState().m_Mutex);
+    ClearPropertyCache();
+  }
+
   m_ParentHierarchy.Clear();
 
   for (const ezRTTI* rtti = this; rtti != nullptr; rtti = rtti->m_pParentType)
@@ -210,6 +243,8 @@ void ezRTTI::UpdateType(const ezRTTI* pParentType, ezUInt32 uiTypeSize, ezUInt32
   m_uiTypeVersion = uiTypeVersion;
   m_TypeFlags = flags;
   m_ParentHierarchy.Clear();
+
+  InvalidatePropertyCache();
 }
 
 void ezRTTI::RegisterType()
@@ -226,6 +261,9 @@ void ezRTTI::UnregisterType()
   auto pTable = GetTypeHashTable();
   EZ_LOCK(pTable->m_Mutex);
   pTable->m_Table.Remove(m_szTypeName);
+
+  // derived types might reference the properties of this type
+  InvalidatePropertyCache();
 }
 
 void ezRTTI::GetAllProperties(ezHybridArray<ezAbstractProperty*, 32>& out_Properties) const
@@ -302,6 +340,13 @@ ezRTTI* ezRTTI::FindTypeByNameHash32(ezUInt32 uiNameHash)
 
 ezAbstractProperty* ezRTTI::FindPropertyByName(const char* szName, bool bSearchBaseTypes /* = true */) const
 {
+  if (bSearchBaseTypes && szName != nullptr)
+  {
+    ezAbstractProperty* pProp = nullptr;
+    GetPropertyCache().m_PropertiesByName.TryGetValue(szName, pProp);
+    return pProp;
+  }
+
   const ezRTTI* pInstance = this;
 
   do
@@ -323,6 +368,82 @@ ezAbstractProperty* ezRTTI::FindPropertyByName(const char* szName, bool bSearchB
   return nullptr;
 }
 
+const ezSerializationPlan& ezRTTI::GetSerializationPlan() const
+{
+  return GetPropertyCache().m_SerializationPlan;
+}
+
+void ezRTTI::InvalidatePropertyCache()
+{
+  ezPropertyCacheState& state = GetPropertyCacheState();
+  EZ_LOCK(state.m_Mutex);
+
+  ClearPropertyCache();
+
+  // types are created and updated a lot during static initialization, but no cache exists at that point, so there is nothing to look for
+  if (state.m_uiNumCaches == 0)
+    return;
+
+  // m_ParentHierarchy may not be set up yet, so walk the parent chain instead
+  for (ezRTTI* pType = ezRTTI::GetFirstInstance(); pType != nullptr; pType = pType->GetNextInstance())
+  {
+    for (const ezRTTI* pParent = pType->m_pParentType; pParent != nullptr; pParent = pParent->m_pParentType)
+    {
+      if (pParent == this)
+      {
+        pType->ClearPropertyCache();
+        break;
+      }
+    }
+  }
+}
+
+void ezRTTI::ClearPropertyCache() const
+{
+  if (m_pPropertyCache == nullptr)
+    return;
+
+  m_bPropertyCacheValid.Set(false);
+
+  EZ_DELETE(ezStaticAllocatorWrapper::GetAllocator(), m_pPropertyCache);
+  --GetPropertyCacheState().m_uiNumCaches;
+}
+
+const ezRTTI::PropertyCache& ezRTTI::GetPropertyCache() const
+{
+  if (m_bPropertyCacheValid)
+    return *m_pPropertyCache;
+
+  ezPropertyCacheState& state = GetPropertyCacheState();
+  EZ_LOCK(state.m_Mutex);
+
+  if (!m_bPropertyCacheValid)
+  {
+    // the static allocator is used, since the caches are only freed when the types are destroyed, which is after the leak report
+    PropertyCache* pCache = EZ_NEW(ezStaticAllocatorWrapper::GetAllocator(), PropertyCache);
+    ++state.m_uiNumCaches;
+
+    // search this type first, so that properties of derived types hide those of the base types, same as the linear search does
+    for (const ezRTTI* pInstance = this; pInstance != nullptr; pInstance = pInstance->m_pParentType)
+    {
+      for (ezAbstractProperty* pProp : pInstance->m_Properties)
+      {
+        if (!pCache->m_PropertiesByName.Contains(pProp->GetPropertyName()))
+        {
+          pCache->m_PropertiesByName.Insert(pProp->GetPropertyName(), pProp);
+        }
+      }
+    }
+
+    pCache->m_SerializationPlan.Build(this);
+
+    m_pPropertyCache = pCache;
+    m_bPropertyCacheValid.Set(true);
+  }
+
+  return *m_pPropertyCache;
+}
+
 bool ezRTTI::DispatchMessage(void* pInstance, ezMessage& msg) const
 {
   EZ_ASSERT_DEBUG(m_bGatheredDynamicMessageHandlers, "Message handler table should have been gathered at this point.\n"
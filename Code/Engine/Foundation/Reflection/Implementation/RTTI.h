@@ -5,6 +5,7 @@
 #include <Foundation/Basics.h>
 #include <Foundation/Configuration/Plugin.h>
 #include <Foundation/Reflection/Implementation/StaticRTTI.h>
+#include <Foundation/Threading/AtomicInteger.h>
 #include <Foundation/Utilities/EnumerableClass.h>
 
 
@@ -17,6 +18,7 @@ class ezAbstractFunctionProperty;
 class ezAbstractMessageHandler;
 struct ezMessageSenderInfo;
 class ezPropertyAttribute;
+class ezSerializationPlan;
 class ezMessage;
 typedef ezUInt16 ezMessageId;
 
@@ -108,9 +110,16 @@ public:
   static ezRTTI* FindTypeByNameHash(ezUInt64 uiNameHash); // [tested]
   static ezRTTI* FindTypeByNameHash32(ezUInt32 uiNameHash);
 
-  /// \brief Will iterate over all properties of this type and (optionally) the base types to search for a property with the given name.
+  /// \brief Searches the properties of this type and (optionally) the base types for a property with the given name.
+  ///
+  /// When the base types are included, the lookup goes through a hash table of all properties that is built on first use.
   ezAbstractProperty* FindPropertyByName(const char* szName, bool bSearchBaseTypes = true) const; // [tested]
 
+  /// \brief Returns the properties of this type and all base types with precomputed access information, see ezSerializationPlan.
+  ///
+  /// The plan is built on first use and rebuilt whenever the properties of any type changed, e.g. when phantom types are updated.
+  const ezSerializationPlan& GetSerializationPlan() const;
+
   /// \brief Returns the name of the plugin which this type is declared in.
   EZ_ALWAYS_INLINE const char* GetPluginName() const { return m_szPluginName; } // [tested]
 
@@ -184,7 +193,19 @@ protected:
   ezArrayPtr<ezMessageSenderInfo> m_MessageSenders;
   ezHybridArray<const ezRTTI*, 8> m_ParentHierarchy;
 
+  /// \brief Discards the property lookup table and serialization plan of this type and all types derived from it.
+  ///
+  /// Types must not be modified while other threads use them, so the outdated data is freed right away.
+  void InvalidatePropertyCache();
+
 private:
+  struct PropertyCache;
+  const PropertyCache& GetPropertyCache() const;
+  void ClearPropertyCache() const;
+
+  mutable PropertyCache* m_pPropertyCache = nullptr;
+  mutable ezAtomicBool m_bPropertyCacheValid; ///< Set after m_pPropertyCache has been built, so it can be read without a lock.
+
   EZ_MAKE_SUBSYSTEM_STARTUP_FRIEND(Foundation, Reflection);
 
   /// \brief Assigns the given plugin name to every ezRTTI instance that has no plugin assigned yet.
@@ -0,0 +1,172 @@
+#include <Foundation/FoundationPCH.h>
+
+#include <Foundation/Reflection/Implementation/SerializationPlan.h>
+#include <Foundation/Reflection/Reflection.h>
+
+// Standard types that are trivially copyable and can therefore be accessed directly in memory.
+#define EZ_SERIALIZATION_PLAN_DIRECT_TYPES(MACRO) \
+  MACRO(Bool, bool)                               \
+  MACRO(Int8, ezInt8)                             \
+  MACRO(UInt8, ezUInt8)                           \
+  MACRO(Int16, ezInt16)                           \
+  MACRO(UInt16, ezUInt16)                         \
+  MACRO(Int32, ezInt32)                           \
+  MACRO(UInt32, ezUInt32)                         \
+  MACRO(Int64, ezInt64)                           \
+  MACRO(UInt64, ezUInt64)                         \
+  MACRO(Float, float)                             \
+  MACRO(Double, double)                           \
+  MACRO(Color, ezColor)                           \
+  MACRO(Vector2, ezVec2)                          \
+  MACRO(Vector3, ezVec3)                          \
+  MACRO(Vector4, ezVec4)                          \
+  MACRO(Vector2I, ezVec2I32)                      \
+  MACRO(Vector3I, ezVec3I32)                      \
+  MACRO(Vector4I, ezVec4I32)                      \
+  MACRO(Vector2U, ezVec2U32)                      \
+  MACRO(Vector3U, ezVec3U32)                      \
+  MACRO(Vector4U, ezVec4U32)                      \
+  MACRO(Quaternion, ezQuat)                       \
+  MACRO(Matrix3, ezMat3)                          \
+  MACRO(Matrix4, ezMat4)                          \
+  MACRO(Transform, ezTransform)                   \
+  MACRO(Time, ezTime)                             \
+  MACRO(Uuid, ezUuid)                             \
+  MACRO(Angle, ezAngle)                           \
+  MACRO(ColorGamma, ezColorGammaUB)
+
+namespace
+{
+  ezUInt32 GetDirectTypeSize(ezVariantType::Enum type)
+  {
+    switch (type)
+    {
+#define EZ_DIRECT_TYPE_SIZE(VariantType, Type) \
+  case ezVariantType::VariantType:             \
+    return sizeof(Type);
+
+      EZ_SERIALIZATION_PLAN_DIRECT_TYPES(EZ_DIRECT_TYPE_SIZE)
+
+#undef EZ_DIRECT_TYPE_SIZE
+
+      default:
+        return 0;
+    }
+  }
+} // namespace
+
+ezVariant ezSerializationPlan::Property::ReadDirect(const void* pObject) const
+{
+  const void* pMember = static_cast<const ezUInt8*>(pObject) + m_uiOffset;
+
+  switch (m_DirectType)
+  {
+#define EZ_DIRECT_TYPE_READ(VariantType, Type) \
+  case ezVariantType::VariantType:             \
+    return ezVariant(*static_cast<const Type*>(pMember));
+
+    EZ_SERIALIZATION_PLAN_DIRECT_TYPES(EZ_DIRECT_TYPE_READ)
+
+#undef EZ_DIRECT_TYPE_READ
+
+    default:
+      EZ_REPORT_FAILURE("Property '{0}' has no direct access", m_pProperty->GetPropertyName());
+      return ezVariant();
+  }
+}
+
+void ezSerializationPlan::Property::WriteDirect(void* pObject, const ezVariant& value) const
+{
+  void* pMember = static_cast<ezUInt8*>(pObject) + m_uiOffset;
+
+  switch (m_DirectType)
+  {
+#define EZ_DIRECT_TYPE_WRITE(VariantType, Type)              \
+  case ezVariantType::VariantType:                           \
+    *static_cast<Type*>(pMember) = value.ConvertTo<Type>(); \
+    return;
+
+    EZ_SERIALIZATION_PLAN_DIRECT_TYPES(EZ_DIRECT_TYPE_WRITE)
+
+#undef EZ_DIRECT_TYPE_WRITE
+
+    default:
+      EZ_REPORT_FAILURE("Property '{0}' has no direct access", m_pProperty->GetPropertyName());
+  }
+}
+
+#undef EZ_SERIALIZATION_PLAN_DIRECT_TYPES
+
+ezSerializationPlan::ezSerializationPlan() = default;
+ezSerializationPlan::~ezSerializationPlan() = default;
+
+void ezSerializationPlan::Build(const ezRTTI* pType)
+{
+  m_Properties.Clear();
+
+  ezHybridArray<ezAbstractProperty*, 32> properties;
+  pType->GetAllProperties(properties);
+
+  // Direct member properties only apply the member offset to the instance pointer,
+  // so any address can be used to determine the offset without an actual object.
+  const ezUInt8* pFakeInstance = reinterpret_cast<const ezUInt8*>(static_cast<size_t>(0x10000));
+
+  m_Properties.Reserve(properties.GetCount());
+  for (ezAbstractProperty* pProp : properties)
+  {
+    Property& prop = m_Properties.ExpandAndGetRef();
+    prop.m_pProperty = pProp;
+
+    if (pProp->GetCategory() != ezPropertyCategory::Member || !pProp->GetFlags().IsSet(ezPropertyFlags::StandardType) ||
+        pProp->GetFlags().IsAnySet(ezPropertyFlags::Pointer | ezPropertyFlags::IsEnum | ezPropertyFlags::Bitflags))
+      continue;
+
+    const ezVariantType::Enum type = pProp->GetSpecificType()->GetVariantType();
+    const ezUInt32 uiSize = GetDirectTypeSize(type);
+    if (uiSize == 0)
+      continue;
+
+    const ezUInt8* pMember = static_cast<const ezUInt8*>(static_cast<const ezAbstractMemberProperty*>(pProp)->GetPropertyPointer(pFakeInstance));
+    if (pMember == nullptr)
+      continue;
+
+    prop.m_DirectType = type;
+    prop.m_uiOffset = static_cast<ezUInt32>(pMember - pFakeInstance);
+    prop.m_uiSize = uiSize;
+  }
+
+  // Merge writable direct members that are stored without gaps into runs.
+  // Going back to front, every property knows the run that starts at it.
+  for (ezUInt32 i = m_Properties.GetCount(); i-- > 0;)
+  {
+    Property& prop = m_Properties[i];
+    if (!prop.HasDirectAccess() || prop.m_pProperty->GetFlags().IsSet(ezPropertyFlags::ReadOnly))
+      continue;
+
+    prop.m_uiRunLength = 1;
+    prop.m_uiRunSize = prop.m_uiSize;
+
+    if (i + 1 < m_Properties.GetCount())
+    {
+      const Property& next = m_Properties[i + 1];
+      if (next.m_uiRunLength > 0 && next.m_uiOffset == prop.m_uiOffset + prop.m_uiSize)
+      {
+        prop.m_uiRunLength += next.m_uiRunLength;
+        prop.m_uiRunSize += next.m_uiRunSize;
+      }
+    }
+  }
+}
+
+ezUInt32 ezSerializationPlan::CopyRun(ezUInt32 uiPropertyIndex, const void* pObject, void* pTarget) const
+{
+  const Property& prop = m_Properties[uiPropertyIndex];
+  if (prop.m_uiRunLength > 0)
+  {
+    ezMemoryUtils::RawByteCopy(static_cast<ezUInt8*>(pTarget) + prop.m_uiOffset, static_cast<const ezUInt8*>(pObject) + prop.m_uiOffset, prop.m_uiRunSize);
+  }
+
+  return prop.m_uiRunLength;
+}
+
+EZ_STATICLINK_FILE(Foundation, Foundation_Reflection_Implementation_SerializationPlan);
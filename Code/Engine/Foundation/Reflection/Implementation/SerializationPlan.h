@@ -0,0 +1,54 @@
+#pragma once
+
+/// \file
+
+#include <Foundation/Containers/DynamicArray.h>
+#include <Foundation/Types/Variant.h>
+
+class ezAbstractProperty;
+
+/// \brief Flattened list of all properties of a reflected type, including the ones of its base types, with precomputed access information.
+///
+/// Serializers iterate over the plan instead of walking the type hierarchy and dispatching on the property flags for every object.
+/// Member properties of simple standard types (numbers, vectors, colors, etc.) that are stored directly in the object are read and written
+/// through their offset, without going through the virtual property accessors. Consecutive members of this kind are merged into runs that
+/// can be copied in bulk.
+///
+/// Use ezRTTI::GetSerializationPlan() to get the cached plan of a type.
+class EZ_FOUNDATION_DLL ezSerializationPlan
+{
+public:
+  struct Property
+  {
+    ezAbstractProperty* m_pProperty = nullptr;
+    ezVariantType::Enum m_DirectType = ezVariantType::Invalid; ///< Type of the member, if it has direct access.
+    ezUInt32 m_uiOffset = ezInvalidIndex;                      ///< Offset of the member inside the object, ezInvalidIndex if it has no direct access.
+    ezUInt32 m_uiSize = 0;                                     ///< Size of the member, if it has direct access.
+    ezUInt32 m_uiRunLength = 0;                                ///< Number of writable direct members starting at this one that are stored without gaps.
+    ezUInt32 m_uiRunSize = 0;                                  ///< Size of that run in bytes.
+
+    EZ_ALWAYS_INLINE bool HasDirectAccess() const { return m_uiOffset != ezInvalidIndex; }
+
+    /// \brief Reads the value of a direct member property. Same result as ezReflectionUtils::GetMemberPropertyValue().
+    ezVariant ReadDirect(const void* pObject) const;
+
+    /// \brief Writes the value of a direct member property. Same result as ezReflectionUtils::SetMemberPropertyValue().
+    void WriteDirect(void* pObject, const ezVariant& value) const;
+  };
+
+  ezSerializationPlan();
+  ~ezSerializationPlan();
+
+  /// \brief Builds the plan for the given type. Called by ezRTTI, use ezRTTI::GetSerializationPlan() instead.
+  void Build(const ezRTTI* pType);
+
+  /// \brief Returns all properties of the type, base type properties first.
+  EZ_ALWAYS_INLINE ezArrayPtr<const Property> GetProperties() const { return m_Properties; }
+
+  /// \brief Copies all writable properties from \a pObject to \a pTarget that are part of a run, starting at \a uiPropertyIndex.
+  /// Returns the number of properties that were copied, zero if the property at \a uiPropertyIndex has no direct access.
+  ezUInt32 CopyRun(ezUInt32 uiPropertyIndex, const void* pObject, void* pTarget) const;
+
+private:
+  ezDynamicArray<Property, ezStaticAllocatorWrapper> m_Properties;
+};
@@ -17,6 +17,7 @@
 #include <Foundation/Reflection/Implementation/MessageHandler.h>
 #include <Foundation/Reflection/Implementation/PropertyAttributes.h>
 #include <Foundation/Reflection/Implementation/RTTI.h>
+#include <Foundation/Reflection/Implementation/SerializationPlan.h>
 #include <Foundation/Reflection/Implementation/SetProperty.h>
 #include <Foundation/Reflection/Implementation/StaticRTTI.h>
 
@@ -28,6 +28,18 @@ public:
   static void WriteDocument(ezStreamWriter& stream, const ezAbstractObjectGraph* pHeader, const ezAbstractObjectGraph* pGraph, const ezAbstractObjectGraph* pTypes, bool bCompactMode = true, ezOpenDdlWriter::TypeStringMode typeMode = ezOpenDdlWriter::TypeStringMode::Shortest);
   static ezResult ReadDocument(ezStreamReader& stream, ezUniquePtr<ezAbstractObjectGraph>& pHeader, ezUniquePtr<ezAbstractObjectGraph>& pGraph, ezUniquePtr<ezAbstractObjectGraph>& pTypes, bool bApplyPatches = true);
 
+  /// \brief Writes the same data as Write(), but in a binary encoding instead of OpenDDL text.
+  ///
+  /// All strings (types, property names and string values) are stored only once in a string table, all other values are stored in their
+  /// native binary representation and arrays in which all elements have the same fixed size type are stored as one block of raw data.
+  /// This makes reading much faster than parsing the text. Read(), ReadDocument() and ReadHeader() detect the binary format automatically,
+  /// so callers don't need to know which format a file uses.
+  /// When reading, every block is copied from the stream into memory before it is decoded, the data is never used in place.
+  static void WriteBinary(ezStreamWriter& stream, const ezAbstractObjectGraph* pGraph, const ezAbstractObjectGraph* pTypesGraph = nullptr);
+
+  /// \brief Writes the same data as WriteDocument(), but in the binary encoding described at WriteBinary().
+  static void WriteDocumentBinary(ezStreamWriter& stream, const ezAbstractObjectGraph* pHeader, const ezAbstractObjectGraph* pGraph, const ezAbstractObjectGraph* pTypes);
+
   static ezResult ReadHeader(ezStreamReader& stream, ezAbstractObjectGraph* pGraph);
 
 private:
@@ -1,5 +1,8 @@
 #include <Foundation/FoundationPCH.h>
 
+#include <Foundation/Containers/Deque.h>
+#include <Foundation/Containers/HashTable.h>
+#include <Foundation/IO/MemoryStream.h>
 #include <Foundation/IO/OpenDdlReader.h>
 #include <Foundation/IO/OpenDdlUtils.h>
 #include <Foundation/IO/OpenDdlWriter.h>
@@ -56,6 +59,660 @@ namespace
   }
 } // namespace
 
+//////////////////////////////////////////////////////////////////////////
+// Binary format
+//
+// Signature (8 bytes), format version (ezUInt32), size of all following data (ezUInt64)
+// String table: number of strings (ezUInt32), size of the string data (ezUInt32), offset of each string (ezUInt32[]), string data (zero terminated strings)
+// Number of blocks (ezUInt32)
+// For each block: name (string index), size of the block data (ezUInt64), block data
+//
+// Block data: number of nodes (ezUInt32)
+// For each node: guid, type (string index), type version (ezUInt32), node name (string index or ezInvalidIndex), number of properties (ezUInt32)
+// For each property: name (string index), value
+//
+// Values start with their ezVariantType. Strings are stored as string indices, arrays in which all elements have the same fixed size type
+// are stored as raw data, all other fixed size types are stored in their native binary representation.
+
+namespace
+{
+  // A text document can't start with a zero byte, which tells the two formats apart.
+  constexpr ezUInt8 s_BinaryDdlSignature[8] = {0, 'e', 'z', 'B', 'D', 'D', 'L', 0};
+  constexpr ezUInt32 s_uiBinaryDdlVersion = 2;
+
+  /// Arrays are read from the stream in pieces of at most this size, so that a corrupted size doesn't allocate more memory than the stream contains.
+  constexpr ezUInt32 s_uiBinaryDdlMaxChunkSize = 1024 * 1024;
+
+  /// All standard types, except for strings and data buffers, can be stored as raw data.
+  template <typename T>
+  constexpr bool IsRawValue = static_cast<int>(ezVariantTypeDeduction<T>::value) > ezVariantType::FirstStandardType && static_cast<int>(ezVariantTypeDeduction<T>::value) < ezVariantType::LastStandardType && !std::is_same<T, ezString>::value && !std::is_same<T, ezStringView>::value && !std::is_same<T, ezDataBuffer>::value;
+
+  struct RawSizeFunc
+  {
+    template <typename T>
+    void operator()()
+    {
+      if constexpr (IsRawValue<T>)
+      {
+        m_uiSize = sizeof(T);
+      }
+    }
+
+    ezUInt32 m_uiSize = 0;
+  };
+
+  struct ReadRawFunc
+  {
+    template <typename T>
+    void operator()()
+    {
+      if constexpr (IsRawValue<T>)
+      {
+        T value;
+        ezMemoryUtils::RawByteCopy(&value, m_pData, sizeof(T));
+        *m_pValue = value;
+      }
+    }
+
+    const ezUInt8* m_pData = nullptr;
+    ezVariant* m_pValue = nullptr;
+  };
+
+  /// Returns 0 for types that can't be stored as raw data.
+  ezUInt32 GetRawSize(ezVariantType::Enum type)
+  {
+    if (type <= ezVariantType::FirstStandardType || type >= ezVariantType::LastStandardType)
+      return 0;
+
+    RawSizeFunc func;
+    ezVariant::DispatchTo(func, type);
+    return func.m_uiSize;
+  }
+
+  class BinaryDdlWriter
+  {
+  public:
+    void AddGraph(const ezAbstractObjectGraph* pGraph, const char* szName)
+    {
+      Block& block = m_Blocks.ExpandAndGetRef();
+      block.m_uiName = GetStringIndex(szName);
+
+      ezMemoryStreamWriter writer(&block.m_Storage);
+
+      const auto& nodes = pGraph->GetAllNodes();
+      writer << nodes.GetCount();
+
+      for (auto itNode = nodes.GetIterator(); itNode.IsValid(); ++itNode)
+      {
+        const auto& node = *itNode.Value();
+
+        writer.WriteBytes(&node.GetGuid(), sizeof(ezUuid)).IgnoreResult();
+        writer << GetStringIndex(node.GetType());
+        writer << node.GetTypeVersion();
+        writer << (ezStringUtils::IsNullOrEmpty(node.GetNodeName()) ? ezInvalidIndex : GetStringIndex(node.GetNodeName()));
+
+        writer << node.GetProperties().GetCount();
+        for (const auto& prop : node.GetProperties())
+        {
+          writer << GetStringIndex(prop.m_szPropertyName);
+          WriteValue(writer, prop.m_Value);
+        }
+      }
+    }
+
+    void WriteTo(ezStreamWriter& stream) const
+    {
+      stream.WriteBytes(s_BinaryDdlSignature, sizeof(s_BinaryDdlSignature)).IgnoreResult();
+      stream << s_uiBinaryDdlVersion;
+
+      ezUInt64 uiPayloadSize = sizeof(ezUInt32) * 3 + m_StringOffsets.GetCount() * sizeof(ezUInt32) + m_StringData.GetCount();
+      for (const Block& block : m_Blocks)
+      {
+        uiPayloadSize += sizeof(ezUInt32) + sizeof(ezUInt64) + block.m_Storage.GetStorageSize64();
+      }
+
+      stream << uiPayloadSize;
+
+      stream << m_StringOffsets.GetCount();
+      stream << m_StringData.GetCount();
+      stream.WriteBytes(m_StringOffsets.GetData(), m_StringOffsets.GetCount() * sizeof(ezUInt32)).IgnoreResult();
+      stream.WriteBytes(m_StringData.GetData(), m_StringData.GetCount()).IgnoreResult();
+
+      stream << m_Blocks.GetCount();
+      for (const Block& block : m_Blocks)
+      {
+        stream << block.m_uiName;
+        stream << block.m_Storage.GetStorageSize64();
+        block.m_Storage.CopyToStream(stream).IgnoreResult();
+      }
+    }
+
+  private:
+    struct Block
+    {
+      ezUInt32 m_uiName = 0;
+      ezDefaultMemoryStreamStorage m_Storage;
+    };
+
+    ezUInt32 GetStringIndex(const char* szString)
+    {
+      ezUInt32 uiIndex;
+      if (m_StringIndices.TryGetValue(szString, uiIndex))
+        return uiIndex;
+
+      uiIndex = m_StringOffsets.GetCount();
+      m_StringIndices.Insert(szString, uiIndex);
+
+      m_StringOffsets.PushBack(m_StringData.GetCount());
+      m_StringData.PushBackRange(ezArrayPtr<const char>(szString, ezStringUtils::GetStringElementCount(szString) + 1));
+
+      return uiIndex;
+    }
+
+    void WriteValue(ezStreamWriter& writer, const ezVariant& value)
+    {
+      ezUInt8 uiType = value.GetType();
+
+      switch (value.GetType())
+      {
+        case ezVariantType::String:
+          writer << uiType;
+          writer << GetStringIndex(value.Get<ezString>().GetData());
+          return;
+
+        case ezVariantType::StringView:
+        {
+          // like in the text format, string views are read back as strings
+          uiType = ezVariantType::String;
+          writer << uiType;
+
+          // the hash table only stores the pointer, so the zero terminated copy has to stay alive
+          ezString& sTemp = m_TempStrings.ExpandAndGetRef();
+          sTemp = value.Get<ezStringView>();
+          writer << GetStringIndex(sTemp.GetData());
+          return;
+        }
+
+        case ezVariantType::VariantArray:
+        {
+          const ezVariantArray& values = value.Get<ezVariantArray>();
+
+          writer << uiType;
+          writer << values.GetCount();
+
+          // arrays of fixed size values are stored as one block of raw data
+          ezUInt8 uiElementType = values.IsEmpty() ? ezVariantType::Invalid : values[0].GetType();
+          const ezUInt32 uiElementSize = GetRawSize(static_cast<ezVariantType::Enum>(uiElementType));
+
+          for (ezUInt32 i = 1; i < values.GetCount() && uiElementSize > 0; ++i)
+          {
+            if (values[i].GetType() != uiElementType)
+            {
+              uiElementType = ezVariantType::Invalid;
+              break;
+            }
+          }
+
+          if (uiElementSize == 0)
+            uiElementType = ezVariantType::Invalid;
+
+          writer << uiElementType;
+
+          if (uiElementType != ezVariantType::Invalid)
+          {
+            for (const ezVariant& element : values)
+            {
+              writer.WriteBytes(element.GetData(), uiElementSize).IgnoreResult();
+            }
+          }
+          else
+          {
+            for (const ezVariant& element : values)
+            {
+              WriteValue(writer, element);
+            }
+          }
+          return;
+        }
+
+        case ezVariantType::VariantDictionary:
+        {
+          const ezVariantDictionary& values = value.Get<ezVariantDictionary>();
+
+          writer << uiType;
+          writer << values.GetCount();
+
+          for (auto it = values.GetIterator(); it.IsValid(); ++it)
+          {
+            writer << GetStringIndex(it.Key().GetData());
+            WriteValue(writer, it.Value());
+          }
+          return;
+        }
+
+        case ezVariantType::DataBuffer:
+        {
+          const ezDataBuffer& data = value.Get<ezDataBuffer>();
+
+          writer << uiType;
+          writer << data.GetCount();
+          writer.WriteBytes(data.GetData(), data.GetCount()).IgnoreResult();
+          return;
+        }
+
+        case ezVariantType::TypedObject:
+          // custom types are rare, they use their own serialization
+          writer << uiType;
+          writer << value;
+          return;
+
+        default:
+          break;
+      }
+
+      const ezUInt32 uiSize = GetRawSize(value.GetType());
+      if (uiSize == 0)
+      {
+        // invalid values and types that can't be serialized at all
+        uiType = ezVariantType::Invalid;
+        writer << uiType;
+        return;
+      }
+
+      writer << uiType;
+      writer.WriteBytes(value.GetData(), uiSize).IgnoreResult();
+    }
+
+    ezHashTable<const char*, ezUInt32> m_StringIndices;
+    ezDeque<ezString> m_TempStrings;
+    ezDynamicArray<ezUInt32> m_StringOffsets;
+    ezDynamicArray<char> m_StringData;
+    ezDeque<Block> m_Blocks;
+  };
+
+  class BinaryDdlReader
+  {
+  public:
+    /// \brief Reads the string table and then all blocks. GetGraph(szBlockName) returns the graph to read a block into, or nullptr to skip it.
+    template <typename GetGraphFunc>
+    ezResult Read(ezStreamReader& stream, GetGraphFunc getGraph, ezUInt32 uiMaxBlocks = ezInvalidIndex)
+    {
+      ezUInt32 uiVersion = 0;
+      stream >> uiVersion;
+
+      if (uiVersion != s_uiBinaryDdlVersion)
+      {
+        ezLog::Error("Unsupported binary DDL version {0}", uiVersion);
+        return EZ_FAILURE;
+      }
+
+      stream >> m_uiRemainingBytes;
+
+      EZ_SUCCEED_OR_RETURN(ReadStringTable(stream));
+
+      ezUInt32 uiNumBlocks = 0;
+      if (stream.ReadDWordValue(&uiNumBlocks).Failed() || Consume(sizeof(ezUInt32)).Failed())
+        return Error();
+
+      ezDynamicArray<ezUInt8> blockData;
+
+      for (ezUInt32 uiBlock = 0; uiBlock < ezMath::Min(uiNumBlocks, uiMaxBlocks); ++uiBlock)
+      {
+        ezUInt32 uiName = 0;
+        ezUInt64 uiSize = 0;
+        if (stream.ReadDWordValue(&uiName).Failed() || stream.ReadQWordValue(&uiSize).Failed())
+          return Error();
+
+        if (uiName >= m_StringOffsets.GetCount() || uiSize > ezMath::MaxValue<ezUInt32>() || Consume(sizeof(ezUInt32) + sizeof(ezUInt64) + uiSize).Failed())
+          return Error();
+
+        ezAbstractObjectGraph* pGraph = getGraph(GetString(uiName));
+        if (pGraph == nullptr)
+        {
+          if (stream.SkipBytes(uiSize) != uiSize)
+            return Error();
+
+          continue;
+        }
+
+        // every block is copied into memory and decoded from there, this way reading values doesn't go through the stream interface
+        EZ_SUCCEED_OR_RETURN(ReadArray(stream, blockData, static_cast<ezUInt32>(uiSize)));
+
+        m_pData = blockData.GetData();
+        m_pEnd = blockData.GetData() + blockData.GetCount();
+        m_bError = false;
+
+        ReadGraph(pGraph);
+
+        if (m_bError)
+          return Error();
+      }
+
+      return EZ_SUCCESS;
+    }
+
+  private:
+    ezResult Error()
+    {
+      ezLog::Error("Binary DDL data is corrupted");
+      return EZ_FAILURE;
+    }
+
+    /// \brief Subtracts uiBytes from the data that is left according to the header, fails if there isn't enough left.
+    ezResult Consume(ezUInt64 uiBytes)
+    {
+      if (uiBytes > m_uiRemainingBytes)
+        return EZ_FAILURE;
+
+      m_uiRemainingBytes -= uiBytes;
+      return EZ_SUCCESS;
+    }
+
+    /// \brief Reads uiCount elements in pieces, so the array only grows as far as the stream actually delivers data.
+    template <typename T>
+    ezResult ReadArray(ezStreamReader& stream, ezDynamicArray<T>& out_array, ezUInt32 uiCount)
+    {
+      constexpr ezUInt32 uiMaxChunkCount = s_uiBinaryDdlMaxChunkSize / sizeof(T);
+
+      out_array.Clear();
+      while (out_array.GetCount() < uiCount)
+      {
+        const ezUInt32 uiStart = out_array.GetCount();
+        const ezUInt32 uiChunkCount = ezMath::Min(uiCount - uiStart, uiMaxChunkCount);
+        out_array.SetCountUninitialized(uiStart + uiChunkCount);
+
+        const ezUInt64 uiChunkSize = static_cast<ezUInt64>(uiChunkCount) * sizeof(T);
+        if (stream.ReadBytes(out_array.GetData() + uiStart, uiChunkSize) != uiChunkSize)
+          return Error();
+      }
+
+      return EZ_SUCCESS;
+    }
+
+    ezResult ReadStringTable(ezStreamReader& stream)
+    {
+      ezUInt32 uiNumStrings = 0;
+      ezUInt32 uiDataSize = 0;
+      if (stream.ReadDWordValue(&uiNumStrings).Failed() || stream.ReadDWordValue(&uiDataSize).Failed())
+        return Error();
+
+      // validate the sizes before allocating anything, every string takes at least one byte for its terminator
+      if (uiNumStrings > uiDataSize || Consume(sizeof(ezUInt32) * 2 + static_cast<ezUInt64>(uiNumStrings) * sizeof(ezUInt32) + uiDataSize).Failed())
+        return Error();
+
+      EZ_SUCCEED_OR_RETURN(ReadArray(stream, m_StringOffsets, uiNumStrings));
+      EZ_SUCCEED_OR_RETURN(ReadArray(stream, m_StringData, uiDataSize));
+
+      // strings are used directly from the table, they all have to be terminated
+      if (uiNumStrings > 0 && (uiDataSize == 0 || m_StringData.PeekBack() != '\0'))
+        return Error();
+
+      for (ezUInt32 uiOffset : m_StringOffsets)
+      {
+        if (uiOffset >= uiDataSize)
+          return Error();
+      }
+
+      return EZ_SUCCESS;
+    }
+
+    EZ_ALWAYS_INLINE const char* GetString(ezUInt32 uiIndex) const { return m_StringData.GetData() + m_StringOffsets[uiIndex]; }
+
+    template <typename T>
+    EZ_ALWAYS_INLINE T Read()
+    {
+      T value = {};
+      if (m_pData + sizeof(T) > m_pEnd)
+      {
+        m_bError = true;
+        return value;
+      }
+
+      ezMemoryUtils::RawByteCopy(&value, m_pData, sizeof(T));
+      m_pData += sizeof(T);
+      return value;
+    }
+
+    const ezUInt8* ReadBytes(ezUInt64 uiSize)
+    {
+      if (uiSize > static_cast<ezUInt64>(m_pEnd - m_pData))
+      {
+        m_bError = true;
+        return nullptr;
+      }
+
+      const ezUInt8* pBytes = m_pData;
+      m_pData += uiSize;
+      return pBytes;
+    }
+
+    const char* ReadString()
+    {
+      const ezUInt32 uiIndex = Read<ezUInt32>();
+      if (uiIndex >= m_StringOffsets.GetCount())
+      {
+        m_bError = true;
+        return "";
+      }
+
+      return GetString(uiIndex);
+    }
+
+    void ReadGraph(ezAbstractObjectGraph* pGraph)
+    {
+      ezVariant value;
+
+      const ezUInt32 uiNumNodes = Read<ezUInt32>();
+      for (ezUInt32 uiNode = 0; uiNode < uiNumNodes && !m_bError; ++uiNode)
+      {
+        const ezUuid guid = Read<ezUuid>();
+        const char* szType = ReadString();
+        const ezUInt32 uiTypeVersion = Read<ezUInt32>();
+
+        const char* szNodeName = nullptr;
+        const ezUInt32 uiNodeName = Read<ezUInt32>();
+        if (uiNodeName != ezInvalidIndex)
+        {
+          if (uiNodeName >= m_StringOffsets.GetCount())
+          {
+            m_bError = true;
+            return;
+          }
+
+          szNodeName = GetString(uiNodeName);
+        }
+
+        if (m_bError || pGraph->GetNode(guid) != nullptr)
+        {
+          m_bError = true;
+          return;
+        }
+
+        ezAbstractObjectNode* pNode = pGraph->AddNode(guid, szType, uiTypeVersion, szNodeName);
+
+        const ezUInt32 uiNumProperties = Read<ezUInt32>();
+        for (ezUInt32 uiProperty = 0; uiProperty < uiNumProperties && !m_bError; ++uiProperty)
+        {
+          const char* szName = ReadString();
+          ReadValue(value);
+
+          if (!m_bError)
+          {
+            pNode->AddProperty(szName, value);
+          }
+        }
+      }
+    }
+
+    void ReadValue(ezVariant& out_value)
+    {
+      const ezVariantType::Enum type = static_cast<ezVariantType::Enum>(Read<ezUInt8>());
+
+      switch (type)
+      {
+        case ezVariantType::Invalid:
+          out_value = ezVariant();
+          return;
+
+        case ezVariantType::String:
+          out_value = ReadString();
+          return;
+
+        case ezVariantType::VariantArray:
+        {
+          const ezUInt32 uiCount = Read<ezUInt32>();
+          const ezVariantType::Enum elementType = static_cast<ezVariantType::Enum>(Read<ezUInt8>());
+
+          if (m_bError || uiCount > static_cast<ezUInt64>(m_pEnd - m_pData))
+          {
+            // every element needs at least one byte, this catches corrupted counts before allocating anything
+            m_bError = true;
+            return;
+          }
+
+          ezVariantArray values;
+          values.SetCount(uiCount);
+
+          if (elementType != ezVariantType::Invalid)
+          {
+            const ezUInt32 uiElementSize = GetRawSize(elementType);
+            const ezUInt8* pData = uiElementSize > 0 ? ReadBytes(static_cast<ezUInt64>(uiCount) * uiElementSize) : nullptr;
+
+            if (pData == nullptr)
+            {
+              m_bError = true;
+              return;
+            }
+
+            ReadRawFunc func;
+            for (ezUInt32 i = 0; i < uiCount; ++i)
+            {
+              func.m_pData = pData + static_cast<ezUInt64>(i) * uiElementSize;
+              func.m_pValue = &values[i];
+              ezVariant::DispatchTo(func, elementType);
+            }
+          }
+          else
+          {
+            for (ezUInt32 i = 0; i < uiCount && !m_bError; ++i)
+            {
+              ReadValue(values[i]);
+            }
+          }
+
+          out_value = std::move(values);
+          return;
+        }
+
+        case ezVariantType::VariantDictionary:
+        {
+          const ezUInt32 uiCount = Read<ezUInt32>();
+          if (m_bError || uiCount > static_cast<ezUInt64>(m_pEnd - m_pData))
+          {
+            m_bError = true;
+            return;
+          }
+
+          ezVariantDictionary values;
+
+          ezVariant element;
+          for (ezUInt32 i = 0; i < uiCount && !m_bError; ++i)
+          {
+            const char* szKey = ReadString();
+            ReadValue(element);
+            values.Insert(szKey, element);
+          }
+
+          out_value = std::move(values);
+          return;
+        }
+
+        case ezVariantType::DataBuffer:
+        {
+          const ezUInt32 uiCount = Read<ezUInt32>();
+          const ezUInt8* pData = ReadBytes(uiCount);
+          if (pData == nullptr)
+            return;
+
+          ezDataBuffer data;
+          data.SetCountUninitialized(uiCount);
+          ezMemoryUtils::Copy(data.GetData(), pData, uiCount);
+          out_value = std::move(data);
+          return;
+        }
+
+        case ezVariantType::TypedObject:
+        {
+          ezRawMemoryStreamReader reader(m_pData, m_pEnd - m_pData);
+          reader >> out_value;
+          ReadBytes(reader.GetReadPosition());
+          return;
+        }
+
+        default:
+          break;
+      }
+
+      const ezUInt32 uiSize = GetRawSize(type);
+      const ezUInt8* pData = uiSize > 0 ? ReadBytes(uiSize) : nullptr;
+
+      if (pData == nullptr)
+      {
+        m_bError = true;
+        return;
+      }
+
+      ReadRawFunc func;
+      func.m_pData = pData;
+      func.m_pValue = &out_value;
+      ezVariant::DispatchTo(func, type);
+    }
+
+    ezDynamicArray<ezUInt32> m_StringOffsets;
+    ezDynamicArray<char> m_StringData;
+
+    ezUInt64 m_uiRemainingBytes = 0;
+
+    const ezUInt8* m_pData = nullptr;
+    const ezUInt8* m_pEnd = nullptr;
+    bool m_bError = false;
+  };
+
+  /// \brief Reads the first bytes of a stream to detect the binary format, and hands them out again when the stream is read as text.
+  class PeekStreamReader : public ezStreamReader
+  {
+  public:
+    PeekStreamReader(ezStreamReader& ref_stream)
+      : m_Stream(ref_stream)
+    {
+      m_uiPeekedBytes = static_cast<ezUInt32>(m_Stream.ReadBytes(m_PeekedBytes, sizeof(m_PeekedBytes)));
+    }
+
+    bool IsBinaryDdl() const
+    {
+      return m_uiPeekedBytes == sizeof(s_BinaryDdlSignature) && ezMemoryUtils::IsEqual(m_PeekedBytes, s_BinaryDdlSignature, sizeof(s_BinaryDdlSignature));
+    }
+
+    virtual ezUInt64 ReadBytes(void* pReadBuffer, ezUInt64 uiBytesToRead) override
+    {
+      const ezUInt32 uiFromPeeked = static_cast<ezUInt32>(ezMath::Min<ezUInt64>(uiBytesToRead, m_uiPeekedBytes - m_uiReadPosition));
+      ezMemoryUtils::Copy(static_cast<ezUInt8*>(pReadBuffer), m_PeekedBytes + m_uiReadPosition, uiFromPeeked);
+      m_uiReadPosition += uiFromPeeked;
+
+      if (uiFromPeeked == uiBytesToRead)
+        return uiBytesToRead;
+
+      return uiFromPeeked + m_Stream.ReadBytes(static_cast<ezUInt8*>(pReadBuffer) + uiFromPeeked, uiBytesToRead - uiFromPeeked);
+    }
+
+  private:
+    ezStreamReader& m_Stream;
+    ezUInt8 m_PeekedBytes[sizeof(s_BinaryDdlSignature)];
+    ezUInt32 m_uiPeekedBytes = 0;
+    ezUInt32 m_uiReadPosition = 0;
+  };
+} // namespace
+
 static void WriteGraph(ezOpenDdlWriter& writer, const ezAbstractObjectGraph* pGraph, const char* szName)
 {
   ezMap<const char*, const ezVariant*, CompareConstChar> SortedProperties;
@@ -113,6 +770,18 @@ void ezAbstractGraphDdlSerializer::Write(ezStreamWriter& stream, const ezAbstrac
   Write(writer, pGraph, pTypesGraph);
 }
 
+void ezAbstractGraphDdlSerializer::WriteBinary(ezStreamWriter& stream, const ezAbstractObjectGraph* pGraph, const ezAbstractObjectGraph* pTypesGraph)
+{
+  BinaryDdlWriter writer;
+  writer.AddGraph(pGraph, "Objects");
+  if (pTypesGraph)
+  {
+    writer.AddGraph(pTypesGraph, "Types");
+  }
+
+  writer.WriteTo(stream);
+}
+
 
 void ezAbstractGraphDdlSerializer::Write(
   ezOpenDdlWriter& writer, const ezAbstractObjectGraph* pGraph, const ezAbstractObjectGraph* pTypesGraph /*= nullptr*/)
@@ -181,8 +850,47 @@ static void ReadGraph(ezAbstractObjectGraph* pGraph, const ezOpenDdlReaderElemen
 ezResult ezAbstractGraphDdlSerializer::Read(
   ezStreamReader& stream, ezAbstractObjectGraph* pGraph, ezAbstractObjectGraph* pTypesGraph, bool bApplyPatches)
 {
+  PeekStreamReader peekStream(stream);
+  if (peekStream.IsBinaryDdl())
+  {
+    ezUniquePtr<ezAbstractObjectGraph> pTempTypesGraph;
+    if (pTypesGraph == nullptr)
+    {
+      pTempTypesGraph = EZ_DEFAULT_NEW(ezAbstractObjectGraph);
+      pTypesGraph = pTempTypesGraph.Borrow();
+    }
+
+    bool bHasObjects = false;
+
+    // the signature was already read from the stream
+    BinaryDdlReader reader;
+    EZ_SUCCEED_OR_RETURN(reader.Read(stream, [&](const char* szName) -> ezAbstractObjectGraph* {
+      if (ezStringUtils::IsEqual(szName, "Objects"))
+      {
+        bHasObjects = true;
+        return pGraph;
+      }
+
+      return ezStringUtils::IsEqual(szName, "Types") ? pTypesGraph : nullptr;
+    }));
+
+    if (!bHasObjects)
+    {
+      ezLog::Error("DDL graph does not contain an 'Objects' root object");
+      return EZ_FAILURE;
+    }
+
+    if (bApplyPatches)
+    {
+      ezGraphVersioning::GetSingleton()->PatchGraph(pTypesGraph);
+      ezGraphVersioning::GetSingleton()->PatchGraph(pGraph, pTypesGraph);
+    }
+
+    return EZ_SUCCESS;
+  }
+
   ezOpenDdlReader reader;
-  if (reader.ParseDocument(stream, 0, ezLog::GetThreadLocalLogSystem()).Failed())
+  if (reader.ParseDocument(peekStream, 0, ezLog::GetThreadLocalLogSystem()).Failed())
   {
     ezLog::Error("Failed to parse DDL graph");
     return EZ_FAILURE;
@@ -232,8 +940,15 @@ ezResult ezAbstractGraphDdlSerializer::Read(const ezOpenDdlReaderElement* pRootE
 
 ezResult ezAbstractGraphDdlSerializer::ReadBlocks(ezStreamReader& stream, ezHybridArray<ezSerializedBlock, 3>& blocks)
 {
+  PeekStreamReader peekStream(stream);
+  if (peekStream.IsBinaryDdl())
+  {
+    BinaryDdlReader reader;
+    return reader.Read(stream, [&](const char* szName) -> ezAbstractObjectGraph* { return GetOrCreateBlock(blocks, szName)->m_Graph.Borrow(); });
+  }
+
   ezOpenDdlReader reader;
-  if (reader.ParseDocument(stream, 0, ezLog::GetThreadLocalLogSystem()).Failed())
+  if (reader.ParseDocument(peekStream, 0, ezLog::GetThreadLocalLogSystem()).Failed())
   {
     ezLog::Error("Failed to parse DDL graph");
     return EZ_FAILURE;
@@ -269,6 +984,19 @@ void ezAbstractGraphDdlSerializer::WriteDocument(ezStreamWriter& stream, const e
   WriteGraph(writer, pTypes, "Types");
 }
 
+void ezAbstractGraphDdlSerializer::WriteDocumentBinary(ezStreamWriter& stream, const ezAbstractObjectGraph* pHeader, const ezAbstractObjectGraph* pGraph, const ezAbstractObjectGraph* pTypes)
+{
+  ezStringBuilder sHeaderVersion;
+  sHeaderVersion.Format("HeaderV{0}", (int)EZ_DOCUMENT_VERSION);
+
+  // the header has to be the first block, ReadHeader() only reads that
+  BinaryDdlWriter writer;
+  writer.AddGraph(pHeader, sHeaderVersion);
+  writer.AddGraph(pGraph, "Objects");
+  writer.AddGraph(pTypes, "Types");
+  writer.WriteTo(stream);
+}
+
 ezResult ezAbstractGraphDdlSerializer::ReadDocument(ezStreamReader& stream, ezUniquePtr<ezAbstractObjectGraph>& pHeader,
   ezUniquePtr<ezAbstractObjectGraph>& pGraph, ezUniquePtr<ezAbstractObjectGraph>& pTypes, bool bApplyPatches)
 {
@@ -422,8 +1150,16 @@ public:
 
 ezResult ezAbstractGraphDdlSerializer::ReadHeader(ezStreamReader& stream, ezAbstractObjectGraph* pGraph)
 {
+  PeekStreamReader peekStream(stream);
+  if (peekStream.IsBinaryDdl())
+  {
+    // binary files are always written with the header in the first block
+    BinaryDdlReader binaryReader;
+    return binaryReader.Read(stream, [&](const char*) { return pGraph; }, 1);
+  }
+
   HeaderReader reader;
-  if (reader.ParseDocument(stream, 0, ezLog::GetThreadLocalLogSystem()).Failed())
+  if (reader.ParseDocument(peekStream, 0, ezLog::GetThreadLocalLogSystem()).Failed())
   {
     EZ_REPORT_FAILURE("Failed to parse DDL graph");
     return EZ_FAILURE;
@@ -377,12 +377,22 @@ namespace
 
   static void CloneProperties(const void* pObject, void* pClone, const ezRTTI* pType)
   {
-    if (pType->GetParentType())
-      CloneProperties(pObject, pClone, pType->GetParentType());
+    const ezSerializationPlan& plan = pType->GetSerializationPlan();
+    const ezUInt32 uiNumProperties = plan.GetProperties().GetCount();
 
-    for (auto* pProp : pType->GetProperties())
+    for (ezUInt32 i = 0; i < uiNumProperties;)
     {
-      CloneProperty(pObject, pClone, pProp);
+      // consecutive plain members are copied at once, everything else goes through the property
+      const ezUInt32 uiNumCopied = plan.CopyRun(i, pObject, pClone);
+      if (uiNumCopied > 0)
+      {
+        i += uiNumCopied;
+      }
+      else
+      {
+        CloneProperty(pObject, pClone, plan.GetProperties()[i].m_pProperty);
+        ++i;
+      }
     }
   }
 } // namespace
@@ -5,6 +5,32 @@
 #include <Foundation/Serialization/RttiConverter.h>
 #include <Foundation/Types/VariantTypeRegistry.h>
 
+namespace
+{
+  /// The properties of a node are usually stored in the same order as in the serialization plan,
+  /// so the search starts after the previously found property.
+  const ezAbstractObjectNode::Property* FindNodeProperty(const ezAbstractObjectNode* pNode, const char* szName, ezUInt32& inout_uiSearchStart)
+  {
+    const auto& properties = pNode->GetProperties();
+    const ezUInt32 uiNumProperties = properties.GetCount();
+
+    for (ezUInt32 i = 0; i < uiNumProperties; ++i)
+    {
+      ezUInt32 uiIndex = inout_uiSearchStart + i;
+      if (uiIndex >= uiNumProperties)
+        uiIndex -= uiNumProperties;
+
+      if (ezStringUtils::IsEqual(properties[uiIndex].m_szPropertyName, szName))
+      {
+        inout_uiSearchStart = uiIndex + 1;
+        return &properties[uiIndex];
+      }
+    }
+
+    return nullptr;
+  }
+} // namespace
+
 ezRttiConverterReader::ezRttiConverterReader(const ezAbstractObjectGraph* pGraph, ezRttiConverterContext* pContext)
 {
   m_pGraph = pGraph;
@@ -34,16 +60,24 @@ void ezRttiConverterReader::ApplyPropertiesToObject(const ezAbstractObjectNode*
 {
   EZ_ASSERT_DEBUG(pNode != nullptr, "Invalid node");
 
-  if (pRtti->GetParentType() != nullptr)
-    ApplyPropertiesToObject(pNode, pRtti->GetParentType(), pObject);
-
-  for (auto* prop : pRtti->GetProperties())
+  ezUInt32 uiSearchStart = 0;
+  for (const ezSerializationPlan::Property& prop : pRtti->GetSerializationPlan().GetProperties())
   {
-    auto* pOtherProp = pNode->FindProperty(prop->GetPropertyName());
+    auto* pOtherProp = FindNodeProperty(pNode, prop.m_pProperty->GetPropertyName(), uiSearchStart);
     if (pOtherProp == nullptr)
       continue;
 
-    ApplyProperty(pObject, prop, pOtherProp);
+    if (prop.HasDirectAccess())
+    {
+      if (!prop.m_pProperty->GetFlags().IsSet(ezPropertyFlags::ReadOnly))
+      {
+        prop.WriteDirect(pObject, pOtherProp->m_Value);
+      }
+    }
+    else
+    {
+      ApplyProperty(pObject, prop.m_pProperty, pOtherProp);
+    }
   }
 }
 
@@ -430,12 +430,19 @@ void ezRttiConverterWriter::AddProperty(ezAbstractObjectNode* pNode, const ezAbs
 
 void ezRttiConverterWriter::AddProperties(ezAbstractObjectNode* pNode, const ezRTTI* pRtti, const void* pObject)
 {
-  if (pRtti->GetParentType())
-    AddProperties(pNode, pRtti->GetParentType(), pObject);
-
-  for (const auto* pProp : pRtti->GetProperties())
+  for (const ezSerializationPlan::Property& prop : pRtti->GetSerializationPlan().GetProperties())
   {
-    AddProperty(pNode, pProp, pObject);
+    if (prop.HasDirectAccess())
+    {
+      if (m_Filter(pObject, prop.m_pProperty))
+      {
+        pNode->AddProperty(prop.m_pProperty->GetPropertyName(), prop.ReadDirect(pObject));
+      }
+    }
+    else
+    {
+      AddProperty(pNode, prop.m_pProperty, pObject);
+    }
   }
 }
 
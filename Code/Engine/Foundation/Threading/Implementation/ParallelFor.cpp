@@ -22,7 +22,7 @@ public:
 
   void ExecuteWithMultiplicity(ezUInt32 uiInvocation) const override
   {
-    const ezUInt32 uiSliceStartIndex = uiInvocation * m_uiItemsPerInvocation;
+    const ezUInt32 uiSliceStartIndex = m_uiStartIndex + uiInvocation * m_uiItemsPerInvocation;
     const ezUInt32 uiSliceEndIndex = ezMath::Min(uiSliceStartIndex + m_uiItemsPerInvocation, m_uiStartIndex + m_uiNumItems);
 
     // Run through the calculated slice, the end index is exclusive, i.e., should not be handled by this instance.
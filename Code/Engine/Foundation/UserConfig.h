@@ -79,4 +79,9 @@
 //#undef EZ_USE_GUARDED_ALLOCATIONS
 //#define EZ_USE_GUARDED_ALLOCATIONS EZ_ON
 
+// Uncomment to use the thread caching heap (ezThreadCachingHeapAllocator) for the default and aligned allocators.
+// Memory that the heap keeps cached for reuse shows up as 'Page' allocations in memory leak reports.
+//#undef EZ_USE_THREAD_CACHING_ALLOCATIONS
+//#define EZ_USE_THREAD_CACHING_ALLOCATIONS EZ_ON
+
 #endif
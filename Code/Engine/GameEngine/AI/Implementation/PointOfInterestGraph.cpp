@@ -1,7 +1,281 @@
 #include <GameEngine/GameEnginePCH.h>
 
+#include <Foundation/Algorithm/Sorting.h>
 #include <GameEngine/AI/PointOfInterestGraph.h>
 
+namespace
+{
+  constexpr ezUInt32 MaxCellsPerAxis = 1024;
+
+  // the bits of the cell code that belong to the x axis, y and z are shifted by one and two bits
+  constexpr ezUInt32 AxisMaskX = 0x09249249u;
+
+  EZ_ALWAYS_INLINE ezUInt32 SpreadBits(ezUInt32 v)
+  {
+    v &= 0x3FF;
+    v = (v | (v << 16)) & 0x030000FF;
+    v = (v | (v << 8)) & 0x0300F00F;
+    v = (v | (v << 4)) & 0x030C30C3;
+    v = (v | (v << 2)) & 0x09249249;
+    return v;
+  }
+
+  EZ_ALWAYS_INLINE ezUInt32 ComputeMortonCode(ezUInt32 x, ezUInt32 y, ezUInt32 z)
+  {
+    return SpreadBits(x) | (SpreadBits(y) << 1) | (SpreadBits(z) << 2);
+  }
+
+  EZ_ALWAYS_INLINE bool IsCodeInBox(ezUInt32 uiCode, ezUInt32 uiMinCode, ezUInt32 uiMaxCode)
+  {
+    // the bits of one axis can be compared directly, without decoding the cell coordinates
+    for (ezUInt32 axis = 0; axis < 3; ++axis)
+    {
+      const ezUInt32 mask = AxisMaskX << axis;
+      if ((uiCode & mask) < (uiMinCode & mask) || (uiCode & mask) > (uiMaxCode & mask))
+        return false;
+    }
+
+    return true;
+  }
+
+  /// Returns the smallest code that is larger than uiCode and inside the box given by its min and max code.
+  /// uiCode must be between the min and max code, but outside of the box. This is the BIGMIN computation by Tropf and Herzog.
+  ezUInt32 ComputeNextCodeInBox(ezUInt32 uiCode, ezUInt32 uiMinCode, ezUInt32 uiMaxCode)
+  {
+    ezUInt32 uiNextCode = uiMaxCode;
+
+    for (ezInt32 bit = 29; bit >= 0; --bit)
+    {
+      const ezUInt32 mask = 1u << bit;
+      const ezUInt32 lowerBitsOfAxis = (AxisMaskX << (bit % 3)) & (mask - 1);
+
+      const ezUInt32 uiCase = ((uiCode & mask) ? 4 : 0) | ((uiMinCode & mask) ? 2 : 0) | ((uiMaxCode & mask) ? 1 : 0);
+
+      switch (uiCase)
+      {
+        case 0b001:
+          // the box spans this bit, continue in the lower half, but remember the start of the upper half
+          uiNextCode = (uiMinCode & ~lowerBitsOfAxis) | mask;
+          uiMaxCode = (uiMaxCode & ~mask) | lowerBitsOfAxis;
+          break;
+
+        case 0b011:
+          return uiMinCode;
+
+        case 0b100:
+          return uiNextCode;
+
+        case 0b101:
+          // continue in the upper half
+          uiMinCode = (uiMinCode & ~lowerBitsOfAxis) | mask;
+          break;
+
+        case 0b000:
+        case 0b111:
+          break;
+
+        default:
+          // min code is larger than max code in this bit, can't happen for a valid box
+          return uiNextCode;
+      }
+    }
+
+    return uiNextCode;
+  }
+
+  ezUInt32 LowerBound(const ezDynamicArray<ezUInt32>& values, ezUInt32 uiStart, ezUInt32 uiValue)
+  {
+    ezUInt32 uiEnd = values.GetCount();
+
+    while (uiStart < uiEnd)
+    {
+      const ezUInt32 uiMiddle = uiStart + (uiEnd - uiStart) / 2;
+
+      if (values[uiMiddle] < uiValue)
+        uiStart = uiMiddle + 1;
+      else
+        uiEnd = uiMiddle;
+    }
+
+    return uiStart;
+  }
+} // namespace
+
+ezPointOfInterestCells::ezPointOfInterestCells() = default;
+ezPointOfInterestCells::~ezPointOfInterestCells() = default;
+
+void ezPointOfInterestCells::Initialize(const ezVec3& vCenter, const ezVec3& vHalfExtents, float fCellSize)
+{
+  const ezVec3 vSize = vHalfExtents.CompMax(ezVec3::ZeroVector()) * 2.0f;
+  const float fMaxSize = ezMath::Max(vSize.x, vSize.y, vSize.z);
+
+  fCellSize = ezMath::Max(fCellSize, fMaxSize / MaxCellsPerAxis, ezMath::SmallEpsilon<float>());
+
+  m_vGridOrigin = vCenter - vHalfExtents.CompMax(ezVec3::ZeroVector());
+  m_fInvCellSize = 1.0f / fCellSize;
+
+  for (ezUInt32 axis = 0; axis < 3; ++axis)
+  {
+    m_uiMaxCell[axis] = ezMath::Clamp<ezUInt32>((ezUInt32)ezMath::Ceil(vSize.GetData()[axis] * m_fInvCellSize), 1, MaxCellsPerAxis) - 1;
+  }
+
+  m_Positions.Clear();
+  m_SortedPoints.Clear();
+  m_CellCodes.Clear();
+  m_CellOffsets.Clear();
+  m_bNeedsSorting = false;
+}
+
+void ezPointOfInterestCells::AddPoint(const ezVec3& vPosition)
+{
+  m_Positions.PushBack(vPosition);
+  m_bNeedsSorting = true;
+}
+
+void ezPointOfInterestCells::FindPointsInRadius(const ezVec3& vPosition, float fRadius, ezDynamicArray<ezUInt32>& out_Points) const
+{
+  EnsureSorted();
+
+  FindPointsInRadiusInternal(vPosition, fRadius, out_Points);
+}
+
+void ezPointOfInterestCells::FindPointsInRadius(ezArrayPtr<const ezBoundingSphere> queries, ezDynamicArray<ezUInt32>& out_Points, ezDynamicArray<QueryResult>& out_Results) const
+{
+  EnsureSorted();
+
+  out_Points.Clear();
+  out_Results.SetCountUninitialized(queries.GetCount());
+
+  // execute the queries in the order of their cells, so that neighboring queries mostly find the same points
+  ezDynamicArray<ezUInt64> order;
+  order.SetCountUninitialized(queries.GetCount());
+
+  for (ezUInt32 i = 0; i < queries.GetCount(); ++i)
+  {
+    order[i] = (static_cast<ezUInt64>(ComputeCellCode(queries[i].m_vCenter)) << 32) | i;
+  }
+
+  ezSorting::QuickSort(order, ezCompareHelper<ezUInt64>());
+
+  for (ezUInt64 uiOrder : order)
+  {
+    const ezUInt32 uiQuery = static_cast<ezUInt32>(uiOrder);
+
+    QueryResult& result = out_Results[uiQuery];
+    result.m_uiFirstPoint = out_Points.GetCount();
+
+    FindPointsInRadiusInternal(queries[uiQuery].m_vCenter, queries[uiQuery].m_fRadius, out_Points);
+
+    result.m_uiNumPoints = out_Points.GetCount() - result.m_uiFirstPoint;
+  }
+}
+
+void ezPointOfInterestCells::EnsureSorted() const
+{
+  if (!m_bNeedsSorting)
+    return;
+
+  EZ_LOCK(m_SortMutex);
+
+  if (m_bNeedsSorting)
+  {
+    // sorting only changes the acceleration structure, not the points, so the graph is still logically const
+    const_cast<ezPointOfInterestCells*>(this)->Sort();
+    m_bNeedsSorting = false;
+  }
+}
+
+void ezPointOfInterestCells::Sort()
+{
+  const ezUInt32 uiNumPoints = m_Positions.GetCount();
+
+  ezDynamicArray<ezUInt64> order;
+  order.SetCountUninitialized(uiNumPoints);
+
+  for (ezUInt32 i = 0; i < uiNumPoints; ++i)
+  {
+    order[i] = (static_cast<ezUInt64>(ComputeCellCode(m_Positions[i])) << 32) | i;
+  }
+
+  // sorting by code and index keeps points in the same cell in the order in which they were added
+  ezSorting::QuickSort(order, ezCompareHelper<ezUInt64>());
+
+  m_SortedPoints.SetCountUninitialized(uiNumPoints);
+  m_CellCodes.Clear();
+  m_CellOffsets.Clear();
+
+  for (ezUInt32 i = 0; i < uiNumPoints; ++i)
+  {
+    const ezUInt32 uiCode = static_cast<ezUInt32>(order[i] >> 32);
+    const ezUInt32 uiPointIndex = static_cast<ezUInt32>(order[i]);
+
+    if (m_CellCodes.IsEmpty() || m_CellCodes.PeekBack() != uiCode)
+    {
+      m_CellCodes.PushBack(uiCode);
+      m_CellOffsets.PushBack(i);
+    }
+
+    m_SortedPoints[i].m_vPosition = m_Positions[uiPointIndex];
+    m_SortedPoints[i].m_uiPointIndex = uiPointIndex;
+  }
+
+  m_CellOffsets.PushBack(uiNumPoints);
+}
+
+ezUInt32 ezPointOfInterestCells::ComputeCellCode(const ezVec3& vPosition) const
+{
+  const ezVec3 vCell = (vPosition - m_vGridOrigin) * m_fInvCellSize;
+
+  ezUInt32 uiCell[3];
+  for (ezUInt32 axis = 0; axis < 3; ++axis)
+  {
+    // points outside of the grid go into the border cells
+    uiCell[axis] = static_cast<ezUInt32>(ezMath::Clamp(vCell.GetData()[axis], 0.0f, static_cast<float>(m_uiMaxCell[axis])));
+  }
+
+  return ComputeMortonCode(uiCell[0], uiCell[1], uiCell[2]);
+}
+
+void ezPointOfInterestCells::FindPointsInRadiusInternal(const ezVec3& vPosition, float fRadius, ezDynamicArray<ezUInt32>& out_Points) const
+{
+  if (m_CellCodes.IsEmpty() || fRadius < 0.0f)
+    return;
+
+  const ezUInt32 uiMinCode = ComputeCellCode(vPosition - ezVec3(fRadius));
+  const ezUInt32 uiMaxCode = ComputeCellCode(vPosition + ezVec3(fRadius));
+  const float fRadiusSquared = fRadius * fRadius;
+
+  const ezUInt32 uiNumCells = m_CellCodes.GetCount();
+  ezUInt32 uiCell = LowerBound(m_CellCodes, 0, uiMinCode);
+
+  while (uiCell < uiNumCells)
+  {
+    const ezUInt32 uiCode = m_CellCodes[uiCell];
+    if (uiCode > uiMaxCode)
+      break;
+
+    if (!IsCodeInBox(uiCode, uiMinCode, uiMaxCode))
+    {
+      // skip all occupied cells up to the next one that can be inside of the box
+      uiCell = LowerBound(m_CellCodes, uiCell + 1, ComputeNextCodeInBox(uiCode, uiMinCode, uiMaxCode));
+      continue;
+    }
+
+    const SortedPoint* pPoints = m_SortedPoints.GetData();
+    for (ezUInt32 i = m_CellOffsets[uiCell]; i < m_CellOffsets[uiCell + 1]; ++i)
+    {
+      if ((pPoints[i].m_vPosition - vPosition).GetLengthSquared() <= fRadiusSquared)
+      {
+        out_Points.PushBack(pPoints[i].m_uiPointIndex);
+      }
+    }
+
+    ++uiCell;
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////
+
 struct ezDummyPointType
 {
   EZ_DECLARE_POD_TYPE();
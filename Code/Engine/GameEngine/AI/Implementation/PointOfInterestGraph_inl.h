@@ -6,16 +6,15 @@ template <typename POINTTYPE>
 void ezPointOfInterestGraph<POINTTYPE>::Initialize(const ezVec3& center, const ezVec3& halfExtents, float cellSize)
 {
   m_Points.Clear();
-  m_Octree.CreateTree(center, halfExtents, cellSize);
+  m_Cells.Initialize(center, halfExtents, cellSize);
 }
 
 template <typename POINTTYPE>
 POINTTYPE& ezPointOfInterestGraph<POINTTYPE>::AddPoint(const ezVec3& position)
 {
-  const ezUInt32 id = m_Points.GetCount();
   auto& pt = m_Points.ExpandAndGetRef();
 
-  m_Octree.InsertObject(position, ezVec3::ZeroVector(), 0, id, nullptr, true).IgnoreResult();
+  m_Cells.AddPoint(position);
 
   return pt;
 }
@@ -23,25 +22,11 @@ POINTTYPE& ezPointOfInterestGraph<POINTTYPE>::AddPoint(const ezVec3& position)
 template <typename POINTTYPE>
 void ezPointOfInterestGraph<POINTTYPE>::FindPointsOfInterest(const ezVec3& position, float radius, ezDynamicArray<ezUInt32>& out_Points) const
 {
-  if (m_Octree.IsEmpty())
-    return;
-
-  struct Data
-  {
-    ezDynamicArray<ezUInt32>* m_pResults;
-  };
-
-  Data data;
-  data.m_pResults = &out_Points;
-
-  auto cb = [](void* pPassThrough, ezDynamicTreeObjectConst Object) -> bool {
-    auto pData = static_cast<Data*>(pPassThrough);
-
-    const ezUInt32 id = (ezUInt32)Object.Value().m_iObjectInstance;
-    pData->m_pResults->PushBack(id);
-
-    return true;
-  };
+  m_Cells.FindPointsInRadius(position, radius, out_Points);
+}
 
-  m_Octree.FindObjectsInRange(position, radius, cb, &data);
+template <typename POINTTYPE>
+void ezPointOfInterestGraph<POINTTYPE>::FindPointsOfInterest(ezArrayPtr<const ezBoundingSphere> queries, ezDynamicArray<ezUInt32>& out_Points, ezDynamicArray<QueryResult>& out_Results) const
+{
+  m_Cells.FindPointsInRadius(queries, out_Points, out_Results);
 }
@@ -576,72 +576,252 @@ void ezSensorWorldModule::UpdateSensors(const ezWorldModule::UpdateContext& cont
   if (m_pPhysicsWorldModule == nullptr)
     return;
 
+  m_uiNumSensorWork = 0;
+
   const ezTime deltaTime = GetWorld()->GetClock().GetTimeDiff();
   m_Scheduler.Update(deltaTime, [this](const ezComponentHandle& hComponent, ezTime deltaTime) {
-    const ezWorld* pWorld = GetWorld();
     const ezSensorComponent* pSensorComponent = nullptr;
-    EZ_VERIFY(pWorld->TryGetComponent(hComponent, pSensorComponent), "Invalid component handle");
+    EZ_VERIFY(GetWorld()->TryGetComponent(hComponent, pSensorComponent), "Invalid component handle");
 
-#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
-    pSensorComponent->m_LastOccludedObjectPositions.Clear();
-#endif
+    if (m_uiNumSensorWork == m_SensorWork.GetCount())
+    {
+      m_SensorWork.ExpandAndGetRef();
+    }
 
-    m_ObjectsInSensorVolume.Clear();
+    m_SensorWork[m_uiNumSensorWork++].m_pSensor = pSensorComponent; });
 
-    pSensorComponent->GetObjectsInSensorVolume(m_ObjectsInSensorVolume);
-    const ezGameObject* pSensorOwner = pSensorComponent->GetOwner();
+  if (m_uiNumSensorWork > 0)
+  {
+    ezParallelForParams parallelForParams;
+    parallelForParams.uiBinSize = 16;
+
+    ezTaskSystem::ParallelForIndexed(
+      0, m_uiNumSensorWork, [this](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) { GatherSensorCandidates(uiStartIndex, uiEndIndex); },
+      "Sensor Volume Queries", parallelForParams);
+
+    TraceVisibilityRays();
 
-    m_DetectedObjects.Clear();
+    ezTaskSystem::ParallelForIndexed(
+      0, m_uiNumSensorWork, [this](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) { ApplySensorResults(uiStartIndex, uiEndIndex); },
+      "Sensor Results", parallelForParams);
+  }
+
+  RemoveOutdatedVisibilityCacheEntries();
+}
 
-    if (pSensorComponent->m_bTestVisibility)
+void ezSensorWorldModule::GatherSensorCandidates(ezUInt32 uiStartIndex, ezUInt32 uiEndIndex)
+{
+  // the cache is only read here, it is written in TraceVisibilityRays() on a single thread
+  const auto& visibilityCache = m_VisibilityCache;
+  const bool bUseCache = m_VisibilityCacheDuration.IsPositive();
+  const ezTime now = GetWorld()->GetClock().GetAccumulatedTime();
+
+  constexpr float fMovementTolerance = 0.01f;
+
+  for (ezUInt32 i = uiStartIndex; i < uiEndIndex; ++i)
+  {
+    SensorWork& work = m_SensorWork[i];
+    const ezSensorComponent* pSensorComponent = work.m_pSensor;
+
+    work.m_vSensorPos = pSensorComponent->GetOwner()->GetGlobalPosition();
+    work.m_Objects.Clear();
+    work.m_Visibility.Clear();
+
+    pSensorComponent->GetObjectsInSensorVolume(work.m_Objects);
+
+    if (!pSensorComponent->m_bTestVisibility)
+      continue;
+
+    work.m_Visibility.SetCountUninitialized(work.m_Objects.GetCount());
+
+    for (ezUInt32 j = 0; j < work.m_Objects.GetCount(); ++j)
     {
-      const ezVec3 rayStart = pSensorOwner->GetGlobalPosition();
-      for (auto pObject : m_ObjectsInSensorVolume)
+      const ezGameObject* pObject = work.m_Objects[j];
+      Visibility visibility = Visibility::NeedsRaycast;
+
+      if (bUseCache)
       {
-        const ezVec3 rayEnd = pObject->GetGlobalPosition();
-        ezVec3 rayDir = rayEnd - rayStart;
-        const float fDistance = rayDir.GetLengthAndNormalize();
+        const VisibilityCacheEntry* pEntry = visibilityCache.GetValue(VisibilityKey{pSensorComponent->GetHandle(), pObject->GetHandle()});
+
+        if (pEntry != nullptr && now - pEntry->m_Time < m_VisibilityCacheDuration && pEntry->m_vSensorPos.IsEqual(work.m_vSensorPos, fMovementTolerance) &&
+            pEntry->m_vTargetPos.IsEqual(pObject->GetGlobalPosition(), fMovementTolerance))
+        {
+          visibility = pEntry->m_bVisible ? Visibility::Visible : Visibility::Occluded;
+        }
+      }
 
-        ezPhysicsCastResult hitResult;
-        ezPhysicsQueryParameters params(pSensorComponent->m_uiCollisionLayer);
-        params.m_bIgnoreInitialOverlap = true;
-        params.m_ShapeTypes = ezPhysicsShapeType::Default;
+      work.m_Visibility[j] = visibility;
+    }
+  }
+}
 
-        // TODO: probably best to expose the ezPhysicsShapeType bitflags on the component
-        params.m_ShapeTypes.Remove(ezPhysicsShapeType::Rope);
-        params.m_ShapeTypes.Remove(ezPhysicsShapeType::Ragdoll);
+void ezSensorWorldModule::TraceVisibilityRays()
+{
+  for (RayBatch& batch : m_RayBatches)
+  {
+    batch.m_Rays.Clear();
+    batch.m_RaySensors.Clear();
+    batch.m_RayObjects.Clear();
+  }
+
+  // collect the rays of all sensors, one batch per collision layer
+  for (ezUInt32 i = 0; i < m_uiNumSensorWork; ++i)
+  {
+    SensorWork& work = m_SensorWork[i];
+    const ezUInt8 uiCollisionLayer = work.m_pSensor->m_uiCollisionLayer;
 
-        if (m_pPhysicsWorldModule->Raycast(hitResult, rayStart, rayDir, fDistance, params))
+    RayBatch* pBatch = nullptr;
+
+    for (ezUInt32 j = 0; j < work.m_Visibility.GetCount(); ++j)
+    {
+      if (work.m_Visibility[j] != Visibility::NeedsRaycast)
+        continue;
+
+      ezPhysicsRaycastRequest ray;
+      ray.m_vStart = work.m_vSensorPos;
+      ray.m_vDir = work.m_Objects[j]->GetGlobalPosition() - work.m_vSensorPos;
+      ray.m_fDistance = ray.m_vDir.GetLengthAndNormalize();
+
+      if (ray.m_fDistance <= 0.0f)
+      {
+        // the target is at the sensor position, nothing can be in between
+        work.m_Visibility[j] = Visibility::Visible;
+        continue;
+      }
+
+      if (pBatch == nullptr)
+      {
+        for (RayBatch& batch : m_RayBatches)
         {
-          // hit something in between -> not visible
-#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
-          pSensorComponent->m_LastOccludedObjectPositions.PushBack(rayEnd);
-#endif
+          if (batch.m_uiCollisionLayer == uiCollisionLayer)
+          {
+            pBatch = &batch;
+            break;
+          }
+        }
 
-          continue;
+        if (pBatch == nullptr)
+        {
+          pBatch = &m_RayBatches.ExpandAndGetRef();
+          pBatch->m_uiCollisionLayer = uiCollisionLayer;
         }
+      }
 
-        m_DetectedObjects.PushBack(pObject->GetHandle());
+      pBatch->m_Rays.PushBack(ray);
+      pBatch->m_RaySensors.PushBack(i);
+      pBatch->m_RayObjects.PushBack(j);
+    }
+  }
+
+  const bool bUseCache = m_VisibilityCacheDuration.IsPositive();
+  const ezTime now = GetWorld()->GetClock().GetAccumulatedTime();
+
+  for (RayBatch& batch : m_RayBatches)
+  {
+    const ezUInt32 uiNumRays = batch.m_Rays.GetCount();
+    if (uiNumRays == 0)
+      continue;
+
+    ezPhysicsQueryParameters params(batch.m_uiCollisionLayer);
+    params.m_bIgnoreInitialOverlap = true;
+    params.m_ShapeTypes = ezPhysicsShapeType::Default;
+
+    // TODO: probably best to expose the ezPhysicsShapeType bitflags on the component
+    params.m_ShapeTypes.Remove(ezPhysicsShapeType::Rope);
+    params.m_ShapeTypes.Remove(ezPhysicsShapeType::Ragdoll);
+
+    batch.m_Results.SetCount(uiNumRays);
+    batch.m_Hits.SetCount(uiNumRays);
+
+    // any hit in between means the target is not visible, the closest one is not needed
+    m_pPhysicsWorldModule->RaycastBatch(batch.m_Rays, batch.m_Results, batch.m_Hits, params, ezPhysicsHitCollection::Any);
+
+    for (ezUInt32 r = 0; r < uiNumRays; ++r)
+    {
+      SensorWork& work = m_SensorWork[batch.m_RaySensors[r]];
+      const ezUInt32 uiObject = batch.m_RayObjects[r];
+      const bool bVisible = !batch.m_Hits[r];
+
+      work.m_Visibility[uiObject] = bVisible ? Visibility::Visible : Visibility::Occluded;
+
+      if (bUseCache)
+      {
+        const ezGameObject* pObject = work.m_Objects[uiObject];
+
+        VisibilityCacheEntry& entry = m_VisibilityCache[VisibilityKey{work.m_pSensor->GetHandle(), pObject->GetHandle()}];
+        entry.m_vSensorPos = work.m_vSensorPos;
+        entry.m_vTargetPos = pObject->GetGlobalPosition();
+        entry.m_Time = now;
+        entry.m_bVisible = bVisible;
       }
     }
-    else
+  }
+}
+
+void ezSensorWorldModule::ApplySensorResults(ezUInt32 uiStartIndex, ezUInt32 uiEndIndex)
+{
+  for (ezUInt32 i = uiStartIndex; i < uiEndIndex; ++i)
+  {
+    SensorWork& work = m_SensorWork[i];
+    const ezSensorComponent* pSensorComponent = work.m_pSensor;
+    const bool bTestVisibility = pSensorComponent->m_bTestVisibility;
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+    pSensorComponent->m_LastOccludedObjectPositions.Clear();
+#endif
+
+    work.m_DetectedObjects.Clear();
+
+    for (ezUInt32 j = 0; j < work.m_Objects.GetCount(); ++j)
     {
-      for (auto pObject : m_ObjectsInSensorVolume)
+      const ezGameObject* pObject = work.m_Objects[j];
+
+      if (bTestVisibility && work.m_Visibility[j] != Visibility::Visible)
       {
-        m_DetectedObjects.PushBack(pObject->GetHandle());
+        // hit something in between -> not visible
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+        pSensorComponent->m_LastOccludedObjectPositions.PushBack(pObject->GetGlobalPosition());
+#endif
+
+        continue;
       }
+
+      work.m_DetectedObjects.PushBack(pObject->GetHandle());
     }
 
-    m_DetectedObjects.Sort();
-    if (m_DetectedObjects != pSensorComponent->m_LastDetectedObjects)
+    work.m_DetectedObjects.Sort();
+    if (work.m_DetectedObjects != pSensorComponent->m_LastDetectedObjects)
     {
-      m_DetectedObjects.Swap(pSensorComponent->m_LastDetectedObjects);
+      work.m_DetectedObjects.Swap(pSensorComponent->m_LastDetectedObjects);
 
       ezMsgSensorDetectedObjectsChanged msg;
       msg.m_DetectedObjects = pSensorComponent->m_LastDetectedObjects;
 
-      pSensorOwner->PostEventMessage(msg, pSensorComponent, ezTime::Zero(), ezObjectMsgQueueType::PostAsync);
-    } });
+      pSensorComponent->GetOwner()->PostEventMessage(msg, pSensorComponent, ezTime::Zero(), ezObjectMsgQueueType::PostAsync);
+    }
+  }
+}
+
+void ezSensorWorldModule::RemoveOutdatedVisibilityCacheEntries()
+{
+  const ezTime now = GetWorld()->GetClock().GetAccumulatedTime();
+
+  if (m_VisibilityCache.IsEmpty() || now - m_LastVisibilityCacheCleanup < m_VisibilityCacheDuration)
+    return;
+
+  m_LastVisibilityCacheCleanup = now;
+
+  for (auto it = m_VisibilityCache.GetIterator(); it.IsValid();)
+  {
+    if (now - it.Value().m_Time >= m_VisibilityCacheDuration)
+    {
+      it = m_VisibilityCache.Remove(it);
+    }
+    else
+    {
+      ++it;
+    }
+  }
 }
 
 void ezSensorWorldModule::DebugDrawSensors(const ezWorldModule::UpdateContext& context)
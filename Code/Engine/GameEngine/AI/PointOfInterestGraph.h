@@ -1,25 +1,105 @@
 #pragma once
 
+#include <Foundation/Containers/Deque.h>
+#include <Foundation/Math/BoundingSphere.h>
 #include <Foundation/Math/Vec3.h>
+#include <Foundation/Threading/AtomicInteger.h>
+#include <Foundation/Threading/Mutex.h>
 #include <GameEngine/GameEngineDLL.h>
-#include <Utilities/DataStructures/DynamicOctree.h>
+
+/// \brief Sorts points into a uniform grid of cells for fast radius queries. This is what ezPointOfInterestGraph uses internally.
+///
+/// The points are stored sorted by the Morton code (Z-order) of their cell, so points in the same cell and in neighboring cells are
+/// close to each other in memory. Only occupied cells are stored, as a sorted table of cell codes with the offset of their first point.
+/// A query walks through the occupied cells in the code range of its bounding box and jumps over the parts of that range that are outside
+/// of the box, so the cost mostly depends on the number of occupied cells that overlap the query, not on the size of the grid.
+///
+/// Points that are added after a query are sorted in on the next query. This is thread-safe, so many threads may query at the same time,
+/// but adding points must not happen concurrently with queries.
+class EZ_GAMEENGINE_DLL ezPointOfInterestCells
+{
+public:
+  /// \brief The range of points in the result array that belong to one query of a batch.
+  struct QueryResult
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezUInt32 m_uiFirstPoint = 0;
+    ezUInt32 m_uiNumPoints = 0;
+  };
+
+  ezPointOfInterestCells();
+  ~ezPointOfInterestCells();
+
+  /// \brief Removes all points and sets up the grid. Points outside of the given box are still found, but they are all stored in the border cells.
+  ///
+  /// The grid has at most 1024 cells along each axis, for large boxes the cell size is increased accordingly.
+  void Initialize(const ezVec3& vCenter, const ezVec3& vHalfExtents, float fCellSize);
+
+  /// \brief Adds a point. Points are identified by the order in which they were added.
+  void AddPoint(const ezVec3& vPosition);
+
+  ezUInt32 GetNumPoints() const { return m_Positions.GetCount(); }
+
+  /// \brief Appends the indices of all points within the radius around the position to out_Points.
+  void FindPointsInRadius(const ezVec3& vPosition, float fRadius, ezDynamicArray<ezUInt32>& out_Points) const;
+
+  /// \brief Runs many queries at once.
+  ///
+  /// The queries are executed in the order of their cells, so that consecutive queries mostly access the same memory.
+  /// out_Points is cleared and receives the results of all queries, out_Results receives the range of out_Points for each query, in the order of the queries.
+  void FindPointsInRadius(ezArrayPtr<const ezBoundingSphere> queries, ezDynamicArray<ezUInt32>& out_Points, ezDynamicArray<QueryResult>& out_Results) const;
+
+private:
+  struct SortedPoint
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezVec3 m_vPosition;
+    ezUInt32 m_uiPointIndex;
+  };
+
+  void EnsureSorted() const;
+  void Sort();
+
+  ezUInt32 ComputeCellCode(const ezVec3& vPosition) const;
+  void FindPointsInRadiusInternal(const ezVec3& vPosition, float fRadius, ezDynamicArray<ezUInt32>& out_Points) const;
+
+  ezVec3 m_vGridOrigin = ezVec3::ZeroVector();
+  float m_fInvCellSize = 1.0f;
+  ezUInt32 m_uiMaxCell[3] = {0, 0, 0};
+
+  ezDynamicArray<ezVec3> m_Positions; ///< All points in the order in which they were added.
+
+  ezDynamicArray<SortedPoint> m_SortedPoints; ///< All points, sorted by the code of their cell.
+  ezDynamicArray<ezUInt32> m_CellCodes;       ///< The codes of all occupied cells, in ascending order.
+  ezDynamicArray<ezUInt32> m_CellOffsets;     ///< The index of the first point of every occupied cell in m_SortedPoints, plus the total number of points.
+
+  mutable ezAtomicBool m_bNeedsSorting;
+  mutable ezMutex m_SortMutex;
+};
 
 template <typename POINTTYPE>
 class ezPointOfInterestGraph
 {
 public:
+  using QueryResult = ezPointOfInterestCells::QueryResult;
+
   void Initialize(const ezVec3& center, const ezVec3& halfExtents, float cellSize = 1.0f);
 
   POINTTYPE& AddPoint(const ezVec3& position);
 
   void FindPointsOfInterest(const ezVec3& position, float radius, ezDynamicArray<ezUInt32>& out_Points) const;
 
+  /// \brief Runs many radius queries at once, which is considerably faster than querying one by one. See ezPointOfInterestCells.
+  void FindPointsOfInterest(ezArrayPtr<const ezBoundingSphere> queries, ezDynamicArray<ezUInt32>& out_Points, ezDynamicArray<QueryResult>& out_Results) const;
+
   const ezDeque<POINTTYPE>& GetPoints() const { return m_Points; }
   ezDeque<POINTTYPE>& AccessPoints() { return m_Points; }
 
 private:
   ezDeque<POINTTYPE> m_Points;
-  ezDynamicOctree m_Octree;
+  ezPointOfInterestCells m_Cells;
 };
 
 #include <GameEngine/AI/Implementation/PointOfInterestGraph_inl.h>
@@ -1,11 +1,10 @@
 #pragma once
 
+#include <Core/Interfaces/PhysicsWorldModule.h>
 #include <Core/Utils/IntervalScheduler.h>
 #include <Core/World/World.h>
 #include <GameEngine/GameEngineDLL.h>
 
-class ezPhysicsWorldModuleInterface;
-
 struct EZ_GAMEENGINE_DLL ezMsgSensorDetectedObjectsChanged : public ezEventMessage
 {
   EZ_DECLARE_MESSAGE_TYPE(ezMsgSensorDetectedObjectsChanged, ezEventMessage);
@@ -183,7 +182,12 @@ public:
 
 //////////////////////////////////////////////////////////////////////////
 
-class ezSensorWorldModule : public ezWorldModule
+/// \brief Updates all sensor components of a world.
+///
+/// All sensors that are due in a frame are updated in parallel on the task system. The visibility raycasts of all of them are collected
+/// and executed as batches (one per collision layer). The result of a visibility test is cached per sensor and target and reused as long
+/// as neither of the two moved and the result isn't older than the visibility cache duration.
+class EZ_GAMEENGINE_DLL ezSensorWorldModule : public ezWorldModule
 {
   EZ_DECLARE_WORLD_MODULE();
   EZ_ADD_DYNAMIC_REFLECTION(ezSensorWorldModule, ezWorldModule);
@@ -199,15 +203,85 @@ public:
   void AddComponentForDebugRendering(ezSensorComponent* pComponent);
   void RemoveComponentForDebugRendering(ezSensorComponent* pComponent);
 
+  /// \brief Sets for how long a visibility test result is reused, if neither the sensor nor the target moved. Zero disables the cache.
+  void SetVisibilityCacheDuration(ezTime duration) { m_VisibilityCacheDuration = duration; }
+  ezTime GetVisibilityCacheDuration() const { return m_VisibilityCacheDuration; }
+
 private:
   void UpdateSensors(const ezWorldModule::UpdateContext& context);
   void DebugDrawSensors(const ezWorldModule::UpdateContext& context);
 
+  void GatherSensorCandidates(ezUInt32 uiStartIndex, ezUInt32 uiEndIndex);
+  void TraceVisibilityRays();
+  void ApplySensorResults(ezUInt32 uiStartIndex, ezUInt32 uiEndIndex);
+  void RemoveOutdatedVisibilityCacheEntries();
+
   ezIntervalScheduler<ezComponentHandle> m_Scheduler;
   ezPhysicsWorldModuleInterface* m_pPhysicsWorldModule = nullptr;
 
-  ezDynamicArray<ezGameObject*> m_ObjectsInSensorVolume;
-  ezDynamicArray<ezGameObjectHandle> m_DetectedObjects;
+  enum class Visibility : ezUInt8
+  {
+    Visible,
+    Occluded,
+    NeedsRaycast,
+  };
+
+  struct SensorWork
+  {
+    const ezSensorComponent* m_pSensor = nullptr;
+    ezVec3 m_vSensorPos;
+    ezDynamicArray<ezGameObject*> m_Objects;
+    ezDynamicArray<Visibility> m_Visibility;
+    ezDynamicArray<ezGameObjectHandle> m_DetectedObjects;
+  };
+
+  // the sensor work entries are kept from frame to frame, so that their arrays don't need to be reallocated
+  ezDynamicArray<SensorWork> m_SensorWork;
+  ezUInt32 m_uiNumSensorWork = 0;
+
+  struct RayBatch
+  {
+    ezUInt8 m_uiCollisionLayer = 0;
+    ezDynamicArray<ezPhysicsRaycastRequest> m_Rays;
+    ezDynamicArray<ezUInt32> m_RaySensors;
+    ezDynamicArray<ezUInt32> m_RayObjects;
+    ezDynamicArray<ezPhysicsCastResult> m_Results;
+    ezDynamicArray<bool> m_Hits;
+  };
+
+  ezHybridArray<RayBatch, 2> m_RayBatches;
+
+  struct VisibilityKey
+  {
+    ezComponentHandle m_hSensor;
+    ezGameObjectHandle m_hTarget;
+
+    bool operator==(const VisibilityKey& other) const { return m_hSensor == other.m_hSensor && m_hTarget == other.m_hTarget; }
+  };
+
+  struct VisibilityKeyHashHelper
+  {
+    static ezUInt32 Hash(const VisibilityKey& key)
+    {
+      return ezHashingUtils::CombineHashValues32(ezHashHelper<ezComponentHandle>::Hash(key.m_hSensor), ezHashHelper<ezGameObjectHandle>::Hash(key.m_hTarget));
+    }
+
+    static bool Equal(const VisibilityKey& a, const VisibilityKey& b) { return a == b; }
+  };
+
+  struct VisibilityCacheEntry
+  {
+    ezVec3 m_vSensorPos;
+    ezVec3 m_vTargetPos;
+    ezTime m_Time;
+    bool m_bVisible = false;
+  };
+
+  ezHashTable<VisibilityKey, VisibilityCacheEntry, VisibilityKeyHashHelper> m_VisibilityCache;
+  ezTime m_VisibilityCacheDuration = ezTime::Milliseconds(500);
+  ezTime m_LastVisibilityCacheCleanup;
 
   ezDynamicArray<ezComponentHandle> m_DebugComponents;
 };
+
+EZ_DEFINE_AS_POD_TYPE(ezSensorWorldModule::Visibility);
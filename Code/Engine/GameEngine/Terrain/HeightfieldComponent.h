@@ -9,6 +9,7 @@
 #include <RendererCore/Pipeline/RenderData.h>
 
 class ezGeometry;
+class ezImage;
 struct ezMsgExtractRenderData;
 struct ezMsgBuildStaticMesh;
 struct ezMsgExtractGeometry;
@@ -19,6 +20,39 @@ using ezMeshResourceHandle = ezTypedResourceHandle<class ezMeshResource>;
 using ezMaterialResourceHandle = ezTypedResourceHandle<class ezMaterialResource>;
 using ezImageDataResourceHandle = ezTypedResourceHandle<class ezImageDataResource>;
 
+/// \brief All settings that define the shape of a heightfield mesh.
+///
+/// The heightfield is split into a grid of chunks, each of which has its own chain of LOD meshes.
+/// LOD 0 uses the full tesselation, every following LOD halves it. Chunk edges that touch another chunk get a skirt,
+/// which hides the cracks between neighboring chunks that are rendered with different LODs.
+struct EZ_GAMEENGINE_DLL ezHeightfieldMeshSettings
+{
+  ezVec2 m_vHalfExtents = ezVec2(100.0f);
+  float m_fHeight = 50.0f;
+  ezVec2 m_vTexCoordOffset = ezVec2::ZeroVector();
+  ezVec2 m_vTexCoordScale = ezVec2(1);
+  ezVec2U32 m_vTesselation = ezVec2U32(128);
+  ezVec2U32 m_vNumChunks = ezVec2U32(1);
+  ezUInt32 m_uiNumLods = 1;
+
+  /// \brief Returns the number of cells of the whole heightfield, after clamping the tesselation to the supported range.
+  ezVec2U32 GetNumCells() const;
+
+  /// \brief Returns the number of cells of a single chunk. The chunks at the far end may be smaller.
+  ezVec2U32 GetNumCellsPerChunk() const;
+
+  /// \brief Returns the actual number of chunks, which may be lower than m_vNumChunks, if the tesselation is too low to fill all of them.
+  ezVec2U32 GetNumChunks() const;
+
+  /// \brief Returns the number of LODs that the chunks actually have, which may be lower than m_uiNumLods for low tesselations.
+  ezUInt32 GetNumLods() const;
+
+  /// \brief Fills out the render mesh of one chunk at the given LOD.
+  ///
+  /// Only reads from the heightmap and the settings, so it can be called from any thread.
+  void BuildChunkMesh(const ezImage& heightmap, ezUInt32 uiChunkIndex, ezUInt32 uiLod, ezMeshResourceDescriptor& out_Desc) const;
+};
+
 class EZ_GAMEENGINE_DLL ezHeightfieldComponentManager : public ezComponentManager<ezHeightfieldComponent, ezBlockStorageType::Compact>
 {
 public:
@@ -29,11 +63,13 @@ public:
 
   void Update(const ezWorldModule::UpdateContext& context);
   void AddToUpdateList(ezHeightfieldComponent* pComponent);
+  void AddToMeshGenerationList(ezHeightfieldComponent* pComponent);
 
 private:
   void ResourceEventHandler(const ezResourceEvent& e);
 
   ezDeque<ezComponentHandle> m_ComponentsToUpdate;
+  ezDeque<ezComponentHandle> m_ComponentsWithMeshGeneration;
 };
 
 /// \brief This component utilizes a greyscale image to generate an elevation mesh, which is typically used for simple terrain
@@ -41,6 +77,10 @@ private:
 /// The component always creates a mesh for rendering, which uses a single material.
 /// For different layers of grass, dirt, etc. the material can combine multiple textures and a mask.
 ///
+/// The render mesh is split into chunks with multiple LODs each, see ezHeightfieldMeshSettings. The chunk meshes are generated on
+/// worker threads, until they are done, the previous meshes are rendered. During extraction every chunk selects its LOD
+/// by its distance to the LOD camera of the view.
+///
 /// If the "GenerateCollision" property is set, the component also generates a static collision mesh during scene export.
 class EZ_GAMEENGINE_DLL ezHeightfieldComponent : public ezRenderComponent
 {
@@ -100,6 +140,16 @@ public:
   ezVec2U32 GetColMeshTesselation() const { return m_vColMeshTesselation; } // [ property ]
   void SetColMeshTesselation(ezVec2U32 value);                              // [ property ]
 
+  ezVec2U32 GetNumChunks() const { return m_vNumChunks; } // [ property ]
+  void SetNumChunks(ezVec2U32 value);                     // [ property ]
+
+  ezUInt8 GetNumLods() const { return m_uiNumLods; } // [ property ]
+  void SetNumLods(ezUInt8 value);                    // [ property ]
+
+  /// \brief The distance up to which the chunks use LOD 0. Every following LOD is used for twice the distance of the previous one.
+  float GetLodDistance() const { return m_fLodDistance; } // [ property ]
+  void SetLodDistance(float value);                       // [ property ]
+
   void SetIncludeInNavmesh(bool b);                                // [ property ]
   bool GetIncludeInNavmesh() const { return m_bIncludeInNavmesh; } // [ property ]
 
@@ -109,11 +159,15 @@ protected:
 
   void InvalidateMesh();
   void BuildGeometry(ezGeometry& geom) const;
-  ezResult BuildMeshDescriptor(ezMeshResourceDescriptor& desc) const;
+  ezHeightfieldMeshSettings GetMeshSettings() const;
+  ezUInt64 ComputeSettingsHash(const ezHeightfieldMeshSettings& settings) const;
 
   template <typename ResourceType>
   ezTypedResourceHandle<ResourceType> GenerateMesh() const;
 
+  void GenerateChunkMeshes();
+  void FinishChunkMeshGeneration();
+
   ezUInt32 m_uiHeightfieldChangeCounter = 0;
   ezImageDataResourceHandle m_hHeightfield;
   ezMaterialResourceHandle m_hMaterial;
@@ -127,8 +181,22 @@ protected:
   ezVec2U32 m_vTesselation = ezVec2U32(128);
   ezVec2U32 m_vColMeshTesselation = ezVec2U32(64);
 
+  ezVec2U32 m_vNumChunks = ezVec2U32(4);
+  ezUInt8 m_uiNumLods = 4;
+  float m_fLodDistance = 50.0f;
+
   bool m_bGenerateCollision = true;
   bool m_bIncludeInNavmesh = true;
 
-  ezMeshResourceHandle m_hMesh;
+  struct Chunk
+  {
+    ezBoundingBox m_LocalBounds;
+    ezHybridArray<ezMeshResourceHandle, 4> m_Lods;
+  };
+
+  ezDynamicArray<Chunk> m_Chunks;
+  bool m_bChunkMeshesRequested = false;
+
+  struct MeshGenerationTask;
+  ezSharedPtr<MeshGenerationTask> m_pMeshGenerationTask;
 };
@@ -4,18 +4,20 @@
 #include <Core/Interfaces/PhysicsWorldModule.h>
 #include <Core/WorldSerializer/WorldReader.h>
 #include <Core/WorldSerializer/WorldWriter.h>
+#include <Foundation/SimdMath/SimdConversion.h>
 #include <GameEngine/Terrain/HeightfieldComponent.h>
 #include <GameEngine/Utils/ImageDataResource.h>
 #include <RendererCore/Meshes/CpuMeshResource.h>
 #include <RendererCore/Meshes/MeshBufferUtils.h>
 #include <RendererCore/Meshes/MeshComponent.h>
 #include <RendererCore/Meshes/MeshResource.h>
+#include <RendererCore/Pipeline/View.h>
 #include <RendererCore/Utils/WorldGeoExtractionUtil.h>
 #include <Texture/Image/Image.h>
 #include <Texture/Image/ImageUtils.h>
 
 // clang-format off
-EZ_BEGIN_COMPONENT_TYPE(ezHeightfieldComponent, 2, ezComponentMode::Static)
+EZ_BEGIN_COMPONENT_TYPE(ezHeightfieldComponent, 3, ezComponentMode::Static)
 {
   EZ_BEGIN_PROPERTIES
   {
@@ -29,6 +31,9 @@ EZ_BEGIN_COMPONENT_TYPE(ezHeightfieldComponent, 2, ezComponentMode::Static)
     EZ_ACCESSOR_PROPERTY("GenerateCollision", GetGenerateCollision, SetGenerateCollision)->AddAttributes(new ezDefaultValueAttribute(true)),
     EZ_ACCESSOR_PROPERTY("ColMeshTesselation", GetColMeshTesselation, SetColMeshTesselation)->AddAttributes(new ezDefaultValueAttribute(ezVec2U32(64))),    
     EZ_ACCESSOR_PROPERTY("IncludeInNavmesh", GetIncludeInNavmesh, SetIncludeInNavmesh)->AddAttributes(new ezDefaultValueAttribute(true)),
+    EZ_ACCESSOR_PROPERTY("NumChunks", GetNumChunks, SetNumChunks)->AddAttributes(new ezDefaultValueAttribute(ezVec2U32(4)), new ezClampValueAttribute(ezVec2U32(1), ezVec2U32(16))),
+    EZ_ACCESSOR_PROPERTY("NumLods", GetNumLods, SetNumLods)->AddAttributes(new ezDefaultValueAttribute(4), new ezClampValueAttribute(1, 8)),
+    EZ_ACCESSOR_PROPERTY("LodDistance", GetLodDistance, SetLodDistance)->AddAttributes(new ezDefaultValueAttribute(50.0f), new ezClampValueAttribute(1.0f, ezVariant())),
   }
   EZ_END_PROPERTIES;
   EZ_BEGIN_ATTRIBUTES
@@ -47,8 +52,353 @@ EZ_BEGIN_COMPONENT_TYPE(ezHeightfieldComponent, 2, ezComponentMode::Static)
 EZ_END_COMPONENT_TYPE;
 // clang-format on
 
+namespace
+{
+  constexpr ezUInt32 s_uiMaxTesselation = 8192;
+  constexpr ezUInt32 s_uiMaxChunks = 16;
+  constexpr ezUInt32 s_uiMaxLods = 8;
+
+  // Data/Base/Materials/Common/Pattern.ezMaterialAsset
+  constexpr const char* s_szDefaultMaterial = "{ 1c47ee4c-0379-4280-85f5-b8cda61941d2 }";
+
+  EZ_ALWAYS_INLINE ezUInt32 DivideRoundUp(ezUInt32 a, ezUInt32 b)
+  {
+    return (a + b - 1) / b;
+  }
+
+  /// Writes the grid coordinates of all vertices from uiFirst to uiLast with the given step size, the last one is always included.
+  /// Additionally the neighbors before the first and after the last vertex are added at the front and at the end.
+  void ComputeGridCoordinates(ezUInt32 uiFirst, ezUInt32 uiLast, ezUInt32 uiStep, ezUInt32 uiMax, ezDynamicArray<ezUInt32>& out_Coordinates)
+  {
+    out_Coordinates.Clear();
+    out_Coordinates.PushBack(uiFirst >= uiStep ? uiFirst - uiStep : 0);
+
+    for (ezUInt32 i = uiFirst; i < uiLast; i += uiStep)
+    {
+      out_Coordinates.PushBack(i);
+    }
+
+    out_Coordinates.PushBack(uiLast);
+    out_Coordinates.PushBack(ezMath::Min(uiLast + uiStep, uiMax));
+  }
+} // namespace
+
+ezVec2U32 ezHeightfieldMeshSettings::GetNumCells() const
+{
+  return ezVec2U32(ezMath::Clamp(m_vTesselation.x, 4u, s_uiMaxTesselation), ezMath::Clamp(m_vTesselation.y, 4u, s_uiMaxTesselation));
+}
+
+ezUInt32 ezHeightfieldMeshSettings::GetNumLods() const
+{
+  const ezVec2U32 vNumCells = GetNumCells();
+  const ezUInt32 uiChunkCellsX = DivideRoundUp(vNumCells.x, ezMath::Clamp(m_vNumChunks.x, 1u, s_uiMaxChunks));
+  const ezUInt32 uiChunkCellsY = DivideRoundUp(vNumCells.y, ezMath::Clamp(m_vNumChunks.y, 1u, s_uiMaxChunks));
+  const ezUInt32 uiMinChunkCells = ezMath::Min(uiChunkCellsX, uiChunkCellsY);
+
+  ezUInt32 uiNumLods = ezMath::Clamp(m_uiNumLods, 1u, s_uiMaxLods);
+
+  // the coarsest LOD should still have at least two cells per chunk along each axis
+  while (uiNumLods > 1 && (2u << (uiNumLods - 1)) > uiMinChunkCells)
+  {
+    --uiNumLods;
+  }
+
+  return uiNumLods;
+}
+
+ezVec2U32 ezHeightfieldMeshSettings::GetNumCellsPerChunk() const
+{
+  const ezVec2U32 vNumCells = GetNumCells();
+
+  // round up to the step size of the coarsest LOD, so that all LODs have vertices at the same chunk borders
+  const ezUInt32 uiAlignment = 1u << (GetNumLods() - 1);
+  const ezUInt32 uiChunkCellsX = DivideRoundUp(DivideRoundUp(vNumCells.x, ezMath::Clamp(m_vNumChunks.x, 1u, s_uiMaxChunks)), uiAlignment) * uiAlignment;
+  const ezUInt32 uiChunkCellsY = DivideRoundUp(DivideRoundUp(vNumCells.y, ezMath::Clamp(m_vNumChunks.y, 1u, s_uiMaxChunks)), uiAlignment) * uiAlignment;
+
+  return ezVec2U32(uiChunkCellsX, uiChunkCellsY);
+}
+
+ezVec2U32 ezHeightfieldMeshSettings::GetNumChunks() const
+{
+  const ezVec2U32 vNumCells = GetNumCells();
+  const ezVec2U32 vNumCellsPerChunk = GetNumCellsPerChunk();
+
+  return ezVec2U32(DivideRoundUp(vNumCells.x, vNumCellsPerChunk.x), DivideRoundUp(vNumCells.y, vNumCellsPerChunk.y));
+}
+
+void ezHeightfieldMeshSettings::BuildChunkMesh(const ezImage& heightmap, ezUInt32 uiChunkIndex, ezUInt32 uiLod, ezMeshResourceDescriptor& out_Desc) const
+{
+  EZ_PROFILE_SCOPE("Heightfield: BuildChunkMesh");
+
+  const ezVec2U32 vNumCells = GetNumCells();
+  const ezVec2U32 vNumChunks = GetNumChunks();
+  const ezVec2U32 vNumCellsPerChunk = GetNumCellsPerChunk();
+  const ezUInt32 uiStep = 1u << uiLod;
+
+  const ezUInt32 uiChunkX = uiChunkIndex % vNumChunks.x;
+  const ezUInt32 uiChunkY = uiChunkIndex / vNumChunks.x;
+  EZ_ASSERT_DEV(uiChunkY < vNumChunks.y, "Invalid chunk index {}", uiChunkIndex);
+
+  ezHybridArray<ezUInt32, 130> gridX;
+  ezHybridArray<ezUInt32, 130> gridY;
+  ComputeGridCoordinates(uiChunkX * vNumCellsPerChunk.x, ezMath::Min((uiChunkX + 1) * vNumCellsPerChunk.x, vNumCells.x), uiStep, vNumCells.x, gridX);
+  ComputeGridCoordinates(uiChunkY * vNumCellsPerChunk.y, ezMath::Min((uiChunkY + 1) * vNumCellsPerChunk.y, vNumCells.y), uiStep, vNumCells.y, gridY);
+
+  // the first and last grid coordinate are only the neighbors for computing the normals
+  const ezUInt32 uiGridWidth = gridX.GetCount();
+  const ezUInt32 uiNumVerticesX = gridX.GetCount() - 2;
+  const ezUInt32 uiNumVerticesY = gridY.GetCount() - 2;
+
+  // chunk edges that touch another chunk get a skirt that reaches down to the bottom of the heightfield
+  const bool bSkirtBottom = uiChunkY > 0;
+  const bool bSkirtRight = uiChunkX + 1 < vNumChunks.x;
+  const bool bSkirtTop = uiChunkY + 1 < vNumChunks.y;
+  const bool bSkirtLeft = uiChunkX > 0;
+
+  const ezUInt32 uiNumSkirtVertices = (bSkirtBottom ? uiNumVerticesX : 0) + (bSkirtTop ? uiNumVerticesX : 0) + (bSkirtLeft ? uiNumVerticesY : 0) + (bSkirtRight ? uiNumVerticesY : 0);
+  const ezUInt32 uiNumSkirtTriangles = (bSkirtBottom ? uiNumVerticesX - 1 : 0) * 2 + (bSkirtTop ? uiNumVerticesX - 1 : 0) * 2 + (bSkirtLeft ? uiNumVerticesY - 1 : 0) * 2 + (bSkirtRight ? uiNumVerticesY - 1 : 0) * 2;
+
+  const ezUInt32 uiNumVertices = uiNumVerticesX * uiNumVerticesY + uiNumSkirtVertices;
+  const ezUInt32 uiNumTriangles = (uiNumVerticesX - 1) * (uiNumVerticesY - 1) * 2 + uiNumSkirtTriangles;
+
+  const ezVec3 vSize(m_vHalfExtents.x * 2, m_vHalfExtents.y * 2, m_fHeight);
+  const ezVec2 vToNDC = ezVec2(1.0f / vNumCells.x, 1.0f / vNumCells.y);
+  const ezVec3 vPosOffset(-m_vHalfExtents.x, -m_vHalfExtents.y, -m_fHeight);
+
+  // sample the heights of all vertices and their neighbors once
+  ezDynamicArray<float> heights;
+  heights.SetCountUninitialized(gridX.GetCount() * gridY.GetCount());
+
+  {
+    const ezColor* pImgData = heightmap.GetPixelPointer<ezColor>();
+    const ezUInt32 imgWidth = heightmap.GetWidth();
+    const ezUInt32 imgHeight = heightmap.GetHeight();
+
+    ezUInt32 uiHeightIdx = 0;
+    for (ezUInt32 y : gridY)
+    {
+      for (ezUInt32 x : gridX)
+      {
+        const ezVec2 heightTC = ezVec2((float)x, (float)y).CompMul(vToNDC);
+        heights[uiHeightIdx++] = ezImageUtils::BilinearSample(pImgData, imgWidth, imgHeight, ezImageAddressMode::Clamp, heightTC).r;
+      }
+    }
+  }
+
+  // positions are addressed with the indices into the grid coordinates, including the neighbors
+  auto GetPosition = [&](ezUInt32 gx, ezUInt32 gy) -> ezVec3 {
+    const ezVec2 ndc = ezVec2((float)gridX[gx], (float)gridY[gy]).CompMul(vToNDC);
+    return vPosOffset + ezVec3(ndc.x, ndc.y, heights[gy * uiGridWidth + gx]).CompMul(vSize);
+  };
+
+  auto GetNormal = [&](ezUInt32 gx, ezUInt32 gy) -> ezVec3 {
+    const ezVec3 vPosCenter = GetPosition(gx, gy);
+
+    ezVec3 edgeL = GetPosition(gx - 1, gy) - vPosCenter;
+    ezVec3 edgeR = GetPosition(gx + 1, gy) - vPosCenter;
+    ezVec3 edgeB = GetPosition(gx, gy - 1) - vPosCenter;
+    ezVec3 edgeT = GetPosition(gx, gy + 1) - vPosCenter;
+
+    // rotate edges by 90 degrees, so that they become normals
+    ezMath::Swap(edgeL.x, edgeL.z);
+    ezMath::Swap(edgeR.x, edgeR.z);
+    ezMath::Swap(edgeB.y, edgeB.z);
+    ezMath::Swap(edgeT.y, edgeT.z);
+
+    edgeL.z = -edgeL.z;
+    edgeR.x = -edgeR.x;
+    edgeB.z = -edgeB.z;
+    edgeT.y = -edgeT.y;
+
+    // don't normalize the edges first, if they are longer, they shall have more influence
+    ezVec3 vNormal(0);
+    vNormal += edgeL;
+    vNormal += edgeR;
+    vNormal += edgeB;
+    vNormal += edgeT;
+    vNormal.Normalize();
+
+    return vNormal;
+  };
+
+  out_Desc.SetMaterial(0, s_szDefaultMaterial);
+
+  out_Desc.MeshBufferDesc().AddCommonStreams();
+  // 0 = position
+  // 1 = texcoord
+  // 2 = normal
+  // 3 = tangent
+
+  auto& mb = out_Desc.MeshBufferDesc();
+  mb.AllocateStreams(uiNumVertices, ezGALPrimitiveTopology::Triangles, uiNumTriangles);
+
+  const auto texCoordFormat = ezMeshTexCoordPrecision::ToResourceFormat(ezMeshTexCoordPrecision::Default);
+  const auto normalFormat = ezMeshNormalPrecision::ToResourceFormatNormal(ezMeshNormalPrecision::Default);
+  const auto tangentFormat = ezMeshNormalPrecision::ToResourceFormatTangent(ezMeshNormalPrecision::Default);
+
+  // access the vertex data directly, this is way faster than going through SetVertexData
+  auto positionData = mb.GetVertexData(0, 0);
+  auto texcoordData = mb.GetVertexData(1, 0);
+  auto normalData = mb.GetVertexData(2, 0);
+  auto tangentData = mb.GetVertexData(3, 0);
+
+  const ezUInt32 uiVertexDataSize = mb.GetVertexDataSize();
+
+  // vertex x/y are the indices of the vertex inside the chunk, the skirt vertices are moved down to the bottom of the heightfield
+  auto WriteVertex = [&](ezUInt32 uiVertexIdx, ezUInt32 x, ezUInt32 y, bool bSkirt) {
+    const size_t uiByteOffset = (size_t)uiVertexIdx * (size_t)uiVertexDataSize;
+
+    ezVec3 vPosition = GetPosition(x + 1, y + 1);
+    if (bSkirt)
+    {
+      vPosition.z = vPosOffset.z;
+    }
+
+    const ezVec2 ndc = ezVec2((float)gridX[x + 1], (float)gridY[y + 1]).CompMul(vToNDC);
+    const ezVec2 tc = m_vTexCoordOffset + ndc.CompMul(m_vTexCoordScale);
+
+    const ezVec3 vNormal = GetNormal(x + 1, y + 1);
+    const ezVec3 vTangent = ezVec3(1, 0, 0).CrossRH(vNormal).GetNormalized();
+
+    *reinterpret_cast<ezVec3*>(positionData.GetPtr() + uiByteOffset) = vPosition;
+    ezMeshBufferUtils::EncodeTexCoord(tc, ezByteArrayPtr(texcoordData.GetPtr() + uiByteOffset, 32), texCoordFormat).IgnoreResult();
+    ezMeshBufferUtils::EncodeNormal(vNormal, ezByteArrayPtr(normalData.GetPtr() + uiByteOffset, 32), normalFormat).IgnoreResult();
+    ezMeshBufferUtils::EncodeTangent(vTangent, 1.0f, ezByteArrayPtr(tangentData.GetPtr() + uiByteOffset, 32), tangentFormat).IgnoreResult();
+  };
+
+  ezUInt32 uiVertexIdx = 0;
+  float fMinHeight = ezMath::MaxValue<float>();
+  float fMaxHeight = -ezMath::MaxValue<float>();
+
+  for (ezUInt32 y = 0; y < uiNumVerticesY; ++y)
+  {
+    for (ezUInt32 x = 0; x < uiNumVerticesX; ++x)
+    {
+      const float fHeight = heights[(y + 1) * uiGridWidth + x + 1];
+      fMinHeight = ezMath::Min(fMinHeight, fHeight);
+      fMaxHeight = ezMath::Max(fMaxHeight, fHeight);
+
+      WriteVertex(uiVertexIdx, x, y, false);
+      ++uiVertexIdx;
+    }
+  }
+
+  ezUInt32 uiTriangleIdx = 0;
+
+  for (ezUInt32 y = 0; y < uiNumVerticesY - 1; ++y)
+  {
+    for (ezUInt32 x = 0; x < uiNumVerticesX - 1; ++x)
+    {
+      const ezUInt32 uiIdx = y * uiNumVerticesX + x;
+
+      mb.SetTriangleIndices(uiTriangleIdx + 0, uiIdx, uiIdx + 1, uiIdx + uiNumVerticesX);
+      mb.SetTriangleIndices(uiTriangleIdx + 1, uiIdx + 1, uiIdx + uiNumVerticesX + 1, uiIdx + uiNumVerticesX);
+      uiTriangleIdx += 2;
+    }
+  }
+
+  // walks along one chunk edge counter-clockwise (seen from above), so that the skirt faces outwards
+  auto AddSkirt = [&](ezUInt32 x, ezUInt32 y, ezInt32 iDirX, ezInt32 iDirY, ezUInt32 uiCount) {
+    const ezUInt32 uiFirstSkirtVertex = uiVertexIdx;
+
+    for (ezUInt32 i = 0; i < uiCount; ++i)
+    {
+      WriteVertex(uiVertexIdx, x + iDirX * i, y + iDirY * i, true);
+      ++uiVertexIdx;
+    }
+
+    for (ezUInt32 i = 0; i + 1 < uiCount; ++i)
+    {
+      const ezUInt32 a = (y + iDirY * i) * uiNumVerticesX + (x + iDirX * i);
+      const ezUInt32 b = (y + iDirY * (i + 1)) * uiNumVerticesX + (x + iDirX * (i + 1));
+      const ezUInt32 aSkirt = uiFirstSkirtVertex + i;
+      const ezUInt32 bSkirt = uiFirstSkirtVertex + i + 1;
+
+      mb.SetTriangleIndices(uiTriangleIdx + 0, a, aSkirt, b);
+      mb.SetTriangleIndices(uiTriangleIdx + 1, b, aSkirt, bSkirt);
+      uiTriangleIdx += 2;
+    }
+  };
+
+  if (bSkirtBottom)
+    AddSkirt(0, 0, 1, 0, uiNumVerticesX);
+  if (bSkirtRight)
+    AddSkirt(uiNumVerticesX - 1, 0, 0, 1, uiNumVerticesY);
+  if (bSkirtTop)
+    AddSkirt(uiNumVerticesX - 1, uiNumVerticesY - 1, -1, 0, uiNumVerticesX);
+  if (bSkirtLeft)
+    AddSkirt(0, uiNumVerticesY - 1, 0, -1, uiNumVerticesY);
+
+  EZ_ASSERT_DEBUG(uiVertexIdx == uiNumVertices && uiTriangleIdx == uiNumTriangles, "Heightfield chunk mesh size was computed incorrectly");
+
+  if (uiNumSkirtVertices > 0)
+  {
+    fMinHeight = 0.0f;
+  }
+
+  const ezVec3 vBoundsMin = vPosOffset + ezVec3((float)gridX[1] * vToNDC.x, (float)gridY[1] * vToNDC.y, fMinHeight).CompMul(vSize);
+  const ezVec3 vBoundsMax = vPosOffset + ezVec3((float)gridX[uiNumVerticesX] * vToNDC.x, (float)gridY[uiNumVerticesY] * vToNDC.y, fMaxHeight).CompMul(vSize);
+  out_Desc.SetBounds(ezBoundingBox(vBoundsMin, vBoundsMax));
+
+  out_Desc.AddSubMesh(mb.GetPrimitiveCount(), 0, 0);
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+struct ezHeightfieldComponent::MeshGenerationTask : public ezTask
+{
+  MeshGenerationTask()
+  {
+    ConfigureTask("Heightfield Mesh Generation", ezTaskNesting::Maybe);
+  }
+
+  virtual void Execute() override
+  {
+    ezResourceLock<ezImageDataResource> pImageData(m_hHeightfield, ezResourceAcquireMode::BlockTillLoaded_NeverFail);
+    if (pImageData.GetAcquireResult() != ezResourceAcquireResult::Final)
+    {
+      ezLog::Error("Failed to load heightmap image data '{}'", m_hHeightfield.GetResourceID());
+      return;
+    }
+
+    const ezImage& heightmap = pImageData->GetDescriptor().m_Image;
+
+    ezParallelForParams params;
+    params.uiBinSize = 1;
+    params.nestingMode = ezTaskNesting::Maybe;
+
+    ezTaskSystem::ParallelForIndexed(
+      0, m_Meshes.GetCount(),
+      [this, &heightmap](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) {
+        for (ezUInt32 i = uiStartIndex; i < uiEndIndex && !HasBeenCanceled(); ++i)
+        {
+          m_Settings.BuildChunkMesh(heightmap, i / m_uiNumLods, i % m_uiNumLods, m_Meshes[i]);
+        }
+      },
+      "Heightfield Chunk Meshes", params);
+
+    m_bSucceeded = !HasBeenCanceled();
+  }
+
+  ezImageDataResourceHandle m_hHeightfield;
+  ezHeightfieldMeshSettings m_Settings;
+  ezUInt64 m_uiSettingsHash = 0;
+  ezUInt32 m_uiNumLods = 0;
+  ezDynamicArray<ezMeshResourceDescriptor> m_Meshes;
+  bool m_bSucceeded = false;
+};
+
+//////////////////////////////////////////////////////////////////////////
+
 ezHeightfieldComponent::ezHeightfieldComponent() = default;
-ezHeightfieldComponent::~ezHeightfieldComponent() = default;
+
+ezHeightfieldComponent::~ezHeightfieldComponent()
+{
+  if (m_pMeshGenerationTask != nullptr)
+  {
+    ezTaskSystem::CancelTask(m_pMeshGenerationTask, ezOnTaskRunning::ReturnWithoutBlocking).IgnoreResult();
+  }
+}
 
 void ezHeightfieldComponent::SetHalfExtents(ezVec2 value)
 {
@@ -85,6 +435,11 @@ void ezHeightfieldComponent::SerializeComponent(ezWorldWriter& stream) const
   // Version 2
   s << m_bGenerateCollision;
   s << m_bIncludeInNavmesh;
+
+  // Version 3
+  s << m_vNumChunks;
+  s << m_uiNumLods;
+  s << m_fLodDistance;
 }
 
 void ezHeightfieldComponent::DeserializeComponent(ezWorldReader& stream)
@@ -107,92 +462,147 @@ void ezHeightfieldComponent::DeserializeComponent(ezWorldReader& stream)
     s >> m_bGenerateCollision;
     s >> m_bIncludeInNavmesh;
   }
+
+  if (uiVersion >= 3)
+  {
+    s >> m_vNumChunks;
+    s >> m_uiNumLods;
+    s >> m_fLodDistance;
+  }
 }
 
 void ezHeightfieldComponent::OnActivated()
 {
-  if (!m_hMesh.IsValid())
+  if (!m_bChunkMeshesRequested)
   {
-    m_hMesh = GenerateMesh<ezMeshResource>();
+    GenerateChunkMeshes();
   }
 
-  // First generate the mesh and then call the base implementation which will update the bounds
   SUPER::OnActivated();
 }
 
 ezResult ezHeightfieldComponent::GetLocalBounds(ezBoundingBoxSphere& bounds, bool& bAlwaysVisible)
 {
-  if (m_hMesh.IsValid())
-  {
-    ezResourceLock<ezMeshResource> pMesh(m_hMesh, ezResourceAcquireMode::AllowLoadingFallback);
-    bounds = pMesh->GetBounds();
-    return EZ_SUCCESS;
-  }
+  if (!m_hHeightfield.IsValid())
+    return EZ_FAILURE;
 
-  return EZ_FAILURE;
+  // the chunk meshes are generated in the background, but their bounds are known upfront
+  const ezVec3 vSize(m_vHalfExtents.x * 2, m_vHalfExtents.y * 2, m_fHeight);
+  const ezVec3 vPosOffset(-m_vHalfExtents.x, -m_vHalfExtents.y, -m_fHeight);
+
+  bounds = ezBoundingBox(vPosOffset, vPosOffset + vSize);
+  return EZ_SUCCESS;
 }
 
 void ezHeightfieldComponent::OnMsgExtractRenderData(ezMsgExtractRenderData& msg) const
 {
-  if (!m_hMesh.IsValid())
+  if (m_Chunks.IsEmpty())
     return;
 
-  const ezUInt32 uiFlipWinding = GetOwner()->GetGlobalTransformSimd().ContainsNegativeScale() ? 1 : 0;
-  const ezUInt32 uiUniformScale = GetOwner()->GetGlobalTransformSimd().ContainsUniformScale() ? 1 : 0;
+  const ezTransform globalTransform = GetOwner()->GetGlobalTransform();
+  const ezSimdTransform& globalTransformSimd = GetOwner()->GetGlobalTransformSimd();
+
+  const ezUInt32 uiFlipWinding = globalTransformSimd.ContainsNegativeScale() ? 1 : 0;
+  const ezUInt32 uiUniformScale = globalTransformSimd.ContainsUniformScale() ? 1 : 0;
 
-  ezResourceLock<ezMeshResource> pMesh(m_hMesh, ezResourceAcquireMode::AllowLoadingFallback);
-  ezArrayPtr<const ezMeshResourceDescriptor::SubMesh> parts = pMesh->GetSubMeshes();
+  ezMaterialResourceHandle hMaterial = m_hMaterial;
+  if (!hMaterial.IsValid())
+  {
+    ezResourceLock<ezMeshResource> pMesh(m_Chunks[0].m_Lods[0], ezResourceAcquireMode::AllowLoadingFallback);
+    if (!pMesh->GetMaterials().IsEmpty())
+    {
+      hMaterial = pMesh->GetMaterials()[0];
+    }
+  }
+
+  // Determine render data category.
+  ezRenderData::Category category = ezDefaultRenderDataCategories::LitOpaque;
 
-  for (ezUInt32 uiPartIndex = 0; uiPartIndex < parts.GetCount(); ++uiPartIndex)
+  if (hMaterial.IsValid())
   {
-    const ezUInt32 uiMaterialIndex = parts[uiPartIndex].m_uiMaterialIndex;
-    ezMaterialResourceHandle hMaterial = m_hMaterial.IsValid() ? m_hMaterial : pMesh->GetMaterials()[uiMaterialIndex];
+    ezResourceLock<ezMaterialResource> pMaterial(hMaterial, ezResourceAcquireMode::AllowLoadingFallback);
 
-    ezMeshRenderData* pRenderData = ezCreateRenderDataForThisFrame<ezMeshRenderData>(GetOwner());
+    ezTempHashedString blendModeValue = pMaterial->GetPermutationValue("BLEND_MODE");
+    if (blendModeValue == "BLEND_MODE_OPAQUE" || blendModeValue == "")
     {
-      pRenderData->m_GlobalTransform = GetOwner()->GetGlobalTransform();
-      pRenderData->m_GlobalBounds = GetOwner()->GetGlobalBounds();
-      pRenderData->m_hMesh = m_hMesh;
-      pRenderData->m_hMaterial = hMaterial;
-      pRenderData->m_Color = ezColor::White;
+      category = ezDefaultRenderDataCategories::LitOpaque;
+    }
+    else if (blendModeValue == "BLEND_MODE_MASKED")
+    {
+      category = ezDefaultRenderDataCategories::LitMasked;
+    }
+    else
+    {
+      category = ezDefaultRenderDataCategories::LitTransparent;
+    }
+  }
 
-      pRenderData->m_uiSubMeshIndex = uiPartIndex;
-      pRenderData->m_uiFlipWinding = uiFlipWinding;
-      pRenderData->m_uiUniformScale = uiUniformScale;
+  // the LODs are selected by the distance of the chunks to the LOD camera, in the local space of the heightfield
+  bool bSelectLod = false;
+  ezVec3 vLocalCameraPos = ezVec3::ZeroVector();
+  const float fScale = globalTransform.GetMaxScale();
 
-      pRenderData->m_uiUniqueID = GetUniqueIdForRendering(uiMaterialIndex);
+  bool bCullChunks = false;
+  ezFrustum frustum;
 
-      pRenderData->FillBatchIdAndSortingKey();
+  if (msg.m_pView != nullptr)
+  {
+    if (const ezCamera* pLodCamera = msg.m_pView->GetLodCamera())
+    {
+      vLocalCameraPos = globalTransform.GetInverse().TransformPosition(pLodCamera->GetPosition());
+      bSelectLod = true;
     }
 
-    bool bDontCacheYet = false;
+    if (msg.m_pView->GetCullingCamera() != nullptr)
+    {
+      msg.m_pView->ComputeCullingFrustum(frustum);
+      bCullChunks = true;
+    }
+  }
+
+  for (ezUInt32 uiChunkIndex = 0; uiChunkIndex < m_Chunks.GetCount(); ++uiChunkIndex)
+  {
+    const Chunk& chunk = m_Chunks[uiChunkIndex];
 
-    // Determine render data category.
-    ezRenderData::Category category = ezDefaultRenderDataCategories::LitOpaque;
+    ezSimdBBox globalChunkBounds = ezSimdConversion::ToBBox(chunk.m_LocalBounds);
+    globalChunkBounds.Transform(globalTransformSimd);
 
-    if (hMaterial.IsValid())
-    {
-      ezResourceLock<ezMaterialResource> pMaterial(hMaterial, ezResourceAcquireMode::AllowLoadingFallback);
+    if (bCullChunks && !frustum.Overlaps(globalChunkBounds))
+      continue;
 
-      if (pMaterial.GetAcquireResult() == ezResourceAcquireResult::LoadingFallback)
-        bDontCacheYet = true;
+    ezUInt32 uiLod = 0;
 
-      ezTempHashedString blendModeValue = pMaterial->GetPermutationValue("BLEND_MODE");
-      if (blendModeValue == "BLEND_MODE_OPAQUE" || blendModeValue == "")
-      {
-        category = ezDefaultRenderDataCategories::LitOpaque;
-      }
-      else if (blendModeValue == "BLEND_MODE_MASKED")
-      {
-        category = ezDefaultRenderDataCategories::LitMasked;
-      }
-      else
+    if (bSelectLod)
+    {
+      const float fDistance = chunk.m_LocalBounds.GetDistanceTo(vLocalCameraPos) * fScale;
+
+      float fLodDistance = m_fLodDistance;
+      while (fDistance > fLodDistance && uiLod + 1 < chunk.m_Lods.GetCount())
       {
-        category = ezDefaultRenderDataCategories::LitTransparent;
+        ++uiLod;
+        fLodDistance *= 2.0f;
       }
     }
 
-    msg.AddRenderData(pRenderData, category, bDontCacheYet ? ezRenderData::Caching::Never : ezRenderData::Caching::IfStatic);
+    ezMeshRenderData* pRenderData = ezCreateRenderDataForThisFrame<ezMeshRenderData>(GetOwner());
+    {
+      pRenderData->m_GlobalTransform = globalTransform;
+      pRenderData->m_GlobalBounds = ezSimdConversion::ToBBox(globalChunkBounds);
+      pRenderData->m_hMesh = chunk.m_Lods[uiLod];
+      pRenderData->m_hMaterial = hMaterial;
+      pRenderData->m_Color = ezColor::White;
+
+      pRenderData->m_uiSubMeshIndex = 0;
+      pRenderData->m_uiFlipWinding = uiFlipWinding;
+      pRenderData->m_uiUniformScale = uiUniformScale;
+
+      pRenderData->m_uiUniqueID = GetUniqueIdForRendering(uiChunkIndex);
+
+      pRenderData->FillBatchIdAndSortingKey();
+    }
+
+    // the LOD depends on the view, so the render data can't be cached
+    msg.AddRenderData(pRenderData, category, ezRenderData::Caching::Never);
   }
 }
 
@@ -271,6 +681,24 @@ void ezHeightfieldComponent::SetIncludeInNavmesh(bool b)
   m_bIncludeInNavmesh = b;
 }
 
+void ezHeightfieldComponent::SetNumChunks(ezVec2U32 value)
+{
+  m_vNumChunks = value;
+  InvalidateMesh();
+}
+
+void ezHeightfieldComponent::SetNumLods(ezUInt8 value)
+{
+  m_uiNumLods = value;
+  InvalidateMesh();
+}
+
+void ezHeightfieldComponent::SetLodDistance(float value)
+{
+  // only used during extraction, no need to regenerate the meshes
+  m_fLodDistance = value;
+}
+
 void ezHeightfieldComponent::OnBuildStaticMesh(ezMsgBuildStaticMesh& msg) const
 {
   if (!m_bGenerateCollision)
@@ -348,11 +776,9 @@ void ezHeightfieldComponent::OnMsgExtractGeometry(ezMsgExtractGeometry& msg) con
 
 void ezHeightfieldComponent::InvalidateMesh()
 {
-  if (m_hMesh.IsValid())
+  if (m_bChunkMeshesRequested)
   {
-    m_hMesh.Invalidate();
-
-    m_hMesh = GenerateMesh<ezMeshResource>();
+    GenerateChunkMeshes();
 
     TriggerLocalBoundsUpdate();
   }
@@ -423,207 +849,171 @@ void ezHeightfieldComponent::BuildGeometry(ezGeometry& geom) const
   }
 }
 
-ezResult ezHeightfieldComponent::BuildMeshDescriptor(ezMeshResourceDescriptor& desc) const
+ezHeightfieldMeshSettings ezHeightfieldComponent::GetMeshSettings() const
+{
+  ezHeightfieldMeshSettings settings;
+  settings.m_vHalfExtents = m_vHalfExtents;
+  settings.m_fHeight = m_fHeight;
+  settings.m_vTexCoordOffset = m_vTexCoordOffset;
+  settings.m_vTexCoordScale = m_vTexCoordScale;
+  settings.m_vTesselation = m_vTesselation;
+  settings.m_vNumChunks = m_vNumChunks;
+  settings.m_uiNumLods = m_uiNumLods;
+  return settings;
+}
+
+ezUInt64 ezHeightfieldComponent::ComputeSettingsHash(const ezHeightfieldMeshSettings& settings) const
+{
+  ezUInt64 uiSettingsHash = m_hHeightfield.GetResourceIDHash() + m_uiHeightfieldChangeCounter;
+  uiSettingsHash = ezHashingUtils::xxHash64(&settings.m_vHalfExtents, sizeof(settings.m_vHalfExtents), uiSettingsHash);
+  uiSettingsHash = ezHashingUtils::xxHash64(&settings.m_fHeight, sizeof(settings.m_fHeight), uiSettingsHash);
+  uiSettingsHash = ezHashingUtils::xxHash64(&settings.m_vTexCoordOffset, sizeof(settings.m_vTexCoordOffset), uiSettingsHash);
+  uiSettingsHash = ezHashingUtils::xxHash64(&settings.m_vTexCoordScale, sizeof(settings.m_vTexCoordScale), uiSettingsHash);
+  uiSettingsHash = ezHashingUtils::xxHash64(&settings.m_vTesselation, sizeof(settings.m_vTesselation), uiSettingsHash);
+  uiSettingsHash = ezHashingUtils::xxHash64(&settings.m_vNumChunks, sizeof(settings.m_vNumChunks), uiSettingsHash);
+  uiSettingsHash = ezHashingUtils::xxHash64(&settings.m_uiNumLods, sizeof(settings.m_uiNumLods), uiSettingsHash);
+  return uiSettingsHash;
+}
+
+template <typename ResourceType>
+ezTypedResourceHandle<ResourceType> ezHeightfieldComponent::GenerateMesh() const
 {
-  EZ_PROFILE_SCOPE("Heightfield: GenerateRenderMesh");
+  if (!m_hHeightfield.IsValid())
+    return ezTypedResourceHandle<ResourceType>();
+
+  // a single mesh for the whole heightfield, without chunks and LODs
+  ezHeightfieldMeshSettings settings = GetMeshSettings();
+  settings.m_vTesselation.x = ezMath::Min(settings.m_vTesselation.x, 1023u);
+  settings.m_vTesselation.y = ezMath::Min(settings.m_vTesselation.y, 1023u);
+  settings.m_vNumChunks = ezVec2U32(1);
+  settings.m_uiNumLods = 1;
+
+  ezStringBuilder sResourceName;
+  sResourceName.Format("Heightfield:{}", ComputeSettingsHash(settings));
+
+  ezTypedResourceHandle<ResourceType> hResource = ezResourceManager::GetExistingResource<ResourceType>(sResourceName);
+  if (hResource.IsValid())
+    return hResource;
 
   ezResourceLock<ezImageDataResource> pImageData(m_hHeightfield, ezResourceAcquireMode::BlockTillLoaded_NeverFail);
   if (pImageData.GetAcquireResult() != ezResourceAcquireResult::Final)
   {
     ezLog::Error("Failed to load heightmap image data '{}'", m_hHeightfield.GetResourceID());
-    return EZ_FAILURE;
+    return ezTypedResourceHandle<ResourceType>();
   }
 
-  const ezImage& heightmap = pImageData->GetDescriptor().m_Image;
+  ezMeshResourceDescriptor desc;
+  settings.BuildChunkMesh(pImageData->GetDescriptor().m_Image, 0, 0, desc);
 
-  // Data/Base/Materials/Common/Pattern.ezMaterialAsset
-  desc.SetMaterial(0, "{ 1c47ee4c-0379-4280-85f5-b8cda61941d2 }");
+  return ezResourceManager::CreateResource<ResourceType>(sResourceName, std::move(desc), sResourceName);
+}
 
-  desc.MeshBufferDesc().AddCommonStreams();
-  // 0 = position
-  // 1 = texcoord
-  // 2 = normal
-  // 3 = tangent
+void ezHeightfieldComponent::GenerateChunkMeshes()
+{
+  m_bChunkMeshesRequested = true;
 
+  if (m_pMeshGenerationTask != nullptr)
   {
-    auto& mb = desc.MeshBufferDesc();
-
-    const ezUInt32 uiNumVerticesX = ezMath::Clamp(m_vTesselation.x + 1u, 5u, 1024u);
-    const ezUInt32 uiNumVerticesY = ezMath::Clamp(m_vTesselation.y + 1u, 5u, 1024u);
-    const ezUInt32 uiNumTriangles = (uiNumVerticesX - 1) * (uiNumVerticesY - 1) * 2;
-
-    mb.AllocateStreams(uiNumVerticesX * uiNumVerticesY, ezGALPrimitiveTopology::Triangles, uiNumTriangles);
-
-    const ezVec3 vSize(m_vHalfExtents.x * 2, m_vHalfExtents.y * 2, m_fHeight);
-    const ezVec2 vToNDC = ezVec2(1.0f / (uiNumVerticesX - 1), 1.0f / (uiNumVerticesY - 1));
-    const ezVec3 vPosOffset(-m_vHalfExtents.x, -m_vHalfExtents.y, -m_fHeight);
-
-    const auto texCoordFormat = ezMeshTexCoordPrecision::ToResourceFormat(ezMeshTexCoordPrecision::Default);
-    const auto normalFormat = ezMeshNormalPrecision::ToResourceFormatNormal(ezMeshNormalPrecision::Default);
-    const auto tangentFormat = ezMeshNormalPrecision::ToResourceFormatTangent(ezMeshNormalPrecision::Default);
-
-    // access the vertex data directly
-    // this is way more complicated than going through SetVertexData, but it is ~20% faster
+    ezTaskSystem::CancelTask(m_pMeshGenerationTask, ezOnTaskRunning::ReturnWithoutBlocking).IgnoreResult();
+    m_pMeshGenerationTask = nullptr;
+  }
 
-    auto positionData = mb.GetVertexData(0, 0);
-    auto texcoordData = mb.GetVertexData(1, 0);
-    auto normalData = mb.GetVertexData(2, 0);
-    auto tangentData = mb.GetVertexData(3, 0);
+  if (!m_hHeightfield.IsValid())
+  {
+    m_Chunks.Clear();
+    return;
+  }
 
-    const ezUInt32 uiVertexDataSize = mb.GetVertexDataSize();
+  const ezHeightfieldMeshSettings settings = GetMeshSettings();
+  const ezUInt64 uiSettingsHash = ComputeSettingsHash(settings);
+  const ezVec2U32 vNumChunks = settings.GetNumChunks();
+  const ezUInt32 uiNumChunks = vNumChunks.x * vNumChunks.y;
+  const ezUInt32 uiNumLods = settings.GetNumLods();
 
-    ezUInt32 uiVertexIdx = 0;
+  // if the meshes were already generated for the same settings, they can be used right away
+  {
+    ezDynamicArray<Chunk> chunks;
+    chunks.SetCount(uiNumChunks);
 
-    const ezColor* pImgData = heightmap.GetPixelPointer<ezColor>();
-    const ezUInt32 imgWidth = heightmap.GetWidth();
-    const ezUInt32 imgHeight = heightmap.GetHeight();
+    bool bAllMeshesExist = true;
+    ezStringBuilder sResourceName;
 
-    for (ezUInt32 y = 0; y < uiNumVerticesY; ++y)
+    for (ezUInt32 uiChunk = 0; uiChunk < uiNumChunks && bAllMeshesExist; ++uiChunk)
     {
-      for (ezUInt32 x = 0; x < uiNumVerticesX; ++x)
+      for (ezUInt32 uiLod = 0; uiLod < uiNumLods; ++uiLod)
       {
-        const ezVec2 ndc = ezVec2((float)x, (float)y).CompMul(vToNDC);
-        const ezVec2 tc = m_vTexCoordOffset + ndc.CompMul(m_vTexCoordScale);
-        const ezVec2 heightTC = ndc;
-
-        const size_t uiByteOffset = (size_t)uiVertexIdx * (size_t)uiVertexDataSize;
-
-        const float fHeightScale = ezImageUtils::BilinearSample(pImgData, imgWidth, imgHeight, ezImageAddressMode::Clamp, heightTC).r;
-
-        // complicated but faster
-        *reinterpret_cast<ezVec3*>(positionData.GetPtr() + uiByteOffset) = vPosOffset + ezVec3(ndc.x, ndc.y, fHeightScale).CompMul(vSize);
-        ezMeshBufferUtils::EncodeTexCoord(tc, ezByteArrayPtr(texcoordData.GetPtr() + uiByteOffset, 32), texCoordFormat).IgnoreResult();
+        sResourceName.Format("Heightfield:{}-{}-{}", uiSettingsHash, uiChunk, uiLod);
 
-        // easier to understand, but slower
-        // mb.SetVertexData(0, uiVertexIdx, vPosOffset + ezVec3(ndc.x, ndc.y, -fHeightScale).CompMul(vSize));
-        // ezMeshBufferUtils::EncodeTexCoord(tc, mb.GetVertexData(1, uiVertexIdx), texCoordFormat).IgnoreResult();
+        ezMeshResourceHandle hMesh = ezResourceManager::GetExistingResource<ezMeshResource>(sResourceName);
+        if (!hMesh.IsValid())
+        {
+          bAllMeshesExist = false;
+          break;
+        }
 
-        ++uiVertexIdx;
+        chunks[uiChunk].m_Lods.PushBack(hMesh);
       }
     }
 
-    uiVertexIdx = 0;
-
-    for (ezUInt32 y = 0; y < uiNumVerticesY; ++y)
+    if (bAllMeshesExist)
     {
-      for (ezUInt32 x = 0; x < uiNumVerticesX; ++x)
+      for (Chunk& chunk : chunks)
       {
-        const size_t uiByteOffset = (size_t)uiVertexIdx * (size_t)uiVertexDataSize;
-
-        const ezInt32 centerIDx = uiVertexIdx;
-        ezInt32 leftIDx = uiVertexIdx - 1;
-        ezInt32 rightIDx = uiVertexIdx + 1;
-        ezInt32 bottomIDx = uiVertexIdx - uiNumVerticesX;
-        ezInt32 topIDx = uiVertexIdx + uiNumVerticesX;
-
-        // clamp the indices
-        if (x == 0)
-          leftIDx = centerIDx;
-        if (x + 1 == uiNumVerticesX)
-          rightIDx = centerIDx;
-        if (y == 0)
-          bottomIDx = centerIDx;
-        if (y + 1 == uiNumVerticesY)
-          topIDx = centerIDx;
-
-        const ezVec3 vPosCenter = *reinterpret_cast<ezVec3*>(positionData.GetPtr() + (size_t)centerIDx * (size_t)uiVertexDataSize);
-        const ezVec3 vPosLeft = *reinterpret_cast<ezVec3*>(positionData.GetPtr() + (size_t)leftIDx * (size_t)uiVertexDataSize);
-        const ezVec3 vPosRight = *reinterpret_cast<ezVec3*>(positionData.GetPtr() + (size_t)rightIDx * (size_t)uiVertexDataSize);
-        const ezVec3 vPosBottom = *reinterpret_cast<ezVec3*>(positionData.GetPtr() + (size_t)bottomIDx * (size_t)uiVertexDataSize);
-        const ezVec3 vPosTop = *reinterpret_cast<ezVec3*>(positionData.GetPtr() + (size_t)topIDx * (size_t)uiVertexDataSize);
-
-        ezVec3 edgeL = vPosLeft - vPosCenter;
-        ezVec3 edgeR = vPosRight - vPosCenter;
-        ezVec3 edgeB = vPosBottom - vPosCenter;
-        ezVec3 edgeT = vPosTop - vPosCenter;
-
-        // rotate edges by 90 degrees, so that they become normals
-        ezMath::Swap(edgeL.x, edgeL.z);
-        ezMath::Swap(edgeR.x, edgeR.z);
-        ezMath::Swap(edgeB.y, edgeB.z);
-        ezMath::Swap(edgeT.y, edgeT.z);
-
-        edgeL.z = -edgeL.z;
-        edgeR.x = -edgeR.x;
-        edgeB.z = -edgeB.z;
-        edgeT.y = -edgeT.y;
-
-        // don't normalize the edges first, if they are longer, they shall have more influence
-        ezVec3 vNormal(0);
-        vNormal += edgeL;
-        vNormal += edgeR;
-        vNormal += edgeB;
-        vNormal += edgeT;
-        vNormal.Normalize();
-
-        ezVec3 vTangent = ezVec3(1, 0, 0).CrossRH(vNormal).GetNormalized();
-
-        // complicated but faster
-        ezMeshBufferUtils::EncodeNormal(vNormal, ezByteArrayPtr(normalData.GetPtr() + uiByteOffset, 32), normalFormat).IgnoreResult();
-        ezMeshBufferUtils::EncodeTangent(vTangent, 1.0f, ezByteArrayPtr(tangentData.GetPtr() + uiByteOffset, 32), tangentFormat).IgnoreResult();
-
-        // easier to understand, but slower
-        // ezMeshBufferUtils::EncodeNormal(ezVec3(0, 0, 1), mb.GetVertexData(2, uiVertexIdx), normalFormat).IgnoreResult();
-        // ezMeshBufferUtils::EncodeTangent(ezVec3(1, 0, 0), 1.0f, mb.GetVertexData(3, uiVertexIdx), tangentFormat).IgnoreResult();
-
-        ++uiVertexIdx;
+        ezResourceLock<ezMeshResource> pMesh(chunk.m_Lods[0], ezResourceAcquireMode::BlockTillLoaded);
+        chunk.m_LocalBounds = pMesh->GetBounds().GetBox();
       }
+
+      m_Chunks.Swap(chunks);
+      return;
     }
+  }
 
-    desc.SetBounds(ezBoundingBox(vPosOffset, vPosOffset + vSize));
+  // otherwise generate them in the background and keep rendering the previous meshes until they are done
+  m_pMeshGenerationTask = EZ_DEFAULT_NEW(MeshGenerationTask);
+  m_pMeshGenerationTask->m_hHeightfield = m_hHeightfield;
+  m_pMeshGenerationTask->m_Settings = settings;
+  m_pMeshGenerationTask->m_uiSettingsHash = uiSettingsHash;
+  m_pMeshGenerationTask->m_uiNumLods = uiNumLods;
+  m_pMeshGenerationTask->m_Meshes.SetCount(uiNumChunks * uiNumLods);
 
-    ezUInt32 uiTriangleIdx = 0;
-    uiVertexIdx = 0;
+  ezTaskSystem::StartSingleTask(m_pMeshGenerationTask, ezTaskPriority::LongRunning);
 
-    for (ezUInt32 y = 0; y < uiNumVerticesY - 1; ++y)
-    {
-      for (ezUInt32 x = 0; x < uiNumVerticesX - 1; ++x)
-      {
-        mb.SetTriangleIndices(uiTriangleIdx + 0, uiVertexIdx, uiVertexIdx + 1, uiVertexIdx + uiNumVerticesX);
-        mb.SetTriangleIndices(uiTriangleIdx + 1, uiVertexIdx + 1, uiVertexIdx + uiNumVerticesX + 1, uiVertexIdx + uiNumVerticesX);
-        uiTriangleIdx += 2;
+  static_cast<ezHeightfieldComponentManager*>(GetOwningManager())->AddToMeshGenerationList(this);
+}
 
-        ++uiVertexIdx;
-      }
+void ezHeightfieldComponent::FinishChunkMeshGeneration()
+{
+  ezSharedPtr<MeshGenerationTask> pTask = m_pMeshGenerationTask;
+  m_pMeshGenerationTask = nullptr;
 
-      ++uiVertexIdx;
-    }
-  }
+  if (!pTask->m_bSucceeded)
+    return;
 
-  desc.AddSubMesh(desc.MeshBufferDesc().GetPrimitiveCount(), 0, 0);
-  return EZ_SUCCESS;
-}
+  EZ_PROFILE_SCOPE("Heightfield: CreateChunkMeshes");
 
-template <typename ResourceType>
-ezTypedResourceHandle<ResourceType> ezHeightfieldComponent::GenerateMesh() const
-{
-  if (!m_hHeightfield.IsValid())
-    return ezTypedResourceHandle<ResourceType>();
+  const ezUInt32 uiNumLods = pTask->m_uiNumLods;
+  const ezUInt32 uiNumChunks = pTask->m_Meshes.GetCount() / uiNumLods;
+
+  ezDynamicArray<Chunk> chunks;
+  chunks.SetCount(uiNumChunks);
 
   ezStringBuilder sResourceName;
 
+  for (ezUInt32 uiChunk = 0; uiChunk < uiNumChunks; ++uiChunk)
   {
-    ezUInt64 uiSettingsHash = m_hHeightfield.GetResourceIDHash() + m_uiHeightfieldChangeCounter;
-    uiSettingsHash = ezHashingUtils::xxHash64(&m_vHalfExtents, sizeof(m_vHalfExtents), uiSettingsHash);
-    uiSettingsHash = ezHashingUtils::xxHash64(&m_fHeight, sizeof(m_fHeight), uiSettingsHash);
-    uiSettingsHash = ezHashingUtils::xxHash64(&m_vTexCoordOffset, sizeof(m_vTexCoordOffset), uiSettingsHash);
-    uiSettingsHash = ezHashingUtils::xxHash64(&m_vTexCoordScale, sizeof(m_vTexCoordScale), uiSettingsHash);
-    uiSettingsHash = ezHashingUtils::xxHash64(&m_vTesselation, sizeof(m_vTesselation), uiSettingsHash);
-
-    sResourceName.Format("Heightfield:{}", uiSettingsHash);
+    Chunk& chunk = chunks[uiChunk];
+    chunk.m_LocalBounds = pTask->m_Meshes[uiChunk * uiNumLods].GetBounds().GetBox();
 
-    ezTypedResourceHandle<ResourceType> hResource = ezResourceManager::GetExistingResource<ResourceType>(sResourceName);
-    if (hResource.IsValid())
-      return hResource;
-  }
+    for (ezUInt32 uiLod = 0; uiLod < uiNumLods; ++uiLod)
+    {
+      sResourceName.Format("Heightfield:{}-{}-{}", pTask->m_uiSettingsHash, uiChunk, uiLod);
 
-  ezMeshResourceDescriptor desc;
-  if (BuildMeshDescriptor(desc).Succeeded())
-  {
-    return ezResourceManager::CreateResource<ResourceType>(sResourceName, std::move(desc), sResourceName);
+      // another heightfield with the same settings may have created the mesh in the meantime
+      chunk.m_Lods.PushBack(ezResourceManager::GetOrCreateResource<ezMeshResource>(sResourceName, std::move(pTask->m_Meshes[uiChunk * uiNumLods + uiLod]), sResourceName));
+    }
   }
 
-  return ezTypedResourceHandle<ResourceType>();
+  m_Chunks.Swap(chunks);
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -667,6 +1057,23 @@ void ezHeightfieldComponentManager::ResourceEventHandler(const ezResourceEvent&
 
 void ezHeightfieldComponentManager::Update(const ezWorldModule::UpdateContext& context)
 {
+  for (ezUInt32 i = 0; i < m_ComponentsWithMeshGeneration.GetCount();)
+  {
+    ezHeightfieldComponent* pComponent;
+    if (TryGetComponent(m_ComponentsWithMeshGeneration[i], pComponent) && pComponent->m_pMeshGenerationTask != nullptr)
+    {
+      if (!pComponent->m_pMeshGenerationTask->IsTaskFinished())
+      {
+        ++i;
+        continue;
+      }
+
+      pComponent->FinishChunkMeshGeneration();
+    }
+
+    m_ComponentsWithMeshGeneration.RemoveAtAndSwap(i);
+  }
+
   for (auto hComp : m_ComponentsToUpdate)
   {
     ezHeightfieldComponent* pComponent;
@@ -691,3 +1098,13 @@ void ezHeightfieldComponentManager::AddToUpdateList(ezHeightfieldComponent* pCom
     m_ComponentsToUpdate.PushBack(hComponent);
   }
 }
+
+void ezHeightfieldComponentManager::AddToMeshGenerationList(ezHeightfieldComponent* pComponent)
+{
+  ezComponentHandle hComponent = pComponent->GetHandle();
+
+  if (m_ComponentsWithMeshGeneration.IndexOf(hComponent) == ezInvalidIndex)
+  {
+    m_ComponentsWithMeshGeneration.PushBack(hComponent);
+  }
+}
@@ -21,6 +21,9 @@ struct ezRenderViewContext;
 /// The 'context' specifies whether shapes are generally visible in a scene, from all views,
 /// or specific to a single view. See the ezDebugRendererContext constructors for what can be implicitly
 /// used as a context.
+///
+/// All functions can be called from any thread. Threads other than the rendering thread append to their own buffers,
+/// which are merged once per frame before rendering, so drawing from many threads at once doesn't contend on a lock.
 class EZ_RENDERERCORE_DLL ezDebugRenderer
 {
 public:
@@ -92,6 +92,7 @@ namespace
     ezDynamicArray<Vertex, ezAlignedAllocatorWrapper> m_triangle2DVertices;
     ezDynamicArray<Vertex, ezAlignedAllocatorWrapper> m_line2DVertices;
     ezDynamicArray<BoxData, ezAlignedAllocatorWrapper> m_lineBoxes;
+    ezDynamicArray<BoxData, ezAlignedAllocatorWrapper> m_lineSpheres;
     ezDynamicArray<BoxData, ezAlignedAllocatorWrapper> m_solidBoxes;
     ezMap<ezGALResourceViewHandle, ezDynamicArray<TexVertex, ezAlignedAllocatorWrapper>> m_texTriangle2DVertices;
     ezMap<ezGALResourceViewHandle, ezDynamicArray<TexVertex, ezAlignedAllocatorWrapper>> m_texTriangle3DVertices;
@@ -118,21 +119,204 @@ namespace
   static ezHashTable<ezDebugRendererContext, DoubleBufferedPerContextData> s_PerContextData;
   static ezMutex s_Mutex;
 
-  static PerContextData& GetDataForExtraction(const ezDebugRendererContext& context)
+  /// \brief Primitives drawn from any thread other than the rendering thread are first appended to buffers owned by that thread.
+  ///
+  /// This way many threads can draw at the same time, e.g. during the async phase of the world update, without all of them having to
+  /// go through s_Mutex for every single call. The buffers are merged into s_PerContextData once per frame, right before rendering.
+  /// m_Mutex is only ever contended while merging.
+  struct PerThreadData
   {
-    DoubleBufferedPerContextData& doubleBufferedData = s_PerContextData[context];
+    ezMutex m_Mutex;
+    ezHashTable<ezDebugRendererContext, PerContextData> m_PerContextData[2];
 
-    const ezUInt32 uiDataIndex = ezRenderWorld::IsRenderingThread() && (doubleBufferedData.m_uiLastRenderedFrame != ezRenderWorld::GetFrameCounter()) ? ezRenderWorld::GetDataIndexForRendering() : ezRenderWorld::GetDataIndexForExtraction();
+    bool m_bThreadExited = false;
+    ezUInt32 m_uiMergesSinceExit = 0;
+  };
+
+  static ezDynamicArray<ezUniquePtr<PerThreadData>> s_PerThreadData; // protected by s_Mutex
+  static ezAtomicInteger32 s_iPerThreadDataGeneration;               // incremented on shutdown, invalidates all thread local pointers
+
+  struct ThreadLocalDataPtr
+  {
+    ~ThreadLocalDataPtr()
+    {
+      if (m_pData != nullptr)
+      {
+        EZ_LOCK(s_Mutex);
+
+        // the data itself may still contain primitives for this or the next frame, it is deleted after it was merged
+        if (m_iGeneration == s_iPerThreadDataGeneration)
+        {
+          m_pData->m_bThreadExited = true;
+        }
+      }
+    }
 
-    ezUniquePtr<PerContextData>& pData = doubleBufferedData.m_pData[uiDataIndex];
+    PerThreadData* m_pData = nullptr;
+    ezInt32 m_iGeneration = 0;
+  };
+
+  static thread_local ThreadLocalDataPtr tl_PerThreadData;
+
+  static PerThreadData& GetPerThreadData()
+  {
+    if (tl_PerThreadData.m_pData == nullptr || tl_PerThreadData.m_iGeneration != s_iPerThreadDataGeneration)
+    {
+      EZ_LOCK(s_Mutex);
+
+      ezUniquePtr<PerThreadData>& pData = s_PerThreadData.ExpandAndGetRef();
+      pData = EZ_DEFAULT_NEW(PerThreadData);
+
+      tl_PerThreadData.m_pData = pData.Borrow();
+      tl_PerThreadData.m_iGeneration = s_iPerThreadDataGeneration;
+    }
+
+    return *tl_PerThreadData.m_pData;
+  }
+
+  static PerContextData& GetDataForRendering(const ezDebugRendererContext& context)
+  {
+    const ezUInt32 uiDataIndex = ezRenderWorld::GetDataIndexForRendering();
+
+    ezUniquePtr<PerContextData>& pData = s_PerContextData[context].m_pData[uiDataIndex];
     if (pData == nullptr)
     {
-      doubleBufferedData.m_pData[uiDataIndex] = EZ_DEFAULT_NEW(PerContextData);
+      pData = EZ_DEFAULT_NEW(PerContextData);
     }
 
     return *pData;
   }
 
+  /// \brief Locks and returns the data that the calling thread appends its primitives to.
+  class DataForExtraction
+  {
+  public:
+    DataForExtraction(const ezDebugRendererContext& context)
+    {
+      if (ezRenderWorld::IsRenderingThread())
+      {
+        // The rendering thread draws directly into the shared data, since it may draw while rendering, e.g. persistent items,
+        // and those have to show up in the same frame.
+        m_pMutex = &s_Mutex;
+        m_pMutex->Lock();
+
+        DoubleBufferedPerContextData& doubleBufferedData = s_PerContextData[context];
+
+        const ezUInt32 uiDataIndex = (doubleBufferedData.m_uiLastRenderedFrame != ezRenderWorld::GetFrameCounter()) ? ezRenderWorld::GetDataIndexForRendering() : ezRenderWorld::GetDataIndexForExtraction();
+
+        ezUniquePtr<PerContextData>& pData = doubleBufferedData.m_pData[uiDataIndex];
+        if (pData == nullptr)
+        {
+          pData = EZ_DEFAULT_NEW(PerContextData);
+        }
+
+        m_pData = pData.Borrow();
+      }
+      else
+      {
+        PerThreadData& threadData = GetPerThreadData();
+
+        m_pMutex = &threadData.m_Mutex;
+        m_pMutex->Lock();
+
+        m_pData = &threadData.m_PerContextData[ezRenderWorld::GetDataIndexForExtraction()][context];
+      }
+    }
+
+    ~DataForExtraction()
+    {
+      m_pMutex->Unlock();
+    }
+
+    PerContextData& GetData() { return *m_pData; }
+
+  private:
+    ezMutex* m_pMutex = nullptr;
+    PerContextData* m_pData = nullptr;
+  };
+
+  static void ClearData(PerContextData& ref_data)
+  {
+    ref_data.m_lineVertices.Clear();
+    ref_data.m_line2DVertices.Clear();
+    ref_data.m_lineBoxes.Clear();
+    ref_data.m_lineSpheres.Clear();
+    ref_data.m_solidBoxes.Clear();
+    ref_data.m_triangleVertices.Clear();
+    ref_data.m_triangle2DVertices.Clear();
+    ref_data.m_texTriangle2DVertices.Clear();
+    ref_data.m_texTriangle3DVertices.Clear();
+    ref_data.m_textLines2D.Clear();
+    ref_data.m_textLines3D.Clear();
+
+    for (ezUInt32 i = 0; i < (ezUInt32)ezDebugRenderer::ScreenPlacement::ENUM_COUNT; ++i)
+    {
+      ref_data.m_infoTextData[i].Clear();
+    }
+  }
+
+  static void MergeData(PerContextData& ref_target, PerContextData& ref_source)
+  {
+    ref_target.m_lineVertices.PushBackRange(ref_source.m_lineVertices);
+    ref_target.m_line2DVertices.PushBackRange(ref_source.m_line2DVertices);
+    ref_target.m_lineBoxes.PushBackRange(ref_source.m_lineBoxes);
+    ref_target.m_lineSpheres.PushBackRange(ref_source.m_lineSpheres);
+    ref_target.m_solidBoxes.PushBackRange(ref_source.m_solidBoxes);
+    ref_target.m_triangleVertices.PushBackRange(ref_source.m_triangleVertices);
+    ref_target.m_triangle2DVertices.PushBackRange(ref_source.m_triangle2DVertices);
+    ref_target.m_textLines2D.PushBackRange(ref_source.m_textLines2D);
+    ref_target.m_textLines3D.PushBackRange(ref_source.m_textLines3D);
+
+    for (auto it = ref_source.m_texTriangle2DVertices.GetIterator(); it.IsValid(); ++it)
+    {
+      ref_target.m_texTriangle2DVertices[it.Key()].PushBackRange(it.Value());
+    }
+
+    for (auto it = ref_source.m_texTriangle3DVertices.GetIterator(); it.IsValid(); ++it)
+    {
+      ref_target.m_texTriangle3DVertices[it.Key()].PushBackRange(it.Value());
+    }
+
+    for (ezUInt32 i = 0; i < (ezUInt32)ezDebugRenderer::ScreenPlacement::ENUM_COUNT; ++i)
+    {
+      ref_target.m_infoTextData[i].PushBackRange(ref_source.m_infoTextData[i]);
+    }
+
+    // keeps the capacity, so the thread doesn't need to allocate again next frame
+    ClearData(ref_source);
+  }
+
+  static void MergePerThreadData()
+  {
+    EZ_LOCK(s_Mutex);
+
+    const ezUInt32 uiDataIndex = ezRenderWorld::GetDataIndexForRendering();
+
+    for (ezUInt32 i = 0; i < s_PerThreadData.GetCount();)
+    {
+      PerThreadData& threadData = *s_PerThreadData[i];
+
+      {
+        EZ_LOCK(threadData.m_Mutex);
+
+        for (auto it = threadData.m_PerContextData[uiDataIndex].GetIterator(); it.IsValid(); ++it)
+        {
+          MergeData(GetDataForRendering(it.Key()), it.Value());
+        }
+      }
+
+      // once both data indices have been merged after the thread exited, nobody references its data anymore
+      if (threadData.m_bThreadExited && ++threadData.m_uiMergesSinceExit >= 2)
+      {
+        s_PerThreadData.RemoveAtAndSwap(i);
+      }
+      else
+      {
+        ++i;
+      }
+    }
+  }
+
   static void ClearRenderData()
   {
     EZ_LOCK(s_Mutex);
@@ -142,28 +326,18 @@ namespace
       PerContextData* pData = it.Value().m_pData[ezRenderWorld::GetDataIndexForRendering()].Borrow();
       if (pData)
       {
-        pData->m_lineVertices.Clear();
-        pData->m_line2DVertices.Clear();
-        pData->m_lineBoxes.Clear();
-        pData->m_solidBoxes.Clear();
-        pData->m_triangleVertices.Clear();
-        pData->m_triangle2DVertices.Clear();
-        pData->m_texTriangle2DVertices.Clear();
-        pData->m_texTriangle3DVertices.Clear();
-        pData->m_textLines2D.Clear();
-        pData->m_textLines3D.Clear();
-
-        for (ezUInt32 i = 0; i < (ezUInt32)ezDebugRenderer::ScreenPlacement::ENUM_COUNT; ++i)
-        {
-          pData->m_infoTextData[i].Clear();
-        }
+        ClearData(*pData);
       }
     }
   }
 
   static void OnRenderEvent(const ezRenderWorldRenderEvent& e)
   {
-    if (e.m_Type == ezRenderWorldRenderEvent::Type::EndRender)
+    if (e.m_Type == ezRenderWorldRenderEvent::Type::BeginRender)
+    {
+      MergePerThreadData();
+    }
+    else if (e.m_Type == ezRenderWorldRenderEvent::Type::EndRender)
     {
       ClearRenderData();
     }
@@ -182,6 +356,7 @@ namespace
       TexTriangles3D,
       Glyphs,
       Lines2D,
+      LineSpheres,
 
       Count
     };
@@ -190,6 +365,7 @@ namespace
   static ezGALBufferHandle s_hDataBuffer[BufferType::Count];
 
   static ezMeshBufferResourceHandle s_hLineBoxMeshBuffer;
+  static ezMeshBufferResourceHandle s_hLineSphereMeshBuffer;
   static ezMeshBufferResourceHandle s_hSolidBoxMeshBuffer;
   static ezVertexDeclarationInfo s_VertexDeclarationInfo;
   static ezVertexDeclarationInfo s_TexVertexDeclarationInfo;
@@ -252,6 +428,33 @@ namespace
     }
   }
 
+  enum
+  {
+    CIRCLE_SEGMENTS = 32,
+  };
+
+  /// \brief The points of a unit circle in the XY plane, so that round shapes don't need to evaluate sin and cos for every draw call.
+  struct UnitCircle
+  {
+    UnitCircle()
+    {
+      const ezAngle stepAngle = ezAngle::Degree(360.0f / CIRCLE_SEGMENTS);
+
+      for (ezUInt32 s = 0; s <= CIRCLE_SEGMENTS; ++s)
+      {
+        m_Points[s].Set(ezMath::Cos((float)s * stepAngle), ezMath::Sin((float)s * stepAngle));
+      }
+    }
+
+    ezVec2 m_Points[CIRCLE_SEGMENTS + 1]; ///< The first point is repeated at the end.
+  };
+
+  static const UnitCircle& GetUnitCircle()
+  {
+    static const UnitCircle s_UnitCircle;
+    return s_UnitCircle;
+  }
+
   template <typename AddFunc>
   static ezUInt32 AddTextLines(const ezDebugRendererContext& context, const ezFormatString& text0, const ezVec2I32& positionInPixel, float fSizeInPixel, ezDebugRenderer::HorizontalAlignment horizontalAlignment, ezDebugRenderer::VerticalAlignment verticalAlignment, AddFunc func)
   {
@@ -323,9 +526,9 @@ namespace
       screenPosY -= lines.GetCount() * fLineHeight;
 
     {
-      EZ_LOCK(s_Mutex);
+      DataForExtraction dataForExtraction(context);
 
-      auto& data = GetDataForExtraction(context);
+      auto& data = dataForExtraction.GetData();
 
       ezVec2 currentPos(screenPosX, screenPosY);
 
@@ -455,9 +658,9 @@ void ezDebugRenderer::DrawLines(const ezDebugRendererContext& context, ezArrayPt
   if (lines.IsEmpty())
     return;
 
-  EZ_LOCK(s_Mutex);
+  DataForExtraction dataForExtraction(context);
 
-  auto& data = GetDataForExtraction(context);
+  auto& data = dataForExtraction.GetData();
 
   for (auto& line : lines)
   {
@@ -478,9 +681,9 @@ void ezDebugRenderer::Draw2DLines(const ezDebugRendererContext& context, ezArray
   if (lines.IsEmpty())
     return;
 
-  EZ_LOCK(s_Mutex);
+  DataForExtraction dataForExtraction(context);
 
-  auto& data = GetDataForExtraction(context);
+  auto& data = dataForExtraction.GetData();
 
   for (auto& line : lines)
   {
@@ -506,9 +709,9 @@ void ezDebugRenderer::DrawCross(const ezDebugRendererContext& context, const ezV
   const ezVec3 yAxis = ezVec3::UnitYAxis() * fHalfLineLength;
   const ezVec3 zAxis = ezVec3::UnitZAxis() * fHalfLineLength;
 
-  EZ_LOCK(s_Mutex);
+  DataForExtraction dataForExtraction(context);
 
-  auto& data = GetDataForExtraction(context);
+  auto& data = dataForExtraction.GetData();
 
   data.m_lineVertices.PushBack({transform.TransformPosition(globalPosition - xAxis), color});
   data.m_lineVertices.PushBack({transform.TransformPosition(globalPosition + xAxis), color});
@@ -523,9 +726,9 @@ void ezDebugRenderer::DrawCross(const ezDebugRendererContext& context, const ezV
 // static
 void ezDebugRenderer::DrawLineBox(const ezDebugRendererContext& context, const ezBoundingBox& box, const ezColor& color, const ezTransform& transform)
 {
-  EZ_LOCK(s_Mutex);
+  DataForExtraction dataForExtraction(context);
 
-  auto& data = GetDataForExtraction(context);
+  auto& data = dataForExtraction.GetData();
 
   auto& boxData = data.m_lineBoxes.ExpandAndGetRef();
 
@@ -582,39 +785,17 @@ void ezDebugRenderer::DrawLineBoxCorners(const ezDebugRendererContext& context,
 // static
 void ezDebugRenderer::DrawLineSphere(const ezDebugRendererContext& context, const ezBoundingSphere& sphere, const ezColor& color, const ezTransform& transform /*= ezTransform::IdentityTransform()*/)
 {
-  enum
-  {
-    NUM_SEGMENTS = 32
-  };
-
-  const ezVec3 vCenter = sphere.m_vCenter;
-  const float fRadius = sphere.m_fRadius;
-  const ezAngle stepAngle = ezAngle::Degree(360.0f / NUM_SEGMENTS);
-
-  EZ_LOCK(s_Mutex);
-
-  auto& data = GetDataForExtraction(context);
-
-  for (ezUInt32 s = 0; s < NUM_SEGMENTS; ++s)
-  {
-    const float fS1 = (float)s;
-    const float fS2 = (float)(s + 1);
-
-    const float fCos1 = ezMath::Cos(fS1 * stepAngle);
-    const float fCos2 = ezMath::Cos(fS2 * stepAngle);
+  // rendered as an instance of the unit sphere mesh, like line boxes
+  DataForExtraction dataForExtraction(context);
 
-    const float fSin1 = ezMath::Sin(fS1 * stepAngle);
-    const float fSin2 = ezMath::Sin(fS2 * stepAngle);
+  auto& data = dataForExtraction.GetData();
 
-    data.m_lineVertices.PushBack({transform * (vCenter + ezVec3(0.0f, fCos1, fSin1) * fRadius), color});
-    data.m_lineVertices.PushBack({transform * (vCenter + ezVec3(0.0f, fCos2, fSin2) * fRadius), color});
+  auto& sphereData = data.m_lineSpheres.ExpandAndGetRef();
 
-    data.m_lineVertices.PushBack({transform * (vCenter + ezVec3(fCos1, 0.0f, fSin1) * fRadius), color});
-    data.m_lineVertices.PushBack({transform * (vCenter + ezVec3(fCos2, 0.0f, fSin2) * fRadius), color});
+  ezTransform sphereTransform(sphere.m_vCenter, ezQuat::IdentityQuaternion(), ezVec3(sphere.m_fRadius));
 
-    data.m_lineVertices.PushBack({transform * (vCenter + ezVec3(fCos1, fSin1, 0.0f) * fRadius), color});
-    data.m_lineVertices.PushBack({transform * (vCenter + ezVec3(fCos2, fSin2, 0.0f) * fRadius), color});
-  }
+  sphereData.m_transform = transform * sphereTransform;
+  sphereData.m_color = color;
 }
 
 
@@ -622,12 +803,12 @@ void ezDebugRenderer::DrawLineCapsuleZ(const ezDebugRendererContext& context, fl
 {
   enum
   {
-    NUM_SEGMENTS = 32,
-    NUM_HALF_SEGMENTS = 16,
+    NUM_SEGMENTS = CIRCLE_SEGMENTS,
+    NUM_HALF_SEGMENTS = CIRCLE_SEGMENTS / 2,
     NUM_LINES = NUM_SEGMENTS + NUM_SEGMENTS + NUM_SEGMENTS + NUM_SEGMENTS + 4,
   };
 
-  const ezAngle stepAngle = ezAngle::Degree(360.0f / NUM_SEGMENTS);
+  const ezVec2* pCircle = GetUnitCircle().m_Points;
 
   Line lines[NUM_LINES];
 
@@ -655,14 +836,11 @@ void ezDebugRenderer::DrawLineCapsuleZ(const ezDebugRendererContext& context, fl
   // render top and bottom circle
   for (ezUInt32 s = 0; s < NUM_SEGMENTS; ++s)
   {
-    const float fS1 = (float)s;
-    const float fS2 = (float)(s + 1);
-
-    const float fCos1 = ezMath::Cos(fS1 * stepAngle);
-    const float fCos2 = ezMath::Cos(fS2 * stepAngle);
+    const float fCos1 = pCircle[s].x;
+    const float fCos2 = pCircle[s + 1].x;
 
-    const float fSin1 = ezMath::Sin(fS1 * stepAngle);
-    const float fSin2 = ezMath::Sin(fS2 * stepAngle);
+    const float fSin1 = pCircle[s].y;
+    const float fSin2 = pCircle[s + 1].y;
 
     lines[curLine].m_start = transform * ezVec3(fCos1 * fRadius, fSin1 * fRadius, fOffsetZ);
     lines[curLine].m_end = transform * ezVec3(fCos2 * fRadius, fSin2 * fRadius, fOffsetZ);
@@ -676,14 +854,11 @@ void ezDebugRenderer::DrawLineCapsuleZ(const ezDebugRendererContext& context, fl
   // render top and bottom half circles
   for (ezUInt32 s = 0; s < NUM_HALF_SEGMENTS; ++s)
   {
-    const float fS1 = (float)s;
-    const float fS2 = (float)(s + 1);
-
-    const float fCos1 = ezMath::Cos(fS1 * stepAngle);
-    const float fCos2 = ezMath::Cos(fS2 * stepAngle);
+    const float fCos1 = pCircle[s].x;
+    const float fCos2 = pCircle[s + 1].x;
 
-    const float fSin1 = ezMath::Sin(fS1 * stepAngle);
-    const float fSin2 = ezMath::Sin(fS2 * stepAngle);
+    const float fSin1 = pCircle[s].y;
+    const float fSin2 = pCircle[s + 1].y;
 
     // top two bows
     lines[curLine].m_start = transform * ezVec3(0.0f, fCos1 * fRadius, fSin1 * fRadius + fOffsetZ);
@@ -784,9 +959,9 @@ void ezDebugRenderer::DrawLineFrustum(const ezDebugRendererContext& context, con
 // static
 void ezDebugRenderer::DrawSolidBox(const ezDebugRendererContext& context, const ezBoundingBox& box, const ezColor& color, const ezTransform& transform)
 {
-  EZ_LOCK(s_Mutex);
+  DataForExtraction dataForExtraction(context);
 
-  auto& data = GetDataForExtraction(context);
+  auto& data = dataForExtraction.GetData();
 
   auto& boxData = data.m_solidBoxes.ExpandAndGetRef();
 
@@ -802,9 +977,9 @@ void ezDebugRenderer::DrawSolidTriangles(const ezDebugRendererContext& context,
   if (triangles.IsEmpty())
     return;
 
-  EZ_LOCK(s_Mutex);
+  DataForExtraction dataForExtraction(context);
 
-  auto& data = GetDataForExtraction(context);
+  auto& data = dataForExtraction.GetData();
 
   for (auto& triangle : triangles)
   {
@@ -827,9 +1002,9 @@ void ezDebugRenderer::DrawTexturedTriangles(const ezDebugRendererContext& contex
   ezResourceLock<ezTexture2DResource> pTexture(hTexture, ezResourceAcquireMode::AllowLoadingFallback);
   auto hResourceView = ezGALDevice::GetDefaultDevice()->GetDefaultResourceView(pTexture->GetGALTexture());
 
-  EZ_LOCK(s_Mutex);
+  DataForExtraction dataForExtraction(context);
 
-  auto& data = GetDataForExtraction(context).m_texTriangle3DVertices[hResourceView];
+  auto& data = dataForExtraction.GetData().m_texTriangle3DVertices[hResourceView];
 
   for (auto& triangle : triangles)
   {
@@ -862,9 +1037,9 @@ void ezDebugRenderer::Draw2DRectangle(const ezDebugRendererContext& context, con
   }
 
 
-  EZ_LOCK(s_Mutex);
+  DataForExtraction dataForExtraction(context);
 
-  auto& data = GetDataForExtraction(context);
+  auto& data = dataForExtraction.GetData();
 
   data.m_triangle2DVertices.PushBackRange(ezMakeArrayPtr(vertices));
 }
@@ -898,9 +1073,9 @@ void ezDebugRenderer::Draw2DRectangle(const ezDebugRendererContext& context, con
   }
 
 
-  EZ_LOCK(s_Mutex);
+  DataForExtraction dataForExtraction(context);
 
-  auto& data = GetDataForExtraction(context);
+  auto& data = dataForExtraction.GetData();
 
   data.m_texTriangle2DVertices[hResourceView].PushBackRange(ezMakeArrayPtr(vertices));
 }
@@ -919,9 +1094,9 @@ ezUInt32 ezDebugRenderer::Draw2DText(const ezDebugRendererContext& context, cons
 
 void ezDebugRenderer::DrawInfoText(const ezDebugRendererContext& context, ScreenPlacement placement, const char* groupName, const ezFormatString& text, const ezColor& color)
 {
-  EZ_LOCK(s_Mutex);
+  DataForExtraction dataForExtraction(context);
 
-  auto& data = GetDataForExtraction(context);
+  auto& data = dataForExtraction.GetData();
 
   ezStringBuilder tmp;
 
@@ -1528,7 +1703,11 @@ void ezDebugRenderer::RenderInternal(const ezDebugRendererContext& context, cons
         const ezUInt32 uiNumLineBoxesInBatch = ezMath::Min<ezUInt32>(uiNumLineBoxes, BOXES_PER_BATCH);
         pGALCommandEncoder->UpdateBuffer(s_hDataBuffer[BufferType::LineBoxes], 0, ezMakeArrayPtr(pLineBoxData, uiNumLineBoxesInBatch).ToByteArray());
 
-        renderViewContext.m_pRenderContext->DrawMeshBuffer(0xFFFFFFFF, 0, uiNumLineBoxesInBatch).IgnoreResult();
+        unsigned int uiRenderedInstances = uiNumLineBoxesInBatch;
+        if (renderViewContext.m_pCamera->IsStereoscopic())
+          uiRenderedInstances *= 2;
+
+        renderViewContext.m_pRenderContext->DrawMeshBuffer(0xFFFFFFFF, 0, uiRenderedInstances).IgnoreResult();
 
         uiNumLineBoxes -= uiNumLineBoxesInBatch;
         pLineBoxData += BOXES_PER_BATCH;
@@ -1536,6 +1715,35 @@ void ezDebugRenderer::RenderInternal(const ezDebugRendererContext& context, cons
     }
   }
 
+  // LineSpheres
+  {
+    ezUInt32 uiNumLineSpheres = pData->m_lineSpheres.GetCount();
+    if (uiNumLineSpheres != 0)
+    {
+      CreateDataBuffer(BufferType::LineSpheres, sizeof(BoxData));
+
+      renderViewContext.m_pRenderContext->BindShader(s_hDebugGeometryShader);
+      renderViewContext.m_pRenderContext->BindBuffer("boxData", pDevice->GetDefaultResourceView(s_hDataBuffer[BufferType::LineSpheres]));
+      renderViewContext.m_pRenderContext->BindMeshBuffer(s_hLineSphereMeshBuffer);
+
+      const BoxData* pLineSphereData = pData->m_lineSpheres.GetData();
+      while (uiNumLineSpheres > 0)
+      {
+        const ezUInt32 uiNumLineSpheresInBatch = ezMath::Min<ezUInt32>(uiNumLineSpheres, BOXES_PER_BATCH);
+        pGALCommandEncoder->UpdateBuffer(s_hDataBuffer[BufferType::LineSpheres], 0, ezMakeArrayPtr(pLineSphereData, uiNumLineSpheresInBatch).ToByteArray());
+
+        unsigned int uiRenderedInstances = uiNumLineSpheresInBatch;
+        if (renderViewContext.m_pCamera->IsStereoscopic())
+          uiRenderedInstances *= 2;
+
+        renderViewContext.m_pRenderContext->DrawMeshBuffer(0xFFFFFFFF, 0, uiRenderedInstances).IgnoreResult();
+
+        uiNumLineSpheres -= uiNumLineSpheresInBatch;
+        pLineSphereData += BOXES_PER_BATCH;
+      }
+    }
+  }
+
   // 2D Rectangles
   {
     ezUInt32 uiNum2DVertices = pData->m_triangle2DVertices.GetCount();
@@ -1658,6 +1866,35 @@ void ezDebugRenderer::OnEngineStartup()
     s_hLineBoxMeshBuffer = ezResourceManager::CreateResource<ezMeshBufferResource>("DebugLineBox", std::move(desc), "Mesh for Rendering Debug Line Boxes");
   }
 
+  {
+    // three orthogonal circles with radius one
+    const ezVec2* pCircle = GetUnitCircle().m_Points;
+
+    ezGeometry geom;
+    for (ezUInt32 s = 0; s < CIRCLE_SEGMENTS; ++s)
+    {
+      geom.AddVertex(ezVec3(0.0f, pCircle[s].x, pCircle[s].y), ezVec3(1, 0, 0), ezVec2(0), ezColor::White);
+      geom.AddVertex(ezVec3(pCircle[s].x, 0.0f, pCircle[s].y), ezVec3(0, 1, 0), ezVec2(0), ezColor::White);
+      geom.AddVertex(ezVec3(pCircle[s].x, pCircle[s].y, 0.0f), ezVec3(0, 0, 1), ezVec2(0), ezColor::White);
+    }
+
+    for (ezUInt32 s = 0; s < CIRCLE_SEGMENTS; ++s)
+    {
+      const ezUInt32 uiNext = (s + 1) % CIRCLE_SEGMENTS;
+
+      for (ezUInt32 c = 0; c < 3; ++c)
+      {
+        geom.AddLine(s * 3 + c, uiNext * 3 + c);
+      }
+    }
+
+    ezMeshBufferResourceDescriptor desc;
+    desc.AddStream(ezGALVertexAttributeSemantic::Position, ezGALResourceFormat::XYZFloat);
+    desc.AllocateStreamsFromGeometry(geom, ezGALPrimitiveTopology::Lines);
+
+    s_hLineSphereMeshBuffer = ezResourceManager::CreateResource<ezMeshBufferResource>("DebugLineSphere", std::move(desc), "Mesh for Rendering Debug Line Spheres");
+  }
+
   {
     ezGeometry geom;
     geom.AddBox(ezVec3(2.0f), false);
@@ -1763,6 +2000,7 @@ void ezDebugRenderer::OnEngineShutdown()
   }
 
   s_hLineBoxMeshBuffer.Invalidate();
+  s_hLineSphereMeshBuffer.Invalidate();
   s_hSolidBoxMeshBuffer.Invalidate();
   s_hDebugFontTexture.Invalidate();
 
@@ -1771,6 +2009,13 @@ void ezDebugRenderer::OnEngineShutdown()
   s_hDebugTexturedPrimitiveShader.Invalidate();
   s_hDebugTextShader.Invalidate();
 
+  {
+    EZ_LOCK(s_Mutex);
+
+    s_PerThreadData.Clear();
+    s_iPerThreadDataGeneration.Increment();
+  }
+
   s_PerContextData.Clear();
 
   s_PersistentPerContextData.Clear();
@@ -403,13 +403,28 @@ ezBoundingBoxSphere ezMeshBufferResourceDescriptor::ComputeBounds() const
   {
     if (m_VertexDeclaration.m_VertexStreams[i].m_Semantic == ezGALVertexAttributeSemantic::Position)
     {
-      EZ_ASSERT_DEBUG(m_VertexDeclaration.m_VertexStreams[i].m_Format == ezGALResourceFormat::XYZFloat, "Position format is not usable");
-
-      const ezUInt32 offset = m_VertexDeclaration.m_VertexStreams[i].m_uiOffset;
+      const ezVertexStreamInfo& si = m_VertexDeclaration.m_VertexStreams[i];
+      const ezUInt32 offset = si.m_uiOffset;
 
       if (!m_VertexStreamData.IsEmpty() && m_uiVertexCount > 0)
       {
-        bounds.SetFromPoints(reinterpret_cast<const ezVec3*>(&m_VertexStreamData[offset]), m_uiVertexCount, m_uiVertexSize);
+        if (si.m_Format == ezGALResourceFormat::XYZFloat)
+        {
+          bounds.SetFromPoints(reinterpret_cast<const ezVec3*>(&m_VertexStreamData[offset]), m_uiVertexCount, m_uiVertexSize);
+        }
+        else
+        {
+          // quantized positions, e.g. from ezMeshOptimizer
+          ezDynamicArray<ezVec3> positions;
+          positions.SetCountUninitialized(m_uiVertexCount);
+
+          for (ezUInt32 v = 0; v < m_uiVertexCount; ++v)
+          {
+            EZ_VERIFY(ezMeshBufferUtils::DecodeToVec3(m_VertexStreamData.GetArrayPtr().GetSubArray(m_uiVertexSize * v + offset, si.m_uiElementSize), si.m_Format, positions[v]).Succeeded(), "Position format is not usable");
+          }
+
+          bounds.SetFromPoints(positions.GetData(), m_uiVertexCount);
+        }
       }
 
       return bounds;
@@ -22,6 +22,17 @@ namespace
     }
   }
 
+  const ezVertexStreamInfo* FindVertexStream(const ezMeshBufferResourceDescriptor& meshBufferDesc, ezGALVertexAttributeSemantic::Enum semantic)
+  {
+    for (const ezVertexStreamInfo& si : meshBufferDesc.GetVertexDeclaration().m_VertexStreams)
+    {
+      if (si.m_Semantic == semantic)
+        return &si;
+    }
+
+    return nullptr;
+  }
+
   template <ezUInt32 Bits>
   constexpr inline float ColorUNormToFloat(ezUInt32 value)
   {
@@ -235,6 +246,10 @@ ezResult ezMeshBufferUtils::DecodeToVec3(ezArrayPtr<const ezUInt8> source, ezGAL
       dest = *reinterpret_cast<const ezVec3*>(source.GetPtr());
       return EZ_SUCCESS;
 
+    case ezGALResourceFormat::RGBAHalf:
+      dest = static_cast<ezVec4>(*reinterpret_cast<const ezFloat16Vec4*>(source.GetPtr())).GetAsVec3();
+      return EZ_SUCCESS;
+
     case ezGALResourceFormat::RGBAUShortNormalized:
       dest.x = ezMath::ColorShortToFloat(reinterpret_cast<const ezUInt16*>(source.GetPtr())[0]);
       dest.y = ezMath::ColorShortToFloat(reinterpret_cast<const ezUInt16*>(source.GetPtr())[1]);
@@ -324,6 +339,62 @@ ezResult ezMeshBufferUtils::DecodeToVec4(ezArrayPtr<const ezUInt8> source, ezGAL
   }
 }
 
+// static
+ezResult ezMeshBufferUtils::DecodePositions(const ezMeshBufferResourceDescriptor& meshBufferDesc, ezDynamicArray<ezVec3>& out_Positions)
+{
+  const ezVertexStreamInfo* pStream = FindVertexStream(meshBufferDesc, ezGALVertexAttributeSemantic::Position);
+  if (pStream == nullptr)
+  {
+    ezLog::Error("No position stream found");
+    return EZ_FAILURE;
+  }
+
+  const ezUInt32 uiNumVertices = meshBufferDesc.GetVertexCount();
+  const ezUInt32 uiVertexSize = meshBufferDesc.GetVertexDataSize();
+  const ezArrayPtr<const ezUInt8> vertexData = meshBufferDesc.GetVertexBufferData();
+
+  out_Positions.SetCountUninitialized(uiNumVertices);
+
+  for (ezUInt32 v = 0; v < uiNumVertices; ++v)
+  {
+    if (DecodeToVec3(vertexData.GetSubArray(uiVertexSize * v + pStream->m_uiOffset, pStream->m_uiElementSize), pStream->m_Format, out_Positions[v]).Failed())
+    {
+      ezLog::Error("Unsupported vertex position format {0}", (int)pStream->m_Format);
+      return EZ_FAILURE;
+    }
+  }
+
+  return EZ_SUCCESS;
+}
+
+// static
+ezResult ezMeshBufferUtils::DecodeNormals(const ezMeshBufferResourceDescriptor& meshBufferDesc, ezDynamicArray<ezVec3>& out_Normals)
+{
+  const ezVertexStreamInfo* pStream = FindVertexStream(meshBufferDesc, ezGALVertexAttributeSemantic::Normal);
+  if (pStream == nullptr)
+  {
+    ezLog::Error("No normal stream found");
+    return EZ_FAILURE;
+  }
+
+  const ezUInt32 uiNumVertices = meshBufferDesc.GetVertexCount();
+  const ezUInt32 uiVertexSize = meshBufferDesc.GetVertexDataSize();
+  const ezArrayPtr<const ezUInt8> vertexData = meshBufferDesc.GetVertexBufferData();
+
+  out_Normals.SetCountUninitialized(uiNumVertices);
+
+  for (ezUInt32 v = 0; v < uiNumVertices; ++v)
+  {
+    if (DecodeNormal(vertexData.GetSubArray(uiVertexSize * v + pStream->m_uiOffset, pStream->m_uiElementSize), pStream->m_Format, out_Normals[v]).Failed())
+    {
+      ezLog::Error("Unsupported vertex normal format {0}", (int)pStream->m_Format);
+      return EZ_FAILURE;
+    }
+  }
+
+  return EZ_SUCCESS;
+}
+
 // static
 ezResult ezMeshBufferUtils::GetPositionStream(const ezMeshBufferResourceDescriptor& meshBufferDesc, const ezVec3*& out_pPositions, ezUInt32& out_uiElementStride)
 {
@@ -4,9 +4,50 @@
 #include <Core/WorldSerializer/WorldReader.h>
 #include <Core/WorldSerializer/WorldWriter.h>
 #include <RendererCore/Meshes/MeshComponentBase.h>
+#include <RendererCore/Pipeline/View.h>
 #include <RendererCore/RenderWorld/RenderWorld.h>
 #include <RendererFoundation/Device/Device.h>
 
+namespace
+{
+  /// A finer LOD is only selected once the mesh covers this much more of the screen than the threshold of the current LOD,
+  /// so that meshes close to a threshold don't switch back and forth every frame.
+  constexpr float s_fLodHysteresis = 0.1f;
+
+  /// Returns which fraction of the screen height the bounding sphere covers.
+  float ComputeScreenCoverage(const ezBoundingSphere& sphere, const ezView& view)
+  {
+    const ezCamera* pCamera = view.GetLodCamera();
+    const ezRectFloat& viewport = view.GetViewport();
+
+    if (pCamera == nullptr || viewport.height <= 0.0f)
+      return 1.0f;
+
+    const float fAspectRatio = viewport.width / viewport.height;
+
+    if (pCamera->IsOrthographic())
+      return 2.0f * sphere.m_fRadius / pCamera->GetDimensionY(fAspectRatio);
+
+    const float fDistance = (sphere.m_vCenter - pCamera->GetPosition()).GetLength();
+    if (fDistance <= sphere.m_fRadius)
+      return 1.0f;
+
+    return sphere.m_fRadius / (fDistance * ezMath::Tan(pCamera->GetFovY(fAspectRatio) * 0.5f));
+  }
+
+  /// Returns the coarsest LOD that is still detailed enough for the given screen coverage.
+  ezUInt32 SelectLod(ezArrayPtr<const ezMeshResourceDescriptor::Lod> lods, float fScreenCoverage)
+  {
+    ezUInt32 uiLod = 0;
+    while (uiLod + 1 < lods.GetCount() && fScreenCoverage < lods[uiLod + 1].m_fMaxScreenCoverage)
+    {
+      ++uiLod;
+    }
+
+    return uiLod;
+  }
+} // namespace
+
 //////////////////////////////////////////////////////////////////////////
 
 // clang-format off
@@ -166,7 +207,42 @@ void ezMeshComponentBase::OnMsgExtractRenderData(ezMsgExtractRenderData& msg) co
     return;
 
   ezResourceLock<ezMeshResource> pMesh(m_hMesh, ezResourceAcquireMode::AllowLoadingFallback);
-  ezArrayPtr<const ezMeshResourceDescriptor::SubMesh> parts = pMesh->GetSubMeshes();
+
+  const ezArrayPtr<const ezMeshResourceDescriptor::Lod> lods = pMesh->GetLods();
+  ezUInt32 uiLod = 0;
+
+  if (lods.GetCount() > 1)
+  {
+    const float fScreenCoverage = ComputeScreenCoverage(GetOwner()->GetGlobalBounds().GetSphere(), *msg.m_pView);
+
+    uiLod = SelectLod(lods, fScreenCoverage);
+
+    // Only views that are looked at need hysteresis, shadow and other helper views would just evict their LODs from the slots.
+    const ezEnum<ezCameraUsageHint> usageHint = msg.m_pView->GetCameraUsageHint();
+    if (usageHint == ezCameraUsageHint::MainView || usageHint == ezCameraUsageHint::EditorView)
+    {
+      const ezUInt32 uiViewIndex = msg.m_pView->GetHandle().GetInternalID().m_InstanceIndex;
+      const ezInt32 iViewTag = static_cast<ezInt32>((uiViewIndex + 1) << 8);
+      ezAtomicInteger32& lastLod = m_LastLodPerView[uiViewIndex % EZ_ARRAY_SIZE(m_LastLodPerView)];
+
+      const ezInt32 iLastState = lastLod;
+      if ((iLastState & ~0xFF) == iViewTag)
+      {
+        // stay at a coarser LOD until the coverage is clearly above the threshold
+        const ezUInt32 uiLastLod = ezMath::Min<ezUInt32>(iLastState & 0xFF, lods.GetCount() - 1);
+        while (uiLod < uiLastLod && fScreenCoverage <= lods[uiLod + 1].m_fMaxScreenCoverage * (1.0f + s_fLodHysteresis))
+        {
+          ++uiLod;
+        }
+      }
+
+      lastLod = iViewTag | static_cast<ezInt32>(uiLod);
+    }
+  }
+
+  // the render data references the sub-meshes by their index in the list of all LODs
+  const ezUInt32 uiFirstPart = lods[uiLod].m_uiFirstSubMesh;
+  ezArrayPtr<const ezMeshResourceDescriptor::SubMesh> parts = pMesh->GetAllSubMeshes().GetSubArray(uiFirstPart, lods[uiLod].m_uiSubMeshCount);
 
   for (ezUInt32 uiPartIndex = 0; uiPartIndex < parts.GetCount(); ++uiPartIndex)
   {
@@ -186,13 +262,14 @@ void ezMeshComponentBase::OnMsgExtractRenderData(ezMsgExtractRenderData& msg) co
       pRenderData->m_hMesh = m_hMesh;
       pRenderData->m_hMaterial = hMaterial;
       pRenderData->m_Color = m_Color;
-      pRenderData->m_uiSubMeshIndex = uiPartIndex;
+      pRenderData->m_uiSubMeshIndex = uiFirstPart + uiPartIndex;
       pRenderData->m_uiUniqueID = GetUniqueIdForRendering(uiMaterialIndex);
 
       pRenderData->FillBatchIdAndSortingKey();
     }
 
-    bool bDontCacheYet = false;
+    // the LOD depends on the camera, so the render data can't be cached
+    bool bDontCacheYet = lods.GetCount() > 1;
 
     // Determine render data category.
     ezRenderData::Category category = m_RenderDataCategory;
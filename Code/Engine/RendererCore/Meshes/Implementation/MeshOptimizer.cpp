@@ -0,0 +1,1157 @@
+#include <RendererCore/RendererCorePCH.h>
+
+#include <Foundation/Containers/HashSet.h>
+#include <Foundation/Profiling/Profiling.h>
+#include <RendererCore/Meshes/MeshBufferUtils.h>
+#include <RendererCore/Meshes/MeshOptimizer.h>
+#include <RendererCore/Meshes/MeshResourceDescriptor.h>
+
+namespace
+{
+  void ReadIndices(const ezMeshBufferResourceDescriptor& meshBuffer, ezDynamicArray<ezUInt32>& out_Indices)
+  {
+    const ezUInt32 uiNumIndices = meshBuffer.GetPrimitiveCount() * 3;
+    out_Indices.SetCountUninitialized(uiNumIndices);
+
+    const ezUInt8* pIndexData = meshBuffer.GetIndexBufferData().GetPtr();
+
+    if (meshBuffer.Uses32BitIndices())
+    {
+      ezMemoryUtils::Copy(out_Indices.GetData(), reinterpret_cast<const ezUInt32*>(pIndexData), uiNumIndices);
+    }
+    else
+    {
+      const ezUInt16* pIndices16 = reinterpret_cast<const ezUInt16*>(pIndexData);
+
+      for (ezUInt32 i = 0; i < uiNumIndices; ++i)
+      {
+        out_Indices[i] = pIndices16[i];
+      }
+    }
+  }
+
+  void WriteIndices(ezMeshBufferResourceDescriptor& inout_MeshBuffer, ezArrayPtr<const ezUInt32> indices)
+  {
+    for (ezUInt32 t = 0; t < indices.GetCount() / 3; ++t)
+    {
+      inout_MeshBuffer.SetTriangleIndices(t, indices[t * 3 + 0], indices[t * 3 + 1], indices[t * 3 + 2]);
+    }
+  }
+
+  void RemapVertices(ezMeshBufferResourceDescriptor& inout_MeshBuffer, ezArrayPtr<const ezUInt32> vertexRemap)
+  {
+    const ezUInt32 uiVertexSize = inout_MeshBuffer.GetVertexDataSize();
+
+    ezDynamicArray<ezUInt8, ezAlignedAllocatorWrapper>& vertexData = inout_MeshBuffer.GetVertexBufferData();
+
+    ezDynamicArray<ezUInt8, ezAlignedAllocatorWrapper> remappedData;
+    remappedData.SetCountUninitialized(vertexData.GetCount());
+
+    for (ezUInt32 v = 0; v < vertexRemap.GetCount(); ++v)
+    {
+      ezMemoryUtils::RawByteCopy(remappedData.GetData() + vertexRemap[v] * uiVertexSize, vertexData.GetData() + v * uiVertexSize, uiVertexSize);
+    }
+
+    vertexData = std::move(remappedData);
+  }
+
+  // Tuning values from Tom Forsyth's "Linear-Speed Vertex Cache Optimisation".
+  namespace Forsyth
+  {
+    constexpr ezUInt32 CacheSize = 32;
+    constexpr float CacheDecayPower = 1.5f;
+    constexpr float LastTriangleScore = 0.75f;
+    constexpr float ValenceBoostScale = 2.0f;
+    constexpr float ValenceBoostPower = 0.5f;
+
+    float ComputeVertexScore(ezInt32 iCachePosition, ezUInt32 uiRemainingTriangles)
+    {
+      if (uiRemainingTriangles == 0)
+        return -1.0f;
+
+      float fScore = 0.0f;
+
+      if (iCachePosition >= 0)
+      {
+        if (iCachePosition < 3)
+        {
+          // the vertices of the last triangle get a fixed score, so that there is no preference for strips or fans
+          fScore = LastTriangleScore;
+        }
+        else
+        {
+          const float fScaler = 1.0f / (CacheSize - 3);
+          fScore = ezMath::Pow(1.0f - (iCachePosition - 3) * fScaler, CacheDecayPower);
+        }
+      }
+
+      // vertices with few remaining triangles get a boost, to get rid of them quickly
+      fScore += ValenceBoostScale * ezMath::Pow((float)uiRemainingTriangles, -ValenceBoostPower);
+
+      return fScore;
+    }
+  } // namespace Forsyth
+
+  /// Sum of squared distances to a set of planes, weighted by the area of the triangles that the planes belong to.
+  struct Quadric
+  {
+    double m_fA00 = 0, m_fA11 = 0, m_fA22 = 0, m_fA01 = 0, m_fA02 = 0, m_fA12 = 0;
+    double m_fB0 = 0, m_fB1 = 0, m_fB2 = 0;
+    double m_fC = 0;
+    double m_fWeight = 0;
+
+    void AddPlane(const ezVec3& vNormal, float fDistance, float fWeight)
+    {
+      const double x = vNormal.x, y = vNormal.y, z = vNormal.z, d = fDistance, w = fWeight;
+
+      m_fA00 += w * x * x;
+      m_fA11 += w * y * y;
+      m_fA22 += w * z * z;
+      m_fA01 += w * x * y;
+      m_fA02 += w * x * z;
+      m_fA12 += w * y * z;
+      m_fB0 += w * x * d;
+      m_fB1 += w * y * d;
+      m_fB2 += w * z * d;
+      m_fC += w * d * d;
+      m_fWeight += w;
+    }
+
+    void operator+=(const Quadric& q)
+    {
+      m_fA00 += q.m_fA00;
+      m_fA11 += q.m_fA11;
+      m_fA22 += q.m_fA22;
+      m_fA01 += q.m_fA01;
+      m_fA02 += q.m_fA02;
+      m_fA12 += q.m_fA12;
+      m_fB0 += q.m_fB0;
+      m_fB1 += q.m_fB1;
+      m_fB2 += q.m_fB2;
+      m_fC += q.m_fC;
+      m_fWeight += q.m_fWeight;
+    }
+
+    /// Returns the weighted mean of the squared distances of the point to all planes.
+    double Evaluate(const ezVec3& vPos) const
+    {
+      if (m_fWeight <= 0.0)
+        return 0.0;
+
+      const double x = vPos.x, y = vPos.y, z = vPos.z;
+      const double fResult = m_fA00 * x * x + m_fA11 * y * y + m_fA22 * z * z + 2.0 * (m_fA01 * x * y + m_fA02 * x * z + m_fA12 * y * z) + 2.0 * (m_fB0 * x + m_fB1 * y + m_fB2 * z) + m_fC;
+
+      return ezMath::Max(fResult, 0.0) / m_fWeight;
+    }
+  };
+
+  /// Fills out_VertexTriangles with the triangles of every vertex, the ones of vertex v start at out_TriangleOffsets[v].
+  void BuildVertexTriangles(ezArrayPtr<const ezUInt32> indices, ezUInt32 uiNumVertices, ezDynamicArray<ezUInt32>& out_TriangleOffsets, ezDynamicArray<ezUInt32>& out_VertexTriangles)
+  {
+    out_TriangleOffsets.Clear();
+    out_TriangleOffsets.SetCount(uiNumVertices + 1, 0);
+
+    for (const ezUInt32 uiIndex : indices)
+    {
+      ++out_TriangleOffsets[uiIndex + 1];
+    }
+
+    for (ezUInt32 v = 0; v < uiNumVertices; ++v)
+    {
+      out_TriangleOffsets[v + 1] += out_TriangleOffsets[v];
+    }
+
+    out_VertexTriangles.SetCountUninitialized(indices.GetCount());
+
+    ezDynamicArray<ezUInt32> fillCount;
+    fillCount.SetCount(uiNumVertices, 0);
+
+    for (ezUInt32 i = 0; i < indices.GetCount(); ++i)
+    {
+      const ezUInt32 v = indices[i];
+      out_VertexTriangles[out_TriangleOffsets[v] + fillCount[v]++] = i / 3;
+    }
+  }
+} // namespace
+
+// static
+ezResult ezMeshOptimizer::Optimize(ezMeshResourceDescriptor& inout_Mesh, const Options& options, Statistics* out_pStatsBefore, Statistics* out_pStatsAfter)
+{
+  ezMeshBufferResourceDescriptor& meshBuffer = inout_Mesh.MeshBufferDesc();
+
+  if (meshBuffer.GetTopology() != ezGALPrimitiveTopology::Triangles || !meshBuffer.HasIndexBuffer())
+    return EZ_FAILURE;
+
+  EZ_PROFILE_SCOPE("ezMeshOptimizer::Optimize");
+
+  if (out_pStatsBefore)
+  {
+    *out_pStatsBefore = ComputeStatistics(meshBuffer);
+  }
+
+  const ezUInt32 uiNumVertices = meshBuffer.GetVertexCount();
+
+  ezDynamicArray<ezUInt32> indices;
+  ReadIndices(meshBuffer, indices);
+
+  ezDynamicArray<ezVec3> positions;
+  const bool bOptimizeOverdraw = options.m_bOptimizeOverdraw && ezMeshBufferUtils::DecodePositions(meshBuffer, positions).Succeeded();
+
+  // each sub-mesh is optimized on its own, so that it keeps its triangle range
+  ezHybridArray<ezArrayPtr<ezUInt32>, 8> triangleRanges;
+  for (const ezMeshResourceDescriptor::SubMesh& subMesh : inout_Mesh.GetAllSubMeshes())
+  {
+    if (subMesh.m_uiFirstPrimitive + subMesh.m_uiPrimitiveCount <= indices.GetCount() / 3)
+    {
+      triangleRanges.PushBack(indices.GetArrayPtr().GetSubArray(subMesh.m_uiFirstPrimitive * 3, subMesh.m_uiPrimitiveCount * 3));
+    }
+  }
+
+  if (inout_Mesh.GetAllSubMeshes().IsEmpty())
+  {
+    triangleRanges.PushBack(indices.GetArrayPtr());
+  }
+
+  for (ezArrayPtr<ezUInt32> range : triangleRanges)
+  {
+    if (options.m_bOptimizeVertexCache)
+    {
+      OptimizeVertexCache(range, uiNumVertices);
+    }
+
+    if (bOptimizeOverdraw)
+    {
+      OptimizeOverdraw(range, positions, options.m_fOverdrawThreshold);
+    }
+  }
+
+  if (options.m_bOptimizeVertexFetch)
+  {
+    ezDynamicArray<ezUInt32> vertexRemap;
+    OptimizeVertexFetch(indices, uiNumVertices, vertexRemap);
+    RemapVertices(meshBuffer, vertexRemap);
+  }
+
+  WriteIndices(meshBuffer, indices);
+
+  if (options.m_bQuantizeVertices)
+  {
+    EZ_SUCCEED_OR_RETURN(QuantizeVertices(meshBuffer));
+  }
+
+  if (out_pStatsAfter)
+  {
+    *out_pStatsAfter = ComputeStatistics(meshBuffer);
+  }
+
+  return EZ_SUCCESS;
+}
+
+// static
+ezMeshOptimizer::Statistics ezMeshOptimizer::ComputeStatistics(const ezMeshBufferResourceDescriptor& meshBuffer)
+{
+  Statistics stats;
+  stats.m_uiNumVertices = meshBuffer.GetVertexCount();
+  stats.m_uiVertexSize = meshBuffer.GetVertexDataSize();
+
+  if (meshBuffer.GetTopology() != ezGALPrimitiveTopology::Triangles || !meshBuffer.HasIndexBuffer())
+    return stats;
+
+  ezDynamicArray<ezUInt32> indices;
+  ReadIndices(meshBuffer, indices);
+
+  stats.m_uiNumTriangles = indices.GetCount() / 3;
+  stats.m_uiNumTransformedVertices = SimulateVertexCache(indices, stats.m_uiNumVertices);
+
+  return stats;
+}
+
+// static
+ezUInt32 ezMeshOptimizer::SimulateVertexCache(ezArrayPtr<const ezUInt32> indices, ezUInt32 uiNumVertices, ezUInt32 uiCacheSize)
+{
+  // Instead of shifting a FIFO, every vertex remembers when it was put into the cache.
+  // It is still in the cache as long as less than uiCacheSize other vertices were put in after it.
+  ezDynamicArray<ezUInt32> cacheTimestamps;
+  cacheTimestamps.SetCount(uiNumVertices, 0);
+
+  ezUInt32 uiTimestamp = uiCacheSize + 1;
+  ezUInt32 uiNumTransformed = 0;
+
+  for (const ezUInt32 uiIndex : indices)
+  {
+    if (uiTimestamp - cacheTimestamps[uiIndex] > uiCacheSize)
+    {
+      cacheTimestamps[uiIndex] = uiTimestamp++;
+      ++uiNumTransformed;
+    }
+  }
+
+  return uiNumTransformed;
+}
+
+// static
+void ezMeshOptimizer::OptimizeVertexCache(ezArrayPtr<ezUInt32> inout_Indices, ezUInt32 uiNumVertices)
+{
+  EZ_PROFILE_SCOPE("OptimizeVertexCache");
+
+  const ezUInt32 uiNumTriangles = inout_Indices.GetCount() / 3;
+  if (uiNumTriangles == 0)
+    return;
+
+  // the triangles of each vertex are stored in one array, vertexTriangles[triangleOffsets[v]] is the first triangle of vertex v
+  // the first remainingTriangles[v] entries are the triangles that were not added yet
+  ezDynamicArray<ezUInt32> remainingTriangles;
+  remainingTriangles.SetCount(uiNumVertices, 0);
+
+  for (const ezUInt32 uiIndex : inout_Indices)
+  {
+    ++remainingTriangles[uiIndex];
+  }
+
+  ezDynamicArray<ezUInt32> triangleOffsets;
+  triangleOffsets.SetCountUninitialized(uiNumVertices + 1);
+  triangleOffsets[0] = 0;
+
+  for (ezUInt32 v = 0; v < uiNumVertices; ++v)
+  {
+    triangleOffsets[v + 1] = triangleOffsets[v] + remainingTriangles[v];
+  }
+
+  ezDynamicArray<ezUInt32> vertexTriangles;
+  vertexTriangles.SetCountUninitialized(inout_Indices.GetCount());
+
+  {
+    ezDynamicArray<ezUInt32> fillCount;
+    fillCount.SetCount(uiNumVertices, 0);
+
+    for (ezUInt32 i = 0; i < inout_Indices.GetCount(); ++i)
+    {
+      const ezUInt32 v = inout_Indices[i];
+      vertexTriangles[triangleOffsets[v] + fillCount[v]++] = i / 3;
+    }
+  }
+
+  ezDynamicArray<ezInt32> cachePositions;
+  cachePositions.SetCount(uiNumVertices, -1);
+
+  ezDynamicArray<float> vertexScores;
+  vertexScores.SetCountUninitialized(uiNumVertices);
+
+  for (ezUInt32 v = 0; v < uiNumVertices; ++v)
+  {
+    vertexScores[v] = Forsyth::ComputeVertexScore(-1, remainingTriangles[v]);
+  }
+
+  ezDynamicArray<float> triangleScores;
+  triangleScores.SetCountUninitialized(uiNumTriangles);
+
+  ezDynamicArray<bool> triangleAdded;
+  triangleAdded.SetCount(uiNumTriangles, false);
+
+  ezUInt32 uiBestTriangle = 0;
+  for (ezUInt32 t = 0; t < uiNumTriangles; ++t)
+  {
+    triangleScores[t] = vertexScores[inout_Indices[t * 3 + 0]] + vertexScores[inout_Indices[t * 3 + 1]] + vertexScores[inout_Indices[t * 3 + 2]];
+
+    if (triangleScores[t] > triangleScores[uiBestTriangle])
+    {
+      uiBestTriangle = t;
+    }
+  }
+
+  ezDynamicArray<ezUInt32> result;
+  result.SetCountUninitialized(inout_Indices.GetCount());
+
+  ezUInt32 cache[Forsyth::CacheSize + 3];
+  ezUInt32 newCache[Forsyth::CacheSize + 3];
+  ezUInt32 uiCacheCount = 0;
+
+  ezUInt32 uiNextUnaddedTriangle = 0;
+
+  for (ezUInt32 uiNumAdded = 0; uiNumAdded < uiNumTriangles; ++uiNumAdded)
+  {
+    if (uiBestTriangle == ezInvalidIndex)
+    {
+      // none of the vertices in the cache has any triangles left, continue with the next triangle in the original order
+      while (triangleAdded[uiNextUnaddedTriangle])
+      {
+        ++uiNextUnaddedTriangle;
+      }
+
+      uiBestTriangle = uiNextUnaddedTriangle;
+    }
+
+    triangleAdded[uiBestTriangle] = true;
+
+    const ezUInt32* pTriangle = &inout_Indices[uiBestTriangle * 3];
+    ezMemoryUtils::Copy(&result[uiNumAdded * 3], pTriangle, 3);
+
+    // the vertices of the new triangle go to the front of the cache, the others move back
+    ezUInt32 uiNewCacheCount = 0;
+    for (ezUInt32 i = 0; i < 3; ++i)
+    {
+      const ezUInt32 v = pTriangle[i];
+      newCache[uiNewCacheCount++] = v;
+
+      // remove the triangle from the list of remaining triangles of the vertex
+      ezUInt32* pVertexTriangles = &vertexTriangles[triangleOffsets[v]];
+      for (ezUInt32 j = 0; j < remainingTriangles[v]; ++j)
+      {
+        if (pVertexTriangles[j] == uiBestTriangle)
+        {
+          pVertexTriangles[j] = pVertexTriangles[remainingTriangles[v] - 1];
+          --remainingTriangles[v];
+          break;
+        }
+      }
+    }
+
+    for (ezUInt32 i = 0; i < uiCacheCount; ++i)
+    {
+      const ezUInt32 v = cache[i];
+      if (v != pTriangle[0] && v != pTriangle[1] && v != pTriangle[2])
+      {
+        newCache[uiNewCacheCount++] = v;
+      }
+    }
+
+    // update the scores of all vertices that moved in the cache, including the ones that fell out of it
+    uiBestTriangle = ezInvalidIndex;
+    float fBestScore = -1.0f;
+
+    for (ezUInt32 i = 0; i < uiNewCacheCount; ++i)
+    {
+      const ezUInt32 v = newCache[i];
+      const ezInt32 iCachePosition = i < Forsyth::CacheSize ? static_cast<ezInt32>(i) : -1;
+
+      cachePositions[v] = iCachePosition;
+
+      const float fNewScore = Forsyth::ComputeVertexScore(iCachePosition, remainingTriangles[v]);
+      const float fScoreDiff = fNewScore - vertexScores[v];
+      vertexScores[v] = fNewScore;
+
+      const ezUInt32* pVertexTriangles = &vertexTriangles[triangleOffsets[v]];
+      for (ezUInt32 j = 0; j < remainingTriangles[v]; ++j)
+      {
+        const ezUInt32 t = pVertexTriangles[j];
+        triangleScores[t] += fScoreDiff;
+
+        if (iCachePosition >= 0 && triangleScores[t] > fBestScore)
+        {
+          fBestScore = triangleScores[t];
+          uiBestTriangle = t;
+        }
+      }
+    }
+
+    uiCacheCount = ezMath::Min(uiNewCacheCount, Forsyth::CacheSize);
+    ezMemoryUtils::Copy(cache, newCache, uiCacheCount);
+  }
+
+  ezMemoryUtils::Copy(inout_Indices.GetPtr(), result.GetData(), result.GetCount());
+}
+
+// static
+void ezMeshOptimizer::OptimizeOverdraw(ezArrayPtr<ezUInt32> inout_Indices, ezArrayPtr<const ezVec3> positions, float fThreshold)
+{
+  EZ_PROFILE_SCOPE("OptimizeOverdraw");
+
+  const ezUInt32 uiNumTriangles = inout_Indices.GetCount() / 3;
+  const ezUInt32 uiNumVertices = positions.GetCount();
+  if (uiNumTriangles == 0)
+    return;
+
+  const float fMeshACMR = (float)SimulateVertexCache(inout_Indices, uiNumVertices) / uiNumTriangles;
+
+  // Split the triangles into clusters. Where all three vertices of a triangle miss the cache, a new cluster can start without any cost.
+  // Within those, the cache is restarted as soon as the cluster has a cache efficiency that is close enough to the one of the whole mesh.
+  ezDynamicArray<ezUInt32> clusterStarts;
+
+  {
+    ezDynamicArray<ezUInt32> cacheTimestamps;
+    cacheTimestamps.SetCount(uiNumVertices, 0);
+
+    const ezUInt32 uiCacheSize = StatisticsCacheSize;
+    ezUInt32 uiTimestamp = uiCacheSize + 1;
+
+    ezUInt32 uiClusterStart = 0;
+    ezUInt32 uiClusterMisses = 0;
+    clusterStarts.PushBack(0);
+
+    for (ezUInt32 t = 0; t < uiNumTriangles; ++t)
+    {
+      ezUInt32 uiMisses = 0;
+      for (ezUInt32 i = 0; i < 3; ++i)
+      {
+        const ezUInt32 v = inout_Indices[t * 3 + i];
+        if (uiTimestamp - cacheTimestamps[v] > uiCacheSize)
+        {
+          cacheTimestamps[v] = uiTimestamp++;
+          ++uiMisses;
+        }
+      }
+
+      if (uiMisses == 3 && t > uiClusterStart)
+      {
+        clusterStarts.PushBack(t);
+        uiClusterStart = t;
+        uiClusterMisses = 0;
+      }
+
+      uiClusterMisses += uiMisses;
+
+      if (t + 1 < uiNumTriangles && (float)uiClusterMisses / (t + 1 - uiClusterStart) <= fMeshACMR * fThreshold)
+      {
+        clusterStarts.PushBack(t + 1);
+        uiClusterStart = t + 1;
+        uiClusterMisses = 0;
+
+        // the next cluster may be drawn after any other one, so it can't rely on the cache content
+        uiTimestamp += uiCacheSize + 1;
+      }
+    }
+  }
+
+  const ezUInt32 uiNumClusters = clusterStarts.GetCount();
+  clusterStarts.PushBack(uiNumTriangles);
+
+  struct Cluster
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezUInt32 m_uiIndex;
+    float m_fSortKey;
+  };
+
+  ezDynamicArray<Cluster> clusters;
+  clusters.SetCount(uiNumClusters);
+
+  ezDynamicArray<ezVec3> clusterCentroids;
+  clusterCentroids.SetCountUninitialized(uiNumClusters);
+
+  ezDynamicArray<ezVec3> clusterNormals;
+  clusterNormals.SetCountUninitialized(uiNumClusters);
+
+  ezVec3 vMeshCentroid = ezVec3::ZeroVector();
+  float fMeshArea = 0.0f;
+
+  for (ezUInt32 c = 0; c < uiNumClusters; ++c)
+  {
+    ezVec3 vCentroid = ezVec3::ZeroVector();
+    ezVec3 vNormal = ezVec3::ZeroVector();
+    float fArea = 0.0f;
+
+    for (ezUInt32 t = clusterStarts[c]; t < clusterStarts[c + 1]; ++t)
+    {
+      const ezVec3& p0 = positions[inout_Indices[t * 3 + 0]];
+      const ezVec3& p1 = positions[inout_Indices[t * 3 + 1]];
+      const ezVec3& p2 = positions[inout_Indices[t * 3 + 2]];
+
+      // the length of the cross product is twice the triangle area, so summing it up weights the normal by area
+      const ezVec3 vCross = (p1 - p0).CrossRH(p2 - p0);
+      const float fTriangleArea = vCross.GetLength();
+
+      vNormal += vCross;
+      vCentroid += (p0 + p1 + p2) * (fTriangleArea / 3.0f);
+      fArea += fTriangleArea;
+    }
+
+    vMeshCentroid += vCentroid;
+    fMeshArea += fArea;
+
+    clusterCentroids[c] = fArea > 0.0f ? vCentroid / fArea : positions[inout_Indices[clusterStarts[c] * 3]];
+    clusterNormals[c] = vNormal;
+    clusterNormals[c].NormalizeIfNotZero(ezVec3::ZeroVector()).IgnoreResult();
+  }
+
+  if (fMeshArea > 0.0f)
+  {
+    vMeshCentroid /= fMeshArea;
+  }
+
+  // clusters that face away from the center are on the outside of the mesh and occlude the ones further inside, so they are drawn first
+  for (ezUInt32 c = 0; c < uiNumClusters; ++c)
+  {
+    clusters[c].m_uiIndex = c;
+    clusters[c].m_fSortKey = (clusterCentroids[c] - vMeshCentroid).Dot(clusterNormals[c]);
+  }
+
+  clusters.Sort([](const Cluster& a, const Cluster& b) {
+    if (a.m_fSortKey != b.m_fSortKey)
+      return a.m_fSortKey > b.m_fSortKey;
+
+    return a.m_uiIndex < b.m_uiIndex;
+  });
+
+  ezDynamicArray<ezUInt32> result;
+  result.Reserve(inout_Indices.GetCount());
+
+  for (const Cluster& cluster : clusters)
+  {
+    const ezUInt32 uiFirstIndex = clusterStarts[cluster.m_uiIndex] * 3;
+    const ezUInt32 uiLastIndex = clusterStarts[cluster.m_uiIndex + 1] * 3;
+
+    result.PushBackRange(inout_Indices.GetSubArray(uiFirstIndex, uiLastIndex - uiFirstIndex));
+  }
+
+  ezMemoryUtils::Copy(inout_Indices.GetPtr(), result.GetData(), result.GetCount());
+}
+
+// static
+void ezMeshOptimizer::OptimizeVertexFetch(ezArrayPtr<ezUInt32> inout_Indices, ezUInt32 uiNumVertices, ezDynamicArray<ezUInt32>& out_VertexRemap)
+{
+  out_VertexRemap.Clear();
+  out_VertexRemap.SetCount(uiNumVertices, ezInvalidIndex);
+
+  ezUInt32 uiNextVertex = 0;
+
+  for (ezUInt32& uiIndex : inout_Indices)
+  {
+    if (out_VertexRemap[uiIndex] == ezInvalidIndex)
+    {
+      out_VertexRemap[uiIndex] = uiNextVertex++;
+    }
+
+    uiIndex = out_VertexRemap[uiIndex];
+  }
+
+  for (ezUInt32& uiNewIndex : out_VertexRemap)
+  {
+    if (uiNewIndex == ezInvalidIndex)
+    {
+      uiNewIndex = uiNextVertex++;
+    }
+  }
+}
+
+// static
+ezResult ezMeshOptimizer::GenerateLods(ezMeshResourceDescriptor& inout_Mesh, const LodOptions& options)
+{
+  ezMeshBufferResourceDescriptor& meshBuffer = inout_Mesh.MeshBufferDesc();
+
+  if (meshBuffer.GetTopology() != ezGALPrimitiveTopology::Triangles || !meshBuffer.HasIndexBuffer())
+    return EZ_FAILURE;
+
+  EZ_PROFILE_SCOPE("ezMeshOptimizer::GenerateLods");
+
+  ezDynamicArray<ezVec3> positions;
+  EZ_SUCCEED_OR_RETURN(ezMeshBufferUtils::DecodePositions(meshBuffer, positions));
+
+  // throw away existing LODs, their triangles are at the end of the index buffer
+  ezDynamicArray<ezUInt32> indices;
+  ReadIndices(meshBuffer, indices);
+  indices.SetCount(inout_Mesh.GetNumPrimitivesOfFirstLod() * 3);
+
+  inout_Mesh.ClearLods();
+
+  ezHybridArray<ezMeshResourceDescriptor::SubMesh, 8> subMeshes;
+  subMeshes = inout_Mesh.GetSubMeshes();
+
+  if (subMeshes.IsEmpty())
+  {
+    auto& subMesh = subMeshes.ExpandAndGetRef();
+    subMesh.m_uiFirstPrimitive = 0;
+    subMesh.m_uiPrimitiveCount = indices.GetCount() / 3;
+    subMesh.m_uiMaterialIndex = 0;
+  }
+
+  ezBoundingBoxSphere bounds;
+  bounds.SetFromPoints(positions.GetData(), positions.GetCount());
+
+  // the error is relative to the diameter of the bounding sphere, that is what the screen coverage is measured with
+  const float fMeshSize = ezMath::Max(2.0f * bounds.m_fSphereRadius, ezMath::SmallEpsilon<float>());
+  const ezUInt32 uiNumLod0Indices = indices.GetCount();
+
+  ezUInt32 uiPrevNumTriangles = uiNumLod0Indices / 3;
+  float fPrevError = 0.0f;
+  float fPrevScreenCoverage = 1.0f;
+  float fTriangleRatio = 1.0f;
+
+  ezDynamicArray<ezUInt32> simplified;
+
+  for (ezUInt32 uiLod = 1; uiLod < options.m_uiNumLods; ++uiLod)
+  {
+    fTriangleRatio *= options.m_fTriangleReduction;
+
+    const ezUInt32 uiFirstLodIndex = indices.GetCount();
+    float fLodError = 0.0f;
+
+    ezHybridArray<ezMeshResourceDescriptor::SubMesh, 8> lodSubMeshes;
+
+    for (const ezMeshResourceDescriptor::SubMesh& subMesh : subMeshes)
+    {
+      if (subMesh.m_uiFirstPrimitive + subMesh.m_uiPrimitiveCount > uiNumLod0Indices / 3)
+        continue;
+
+      const ezArrayPtr<const ezUInt32> subMeshIndices = indices.GetArrayPtr().GetSubArray(subMesh.m_uiFirstPrimitive * 3, subMesh.m_uiPrimitiveCount * 3);
+      const ezUInt32 uiTargetCount = static_cast<ezUInt32>(subMesh.m_uiPrimitiveCount * fTriangleRatio);
+
+      // always simplify the full detail mesh, to not accumulate the errors of the previous LODs
+      fLodError = ezMath::Max(fLodError, Simplify(subMeshIndices, positions, uiTargetCount, options.m_fMaxError * fMeshSize, simplified));
+
+      auto& lodSubMesh = lodSubMeshes.ExpandAndGetRef();
+      lodSubMesh.m_uiFirstPrimitive = indices.GetCount() / 3;
+      lodSubMesh.m_uiPrimitiveCount = simplified.GetCount() / 3;
+      lodSubMesh.m_uiMaterialIndex = subMesh.m_uiMaterialIndex;
+
+      indices.PushBackRange(simplified);
+    }
+
+    const ezUInt32 uiNumTriangles = (indices.GetCount() - uiFirstLodIndex) / 3;
+
+    // stop when the error limit prevents any further meaningful reduction
+    if (uiNumTriangles == 0 || uiNumTriangles > uiPrevNumTriangles * 0.9f)
+    {
+      indices.SetCount(uiFirstLodIndex);
+      break;
+    }
+
+    // the error (in pixels) is the relative error times the screen coverage times the screen height
+    const float fError = ezMath::Max(fPrevError, fLodError / fMeshSize);
+    float fScreenCoverage = fPrevScreenCoverage;
+
+    if (fError > 0.0f)
+    {
+      fScreenCoverage = ezMath::Min(fPrevScreenCoverage, options.m_fMaxPixelError / (fError * options.m_fReferenceScreenHeight));
+    }
+
+    inout_Mesh.AddLod(fScreenCoverage, fError);
+
+    for (const ezMeshResourceDescriptor::SubMesh& lodSubMesh : lodSubMeshes)
+    {
+      inout_Mesh.AddSubMesh(lodSubMesh.m_uiPrimitiveCount, lodSubMesh.m_uiFirstPrimitive, lodSubMesh.m_uiMaterialIndex);
+    }
+
+    uiPrevNumTriangles = uiNumTriangles;
+    fPrevError = fError;
+    fPrevScreenCoverage = fScreenCoverage;
+  }
+
+  const ezUInt32 uiIndexSize = meshBuffer.Uses32BitIndices() ? sizeof(ezUInt32) : sizeof(ezUInt16);
+  meshBuffer.GetIndexBufferData().SetCount(indices.GetCount() * uiIndexSize);
+  WriteIndices(meshBuffer, indices);
+
+  return EZ_SUCCESS;
+}
+
+// static
+float ezMeshOptimizer::Simplify(ezArrayPtr<const ezUInt32> indices, ezArrayPtr<const ezVec3> positions, ezUInt32 uiTargetTriangleCount, float fMaxError, ezDynamicArray<ezUInt32>& out_Indices)
+{
+  EZ_PROFILE_SCOPE("Simplify");
+
+  out_Indices = indices;
+
+  const ezUInt32 uiNumVertices = positions.GetCount();
+  ezUInt32 uiNumTriangles = indices.GetCount() / 3;
+
+  if (uiNumTriangles <= uiTargetTriangleCount)
+    return 0.0f;
+
+  // vertices at the same position share one ID, that way seams can be detected and the quadrics are the same on both sides of a seam
+  ezDynamicArray<ezUInt32> positionIds;
+  positionIds.SetCountUninitialized(uiNumVertices);
+
+  {
+    ezDynamicArray<ezUInt32> sortedVertices;
+    sortedVertices.SetCountUninitialized(uiNumVertices);
+    for (ezUInt32 v = 0; v < uiNumVertices; ++v)
+    {
+      sortedVertices[v] = v;
+    }
+
+    sortedVertices.Sort([&](ezUInt32 a, ezUInt32 b) {
+      const ezVec3& pa = positions[a];
+      const ezVec3& pb = positions[b];
+
+      if (pa.x != pb.x)
+        return pa.x < pb.x;
+      if (pa.y != pb.y)
+        return pa.y < pb.y;
+      if (pa.z != pb.z)
+        return pa.z < pb.z;
+
+      return a < b;
+    });
+
+    for (ezUInt32 i = 0; i < uiNumVertices; ++i)
+    {
+      const bool bSamePosition = i > 0 && positions[sortedVertices[i]] == positions[sortedVertices[i - 1]];
+      positionIds[sortedVertices[i]] = bSamePosition ? positionIds[sortedVertices[i - 1]] : sortedVertices[i];
+    }
+  }
+
+  // vertices on open borders and seams must not move, otherwise holes would open up
+  ezDynamicArray<bool> locked;
+  locked.SetCount(uiNumVertices, false);
+
+  {
+    ezDynamicArray<ezUInt32> referencingVertex;
+    referencingVertex.SetCount(uiNumVertices, ezInvalidIndex);
+
+    for (const ezUInt32 v : indices)
+    {
+      ezUInt32& uiReferencing = referencingVertex[positionIds[v]];
+
+      if (uiReferencing == ezInvalidIndex)
+        uiReferencing = v;
+      else if (uiReferencing != v)
+        locked[positionIds[v]] = true;
+    }
+
+    ezHashSet<ezUInt64> edges;
+    edges.Reserve(indices.GetCount());
+
+    for (ezUInt32 i = 0; i < indices.GetCount(); ++i)
+    {
+      const ezUInt64 p0 = positionIds[indices[i]];
+      const ezUInt64 p1 = positionIds[indices[i - (i % 3) + (i + 1) % 3]];
+      edges.Insert((p0 << 32) | p1);
+    }
+
+    for (ezUInt32 i = 0; i < indices.GetCount(); ++i)
+    {
+      const ezUInt64 p0 = positionIds[indices[i]];
+      const ezUInt64 p1 = positionIds[indices[i - (i % 3) + (i + 1) % 3]];
+
+      if (!edges.Contains((p1 << 32) | p0))
+      {
+        locked[static_cast<ezUInt32>(p0)] = true;
+        locked[static_cast<ezUInt32>(p1)] = true;
+      }
+    }
+  }
+
+  ezDynamicArray<Quadric> quadrics;
+  quadrics.SetCount(uiNumVertices);
+
+  for (ezUInt32 t = 0; t < uiNumTriangles; ++t)
+  {
+    const ezVec3& p0 = positions[indices[t * 3 + 0]];
+    const ezVec3& p1 = positions[indices[t * 3 + 1]];
+    const ezVec3& p2 = positions[indices[t * 3 + 2]];
+
+    ezVec3 vNormal = (p1 - p0).CrossRH(p2 - p0);
+    const float fArea = vNormal.GetLengthAndNormalize();
+
+    if (fArea <= 0.0f)
+      continue;
+
+    const float fDistance = -vNormal.Dot(p0);
+
+    for (ezUInt32 i = 0; i < 3; ++i)
+    {
+      quadrics[positionIds[indices[t * 3 + i]]].AddPlane(vNormal, fDistance, fArea);
+    }
+  }
+
+  struct Collapse
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezUInt32 m_uiVertex;
+    ezUInt32 m_uiTarget;
+    float m_fError;
+  };
+
+  ezDynamicArray<Collapse> collapses;
+  ezDynamicArray<ezUInt32> triangleOffsets;
+  ezDynamicArray<ezUInt32> vertexTriangles;
+  ezDynamicArray<ezUInt32> remap;
+  ezDynamicArray<bool> touched;
+  ezHybridArray<ezUInt32, 16> neighbors;
+
+  const double fMaxSquaredError = static_cast<double>(fMaxError) * fMaxError;
+  double fResultError = 0.0;
+
+  // Every pass collapses as many edges as possible, starting with the cheapest ones.
+  // A vertex can only be part of one collapse per pass, so that the error and flip checks see the final positions.
+  while (uiNumTriangles > uiTargetTriangleCount)
+  {
+    BuildVertexTriangles(out_Indices, uiNumVertices, triangleOffsets, vertexTriangles);
+
+    collapses.Clear();
+
+    for (ezUInt32 v = 0; v < uiNumVertices; ++v)
+    {
+      if (locked[positionIds[v]] || triangleOffsets[v] == triangleOffsets[v + 1])
+        continue;
+
+      Collapse best = {v, ezInvalidIndex, 0.0f};
+      double fBestError = fMaxSquaredError;
+
+      for (ezUInt32 j = triangleOffsets[v]; j < triangleOffsets[v + 1]; ++j)
+      {
+        const ezUInt32* pTriangle = &out_Indices[vertexTriangles[j] * 3];
+
+        for (ezUInt32 i = 0; i < 3; ++i)
+        {
+          const ezUInt32 uiTarget = pTriangle[i];
+          if (uiTarget == v)
+            continue;
+
+          Quadric combined = quadrics[positionIds[v]];
+          combined += quadrics[positionIds[uiTarget]];
+
+          const double fError = combined.Evaluate(positions[uiTarget]);
+          if (fError <= fBestError)
+          {
+            fBestError = fError;
+            best.m_uiTarget = uiTarget;
+            best.m_fError = static_cast<float>(fError);
+          }
+        }
+      }
+
+      if (best.m_uiTarget != ezInvalidIndex)
+      {
+        collapses.PushBack(best);
+      }
+    }
+
+    collapses.Sort([](const Collapse& a, const Collapse& b) {
+      if (a.m_fError != b.m_fError)
+        return a.m_fError < b.m_fError;
+
+      return a.m_uiVertex < b.m_uiVertex;
+    });
+
+    remap.SetCountUninitialized(uiNumVertices);
+    for (ezUInt32 v = 0; v < uiNumVertices; ++v)
+    {
+      remap[v] = v;
+    }
+
+    touched.Clear();
+    touched.SetCount(uiNumVertices, false);
+
+    const ezUInt32 uiTrianglesToRemove = uiNumTriangles - uiTargetTriangleCount;
+    ezUInt32 uiNumRemoved = 0;
+    ezUInt32 uiNumCollapsed = 0;
+
+    for (const Collapse& collapse : collapses)
+    {
+      if (uiNumRemoved >= uiTrianglesToRemove)
+        break;
+
+      const ezUInt32 v = collapse.m_uiVertex;
+      const ezUInt32 uiTarget = collapse.m_uiTarget;
+
+      if (touched[v] || touched[uiTarget])
+        continue;
+
+      // triangles that would flip over are not allowed
+      bool bFlips = false;
+      ezUInt32 uiTrianglesRemoved = 0;
+
+      for (ezUInt32 j = triangleOffsets[v]; j < triangleOffsets[v + 1] && !bFlips; ++j)
+      {
+        const ezUInt32* pTriangle = &out_Indices[vertexTriangles[j] * 3];
+
+        if (pTriangle[0] == uiTarget || pTriangle[1] == uiTarget || pTriangle[2] == uiTarget)
+        {
+          ++uiTrianglesRemoved;
+          continue;
+        }
+
+        ezVec3 p[3];
+        ezVec3 pMoved[3];
+        for (ezUInt32 i = 0; i < 3; ++i)
+        {
+          p[i] = positions[pTriangle[i]];
+          pMoved[i] = pTriangle[i] == v ? positions[uiTarget] : p[i];
+        }
+
+        const ezVec3 vNormal = (p[1] - p[0]).CrossRH(p[2] - p[0]);
+        const ezVec3 vMovedNormal = (pMoved[1] - pMoved[0]).CrossRH(pMoved[2] - pMoved[0]);
+
+        bFlips = vNormal.Dot(vMovedNormal) <= 0.0f;
+      }
+
+      if (bFlips)
+        continue;
+
+      // vertices that are connected to both, but not through one of the removed triangles, would end up with duplicate edges and fold the surface
+      neighbors.Clear();
+      for (ezUInt32 j = triangleOffsets[v]; j < triangleOffsets[v + 1]; ++j)
+      {
+        const ezUInt32* pTriangle = &out_Indices[vertexTriangles[j] * 3];
+        for (ezUInt32 i = 0; i < 3; ++i)
+        {
+          if (pTriangle[i] != v && pTriangle[i] != uiTarget && !neighbors.Contains(pTriangle[i]))
+            neighbors.PushBack(pTriangle[i]);
+        }
+      }
+
+      ezUInt32 uiNumSharedNeighbors = 0;
+      for (ezUInt32 j = triangleOffsets[uiTarget]; j < triangleOffsets[uiTarget + 1]; ++j)
+      {
+        const ezUInt32* pTriangle = &out_Indices[vertexTriangles[j] * 3];
+        for (ezUInt32 i = 0; i < 3; ++i)
+        {
+          if (neighbors.RemoveAndSwap(pTriangle[i]))
+            ++uiNumSharedNeighbors;
+        }
+      }
+
+      if (uiNumSharedNeighbors > uiTrianglesRemoved)
+        continue;
+
+      remap[v] = uiTarget;
+      quadrics[positionIds[uiTarget]] += quadrics[positionIds[v]];
+      fResultError = ezMath::Max<double>(fResultError, collapse.m_fError);
+
+      uiNumRemoved += uiTrianglesRemoved;
+      ++uiNumCollapsed;
+
+      // the neighbors must not move in this pass either, the flip check above assumed their current positions
+      for (ezUInt32 j = triangleOffsets[v]; j < triangleOffsets[v + 1]; ++j)
+      {
+        const ezUInt32* pTriangle = &out_Indices[vertexTriangles[j] * 3];
+        touched[pTriangle[0]] = true;
+        touched[pTriangle[1]] = true;
+        touched[pTriangle[2]] = true;
+      }
+    }
+
+    if (uiNumCollapsed == 0)
+      break;
+
+    // apply the collapses and remove the triangles that became degenerate
+    ezUInt32 uiNumKept = 0;
+    for (ezUInt32 t = 0; t < uiNumTriangles; ++t)
+    {
+      const ezUInt32 i0 = remap[out_Indices[t * 3 + 0]];
+      const ezUInt32 i1 = remap[out_Indices[t * 3 + 1]];
+      const ezUInt32 i2 = remap[out_Indices[t * 3 + 2]];
+
+      if (i0 == i1 || i0 == i2 || i1 == i2)
+        continue;
+
+      out_Indices[uiNumKept * 3 + 0] = i0;
+      out_Indices[uiNumKept * 3 + 1] = i1;
+      out_Indices[uiNumKept * 3 + 2] = i2;
+      ++uiNumKept;
+    }
+
+    uiNumTriangles = uiNumKept;
+    out_Indices.SetCount(uiNumTriangles * 3);
+  }
+
+  return static_cast<float>(ezMath::Sqrt(fResultError));
+}
+
+// static
+ezResult ezMeshOptimizer::QuantizeVertices(ezMeshBufferResourceDescriptor& inout_MeshBuffer)
+{
+  EZ_PROFILE_SCOPE("QuantizeVertices");
+
+  const ezVertexDeclarationInfo& sourceDecl = inout_MeshBuffer.GetVertexDeclaration();
+
+  ezMeshBufferResourceDescriptor quantized;
+  bool bAnyChanges = false;
+
+  for (const ezVertexStreamInfo& si : sourceDecl.m_VertexStreams)
+  {
+    ezGALResourceFormat::Enum format = si.m_Format;
+
+    switch (si.m_Semantic)
+    {
+      case ezGALVertexAttributeSemantic::Position:
+        // 16 bit floats are still read as float3 by the shaders, so the vertex shaders don't need to know about this
+        if (format == ezGALResourceFormat::XYZFloat)
+          format = ezGALResourceFormat::RGBAHalf;
+        break;
+
+      case ezGALVertexAttributeSemantic::Normal:
+        format = ezMeshNormalPrecision::ToResourceFormatNormal(ezMeshNormalPrecision::_10Bit);
+        break;
+
+      case ezGALVertexAttributeSemantic::Tangent:
+        format = ezMeshNormalPrecision::ToResourceFormatTangent(ezMeshNormalPrecision::_10Bit);
+        break;
+
+      case ezGALVertexAttributeSemantic::TexCoord0:
+      case ezGALVertexAttributeSemantic::TexCoord1:
+        if (format == ezGALResourceFormat::UVFloat)
+          format = ezMeshTexCoordPrecision::ToResourceFormat(ezMeshTexCoordPrecision::_16Bit);
+        break;
+
+      default:
+        break;
+    }
+
+    bAnyChanges |= format != si.m_Format;
+    quantized.AddStream(si.m_Semantic, format);
+  }
+
+  if (!bAnyChanges)
+    return EZ_SUCCESS;
+
+  const ezUInt32 uiNumVertices = inout_MeshBuffer.GetVertexCount();
+
+  quantized.AllocateStreams(uiNumVertices, inout_MeshBuffer.GetTopology(), inout_MeshBuffer.GetPrimitiveCount());
+  quantized.GetIndexBufferData() = inout_MeshBuffer.GetIndexBufferData();
+
+  const ezVertexDeclarationInfo& targetDecl = quantized.GetVertexDeclaration();
+
+  for (ezUInt32 s = 0; s < sourceDecl.m_VertexStreams.GetCount(); ++s)
+  {
+    const ezVertexStreamInfo& sourceStream = sourceDecl.m_VertexStreams[s];
+    const ezGALResourceFormat::Enum sourceFormat = sourceStream.m_Format;
+    const ezGALResourceFormat::Enum targetFormat = targetDecl.m_VertexStreams[s].m_Format;
+
+    for (ezUInt32 v = 0; v < uiNumVertices; ++v)
+    {
+      const ezArrayPtr<const ezUInt8> source = inout_MeshBuffer.GetVertexData(s, v).GetSubArray(0, sourceStream.m_uiElementSize);
+      const ezArrayPtr<ezUInt8> target = quantized.GetVertexData(s, v);
+
+      if (sourceFormat == targetFormat)
+      {
+        ezMemoryUtils::RawByteCopy(target.GetPtr(), source.GetPtr(), source.GetCount());
+        continue;
+      }
+
+      switch (sourceStream.m_Semantic)
+      {
+        case ezGALVertexAttributeSemantic::Position:
+        {
+          ezVec3 vPosition;
+          EZ_SUCCEED_OR_RETURN(ezMeshBufferUtils::DecodeToVec3(source, sourceFormat, vPosition));
+          EZ_SUCCEED_OR_RETURN(ezMeshBufferUtils::EncodeFromVec4(vPosition.GetAsVec4(1.0f), target, targetFormat));
+          break;
+        }
+
+        case ezGALVertexAttributeSemantic::Normal:
+        {
+          ezVec3 vNormal;
+          EZ_SUCCEED_OR_RETURN(ezMeshBufferUtils::DecodeNormal(source, sourceFormat, vNormal));
+          EZ_SUCCEED_OR_RETURN(ezMeshBufferUtils::EncodeNormal(vNormal, target, targetFormat));
+          break;
+        }
+
+        case ezGALVertexAttributeSemantic::Tangent:
+        {
+          ezVec3 vTangent;
+          float fBiTangentSign;
+          EZ_SUCCEED_OR_RETURN(ezMeshBufferUtils::DecodeTangent(source, sourceFormat, vTangent, fBiTangentSign));
+          EZ_SUCCEED_OR_RETURN(ezMeshBufferUtils::EncodeTangent(vTangent, fBiTangentSign, target, targetFormat));
+          break;
+        }
+
+        default:
+        {
+          ezVec2 vTexCoord;
+          EZ_SUCCEED_OR_RETURN(ezMeshBufferUtils::DecodeTexCoord(source, sourceFormat, vTexCoord));
+          EZ_SUCCEED_OR_RETURN(ezMeshBufferUtils::EncodeTexCoord(vTexCoord, target, targetFormat));
+          break;
+        }
+      }
+    }
+  }
+
+  inout_MeshBuffer = quantized;
+  return EZ_SUCCESS;
+}
+
+
+EZ_STATICLINK_FILE(RendererCore, RendererCore_Meshes_Implementation_MeshOptimizer);
@@ -52,7 +52,7 @@ void ezMeshRenderer::RenderBatch(const ezRenderViewContext& renderViewContext, c
   ezResourceLock<ezMeshResource> pMesh(hMesh, ezResourceAcquireMode::AllowLoadingFallback);
 
   // This can happen when the resource has been reloaded and now has fewer submeshes.
-  const auto& subMeshes = pMesh->GetSubMeshes();
+  const auto& subMeshes = pMesh->GetAllSubMeshes();
   if (subMeshes.GetCount() <= uiPartIndex)
   {
     return;
@@ -17,6 +17,7 @@ ezMeshResource::ezMeshResource()
   : ezResource(DoUpdate::OnAnyThread, 1)
 {
   m_Bounds.SetInvalid();
+  m_Lods.SetCount(1);
 }
 
 ezResourceLoadDesc ezMeshResource::UnloadData(Unload WhatToUnload)
@@ -31,6 +32,8 @@ ezResourceLoadDesc ezMeshResource::UnloadData(Unload WhatToUnload)
   {
     m_SubMeshes.Clear();
     m_SubMeshes.Compact();
+    m_Lods.SetCount(1);
+    m_Lods[0] = ezMeshResourceDescriptor::Lod();
     m_Materials.Clear();
     m_Materials.Compact();
     m_Bones.Clear();
@@ -106,7 +109,8 @@ EZ_RESOURCE_IMPLEMENT_CREATEABLE(ezMeshResource, ezMeshResourceDescriptor)
     m_hMeshBuffer = ezResourceManager::CreateResource<ezMeshBufferResource>(sMbName, std::move(mb), GetResourceDescription());
   }
 
-  m_SubMeshes = descriptor.GetSubMeshes();
+  m_SubMeshes = descriptor.GetAllSubMeshes();
+  m_Lods = descriptor.GetLods();
 
   m_Materials.Clear();
   m_Materials.Reserve(descriptor.GetMaterials().GetCount());
@@ -13,6 +13,7 @@
 ezMeshResourceDescriptor::ezMeshResourceDescriptor()
 {
   m_Bounds.SetInvalid();
+  m_Lods.SetCount(1);
 }
 
 void ezMeshResourceDescriptor::Clear()
@@ -22,6 +23,8 @@ void ezMeshResourceDescriptor::Clear()
   m_Materials.Clear();
   m_MeshBufferDescriptor.Clear();
   m_SubMeshes.Clear();
+  m_Lods.Clear();
+  m_Lods.SetCount(1);
 }
 
 ezMeshBufferResourceDescriptor& ezMeshResourceDescriptor::MeshBufferDesc()
@@ -51,7 +54,21 @@ ezArrayPtr<const ezMeshResourceDescriptor::Material> ezMeshResourceDescriptor::G
 
 ezArrayPtr<const ezMeshResourceDescriptor::SubMesh> ezMeshResourceDescriptor::GetSubMeshes() const
 {
-  return m_SubMeshes;
+  return m_SubMeshes.GetArrayPtr().GetSubArray(0, m_Lods[0].m_uiSubMeshCount);
+}
+
+ezUInt32 ezMeshResourceDescriptor::GetNumPrimitivesOfFirstLod() const
+{
+  if (m_Lods.GetCount() == 1)
+    return m_MeshBufferDescriptor.GetPrimitiveCount();
+
+  ezUInt32 uiNumPrimitives = 0;
+  for (const SubMesh& subMesh : GetSubMeshes())
+  {
+    uiNumPrimitives = ezMath::Max(uiNumPrimitives, subMesh.m_uiFirstPrimitive + subMesh.m_uiPrimitiveCount);
+  }
+
+  return uiNumPrimitives;
 }
 
 const ezBoundingBoxSphere& ezMeshResourceDescriptor::GetBounds() const
@@ -68,6 +85,21 @@ void ezMeshResourceDescriptor::AddSubMesh(ezUInt32 uiPrimitiveCount, ezUInt32 ui
   p.m_Bounds.SetInvalid();
 
   m_SubMeshes.PushBack(p);
+  m_Lods.PeekBack().m_uiSubMeshCount++;
+}
+
+void ezMeshResourceDescriptor::AddLod(float fMaxScreenCoverage, float fError)
+{
+  Lod& lod = m_Lods.ExpandAndGetRef();
+  lod.m_uiFirstSubMesh = m_SubMeshes.GetCount();
+  lod.m_fMaxScreenCoverage = fMaxScreenCoverage;
+  lod.m_fError = fError;
+}
+
+void ezMeshResourceDescriptor::ClearLods()
+{
+  m_SubMeshes.SetCount(m_Lods[0].m_uiSubMeshCount);
+  m_Lods.SetCount(1);
 }
 
 void ezMeshResourceDescriptor::SetMaterial(ezUInt32 uiMaterialIndex, const char* szPathToMaterial)
@@ -145,6 +177,23 @@ void ezMeshResourceDescriptor::Save(ezStreamWriter& stream)
     chunk.EndChunk();
   }
 
+  if (m_Lods.GetCount() > 1)
+  {
+    chunk.BeginChunk("Lods", 1);
+
+    chunk << m_Lods.GetCount();
+
+    for (const Lod& lod : m_Lods)
+    {
+      chunk << lod.m_uiFirstSubMesh;
+      chunk << lod.m_uiSubMeshCount;
+      chunk << lod.m_fMaxScreenCoverage;
+      chunk << lod.m_fError;
+    }
+
+    chunk.EndChunk();
+  }
+
   {
     chunk.BeginChunk("MeshInfo", 4);
 
@@ -314,6 +363,7 @@ ezResult ezMeshResourceDescriptor::Load(ezStreamReader& stream)
   bool bHasIndexBuffer = false;
   bool b32BitIndices = false;
   bool bCalculateBounds = true;
+  bool bHasLods = false;
 
   while (chunk.GetCurrentChunk().m_bValid)
   {
@@ -366,6 +416,28 @@ ezResult ezMeshResourceDescriptor::Load(ezStreamReader& stream)
       }
     }
 
+    if (ci.m_sChunkName == "Lods")
+    {
+      if (ci.m_uiChunkVersion != 1)
+      {
+        ezLog::Error("Version of chunk '{0}' is invalid ({1})", ci.m_sChunkName, ci.m_uiChunkVersion);
+        return EZ_FAILURE;
+      }
+
+      chunk >> count;
+      m_Lods.SetCount(count);
+
+      for (Lod& lod : m_Lods)
+      {
+        chunk >> lod.m_uiFirstSubMesh;
+        chunk >> lod.m_uiSubMeshCount;
+        chunk >> lod.m_fMaxScreenCoverage;
+        chunk >> lod.m_fError;
+      }
+
+      bHasLods = true;
+    }
+
     if (ci.m_sChunkName == "MeshInfo")
     {
       if (ci.m_uiChunkVersion > 4)
@@ -489,6 +561,12 @@ ezResult ezMeshResourceDescriptor::Load(ezStreamReader& stream)
 
   chunk.EndStream();
 
+  if (!bHasLods)
+  {
+    m_Lods.SetCount(1);
+    m_Lods[0].m_uiSubMeshCount = m_SubMeshes.GetCount();
+  }
+
   if (bCalculateBounds)
   {
     ComputeBounds();
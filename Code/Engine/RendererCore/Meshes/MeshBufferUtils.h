@@ -77,7 +77,15 @@ struct EZ_RENDERERCORE_DLL ezMeshBufferUtils
   static ezResult DecodeToVec3(ezArrayPtr<const ezUInt8> source, ezGALResourceFormat::Enum sourceFormat, ezVec3& dest);
   static ezResult DecodeToVec4(ezArrayPtr<const ezUInt8> source, ezGALResourceFormat::Enum sourceFormat, ezVec4& dest);
 
+  /// \brief Decodes the positions of all vertices. Unlike GetPositionStream() this also supports quantized positions.
+  static ezResult DecodePositions(const ezMeshBufferResourceDescriptor& meshBufferDesc, ezDynamicArray<ezVec3>& out_Positions);
+
+  /// \brief Decodes the normals of all vertices in any format that DecodeNormal() supports.
+  static ezResult DecodeNormals(const ezMeshBufferResourceDescriptor& meshBufferDesc, ezDynamicArray<ezVec3>& out_Normals);
+
   /// \brief Helper function to get the position stream from the given mesh buffer descriptor
+  ///
+  /// Only 32 bit float positions can be accessed directly, use DecodePositions() to support meshes with quantized positions as well.
   static ezResult GetPositionStream(const ezMeshBufferResourceDescriptor& meshBufferDesc, const ezVec3*& out_pPositions, ezUInt32& out_uiElementStride);
 
   /// \brief Helper function to get the position and normal stream from the given mesh buffer descriptor
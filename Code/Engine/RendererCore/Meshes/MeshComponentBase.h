@@ -114,4 +114,9 @@ protected:
   ezMeshResourceHandle m_hMesh;
   ezDynamicArray<ezMaterialResourceHandle> m_Materials;
   ezColor m_Color = ezColor::White;
+
+  /// The LOD that was rendered last in up to two views, to switch LODs with hysteresis. Each slot stores a tag of the view in the upper bits
+  /// and the LOD in the lowest byte. Views are extracted in parallel, so the slots are atomic. A view that doesn't find its tag in its slot
+  /// selects the LOD without hysteresis.
+  mutable ezAtomicInteger32 m_LastLodPerView[2];
 };
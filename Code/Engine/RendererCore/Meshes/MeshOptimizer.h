@@ -0,0 +1,115 @@
+#pragma once
+
+#include <Foundation/Containers/DynamicArray.h>
+#include <Foundation/Math/Vec3.h>
+#include <RendererCore/RendererCoreDLL.h>
+
+class ezMeshResourceDescriptor;
+struct ezMeshBufferResourceDescriptor;
+
+/// \brief Reorders and compresses the data of triangle meshes to make them faster to render.
+///
+/// All functions work on the CPU only and are meant to be used while importing or generating meshes.
+/// The order in which the steps are applied matters, Optimize() runs them in the recommended order:
+/// first the vertex cache optimization, then the overdraw optimization (which keeps most of the vertex cache efficiency),
+/// then the vertex fetch optimization (which only changes the vertex order) and finally the quantization.
+struct EZ_RENDERERCORE_DLL ezMeshOptimizer
+{
+  struct Options
+  {
+    /// Reorders the triangles of each sub-mesh, such that vertices are reused while they are still in the post-transform cache.
+    bool m_bOptimizeVertexCache = true;
+
+    /// Reorders clusters of triangles, such that triangles that face outwards are drawn first, which reduces overdraw.
+    bool m_bOptimizeOverdraw = true;
+
+    /// How much the vertex cache efficiency may get worse by the overdraw optimization. 1.05 allows the ACMR to go up by 5%.
+    float m_fOverdrawThreshold = 1.05f;
+
+    /// Reorders the vertices in the order in which they are first used by the triangles.
+    bool m_bOptimizeVertexFetch = true;
+
+    /// Stores positions as 16 bit floats, normals and tangents with 10 bits per component and texture coordinates as 16 bit floats.
+    ///
+    /// \note Code that reads the positions of a mesh on the CPU has to decode them with ezMeshBufferUtils::DecodePositions(),
+    /// ezMeshBufferUtils::GetPositionStream() only gives access to 32 bit float positions.
+    bool m_bQuantizeVertices = false;
+  };
+
+  /// \brief Describes how well a mesh uses the post-transform vertex cache, measured with a simulated FIFO cache.
+  struct Statistics
+  {
+    ezUInt32 m_uiNumTriangles = 0;
+    ezUInt32 m_uiNumVertices = 0;
+    ezUInt32 m_uiVertexSize = 0;
+    ezUInt32 m_uiNumTransformedVertices = 0;
+
+    /// \brief Average cache miss ratio: transformed vertices per triangle. Between 0.5 (ideal) and 3.
+    float GetACMR() const { return m_uiNumTriangles > 0 ? (float)m_uiNumTransformedVertices / m_uiNumTriangles : 0.0f; }
+
+    /// \brief Average transformed vertex ratio: how often each vertex is transformed on average. 1 is ideal.
+    float GetATVR() const { return m_uiNumVertices > 0 ? (float)m_uiNumTransformedVertices / m_uiNumVertices : 0.0f; }
+  };
+
+  struct LodOptions
+  {
+    /// The number of LODs, including the full detail one.
+    ezUInt32 m_uiNumLods = 4;
+
+    /// Each LOD gets this fraction of the triangles of the previous one.
+    float m_fTriangleReduction = 0.5f;
+
+    /// The largest simplification error that is accepted, relative to the size of the mesh. LODs that can't be reduced enough within this error are skipped.
+    float m_fMaxError = 0.05f;
+
+    /// The screen coverage at which a LOD is used, is chosen such that its error is at most this many pixels at the reference screen height.
+    float m_fMaxPixelError = 1.0f;
+    float m_fReferenceScreenHeight = 1080.0f;
+  };
+
+  /// \brief The cache size used for the statistics. Most GPUs have a larger cache, but a small size gives more meaningful numbers.
+  static constexpr ezUInt32 StatisticsCacheSize = 16;
+
+  /// \brief Applies all the steps that are enabled in the options to the mesh. Sub-meshes keep their triangle ranges.
+  ///
+  /// Fails if the mesh doesn't consist of indexed triangles. If given, the statistics of the mesh before and after the optimization are written out.
+  static ezResult Optimize(ezMeshResourceDescriptor& inout_Mesh, const Options& options, Statistics* out_pStatsBefore = nullptr, Statistics* out_pStatsAfter = nullptr);
+
+  /// \brief Computes the vertex cache statistics of an indexed triangle mesh.
+  static Statistics ComputeStatistics(const ezMeshBufferResourceDescriptor& meshBuffer);
+
+  /// \brief Computes how many vertices a FIFO cache of the given size would have to transform for the triangle list.
+  static ezUInt32 SimulateVertexCache(ezArrayPtr<const ezUInt32> indices, ezUInt32 uiNumVertices, ezUInt32 uiCacheSize = StatisticsCacheSize);
+
+  /// \brief Reorders the triangles for a better usage of the post-transform vertex cache, using Tom Forsyth's linear-speed algorithm.
+  static void OptimizeVertexCache(ezArrayPtr<ezUInt32> inout_Indices, ezUInt32 uiNumVertices);
+
+  /// \brief Reorders clusters of triangles by how much they face outwards, so that triangles that occlude others are drawn first.
+  ///
+  /// The triangles are expected to be optimized for the vertex cache already. Clusters are split where the cache would be empty anyway,
+  /// and additionally where the cache efficiency of the cluster so far is within fThreshold of the whole mesh.
+  static void OptimizeOverdraw(ezArrayPtr<ezUInt32> inout_Indices, ezArrayPtr<const ezVec3> positions, float fThreshold);
+
+  /// \brief Computes a new vertex order, in which the vertices are sorted by their first use in the index buffer.
+  ///
+  /// The indices are changed to the new order. out_VertexRemap[uiOldIndex] is the new index of each vertex.
+  /// Vertices that are not referenced at all are moved to the end.
+  static void OptimizeVertexFetch(ezArrayPtr<ezUInt32> inout_Indices, ezUInt32 uiNumVertices, ezDynamicArray<ezUInt32>& out_VertexRemap);
+
+  /// \brief Adds simplified versions of all sub-meshes as additional LODs to the mesh, see ezMeshResourceDescriptor::AddLod().
+  ///
+  /// The LODs reuse the vertices of the full detail mesh, only their triangles are added to the index buffer.
+  /// Existing LODs are replaced. Fails if the mesh doesn't consist of indexed triangles.
+  static ezResult GenerateLods(ezMeshResourceDescriptor& inout_Mesh, const LodOptions& options);
+
+  /// \brief Reduces the number of triangles by collapsing edges in the order of their quadric error.
+  ///
+  /// Edges are collapsed into one of their vertices, so the result only references vertices of the input.
+  /// Vertices on open borders and on attribute seams (different vertices at the same position) are never removed.
+  /// Stops when uiTargetTriangleCount is reached, or when every remaining collapse would cause an error larger than fMaxError.
+  /// Returns the error of the result: the largest (area weighted RMS) distance of a collapsed vertex to the planes of the triangles it replaced.
+  static float Simplify(ezArrayPtr<const ezUInt32> indices, ezArrayPtr<const ezVec3> positions, ezUInt32 uiTargetTriangleCount, float fMaxError, ezDynamicArray<ezUInt32>& out_Indices);
+
+  /// \brief Converts the vertex streams of the mesh buffer to the compact formats described at Options::m_bQuantizeVertices.
+  static ezResult QuantizeVertices(ezMeshBufferResourceDescriptor& inout_MeshBuffer);
+};
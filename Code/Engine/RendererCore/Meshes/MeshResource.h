@@ -14,8 +14,14 @@ class EZ_RENDERERCORE_DLL ezMeshResource : public ezResource
 public:
   ezMeshResource();
 
-  /// \brief Returns the array of sub-meshes in this mesh.
-  ezArrayPtr<const ezMeshResourceDescriptor::SubMesh> GetSubMeshes() const { return m_SubMeshes; }
+  /// \brief Returns the array of sub-meshes in this mesh, at full detail.
+  ezArrayPtr<const ezMeshResourceDescriptor::SubMesh> GetSubMeshes() const { return m_SubMeshes.GetArrayPtr().GetSubArray(0, m_Lods[0].m_uiSubMeshCount); }
+
+  /// \brief Returns the sub-meshes of all LODs. ezMeshRenderData::m_uiSubMeshIndex is an index into this array.
+  ezArrayPtr<const ezMeshResourceDescriptor::SubMesh> GetAllSubMeshes() const { return m_SubMeshes; }
+
+  /// \brief Returns the levels of detail of this mesh, there is always at least one.
+  ezArrayPtr<const ezMeshResourceDescriptor::Lod> GetLods() const { return m_Lods; }
 
   /// \brief Returns the mesh buffer that is used by this resource.
   const ezMeshBufferResourceHandle& GetMeshBuffer() const { return m_hMeshBuffer; }
@@ -37,6 +43,7 @@ private:
   virtual void UpdateMemoryUsage(MemoryUsage& out_NewMemoryUsage) override;
 
   ezDynamicArray<ezMeshResourceDescriptor::SubMesh> m_SubMeshes;
+  ezHybridArray<ezMeshResourceDescriptor::Lod, 1> m_Lods;
   ezMeshBufferResourceHandle m_hMeshBuffer;
   ezDynamicArray<ezMaterialResourceHandle> m_Materials;
 
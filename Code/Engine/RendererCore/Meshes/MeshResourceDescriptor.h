@@ -19,6 +19,17 @@ public:
     ezBoundingBoxSphere m_Bounds;
   };
 
+  /// \brief A level of detail of the mesh: a range of sub-meshes that all use the same mesh buffer.
+  struct Lod
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezUInt32 m_uiFirstSubMesh = 0;
+    ezUInt32 m_uiSubMeshCount = 0;
+    float m_fMaxScreenCoverage = 1.0f; ///< The LOD is used once the mesh covers less than this fraction of the screen height.
+    float m_fError = 0.0f;             ///< The simplification error of the LOD, relative to the size of the mesh.
+  };
+
   struct Material
   {
     ezString m_sPath;
@@ -34,8 +45,18 @@ public:
 
   void UseExistingMeshBuffer(const ezMeshBufferResourceHandle& hBuffer);
 
+  /// \brief Adds a sub-mesh to the last LOD.
   void AddSubMesh(ezUInt32 uiPrimitiveCount, ezUInt32 uiFirstPrimitive, ezUInt32 uiMaterialIndex);
 
+  /// \brief Starts a new, coarser level of detail. All sub-meshes that are added afterwards belong to it.
+  ///
+  /// LOD 0 always exists and contains all sub-meshes that were added before the first call.
+  /// The primitives of all LODs are stored in the same mesh buffer, see GetNumPrimitivesOfFirstLod().
+  void AddLod(float fMaxScreenCoverage, float fError);
+
+  /// \brief Removes all LODs except for LOD 0. Doesn't change the mesh buffer.
+  void ClearLods();
+
   void SetMaterial(ezUInt32 uiMaterialIndex, const char* szPathToMaterial);
 
   void Save(ezStreamWriter& stream);
@@ -48,8 +69,19 @@ public:
 
   ezArrayPtr<const Material> GetMaterials() const;
 
+  /// \brief Returns the sub-meshes of LOD 0.
   ezArrayPtr<const SubMesh> GetSubMeshes() const;
 
+  /// \brief Returns the sub-meshes of all LODs, use GetLods() to find the ones of a specific LOD.
+  ezArrayPtr<const SubMesh> GetAllSubMeshes() const { return m_SubMeshes; }
+
+  ezArrayPtr<const Lod> GetLods() const { return m_Lods; }
+
+  /// \brief Returns how many primitives at the start of the mesh buffer belong to LOD 0.
+  ///
+  /// Code that needs the full detail geometry of the mesh, e.g. for collision, should ignore all primitives after these.
+  ezUInt32 GetNumPrimitivesOfFirstLod() const;
+
   void ComputeBounds();
   const ezBoundingBoxSphere& GetBounds() const;
   void SetBounds(const ezBoundingBoxSphere& bounds) { m_Bounds = bounds; }
@@ -70,6 +102,7 @@ public:
 private:
   ezHybridArray<Material, 8> m_Materials;
   ezHybridArray<SubMesh, 8> m_SubMeshes;
+  ezHybridArray<Lod, 1> m_Lods;
   ezMeshBufferResourceDescriptor m_MeshBufferDescriptor;
   ezMeshBufferResourceHandle m_hMeshBuffer;
   ezBoundingBoxSphere m_Bounds;
@@ -52,6 +52,7 @@ EZ_STATICLINK_LIBRARY(RendererCore)
   EZ_STATICLINK_REFERENCE(RendererCore_Meshes_Implementation_MeshBufferUtils);
   EZ_STATICLINK_REFERENCE(RendererCore_Meshes_Implementation_MeshComponent);
   EZ_STATICLINK_REFERENCE(RendererCore_Meshes_Implementation_MeshComponentBase);
+  EZ_STATICLINK_REFERENCE(RendererCore_Meshes_Implementation_MeshOptimizer);
   EZ_STATICLINK_REFERENCE(RendererCore_Meshes_Implementation_MeshRenderer);
   EZ_STATICLINK_REFERENCE(RendererCore_Meshes_Implementation_MeshResource);
   EZ_STATICLINK_REFERENCE(RendererCore_Meshes_Implementation_MeshResourceDescriptor);
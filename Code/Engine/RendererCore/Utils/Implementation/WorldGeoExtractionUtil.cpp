@@ -85,10 +85,10 @@ void ezWorldGeoExtractionUtil::WriteWorldGeometryToOBJ(const char* szFile, const
     }
 
     const auto& meshBufferDesc = pCpuMesh->GetDescriptor().MeshBufferDesc();
+    const ezUInt32 uiNumPrimitives = pCpuMesh->GetDescriptor().GetNumPrimitivesOfFirstLod(); // ignore the triangles of the coarser LODs
 
-    const ezVec3* pPositions = nullptr;
-    ezUInt32 uiElementStride = 0;
-    if (ezMeshBufferUtils::GetPositionStream(meshBufferDesc, pPositions, uiElementStride).Failed())
+    ezDynamicArray<ezVec3> positions;
+    if (ezMeshBufferUtils::DecodePositions(meshBufferDesc, positions).Failed())
     {
       continue;
     }
@@ -96,14 +96,12 @@ void ezWorldGeoExtractionUtil::WriteWorldGeometryToOBJ(const char* szFile, const
     ezMat4 finalTransform = transform * object.m_GlobalTransform.GetAsMat4();
 
     // write out all vertices
-    for (ezUInt32 i = 0; i < meshBufferDesc.GetVertexCount(); ++i)
+    for (const ezVec3& vPosition : positions)
     {
-      const ezVec3 pos = finalTransform.TransformPosition(*pPositions);
+      const ezVec3 pos = finalTransform.TransformPosition(vPosition);
 
       line.Format("v {0} {1} {2}\n", ezArgF(pos.x, 8), ezArgF(pos.y, 8), ezArgF(pos.z, 8));
       file.WriteBytes(line.GetData(), line.GetElementCount()).IgnoreResult();
-
-      pPositions = ezMemoryUtils::AddByteOffset(pPositions, uiElementStride);
     }
 
     // collect all indices
@@ -115,7 +113,7 @@ void ezWorldGeoExtractionUtil::WriteWorldGeometryToOBJ(const char* szFile, const
       {
         const ezUInt32* pTypedIndices = reinterpret_cast<const ezUInt32*>(meshBufferDesc.GetIndexBufferData().GetPtr());
 
-        for (ezUInt32 p = 0; p < meshBufferDesc.GetPrimitiveCount(); ++p)
+        for (ezUInt32 p = 0; p < uiNumPrimitives; ++p)
         {
           indices.PushBack(pTypedIndices[p * 3 + (flip ? 2 : 0)] + uiVertexOffset);
           indices.PushBack(pTypedIndices[p * 3 + 1] + uiVertexOffset);
@@ -126,7 +124,7 @@ void ezWorldGeoExtractionUtil::WriteWorldGeometryToOBJ(const char* szFile, const
       {
         const ezUInt16* pTypedIndices = reinterpret_cast<const ezUInt16*>(meshBufferDesc.GetIndexBufferData().GetPtr());
 
-        for (ezUInt32 p = 0; p < meshBufferDesc.GetPrimitiveCount(); ++p)
+        for (ezUInt32 p = 0; p < uiNumPrimitives; ++p)
         {
           indices.PushBack(pTypedIndices[p * 3 + (flip ? 2 : 0)] + uiVertexOffset);
           indices.PushBack(pTypedIndices[p * 3 + 1] + uiVertexOffset);
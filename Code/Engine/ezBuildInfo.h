@@ -0,0 +1,10 @@
+//
+// This file is auto-generated by CMake.
+//
+
+#pragma once
+
+#define EZ_GIT_COMMIT_HASH_SHORT ce0d6a074f57
+#define EZ_GIT_COMMIT_HASH_LONG ce0d6a074f57edcfcba780b1808f93f20d93d6ec
+#define EZ_GIT_BRANCH_NAME "master"
+
@@ -96,9 +96,10 @@ ezResult ezBakingScene::Bake(const ezStringView& sOutputPath, ezProgress& progre
     m_pTracer = EZ_DEFAULT_NEW(ezTracerEmbree);
   }
 
-  ezProgressRange pgRange("Baking Scene", 2, true, &progress);
-  pgRange.SetStepWeighting(0, 0.95f);
-  pgRange.SetStepWeighting(1, 0.05f);
+  ezProgressRange pgRange("Baking Scene", 3, true, &progress);
+  pgRange.SetStepWeighting(0, 0.05f);
+  pgRange.SetStepWeighting(1, 0.9f);
+  pgRange.SetStepWeighting(2, 0.05f);
 
   if (!pgRange.BeginNextStep("Building Scene"))
     return EZ_FAILURE;
@@ -108,9 +109,15 @@ ezResult ezBakingScene::Bake(const ezStringView& sOutputPath, ezProgress& progre
   ezBakingInternal::PlaceProbesTask placeProbesTask(m_Settings, m_BoundingBox, m_Volumes);
   placeProbesTask.Execute();
 
-  ezBakingInternal::SkyVisibilityTask skyVisibilityTask(m_Settings, *m_pTracer, placeProbesTask.GetProbePositions());
+  if (!pgRange.BeginNextStep("Computing Sky Visibility"))
+    return EZ_FAILURE;
+
+  ezBakingInternal::SkyVisibilityTask skyVisibilityTask(m_Settings, *m_pTracer, placeProbesTask.GetProbePositions(), &progress);
   skyVisibilityTask.Execute();
 
+  if (skyVisibilityTask.WasCanceled())
+    return EZ_FAILURE;
+
   if (!pgRange.BeginNextStep("Writing Result"))
     return EZ_FAILURE;
 
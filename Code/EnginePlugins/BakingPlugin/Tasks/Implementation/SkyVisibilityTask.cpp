@@ -2,14 +2,26 @@
 
 #include <BakingPlugin/Tasks/SkyVisibilityTask.h>
 #include <BakingPlugin/Tracer/TracerInterface.h>
+#include <Foundation/Time/Stopwatch.h>
+#include <Foundation/Utilities/Progress.h>
 #include <RendererCore/BakedProbes/BakingInterface.h>
 
 using namespace ezBakingInternal;
 
-SkyVisibilityTask::SkyVisibilityTask(const ezBakingSettings& settings, ezTracerInterface& tracer, ezArrayPtr<const ezVec3> probePositions)
+namespace
+{
+  // Several probes are traced with one call, that way the tracer can sort the rays of all of them into full packets.
+  static constexpr ezUInt32 s_uiRaysPerBatch = 1024;
+
+  // Batches are processed in rounds, between two rounds the progress is updated and the bake can be canceled.
+  static constexpr ezUInt32 s_uiBatchesPerThreadAndRound = 8;
+} // namespace
+
+SkyVisibilityTask::SkyVisibilityTask(const ezBakingSettings& settings, ezTracerInterface& tracer, ezArrayPtr<const ezVec3> probePositions, ezProgress* pProgress)
   : m_Settings(settings)
   , m_Tracer(tracer)
   , m_ProbePositions(probePositions)
+  , m_pProgress(pProgress)
 {
 }
 
@@ -17,55 +29,122 @@ SkyVisibilityTask::~SkyVisibilityTask() = default;
 
 void SkyVisibilityTask::Execute()
 {
-  m_SkyVisibility.SetCountUninitialized(m_ProbePositions.GetCount());
+  const ezUInt32 uiNumProbes = m_ProbePositions.GetCount();
+  m_SkyVisibility.SetCountUninitialized(uiNumProbes);
+  m_bCanceled = false;
 
   const ezUInt32 uiNumSamples = m_Settings.m_uiNumSamplesPerProbe;
-  ezHybridArray<ezTracerInterface::Ray, 128> rays(ezFrameAllocator::GetCurrentAllocator());
-  rays.SetCountUninitialized(uiNumSamples);
+  m_Directions.SetCountUninitialized(uiNumSamples);
+  m_WeightNormalization = ezAmbientCube<float>();
 
-  ezAmbientCube<float> weightNormalization;
   for (ezUInt32 uiSampleIndex = 0; uiSampleIndex < uiNumSamples; ++uiSampleIndex)
   {
-    auto& ray = rays[uiSampleIndex];
-    ray.m_vDir = ezBakingUtils::FibonacciSphere(uiSampleIndex, uiNumSamples);
-    ray.m_fDistance = m_Settings.m_fMaxRayDistance;
-
-    weightNormalization.AddSample(ray.m_vDir, 1.0f);
+    m_Directions[uiSampleIndex] = ezBakingUtils::FibonacciSphere(uiSampleIndex, uiNumSamples);
+    m_WeightNormalization.AddSample(m_Directions[uiSampleIndex], 1.0f);
   }
 
   for (ezUInt32 i = 0; i < ezAmbientCubeBasis::NumDirs; ++i)
   {
-    weightNormalization.m_Values[i] = 1.0f / weightNormalization.m_Values[i];
+    m_WeightNormalization.m_Values[i] = 1.0f / m_WeightNormalization.m_Values[i];
   }
 
-  ezHybridArray<ezTracerInterface::Hit, 128> hits(ezFrameAllocator::GetCurrentAllocator());
-  hits.SetCountUninitialized(uiNumSamples);
+  const ezUInt32 uiProbesPerBatch = ezMath::Max(s_uiRaysPerBatch / ezMath::Max(uiNumSamples, 1u), 1u);
+  const ezUInt32 uiNumBatches = (uiNumProbes + uiProbesPerBatch - 1) / uiProbesPerBatch;
+
+  const ezUInt32 uiNumThreads = ezMath::Max(ezTaskSystem::GetWorkerThreadCount(ezWorkerThreadType::ShortTasks), 1u);
+  const ezUInt32 uiBatchesPerRound = uiNumThreads * s_uiBatchesPerThreadAndRound;
+  const ezUInt32 uiNumRounds = (uiNumBatches + uiBatchesPerRound - 1) / uiBatchesPerRound;
 
-  for (ezUInt32 uiProbeIndex = 0; uiProbeIndex < m_ProbePositions.GetCount(); ++uiProbeIndex)
+  ezProgressRange pgRange("Sky Visibility", ezMath::Max(uiNumRounds, 1u), true, m_pProgress);
+
+  ezParallelForParams parallelForParams;
+  parallelForParams.uiBinSize = 1;
+  parallelForParams.uiMaxTasksPerThread = s_uiBatchesPerThreadAndRound;
+
+  ezStopwatch sw;
+  ezStringBuilder sStepText;
+
+  for (ezUInt32 uiRound = 0; uiRound < uiNumRounds; ++uiRound)
   {
-    ezVec3 probePos = m_ProbePositions[uiProbeIndex];
+    const ezUInt32 uiFirstProbe = uiRound * uiBatchesPerRound * uiProbesPerBatch;
+
+    if (uiRound > 0)
+    {
+      // estimate the remaining time from the speed so far
+      const ezTime remainingTime = sw.GetRunningTotal() * (double(uiNumProbes - uiFirstProbe) / uiFirstProbe);
+      sStepText.Format("{} / {} probes, {} seconds remaining", uiFirstProbe, uiNumProbes, ezMath::Ceil(remainingTime.GetSeconds()));
+    }
+    else
+    {
+      sStepText.Format("0 / {} probes", uiNumProbes);
+    }
+
+    if (!pgRange.BeginNextStep(sStepText))
+    {
+      m_bCanceled = true;
+      return;
+    }
+
+    const ezUInt32 uiFirstBatch = uiRound * uiBatchesPerRound;
+    const ezUInt32 uiNumBatchesInRound = ezMath::Min(uiBatchesPerRound, uiNumBatches - uiFirstBatch);
+
+    ezTaskSystem::ParallelForIndexed(
+      uiFirstBatch, uiNumBatchesInRound, [&](ezUInt32 uiStartBatch, ezUInt32 uiEndBatch) {
+        for (ezUInt32 uiBatch = uiStartBatch; uiBatch < uiEndBatch; ++uiBatch)
+        {
+          const ezUInt32 uiStartProbe = uiBatch * uiProbesPerBatch;
+          ComputeSkyVisibility(uiStartProbe, ezMath::Min(uiStartProbe + uiProbesPerBatch, uiNumProbes));
+        }
+      },
+      "Sky Visibility", parallelForParams);
+  }
+
+  ezLog::Dev("Computed the sky visibility of {} probes with {} samples each in {} seconds", uiNumProbes, uiNumSamples, ezArgF(sw.GetRunningTotal().GetSeconds(), 2));
+}
+
+void SkyVisibilityTask::ComputeSkyVisibility(ezUInt32 uiStartProbe, ezUInt32 uiEndProbe)
+{
+  const ezUInt32 uiNumSamples = m_Directions.GetCount();
+  const ezUInt32 uiNumRays = (uiEndProbe - uiStartProbe) * uiNumSamples;
+
+  ezHybridArray<ezTracerInterface::Ray, 256> rays;
+  rays.SetCountUninitialized(uiNumRays);
+
+  for (ezUInt32 uiProbeIndex = uiStartProbe; uiProbeIndex < uiEndProbe; ++uiProbeIndex)
+  {
+    const ezVec3 probePos = m_ProbePositions[uiProbeIndex];
+    ezTracerInterface::Ray* pRays = rays.GetData() + (uiProbeIndex - uiStartProbe) * uiNumSamples;
+
     for (ezUInt32 uiSampleIndex = 0; uiSampleIndex < uiNumSamples; ++uiSampleIndex)
     {
-      rays[uiSampleIndex].m_vStartPos = probePos;
+      auto& ray = pRays[uiSampleIndex];
+      ray.m_vStartPos = probePos;
+      ray.m_vDir = m_Directions[uiSampleIndex];
+      ray.m_fDistance = m_Settings.m_fMaxRayDistance;
     }
+  }
+
+  // only whether a ray reaches the sky matters, not what it hits
+  ezHybridArray<bool, 256> occluded;
+  occluded.SetCountUninitialized(uiNumRays);
 
-    m_Tracer.TraceRays(rays, hits);
+  m_Tracer.TraceOcclusion(rays, occluded);
+
+  for (ezUInt32 uiProbeIndex = uiStartProbe; uiProbeIndex < uiEndProbe; ++uiProbeIndex)
+  {
+    const bool* pOccluded = occluded.GetData() + (uiProbeIndex - uiStartProbe) * uiNumSamples;
 
     ezAmbientCube<float> skyVisibility;
     for (ezUInt32 uiSampleIndex = 0; uiSampleIndex < uiNumSamples; ++uiSampleIndex)
     {
-      const auto& ray = rays[uiSampleIndex];
-      const auto& hit = hits[uiSampleIndex];
-      const float value = hit.m_fDistance < 0.0f ? 1.0f : 0.0f;
-
-      skyVisibility.AddSample(ray.m_vDir, value);
+      skyVisibility.AddSample(m_Directions[uiSampleIndex], pOccluded[uiSampleIndex] ? 0.0f : 1.0f);
     }
 
     for (ezUInt32 i = 0; i < ezAmbientCubeBasis::NumDirs; ++i)
     {
-      skyVisibility.m_Values[i] *= weightNormalization.m_Values[i];
+      skyVisibility.m_Values[i] *= m_WeightNormalization.m_Values[i];
     }
-    auto& compressedSkyVisibility = m_SkyVisibility[uiProbeIndex];
-    compressedSkyVisibility = ezBakingUtils::CompressSkyVisibility(skyVisibility);
+
+    m_SkyVisibility[uiProbeIndex] = ezBakingUtils::CompressSkyVisibility(skyVisibility);
   }
 }
@@ -5,6 +5,7 @@
 #include <RendererCore/BakedProbes/BakingUtils.h>
 
 struct ezBakingSettings;
+class ezProgress;
 class ezTracerInterface;
 
 namespace ezBakingInternal
@@ -12,18 +13,29 @@ namespace ezBakingInternal
   class EZ_BAKINGPLUGIN_DLL SkyVisibilityTask : public ezTask
   {
   public:
-    SkyVisibilityTask(const ezBakingSettings& settings, ezTracerInterface& tracer, ezArrayPtr<const ezVec3> probePositions);
+    /// \brief If a progress bar is given, the progress is reported with a time estimate and the task can be canceled.
+    SkyVisibilityTask(const ezBakingSettings& settings, ezTracerInterface& tracer, ezArrayPtr<const ezVec3> probePositions, ezProgress* pProgress = nullptr);
     ~SkyVisibilityTask();
 
+    /// \brief Distributes the probes across the task system and waits until all of them are done.
     virtual void Execute() override;
 
     ezArrayPtr<const ezCompressedSkyVisibility> GetSkyVisibility() const { return m_SkyVisibility; }
 
+    bool WasCanceled() const { return m_bCanceled; }
+
   private:
+    void ComputeSkyVisibility(ezUInt32 uiStartProbe, ezUInt32 uiEndProbe);
+
     const ezBakingSettings& m_Settings;
 
     ezTracerInterface& m_Tracer;
     ezArrayPtr<const ezVec3> m_ProbePositions;
+    ezProgress* m_pProgress = nullptr;
+    bool m_bCanceled = false;
+
+    ezDynamicArray<ezVec3> m_Directions;
+    ezAmbientCube<float> m_WeightNormalization;
 
     ezDynamicArray<ezCompressedSkyVisibility> m_SkyVisibility;
   };
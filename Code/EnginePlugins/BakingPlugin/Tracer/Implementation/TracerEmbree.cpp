@@ -12,6 +12,7 @@
 namespace
 {
   static RTCDevice s_rtcDevice;
+  static ezUInt32 s_uiPacketSize = 1;
   static ezHashTable<ezHashedString, RTCScene, ezHashHelper<ezHashedString>, ezStaticAllocatorWrapper> s_rtcMeshCache;
 
   const char* rtcErrorCodeToString[] = {
@@ -49,6 +50,9 @@ namespace
         bool bRayStreamSupported = rtcGetDeviceProperty(s_rtcDevice, RTC_DEVICE_PROPERTY_RAY_STREAM_SUPPORTED);
 
         ezLog::Info("Supported ray packets: Ray4:{}, Ray8:{}, Ray16:{}, RayStream:{}", bRay4Supported, bRay8Supported, bRay16Supported, bRayStreamSupported);
+
+        // use the widest packets that the CPU supports natively, packets that are wider than the SIMD width are only emulated
+        s_uiPacketSize = bRay16Supported ? 16 : (bRay8Supported ? 8 : (bRay4Supported ? 4 : 1));
       }
       else
       {
@@ -93,13 +97,13 @@ namespace
     RTCGeometry triangleMesh = rtcNewGeometry(s_rtcDevice, RTC_GEOMETRY_TYPE_TRIANGLE);
     {
       const auto& mbDesc = pCpuMesh->GetDescriptor().MeshBufferDesc();
+      const ezUInt32 uiNumPrimitives = pCpuMesh->GetDescriptor().GetNumPrimitivesOfFirstLod(); // ignore the triangles of the coarser LODs
 
-      const ezVec3* pPositions = nullptr;
-      const ezUInt8* pNormals = nullptr;
-      ezGALResourceFormat::Enum normalFormat = ezGALResourceFormat::Invalid;
-      ezUInt32 uiElementStride = 0;
-      if (ezMeshBufferUtils::GetPositionAndNormalStream(mbDesc, pPositions, pNormals, normalFormat, uiElementStride).Failed())
+      ezDynamicArray<ezVec3> positions;
+      ezDynamicArray<ezVec3> normals;
+      if (ezMeshBufferUtils::DecodePositions(mbDesc, positions).Failed() || ezMeshBufferUtils::DecodeNormals(mbDesc, normals).Failed())
       {
+        rtcReleaseGeometry(triangleMesh);
         return nullptr;
       }
 
@@ -109,26 +113,20 @@ namespace
       ezVec3* rtcNormals = static_cast<ezVec3*>(rtcSetNewGeometryBuffer(triangleMesh, RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE, 0, RTC_FORMAT_FLOAT3, sizeof(ezVec3), mbDesc.GetVertexCount()));
 
       // write out all vertices
-      ezVec3 vNormal;
       for (ezUInt32 i = 0; i < mbDesc.GetVertexCount(); ++i)
       {
-        ezMeshBufferUtils::DecodeNormal(ezMakeArrayPtr(pNormals, sizeof(ezVec3)), normalFormat, vNormal).IgnoreResult();
-
-        rtcPositions[i] = *pPositions;
-        rtcNormals[i] = vNormal;
-
-        pPositions = ezMemoryUtils::AddByteOffset(pPositions, uiElementStride);
-        pNormals = ezMemoryUtils::AddByteOffset(pNormals, uiElementStride);
+        rtcPositions[i] = positions[i];
+        rtcNormals[i] = normals[i];
       }
 
-      ezVec3U32* rtcIndices = static_cast<ezVec3U32*>(rtcSetNewGeometryBuffer(triangleMesh, RTC_BUFFER_TYPE_INDEX, 0, RTC_FORMAT_UINT3, sizeof(ezVec3U32), mbDesc.GetPrimitiveCount()));
+      ezVec3U32* rtcIndices = static_cast<ezVec3U32*>(rtcSetNewGeometryBuffer(triangleMesh, RTC_BUFFER_TYPE_INDEX, 0, RTC_FORMAT_UINT3, sizeof(ezVec3U32), uiNumPrimitives));
 
       bool flip = false;
       if (mbDesc.Uses32BitIndices())
       {
         const ezUInt32* pTypedIndices = reinterpret_cast<const ezUInt32*>(mbDesc.GetIndexBufferData().GetPtr());
 
-        for (ezUInt32 p = 0; p < mbDesc.GetPrimitiveCount(); ++p)
+        for (ezUInt32 p = 0; p < uiNumPrimitives; ++p)
         {
           rtcIndices[p].x = pTypedIndices[p * 3 + (flip ? 2 : 0)];
           rtcIndices[p].y = pTypedIndices[p * 3 + 1];
@@ -139,7 +137,7 @@ namespace
       {
         const ezUInt16* pTypedIndices = reinterpret_cast<const ezUInt16*>(mbDesc.GetIndexBufferData().GetPtr());
 
-        for (ezUInt32 p = 0; p < mbDesc.GetPrimitiveCount(); ++p)
+        for (ezUInt32 p = 0; p < uiNumPrimitives; ++p)
         {
           rtcIndices[p].x = pTypedIndices[p * 3 + (flip ? 2 : 0)];
           rtcIndices[p].y = pTypedIndices[p * 3 + 1];
@@ -162,6 +160,122 @@ namespace
     return scene;
   }
 
+  /// Creates a scene with a single triangle mesh, the vertex normals are averaged from the normals of the adjacent triangles.
+  static RTCScene CreateMesh(ezArrayPtr<const ezVec3> positions, ezArrayPtr<const ezUInt32> indices)
+  {
+    const ezUInt32 uiNumVertices = positions.GetCount();
+    const ezUInt32 uiNumTriangles = indices.GetCount() / 3;
+
+    RTCGeometry triangleMesh = rtcNewGeometry(s_rtcDevice, RTC_GEOMETRY_TYPE_TRIANGLE);
+    {
+      ezVec3* rtcPositions = static_cast<ezVec3*>(rtcSetNewGeometryBuffer(triangleMesh, RTC_BUFFER_TYPE_VERTEX, 0, RTC_FORMAT_FLOAT3, sizeof(ezVec3), uiNumVertices));
+
+      rtcSetGeometryVertexAttributeCount(triangleMesh, 1);
+      ezVec3* rtcNormals = static_cast<ezVec3*>(rtcSetNewGeometryBuffer(triangleMesh, RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE, 0, RTC_FORMAT_FLOAT3, sizeof(ezVec3), uiNumVertices));
+
+      ezVec3U32* rtcIndices = static_cast<ezVec3U32*>(rtcSetNewGeometryBuffer(triangleMesh, RTC_BUFFER_TYPE_INDEX, 0, RTC_FORMAT_UINT3, sizeof(ezVec3U32), uiNumTriangles));
+
+      for (ezUInt32 i = 0; i < uiNumVertices; ++i)
+      {
+        rtcPositions[i] = positions[i];
+        rtcNormals[i].SetZero();
+      }
+
+      for (ezUInt32 t = 0; t < uiNumTriangles; ++t)
+      {
+        const ezUInt32 i0 = indices[t * 3 + 0];
+        const ezUInt32 i1 = indices[t * 3 + 1];
+        const ezUInt32 i2 = indices[t * 3 + 2];
+
+        rtcIndices[t] = ezVec3U32(i0, i1, i2);
+
+        const ezVec3 vNormal = (positions[i1] - positions[i0]).CrossRH(positions[i2] - positions[i0]);
+        rtcNormals[i0] += vNormal;
+        rtcNormals[i1] += vNormal;
+        rtcNormals[i2] += vNormal;
+      }
+
+      for (ezUInt32 i = 0; i < uiNumVertices; ++i)
+      {
+        rtcNormals[i].NormalizeIfNotZero(ezVec3(0, 0, 1)).IgnoreResult();
+      }
+
+      rtcCommitGeometry(triangleMesh);
+    }
+
+    RTCScene scene = rtcNewScene(s_rtcDevice);
+    {
+      EZ_VERIFY(rtcAttachGeometry(scene, triangleMesh) == 0, "Geometry id must be 0");
+      rtcReleaseGeometry(triangleMesh);
+
+      rtcCommitScene(scene);
+    }
+
+    return scene;
+  }
+
+  /// Sorts the rays by the octant of their direction and then along a Morton curve over the direction,
+  /// so that the rays in one packet traverse similar parts of the scene.
+  static void SortRays(ezArrayPtr<const ezTracerInterface::Ray> rays, ezDynamicArray<ezUInt32>& out_Order)
+  {
+    const ezUInt32 uiNumRays = rays.GetCount();
+
+    ezHybridArray<ezUInt64, 256> keys;
+    keys.SetCountUninitialized(uiNumRays);
+
+    for (ezUInt32 i = 0; i < uiNumRays; ++i)
+    {
+      const ezVec3& vDir = rays[i].m_vDir;
+      const ezUInt32 uiOctant = (vDir.x < 0.0f ? 1 : 0) | (vDir.y < 0.0f ? 2 : 0) | (vDir.z < 0.0f ? 4 : 0);
+
+      ezUInt32 uiMorton = 0;
+      const ezUInt32 uiX = static_cast<ezUInt32>(ezMath::Min(ezMath::Abs(vDir.x), 1.0f) * 1023.0f);
+      const ezUInt32 uiY = static_cast<ezUInt32>(ezMath::Min(ezMath::Abs(vDir.y), 1.0f) * 1023.0f);
+      for (ezUInt32 uiBit = 0; uiBit < 10; ++uiBit)
+      {
+        uiMorton |= ((uiX >> uiBit) & 1) << (uiBit * 2);
+        uiMorton |= ((uiY >> uiBit) & 1) << (uiBit * 2 + 1);
+      }
+
+      keys[i] = (static_cast<ezUInt64>((uiOctant << 20) | uiMorton) << 32) | i;
+    }
+
+    keys.Sort();
+
+    out_Order.SetCountUninitialized(uiNumRays);
+    for (ezUInt32 i = 0; i < uiNumRays; ++i)
+    {
+      out_Order[i] = static_cast<ezUInt32>(keys[i] & 0xFFFFFFFF);
+    }
+  }
+
+  template <typename RayN>
+  EZ_ALWAYS_INLINE void SetPacketRay(RayN& ref_rayN, ezUInt32 uiLane, const ezTracerInterface::Ray& ray)
+  {
+    ref_rayN.org_x[uiLane] = ray.m_vStartPos.x;
+    ref_rayN.org_y[uiLane] = ray.m_vStartPos.y;
+    ref_rayN.org_z[uiLane] = ray.m_vStartPos.z;
+    ref_rayN.tnear[uiLane] = 0.0f;
+
+    ref_rayN.dir_x[uiLane] = ray.m_vDir.x;
+    ref_rayN.dir_y[uiLane] = ray.m_vDir.y;
+    ref_rayN.dir_z[uiLane] = ray.m_vDir.z;
+    ref_rayN.time[uiLane] = 0.0f;
+
+    ref_rayN.tfar[uiLane] = ray.m_fDistance;
+    ref_rayN.mask[uiLane] = 0xFFFFFFFF;
+    ref_rayN.id[uiLane] = uiLane;
+    ref_rayN.flags[uiLane] = 0;
+  }
+
+  EZ_ALWAYS_INLINE void IntersectPacket(const int* pValid, RTCScene scene, RTCIntersectContext* pContext, RTCRayHit4* pRayHit) { rtcIntersect4(pValid, scene, pContext, pRayHit); }
+  EZ_ALWAYS_INLINE void IntersectPacket(const int* pValid, RTCScene scene, RTCIntersectContext* pContext, RTCRayHit8* pRayHit) { rtcIntersect8(pValid, scene, pContext, pRayHit); }
+  EZ_ALWAYS_INLINE void IntersectPacket(const int* pValid, RTCScene scene, RTCIntersectContext* pContext, RTCRayHit16* pRayHit) { rtcIntersect16(pValid, scene, pContext, pRayHit); }
+
+  EZ_ALWAYS_INLINE void OccludedPacket(const int* pValid, RTCScene scene, RTCIntersectContext* pContext, RTCRay4* pRay) { rtcOccluded4(pValid, scene, pContext, pRay); }
+  EZ_ALWAYS_INLINE void OccludedPacket(const int* pValid, RTCScene scene, RTCIntersectContext* pContext, RTCRay8* pRay) { rtcOccluded8(pValid, scene, pContext, pRay); }
+  EZ_ALWAYS_INLINE void OccludedPacket(const int* pValid, RTCScene scene, RTCIntersectContext* pContext, RTCRay16* pRay) { rtcOccluded16(pValid, scene, pContext, pRay); }
+
 } // namespace
 
 struct ezTracerEmbree::Data
@@ -180,9 +294,141 @@ struct ezTracerEmbree::Data
       rtcReleaseScene(m_rtcScene);
       m_rtcScene = nullptr;
     }
+
+    if (m_rtcOwnMesh != nullptr)
+    {
+      rtcReleaseScene(m_rtcOwnMesh);
+      m_rtcOwnMesh = nullptr;
+    }
+  }
+
+  void AddInstance(RTCScene mesh, const ezMat4& transform)
+  {
+    RTCGeometry instance = rtcNewGeometry(s_rtcDevice, RTC_GEOMETRY_TYPE_INSTANCE);
+    {
+      rtcSetGeometryInstancedScene(instance, mesh);
+      rtcSetGeometryTransform(instance, 0, RTC_FORMAT_FLOAT4X4_COLUMN_MAJOR, &transform);
+
+      rtcCommitGeometry(instance);
+    }
+
+    ezUInt32 uiInstanceID = rtcAttachGeometry(m_rtcScene, instance);
+    rtcReleaseGeometry(instance);
+
+    ezMat3 normalTransform = transform.GetRotationalPart().GetInverse(0.0f).GetTranspose();
+
+    EZ_ASSERT_DEBUG(uiInstanceID == m_rtcInstancedGeometry.GetCount(), "");
+    auto& instancedGeometry = m_rtcInstancedGeometry.ExpandAndGetRef();
+    instancedGeometry.m_mesh = rtcGetGeometry(mesh, 0);
+    instancedGeometry.m_normalTransform0 = ezSimdConversion::ToVec3(normalTransform.GetColumn(0));
+    instancedGeometry.m_normalTransform1 = ezSimdConversion::ToVec3(normalTransform.GetColumn(1));
+    instancedGeometry.m_normalTransform2 = ezSimdConversion::ToVec3(normalTransform.GetColumn(2));
+  }
+
+  ezUInt32 GetPacketSize() const
+  {
+    return m_uiPacketSize != 0 ? m_uiPacketSize : s_uiPacketSize;
+  }
+
+  void FillHit(ezUInt32 uiInstanceID, ezUInt32 uiPrimitiveID, float u, float v, float fDistance, const Ray& ray, Hit& out_Hit) const
+  {
+    auto& instancedGeometry = m_rtcInstancedGeometry[uiInstanceID];
+
+    ezSimdVec4f objectSpaceNormal;
+    rtcInterpolate0(instancedGeometry.m_mesh, uiPrimitiveID, u, v, RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE, 0, reinterpret_cast<float*>(&objectSpaceNormal), 3);
+
+    ezSimdVec4f worldSpaceNormal = instancedGeometry.m_normalTransform0 * objectSpaceNormal.x();
+    worldSpaceNormal += instancedGeometry.m_normalTransform1 * objectSpaceNormal.y();
+    worldSpaceNormal += instancedGeometry.m_normalTransform2 * objectSpaceNormal.z();
+
+    out_Hit.m_vNormal = ezSimdConversion::ToVec3(worldSpaceNormal.GetNormalized<3>());
+    out_Hit.m_fDistance = fDistance;
+    out_Hit.m_vPosition = ray.m_vStartPos + ray.m_vDir * fDistance;
+  }
+
+  static void FillMiss(Hit& out_Hit)
+  {
+    out_Hit.m_vPosition.SetZero();
+    out_Hit.m_vNormal.SetZero();
+    out_Hit.m_fDistance = -1.0f;
+  }
+
+  template <typename RayHitN, ezUInt32 N>
+  void TraceRayPackets(ezArrayPtr<const Ray> rays, ezArrayPtr<const ezUInt32> order, ezArrayPtr<Hit> hits) const
+  {
+    RTCIntersectContext context;
+    rtcInitIntersectContext(&context);
+    context.flags = RTC_INTERSECT_CONTEXT_FLAG_COHERENT;
+
+    RayHitN rayHit;
+    int valid[N];
+
+    for (ezUInt32 uiFirst = 0; uiFirst < order.GetCount(); uiFirst += N)
+    {
+      const ezUInt32 uiCount = ezMath::Min(N, order.GetCount() - uiFirst);
+
+      for (ezUInt32 i = 0; i < N; ++i)
+      {
+        valid[i] = i < uiCount ? -1 : 0;
+
+        if (i < uiCount)
+        {
+          SetPacketRay(rayHit.ray, i, rays[order[uiFirst + i]]);
+          rayHit.hit.geomID[i] = RTC_INVALID_GEOMETRY_ID;
+        }
+      }
+
+      IntersectPacket(valid, m_rtcScene, &context, &rayHit);
+
+      for (ezUInt32 i = 0; i < uiCount; ++i)
+      {
+        const ezUInt32 uiRayIndex = order[uiFirst + i];
+
+        if (rayHit.hit.geomID[i] != RTC_INVALID_GEOMETRY_ID)
+          FillHit(rayHit.hit.instID[0][i], rayHit.hit.primID[i], rayHit.hit.u[i], rayHit.hit.v[i], rayHit.ray.tfar[i], rays[uiRayIndex], hits[uiRayIndex]);
+        else
+          FillMiss(hits[uiRayIndex]);
+      }
+    }
+  }
+
+  template <typename RayN, ezUInt32 N>
+  void TraceOcclusionPackets(ezArrayPtr<const Ray> rays, ezArrayPtr<const ezUInt32> order, ezArrayPtr<bool> out_Occluded) const
+  {
+    RTCIntersectContext context;
+    rtcInitIntersectContext(&context);
+    context.flags = RTC_INTERSECT_CONTEXT_FLAG_COHERENT;
+
+    RayN rayN;
+    int valid[N];
+
+    for (ezUInt32 uiFirst = 0; uiFirst < order.GetCount(); uiFirst += N)
+    {
+      const ezUInt32 uiCount = ezMath::Min(N, order.GetCount() - uiFirst);
+
+      for (ezUInt32 i = 0; i < N; ++i)
+      {
+        valid[i] = i < uiCount ? -1 : 0;
+
+        if (i < uiCount)
+        {
+          SetPacketRay(rayN, i, rays[order[uiFirst + i]]);
+        }
+      }
+
+      OccludedPacket(valid, m_rtcScene, &context, &rayN);
+
+      // embree sets tfar to -inf for rays that hit something
+      for (ezUInt32 i = 0; i < uiCount; ++i)
+      {
+        out_Occluded[order[uiFirst + i]] = rayN.tfar[i] < 0.0f;
+      }
+    }
   }
 
   RTCScene m_rtcScene = nullptr;
+  RTCScene m_rtcOwnMesh = nullptr; ///< The mesh of a scene that was built from a plain triangle list, meshes of resources are cached globally.
+  ezUInt32 m_uiPacketSize = 0;
 
   struct InstancedGeometry
   {
@@ -217,40 +463,63 @@ ezResult ezTracerEmbree::BuildScene(const ezBakingScene& scene)
       continue;
     }
 
-    ezMat4 transform = meshObject.m_GlobalTransform.GetAsMat4();
+    m_pData->AddInstance(mesh, meshObject.m_GlobalTransform.GetAsMat4());
+  }
 
-    RTCGeometry instance = rtcNewGeometry(s_rtcDevice, RTC_GEOMETRY_TYPE_INSTANCE);
-    {
-      rtcSetGeometryInstancedScene(instance, mesh);
-      rtcSetGeometryTransform(instance, 0, RTC_FORMAT_FLOAT4X4_COLUMN_MAJOR, &transform);
+  rtcCommitScene(m_pData->m_rtcScene);
 
-      rtcCommitGeometry(instance);
-    }
+  return EZ_SUCCESS;
+}
 
-    ezUInt32 uiInstanceID = rtcAttachGeometry(m_pData->m_rtcScene, instance);
-    rtcReleaseGeometry(instance);
+ezResult ezTracerEmbree::BuildScene(ezArrayPtr<const ezVec3> positions, ezArrayPtr<const ezUInt32> indices)
+{
+  EZ_SUCCEED_OR_RETURN(InitDevice());
 
-    ezMat3 normalTransform = transform.GetRotationalPart().GetInverse(0.0f).GetTranspose();
+  m_pData->ClearScene();
+  m_pData->m_rtcScene = rtcNewScene(s_rtcDevice);
 
-    EZ_ASSERT_DEBUG(uiInstanceID == m_pData->m_rtcInstancedGeometry.GetCount(), "");
-    auto& instancedGeometry = m_pData->m_rtcInstancedGeometry.ExpandAndGetRef();
-    instancedGeometry.m_mesh = rtcGetGeometry(mesh, 0);
-    instancedGeometry.m_normalTransform0 = ezSimdConversion::ToVec3(normalTransform.GetColumn(0));
-    instancedGeometry.m_normalTransform1 = ezSimdConversion::ToVec3(normalTransform.GetColumn(1));
-    instancedGeometry.m_normalTransform2 = ezSimdConversion::ToVec3(normalTransform.GetColumn(2));
-  }
+  m_pData->m_rtcOwnMesh = CreateMesh(positions, indices);
+  m_pData->AddInstance(m_pData->m_rtcOwnMesh, ezMat4::IdentityMatrix());
 
   rtcCommitScene(m_pData->m_rtcScene);
 
   return EZ_SUCCESS;
 }
 
+void ezTracerEmbree::SetPacketSize(ezUInt32 uiPacketSize)
+{
+  EZ_ASSERT_DEV(uiPacketSize <= 1 || uiPacketSize == 4 || uiPacketSize == 8 || uiPacketSize == 16, "Invalid packet size {}", uiPacketSize);
+  m_pData->m_uiPacketSize = uiPacketSize;
+}
+
+EZ_DEFINE_AS_POD_TYPE(RTCRay);
 EZ_DEFINE_AS_POD_TYPE(RTCRayHit);
 
 void ezTracerEmbree::TraceRays(ezArrayPtr<const Ray> rays, ezArrayPtr<Hit> hits)
 {
   const ezUInt32 uiNumRays = rays.GetCount();
 
+  const ezUInt32 uiPacketSize = m_pData->GetPacketSize();
+
+  if (uiPacketSize > 1)
+  {
+    ezHybridArray<ezUInt32, 256> order;
+    SortRays(rays, order);
+
+    switch (uiPacketSize)
+    {
+      case 16:
+        m_pData->TraceRayPackets<RTCRayHit16, 16>(rays, order, hits);
+        return;
+      case 8:
+        m_pData->TraceRayPackets<RTCRayHit8, 8>(rays, order, hits);
+        return;
+      default:
+        m_pData->TraceRayPackets<RTCRayHit4, 4>(rays, order, hits);
+        return;
+    }
+  }
+
   ezHybridArray<RTCRayHit, 256, ezAlignedAllocatorWrapper> rtcRayHits;
   rtcRayHits.SetCountUninitialized(uiNumRays);
 
@@ -270,7 +539,7 @@ void ezTracerEmbree::TraceRays(ezArrayPtr<const Ray> rays, ezArrayPtr<Hit> hits)
     rtcRayHit.ray.time = 0.0f;
 
     rtcRayHit.ray.tfar = ray.m_fDistance;
-    rtcRayHit.ray.mask = 0;
+    rtcRayHit.ray.mask = 0xFFFFFFFF;
     rtcRayHit.ray.id = i;
     rtcRayHit.ray.flags = 0;
 
@@ -285,29 +554,70 @@ void ezTracerEmbree::TraceRays(ezArrayPtr<const Ray> rays, ezArrayPtr<Hit> hits)
   for (ezUInt32 i = 0; i < uiNumRays; ++i)
   {
     auto& rtcRayHit = rtcRayHits[i];
-    auto& ray = rays[i];
-    auto& hit = hits[i];
 
     if (rtcRayHit.hit.geomID != RTC_INVALID_GEOMETRY_ID)
-    {
-      auto& instancedGeometry = m_pData->m_rtcInstancedGeometry[rtcRayHit.hit.instID[0]];
+      m_pData->FillHit(rtcRayHit.hit.instID[0], rtcRayHit.hit.primID, rtcRayHit.hit.u, rtcRayHit.hit.v, rtcRayHit.ray.tfar, rays[i], hits[i]);
+    else
+      Data::FillMiss(hits[i]);
+  }
+}
 
-      ezSimdVec4f objectSpaceNormal;
-      rtcInterpolate0(instancedGeometry.m_mesh, rtcRayHit.hit.primID, rtcRayHit.hit.u, rtcRayHit.hit.v, RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE, 0, reinterpret_cast<float*>(&objectSpaceNormal), 3);
+void ezTracerEmbree::TraceOcclusion(ezArrayPtr<const Ray> rays, ezArrayPtr<bool> out_Occluded)
+{
+  const ezUInt32 uiNumRays = rays.GetCount();
 
-      ezSimdVec4f worldSpaceNormal = instancedGeometry.m_normalTransform0 * objectSpaceNormal.x();
-      worldSpaceNormal += instancedGeometry.m_normalTransform1 * objectSpaceNormal.y();
-      worldSpaceNormal += instancedGeometry.m_normalTransform2 * objectSpaceNormal.z();
+  const ezUInt32 uiPacketSize = m_pData->GetPacketSize();
 
-      hit.m_vNormal = ezSimdConversion::ToVec3(worldSpaceNormal.GetNormalized<3>());
-      hit.m_fDistance = rtcRayHit.ray.tfar;
-      hit.m_vPosition = ray.m_vStartPos + ray.m_vDir * hit.m_fDistance;
-    }
-    else
+  if (uiPacketSize > 1)
+  {
+    ezHybridArray<ezUInt32, 256> order;
+    SortRays(rays, order);
+
+    switch (uiPacketSize)
     {
-      hit.m_vPosition.SetZero();
-      hit.m_vNormal.SetZero();
-      hit.m_fDistance = -1.0f;
+      case 16:
+        m_pData->TraceOcclusionPackets<RTCRay16, 16>(rays, order, out_Occluded);
+        return;
+      case 8:
+        m_pData->TraceOcclusionPackets<RTCRay8, 8>(rays, order, out_Occluded);
+        return;
+      default:
+        m_pData->TraceOcclusionPackets<RTCRay4, 4>(rays, order, out_Occluded);
+        return;
     }
   }
+
+  ezHybridArray<RTCRay, 256, ezAlignedAllocatorWrapper> rtcRays;
+  rtcRays.SetCountUninitialized(uiNumRays);
+
+  for (ezUInt32 i = 0; i < uiNumRays; ++i)
+  {
+    auto& ray = rays[i];
+    auto& rtcRay = rtcRays[i];
+
+    rtcRay.org_x = ray.m_vStartPos.x;
+    rtcRay.org_y = ray.m_vStartPos.y;
+    rtcRay.org_z = ray.m_vStartPos.z;
+    rtcRay.tnear = 0.0f;
+
+    rtcRay.dir_x = ray.m_vDir.x;
+    rtcRay.dir_y = ray.m_vDir.y;
+    rtcRay.dir_z = ray.m_vDir.z;
+    rtcRay.time = 0.0f;
+
+    rtcRay.tfar = ray.m_fDistance;
+    rtcRay.mask = 0xFFFFFFFF;
+    rtcRay.id = i;
+    rtcRay.flags = 0;
+  }
+
+  RTCIntersectContext context;
+  rtcInitIntersectContext(&context);
+
+  rtcOccluded1M(m_pData->m_rtcScene, &context, rtcRays.GetData(), uiNumRays, sizeof(RTCRay));
+
+  for (ezUInt32 i = 0; i < uiNumRays; ++i)
+  {
+    out_Occluded[i] = rtcRays[i].tfar < 0.0f;
+  }
 }
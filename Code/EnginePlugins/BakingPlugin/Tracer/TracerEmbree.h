@@ -11,7 +11,17 @@ public:
 
   virtual ezResult BuildScene(const ezBakingScene& scene) override;
 
+  /// \brief Builds the scene from a plain triangle list instead of the meshes of a baking scene, e.g. for tests and benchmarks with synthetic geometry.
+  ezResult BuildScene(ezArrayPtr<const ezVec3> positions, ezArrayPtr<const ezUInt32> indices);
+
+  /// \brief Overrides the number of rays that are traced together in one packet. Has to be 0, 1, 4, 8 or 16.
+  ///
+  /// 0 uses the widest packets that the CPU supports natively, which is the default. 1 traces all rays as a stream of single rays.
+  /// Mainly useful to compare the code paths against each other.
+  void SetPacketSize(ezUInt32 uiPacketSize);
+
   virtual void TraceRays(ezArrayPtr<const Ray> rays, ezArrayPtr<Hit> hits) override;
+  virtual void TraceOcclusion(ezArrayPtr<const Ray> rays, ezArrayPtr<bool> out_Occluded) override;
 
 private:
   struct Data;
@@ -27,5 +27,14 @@ public:
     float m_fDistance;
   };
 
+  /// \brief Finds the closest hit for every ray. A hit distance of -1 means that the ray didn't hit anything.
+  ///
+  /// Must be thread-safe, it is called from multiple tasks at the same time during baking.
+  /// Callers should pass many rays at once, that way implementations can sort them into coherent packets.
   virtual void TraceRays(ezArrayPtr<const Ray> rays, ezArrayPtr<Hit> hits) = 0;
+
+  /// \brief Only determines whether each ray hits anything, which is cheaper than finding the closest hit.
+  ///
+  /// Must be thread-safe, see TraceRays().
+  virtual void TraceOcclusion(ezArrayPtr<const Ray> rays, ezArrayPtr<bool> out_Occluded) = 0;
 };
@@ -6,6 +6,33 @@
 #include <JoltPlugin/System/JoltWorldModule.h>
 #include <JoltPlugin/Utilities/JoltUserData.h>
 
+/// \brief Everything that is needed to run queries with the same parameters.
+///
+/// Batched queries set this up once per chunk and share it between all queries of the chunk.
+class ezJoltQueryContext
+{
+public:
+  ezJoltQueryContext(const JPH::PhysicsSystem& system, const ezPhysicsQueryParameters& params)
+    : m_Query(system.GetNarrowPhaseQuery())
+    , m_LockInterface(system.GetBodyLockInterfaceNoLock())
+    , m_BodyInterface(system.GetBodyInterfaceNoLock())
+    , m_BroadphaseFilter(params.m_ShapeTypes)
+    , m_BodyFilter(params.m_uiIgnoreObjectFilterID)
+    , m_ObjectFilter(params.m_uiCollisionLayer)
+    , m_bIgnoreInitialOverlap(params.m_bIgnoreInitialOverlap)
+  {
+  }
+
+  const JPH::NarrowPhaseQuery& m_Query;
+  const JPH::BodyLockInterface& m_LockInterface;
+  const JPH::BodyInterface& m_BodyInterface;
+
+  ezJoltBroadPhaseLayerFilter m_BroadphaseFilter;
+  ezJoltBodyFilter m_BodyFilter;
+  ezJoltObjectLayerFilter m_ObjectFilter;
+  bool m_bIgnoreInitialOverlap;
+};
+
 void FillCastResult(ezPhysicsCastResult& result, const ezVec3& vStart, const ezVec3& vDir, float fDistance, const JPH::BodyID& bodyId, const JPH::SubShapeID& subShapeId, const JPH::BodyLockInterface& lockInterface, const JPH::BodyInterface& bodyInterface, const ezJoltWorldModule* pModule)
 {
   JPH::BodyLockRead bodyLock(lockInterface, bodyId);
@@ -56,13 +83,11 @@ public:
   }
 };
 
-bool ezJoltWorldModule::Raycast(ezPhysicsCastResult& out_Result, const ezVec3& vStart, const ezVec3& vDir, float fDistance, const ezPhysicsQueryParameters& params, ezPhysicsHitCollection collection /*= ezPhysicsHitCollection::Closest*/) const
+static bool CastRay(const ezJoltQueryContext& context, ezPhysicsCastResult& out_Result, const ezVec3& vStart, const ezVec3& vDir, float fDistance, ezPhysicsHitCollection collection)
 {
   if (fDistance <= 0.001f || vDir.IsZero())
     return false;
 
-  const JPH::NarrowPhaseQuery& query = m_pSystem->GetNarrowPhaseQuery();
-
   JPH::RayCast ray;
   ray.mOrigin = ezJoltConversionUtils::ToVec3(vStart);
   ray.mDirection = ezJoltConversionUtils::ToVec3(vDir * fDistance);
@@ -70,35 +95,38 @@ bool ezJoltWorldModule::Raycast(ezPhysicsCastResult& out_Result, const ezVec3& v
   ezRayCastCollector collector;
   collector.m_bAnyHit = collection == ezPhysicsHitCollection::Any;
 
-  ezJoltBroadPhaseLayerFilter broadphaseFilter(params.m_ShapeTypes);
-  ezJoltBodyFilter bodyFilter(params.m_uiIgnoreObjectFilterID);
-  ezJoltObjectLayerFilter objectFilter(params.m_uiCollisionLayer);
-
-  if (params.m_bIgnoreInitialOverlap)
+  if (context.m_bIgnoreInitialOverlap)
   {
     JPH::RayCastSettings opt;
     opt.mBackFaceMode = JPH::EBackFaceMode::IgnoreBackFaces;
     opt.mTreatConvexAsSolid = false;
 
-    query.CastRay(ray, opt, collector, broadphaseFilter, objectFilter, bodyFilter);
+    context.m_Query.CastRay(ray, opt, collector, context.m_BroadphaseFilter, context.m_ObjectFilter, context.m_BodyFilter);
 
     if (collector.m_bFoundAny == false)
       return false;
   }
   else
   {
-    if (!query.CastRay(ray, collector.m_Result, broadphaseFilter, objectFilter, bodyFilter))
+    if (!context.m_Query.CastRay(ray, collector.m_Result, context.m_BroadphaseFilter, context.m_ObjectFilter, context.m_BodyFilter))
       return false;
   }
 
   out_Result.m_fDistance = collector.m_Result.mFraction * fDistance;
   out_Result.m_vPosition = vStart + fDistance * collector.m_Result.mFraction * vDir;
 
-  FillCastResult(out_Result, vStart, vDir, fDistance, collector.m_Result.mBodyID, collector.m_Result.mSubShapeID2, m_pSystem->GetBodyLockInterfaceNoLock(), m_pSystem->GetBodyInterfaceNoLock(), this);
+  FillCastResult(out_Result, vStart, vDir, fDistance, collector.m_Result.mBodyID, collector.m_Result.mSubShapeID2, context.m_LockInterface, context.m_BodyInterface, nullptr);
 
   return true;
 }
 
+bool ezJoltWorldModule::Raycast(ezPhysicsCastResult& out_Result, const ezVec3& vStart, const ezVec3& vDir, float fDistance, const ezPhysicsQueryParameters& params, ezPhysicsHitCollection collection /*= ezPhysicsHitCollection::Closest*/) const
+{
+  const ezJoltQueryContext context(*m_pSystem, params);
+
+  return CastRay(context, out_Result, vStart, vDir, fDistance, collection);
+}
+
 class ezRayCastCollectorAll : public JPH::CastRayCollector
 {
 public:
@@ -215,20 +243,14 @@ bool ezJoltWorldModule::SweepTestCapsule(ezPhysicsCastResult& out_Result, float
   return SweepTest(out_Result, shape, trans, vDir, fDistance, params, collection);
 }
 
-bool ezJoltWorldModule::SweepTest(ezPhysicsCastResult& out_Result, const JPH::Shape& shape, const JPH::Mat44& transform, const ezVec3& vDir, float fDistance, const ezPhysicsQueryParameters& params, ezPhysicsHitCollection collection) const
+static bool CastShape(const ezJoltQueryContext& context, ezPhysicsCastResult& out_Result, const JPH::Shape& shape, const JPH::Mat44& transform, const ezVec3& vDir, float fDistance, ezPhysicsHitCollection collection)
 {
-  const JPH::NarrowPhaseQuery& query = m_pSystem->GetNarrowPhaseQuery();
-
-  ezJoltBroadPhaseLayerFilter broadphaseFilter(params.m_ShapeTypes);
-  ezJoltBodyFilter bodyFilter(params.m_uiIgnoreObjectFilterID);
-  ezJoltObjectLayerFilter objectFilter(params.m_uiCollisionLayer);
-
   JPH::ShapeCast cast(&shape, JPH::Vec3(1, 1, 1), transform, ezJoltConversionUtils::ToVec3(vDir * fDistance));
 
   ezJoltShapeCastCollector collector;
   collector.m_bAnyHit = collection == ezPhysicsHitCollection::Any;
 
-  query.CastShape(cast, {}, collector, broadphaseFilter, objectFilter, bodyFilter);
+  context.m_Query.CastShape(cast, {}, collector, context.m_BroadphaseFilter, context.m_ObjectFilter, context.m_BodyFilter);
 
   if (!collector.m_bFoundAny)
     return false;
@@ -238,11 +260,91 @@ bool ezJoltWorldModule::SweepTest(ezPhysicsCastResult& out_Result, const JPH::Sh
   out_Result.m_fDistance = res.mFraction * fDistance;
   out_Result.m_vPosition = ezJoltConversionUtils::ToVec3(res.mContactPointOn2);
 
-  FillCastResult(out_Result, ezJoltConversionUtils::ToVec3(transform.GetTranslation()), vDir, fDistance, res.mBodyID2, res.mSubShapeID2, m_pSystem->GetBodyLockInterfaceNoLock(), m_pSystem->GetBodyInterfaceNoLock(), this);
+  FillCastResult(out_Result, ezJoltConversionUtils::ToVec3(transform.GetTranslation()), vDir, fDistance, res.mBodyID2, res.mSubShapeID2, context.m_LockInterface, context.m_BodyInterface, nullptr);
 
   return true;
 }
 
+bool ezJoltWorldModule::SweepTest(ezPhysicsCastResult& out_Result, const JPH::Shape& shape, const JPH::Mat44& transform, const ezVec3& vDir, float fDistance, const ezPhysicsQueryParameters& params, ezPhysicsHitCollection collection) const
+{
+  const ezJoltQueryContext context(*m_pSystem, params);
+
+  return CastShape(context, out_Result, shape, transform, vDir, fDistance, collection);
+}
+
+/// \brief Runs the cast callback for every request, large batches are split into chunks that run on worker threads.
+template <typename RequestType, typename CastFunc>
+static ezUInt32 RunCastBatch(const JPH::PhysicsSystem& system, ezArrayPtr<const RequestType> requests, ezArrayPtr<ezPhysicsCastResult> out_Results, ezArrayPtr<bool> out_Hits, const ezPhysicsQueryParameters& params, const char* szTaskName, CastFunc castFunc)
+{
+  EZ_ASSERT_DEV(out_Results.GetCount() == requests.GetCount() && out_Hits.GetCount() == requests.GetCount(), "Result arrays must have the same size as the request array");
+
+  struct BatchData
+  {
+    const JPH::PhysicsSystem* m_pSystem;
+    ezArrayPtr<const RequestType> m_Requests;
+    ezArrayPtr<ezPhysicsCastResult> m_Results;
+    ezArrayPtr<bool> m_Hits;
+    const ezPhysicsQueryParameters* m_pParams;
+    const CastFunc* m_pCastFunc;
+    ezAtomicInteger32 m_iNumHits;
+  };
+
+  BatchData data;
+  data.m_pSystem = &system;
+  data.m_Requests = requests;
+  data.m_Results = out_Results;
+  data.m_Hits = out_Hits;
+  data.m_pParams = &params;
+  data.m_pCastFunc = &castFunc;
+
+  // small batches are processed directly on this thread
+  ezParallelForParams parallelParams;
+  parallelParams.uiBinSize = 256;
+
+  ezTaskSystem::ParallelForIndexed(
+    0, requests.GetCount(),
+    [pData = &data](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) {
+      const ezJoltQueryContext context(*pData->m_pSystem, *pData->m_pParams);
+
+      ezInt32 iNumHits = 0;
+      for (ezUInt32 i = uiStartIndex; i < uiEndIndex; ++i)
+      {
+        const bool bHit = (*pData->m_pCastFunc)(context, pData->m_Requests[i], pData->m_Results[i]);
+        pData->m_Hits[i] = bHit;
+        iNumHits += bHit ? 1 : 0;
+      }
+
+      pData->m_iNumHits.Add(iNumHits);
+    },
+    szTaskName, parallelParams);
+
+  return static_cast<ezUInt32>(data.m_iNumHits);
+}
+
+ezUInt32 ezJoltWorldModule::RaycastBatch(ezArrayPtr<const ezPhysicsRaycastRequest> rays, ezArrayPtr<ezPhysicsCastResult> out_Results, ezArrayPtr<bool> out_Hits, const ezPhysicsQueryParameters& params, ezPhysicsHitCollection collection) const
+{
+  EZ_PROFILE_SCOPE("Jolt Raycast Batch");
+
+  return RunCastBatch(*m_pSystem, rays, out_Results, out_Hits, params, "ezJoltWorldModule::RaycastBatch",
+    [collection](const ezJoltQueryContext& context, const ezPhysicsRaycastRequest& ray, ezPhysicsCastResult& out_Result) {
+      return CastRay(context, out_Result, ray.m_vStart, ray.m_vDir, ray.m_fDistance, collection);
+    });
+}
+
+ezUInt32 ezJoltWorldModule::SweepTestSphereBatch(ezArrayPtr<const ezPhysicsSweepSphereRequest> sweeps, ezArrayPtr<ezPhysicsCastResult> out_Results, ezArrayPtr<bool> out_Hits, const ezPhysicsQueryParameters& params, ezPhysicsHitCollection collection) const
+{
+  EZ_PROFILE_SCOPE("Jolt Sphere Sweep Batch");
+
+  return RunCastBatch(*m_pSystem, sweeps, out_Results, out_Hits, params, "ezJoltWorldModule::SweepTestSphereBatch",
+    [collection](const ezJoltQueryContext& context, const ezPhysicsSweepSphereRequest& sweep, ezPhysicsCastResult& out_Result) {
+      if (sweep.m_fSphereRadius <= 0.0f)
+        return false;
+
+      const JPH::SphereShape shape(sweep.m_fSphereRadius);
+      return CastShape(context, out_Result, shape, JPH::Mat44::sTranslation(ezJoltConversionUtils::ToVec3(sweep.m_vStart)), sweep.m_vDir, sweep.m_fDistance, collection);
+    });
+}
+
 class ezJoltShapeCollectorAny : public JPH::CollideShapeCollector
 {
 public:
@@ -3,11 +3,11 @@
 #include <Core/Interfaces/PhysicsWorldModule.h>
 #include <Core/World/World.h>
 #include <Core/World/WorldModule.h>
-#include <Foundation/DataProcessing/Stream/ProcessingStreamIterator.h>
 #include <Foundation/Profiling/Profiling.h>
 #include <Foundation/Time/Clock.h>
 #include <ParticlePlugin/Behavior/ParticleBehavior_Gravity.h>
 #include <ParticlePlugin/Finalizer/ParticleFinalizer_ApplyVelocity.h>
+#include <ParticlePlugin/Streams/ParticleStreamUtils.h>
 #include <ParticlePlugin/System/ParticleSystemInstance.h>
 #include <ParticlePlugin/WorldModule/ParticleWorldModule.h>
 
@@ -73,23 +73,25 @@ void ezParticleBehavior_Gravity::CreateRequiredStreams()
   CreateStream("Velocity", ezProcessingStream::DataType::Float3, &m_pStreamVelocity, false);
 }
 
-void ezParticleBehavior_Gravity::Process(ezUInt64 uiNumElements)
+void ezParticleBehavior_Gravity::StepParticleSystem(const ezTime& tDiff, ezUInt32 uiNumNewParticles)
 {
-  EZ_PROFILE_SCOPE("PFX: Gravity");
+  SUPER::StepParticleSystem(tDiff, uiNumNewParticles);
 
   const ezVec3 vGravity = m_pPhysicsModule != nullptr ? m_pPhysicsModule->GetGravity() : ezVec3(0.0f, 0.0f, -10.0f);
 
-  const float tDiff = (float)m_TimeDiff.GetSeconds();
-  const ezVec3 addGravity = vGravity * m_fGravityFactor * tDiff;
+  m_vAddGravity = vGravity * m_fGravityFactor * (float)m_TimeDiff.GetSeconds();
+}
 
-  ezProcessingStreamIterator<ezVec3> itVelocity(m_pStreamVelocity, uiNumElements, 0);
+void ezParticleBehavior_Gravity::Process(ezUInt64 uiNumElements)
+{
+  ProcessRange(0, uiNumElements);
+}
 
-  while (!itVelocity.HasReachedEnd())
-  {
-    itVelocity.Current() += addGravity;
+void ezParticleBehavior_Gravity::ProcessRange(ezUInt64 uiStartIndex, ezUInt64 uiNumElements)
+{
+  EZ_PROFILE_SCOPE("PFX: Gravity");
 
-    itVelocity.Advance();
-  }
+  ezParticleStreamUtils::AddToFloat3(ezParticleStreamUtils::GetFloat3Data(m_pStreamVelocity, uiStartIndex), uiNumElements, m_vAddGravity);
 }
 
 void ezParticleBehavior_Gravity::RequestRequiredWorldModulesForCache(ezParticleWorldModule* pParticleModule)
@@ -36,11 +36,17 @@ public:
 protected:
   friend class ezParticleBehaviorFactory_Gravity;
 
+  virtual void StepParticleSystem(const ezTime& tDiff, ezUInt32 uiNumNewParticles) override;
   virtual void Process(ezUInt64 uiNumElements) override;
+  virtual bool SupportsParallelProcessing() const override { return true; }
+  virtual void ProcessRange(ezUInt64 uiStartIndex, ezUInt64 uiNumElements) override;
 
   void RequestRequiredWorldModulesForCache(ezParticleWorldModule* pParticleModule) override;
 
   ezPhysicsWorldModuleInterface* m_pPhysicsModule;
 
   ezProcessingStream* m_pStreamVelocity;
+
+  // computed once per frame in StepParticleSystem()
+  ezVec3 m_vAddGravity = ezVec3::ZeroVector();
 };
@@ -131,71 +131,88 @@ void ezParticleBehavior_Raycast::Process(ezUInt64 uiNumElements)
 {
   EZ_PROFILE_SCOPE("PFX: Raycast");
 
+  if (m_pPhysicsModule == nullptr)
+    return;
+
   const float tDiff = (float)m_TimeDiff.GetSeconds();
 
-  ezProcessingStreamIterator<ezVec4> itPosition(m_pStreamPosition, uiNumElements, 0);
-  ezProcessingStreamIterator<const ezVec3> itLastPosition(m_pStreamLastPosition, uiNumElements, 0);
-  ezProcessingStreamIterator<ezVec3> itVelocity(m_pStreamVelocity, uiNumElements, 0);
+  ezVec4* pPosition = m_pStreamPosition->GetWritableData<ezVec4>();
+  const ezVec3* pLastPosition = m_pStreamLastPosition->GetData<ezVec3>();
+  ezVec3* pVelocity = m_pStreamVelocity->GetWritableData<ezVec3>();
 
-  ezPhysicsCastResult hitResult;
+  // collect the rays of all moving particles first, so that they can be cast in one batch
+  m_Rays.Clear();
+  m_RayElements.Clear();
 
-  ezUInt32 i = 0;
-  while (!itPosition.HasReachedEnd())
+  for (ezUInt32 i = 0; i < static_cast<ezUInt32>(uiNumElements); ++i)
   {
-    const ezVec3 vLastPos = itLastPosition.Current();
-    const ezVec3 vCurPos = itPosition.Current().GetAsVec3();
+    const ezVec3 vLastPos = pLastPosition[i];
+    const ezVec3 vCurPos = pPosition[i].GetAsVec3();
+
+    if (vLastPos.IsZero())
+      continue;
+
+    const ezVec3 vChange = vCurPos - vLastPos;
+
+    if (vChange.IsZero(0.001f))
+      continue;
+
+    ezPhysicsRaycastRequest& ray = m_Rays.ExpandAndGetRef();
+    ray.m_vStart = vLastPos;
+    ray.m_vDir = vChange;
+    ray.m_fDistance = ray.m_vDir.GetLengthAndNormalize();
+
+    m_RayElements.PushBack(i);
+  }
+
+  if (m_Rays.IsEmpty())
+    return;
+
+  m_HitResults.SetCount(m_Rays.GetCount());
+  m_Hits.SetCountUninitialized(m_Rays.GetCount());
+
+  ezPhysicsQueryParameters query(m_uiCollisionLayer);
+  query.m_ShapeTypes = ezPhysicsShapeType::Static | ezPhysicsShapeType::Dynamic;
+
+  if (m_pPhysicsModule->RaycastBatch(m_Rays, m_HitResults, m_Hits, query) == 0)
+    return;
 
-    if (!vLastPos.IsZero())
+  for (ezUInt32 uiRay = 0; uiRay < m_Rays.GetCount(); ++uiRay)
+  {
+    if (!m_Hits[uiRay])
+      continue;
+
+    const ezUInt32 i = m_RayElements[uiRay];
+    const ezPhysicsCastResult& hitResult = m_HitResults[uiRay];
+    const ezVec3 vDirection = m_Rays[uiRay].m_vDir;
+
+    if (m_Reaction == ezParticleRaycastHitReaction::Bounce)
+    {
+      const ezVec3 vChange = pPosition[i].GetAsVec3() - pLastPosition[i];
+      const ezVec3 vNewDir = vChange.GetReflectedVector(hitResult.m_vNormal) * m_fBounceFactor;
+
+      pPosition[i] = ezVec3(hitResult.m_vPosition + hitResult.m_vNormal * 0.05f + vNewDir).GetAsVec4(0);
+      pVelocity[i] = vNewDir / tDiff;
+    }
+    else if (m_Reaction == ezParticleRaycastHitReaction::Die)
+    {
+      m_pStreamGroup->RemoveElement(i);
+    }
+    else if (m_Reaction == ezParticleRaycastHitReaction::Stop)
     {
-      const ezVec3 vChange = vCurPos - vLastPos;
-
-      if (!vChange.IsZero(0.001f))
-      {
-        ezVec3 vDirection = vChange;
-
-        const float fMaxLen = vDirection.GetLengthAndNormalize();
-
-        ezPhysicsQueryParameters query(m_uiCollisionLayer);
-        query.m_ShapeTypes = ezPhysicsShapeType::Static | ezPhysicsShapeType::Dynamic;
-
-        if (m_pPhysicsModule != nullptr && m_pPhysicsModule->Raycast(hitResult, vLastPos, vDirection, fMaxLen, query))
-        {
-          if (m_Reaction == ezParticleRaycastHitReaction::Bounce)
-          {
-            const ezVec3 vNewDir = vChange.GetReflectedVector(hitResult.m_vNormal) * m_fBounceFactor;
-
-            itPosition.Current() = ezVec3(hitResult.m_vPosition + hitResult.m_vNormal * 0.05f + vNewDir).GetAsVec4(0);
-            itVelocity.Current() = vNewDir / tDiff;
-          }
-          else if (m_Reaction == ezParticleRaycastHitReaction::Die)
-          {
-            /// \todo Get current element index from iterator ?
-            m_pStreamGroup->RemoveElement(i);
-          }
-          else if (m_Reaction == ezParticleRaycastHitReaction::Stop)
-          {
-            itVelocity.Current().SetZero();
-          }
-
-          if (!m_sOnCollideEvent.IsEmpty())
-          {
-            ezParticleEvent e;
-            e.m_EventType = m_sOnCollideEvent;
-            e.m_vPosition = hitResult.m_vPosition;
-            e.m_vNormal = hitResult.m_vNormal;
-            e.m_vDirection = vDirection;
-
-            GetOwnerEffect()->AddParticleEvent(e);
-          }
-        }
-      }
+      pVelocity[i].SetZero();
     }
 
-    itPosition.Advance();
-    itLastPosition.Advance();
-    itVelocity.Advance();
+    if (!m_sOnCollideEvent.IsEmpty())
+    {
+      ezParticleEvent e;
+      e.m_EventType = m_sOnCollideEvent;
+      e.m_vPosition = hitResult.m_vPosition;
+      e.m_vNormal = hitResult.m_vNormal;
+      e.m_vDirection = vDirection;
 
-    ++i;
+      GetOwnerEffect()->AddParticleEvent(e);
+    }
   }
 }
 
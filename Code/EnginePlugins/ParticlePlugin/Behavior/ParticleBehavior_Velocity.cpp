@@ -9,6 +9,7 @@
 #include <Foundation/Time/Clock.h>
 #include <ParticlePlugin/Behavior/ParticleBehavior_Velocity.h>
 #include <ParticlePlugin/Finalizer/ParticleFinalizer_ApplyVelocity.h>
+#include <ParticlePlugin/Streams/ParticleStreamUtils.h>
 #include <ParticlePlugin/System/ParticleSystemInstance.h>
 #include <ParticlePlugin/WorldModule/ParticleWorldModule.h>
 #include <RendererCore/RenderWorld/RenderWorld.h>
@@ -101,9 +102,9 @@ void ezParticleBehavior_Velocity::CreateRequiredStreams()
   CreateStream("Velocity", ezProcessingStream::DataType::Float3, &m_pStreamVelocity, false);
 }
 
-void ezParticleBehavior_Velocity::Process(ezUInt64 uiNumElements)
+void ezParticleBehavior_Velocity::StepParticleSystem(const ezTime& tDiff0, ezUInt32 uiNumNewParticles)
 {
-  EZ_PROFILE_SCOPE("PFX: Velocity");
+  SUPER::StepParticleSystem(tDiff0, uiNumNewParticles);
 
   const float tDiff = (float)m_TimeDiff.GetSeconds();
   const ezVec3 vDown = m_pPhysicsModule != nullptr ? m_pPhysicsModule->GetGravity().GetNormalized() : ezVec3(0.0f, 0.0f, -1.0f);
@@ -129,24 +130,36 @@ void ezParticleBehavior_Velocity::Process(ezUInt64 uiNumElements)
     m_iWindSampleIdx = pOwner->AddWindSampleLocation(GetOwnerSystem()->GetTransform().m_vPosition);
   }
 
-  const ezVec3 vAddPos0 = vRise + vWind;
-
-  ezSimdVec4f vAddPos;
-  vAddPos.Load<3>(&vAddPos0.x);
+  m_vAddPos = vRise + vWind;
 
   const float fFriction = ezMath::Clamp(m_fFriction, 0.0f, 100.0f);
-  const float fFrictionFactor = ezMath::Pow(0.5f, tDiff * fFriction);
+  m_fFrictionFactor = ezMath::Pow(0.5f, tDiff * fFriction);
+}
 
-  ezProcessingStreamIterator<ezSimdVec4f> itPosition(m_pStreamPosition, uiNumElements, 0);
-  ezProcessingStreamIterator<ezVec3> itVelocity(m_pStreamVelocity, uiNumElements, 0);
+void ezParticleBehavior_Velocity::Process(ezUInt64 uiNumElements)
+{
+  ProcessRange(0, uiNumElements);
+}
+
+void ezParticleBehavior_Velocity::ProcessRange(ezUInt64 uiStartIndex, ezUInt64 uiNumElements)
+{
+  EZ_PROFILE_SCOPE("PFX: Velocity");
+
+  ezSimdVec4f vAddPos;
+  vAddPos.Load<3>(&m_vAddPos.x);
+
+  ezProcessingStreamIterator<ezSimdVec4f> itPosition(m_pStreamPosition, uiNumElements, uiStartIndex);
 
   while (!itPosition.HasReachedEnd())
   {
     itPosition.Current() += vAddPos;
-    itVelocity.Current() *= fFrictionFactor;
 
     itPosition.Advance();
-    itVelocity.Advance();
+  }
+
+  if (m_fFrictionFactor != 1.0f)
+  {
+    ezParticleStreamUtils::MultiplyFloat3(ezParticleStreamUtils::GetFloat3Data(m_pStreamVelocity, uiStartIndex), uiNumElements, m_fFrictionFactor);
   }
 }
 
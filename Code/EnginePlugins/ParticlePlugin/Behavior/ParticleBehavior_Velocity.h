@@ -41,7 +41,10 @@ public:
 protected:
   friend class ezParticleBehaviorFactory_Velocity;
 
+  virtual void StepParticleSystem(const ezTime& tDiff, ezUInt32 uiNumNewParticles) override;
   virtual void Process(ezUInt64 uiNumElements) override;
+  virtual bool SupportsParallelProcessing() const override { return true; }
+  virtual void ProcessRange(ezUInt64 uiStartIndex, ezUInt64 uiNumElements) override;
 
   void RequestRequiredWorldModulesForCache(ezParticleWorldModule* pParticleModule) override;
 
@@ -54,4 +57,8 @@ protected:
   ezProcessingStream* m_pStreamVelocity;
 
   ezVec3 m_vLastWind = ezVec3::ZeroVector();
+
+  // computed once per frame in StepParticleSystem()
+  ezVec3 m_vAddPos = ezVec3::ZeroVector();
+  float m_fFrictionFactor = 1.0f;
 };
@@ -41,19 +41,26 @@ void ezParticleFinalizer_ApplyVelocity::CreateRequiredStreams()
 }
 
 void ezParticleFinalizer_ApplyVelocity::Process(ezUInt64 uiNumElements)
+{
+  ProcessRange(0, uiNumElements);
+}
+
+void ezParticleFinalizer_ApplyVelocity::ProcessRange(ezUInt64 uiStartIndex, ezUInt64 uiNumElements)
 {
   EZ_PROFILE_SCOPE("PFX: ApplyVelocity");
 
-  const float tDiff = (float)m_TimeDiff.GetSeconds();
+  const ezSimdFloat tDiff = (float)m_TimeDiff.GetSeconds();
 
-  ezProcessingStreamIterator<ezVec4> itPosition(m_pStreamPosition, uiNumElements, 0);
-  ezProcessingStreamIterator<ezVec3> itVelocity(m_pStreamVelocity, uiNumElements, 0);
+  ezProcessingStreamIterator<ezSimdVec4f> itPosition(m_pStreamPosition, uiNumElements, uiStartIndex);
+  ezProcessingStreamIterator<ezVec3> itVelocity(m_pStreamVelocity, uiNumElements, uiStartIndex);
 
   while (!itPosition.HasReachedEnd())
   {
-    ezVec3& pos = reinterpret_cast<ezVec3&>(itPosition.Current());
+    // Load<3> sets w to zero, so the particle's fourth position component is kept
+    ezSimdVec4f vel;
+    vel.Load<3>(&itVelocity.Current().x);
 
-    pos += itVelocity.Current() * tDiff;
+    itPosition.Current() += vel * tDiff;
 
     itPosition.Advance();
     itVelocity.Advance();
@@ -43,18 +43,20 @@ void ezParticleFinalizer_LastPosition::CreateRequiredStreams()
 }
 
 void ezParticleFinalizer_LastPosition::Process(ezUInt64 uiNumElements)
+{
+  ProcessRange(0, uiNumElements);
+}
+
+void ezParticleFinalizer_LastPosition::ProcessRange(ezUInt64 uiStartIndex, ezUInt64 uiNumElements)
 {
   EZ_PROFILE_SCOPE("PFX: LastPosition");
 
-  ezProcessingStreamIterator<ezVec4> itPosition(m_pStreamPosition, uiNumElements, 0);
-  ezProcessingStreamIterator<ezVec3> itLastPosition(m_pStreamLastPosition, uiNumElements, 0);
+  ezProcessingStreamIterator<ezSimdVec4f> itPosition(m_pStreamPosition, uiNumElements, uiStartIndex);
+  ezProcessingStreamIterator<ezVec3> itLastPosition(m_pStreamLastPosition, uiNumElements, uiStartIndex);
 
   while (!itPosition.HasReachedEnd())
   {
-    ezVec3 curPos = itPosition.Current().GetAsVec3();
-    ezVec3& lastPos = itLastPosition.Current();
-
-    lastPos = curPos;
+    itPosition.Current().Store<3>(&itLastPosition.Current().x);
 
     itPosition.Advance();
     itLastPosition.Advance();
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <Foundation/DataProcessing/Stream/ProcessingStream.h>
+#include <Foundation/SimdMath/SimdVec4f.h>
+#include <ParticlePlugin/ParticlePluginDLL.h>
+
+/// \brief SIMD helpers for particle streams that store tightly packed ezVec3 elements (ezProcessingStream::DataType::Float3).
+///
+/// Four ezVec3 elements are exactly three ezSimdVec4f, so these functions process the data in blocks of four elements
+/// and only handle the remainder one element at a time.
+struct ezParticleStreamUtils
+{
+  /// \brief Returns a pointer to the element at \a uiStartIndex of a Float3 stream, whose elements are tightly packed.
+  static ezVec3* GetFloat3Data(const ezProcessingStream* pStream, ezUInt64 uiStartIndex)
+  {
+    EZ_ASSERT_DEBUG(pStream->GetElementSize() == sizeof(ezVec3) && pStream->GetElementStride() == sizeof(ezVec3), "Stream is not a tightly packed Float3 stream");
+    return pStream->GetWritableData<ezVec3>() + uiStartIndex;
+  }
+
+  /// \brief Adds \a vValue to all elements.
+  static void AddToFloat3(ezVec3* pData, ezUInt64 uiNumElements, const ezVec3& vValue)
+  {
+    // the value rotated by one component per register, matching the layout of four consecutive ezVec3
+    const ezSimdVec4f add0(vValue.x, vValue.y, vValue.z, vValue.x);
+    const ezSimdVec4f add1(vValue.y, vValue.z, vValue.x, vValue.y);
+    const ezSimdVec4f add2(vValue.z, vValue.x, vValue.y, vValue.z);
+
+    const ezUInt64 uiNumBlocks = uiNumElements / 4;
+    float* pFloats = &pData->x;
+
+    for (ezUInt64 i = 0; i < uiNumBlocks; ++i, pFloats += 12)
+    {
+      ezSimdVec4f v0, v1, v2;
+      v0.Load<4>(pFloats + 0);
+      v1.Load<4>(pFloats + 4);
+      v2.Load<4>(pFloats + 8);
+
+      v0 += add0;
+      v1 += add1;
+      v2 += add2;
+
+      v0.Store<4>(pFloats + 0);
+      v1.Store<4>(pFloats + 4);
+      v2.Store<4>(pFloats + 8);
+    }
+
+    for (ezUInt64 i = uiNumBlocks * 4; i < uiNumElements; ++i)
+    {
+      pData[i] += vValue;
+    }
+  }
+
+  /// \brief Multiplies all elements with \a fFactor.
+  static void MultiplyFloat3(ezVec3* pData, ezUInt64 uiNumElements, float fFactor)
+  {
+    const ezSimdFloat factor(fFactor);
+
+    const ezUInt64 uiNumBlocks = uiNumElements / 4;
+    float* pFloats = &pData->x;
+
+    for (ezUInt64 i = 0; i < uiNumBlocks; ++i, pFloats += 12)
+    {
+      ezSimdVec4f v0, v1, v2;
+      v0.Load<4>(pFloats + 0);
+      v1.Load<4>(pFloats + 4);
+      v2.Load<4>(pFloats + 8);
+
+      v0 *= factor;
+      v1 *= factor;
+      v2 *= factor;
+
+      v0.Store<4>(pFloats + 0);
+      v1.Store<4>(pFloats + 4);
+      v2.Store<4>(pFloats + 8);
+    }
+
+    for (ezUInt64 i = uiNumBlocks * 4; i < uiNumElements; ++i)
+    {
+      pData[i] *= fFactor;
+    }
+  }
+};
@@ -3,15 +3,20 @@
 #include <ParticlePlugin/Type/Quad/ParticleTypeQuad.h>
 
 #include <Core/World/World.h>
+#include <Foundation/Algorithm/Sorting.h>
+#include <Foundation/Configuration/CVar.h>
 #include <Foundation/Math/Color16f.h>
 #include <Foundation/Math/Float16.h>
 #include <Foundation/Profiling/Profiling.h>
+#include <Foundation/Threading/TaskSystem.h>
 #include <ParticlePlugin/Effect/ParticleEffectInstance.h>
 #include <ParticlePlugin/Finalizer/ParticleFinalizer_LastPosition.h>
 #include <RendererCore/Pipeline/View.h>
 #include <RendererCore/RenderWorld/RenderWorld.h>
 #include <RendererFoundation/Shader/ShaderUtils.h>
 
+ezCVarBool cvar_ParticlesQuadSortReuseOrder("Particles.QuadSort.ReuseOrder", true, ezCVarFlags::Default, "Use the last frame's order as the starting point for sorting blended particles");
+
 // clang-format off
 EZ_BEGIN_STATIC_REFLECTED_ENUM(ezQuadParticleOrientation, 2)
   EZ_ENUM_CONSTANTS(ezQuadParticleOrientation::Billboard)
@@ -187,13 +192,6 @@ void ezParticleTypeQuad::CreateRequiredStreams()
   }
 }
 
-struct sodComparer
-{
-  // sort farther particles to the front, so that they get rendered first (back to front)
-  EZ_ALWAYS_INLINE bool Less(const ezParticleTypeQuad::sod& a, const ezParticleTypeQuad::sod& b) const { return a.dist > b.dist; }
-  EZ_ALWAYS_INLINE bool Equal(const ezParticleTypeQuad::sod& a, const ezParticleTypeQuad::sod& b) const { return a.dist == b.dist; }
-};
-
 void ezParticleTypeQuad::ExtractTypeRenderData(ezMsgExtractRenderData& msg, const ezTransform& instanceTransform) const
 {
   EZ_PROFILE_SCOPE("PFX: Quad");
@@ -212,26 +210,14 @@ void ezParticleTypeQuad::ExtractTypeRenderData(ezMsgExtractRenderData& msg, cons
 
     if (bNeedsSorting)
     {
-      // TODO: Using the frame allocator this way results in memory corruptions.
-      // Not sure, whether this is supposed to work.
-      ezHybridArray<sod, 64> sorted; // (ezFrameAllocator::GetCurrentAllocator());
-      sorted.SetCountUninitialized(numParticles);
-
-      const ezVec3 vCameraPos = msg.m_pView->GetCullingCamera()->GetCenterPosition();
-      const ezVec4* pPosition = m_pStreamPosition->GetData<ezVec4>();
-
-      for (ezUInt32 p = 0; p < numParticles; ++p)
-      {
-        sorted[p].dist = (pPosition[p].GetAsVec3() - vCameraPos).GetLengthSquared();
-        sorted[p].index = p;
-      }
-
-      sorted.Sort(sodComparer());
+      SortParticles(msg.m_pView->GetCullingCamera()->GetCenterPosition(), numParticles);
 
-      CreateExtractedData(&sorted);
+      CreateExtractedData(m_SortedParticles.GetData());
     }
     else
     {
+      m_SortedParticles.Clear();
+
       CreateExtractedData(nullptr);
     }
   }
@@ -239,20 +225,91 @@ void ezParticleTypeQuad::ExtractTypeRenderData(ezMsgExtractRenderData& msg, cons
   AddParticleRenderData(msg, instanceTransform);
 }
 
-EZ_ALWAYS_INLINE ezUInt32 noRedirect(ezUInt32 idx, const ezHybridArray<ezParticleTypeQuad::sod, 64>* pSorted)
+void ezParticleTypeQuad::SortParticles(const ezVec3& vCameraPos, ezUInt32 numParticles) const
 {
-  return idx;
-}
+  EZ_PROFILE_SCOPE("PFX: Quad Sort");
 
-EZ_ALWAYS_INLINE ezUInt32 sortedRedirect(ezUInt32 idx, const ezHybridArray<ezParticleTypeQuad::sod, 64>* pSorted)
-{
-  return (*pSorted)[idx].index;
+  const ezVec4* pPosition = m_pStreamPosition->GetData<ezVec4>();
+
+  auto ComputeDistance = [&](sod& s) { s.dist = (pPosition[s.index].GetAsVec3() - vCameraPos).GetLengthSquared(); };
+
+  bool bSorted = false;
+
+  if (cvar_ParticlesQuadSortReuseOrder && !m_SortedParticles.IsEmpty())
+  {
+    // Particles that died since the last frame were replaced by other particles at the same index,
+    // so the old order stays a valid permutation as long as we drop indices that don't exist anymore and append the new ones.
+    const ezUInt32 uiPrevNumParticles = m_SortedParticles.GetCount();
+    ezUInt32 uiNumKept = 0;
+
+    for (ezUInt32 i = 0; i < uiPrevNumParticles; ++i)
+    {
+      if (m_SortedParticles[i].index < numParticles)
+      {
+        m_SortedParticles[uiNumKept++] = m_SortedParticles[i];
+      }
+    }
+
+    m_SortedParticles.SetCountUninitialized(numParticles);
+
+    for (ezUInt32 p = uiPrevNumParticles; p < numParticles; ++p)
+    {
+      m_SortedParticles[uiNumKept++].index = p;
+    }
+
+    for (sod& s : m_SortedParticles)
+    {
+      ComputeDistance(s);
+    }
+
+    // the order usually changes very little from frame to frame, in which case an insertion sort is close to linear,
+    // if too many particles have to be moved, the partially sorted array is sorted from scratch instead
+    ezUInt32 uiMoveBudget = numParticles * 4;
+    bSorted = true;
+
+    for (ezUInt32 i = 1; i < numParticles && bSorted; ++i)
+    {
+      const sod current = m_SortedParticles[i];
+      ezUInt32 j = i;
+
+      // sort farther particles to the front, so that they get rendered first (back to front)
+      while (j > 0 && m_SortedParticles[j - 1].dist < current.dist)
+      {
+        m_SortedParticles[j] = m_SortedParticles[j - 1];
+        --j;
+
+        if (--uiMoveBudget == 0)
+        {
+          bSorted = false;
+          break;
+        }
+      }
+
+      m_SortedParticles[j] = current;
+    }
+  }
+  else
+  {
+    m_SortedParticles.SetCountUninitialized(numParticles);
+
+    for (ezUInt32 p = 0; p < numParticles; ++p)
+    {
+      m_SortedParticles[p].index = p;
+      ComputeDistance(m_SortedParticles[p]);
+    }
+  }
+
+  if (!bSorted)
+  {
+    m_SortScratch.SetCountUninitialized(numParticles);
+
+    // sort farther particles to the front, so that they get rendered first (back to front)
+    ezSorting::RadixSort(m_SortedParticles.GetArrayPtr(), m_SortScratch.GetArrayPtr(), [](const sod& s) { return ~ezSorting::FloatToRadixKey(s.dist); });
+  }
 }
 
-void ezParticleTypeQuad::CreateExtractedData(const ezHybridArray<sod, 64>* pSorted) const
+void ezParticleTypeQuad::CreateExtractedData(const sod* pSorted) const
 {
-  auto redirect = (pSorted != nullptr) ? sortedRedirect : noRedirect;
-
   const ezUInt32 numParticles = (ezUInt32)GetOwnerSystem()->GetNumActiveParticles();
 
   const bool bNeedsBillboardData = m_Orientation == ezQuadParticleOrientation::Billboard;
@@ -346,61 +403,78 @@ void ezParticleTypeQuad::CreateExtractedData(const ezHybridArray<sod, 64>* pSort
     m_TangentParticleData[dstIdx].TangentZ.x = m_fStretch;
   };
 
-  for (ezUInt32 p = 0; p < numParticles; ++p)
-  {
-    SetBaseData(p, redirect(p, pSorted));
-  }
-
-  if (bNeedsBillboardData)
-  {
-    for (ezUInt32 p = 0; p < numParticles; ++p)
+  // writes the data of the particles in [uiStart; uiEnd) in render order, redirect maps a render position to the particle index
+  auto FillRange = [&](ezUInt32 uiStart, ezUInt32 uiEnd, auto redirect) {
+    for (ezUInt32 p = uiStart; p < uiEnd; ++p)
     {
-      SetBillboardData(p, redirect(p, pSorted));
+      SetBaseData(p, redirect(p));
     }
-  }
 
-  if (bNeedsTangentData)
-  {
-    if (m_Orientation == ezQuadParticleOrientation::Rotating_EmitterDir)
+    if (bNeedsBillboardData)
     {
-      for (ezUInt32 p = 0; p < numParticles; ++p)
+      for (ezUInt32 p = uiStart; p < uiEnd; ++p)
       {
-        SetTangentDataEmitterDir(p, redirect(p, pSorted));
+        SetBillboardData(p, redirect(p));
       }
     }
-    else if (m_Orientation == ezQuadParticleOrientation::Rotating_OrthoEmitterDir)
+
+    if (bNeedsTangentData)
     {
-      for (ezUInt32 p = 0; p < numParticles; ++p)
+      if (m_Orientation == ezQuadParticleOrientation::Rotating_EmitterDir)
       {
-        SetTangentDataEmitterDirOrtho(p, redirect(p, pSorted));
+        for (ezUInt32 p = uiStart; p < uiEnd; ++p)
+        {
+          SetTangentDataEmitterDir(p, redirect(p));
+        }
       }
-    }
-    else if (m_Orientation == ezQuadParticleOrientation::Fixed_EmitterDir || m_Orientation == ezQuadParticleOrientation::Fixed_RandomDir || m_Orientation == ezQuadParticleOrientation::Fixed_WorldUp)
-    {
-      for (ezUInt32 p = 0; p < numParticles; ++p)
+      else if (m_Orientation == ezQuadParticleOrientation::Rotating_OrthoEmitterDir)
       {
-        SetTangentDataFromAxis(p, redirect(p, pSorted));
+        for (ezUInt32 p = uiStart; p < uiEnd; ++p)
+        {
+          SetTangentDataEmitterDirOrtho(p, redirect(p));
+        }
       }
-    }
-    else if (m_Orientation == ezQuadParticleOrientation::FixedAxis_EmitterDir)
-    {
-      for (ezUInt32 p = 0; p < numParticles; ++p)
+      else if (m_Orientation == ezQuadParticleOrientation::Fixed_EmitterDir || m_Orientation == ezQuadParticleOrientation::Fixed_RandomDir || m_Orientation == ezQuadParticleOrientation::Fixed_WorldUp)
       {
-        SetTangentDataAligned_Emitter(p, redirect(p, pSorted));
+        for (ezUInt32 p = uiStart; p < uiEnd; ++p)
+        {
+          SetTangentDataFromAxis(p, redirect(p));
+        }
       }
-    }
-    else if (m_Orientation == ezQuadParticleOrientation::FixedAxis_ParticleDir)
-    {
-      for (ezUInt32 p = 0; p < numParticles; ++p)
+      else if (m_Orientation == ezQuadParticleOrientation::FixedAxis_EmitterDir)
       {
-        SetTangentDataAligned_ParticleDir(p, redirect(p, pSorted));
+        for (ezUInt32 p = uiStart; p < uiEnd; ++p)
+        {
+          SetTangentDataAligned_Emitter(p, redirect(p));
+        }
+      }
+      else if (m_Orientation == ezQuadParticleOrientation::FixedAxis_ParticleDir)
+      {
+        for (ezUInt32 p = uiStart; p < uiEnd; ++p)
+        {
+          SetTangentDataAligned_ParticleDir(p, redirect(p));
+        }
+      }
+      else
+      {
+        EZ_ASSERT_NOT_IMPLEMENTED;
       }
     }
-    else
-    {
-      EZ_ASSERT_NOT_IMPLEMENTED;
-    }
-  }
+  };
+
+  // small systems are processed directly on this thread
+  ezParallelForParams params;
+  params.uiBinSize = 4096;
+
+  ezTaskSystem::ParallelForIndexed(
+    0, numParticles,
+    [&FillRange, pSorted](ezUInt32 uiStart, ezUInt32 uiEnd) {
+      if (pSorted != nullptr)
+        FillRange(uiStart, uiEnd, [pSorted](ezUInt32 p) { return pSorted[p].index; });
+      else
+        FillRange(uiStart, uiEnd, [](ezUInt32 p) { return p; });
+    },
+    "ezParticleTypeQuad::CreateExtractedData", params);
 }
 
 void ezParticleTypeQuad::AddParticleRenderData(ezMsgExtractRenderData& msg, const ezTransform& instanceTransform) const
@@ -94,7 +94,8 @@ protected:
   virtual void Process(ezUInt64 uiNumElements) override {}
   void AllocateParticleData(const ezUInt32 numParticles, const bool bNeedsBillboardData, const bool bNeedsTangentData) const;
   void AddParticleRenderData(ezMsgExtractRenderData& msg, const ezTransform& instanceTransform) const;
-  void CreateExtractedData(const ezHybridArray<sod, 64>* pSorted) const;
+  void SortParticles(const ezVec3& vCameraPos, ezUInt32 numParticles) const;
+  void CreateExtractedData(const sod* pSorted) const;
 
   ezProcessingStream* m_pStreamLifeTime = nullptr;
   ezProcessingStream* m_pStreamPosition = nullptr;
@@ -109,4 +110,8 @@ protected:
   mutable ezArrayPtr<ezBaseParticleShaderData> m_BaseParticleData;
   mutable ezArrayPtr<ezBillboardQuadParticleShaderData> m_BillboardParticleData;
   mutable ezArrayPtr<ezTangentQuadParticleShaderData> m_TangentParticleData;
+
+  /// \brief The back to front order of the particles from the last extraction. Used as the starting point for sorting in the next frame.
+  mutable ezDynamicArray<sod> m_SortedParticles;
+  mutable ezDynamicArray<sod> m_SortScratch;
 };
@@ -0,0 +1,171 @@
+#include <ProcGenPlugin/ProcGenPluginPCH.h>
+
+#include <Foundation/Algorithm/HashStream.h>
+#include <ProcGenPlugin/Components/Implementation/PlacementCache.h>
+#include <ProcGenPlugin/Components/VolumeCollection.h>
+#include <ProcGenPlugin/Tasks/PlacementData.h>
+
+using namespace ezProcGenInternal;
+
+namespace
+{
+  static constexpr ezUInt8 s_uiPlacementCacheVersion = 1;
+}
+
+PlacementCache::PlacementCache() = default;
+PlacementCache::~PlacementCache() = default;
+
+// static
+ezUInt64 PlacementCache::ComputeKey(const PlacementData& data)
+{
+  if (data.m_pOutput == nullptr || data.m_pOutput->m_uiContentHash == 0)
+    return 0;
+
+  ezHashStreamWriter64 writer(data.m_pOutput->m_uiContentHash);
+
+  // the bounding box covers the tile coordinate as well as the height range
+  writer << data.m_TileBoundingBox.m_vMin;
+  writer << data.m_TileBoundingBox.m_vMax;
+  writer << data.m_iTileSeed;
+
+  writer << data.m_GlobalToLocalBoxTransforms.GetCount();
+  writer.WriteBytes(data.m_GlobalToLocalBoxTransforms.GetData(), data.m_GlobalToLocalBoxTransforms.GetCount() * sizeof(ezSimdMat4f)).IgnoreResult();
+
+  writer << data.m_VolumeCollections.GetCount();
+  for (const ezVolumeCollection& volumeCollection : data.m_VolumeCollections)
+  {
+    writer << volumeCollection.ComputeContentHash();
+  }
+
+  const ezUInt64 uiKey = writer.GetHashValue();
+  return uiKey != 0 ? uiKey : 1;
+}
+
+bool PlacementCache::Lookup(ezUInt64 uiKey, ezDynamicArray<PlacementTransform, ezAlignedAllocatorWrapper>& out_Transforms)
+{
+  Entry* pEntry = m_Entries.GetValue(uiKey);
+  if (pEntry == nullptr)
+    return false;
+
+  out_Transforms = pEntry->m_Transforms;
+
+  m_LruKeys.Remove(pEntry->m_LruIt);
+  m_LruKeys.PushFront(uiKey);
+  pEntry->m_LruIt = m_LruKeys.GetIterator();
+
+  return true;
+}
+
+void PlacementCache::Store(ezUInt64 uiKey, ezArrayPtr<const PlacementTransform> transforms)
+{
+  EZ_ASSERT_DEV(uiKey != 0, "Invalid cache key");
+
+  Remove(uiKey);
+
+  m_LruKeys.PushFront(uiKey);
+
+  Entry& entry = m_Entries[uiKey];
+  entry.m_Transforms = transforms;
+  entry.m_LruIt = m_LruKeys.GetIterator();
+
+  m_uiMemoryUsage += GetMemoryUsage(entry);
+
+  EvictToBudget();
+}
+
+void PlacementCache::SetMemoryBudget(ezUInt64 uiMemoryBudget)
+{
+  m_uiMemoryBudget = uiMemoryBudget;
+
+  EvictToBudget();
+}
+
+void PlacementCache::Clear()
+{
+  m_Entries.Clear();
+  m_LruKeys.Clear();
+  m_uiMemoryUsage = 0;
+}
+
+ezResult PlacementCache::Save(ezStreamWriter& stream) const
+{
+  stream << s_uiPlacementCacheVersion;
+  stream << static_cast<ezUInt32>(sizeof(PlacementTransform));
+  stream << m_Entries.GetCount();
+
+  // write the least recently used entries first, so loading restores the same order
+  for (auto it = m_LruKeys.GetLastIterator(); it.IsValid(); --it)
+  {
+    const ezUInt64 uiKey = *it;
+    const Entry* pEntry = m_Entries.GetValue(uiKey);
+
+    stream << uiKey;
+    stream << pEntry->m_Transforms.GetCount();
+    EZ_SUCCEED_OR_RETURN(stream.WriteBytes(pEntry->m_Transforms.GetData(), pEntry->m_Transforms.GetCount() * sizeof(PlacementTransform)));
+  }
+
+  return EZ_SUCCESS;
+}
+
+ezResult PlacementCache::Load(ezStreamReader& stream)
+{
+  Clear();
+
+  ezUInt8 uiVersion = 0;
+  stream >> uiVersion;
+
+  ezUInt32 uiTransformSize = 0;
+  stream >> uiTransformSize;
+
+  if (uiVersion != s_uiPlacementCacheVersion || uiTransformSize != sizeof(PlacementTransform))
+    return EZ_FAILURE;
+
+  ezUInt32 uiNumEntries = 0;
+  stream >> uiNumEntries;
+
+  ezDynamicArray<PlacementTransform, ezAlignedAllocatorWrapper> transforms;
+  for (ezUInt32 i = 0; i < uiNumEntries; ++i)
+  {
+    ezUInt64 uiKey = 0;
+    stream >> uiKey;
+
+    ezUInt32 uiNumTransforms = 0;
+    stream >> uiNumTransforms;
+
+    transforms.SetCountUninitialized(uiNumTransforms);
+    const ezUInt64 uiNumBytes = uiNumTransforms * sizeof(PlacementTransform);
+    if (uiKey == 0 || stream.ReadBytes(transforms.GetData(), uiNumBytes) != uiNumBytes)
+    {
+      Clear();
+      return EZ_FAILURE;
+    }
+
+    Store(uiKey, transforms);
+  }
+
+  return EZ_SUCCESS;
+}
+
+// static
+ezUInt64 PlacementCache::GetMemoryUsage(const Entry& entry)
+{
+  return sizeof(Entry) + sizeof(ezUInt64) + entry.m_Transforms.GetCount() * sizeof(PlacementTransform);
+}
+
+void PlacementCache::Remove(ezUInt64 uiKey)
+{
+  Entry entry;
+  if (m_Entries.Remove(uiKey, &entry))
+  {
+    m_uiMemoryUsage -= GetMemoryUsage(entry);
+    m_LruKeys.Remove(entry.m_LruIt);
+  }
+}
+
+void PlacementCache::EvictToBudget()
+{
+  while (m_uiMemoryUsage > m_uiMemoryBudget && !m_LruKeys.IsEmpty())
+  {
+    Remove(m_LruKeys.PeekBack());
+  }
+}
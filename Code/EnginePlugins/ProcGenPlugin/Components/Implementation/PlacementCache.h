@@ -0,0 +1,60 @@
+#pragma once
+
+#include <Foundation/Containers/HashTable.h>
+#include <Foundation/Containers/List.h>
+#include <ProcGenPlugin/Declarations.h>
+
+class ezStreamWriter;
+class ezStreamReader;
+
+namespace ezProcGenInternal
+{
+  /// \brief Stores the placement results of tiles, such that re-entering a tile whose inputs didn't change restores the objects
+  /// without running the placement task again.
+  ///
+  /// Results are identified by a key that combines the graph output, the tile coordinate and the volumes that affect the tile,
+  /// see ComputeKey(). The least recently used results are evicted once the memory budget is exceeded.
+  /// Note that the physics geometry under a tile is not part of the key, so results are only correct as long as it doesn't change.
+  class EZ_PROCGENPLUGIN_DLL PlacementCache
+  {
+  public:
+    PlacementCache();
+    ~PlacementCache();
+
+    /// \brief Computes the cache key for the prepared placement data. Returns zero if the result can't be cached.
+    static ezUInt64 ComputeKey(const PlacementData& data);
+
+    /// \brief Copies the cached transforms for the given key to \a out_Transforms and marks the entry as recently used.
+    bool Lookup(ezUInt64 uiKey, ezDynamicArray<PlacementTransform, ezAlignedAllocatorWrapper>& out_Transforms);
+
+    /// \brief Stores the transforms for the given key, replacing any previous result, and evicts old entries if necessary.
+    void Store(ezUInt64 uiKey, ezArrayPtr<const PlacementTransform> transforms);
+
+    void SetMemoryBudget(ezUInt64 uiMemoryBudget);
+    ezUInt64 GetMemoryBudget() const { return m_uiMemoryBudget; }
+    ezUInt64 GetMemoryUsage() const { return m_uiMemoryUsage; }
+    ezUInt32 GetCount() const { return m_Entries.GetCount(); }
+
+    void Clear();
+
+    ezResult Save(ezStreamWriter& stream) const;
+    ezResult Load(ezStreamReader& stream);
+
+  private:
+    struct Entry
+    {
+      ezDynamicArray<PlacementTransform, ezAlignedAllocatorWrapper> m_Transforms;
+      ezList<ezUInt64>::Iterator m_LruIt;
+    };
+
+    static ezUInt64 GetMemoryUsage(const Entry& entry);
+    void Remove(ezUInt64 uiKey);
+    void EvictToBudget();
+
+    ezHashTable<ezUInt64, Entry> m_Entries;
+    ezList<ezUInt64> m_LruKeys; ///< Most recently used keys come first.
+
+    ezUInt64 m_uiMemoryUsage = 0;
+    ezUInt64 m_uiMemoryBudget = 16 * 1024 * 1024;
+  };
+} // namespace ezProcGenInternal
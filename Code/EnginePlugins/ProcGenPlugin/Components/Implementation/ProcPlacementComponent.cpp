@@ -5,7 +5,10 @@
 #include <Core/WorldSerializer/WorldReader.h>
 #include <Core/WorldSerializer/WorldWriter.h>
 #include <Foundation/Configuration/CVar.h>
+#include <Foundation/IO/FileSystem/FileReader.h>
+#include <Foundation/IO/FileSystem/FileWriter.h>
 #include <Foundation/Profiling/Profiling.h>
+#include <ProcGenPlugin/Components/Implementation/PlacementCache.h>
 #include <ProcGenPlugin/Components/Implementation/PlacementTile.h>
 #include <ProcGenPlugin/Components/ProcPlacementComponent.h>
 #include <ProcGenPlugin/Tasks/FindPlacementTilesTask.h>
@@ -21,11 +24,15 @@ using namespace ezProcGenInternal;
 
 ezCVarInt cvar_ProcGenProcessingMaxTiles("ProcGen.Processing.MaxTiles", 8, ezCVarFlags::Default, "Maximum number of tiles in process");
 ezCVarInt cvar_ProcGenProcessingMaxNewObjectsPerFrame("ProcGen.Processing.MaxNewObjectsPerFrame", 128, ezCVarFlags::Default, "Maximum number of objects placed per frame");
+ezCVarBool cvar_ProcGenCacheEnable("ProcGen.Cache.Enable", true, ezCVarFlags::Default, "Restores the objects of previously visited tiles from a cache instead of running the placement again");
+ezCVarInt cvar_ProcGenCacheMaxSizeMB("ProcGen.Cache.MaxSizeMB", 16, ezCVarFlags::Default, "Memory budget of the placement cache per world in MB");
+ezCVarBool cvar_ProcGenCachePersistToDisk("ProcGen.Cache.PersistToDisk", false, ezCVarFlags::Save, "Writes the placement cache to disk when a world is destroyed and reads it when the world is created again");
 ezCVarBool cvar_ProcGenVisTiles("ProcGen.VisTiles", false, ezCVarFlags::Default, "Enables debug visualization of procedural placement tiles");
 
 ezProcPlacementComponentManager::ezProcPlacementComponentManager(ezWorld* pWorld)
   : ezComponentManager<ezProcPlacementComponent, ezBlockStorageType::Compact>(pWorld)
 {
+  m_pPlacementCache = EZ_DEFAULT_NEW(PlacementCache);
 }
 
 ezProcPlacementComponentManager::~ezProcPlacementComponentManager() {}
@@ -57,6 +64,8 @@ void ezProcPlacementComponentManager::Initialize()
   }
 
   ezResourceManager::GetResourceEvents().AddEventHandler(ezMakeDelegate(&ezProcPlacementComponentManager::OnResourceEvent, this));
+
+  LoadPlacementCache();
 }
 
 void ezProcPlacementComponentManager::Deinitialize()
@@ -69,6 +78,9 @@ void ezProcPlacementComponentManager::Deinitialize()
   }
   m_ActiveTiles.Clear();
 
+  SavePlacementCache();
+  m_pPlacementCache->Clear();
+
   SUPER::Deinitialize();
 }
 
@@ -288,6 +300,18 @@ void ezProcPlacementComponentManager::PreparePlace(const ezWorldModule::UpdateCo
           continue;
 
         processingTask.m_uiScheduledFrame = ezRenderWorld::GetFrameCounter();
+
+        // All inputs are known once the volumes are extracted, so a previous result can be restored instead of running the placement
+        if (cvar_ProcGenCacheEnable)
+        {
+          processingTask.m_uiCacheKey = PlacementCache::ComputeKey(*processingTask.m_pData);
+          if (processingTask.m_uiCacheKey != 0 && m_pPlacementCache->Lookup(processingTask.m_uiCacheKey, processingTask.m_CachedTransforms))
+          {
+            processingTask.m_bUsesCachedResult = true;
+            continue;
+          }
+        }
+
         processingTask.m_PlacementTaskGroupID = ezTaskSystem::StartSingleTask(processingTask.m_pPlacementTask, ezTaskPriority::LongRunningHighPriority);
       }
     }
@@ -296,6 +320,12 @@ void ezProcPlacementComponentManager::PreparePlace(const ezWorldModule::UpdateCo
 
 void ezProcPlacementComponentManager::PlaceObjects(const ezWorldModule::UpdateContext& context)
 {
+  const ezUInt64 uiCacheMemoryBudget = static_cast<ezUInt64>(ezMath::Max<int>(cvar_ProcGenCacheMaxSizeMB, 0)) * 1024 * 1024;
+  if (m_pPlacementCache->GetMemoryBudget() != uiCacheMemoryBudget)
+  {
+    m_pPlacementCache->SetMemoryBudget(uiCacheMemoryBudget);
+  }
+
   m_SortedProcessingTasks.Clear();
   for (ezUInt32 i = 0; i < m_ProcessingTasks.GetCount(); ++i)
   {
@@ -314,8 +344,23 @@ void ezProcPlacementComponentManager::PlaceObjects(const ezWorldModule::UpdateCo
     if (!task.IsValid() || !task.IsScheduled())
       continue;
 
-    if (task.m_pPlacementTask->IsTaskFinished())
+    if (task.m_bUsesCachedResult || task.m_pPlacementTask->IsTaskFinished())
     {
+      ezArrayPtr<const PlacementTransform> objectTransforms;
+      if (task.m_bUsesCachedResult)
+      {
+        objectTransforms = task.m_CachedTransforms;
+      }
+      else
+      {
+        objectTransforms = task.m_pPlacementTask->GetOutputTransforms();
+
+        if (task.m_uiCacheKey != 0)
+        {
+          m_pPlacementCache->Store(task.m_uiCacheKey, objectTransforms);
+        }
+      }
+
       ezUInt32 uiPlacedObjects = 0;
 
       ezUInt32 uiTileIndex = task.m_uiTileIndex;
@@ -330,7 +375,7 @@ void ezProcPlacementComponentManager::PlaceObjects(const ezWorldModule::UpdateCo
         ezUInt64 uiTileKey = GetTileKey(tileDesc.m_iPosX, tileDesc.m_iPosY);
         if (auto pTile = outputContext.m_TileIndices.GetValue(uiTileKey))
         {
-          uiPlacedObjects = activeTile.PlaceObjects(*GetWorld(), task.m_pPlacementTask->GetOutputTransforms());
+          uiPlacedObjects = activeTile.PlaceObjects(*GetWorld(), objectTransforms);
 
           pTile->m_uiIndex = uiPlacedObjects > 0 ? uiTileIndex : EmptyTileIndex;
           pTile->m_uiLastSeenFrame = ezRenderWorld::GetFrameCounter();
@@ -356,6 +401,47 @@ void ezProcPlacementComponentManager::PlaceObjects(const ezWorldModule::UpdateCo
   }
 }
 
+void ezProcPlacementComponentManager::GetPlacementCacheFile(ezStringBuilder& out_sPath) const
+{
+  ezStringBuilder sWorldName;
+  ezPathUtils::MakeValidFilename(GetWorld()->GetName(), '_', sWorldName).IgnoreResult();
+
+  out_sPath.Format(":appdata/ProcGen/{}.ezProcGenCache", sWorldName);
+}
+
+void ezProcPlacementComponentManager::LoadPlacementCache()
+{
+  if (!cvar_ProcGenCachePersistToDisk)
+    return;
+
+  ezStringBuilder sPath;
+  GetPlacementCacheFile(sPath);
+
+  ezFileReader file;
+  if (file.Open(sPath).Failed())
+    return;
+
+  if (m_pPlacementCache->Load(file).Failed())
+  {
+    ezLog::Warning("Discarding outdated procedural placement cache '{}'", sPath);
+  }
+}
+
+void ezProcPlacementComponentManager::SavePlacementCache() const
+{
+  if (!cvar_ProcGenCachePersistToDisk || m_pPlacementCache->GetCount() == 0)
+    return;
+
+  ezStringBuilder sPath;
+  GetPlacementCacheFile(sPath);
+
+  ezFileWriter file;
+  if (file.Open(sPath).Failed() || m_pPlacementCache->Save(file).Failed())
+  {
+    ezLog::Error("Failed to write procedural placement cache '{}'", sPath);
+  }
+}
+
 void ezProcPlacementComponentManager::DebugDrawTile(const ezProcGenInternal::PlacementTileDesc& desc, const ezColor& color, ezUInt32 uiQueueIndex)
 {
   const ezProcPlacementComponent* pComponent = nullptr;
@@ -457,7 +543,7 @@ ezUInt32 ezProcPlacementComponentManager::AllocateProcessingTask(ezUInt32 uiTile
 void ezProcPlacementComponentManager::DeallocateProcessingTask(ezUInt32 uiTaskIndex)
 {
   auto& task = m_ProcessingTasks[uiTaskIndex];
-  if (task.IsScheduled())
+  if (task.m_PlacementTaskGroupID.IsValid())
   {
     ezTaskSystem::WaitForGroup(task.m_PlacementTaskGroupID);
   }
@@ -1,5 +1,6 @@
 #include <ProcGenPlugin/ProcGenPluginPCH.h>
 
+#include <Foundation/Algorithm/HashStream.h>
 #include <GameEngine/Utils/ImageDataResource.h>
 #include <ProcGenPlugin/Components/VolumeCollection.h>
 #include <Texture/Image/ImageUtils.h>
@@ -57,6 +58,28 @@ ezSimdMat4f ezVolumeCollection::Shape::GetGlobalToLocalTransform() const
 EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezVolumeCollection, 1, ezRTTINoAllocator)
 EZ_END_DYNAMIC_REFLECTED_TYPE;
 
+ezUInt64 ezVolumeCollection::ComputeContentHash(ezUInt64 uiSeed /*= 0*/) const
+{
+  ezHashStreamWriter64 writer(uiSeed);
+
+  // spheres and boxes don't have any padding (see the size checks above), so their memory can be hashed directly
+  writer << m_Spheres.GetCount();
+  writer.WriteBytes(m_Spheres.GetData(), m_Spheres.GetCount() * sizeof(Sphere)).IgnoreResult();
+
+  writer << m_Boxes.GetCount();
+  writer.WriteBytes(m_Boxes.GetData(), m_Boxes.GetCount() * sizeof(Box)).IgnoreResult();
+
+  // images are identified by their content hash instead of the pixel pointer
+  writer << m_Images.GetCount();
+  for (const Image& image : m_Images)
+  {
+    writer.WriteBytes(static_cast<const Box*>(&image), sizeof(Box)).IgnoreResult();
+    writer << image.m_uiContentHash;
+  }
+
+  return writer.GetHashValue();
+}
+
 // static
 ezUInt32 ezVolumeCollection::ComputeSortingKey(float fSortOrder, float fMaxScale)
 {
@@ -291,6 +314,15 @@ void ezVolumeCollection::AddImage(const ezSimdTransform& transform, const ezVec3
     shape.m_pPixelData = pImage->GetDescriptor().m_Image.GetPixelPointer<ezColor>();
     shape.m_uiImageWidth = pImage->GetDescriptor().m_Image.GetWidth();
     shape.m_uiImageHeight = pImage->GetDescriptor().m_Image.GetHeight();
+
+    // Hashing the pixels would be too expensive here. The file modification time detects changes across sessions (e.g. for a
+    // persisted placement cache), the change counter detects reloads and modifications at runtime.
+    ezHashStreamWriter64 writer(shape.m_Image.GetResourceIDHash());
+    writer << pImage->GetLoadedFileModificationTime().GetInt64(ezSIUnitOfTime::Microsecond);
+    writer << pImage->GetCurrentResourceChangeCounter();
+    writer << shape.m_uiImageWidth;
+    writer << shape.m_uiImageHeight;
+    shape.m_uiContentHash = writer.GetHashValue();
   }
 }
 
@@ -9,6 +9,11 @@ class ezProcPlacementComponent;
 struct ezMsgUpdateLocalBounds;
 struct ezMsgExtractRenderData;
 
+namespace ezProcGenInternal
+{
+  class PlacementCache;
+}
+
 //////////////////////////////////////////////////////////////////////////
 
 class EZ_PROCGENPLUGIN_DLL ezProcPlacementComponentManager : public ezComponentManager<ezProcPlacementComponent, ezBlockStorageType::Compact>
@@ -27,6 +32,10 @@ private:
   void PreparePlace(const ezWorldModule::UpdateContext& context);
   void PlaceObjects(const ezWorldModule::UpdateContext& context);
 
+  void GetPlacementCacheFile(ezStringBuilder& out_sPath) const;
+  void LoadPlacementCache();
+  void SavePlacementCache() const;
+
   void DebugDrawTile(const ezProcGenInternal::PlacementTileDesc& desc, const ezColor& color, ezUInt32 uiQueueIndex = ezInvalidIndex);
 
   void AddComponent(ezProcPlacementComponent* pComponent);
@@ -63,12 +72,15 @@ private:
   struct ProcessingTask
   {
     EZ_ALWAYS_INLINE bool IsValid() const { return m_uiTileIndex != ezInvalidIndex; }
-    EZ_ALWAYS_INLINE bool IsScheduled() const { return m_PlacementTaskGroupID.IsValid(); }
+    EZ_ALWAYS_INLINE bool IsScheduled() const { return m_PlacementTaskGroupID.IsValid() || m_bUsesCachedResult; }
     EZ_ALWAYS_INLINE void Invalidate()
     {
       m_uiScheduledFrame = -1;
       m_PlacementTaskGroupID.Invalidate();
       m_uiTileIndex = ezInvalidIndex;
+      m_uiCacheKey = 0;
+      m_bUsesCachedResult = false;
+      m_CachedTransforms.Clear();
     }
 
     ezUInt64 m_uiScheduledFrame;
@@ -77,6 +89,10 @@ private:
     ezSharedPtr<ezProcGenInternal::PlacementTask> m_pPlacementTask;
     ezTaskGroupID m_PlacementTaskGroupID;
     ezUInt32 m_uiTileIndex;
+
+    ezUInt64 m_uiCacheKey = 0;
+    bool m_bUsesCachedResult = false;
+    ezDynamicArray<ezProcGenInternal::PlacementTransform, ezAlignedAllocatorWrapper> m_CachedTransforms;
   };
 
   ezDynamicArray<ProcessingTask> m_ProcessingTasks;
@@ -92,6 +108,8 @@ private:
 
   ezDynamicArray<ezProcGenInternal::PlacementTileDesc, ezAlignedAllocatorWrapper> m_NewTiles;
   ezTaskGroupID m_UpdateTilesTaskGroupID;
+
+  ezUniquePtr<ezProcGenInternal::PlacementCache> m_pPlacementCache;
 };
 
 //////////////////////////////////////////////////////////////////////////
@@ -60,10 +60,14 @@ public:
     const ezColor* m_pPixelData = nullptr;
     ezUInt32 m_uiImageWidth = 0;
     ezUInt32 m_uiImageHeight = 0;
+    ezUInt64 m_uiContentHash = 0; ///< Identifies the image content, changes when the resource is modified or reloaded.
   };
 
   bool IsEmpty() { return m_Spheres.IsEmpty() && m_Boxes.IsEmpty(); }
 
+  /// \brief Computes a hash over all shapes in this collection. Collections with the same hash evaluate to the same values everywhere.
+  ezUInt64 ComputeContentHash(ezUInt64 uiSeed = 0) const;
+
   static ezUInt32 ComputeSortingKey(float fSortOrder, float fMaxScale);
 
   float EvaluateAtGlobalPosition(const ezVec3& vPosition, float fInitialValue, ezProcVolumeImageMode::Enum imgMode, const ezColor& refColor) const;
@@ -150,7 +150,7 @@ namespace ezProcGenInternal
     virtual ~GraphSharedDataBase();
   };
 
-  struct Output : public ezRefCounted
+  struct EZ_PROCGENPLUGIN_DLL Output : public ezRefCounted
   {
     virtual ~Output();
 
@@ -162,7 +162,7 @@ namespace ezProcGenInternal
     ezUniquePtr<ezExpressionByteCode> m_pByteCode;
   };
 
-  struct PlacementOutput : public Output
+  struct EZ_PROCGENPLUGIN_DLL PlacementOutput : public Output
   {
     float GetTileSize() const { return m_pPattern->m_fSize * m_fFootprint; }
 
@@ -194,6 +194,9 @@ namespace ezProcGenInternal
     ezSurfaceResourceHandle m_hSurface;
 
     ezEnum<ezProcPlacementMode> m_Mode;
+
+    /// \brief Identifies the graph asset and output this was loaded from. Used as part of the placement cache key, zero disables caching.
+    ezUInt64 m_uiContentHash = 0;
   };
 
   struct VertexColorOutput : public Output
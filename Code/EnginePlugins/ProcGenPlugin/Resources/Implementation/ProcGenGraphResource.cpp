@@ -177,6 +177,12 @@ ezResourceLoadDesc ezProcGenGraphResource::UpdateContent(ezStreamReader* Stream)
             chunk >> pOutput->m_Mode;
           }
 
+          // the asset hash changes whenever anything in the graph changes, so together with the output index it identifies this output's content
+          if (AssetHash.GetFileHash() != 0)
+          {
+            pOutput->m_uiContentHash = ezHashingUtils::xxHash64(&uiIndex, sizeof(uiIndex), AssetHash.GetFileHash());
+          }
+
           m_PlacementOutputs.PushBack(pOutput);
         }
       }
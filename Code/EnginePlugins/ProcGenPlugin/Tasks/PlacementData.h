@@ -8,7 +8,7 @@ class ezVolumeCollection;
 
 namespace ezProcGenInternal
 {
-  struct PlacementData
+  struct EZ_PROCGENPLUGIN_DLL PlacementData
   {
     PlacementData();
     ~PlacementData();
@@ -49,19 +49,26 @@ void ezRcAgentComponent::DeserializeComponent(ezWorldReader& stream)
 ezResult ezRcAgentComponent::InitializeRecast()
 {
   if (m_bRecastInitialized)
-    return EZ_SUCCESS;
+  {
+    if (m_pWorldModule->GetNavMeshQuery() != nullptr)
+      return EZ_SUCCESS;
+
+    // the world module dropped its queries, because the navmesh was unloaded or replaced
+    // the corridor references polygons of the old navmesh, so start over once the new one is available
+    UninitializeRecast();
+  }
+
+  m_pWorldModule = GetWorld()->GetOrCreateModule<ezRecastWorldModule>();
 
-  const dtNavMesh* pNavMesh = GetWorld()->GetOrCreateModule<ezRecastWorldModule>()->GetDetourNavMesh();
-  if (pNavMesh == nullptr)
+  // the query object is shared by all agents, path searches are done asynchronously by the world module
+  if (m_pWorldModule->GetNavMeshQuery() == nullptr)
     return EZ_FAILURE;
 
   m_bRecastInitialized = true;
 
-  m_pQuery = EZ_DEFAULT_NEW(dtNavMeshQuery);
   m_pCorridor = EZ_DEFAULT_NEW(dtPathCorridor);
 
   /// \todo Hard-coded limits
-  m_pQuery->init(pNavMesh, 512);
   m_pCorridor->init(256);
 
   return EZ_SUCCESS;
@@ -73,7 +80,6 @@ void ezRcAgentComponent::UninitializeRecast()
     return;
 
   m_bRecastInitialized = false;
-  m_pQuery.Clear();
   m_pCorridor.Clear();
 
   if (m_PathToTargetState != ezAgentPathFindingState::HasNoTarget)
@@ -89,6 +95,12 @@ void ezRcAgentComponent::ClearTargetPosition()
   m_PathCorridor.Clear();
   m_vCurrentSteeringDirection.SetZero();
 
+  if (!m_PathRequestId.IsInvalidated())
+  {
+    m_pWorldModule->CancelPathRequest(m_PathRequestId);
+    m_PathRequestId.Invalidate();
+  }
+
   if (m_PathToTargetState != ezAgentPathFindingState::HasNoTarget)
   {
     m_PathToTargetState = ezAgentPathFindingState::HasNoTarget;
@@ -121,12 +133,15 @@ ezVec3 ezRcAgentComponent::GetTargetPosition() const
 
 ezResult ezRcAgentComponent::FindNavMeshPolyAt(const ezVec3& vPosition, dtPolyRef& out_PolyRef, ezVec3* out_vAdjustedPosition /*= nullptr*/, float fPlaneEpsilon /*= 0.01f*/, float fHeightEpsilon /*= 1.0f*/) const
 {
+  if (m_pWorldModule == nullptr || m_pWorldModule->GetNavMeshQuery() == nullptr)
+    return EZ_FAILURE;
+
   ezRcPos rcPos = vPosition;
   ezVec3 vSize(fPlaneEpsilon, fHeightEpsilon, fPlaneEpsilon);
 
   ezRcPos resultPos;
   dtQueryFilter filter; /// \todo Hard-coded filter
-  if (dtStatusFailed(m_pQuery->findNearestPoly(rcPos, &vSize.x, &m_QueryFilter, &out_PolyRef, resultPos)))
+  if (dtStatusFailed(m_pWorldModule->GetNavMeshQuery()->findNearestPoly(rcPos, &vSize.x, &m_QueryFilter, &out_PolyRef, resultPos)))
     return EZ_FAILURE;
 
   if (!ezMath::IsEqual(vPosition.x, resultPos.m_Pos[0], fPlaneEpsilon) || !ezMath::IsEqual(vPosition.y, resultPos.m_Pos[2], fPlaneEpsilon) || !ezMath::IsEqual(vPosition.z, resultPos.m_Pos[1], fHeightEpsilon))
@@ -140,89 +155,69 @@ ezResult ezRcAgentComponent::FindNavMeshPolyAt(const ezVec3& vPosition, dtPolyRe
   return EZ_SUCCESS;
 }
 
-ezResult ezRcAgentComponent::ComputePathCorridor(dtPolyRef startPoly, dtPolyRef endPoly, bool& bFoundPartialPath)
+ezResult ezRcAgentComponent::UpdatePathRequest()
 {
-  bFoundPartialPath = false;
-
-  ezRcPos rcStart = m_vCurrentPositionOnNavmesh;
-  ezRcPos rcEnd = m_vTargetPosition;
-
-  ezInt32 iPathCorridorLength = 0;
-
-  // make enough room
-  m_PathCorridor.SetCountUninitialized(256);
-  if (dtStatusFailed(m_pQuery->findPath(startPoly, endPoly, rcStart, rcEnd, &m_QueryFilter, m_PathCorridor.GetData(), &iPathCorridorLength, (int)m_PathCorridor.GetCount())) || iPathCorridorLength <= 0)
+  if (m_PathRequestId.IsInvalidated())
   {
-    m_PathCorridor.Clear();
+    // the result will be available next frame at the earliest
+    m_PathRequestId = m_pWorldModule->RequestPath(GetOwner()->GetGlobalPosition(), m_vTargetPosition, m_QueryFilter);
     return EZ_FAILURE;
   }
 
-  // reduce to actual length
-  m_PathCorridor.SetCountUninitialized(iPathCorridorLength);
-
-  if (m_PathCorridor[iPathCorridorLength - 1] != endPoly)
-  {
-    // if this is the case, the target position cannot be reached, but we can walk close to it
-    bFoundPartialPath = true;
-  }
+  ezRecastPathResult result;
+  const ezRecastPathRequestState::Enum state = m_pWorldModule->PollPathRequest(m_PathRequestId, result);
 
-  m_pCorridor->reset(startPoly, rcStart);
-  m_pCorridor->setCorridor(rcEnd, m_PathCorridor.GetData(), iPathCorridorLength);
+  if (state == ezRecastPathRequestState::Pending)
+    return EZ_FAILURE;
 
-  return EZ_SUCCESS;
-}
+  m_PathRequestId.Invalidate();
 
-ezResult ezRcAgentComponent::ComputePathToTarget()
-{
-  const ezVec3 vStartPos = GetOwner()->GetGlobalPosition();
+  ezAgentSteeringEvent e;
+  e.m_pComponent = this;
 
-  dtPolyRef startPoly;
-  if (FindNavMeshPolyAt(vStartPos, startPoly, &m_vCurrentPositionOnNavmesh).Failed())
+  switch (state)
   {
-    m_PathToTargetState = ezAgentPathFindingState::HasTargetPathFindingFailed;
+    case ezRecastPathRequestState::Succeeded:
+      ApplyPathResult(result);
 
-    ezAgentSteeringEvent e;
-    e.m_pComponent = this;
-    e.m_Type = ezAgentSteeringEvent::ErrorOutsideNavArea;
-    m_SteeringEvents.Broadcast(e);
-    return EZ_FAILURE;
-  }
+      m_PathToTargetState = ezAgentPathFindingState::HasTargetAndValidPath;
+      e.m_Type = ezAgentSteeringEvent::PathToTargetFound;
+      m_SteeringEvents.Broadcast(e);
+      return EZ_SUCCESS;
 
-  dtPolyRef endPoly;
-  if (FindNavMeshPolyAt(m_vTargetPosition, endPoly).Failed())
-  {
-    m_PathToTargetState = ezAgentPathFindingState::HasTargetPathFindingFailed;
+    case ezRecastPathRequestState::StartNotOnNavMesh:
+      e.m_Type = ezAgentSteeringEvent::ErrorOutsideNavArea;
+      break;
 
-    ezAgentSteeringEvent e;
-    e.m_pComponent = this;
-    e.m_Type = ezAgentSteeringEvent::ErrorInvalidTargetPosition;
-    m_SteeringEvents.Broadcast(e);
-    return EZ_FAILURE;
-  }
+    case ezRecastPathRequestState::TargetNotOnNavMesh:
+      e.m_Type = ezAgentSteeringEvent::ErrorInvalidTargetPosition;
+      break;
 
-  /// \todo Optimize case when endPoly is same as previously ?
+    case ezRecastPathRequestState::PartialPath:
+      /// \todo For now a partial path is considered an error
+      e.m_Type = ezAgentSteeringEvent::WarningNoFullPathToTarget;
+      break;
 
-  bool bFoundPartialPath = false;
-  if (ComputePathCorridor(startPoly, endPoly, bFoundPartialPath).Failed() || bFoundPartialPath)
-  {
-    m_PathToTargetState = ezAgentPathFindingState::HasTargetPathFindingFailed;
+    default:
+      e.m_Type = ezAgentSteeringEvent::ErrorNoPathToTarget;
+      break;
+  }
 
-    /// \todo For now a partial path is considered an error
+  m_PathToTargetState = ezAgentPathFindingState::HasTargetPathFindingFailed;
+  m_SteeringEvents.Broadcast(e);
+  return EZ_FAILURE;
+}
 
-    ezAgentSteeringEvent e;
-    e.m_pComponent = this;
-    e.m_Type = bFoundPartialPath ? ezAgentSteeringEvent::WarningNoFullPathToTarget : ezAgentSteeringEvent::ErrorNoPathToTarget;
-    m_SteeringEvents.Broadcast(e);
-    return EZ_FAILURE;
-  }
+void ezRcAgentComponent::ApplyPathResult(ezRecastPathResult& result)
+{
+  m_vCurrentPositionOnNavmesh = result.m_vStartPosition;
+  m_PathCorridor = std::move(result.m_Corridor);
 
-  m_PathToTargetState = ezAgentPathFindingState::HasTargetAndValidPath;
+  const ezRcPos rcStart = m_vCurrentPositionOnNavmesh;
+  const ezRcPos rcEnd = m_vTargetPosition;
 
-  ezAgentSteeringEvent e;
-  e.m_pComponent = this;
-  e.m_Type = ezAgentSteeringEvent::PathToTargetFound;
-  m_SteeringEvents.Broadcast(e);
-  return EZ_SUCCESS;
+  m_pCorridor->reset(m_PathCorridor[0], rcStart);
+  m_pCorridor->setCorridor(rcEnd, m_PathCorridor.GetData(), (int)m_PathCorridor.GetCount());
 }
 
 bool ezRcAgentComponent::HasReachedPosition(const ezVec3& pos, float fMaxDistance) const
@@ -263,7 +258,7 @@ void ezRcAgentComponent::PlanNextSteps()
   dtPolyRef stepPolys[16];
 
   m_iFirstNextStep = 0;
-  m_iNumNextSteps = m_pCorridor->findCorners(&m_vNextSteps[0].x, stepFlags, stepPolys, 4, m_pQuery.Borrow(), &m_QueryFilter);
+  m_iNumNextSteps = m_pCorridor->findCorners(&m_vNextSteps[0].x, stepFlags, stepPolys, 4, m_pWorldModule->GetNavMeshQuery(), &m_QueryFilter);
 
   // convert from Recast convention (Y up) to ez (Z up)
   for (ezInt32 i = 0; i < m_iNumNextSteps; ++i)
@@ -274,10 +269,13 @@ void ezRcAgentComponent::PlanNextSteps()
 
 bool ezRcAgentComponent::IsPositionVisible(const ezVec3& pos) const
 {
+  if (!m_bRecastInitialized || m_pWorldModule->GetNavMeshQuery() == nullptr)
+    return false;
+
   ezRcPos endPos = pos;
 
   dtRaycastHit hit;
-  if (dtStatusFailed(m_pQuery->raycast(m_pCorridor->getFirstPoly(), m_pCorridor->getPos(), endPos, &m_QueryFilter, 0, &hit)))
+  if (dtStatusFailed(m_pWorldModule->GetNavMeshQuery()->raycast(m_pCorridor->getFirstPoly(), m_pCorridor->getPos(), endPos, &m_QueryFilter, 0, &hit)))
     return false;
 
   // 'visible' if no hit was detected
@@ -297,6 +295,18 @@ void ezRcAgentComponent::OnSimulationStarted()
   }
 }
 
+void ezRcAgentComponent::OnDeactivated()
+{
+  if (!m_PathRequestId.IsInvalidated())
+  {
+    // the path is requested again, if the component gets activated again
+    m_pWorldModule->CancelPathRequest(m_PathRequestId);
+    m_PathRequestId.Invalidate();
+  }
+
+  SUPER::OnDeactivated();
+}
+
 void ezRcAgentComponent::ApplySteering(const ezVec3& vDirection, float fSpeed)
 {
   // compute new rotation
@@ -339,7 +349,7 @@ void ezRcAgentComponent::SyncSteeringWithReality()
 {
   const ezRcPos rcCurrentAgentPosition = GetOwner()->GetGlobalPosition();
 
-  if (!m_pCorridor->movePosition(rcCurrentAgentPosition, m_pQuery.Borrow(), &m_QueryFilter))
+  if (!m_pCorridor->movePosition(rcCurrentAgentPosition, m_pWorldModule->GetNavMeshQuery(), &m_QueryFilter))
   {
     ezAgentSteeringEvent e;
     e.m_pComponent = this;
@@ -372,7 +382,7 @@ void ezRcAgentComponent::Update()
   // target is set, but no path is computed yet
   if (GetPathToTargetState() == ezAgentPathFindingState::HasTargetWaitingForPath)
   {
-    if (ComputePathToTarget().Failed())
+    if (UpdatePathRequest().Failed())
       return;
 
     PlanNextSteps();
@@ -490,7 +500,7 @@ void ezRcAgentComponent::VisualizePathCorridor()
 
     const dtMeshTile* pTile;
     const dtPoly* pPoly;
-    m_pQuery->getAttachedNavMesh()->getTileAndPolyByRef(poly, &pTile, &pPoly);
+    m_pWorldModule->GetDetourNavMesh()->getTileAndPolyByRef(poly, &pTile, &pPoly);
 
     ezHybridArray<ezDebugRenderer::Triangle, 32> tris;
 
@@ -8,8 +8,8 @@
 #include <RecastPlugin/Components/RecastNavMeshComponent.h>
 #include <RecastPlugin/NavMeshBuilder/NavMeshBuilder.h>
 #include <RecastPlugin/RecastPluginDLL.h>
+#include <RecastPlugin/WorldModule/RecastWorldModule.h>
 
-class ezRecastWorldModule;
 class ezPhysicsWorldModuleInterface;
 struct ezResourceEvent;
 
@@ -84,8 +84,8 @@ private:
   // Path Finding and Steering
 
 private:
-  ezResult ComputePathToTarget();
-  ezResult ComputePathCorridor(dtPolyRef startPoly, dtPolyRef endPoly, bool& bFoundPartialPath);
+  ezResult UpdatePathRequest();
+  void ApplyPathResult(ezRecastPathResult& result);
   void ComputeSteeringDirection(float fMaxDistance);
   void ApplySteering(const ezVec3& vDirection, float fSpeed);
   void SyncSteeringWithReality();
@@ -94,7 +94,8 @@ private:
   ezVec3 m_vTargetPosition;
   ezEnum<ezAgentPathFindingState> m_PathToTargetState;
   ezVec3 m_vCurrentPositionOnNavmesh;      /// \todo ??? keep update ?
-  ezUniquePtr<dtNavMeshQuery> m_pQuery;    // careful, dtNavMeshQuery is not moveble
+  ezRecastWorldModule* m_pWorldModule = nullptr;
+  ezRecastPathRequestId m_PathRequestId;
   ezUniquePtr<dtPathCorridor> m_pCorridor; // careful, dtPathCorridor is not moveble
   dtQueryFilter m_QueryFilter;             /// \todo hard-coded filter
   ezDynamicArray<dtPolyRef> m_PathCorridor;
@@ -120,6 +121,7 @@ private:
   ezResult InitializeRecast();
   void UninitializeRecast();
   virtual void OnSimulationStarted() override;
+  virtual void OnDeactivated() override;
   void Update();
 
   bool m_bRecastInitialized = false;
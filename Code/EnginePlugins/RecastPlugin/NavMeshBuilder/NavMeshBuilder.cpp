@@ -1,6 +1,9 @@
 #include <RecastPlugin/RecastPluginPCH.h>
 
 #include <Core/World/World.h>
+#include <Foundation/Algorithm/HashingUtils.h>
+#include <Foundation/Containers/HashTable.h>
+#include <Foundation/Threading/TaskSystem.h>
 #include <Foundation/Time/Stopwatch.h>
 #include <Foundation/Types/ScopeExit.h>
 #include <Foundation/Utilities/GraphicsUtils.h>
@@ -15,7 +18,7 @@
 #include <RendererCore/Utils/WorldGeoExtractionUtil.h>
 
 // clang-format off
-EZ_BEGIN_STATIC_REFLECTED_TYPE(ezRecastConfig, ezNoBase, 1, ezRTTIDefaultAllocator<ezRecastConfig>)
+EZ_BEGIN_STATIC_REFLECTED_TYPE(ezRecastConfig, ezNoBase, 2, ezRTTIDefaultAllocator<ezRecastConfig>)
 {
   EZ_BEGIN_PROPERTIES
   {
@@ -31,6 +34,7 @@ EZ_BEGIN_STATIC_REFLECTED_TYPE(ezRecastConfig, ezNoBase, 1, ezRTTIDefaultAllocat
     EZ_MEMBER_PROPERTY("SampleErrorFactor", m_fDetailMeshSampleErrorFactor)->AddAttributes(new ezDefaultValueAttribute(1.0f)),
     EZ_MEMBER_PROPERTY("MaxSimplification", m_fMaxSimplificationError)->AddAttributes(new ezDefaultValueAttribute(1.3f)),
     EZ_MEMBER_PROPERTY("MaxEdgeLength", m_fMaxEdgeLength)->AddAttributes(new ezDefaultValueAttribute(4.0f)),
+    EZ_MEMBER_PROPERTY("TileSize", m_fTileSize)->AddAttributes(new ezDefaultValueAttribute(32.0f), new ezClampValueAttribute(0.0f, ezVariant())),
   }
   EZ_END_PROPERTIES;
 }
@@ -64,6 +68,42 @@ protected:
   }
 };
 
+struct ezRecastNavMeshBuilder::TileJob
+{
+  ezDynamicArray<ezInt32> m_Triangles;
+  ezRecastNavMeshTile m_Result;
+  bool m_bNeedsBuild = true;
+};
+
+namespace
+{
+  class ezNavMeshTileTask final : public ezTask
+  {
+  public:
+    ezNavMeshTileTask(ezDelegate<void(ezUInt32)> func)
+      : m_Func(func)
+    {
+      ConfigureTask("Build NavMesh Tile", ezTaskNesting::Never);
+    }
+
+    virtual void ExecuteWithMultiplicity(ezUInt32 uiInvocation) const override { m_Func(uiInvocation); }
+
+  private:
+    ezDelegate<void(ezUInt32)> m_Func;
+  };
+} // namespace
+
+EZ_ALWAYS_INLINE static ezUInt64 GetTileKey(ezInt32 iTileX, ezInt32 iTileY)
+{
+  return (static_cast<ezUInt64>(static_cast<ezUInt32>(iTileX)) << 32) | static_cast<ezUInt32>(iTileY);
+}
+
+EZ_ALWAYS_INLINE static ezInt32 GetBorderCells(const ezRecastConfig& config)
+{
+  // tiles need to overlap by the agent radius plus a few cells, so that the eroded walkable area matches at tile boundaries
+  return (ezInt32)ceilf(config.m_fAgentRadius / config.m_fCellSize) + 3;
+}
+
 ezRecastNavMeshBuilder::ezRecastNavMeshBuilder() = default;
 ezRecastNavMeshBuilder::~ezRecastNavMeshBuilder() = default;
 
@@ -72,8 +112,7 @@ void ezRecastNavMeshBuilder::Clear()
   m_BoundingBox.SetInvalid();
   m_Vertices.Clear();
   m_Triangles.Clear();
-  m_TriangleAreaIDs.Clear();
-  m_pRecastContext = nullptr;
+  m_uiNumTilesGenerated = 0;
 }
 
 ezResult ezRecastNavMeshBuilder::ExtractWorldGeometry(const ezWorld& world, ezWorldGeoExtractionUtil::MeshObjectList& out_worldGeo)
@@ -84,51 +123,212 @@ ezResult ezRecastNavMeshBuilder::ExtractWorldGeometry(const ezWorld& world, ezWo
 }
 
 ezResult ezRecastNavMeshBuilder::Build(const ezRecastConfig& config, const ezWorldGeoExtractionUtil::MeshObjectList& geo,
-  ezRecastNavMeshResourceDescriptor& out_NavMeshDesc, ezProgress& progress)
+  ezRecastNavMeshResourceDescriptor& out_NavMeshDesc, ezProgress& progress, ezRecastNavMeshResourceDescriptor* pPreviousBuild)
 {
   EZ_LOG_BLOCK("ezRecastNavMeshBuilder::Build");
 
-  ezProgressRange pg("Generating NavMesh", 4, true, &progress);
+  ezProgressRange pg("Generating NavMesh", 2, true, &progress);
   pg.SetStepWeighting(0, 0.1f);
-  pg.SetStepWeighting(1, 0.1f);
-  pg.SetStepWeighting(2, 0.6f);
-  pg.SetStepWeighting(3, 0.2f);
+  pg.SetStepWeighting(1, 0.9f);
 
   Clear();
   out_NavMeshDesc.Clear();
 
-  ezUniquePtr<ezRcBuildContext> recastContext = EZ_DEFAULT_NEW(ezRcBuildContext);
-  m_pRecastContext = recastContext.Borrow();
-
   if (!pg.BeginNextStep("Triangulate Mesh"))
     return EZ_FAILURE;
 
   GenerateTriangleMeshFromDescription(geo);
 
-  if (m_Vertices.IsEmpty())
+  if (!pg.BeginNextStep("Build Tiles"))
+    return EZ_FAILURE;
+
+  return BuildFromTriangleMesh(config, out_NavMeshDesc, progress, pPreviousBuild);
+}
+
+ezResult ezRecastNavMeshBuilder::Build(const ezRecastConfig& config, ezArrayPtr<const ezVec3> vertices, ezArrayPtr<const ezUInt32> indices,
+  ezRecastNavMeshResourceDescriptor& out_NavMeshDesc, ezProgress& progress, ezRecastNavMeshResourceDescriptor* pPreviousBuild)
+{
+  EZ_LOG_BLOCK("ezRecastNavMeshBuilder::Build");
+
+  Clear();
+  out_NavMeshDesc.Clear();
+
+  GenerateTriangleMeshFromArrays(vertices, indices);
+
+  return BuildFromTriangleMesh(config, out_NavMeshDesc, progress, pPreviousBuild);
+}
+
+ezResult ezRecastNavMeshBuilder::RebuildTiles(const ezRecastConfig& config, const ezWorldGeoExtractionUtil::MeshObjectList& worldGeo,
+  const ezBoundingBox& changedArea, const ezRecastNavMeshResourceDescriptor& navMesh, ezDynamicArray<ezRecastNavMeshTile>& out_Tiles,
+  ezProgress& progress)
+{
+  EZ_LOG_BLOCK("ezRecastNavMeshBuilder::RebuildTiles");
+
+  out_Tiles.Clear();
+
+  if (navMesh.m_fTileWorldSize <= 0.0f)
   {
-    ezLog::Debug("Navmesh is empty");
-    return EZ_SUCCESS;
+    ezLog::Error("Can't rebuild tiles of an empty navmesh.");
+    return EZ_FAILURE;
   }
 
-  if (!pg.BeginNextStep("Compute AABB"))
+  ezProgressRange pg("Rebuilding NavMesh Tiles", 2, true, &progress);
+  pg.SetStepWeighting(0, 0.1f);
+  pg.SetStepWeighting(1, 0.9f);
+
+  Clear();
+
+  if (!pg.BeginNextStep("Triangulate Mesh"))
     return EZ_FAILURE;
 
+  GenerateTriangleMeshFromDescription(worldGeo);
   ComputeBoundingBox();
 
-  if (!pg.BeginNextStep("Build Poly Mesh"))
-    return EZ_FAILURE;
+  TileGrid grid;
+  grid.m_vOrigin = navMesh.m_vTileGridOrigin;
+  grid.m_fTileWorldSize = navMesh.m_fTileWorldSize;
+  grid.m_iTileCells = (ezInt32)ezMath::Round(navMesh.m_fTileWorldSize / config.m_fCellSize);
 
-  out_NavMeshDesc.m_pNavMeshPolygons = EZ_DEFAULT_NEW(rcPolyMesh);
+  // the tile grid is in Recast space (Y up), the changed area is in ez space (Z up)
+  // the grid origin is the minimum of the original build, so there are no tiles at negative coordinates
+  const double fMinX = ezMath::Max(0.0, ezMath::Floor((double)(changedArea.m_vMin.x - grid.m_vOrigin.x) / grid.m_fTileWorldSize));
+  const double fMaxX = ezMath::Floor((double)(changedArea.m_vMax.x - grid.m_vOrigin.x) / grid.m_fTileWorldSize);
+  const double fMinY = ezMath::Max(0.0, ezMath::Floor((double)(changedArea.m_vMin.y - grid.m_vOrigin.z) / grid.m_fTileWorldSize));
+  const double fMaxY = ezMath::Floor((double)(changedArea.m_vMax.y - grid.m_vOrigin.z) / grid.m_fTileWorldSize);
 
-  if (BuildRecastPolyMesh(config, *out_NavMeshDesc.m_pNavMeshPolygons, progress).Failed())
+  if (fMaxX < fMinX || fMaxY < fMinY)
+    return EZ_SUCCESS;
+
+  // computed in double precision, so that a huge or invalid area can't overflow the tile count
+  const double fNumTiles = (fMaxX - fMinX + 1.0) * (fMaxY - fMinY + 1.0);
+  if (fNumTiles > navMesh.m_uiMaxTiles)
+  {
+    ezLog::Error("The changed area covers {} tiles, but the navmesh supports at most {} tiles.", fNumTiles, navMesh.m_uiMaxTiles);
     return EZ_FAILURE;
+  }
+
+  const ezInt32 iMinX = (ezInt32)fMinX;
+  const ezInt32 iMaxX = (ezInt32)fMaxX;
+  const ezInt32 iMinY = (ezInt32)fMinY;
+  const ezInt32 iMaxY = (ezInt32)fMaxY;
+
+  ezDynamicArray<TileJob> jobs;
+  jobs.Reserve(static_cast<ezUInt32>(fNumTiles));
+
+  for (ezInt32 y = iMinY; y <= iMaxY; ++y)
+  {
+    for (ezInt32 x = iMinX; x <= iMaxX; ++x)
+    {
+      TileJob& job = jobs.ExpandAndGetRef();
+      job.m_Result.m_iTileX = x;
+      job.m_Result.m_iTileY = y;
+    }
+  }
 
-  if (!pg.BeginNextStep("Build NavMesh"))
+  if (!pg.BeginNextStep("Build Tiles"))
     return EZ_FAILURE;
 
-  if (BuildDetourNavMeshData(config, *out_NavMeshDesc.m_pNavMeshPolygons, out_NavMeshDesc.m_DetourNavmeshData).Failed())
+  if (!m_Vertices.IsEmpty())
+  {
+    PrepareTileJobs(config, grid, jobs);
+
+    EZ_SUCCEED_OR_RETURN(BuildTileJobs(config, grid, jobs, progress));
+  }
+
+  for (TileJob& job : jobs)
+  {
+    out_Tiles.PushBack(std::move(job.m_Result));
+  }
+
+  return EZ_SUCCESS;
+}
+
+ezResult ezRecastNavMeshBuilder::BuildFromTriangleMesh(
+  const ezRecastConfig& config, ezRecastNavMeshResourceDescriptor& out_NavMeshDesc, ezProgress& progress, ezRecastNavMeshResourceDescriptor* pPreviousBuild)
+{
+  if (m_Vertices.IsEmpty())
+  {
+    ezLog::Debug("Navmesh is empty");
+    return EZ_SUCCESS;
+  }
+
+  ComputeBoundingBox();
+
+  rcConfig cfg;
+  FillOutConfig(cfg, config, m_BoundingBox);
+
+  TileGrid grid;
+  grid.m_vOrigin = m_BoundingBox.m_vMin;
+  grid.m_iTileCells = config.m_fTileSize > 0.0f ? ezMath::Max(16, (ezInt32)(config.m_fTileSize / config.m_fCellSize)) : ezMath::Max(cfg.width, cfg.height);
+  grid.m_fTileWorldSize = grid.m_iTileCells * config.m_fCellSize;
+
+  const ezInt32 iNumTilesX = ezMath::Max(1, (cfg.width + grid.m_iTileCells - 1) / grid.m_iTileCells);
+  const ezInt32 iNumTilesY = ezMath::Max(1, (cfg.height + grid.m_iTileCells - 1) / grid.m_iTileCells);
+  const ezUInt32 uiNumTiles = static_cast<ezUInt32>(iNumTilesX * iNumTilesY);
+
+  // Detour uses 22 bits of a polygon reference for the tile and polygon index
+  const ezUInt32 uiTileBits = ezMath::Log2i(ezMath::PowerOfTwo_Ceil(uiNumTiles));
+  if (uiTileBits > 14)
+  {
+    ezLog::Error("The navmesh would consist of {} tiles, which is more than Detour supports. Increase the tile size.", uiNumTiles);
     return EZ_FAILURE;
+  }
+
+  out_NavMeshDesc.m_vTileGridOrigin = grid.m_vOrigin;
+  out_NavMeshDesc.m_fTileWorldSize = grid.m_fTileWorldSize;
+  out_NavMeshDesc.m_uiMaxTiles = 1u << uiTileBits;
+  out_NavMeshDesc.m_uiMaxPolysPerTile = 1u << (22 - uiTileBits);
+
+  ezDynamicArray<TileJob> jobs;
+  jobs.Reserve(uiNumTiles);
+
+  for (ezInt32 y = 0; y < iNumTilesY; ++y)
+  {
+    for (ezInt32 x = 0; x < iNumTilesX; ++x)
+    {
+      TileJob& job = jobs.ExpandAndGetRef();
+      job.m_Result.m_iTileX = x;
+      job.m_Result.m_iTileY = y;
+    }
+  }
+
+  PrepareTileJobs(config, grid, jobs);
+
+  if (pPreviousBuild != nullptr)
+  {
+    ezHashTable<ezUInt64, ezUInt32> previousTiles;
+    for (ezUInt32 i = 0; i < pPreviousBuild->m_Tiles.GetCount(); ++i)
+    {
+      previousTiles.Insert(GetTileKey(pPreviousBuild->m_Tiles[i].m_iTileX, pPreviousBuild->m_Tiles[i].m_iTileY), i);
+    }
+
+    for (TileJob& job : jobs)
+    {
+      ezUInt32 uiPrevIdx = 0;
+      if (!previousTiles.TryGetValue(GetTileKey(job.m_Result.m_iTileX, job.m_Result.m_iTileY), uiPrevIdx))
+        continue;
+
+      // the hash includes the tile grid and the configuration, so a match means the tile would come out identical
+      ezRecastNavMeshTile& prevTile = pPreviousBuild->m_Tiles[uiPrevIdx];
+      if (prevTile.m_uiInputHash == job.m_Result.m_uiInputHash)
+      {
+        job.m_Result = std::move(prevTile);
+        job.m_bNeedsBuild = false;
+      }
+    }
+  }
+
+  EZ_SUCCEED_OR_RETURN(BuildTileJobs(config, grid, jobs, progress));
+
+  for (TileJob& job : jobs)
+  {
+    if (!job.m_Result.m_DetourTileData.IsEmpty())
+    {
+      out_NavMeshDesc.m_Tiles.PushBack(std::move(job.m_Result));
+    }
+  }
+
+  ezLog::Debug("Generated {} of {} navmesh tiles, {} tiles are not empty", m_uiNumTilesGenerated, uiNumTiles, out_NavMeshDesc.m_Tiles.GetCount());
 
   return EZ_SUCCESS;
 }
@@ -138,7 +338,6 @@ void ezRecastNavMeshBuilder::GenerateTriangleMeshFromDescription(const ezWorldGe
   EZ_LOG_BLOCK("ezRecastNavMeshBuilder::GenerateTriangleMesh");
 
   m_Triangles.Clear();
-  m_TriangleAreaIDs.Clear();
   m_Vertices.Clear();
 
   ezUInt32 uiVertexOffset = 0;
@@ -151,10 +350,10 @@ void ezRecastNavMeshBuilder::GenerateTriangleMeshFromDescription(const ezWorldGe
     }
 
     const auto& meshBufferDesc = pCpuMesh->GetDescriptor().MeshBufferDesc();
+    const ezUInt32 uiNumPrimitives = pCpuMesh->GetDescriptor().GetNumPrimitivesOfFirstLod(); // ignore the triangles of the coarser LODs
 
-    const ezVec3* pPositions = nullptr;
-    ezUInt32 uiElementStride = 0;
-    if (ezMeshBufferUtils::GetPositionStream(meshBufferDesc, pPositions, uiElementStride).Failed())
+    ezDynamicArray<ezVec3> positions;
+    if (ezMeshBufferUtils::DecodePositions(meshBufferDesc, positions).Failed())
     {
       continue;
     }
@@ -170,13 +369,11 @@ void ezRecastNavMeshBuilder::GenerateTriangleMeshFromDescription(const ezWorldGe
     transform = transform * object.m_GlobalTransform.GetAsMat4();
 
     // collect all vertices
-    for (ezUInt32 i = 0; i < meshBufferDesc.GetVertexCount(); ++i)
+    for (const ezVec3& vPosition : positions)
     {
-      ezVec3 pos = transform.TransformPosition(*pPositions);
+      ezVec3 pos = transform.TransformPosition(vPosition);
 
       m_Vertices.PushBack(pos);
-
-      pPositions = ezMemoryUtils::AddByteOffset(pPositions, uiElementStride);
     }
 
     // collect all indices
@@ -185,7 +382,7 @@ void ezRecastNavMeshBuilder::GenerateTriangleMeshFromDescription(const ezWorldGe
     {
       const ezUInt32* pTypedIndices = reinterpret_cast<const ezUInt32*>(meshBufferDesc.GetIndexBufferData().GetPtr());
 
-      for (ezUInt32 p = 0; p < meshBufferDesc.GetPrimitiveCount(); ++p)
+      for (ezUInt32 p = 0; p < uiNumPrimitives; ++p)
       {
         auto& triangle = m_Triangles.ExpandAndGetRef();
         triangle.m_VertexIdx[0] = pTypedIndices[p * 3 + (flip ? 2 : 0)] + uiVertexOffset;
@@ -197,7 +394,7 @@ void ezRecastNavMeshBuilder::GenerateTriangleMeshFromDescription(const ezWorldGe
     {
       const ezUInt16* pTypedIndices = reinterpret_cast<const ezUInt16*>(meshBufferDesc.GetIndexBufferData().GetPtr());
 
-      for (ezUInt32 p = 0; p < meshBufferDesc.GetPrimitiveCount(); ++p)
+      for (ezUInt32 p = 0; p < uiNumPrimitives; ++p)
       {
         auto& triangle = m_Triangles.ExpandAndGetRef();
         triangle.m_VertexIdx[0] = pTypedIndices[p * 3 + (flip ? 2 : 0)] + uiVertexOffset;
@@ -209,12 +406,25 @@ void ezRecastNavMeshBuilder::GenerateTriangleMeshFromDescription(const ezWorldGe
     uiVertexOffset += meshBufferDesc.GetVertexCount();
   }
 
-  // initialize the IDs to zero
-  m_TriangleAreaIDs.SetCount(m_Triangles.GetCount());
-
   ezLog::Debug("Vertices: {0}, Triangles: {1}", m_Vertices.GetCount(), m_Triangles.GetCount());
 }
 
+void ezRecastNavMeshBuilder::GenerateTriangleMeshFromArrays(ezArrayPtr<const ezVec3> vertices, ezArrayPtr<const ezUInt32> indices)
+{
+  m_Vertices.SetCountUninitialized(vertices.GetCount());
+  m_Triangles.SetCount(indices.GetCount() / 3);
+
+  // convert from ez convention (Z up) to recast convention (Y up), which mirrors the geometry, so the winding order has to be flipped as well
+  for (ezUInt32 i = 0; i < vertices.GetCount(); ++i)
+  {
+    m_Vertices[i].Set(vertices[i].x, vertices[i].z, vertices[i].y);
+  }
+
+  for (ezUInt32 i = 0; i < m_Triangles.GetCount(); ++i)
+  {
+    m_Triangles[i] = Triangle(indices[i * 3 + 2], indices[i * 3 + 1], indices[i * 3 + 0]);
+  }
+}
 
 void ezRecastNavMeshBuilder::ComputeBoundingBox()
 {
@@ -250,41 +460,218 @@ void ezRecastNavMeshBuilder::FillOutConfig(rcConfig& cfg, const ezRecastConfig&
   rcCalcGridSize(cfg.bmin, cfg.bmax, cfg.cs, &cfg.width, &cfg.height);
 }
 
-ezResult ezRecastNavMeshBuilder::BuildRecastPolyMesh(const ezRecastConfig& config, rcPolyMesh& out_PolyMesh, ezProgress& progress)
+void ezRecastNavMeshBuilder::PrepareTileJobs(const ezRecastConfig& config, const TileGrid& grid, ezDynamicArray<TileJob>& inout_Jobs) const
 {
-  ezProgressRange pgRange("Build Poly Mesh", 13, true, &progress);
+  EZ_PROFILE_SCOPE("PrepareTileJobs");
+
+  ezHashTable<ezUInt64, ezUInt32> jobLookup;
+  jobLookup.Reserve(inout_Jobs.GetCount());
+
+  for (ezUInt32 i = 0; i < inout_Jobs.GetCount(); ++i)
+  {
+    jobLookup.Insert(GetTileKey(inout_Jobs[i].m_Result.m_iTileX, inout_Jobs[i].m_Result.m_iTileY), i);
+  }
+
+  // sort all triangles into the tiles that they overlap, including the border region of each tile
+  const float fBorder = GetBorderCells(config) * config.m_fCellSize;
+  const float fInvTileSize = 1.0f / grid.m_fTileWorldSize;
+
+  for (ezUInt32 t = 0; t < m_Triangles.GetCount(); ++t)
+  {
+    const ezVec3& v0 = m_Vertices[m_Triangles[t].m_VertexIdx[0]];
+    const ezVec3& v1 = m_Vertices[m_Triangles[t].m_VertexIdx[1]];
+    const ezVec3& v2 = m_Vertices[m_Triangles[t].m_VertexIdx[2]];
+
+    const float fMinX = ezMath::Min(v0.x, v1.x, v2.x) - fBorder - grid.m_vOrigin.x;
+    const float fMaxX = ezMath::Max(v0.x, v1.x, v2.x) + fBorder - grid.m_vOrigin.x;
+    const float fMinZ = ezMath::Min(v0.z, v1.z, v2.z) - fBorder - grid.m_vOrigin.z;
+    const float fMaxZ = ezMath::Max(v0.z, v1.z, v2.z) + fBorder - grid.m_vOrigin.z;
+
+    const ezInt32 iMinX = (ezInt32)ezMath::Floor(fMinX * fInvTileSize);
+    const ezInt32 iMaxX = (ezInt32)ezMath::Floor(fMaxX * fInvTileSize);
+    const ezInt32 iMinY = (ezInt32)ezMath::Floor(fMinZ * fInvTileSize);
+    const ezInt32 iMaxY = (ezInt32)ezMath::Floor(fMaxZ * fInvTileSize);
+
+    for (ezInt32 y = iMinY; y <= iMaxY; ++y)
+    {
+      for (ezInt32 x = iMinX; x <= iMaxX; ++x)
+      {
+        ezUInt32 uiJobIdx = 0;
+        if (jobLookup.TryGetValue(GetTileKey(x, y), uiJobIdx))
+        {
+          inout_Jobs[uiJobIdx].m_Triangles.PushBack(t);
+        }
+      }
+    }
+  }
+
+  // hash everything that influences the result of a tile, so that unchanged tiles can be detected
+  EZ_CHECK_AT_COMPILETIME_MSG(sizeof(ezRecastConfig) == sizeof(float) * 13, "ezRecastConfig has changed, make sure it can still be hashed as a whole");
+  ezUInt64 uiBaseHash = ezHashingUtils::xxHash64(&config, sizeof(ezRecastConfig));
+  uiBaseHash = ezHashingUtils::xxHash64(&grid.m_vOrigin, sizeof(ezVec3), uiBaseHash);
+  uiBaseHash = ezHashingUtils::xxHash64(&grid.m_fTileWorldSize, sizeof(float), uiBaseHash);
+
+  for (TileJob& job : inout_Jobs)
+  {
+    ezUInt64 uiHash = uiBaseHash;
+    uiHash = ezHashingUtils::xxHash64(&job.m_Result.m_iTileX, sizeof(ezInt32), uiHash);
+    uiHash = ezHashingUtils::xxHash64(&job.m_Result.m_iTileY, sizeof(ezInt32), uiHash);
+
+    for (ezInt32 t : job.m_Triangles)
+    {
+      for (ezUInt32 v = 0; v < 3; ++v)
+      {
+        uiHash = ezHashingUtils::xxHash64(&m_Vertices[m_Triangles[t].m_VertexIdx[v]], sizeof(ezVec3), uiHash);
+      }
+    }
+
+    job.m_Result.m_uiInputHash = uiHash;
+  }
+}
+
+ezResult ezRecastNavMeshBuilder::BuildTileJobs(const ezRecastConfig& config, const TileGrid& grid, ezDynamicArray<TileJob>& inout_Jobs, ezProgress& progress)
+{
+  ezDynamicArray<ezUInt32> jobsToBuild;
+
+  for (ezUInt32 i = 0; i < inout_Jobs.GetCount(); ++i)
+  {
+    if (inout_Jobs[i].m_bNeedsBuild && !inout_Jobs[i].m_Triangles.IsEmpty())
+    {
+      jobsToBuild.PushBack(i);
+    }
+  }
+
+  m_uiNumTilesGenerated = jobsToBuild.GetCount();
+
+  if (jobsToBuild.IsEmpty())
+    return EZ_SUCCESS;
+
+  ezProgressRange pg("Build Tiles", true, &progress);
+
+  m_iNumTilesFinished = 0;
+  m_bCancelBuild = false;
+  ezAtomicInteger32 iNumTilesFailed = 0;
+
+  ezSharedPtr<ezNavMeshTileTask> pTask = EZ_DEFAULT_NEW(ezNavMeshTileTask, [&](ezUInt32 uiInvocation) {
+    if (!m_bCancelBuild)
+    {
+      TileJob& job = inout_Jobs[jobsToBuild[uiInvocation]];
+
+      if (BuildTile(config, grid, job).Failed())
+      {
+        job.m_Result.m_DetourTileData.Clear();
+        job.m_Result.m_pPolygons.Clear();
+        iNumTilesFailed.Increment();
+      }
+    }
+
+    m_iNumTilesFinished.Increment();
+  });
+
+  pTask->SetMultiplicity(jobsToBuild.GetCount());
+  const ezTaskGroupID taskGroup = ezTaskSystem::StartSingleTask(pTask, ezTaskPriority::LongRunning);
+
+  const double fInvNumTiles = 1.0 / jobsToBuild.GetCount();
+  ezTaskSystem::WaitForCondition([&]() -> bool {
+    if (ezTaskSystem::IsTaskGroupFinished(taskGroup))
+      return true;
+
+    if (!m_bCancelBuild && !pg.SetCompletion(ezMath::Min(1.0, m_iNumTilesFinished * fInvNumTiles)))
+    {
+      // tiles that are already being built will finish, all others are skipped
+      m_bCancelBuild = true;
+    }
+
+    return false;
+  });
+
+  if (m_bCancelBuild)
+    return EZ_FAILURE;
+
+  if (iNumTilesFailed > 0)
+  {
+    ezLog::Error("{} navmesh tiles could not be built.", (ezInt32)iNumTilesFailed);
+    return EZ_FAILURE;
+  }
+
+  return EZ_SUCCESS;
+}
+
+ezResult ezRecastNavMeshBuilder::BuildTile(const ezRecastConfig& config, const TileGrid& grid, TileJob& job) const
+{
+  EZ_PROFILE_SCOPE("BuildTile");
+
+  const ezInt32 iTileX = job.m_Result.m_iTileX;
+  const ezInt32 iTileY = job.m_Result.m_iTileY;
 
   rcConfig cfg;
   FillOutConfig(cfg, config, m_BoundingBox);
 
-  ezRcBuildContext* pContext = m_pRecastContext;
+  cfg.tileSize = grid.m_iTileCells;
+  cfg.borderSize = GetBorderCells(config);
+  cfg.width = cfg.tileSize + cfg.borderSize * 2;
+  cfg.height = cfg.tileSize + cfg.borderSize * 2;
+
+  const float fBorder = cfg.borderSize * cfg.cs;
+
+  cfg.bmin[0] = grid.m_vOrigin.x + iTileX * grid.m_fTileWorldSize - fBorder;
+  cfg.bmin[2] = grid.m_vOrigin.z + iTileY * grid.m_fTileWorldSize - fBorder;
+  cfg.bmax[0] = grid.m_vOrigin.x + (iTileX + 1) * grid.m_fTileWorldSize + fBorder;
+  cfg.bmax[2] = grid.m_vOrigin.z + (iTileY + 1) * grid.m_fTileWorldSize + fBorder;
+
+  // all tiles must share the same vertical origin, otherwise their polygons can't be merged
+  cfg.bmin[1] = grid.m_vOrigin.y;
+  cfg.bmax[1] = ezMath::Max(cfg.bmax[1], cfg.bmin[1] + cfg.ch);
+
+  ezRcBuildContext context;
+
+  ezUniquePtr<rcPolyMesh> pPolyMesh = EZ_DEFAULT_NEW(rcPolyMesh);
+  EZ_SUCCEED_OR_RETURN(BuildRecastPolyMesh(cfg, &context, job.m_Triangles, *pPolyMesh));
+
+  if (pPolyMesh->npolys == 0)
+    return EZ_SUCCESS;
+
+  EZ_SUCCEED_OR_RETURN(BuildDetourNavMeshData(config, *pPolyMesh, iTileX, iTileY, job.m_Result.m_DetourTileData));
+
+  job.m_Result.m_pPolygons = std::move(pPolyMesh);
+  return EZ_SUCCESS;
+}
+
+ezResult ezRecastNavMeshBuilder::BuildRecastPolyMesh(
+  const rcConfig& cfg, ezRcBuildContext* pContext, ezArrayPtr<const ezInt32> triangles, rcPolyMesh& out_PolyMesh) const
+{
   const float* pVertices = &m_Vertices[0].x;
-  const ezInt32* pTriangles = &m_Triangles[0].m_VertexIdx[0];
+
+  // gather the triangles of this tile, all of them initially have area ID zero
+  ezDynamicArray<ezInt32> tileTriangles;
+  tileTriangles.SetCountUninitialized(triangles.GetCount() * 3);
+
+  for (ezUInt32 t = 0; t < triangles.GetCount(); ++t)
+  {
+    const Triangle& tri = m_Triangles[triangles[t]];
+    tileTriangles[t * 3 + 0] = tri.m_VertexIdx[0];
+    tileTriangles[t * 3 + 1] = tri.m_VertexIdx[1];
+    tileTriangles[t * 3 + 2] = tri.m_VertexIdx[2];
+  }
+
+  ezDynamicArray<ezUInt8> triangleAreaIDs;
+  triangleAreaIDs.SetCount(triangles.GetCount());
 
   rcHeightfield* heightfield = rcAllocHeightfield();
   EZ_SCOPE_EXIT(rcFreeHeightField(heightfield));
 
-  if (!pgRange.BeginNextStep("Creating Heightfield"))
-    return EZ_FAILURE;
-
   if (!rcCreateHeightfield(pContext, *heightfield, cfg.width, cfg.height, cfg.bmin, cfg.bmax, cfg.cs, cfg.ch))
   {
     pContext->log(RC_LOG_ERROR, "Could not create solid heightfield");
     return EZ_FAILURE;
   }
 
-  if (!pgRange.BeginNextStep("Mark Walkable Area"))
-    return EZ_FAILURE;
-
   // TODO Instead of this, it should use area IDs and then clear the non-walkable triangles
   rcMarkWalkableTriangles(
-    pContext, cfg.walkableSlopeAngle, pVertices, m_Vertices.GetCount(), pTriangles, m_Triangles.GetCount(), m_TriangleAreaIDs.GetData());
+    pContext, cfg.walkableSlopeAngle, pVertices, m_Vertices.GetCount(), tileTriangles.GetData(), triangles.GetCount(), triangleAreaIDs.GetData());
 
-  if (!pgRange.BeginNextStep("Rasterize Triangles"))
-    return EZ_FAILURE;
-
-  if (!rcRasterizeTriangles(
-        pContext, pVertices, m_Vertices.GetCount(), pTriangles, m_TriangleAreaIDs.GetData(), m_Triangles.GetCount(), *heightfield, cfg.walkableClimb))
+  if (!rcRasterizeTriangles(pContext, pVertices, m_Vertices.GetCount(), tileTriangles.GetData(), triangleAreaIDs.GetData(), triangles.GetCount(),
+        *heightfield, cfg.walkableClimb))
   {
     pContext->log(RC_LOG_ERROR, "Could not rasterize triangles");
     return EZ_FAILURE;
@@ -292,28 +679,16 @@ ezResult ezRecastNavMeshBuilder::BuildRecastPolyMesh(const ezRecastConfig& confi
 
   // Optional stuff
   {
-    if (!pgRange.BeginNextStep("Filter Low Hanging Obstacles"))
-      return EZ_FAILURE;
-
     // if (m_filterLowHangingObstacles)
     rcFilterLowHangingWalkableObstacles(pContext, cfg.walkableClimb, *heightfield);
 
-    if (!pgRange.BeginNextStep("Filter Ledge Spans"))
-      return EZ_FAILURE;
-
     // if (m_filterLedgeSpans)
     rcFilterLedgeSpans(pContext, cfg.walkableHeight, cfg.walkableClimb, *heightfield);
 
-    if (!pgRange.BeginNextStep("Filter Low Height Spans"))
-      return EZ_FAILURE;
-
     // if (m_filterWalkableLowHeightSpans)
     rcFilterWalkableLowHeightSpans(pContext, cfg.walkableHeight, *heightfield);
   }
 
-  if (!pgRange.BeginNextStep("Build Compact Heightfield"))
-    return EZ_FAILURE;
-
   rcCompactHeightfield* compactHeightfield = rcAllocCompactHeightfield();
   EZ_SCOPE_EXIT(rcFreeCompactHeightfield(compactHeightfield));
 
@@ -323,9 +698,6 @@ ezResult ezRecastNavMeshBuilder::BuildRecastPolyMesh(const ezRecastConfig& confi
     return EZ_FAILURE;
   }
 
-  if (!pgRange.BeginNextStep("Erode Walkable Area"))
-    return EZ_FAILURE;
-
   if (!rcErodeWalkableArea(pContext, cfg.walkableRadius, *compactHeightfield))
   {
     pContext->log(RC_LOG_ERROR, "Could not erode with character radius");
@@ -346,9 +718,6 @@ ezResult ezRecastNavMeshBuilder::BuildRecastPolyMesh(const ezRecastConfig& confi
   {
     // PARTITION_WATERSHED
     {
-      if (!pgRange.BeginNextStep("Build Distance Field"))
-        return EZ_FAILURE;
-
       // Prepare for region partitioning, by calculating distance field along the walkable surface.
       if (!rcBuildDistanceField(pContext, *compactHeightfield))
       {
@@ -356,11 +725,8 @@ ezResult ezRecastNavMeshBuilder::BuildRecastPolyMesh(const ezRecastConfig& confi
         return EZ_FAILURE;
       }
 
-      if (!pgRange.BeginNextStep("Build Regions"))
-        return EZ_FAILURE;
-
       // Partition the walkable surface into simple regions without holes.
-      if (!rcBuildRegions(pContext, *compactHeightfield, 0, cfg.minRegionArea, cfg.mergeRegionArea))
+      if (!rcBuildRegions(pContext, *compactHeightfield, cfg.borderSize, cfg.minRegionArea, cfg.mergeRegionArea))
       {
         pContext->log(RC_LOG_ERROR, "Could not build watershed regions.");
         return EZ_FAILURE;
@@ -371,7 +737,7 @@ ezResult ezRecastNavMeshBuilder::BuildRecastPolyMesh(const ezRecastConfig& confi
     //{
     //  // Partition the walkable surface into simple regions without holes.
     //  // Monotone partitioning does not need distance field.
-    //  if (!rcBuildRegionsMonotone(pContext, *compactHeightfield, 0, cfg.minRegionArea, cfg.mergeRegionArea))
+    //  if (!rcBuildRegionsMonotone(pContext, *compactHeightfield, cfg.borderSize, cfg.minRegionArea, cfg.mergeRegionArea))
     //  {
     //    pContext->log(RC_LOG_ERROR, "Could not build monotone regions.");
     //    return EZ_FAILURE;
@@ -381,7 +747,7 @@ ezResult ezRecastNavMeshBuilder::BuildRecastPolyMesh(const ezRecastConfig& confi
     //// PARTITION_LAYERS
     //{
     //  // Partition the walkable surface into simple regions without holes.
-    //  if (!rcBuildLayerRegions(pContext, *compactHeightfield, 0, cfg.minRegionArea))
+    //  if (!rcBuildLayerRegions(pContext, *compactHeightfield, cfg.borderSize, cfg.minRegionArea))
     //  {
     //    pContext->log(RC_LOG_ERROR, "Could not build layer regions.");
     //    return EZ_FAILURE;
@@ -389,9 +755,6 @@ ezResult ezRecastNavMeshBuilder::BuildRecastPolyMesh(const ezRecastConfig& confi
     //}
   }
 
-  if (!pgRange.BeginNextStep("Build Contours"))
-    return EZ_FAILURE;
-
   rcContourSet* contourSet = rcAllocContourSet();
   EZ_SCOPE_EXIT(rcFreeContourSet(contourSet));
 
@@ -401,8 +764,11 @@ ezResult ezRecastNavMeshBuilder::BuildRecastPolyMesh(const ezRecastConfig& confi
     return EZ_FAILURE;
   }
 
-  if (!pgRange.BeginNextStep("Build Poly Mesh"))
-    return EZ_FAILURE;
+  if (contourSet->nconts == 0)
+  {
+    // nothing walkable in this tile
+    return EZ_SUCCESS;
+  }
 
   if (!rcBuildPolyMesh(pContext, *contourSet, cfg.maxVertsPerPoly, out_PolyMesh))
   {
@@ -413,9 +779,6 @@ ezResult ezRecastNavMeshBuilder::BuildRecastPolyMesh(const ezRecastConfig& confi
   //////////////////////////////////////////////////////////////////////////
   // Detour Navmesh
 
-  if (!pgRange.BeginNextStep("Set Area Flags"))
-    return EZ_FAILURE;
-
   // TODO modify area IDs and flags
 
   for (int i = 0; i < out_PolyMesh.npolys; ++i)
@@ -429,7 +792,8 @@ ezResult ezRecastNavMeshBuilder::BuildRecastPolyMesh(const ezRecastConfig& confi
   return EZ_SUCCESS;
 }
 
-ezResult ezRecastNavMeshBuilder::BuildDetourNavMeshData(const ezRecastConfig& config, const rcPolyMesh& polyMesh, ezDataBuffer& NavmeshData)
+ezResult ezRecastNavMeshBuilder::BuildDetourNavMeshData(
+  const ezRecastConfig& config, const rcPolyMesh& polyMesh, ezInt32 iTileX, ezInt32 iTileY, ezDataBuffer& NavmeshData)
 {
   dtNavMeshCreateParams params;
   ezMemoryUtils::ZeroFill(&params, 1);
@@ -444,6 +808,9 @@ ezResult ezRecastNavMeshBuilder::BuildDetourNavMeshData(const ezRecastConfig& co
   params.walkableHeight = config.m_fAgentHeight;
   params.walkableRadius = config.m_fAgentRadius;
   params.walkableClimb = config.m_fAgentClimbHeight;
+  params.tileX = iTileX;
+  params.tileY = iTileY;
+  params.tileLayer = 0;
   rcVcopy(params.bmin, polyMesh.bmin);
   rcVcopy(params.bmax, polyMesh.bmax);
   params.cs = config.m_fCellSize;
@@ -455,7 +822,7 @@ ezResult ezRecastNavMeshBuilder::BuildDetourNavMeshData(const ezRecastConfig& co
 
   if (!dtCreateNavMeshData(&params, &navData, &navDataSize))
   {
-    ezLog::Error("Could not build Detour navmesh.");
+    ezLog::Error("Could not build Detour navmesh tile ({}, {}).", iTileX, iTileY);
     return EZ_FAILURE;
   }
 
@@ -468,7 +835,7 @@ ezResult ezRecastNavMeshBuilder::BuildDetourNavMeshData(const ezRecastConfig& co
 
 ezResult ezRecastConfig::Serialize(ezStreamWriter& stream) const
 {
-  stream.WriteVersion(1);
+  stream.WriteVersion(2);
 
   stream << m_fAgentHeight;
   stream << m_fAgentRadius;
@@ -482,13 +849,14 @@ ezResult ezRecastConfig::Serialize(ezStreamWriter& stream) const
   stream << m_fRegionMergeSize;
   stream << m_fDetailMeshSampleDistanceFactor;
   stream << m_fDetailMeshSampleErrorFactor;
+  stream << m_fTileSize;
 
   return EZ_SUCCESS;
 }
 
 ezResult ezRecastConfig::Deserialize(ezStreamReader& stream)
 {
-  stream.ReadVersion(1);
+  const ezTypeVersion version = stream.ReadVersion(2);
 
   stream >> m_fAgentHeight;
   stream >> m_fAgentRadius;
@@ -503,5 +871,10 @@ ezResult ezRecastConfig::Deserialize(ezStreamReader& stream)
   stream >> m_fDetailMeshSampleDistanceFactor;
   stream >> m_fDetailMeshSampleErrorFactor;
 
+  if (version >= 2)
+  {
+    stream >> m_fTileSize;
+  }
+
   return EZ_SUCCESS;
 }
@@ -1,16 +1,19 @@
 #pragma once
 
 #include <Foundation/Reflection/Reflection.h>
+#include <Foundation/Threading/AtomicInteger.h>
 #include <Foundation/Types/UniquePtr.h>
 #include <RecastPlugin/RecastPluginDLL.h>
 #include <RendererCore/Utils/WorldGeoExtractionUtil.h>
 
 class ezRcBuildContext;
+struct rcConfig;
 struct rcPolyMesh;
 struct rcPolyMeshDetail;
 class ezWorld;
 class dtNavMesh;
 struct ezRecastNavMeshResourceDescriptor;
+struct ezRecastNavMeshTile;
 class ezProgress;
 class ezStreamWriter;
 class ezStreamReader;
@@ -30,6 +33,9 @@ struct EZ_RECASTPLUGIN_DLL ezRecastConfig
   float m_fDetailMeshSampleDistanceFactor = 1.0f;
   float m_fDetailMeshSampleErrorFactor = 1.0f;
 
+  /// \brief The world space size of a navmesh tile. Zero or negative values build the entire navmesh as a single tile.
+  float m_fTileSize = 32.0f;
+
   ezResult Serialize(ezStreamWriter& stream) const;
   ezResult Deserialize(ezStreamReader& stream);
 };
@@ -37,7 +43,10 @@ struct EZ_RECASTPLUGIN_DLL ezRecastConfig
 EZ_DECLARE_REFLECTABLE_TYPE(EZ_RECASTPLUGIN_DLL, ezRecastConfig);
 
 
-
+/// \brief Generates tiled Detour navmeshes from world geometry.
+///
+/// The navmesh is split into a grid of square tiles (see ezRecastConfig::m_fTileSize), which are generated in parallel on the
+/// task system. Every tile stores a hash of its input, which allows to only regenerate tiles whose geometry actually changed.
 class EZ_RECASTPLUGIN_DLL ezRecastNavMeshBuilder
 {
 public:
@@ -46,17 +55,52 @@ public:
 
   static ezResult ExtractWorldGeometry(const ezWorld& world, ezWorldGeoExtractionUtil::MeshObjectList& out_worldGeo);
 
+  /// \brief Builds a complete navmesh for the given geometry.
+  ///
+  /// If \a pPreviousBuild is given, all tiles whose input (geometry and configuration) has not changed are moved out of it,
+  /// instead of being generated again.
   ezResult Build(const ezRecastConfig& config, const ezWorldGeoExtractionUtil::MeshObjectList& worldGeo, ezRecastNavMeshResourceDescriptor& out_NavMeshDesc,
-    ezProgress& progress);
+    ezProgress& progress, ezRecastNavMeshResourceDescriptor* pPreviousBuild = nullptr);
+
+  /// \brief Same as the other Build() overload, but takes an already triangulated mesh (ez convention, Z up) as input.
+  ezResult Build(const ezRecastConfig& config, ezArrayPtr<const ezVec3> vertices, ezArrayPtr<const ezUInt32> indices,
+    ezRecastNavMeshResourceDescriptor& out_NavMeshDesc, ezProgress& progress, ezRecastNavMeshResourceDescriptor* pPreviousBuild = nullptr);
+
+  /// \brief Regenerates all tiles of an existing navmesh that overlap \a changedArea (in world space).
+  ///
+  /// The tile grid of \a navMesh is kept. All affected tiles are written to \a out_Tiles, including tiles that became empty,
+  /// such that the result can be passed directly to ezRecastNavMeshResource::ReplaceTiles().
+  /// Fails if the area covers more tiles than the navmesh supports (ezRecastNavMeshResourceDescriptor::m_uiMaxTiles).
+  ezResult RebuildTiles(const ezRecastConfig& config, const ezWorldGeoExtractionUtil::MeshObjectList& worldGeo, const ezBoundingBox& changedArea,
+    const ezRecastNavMeshResourceDescriptor& navMesh, ezDynamicArray<ezRecastNavMeshTile>& out_Tiles, ezProgress& progress);
+
+  /// \brief Returns how many tiles were actually generated by the last build. The rest was reused from the previous build.
+  ezUInt32 GetNumTilesGenerated() const { return m_uiNumTilesGenerated; }
 
 private:
-  static void FillOutConfig(struct rcConfig& cfg, const ezRecastConfig& config, const ezBoundingBox& bbox);
+  struct TileGrid
+  {
+    ezVec3 m_vOrigin;
+    float m_fTileWorldSize = 0.0f;
+    ezInt32 m_iTileCells = 0;
+  };
+
+  struct TileJob;
+
+  static void FillOutConfig(rcConfig& cfg, const ezRecastConfig& config, const ezBoundingBox& bbox);
 
   void Clear();
   void GenerateTriangleMeshFromDescription(const ezWorldGeoExtractionUtil::MeshObjectList& objects);
+  void GenerateTriangleMeshFromArrays(ezArrayPtr<const ezVec3> vertices, ezArrayPtr<const ezUInt32> indices);
   void ComputeBoundingBox();
-  ezResult BuildRecastPolyMesh(const ezRecastConfig& config, rcPolyMesh& out_PolyMesh, ezProgress& progress);
-  static ezResult BuildDetourNavMeshData(const ezRecastConfig& config, const rcPolyMesh& polyMesh, ezDataBuffer& NavmeshData);
+  ezResult BuildFromTriangleMesh(const ezRecastConfig& config, ezRecastNavMeshResourceDescriptor& out_NavMeshDesc, ezProgress& progress,
+    ezRecastNavMeshResourceDescriptor* pPreviousBuild);
+  void PrepareTileJobs(const ezRecastConfig& config, const TileGrid& grid, ezDynamicArray<TileJob>& inout_Jobs) const;
+  ezResult BuildTileJobs(const ezRecastConfig& config, const TileGrid& grid, ezDynamicArray<TileJob>& inout_Jobs, ezProgress& progress);
+  ezResult BuildTile(const ezRecastConfig& config, const TileGrid& grid, TileJob& job) const;
+  ezResult BuildRecastPolyMesh(const rcConfig& cfg, ezRcBuildContext* pContext, ezArrayPtr<const ezInt32> triangles, rcPolyMesh& out_PolyMesh) const;
+  static ezResult BuildDetourNavMeshData(
+    const ezRecastConfig& config, const rcPolyMesh& polyMesh, ezInt32 iTileX, ezInt32 iTileY, ezDataBuffer& NavmeshData);
 
   struct Triangle
   {
@@ -74,6 +118,7 @@ private:
   ezBoundingBox m_BoundingBox;
   ezDynamicArray<ezVec3> m_Vertices;
   ezDynamicArray<Triangle> m_Triangles;
-  ezDynamicArray<ezUInt8> m_TriangleAreaIDs;
-  ezRcBuildContext* m_pRecastContext = nullptr;
+  ezUInt32 m_uiNumTilesGenerated = 0;
+  ezAtomicInteger32 m_iNumTilesFinished;
+  ezAtomicBool m_bCancelBuild;
 };
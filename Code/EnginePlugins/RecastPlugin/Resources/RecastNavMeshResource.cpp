@@ -2,6 +2,7 @@
 
 #include <Core/Assets/AssetFileHeader.h>
 #include <Foundation/IO/ChunkStream.h>
+#include <Recast/DetourAlloc.h>
 #include <Recast/DetourNavMesh.h>
 #include <Recast/Recast.h>
 #include <Recast/RecastAlloc.h>
@@ -16,6 +17,132 @@ EZ_RESOURCE_IMPLEMENT_COMMON_CODE(ezRecastNavMeshResource);
 
 //////////////////////////////////////////////////////////////////////////
 
+static ezResult WritePolyMesh(ezStreamWriter& stream, const rcPolyMesh& mesh)
+{
+  EZ_CHECK_AT_COMPILETIME_MSG(sizeof(rcPolyMesh) == sizeof(void*) * 5 + sizeof(int) * 14, "rcPolyMesh data structure has changed");
+
+  stream << (int)mesh.nverts;
+  stream << (int)mesh.npolys;
+  stream << (int)mesh.npolys; // do not use mesh.maxpolys
+  stream << (int)mesh.nvp;
+  stream << (float)mesh.bmin[0];
+  stream << (float)mesh.bmin[1];
+  stream << (float)mesh.bmin[2];
+  stream << (float)mesh.bmax[0];
+  stream << (float)mesh.bmax[1];
+  stream << (float)mesh.bmax[2];
+  stream << (float)mesh.cs;
+  stream << (float)mesh.ch;
+  stream << (int)mesh.borderSize;
+  stream << (float)mesh.maxEdgeError;
+
+  EZ_ASSERT_DEBUG(mesh.maxpolys >= mesh.npolys, "Invalid navmesh polygon count");
+
+  EZ_SUCCEED_OR_RETURN(stream.WriteBytes(mesh.verts, sizeof(ezUInt16) * mesh.nverts * 3));
+  EZ_SUCCEED_OR_RETURN(stream.WriteBytes(mesh.polys, sizeof(ezUInt16) * mesh.npolys * mesh.nvp * 2));
+  EZ_SUCCEED_OR_RETURN(stream.WriteBytes(mesh.regs, sizeof(ezUInt16) * mesh.npolys));
+  EZ_SUCCEED_OR_RETURN(stream.WriteBytes(mesh.flags, sizeof(ezUInt16) * mesh.npolys));
+  EZ_SUCCEED_OR_RETURN(stream.WriteBytes(mesh.areas, sizeof(ezUInt8) * mesh.npolys));
+
+  return EZ_SUCCESS;
+}
+
+static ezResult ReadPolyMesh(ezStreamReader& stream, rcPolyMesh& mesh)
+{
+  EZ_CHECK_AT_COMPILETIME_MSG(sizeof(rcPolyMesh) == sizeof(void*) * 5 + sizeof(int) * 14, "rcPolyMesh data structure has changed");
+
+  stream >> mesh.nverts;
+  stream >> mesh.npolys;
+  stream >> mesh.maxpolys;
+  stream >> mesh.nvp;
+  stream >> mesh.bmin[0];
+  stream >> mesh.bmin[1];
+  stream >> mesh.bmin[2];
+  stream >> mesh.bmax[0];
+  stream >> mesh.bmax[1];
+  stream >> mesh.bmax[2];
+  stream >> mesh.cs;
+  stream >> mesh.ch;
+  stream >> mesh.borderSize;
+  stream >> mesh.maxEdgeError;
+
+  EZ_ASSERT_DEBUG(mesh.maxpolys >= mesh.npolys, "Invalid navmesh polygon count");
+
+  mesh.verts = (ezUInt16*)rcAlloc(sizeof(ezUInt16) * mesh.nverts * 3, RC_ALLOC_PERM);
+  mesh.polys = (ezUInt16*)rcAlloc(sizeof(ezUInt16) * mesh.maxpolys * mesh.nvp * 2, RC_ALLOC_PERM);
+  mesh.regs = (ezUInt16*)rcAlloc(sizeof(ezUInt16) * mesh.maxpolys, RC_ALLOC_PERM);
+  mesh.flags = (ezUInt16*)rcAlloc(sizeof(ezUInt16) * mesh.maxpolys, RC_ALLOC_PERM);
+  mesh.areas = (ezUInt8*)rcAlloc(sizeof(ezUInt8) * mesh.maxpolys, RC_ALLOC_PERM);
+
+  stream.ReadBytes(mesh.verts, sizeof(ezUInt16) * mesh.nverts * 3);
+  stream.ReadBytes(mesh.polys, sizeof(ezUInt16) * mesh.maxpolys * mesh.nvp * 2);
+  stream.ReadBytes(mesh.regs, sizeof(ezUInt16) * mesh.maxpolys);
+  stream.ReadBytes(mesh.flags, sizeof(ezUInt16) * mesh.maxpolys);
+  stream.ReadBytes(mesh.areas, sizeof(ezUInt8) * mesh.maxpolys);
+
+  return EZ_SUCCESS;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+ezRecastNavMeshTile::ezRecastNavMeshTile() = default;
+ezRecastNavMeshTile::ezRecastNavMeshTile(ezRecastNavMeshTile&& rhs)
+{
+  *this = std::move(rhs);
+}
+
+ezRecastNavMeshTile::~ezRecastNavMeshTile() = default;
+
+void ezRecastNavMeshTile::operator=(ezRecastNavMeshTile&& rhs)
+{
+  m_iTileX = rhs.m_iTileX;
+  m_iTileY = rhs.m_iTileY;
+  m_uiInputHash = rhs.m_uiInputHash;
+  m_DetourTileData = std::move(rhs.m_DetourTileData);
+  m_pPolygons = std::move(rhs.m_pPolygons);
+}
+
+ezResult ezRecastNavMeshTile::Serialize(ezStreamWriter& stream) const
+{
+  stream << m_iTileX;
+  stream << m_iTileY;
+  stream << m_uiInputHash;
+  EZ_SUCCEED_OR_RETURN(stream.WriteArray(m_DetourTileData));
+
+  const bool hasPolygons = m_pPolygons != nullptr;
+  stream << hasPolygons;
+
+  if (hasPolygons)
+  {
+    EZ_SUCCEED_OR_RETURN(WritePolyMesh(stream, *m_pPolygons));
+  }
+
+  return EZ_SUCCESS;
+}
+
+ezResult ezRecastNavMeshTile::Deserialize(ezStreamReader& stream)
+{
+  stream >> m_iTileX;
+  stream >> m_iTileY;
+  stream >> m_uiInputHash;
+  EZ_SUCCEED_OR_RETURN(stream.ReadArray(m_DetourTileData));
+
+  bool hasPolygons = false;
+  stream >> hasPolygons;
+
+  m_pPolygons.Clear();
+
+  if (hasPolygons)
+  {
+    m_pPolygons = EZ_DEFAULT_NEW(rcPolyMesh);
+    EZ_SUCCEED_OR_RETURN(ReadPolyMesh(stream, *m_pPolygons));
+  }
+
+  return EZ_SUCCESS;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
 ezRecastNavMeshResourceDescriptor::ezRecastNavMeshResourceDescriptor() = default;
 ezRecastNavMeshResourceDescriptor::ezRecastNavMeshResourceDescriptor(ezRecastNavMeshResourceDescriptor&& rhs)
 {
@@ -29,56 +156,48 @@ ezRecastNavMeshResourceDescriptor::~ezRecastNavMeshResourceDescriptor()
 
 void ezRecastNavMeshResourceDescriptor::operator=(ezRecastNavMeshResourceDescriptor&& rhs)
 {
-  m_DetourNavmeshData = std::move(rhs.m_DetourNavmeshData);
+  m_vTileGridOrigin = rhs.m_vTileGridOrigin;
+  m_fTileWorldSize = rhs.m_fTileWorldSize;
+  m_uiMaxTiles = rhs.m_uiMaxTiles;
+  m_uiMaxPolysPerTile = rhs.m_uiMaxPolysPerTile;
+  m_Tiles = std::move(rhs.m_Tiles);
+}
 
-  m_pNavMeshPolygons = rhs.m_pNavMeshPolygons;
-  rhs.m_pNavMeshPolygons = nullptr;
+ezUInt32 ezRecastNavMeshResourceDescriptor::FindTile(ezInt32 iTileX, ezInt32 iTileY) const
+{
+  for (ezUInt32 i = 0; i < m_Tiles.GetCount(); ++i)
+  {
+    if (m_Tiles[i].m_iTileX == iTileX && m_Tiles[i].m_iTileY == iTileY)
+      return i;
+  }
+
+  return ezInvalidIndex;
 }
 
 void ezRecastNavMeshResourceDescriptor::Clear()
 {
-  m_DetourNavmeshData.Clear();
-  EZ_DEFAULT_DELETE(m_pNavMeshPolygons);
+  m_vTileGridOrigin.SetZero();
+  m_fTileWorldSize = 0.0f;
+  m_uiMaxTiles = 0;
+  m_uiMaxPolysPerTile = 0;
+  m_Tiles.Clear();
 }
 
 //////////////////////////////////////////////////////////////////////////
 
 ezResult ezRecastNavMeshResourceDescriptor::Serialize(ezStreamWriter& stream) const
 {
-  stream.WriteVersion(1);
-  EZ_SUCCEED_OR_RETURN(stream.WriteArray(m_DetourNavmeshData));
+  stream.WriteVersion(2);
 
-  const bool hasPolygons = m_pNavMeshPolygons != nullptr;
-  stream << hasPolygons;
+  stream << m_vTileGridOrigin;
+  stream << m_fTileWorldSize;
+  stream << m_uiMaxTiles;
+  stream << m_uiMaxPolysPerTile;
 
-  if (hasPolygons)
+  stream << m_Tiles.GetCount();
+  for (const auto& tile : m_Tiles)
   {
-    EZ_CHECK_AT_COMPILETIME_MSG(sizeof(rcPolyMesh) == sizeof(void*) * 5 + sizeof(int) * 14, "rcPolyMesh data structure has changed");
-
-    const auto& mesh = *m_pNavMeshPolygons;
-
-    stream << (int)mesh.nverts;
-    stream << (int)mesh.npolys;
-    stream << (int)mesh.npolys; // do not use mesh.maxpolys
-    stream << (int)mesh.nvp;
-    stream << (float)mesh.bmin[0];
-    stream << (float)mesh.bmin[1];
-    stream << (float)mesh.bmin[2];
-    stream << (float)mesh.bmax[0];
-    stream << (float)mesh.bmax[1];
-    stream << (float)mesh.bmax[2];
-    stream << (float)mesh.cs;
-    stream << (float)mesh.ch;
-    stream << (int)mesh.borderSize;
-    stream << (float)mesh.maxEdgeError;
-
-    EZ_ASSERT_DEBUG(mesh.maxpolys >= mesh.npolys, "Invalid navmesh polygon count");
-
-    EZ_SUCCEED_OR_RETURN(stream.WriteBytes(mesh.verts, sizeof(ezUInt16) * mesh.nverts * 3));
-    EZ_SUCCEED_OR_RETURN(stream.WriteBytes(mesh.polys, sizeof(ezUInt16) * mesh.npolys * mesh.nvp * 2));
-    EZ_SUCCEED_OR_RETURN(stream.WriteBytes(mesh.regs, sizeof(ezUInt16) * mesh.npolys));
-    EZ_SUCCEED_OR_RETURN(stream.WriteBytes(mesh.flags, sizeof(ezUInt16) * mesh.npolys));
-    EZ_SUCCEED_OR_RETURN(stream.WriteBytes(mesh.areas, sizeof(ezUInt8) * mesh.npolys));
+    EZ_SUCCEED_OR_RETURN(tile.Serialize(stream));
   }
 
   return EZ_SUCCESS;
@@ -88,47 +207,49 @@ ezResult ezRecastNavMeshResourceDescriptor::Deserialize(ezStreamReader& stream)
 {
   Clear();
 
-  const ezTypeVersion version = stream.ReadVersion(1);
-  EZ_SUCCEED_OR_RETURN(stream.ReadArray(m_DetourNavmeshData));
-
-  bool hasPolygons = false;
-  stream >> hasPolygons;
+  const ezTypeVersion version = stream.ReadVersion(2);
 
-  if (hasPolygons)
+  if (version == 1)
   {
-    EZ_CHECK_AT_COMPILETIME_MSG(sizeof(rcPolyMesh) == sizeof(void*) * 5 + sizeof(int) * 14, "rcPolyMesh data structure has changed");
-
-    m_pNavMeshPolygons = EZ_DEFAULT_NEW(rcPolyMesh);
-
-    auto& mesh = *m_pNavMeshPolygons;
-
-    stream >> mesh.nverts;
-    stream >> mesh.npolys;
-    stream >> mesh.maxpolys;
-    stream >> mesh.nvp;
-    stream >> mesh.bmin[0];
-    stream >> mesh.bmin[1];
-    stream >> mesh.bmin[2];
-    stream >> mesh.bmax[0];
-    stream >> mesh.bmax[1];
-    stream >> mesh.bmax[2];
-    stream >> mesh.cs;
-    stream >> mesh.ch;
-    stream >> mesh.borderSize;
-    stream >> mesh.maxEdgeError;
+    // version 1 stored a single, non-tiled navmesh, which is the same as a navmesh with exactly one tile
+    ezRecastNavMeshTile& tile = m_Tiles.ExpandAndGetRef();
+    EZ_SUCCEED_OR_RETURN(stream.ReadArray(tile.m_DetourTileData));
+
+    bool hasPolygons = false;
+    stream >> hasPolygons;
+
+    if (hasPolygons)
+    {
+      tile.m_pPolygons = EZ_DEFAULT_NEW(rcPolyMesh);
+      EZ_SUCCEED_OR_RETURN(ReadPolyMesh(stream, *tile.m_pPolygons));
+    }
+
+    if (tile.m_DetourTileData.GetCount() < sizeof(dtMeshHeader))
+    {
+      m_Tiles.Clear();
+      return EZ_SUCCESS;
+    }
+
+    const dtMeshHeader* pHeader = reinterpret_cast<const dtMeshHeader*>(tile.m_DetourTileData.GetData());
+    m_vTileGridOrigin.Set(pHeader->bmin[0], pHeader->bmin[1], pHeader->bmin[2]);
+    m_fTileWorldSize = ezMath::Max(pHeader->bmax[0] - pHeader->bmin[0], pHeader->bmax[2] - pHeader->bmin[2]);
+    m_uiMaxTiles = 1;
+    m_uiMaxPolysPerTile = pHeader->polyCount;
+    return EZ_SUCCESS;
+  }
 
-    EZ_ASSERT_DEBUG(mesh.maxpolys >= mesh.npolys, "Invalid navmesh polygon count");
+  stream >> m_vTileGridOrigin;
+  stream >> m_fTileWorldSize;
+  stream >> m_uiMaxTiles;
+  stream >> m_uiMaxPolysPerTile;
 
-    mesh.verts = (ezUInt16*)rcAlloc(sizeof(ezUInt16) * mesh.nverts * 3, RC_ALLOC_PERM);
-    mesh.polys = (ezUInt16*)rcAlloc(sizeof(ezUInt16) * mesh.maxpolys * mesh.nvp * 2, RC_ALLOC_PERM);
-    mesh.regs = (ezUInt16*)rcAlloc(sizeof(ezUInt16) * mesh.maxpolys, RC_ALLOC_PERM);
-    mesh.areas = (ezUInt8*)rcAlloc(sizeof(ezUInt8) * mesh.maxpolys, RC_ALLOC_PERM);
+  ezUInt32 uiNumTiles = 0;
+  stream >> uiNumTiles;
+  m_Tiles.SetCount(uiNumTiles);
 
-    stream.ReadBytes(mesh.verts, sizeof(ezUInt16) * mesh.nverts * 3);
-    stream.ReadBytes(mesh.polys, sizeof(ezUInt16) * mesh.maxpolys * mesh.nvp * 2);
-    stream.ReadBytes(mesh.regs, sizeof(ezUInt16) * mesh.maxpolys);
-    stream.ReadBytes(mesh.flags, sizeof(ezUInt16) * mesh.maxpolys);
-    stream.ReadBytes(mesh.areas, sizeof(ezUInt8) * mesh.maxpolys);
+  for (auto& tile : m_Tiles)
+  {
+    EZ_SUCCEED_OR_RETURN(tile.Deserialize(stream));
   }
 
   return EZ_SUCCESS;
@@ -155,9 +276,9 @@ ezResourceLoadDesc ezRecastNavMeshResource::UnloadData(Unload WhatToUnload)
   res.m_uiQualityLevelsLoadable = 0;
   res.m_State = ezResourceState::Unloaded;
 
-  m_DetourNavmeshData.Clear();
   EZ_DEFAULT_DELETE(m_pNavMesh);
   EZ_DEFAULT_DELETE(m_pNavMeshPolygons);
+  m_Descriptor.Clear();
 
   return res;
 }
@@ -194,7 +315,16 @@ ezResourceLoadDesc ezRecastNavMeshResource::UpdateContent(ezStreamReader* Stream
 void ezRecastNavMeshResource::UpdateMemoryUsage(MemoryUsage& out_NewMemoryUsage)
 {
   out_NewMemoryUsage.m_uiMemoryCPU = sizeof(ezRecastNavMeshResource);
-  out_NewMemoryUsage.m_uiMemoryCPU += m_DetourNavmeshData.GetHeapMemoryUsage();
+  out_NewMemoryUsage.m_uiMemoryCPU += m_Descriptor.m_Tiles.GetHeapMemoryUsage();
+
+  for (const auto& tile : m_Descriptor.m_Tiles)
+  {
+    // the navmesh holds its own copy of the tile data
+    out_NewMemoryUsage.m_uiMemoryCPU += tile.m_DetourTileData.GetHeapMemoryUsage();
+    out_NewMemoryUsage.m_uiMemoryCPU += m_pNavMesh != nullptr ? tile.m_DetourTileData.GetCount() : 0;
+    out_NewMemoryUsage.m_uiMemoryCPU += tile.m_pPolygons != nullptr ? sizeof(rcPolyMesh) : 0;
+  }
+
   out_NewMemoryUsage.m_uiMemoryCPU += m_pNavMesh != nullptr ? sizeof(dtNavMesh) : 0;
   out_NewMemoryUsage.m_uiMemoryCPU += m_pNavMeshPolygons != nullptr ? sizeof(rcPolyMesh) : 0;
   out_NewMemoryUsage.m_uiMemoryGPU = 0;
@@ -207,19 +337,143 @@ ezResourceLoadDesc ezRecastNavMeshResource::CreateResource(ezRecastNavMeshResour
   res.m_uiQualityLevelsLoadable = 0;
   res.m_State = ezResourceState::Loaded;
 
-  m_pNavMeshPolygons = descriptor.m_pNavMeshPolygons;
-  descriptor.m_pNavMeshPolygons = nullptr;
+  m_Descriptor = std::move(descriptor);
 
-  m_DetourNavmeshData = std::move(descriptor.m_DetourNavmeshData);
-
-  if (!m_DetourNavmeshData.IsEmpty())
+  if (!m_Descriptor.m_Tiles.IsEmpty())
   {
+    dtNavMeshParams params;
+    params.orig[0] = m_Descriptor.m_vTileGridOrigin.x;
+    params.orig[1] = m_Descriptor.m_vTileGridOrigin.y;
+    params.orig[2] = m_Descriptor.m_vTileGridOrigin.z;
+    params.tileWidth = m_Descriptor.m_fTileWorldSize;
+    params.tileHeight = m_Descriptor.m_fTileWorldSize;
+    params.maxTiles = m_Descriptor.m_uiMaxTiles;
+    params.maxPolys = m_Descriptor.m_uiMaxPolysPerTile;
+
     m_pNavMesh = EZ_DEFAULT_NEW(dtNavMesh);
 
-    // the dtNavMesh does not need to free the data, the resource owns it
-    const int dtMeshFlags = 0;
-    m_pNavMesh->init(m_DetourNavmeshData.GetData(), m_DetourNavmeshData.GetCount(), dtMeshFlags);
-  }
+    if (dtStatusFailed(m_pNavMesh->init(&params)))
+    {
+      ezLog::Error("Failed to initialize the Detour navmesh.");
+      EZ_DEFAULT_DELETE(m_pNavMesh);
+      return res;
+    }
+
+    for (const auto& tile : m_Descriptor.m_Tiles)
+    {
+      if (tile.m_DetourTileData.IsEmpty())
+        continue;
+
+      if (AddTileToNavMesh(tile).Failed())
+      {
+        ezLog::Error("Failed to add navmesh tile ({}, {}).", tile.m_iTileX, tile.m_iTileY);
+      }
+    }
+  }
+
+  MergeTilePolygons();
 
   return res;
 }
+
+ezResult ezRecastNavMeshResource::ReplaceTiles(ezArrayPtr<ezRecastNavMeshTile> tiles)
+{
+  if (m_pNavMesh == nullptr)
+  {
+    ezLog::Error("Can't replace tiles of a navmesh that is not loaded.");
+    return EZ_FAILURE;
+  }
+
+  if (tiles.GetCount() > m_Descriptor.m_uiMaxTiles)
+  {
+    ezLog::Error("Can't replace {} tiles, the navmesh supports at most {} tiles.", tiles.GetCount(), m_Descriptor.m_uiMaxTiles);
+    return EZ_FAILURE;
+  }
+
+  ezResult result = EZ_SUCCESS;
+
+  for (auto& newTile : tiles)
+  {
+    const ezUInt32 uiExisting = m_Descriptor.FindTile(newTile.m_iTileX, newTile.m_iTileY);
+
+    if (uiExisting != ezInvalidIndex)
+    {
+      const dtTileRef tileRef = m_pNavMesh->getTileRefAt(newTile.m_iTileX, newTile.m_iTileY, 0);
+
+      if (tileRef != 0)
+      {
+        // the navmesh frees its copy of the tile data
+        m_pNavMesh->removeTile(tileRef, nullptr, nullptr);
+      }
+
+      m_Descriptor.m_Tiles.RemoveAtAndSwap(uiExisting);
+    }
+
+    if (newTile.m_DetourTileData.IsEmpty())
+      continue;
+
+    if (m_Descriptor.m_Tiles.GetCount() >= m_Descriptor.m_uiMaxTiles)
+    {
+      ezLog::Error("Can't add navmesh tile ({}, {}), the navmesh already contains the maximum of {} tiles.", newTile.m_iTileX, newTile.m_iTileY, m_Descriptor.m_uiMaxTiles);
+      result = EZ_FAILURE;
+      continue;
+    }
+
+    if (AddTileToNavMesh(newTile).Failed())
+    {
+      ezLog::Error("Failed to add navmesh tile ({}, {}).", newTile.m_iTileX, newTile.m_iTileY);
+      result = EZ_FAILURE;
+      continue;
+    }
+
+    m_Descriptor.m_Tiles.PushBack(std::move(newTile));
+  }
+
+  MergeTilePolygons();
+  ++m_uiRevision;
+
+  return result;
+}
+
+ezResult ezRecastNavMeshResource::AddTileToNavMesh(const ezRecastNavMeshTile& tile)
+{
+  // The navmesh gets its own copy of the data and frees it when the tile is removed. Detour keeps pointers into the tile data,
+  // so sharing the buffer with the descriptor would break as soon as tiles are moved around in m_Descriptor.m_Tiles.
+  const ezUInt32 uiDataSize = tile.m_DetourTileData.GetCount();
+  ezUInt8* pData = static_cast<ezUInt8*>(dtAlloc(uiDataSize, DT_ALLOC_PERM));
+  ezMemoryUtils::Copy(pData, tile.m_DetourTileData.GetData(), uiDataSize);
+
+  if (dtStatusFailed(m_pNavMesh->addTile(pData, uiDataSize, DT_TILE_FREE_DATA, 0, nullptr)))
+  {
+    dtFree(pData);
+    return EZ_FAILURE;
+  }
+
+  return EZ_SUCCESS;
+}
+
+void ezRecastNavMeshResource::MergeTilePolygons()
+{
+  EZ_DEFAULT_DELETE(m_pNavMeshPolygons);
+
+  ezHybridArray<rcPolyMesh*, 64> polyMeshes;
+  for (auto& tile : m_Descriptor.m_Tiles)
+  {
+    if (tile.m_pPolygons != nullptr && tile.m_pPolygons->npolys > 0)
+    {
+      polyMeshes.PushBack(tile.m_pPolygons.Borrow());
+    }
+  }
+
+  if (polyMeshes.IsEmpty())
+    return;
+
+  m_pNavMeshPolygons = EZ_DEFAULT_NEW(rcPolyMesh);
+
+  rcContext ctxt(false);
+  if (!rcMergePolyMeshes(&ctxt, polyMeshes.GetData(), polyMeshes.GetCount(), *m_pNavMeshPolygons))
+  {
+    ezLog::Warning("Failed to merge the navmesh tile polygons, navmesh visualization will not be available.");
+    EZ_DEFAULT_DELETE(m_pNavMeshPolygons);
+  }
+}
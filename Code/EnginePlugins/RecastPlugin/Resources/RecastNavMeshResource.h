@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Core/ResourceManager/Resource.h>
+#include <Foundation/Types/UniquePtr.h>
 #include <RecastPlugin/RecastPluginDLL.h>
 
 struct rcPolyMesh;
@@ -8,6 +9,35 @@ class dtNavMesh;
 
 using ezRecastNavMeshResourceHandle = ezTypedResourceHandle<class ezRecastNavMeshResource>;
 
+/// \brief A single tile of a tiled Detour navmesh, as produced by ezRecastNavMeshBuilder.
+struct EZ_RECASTPLUGIN_DLL ezRecastNavMeshTile
+{
+  ezRecastNavMeshTile();
+  ezRecastNavMeshTile(const ezRecastNavMeshTile& rhs) = delete;
+  ezRecastNavMeshTile(ezRecastNavMeshTile&& rhs);
+  ~ezRecastNavMeshTile();
+  void operator=(ezRecastNavMeshTile&& rhs);
+  void operator=(const ezRecastNavMeshTile& rhs) = delete;
+
+  /// \brief The coordinate of the tile in the tile grid (Detour's x and y, which is ez's x and y as well).
+  ezInt32 m_iTileX = 0;
+  ezInt32 m_iTileY = 0;
+
+  /// \brief Hash of the input geometry and the build configuration that produced this tile.
+  ///
+  /// Used to skip rebuilding tiles whose input has not changed.
+  ezUInt64 m_uiInputHash = 0;
+
+  /// \brief Data that was created by dtCreateNavMeshData() and will be used for dtNavMesh::addTile()
+  ezDataBuffer m_DetourTileData;
+
+  /// \brief Optional, if available the tile can be visualized at runtime
+  ezUniquePtr<rcPolyMesh> m_pPolygons;
+
+  ezResult Serialize(ezStreamWriter& stream) const;
+  ezResult Deserialize(ezStreamReader& stream);
+};
+
 struct EZ_RECASTPLUGIN_DLL ezRecastNavMeshResourceDescriptor
 {
   ezRecastNavMeshResourceDescriptor();
@@ -17,11 +47,21 @@ struct EZ_RECASTPLUGIN_DLL ezRecastNavMeshResourceDescriptor
   void operator=(ezRecastNavMeshResourceDescriptor&& rhs);
   void operator=(const ezRecastNavMeshResourceDescriptor& rhs) = delete;
 
-  /// \brief Data that was created by dtCreateNavMeshData() and will be used for dtNavMesh::init()
-  ezDataBuffer m_DetourNavmeshData;
+  /// \brief The origin of the tile grid in Recast space (Y up), passed to dtNavMesh::init()
+  ezVec3 m_vTileGridOrigin = ezVec3::ZeroVector();
 
-  /// \brief Optional, if available the navmesh can be visualized at runtime
-  rcPolyMesh* m_pNavMeshPolygons = nullptr;
+  /// \brief The world space size of each (square) tile.
+  float m_fTileWorldSize = 0.0f;
+
+  /// \brief Upper limits for the tile grid, passed to dtNavMesh::init()
+  ezUInt32 m_uiMaxTiles = 0;
+  ezUInt32 m_uiMaxPolysPerTile = 0;
+
+  /// \brief All tiles that contain any navigable polygons.
+  ezDynamicArray<ezRecastNavMeshTile> m_Tiles;
+
+  /// \brief Returns the index of the tile at the given tile coordinate or ezInvalidIndex.
+  ezUInt32 FindTile(ezInt32 iTileX, ezInt32 iTileY) const;
 
   void Clear();
 
@@ -40,14 +80,33 @@ public:
   ~ezRecastNavMeshResource();
 
   const dtNavMesh* GetNavMesh() const { return m_pNavMesh; }
+
+  /// \brief Returns all tile polygons merged into one mesh, which is used for visualization and points of interest extraction.
   const rcPolyMesh* GetNavMeshPolygons() const { return m_pNavMeshPolygons; }
 
+  /// \brief Replaces (or adds) the given tiles in the navmesh, e.g. after ezRecastNavMeshBuilder::RebuildTiles().
+  ///
+  /// Tiles that contain no data remove the tile at that coordinate. The merged polygon mesh is recreated and the revision is
+  /// increased, so that users of the navmesh can detect the change. Must not be called while other threads query the navmesh.
+  /// Fails for tiles that would exceed the maximum tile count the navmesh was created with.
+  ezResult ReplaceTiles(ezArrayPtr<ezRecastNavMeshTile> tiles);
+
+  /// \brief Increased every time the navmesh content changes through ReplaceTiles().
+  ezUInt32 GetRevision() const { return m_uiRevision; }
+
+  /// \brief Gives access to the tile data, e.g. to pass it to ezRecastNavMeshBuilder::RebuildTiles().
+  const ezRecastNavMeshResourceDescriptor& GetDescriptor() const { return m_Descriptor; }
+
 private:
   virtual ezResourceLoadDesc UnloadData(Unload WhatToUnload) override;
   virtual ezResourceLoadDesc UpdateContent(ezStreamReader* Stream) override;
   virtual void UpdateMemoryUsage(MemoryUsage& out_NewMemoryUsage) override;
 
-  ezDataBuffer m_DetourNavmeshData;
+  ezResult AddTileToNavMesh(const ezRecastNavMeshTile& tile);
+  void MergeTilePolygons();
+
+  ezRecastNavMeshResourceDescriptor m_Descriptor;
   dtNavMesh* m_pNavMesh = nullptr;
   rcPolyMesh* m_pNavMeshPolygons = nullptr;
+  ezUInt32 m_uiRevision = 0;
 };
@@ -1,8 +1,10 @@
 #include <RecastPlugin/RecastPluginPCH.h>
 
 #include <Core/World/World.h>
+#include <Foundation/Profiling/Profiling.h>
 #include <Recast/DetourCrowd.h>
 #include <RecastPlugin/Resources/RecastNavMeshResource.h>
+#include <RecastPlugin/Utils/RcMath.h>
 #include <RecastPlugin/WorldModule/RecastWorldModule.h>
 
 // clang-format off
@@ -11,6 +13,30 @@ EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezRecastWorldModule, 1, ezRTTINoAllocator)
 EZ_END_DYNAMIC_REFLECTED_TYPE;
 // clang-format on
 
+/// \todo Hard-coded limits
+static constexpr int s_iMaxSearchNodes = 2048;
+static constexpr ezUInt32 s_uiMaxCorridorLength = 256;
+
+class ezRecastPathSearchTask final : public ezTask
+{
+public:
+  ezRecastPathSearchTask(ezRecastWorldModule* pModule)
+    : m_pModule(pModule)
+  {
+    ConfigureTask("Recast Path Search", ezTaskNesting::Never);
+  }
+
+  virtual void ExecuteWithMultiplicity(ezUInt32 uiInvocation) const override
+  {
+    m_pModule->ProcessPathSearches(uiInvocation, m_uiIterationBudget);
+  }
+
+  ezUInt32 m_uiIterationBudget = 0;
+
+private:
+  ezRecastWorldModule* m_pModule = nullptr;
+};
+
 ezRecastWorldModule::ezRecastWorldModule(ezWorld* pWorld)
   : ezWorldModule(pWorld)
 {
@@ -31,6 +57,28 @@ void ezRecastWorldModule::Initialize()
     RegisterUpdateFunction(updateDesc);
   }
 
+  {
+    auto startDesc = EZ_CREATE_MODULE_UPDATE_FUNCTION_DESC(ezRecastWorldModule::StartPathSearches, this);
+    startDesc.m_Phase = ezWorldModule::UpdateFunctionDesc::Phase::PreAsync;
+    startDesc.m_bOnlyUpdateWhenSimulating = false;
+    // start as late as possible, so that all agents had the chance to request paths this frame
+    startDesc.m_fPriority = -100000.0f;
+
+    RegisterUpdateFunction(startDesc);
+  }
+
+  {
+    auto finishDesc = EZ_CREATE_MODULE_UPDATE_FUNCTION_DESC(ezRecastWorldModule::FinishPathSearches, this);
+    finishDesc.m_Phase = ezWorldModule::UpdateFunctionDesc::Phase::PostAsync;
+    finishDesc.m_bOnlyUpdateWhenSimulating = false;
+    // finish before the navmesh may get updated
+    finishDesc.m_fPriority = 100000.0f;
+
+    RegisterUpdateFunction(finishDesc);
+  }
+
+  m_pPathSearchTask = EZ_DEFAULT_NEW(ezRecastPathSearchTask, this);
+
   ezResourceManager::GetResourceEvents().AddEventHandler(ezMakeDelegate(&ezRecastWorldModule::ResourceEventHandler, this));
 }
 
@@ -38,11 +86,18 @@ void ezRecastWorldModule::Deinitialize()
 {
   ezResourceManager::GetResourceEvents().RemoveEventHandler(ezMakeDelegate(&ezRecastWorldModule::ResourceEventHandler, this));
 
+  ClearPathSearches();
+  m_NewPathSearches.Clear();
+  m_PathRequests.Clear();
+  m_pPathSearchTask.Clear();
+
   SUPER::Deinitialize();
 }
 
 void ezRecastWorldModule::SetNavMeshResource(const ezRecastNavMeshResourceHandle& hNavMesh)
 {
+  ClearPathSearches();
+
   m_hNavMesh = hNavMesh;
   m_pDetourNavMesh = nullptr;
   m_pNavMeshPointsOfInterest.Clear();
@@ -50,19 +105,33 @@ void ezRecastWorldModule::SetNavMeshResource(const ezRecastNavMeshResourceHandle
 
 void ezRecastWorldModule::UpdateNavMesh(const UpdateContext& ctxt)
 {
-  if (m_pDetourNavMesh == nullptr && m_hNavMesh.IsValid())
+  if (m_hNavMesh.IsValid())
   {
     ezResourceLock<ezRecastNavMeshResource> pNavMesh(m_hNavMesh, ezResourceAcquireMode::BlockTillLoaded_NeverFail);
 
     if (pNavMesh.GetAcquireResult() != ezResourceAcquireResult::Final)
       return;
 
-    m_pDetourNavMesh = pNavMesh->GetNavMesh();
-
-    if (m_pDetourNavMesh)
+    // tiles may have been replaced at runtime, in that case the points of interest need to be extracted again
+    if (m_pDetourNavMesh == nullptr || m_uiNavMeshRevision != pNavMesh->GetRevision())
     {
-      m_pNavMeshPointsOfInterest = EZ_DEFAULT_NEW(ezNavMeshPointOfInterestGraph);
-      m_pNavMeshPointsOfInterest->ExtractInterestPointsFromMesh(*pNavMesh->GetNavMeshPolygons());
+      // searches that are in progress may reference polygons that don't exist anymore
+      ClearPathSearches();
+
+      m_pDetourNavMesh = pNavMesh->GetNavMesh();
+      m_uiNavMeshRevision = pNavMesh->GetRevision();
+      m_pNavMeshPointsOfInterest.Clear();
+
+      if (m_pDetourNavMesh && pNavMesh->GetNavMeshPolygons())
+      {
+        m_pNavMeshPointsOfInterest = EZ_DEFAULT_NEW(ezNavMeshPointOfInterestGraph);
+        m_pNavMeshPointsOfInterest->ExtractInterestPointsFromMesh(*pNavMesh->GetNavMeshPolygons());
+      }
+
+      if (m_pDetourNavMesh)
+      {
+        CreatePathSearchWorkers();
+      }
     }
   }
 
@@ -76,7 +145,263 @@ void ezRecastWorldModule::ResourceEventHandler(const ezResourceEvent& e)
 {
   if (e.m_Type == ezResourceEvent::Type::ResourceContentUnloading && e.m_pResource->GetDynamicRTTI()->IsDerivedFrom<ezRecastNavMeshResource>())
   {
+    ClearPathSearches();
+
     // triggers a recreation in the next update
     m_pDetourNavMesh = nullptr;
   }
 }
+
+ezRecastPathRequestId ezRecastWorldModule::RequestPath(const ezVec3& vStart, const ezVec3& vTarget, const dtQueryFilter& filter)
+{
+  PathRequest request;
+  request.m_State = ezRecastPathRequestState::Pending;
+
+  PathSearchJob& job = m_NewPathSearches.ExpandAndGetRef();
+  job.m_Id = m_PathRequests.Insert(std::move(request));
+  job.m_Filter = filter;
+  job.m_Result.m_vStartPosition = vStart;
+  job.m_Result.m_vTargetPosition = vTarget;
+
+  return job.m_Id;
+}
+
+void ezRecastWorldModule::CancelPathRequest(ezRecastPathRequestId id)
+{
+  // queued searches for this ID are dropped the next time the searches are started
+  m_PathRequests.Remove(id);
+}
+
+ezRecastPathRequestState::Enum ezRecastWorldModule::PollPathRequest(ezRecastPathRequestId id, ezRecastPathResult& out_Result)
+{
+  PathRequest* pRequest = nullptr;
+  if (!m_PathRequests.TryGetValue(id, pRequest))
+    return ezRecastPathRequestState::Invalid;
+
+  const ezRecastPathRequestState::Enum state = pRequest->m_State;
+
+  if (state != ezRecastPathRequestState::Pending)
+  {
+    out_Result = std::move(pRequest->m_Result);
+    m_PathRequests.Remove(id);
+  }
+
+  return state;
+}
+
+void ezRecastWorldModule::CreatePathSearchWorkers()
+{
+  EZ_ASSERT_DEV(!m_PathSearchTaskGroup.IsValid() || ezTaskSystem::IsTaskGroupFinished(m_PathSearchTaskGroup), "Path searches are still running");
+
+  m_pMainThreadQuery = EZ_DEFAULT_NEW(dtNavMeshQuery);
+  m_pMainThreadQuery->init(m_pDetourNavMesh, 512);
+
+  // one query object per worker thread, every one of them processes its own queue of searches
+  const ezUInt32 uiNumWorkers = ezMath::Clamp(ezTaskSystem::GetWorkerThreadCount(ezWorkerThreadType::ShortTasks), 1u, 16u);
+
+  m_PathSearchWorkers.SetCount(uiNumWorkers);
+
+  for (auto& pWorker : m_PathSearchWorkers)
+  {
+    if (pWorker == nullptr)
+    {
+      pWorker = EZ_DEFAULT_NEW(PathSearchWorker);
+    }
+
+    pWorker->m_pQuery = EZ_DEFAULT_NEW(dtNavMeshQuery);
+    pWorker->m_pQuery->init(m_pDetourNavMesh, s_iMaxSearchNodes);
+  }
+}
+
+void ezRecastWorldModule::ClearPathSearches()
+{
+  ezTaskSystem::WaitForGroup(m_PathSearchTaskGroup);
+  m_PathSearchTaskGroup.Invalidate();
+
+  // put all unfinished searches back into the queue, they are restarted once a navmesh is available again
+  for (auto& pWorker : m_PathSearchWorkers)
+  {
+    for (PathSearchJob& job : pWorker->m_Finished)
+    {
+      job.m_bSearchStarted = false;
+      m_NewPathSearches.PushBack(std::move(job));
+    }
+
+    for (PathSearchJob& job : pWorker->m_Queue)
+    {
+      job.m_bSearchStarted = false;
+      m_NewPathSearches.PushBack(std::move(job));
+    }
+  }
+
+  m_PathSearchWorkers.Clear();
+  m_pMainThreadQuery.Clear();
+}
+
+void ezRecastWorldModule::StartPathSearches(const UpdateContext& ctxt)
+{
+  if (m_pDetourNavMesh == nullptr || m_PathSearchWorkers.IsEmpty())
+    return;
+
+  EZ_PROFILE_SCOPE("StartPathSearches");
+
+  // drop all searches that were canceled in the meantime
+  for (auto& pWorker : m_PathSearchWorkers)
+  {
+    for (ezUInt32 i = pWorker->m_Queue.GetCount(); i > 0; --i)
+    {
+      if (!m_PathRequests.Contains(pWorker->m_Queue[i - 1].m_Id))
+      {
+        pWorker->m_Queue.RemoveAtAndCopy(i - 1);
+      }
+    }
+  }
+
+  // distribute the new searches, always to the worker with the least work
+  ezUInt32 uiTotalSearches = 0;
+  for (PathSearchJob& job : m_NewPathSearches)
+  {
+    if (!m_PathRequests.Contains(job.m_Id))
+      continue;
+
+    PathSearchWorker* pBestWorker = m_PathSearchWorkers[0].Borrow();
+    for (auto& pWorker : m_PathSearchWorkers)
+    {
+      if (pWorker->m_Queue.GetCount() < pBestWorker->m_Queue.GetCount())
+      {
+        pBestWorker = pWorker.Borrow();
+      }
+    }
+
+    pBestWorker->m_Queue.PushBack(std::move(job));
+  }
+
+  m_NewPathSearches.Clear();
+
+  for (auto& pWorker : m_PathSearchWorkers)
+  {
+    uiTotalSearches += pWorker->m_Queue.GetCount();
+  }
+
+  if (uiTotalSearches == 0)
+    return;
+
+  ezRecastPathSearchTask* pTask = static_cast<ezRecastPathSearchTask*>(m_pPathSearchTask.Borrow());
+  pTask->m_uiIterationBudget = ezMath::Max(1u, m_uiPathSearchBudget / m_PathSearchWorkers.GetCount());
+  pTask->SetMultiplicity(m_PathSearchWorkers.GetCount());
+
+  m_PathSearchTaskGroup = ezTaskSystem::StartSingleTask(m_pPathSearchTask, ezTaskPriority::EarlyThisFrame);
+}
+
+void ezRecastWorldModule::FinishPathSearches(const UpdateContext& ctxt)
+{
+  if (!m_PathSearchTaskGroup.IsValid())
+    return;
+
+  EZ_PROFILE_SCOPE("FinishPathSearches");
+
+  {
+    EZ_PROFILE_SCOPE("Wait for Path Searches");
+    ezTaskSystem::WaitForGroup(m_PathSearchTaskGroup);
+    m_PathSearchTaskGroup.Invalidate();
+  }
+
+  for (auto& pWorker : m_PathSearchWorkers)
+  {
+    for (PathSearchJob& job : pWorker->m_Finished)
+    {
+      PathRequest* pRequest = nullptr;
+      if (m_PathRequests.TryGetValue(job.m_Id, pRequest))
+      {
+        pRequest->m_State = job.m_State;
+        pRequest->m_Result = std::move(job.m_Result);
+      }
+    }
+
+    pWorker->m_Finished.Clear();
+  }
+}
+
+void ezRecastWorldModule::ProcessPathSearches(ezUInt32 uiWorker, ezUInt32 uiIterationBudget)
+{
+  PathSearchWorker& worker = *m_PathSearchWorkers[uiWorker];
+  dtNavMeshQuery& query = *worker.m_pQuery;
+
+  ezInt32 iBudget = static_cast<ezInt32>(uiIterationBudget);
+
+  while (!worker.m_Queue.IsEmpty() && iBudget > 0)
+  {
+    PathSearchJob& job = worker.m_Queue.PeekFront();
+
+    if (!job.m_bSearchStarted)
+    {
+      job.m_bSearchStarted = true;
+      job.m_State = ezRecastPathRequestState::Pending;
+
+      // same tolerances as ezRcAgentComponent::FindNavMeshPolyAt()
+      const float fPlaneEpsilon = 0.01f;
+      const float fHeightEpsilon = 1.0f;
+      const ezVec3 vExtents(fPlaneEpsilon, fHeightEpsilon, fPlaneEpsilon);
+
+      ezRcPos rcStart = job.m_Result.m_vStartPosition;
+      ezRcPos rcTarget = job.m_Result.m_vTargetPosition;
+      ezRcPos rcStartOnNavMesh;
+      ezRcPos rcTargetOnNavMesh;
+      dtPolyRef startPoly = 0;
+
+      if (dtStatusFailed(query.findNearestPoly(rcStart, &vExtents.x, &job.m_Filter, &startPoly, rcStartOnNavMesh)) || startPoly == 0)
+      {
+        job.m_State = ezRecastPathRequestState::StartNotOnNavMesh;
+      }
+      else if (dtStatusFailed(query.findNearestPoly(rcTarget, &vExtents.x, &job.m_Filter, &job.m_TargetPoly, rcTargetOnNavMesh)) || job.m_TargetPoly == 0)
+      {
+        job.m_State = ezRecastPathRequestState::TargetNotOnNavMesh;
+      }
+      else if (dtStatusFailed(query.initSlicedFindPath(startPoly, job.m_TargetPoly, rcStartOnNavMesh, rcTarget, &job.m_Filter)))
+      {
+        job.m_State = ezRecastPathRequestState::NoPath;
+      }
+      else
+      {
+        job.m_Result.m_vStartPosition = rcStartOnNavMesh;
+      }
+
+      // these checks are cheap compared to the actual search, so they only count as a single iteration
+      --iBudget;
+    }
+
+    if (job.m_State == ezRecastPathRequestState::Pending)
+    {
+      int iDoneIterations = 0;
+      const dtStatus status = query.updateSlicedFindPath(iBudget, &iDoneIterations);
+      iBudget -= ezMath::Max(1, iDoneIterations);
+
+      if (dtStatusInProgress(status))
+      {
+        // out of budget, continue with this search in the next frame
+        break;
+      }
+
+      int iCorridorLength = 0;
+      job.m_Result.m_Corridor.SetCountUninitialized(s_uiMaxCorridorLength);
+
+      if (dtStatusFailed(status) ||
+          dtStatusFailed(query.finalizeSlicedFindPath(job.m_Result.m_Corridor.GetData(), &iCorridorLength, (int)s_uiMaxCorridorLength)) ||
+          iCorridorLength <= 0)
+      {
+        job.m_Result.m_Corridor.Clear();
+        job.m_State = ezRecastPathRequestState::NoPath;
+      }
+      else
+      {
+        job.m_Result.m_Corridor.SetCountUninitialized(iCorridorLength);
+
+        // if the last polygon is not the target polygon, the target can't be reached, but we can walk close to it
+        job.m_State = (job.m_Result.m_Corridor.PeekBack() == job.m_TargetPoly) ? ezRecastPathRequestState::Succeeded : ezRecastPathRequestState::PartialPath;
+      }
+    }
+
+    worker.m_Finished.PushBack(std::move(job));
+    worker.m_Queue.PopFront();
+  }
+}
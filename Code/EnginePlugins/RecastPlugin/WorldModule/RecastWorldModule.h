@@ -4,6 +4,10 @@
 
 #include <Core/ResourceManager/ResourceHandle.h>
 #include <Core/World/WorldModule.h>
+#include <Foundation/Containers/Deque.h>
+#include <Foundation/Containers/IdTable.h>
+#include <Foundation/Threading/TaskSystem.h>
+#include <Recast/DetourNavMeshQuery.h>
 #include <RecastPlugin/NavMeshBuilder/NavMeshPointsOfInterest.h>
 
 class dtCrowd;
@@ -12,6 +16,40 @@ struct ezResourceEvent;
 
 using ezRecastNavMeshResourceHandle = ezTypedResourceHandle<class ezRecastNavMeshResource>;
 
+/// \brief Identifies a path request, see ezRecastWorldModule::RequestPath()
+typedef ezGenericId<24, 8> ezRecastPathRequestId;
+
+struct ezRecastPathRequestState
+{
+  using StorageType = ezUInt8;
+
+  enum Enum : StorageType
+  {
+    Invalid,            ///< The request ID is unknown, e.g. because it was canceled or its result was already retrieved.
+    Pending,            ///< The path is not computed yet.
+    Succeeded,          ///< A path to the target was found.
+    PartialPath,        ///< The target can't be reached, the result contains a path to the closest reachable polygon.
+    StartNotOnNavMesh,  ///< The start position is not on the navmesh.
+    TargetNotOnNavMesh, ///< The target position is not on the navmesh.
+    NoPath,             ///< The path search failed.
+
+    Default = Invalid
+  };
+};
+
+/// \brief The result of a path request, see ezRecastWorldModule::PollPathRequest()
+struct EZ_RECASTPLUGIN_DLL ezRecastPathResult
+{
+  /// \brief The start position projected onto the navmesh.
+  ezVec3 m_vStartPosition = ezVec3::ZeroVector();
+
+  /// \brief The target position that was requested.
+  ezVec3 m_vTargetPosition = ezVec3::ZeroVector();
+
+  /// \brief All polygons from the start polygon to the target polygon.
+  ezDynamicArray<dtPolyRef> m_Corridor;
+};
+
 class EZ_RECASTPLUGIN_DLL ezRecastWorldModule : public ezWorldModule
 {
   EZ_DECLARE_WORLD_MODULE();
@@ -31,11 +69,82 @@ public:
   const ezNavMeshPointOfInterestGraph* GetNavMeshPointsOfInterestGraph() const { return m_pNavMeshPointsOfInterest.Borrow(); }
   ezNavMeshPointOfInterestGraph* AccessNavMeshPointsOfInterestGraph() const { return m_pNavMeshPointsOfInterest.Borrow(); }
 
+  /// \brief Returns a navmesh query object that can be shared by everyone who runs cheap queries (corridor movement, raycasts, etc.)
+  /// during the synchronous update phases. Returns nullptr as long as no navmesh is available.
+  /// The query is destroyed when the navmesh is unloaded or replaced, so the pointer has to be fetched again every frame.
+  ///
+  /// Path searches should go through RequestPath() instead.
+  dtNavMeshQuery* GetNavMeshQuery() const { return m_pMainThreadQuery.Borrow(); }
+
+  /// \name Asynchronous path queries
+  ///@{
+
+  /// \brief Queues a path search from \a vStart to \a vTarget.
+  ///
+  /// All queued requests are processed as time-sliced searches on the task system, starting at the end of the PreAsync phase.
+  /// Results become available in the PostAsync phase, at the earliest in the same frame, see PollPathRequest().
+  /// Must only be called during the synchronous update phases.
+  ezRecastPathRequestId RequestPath(const ezVec3& vStart, const ezVec3& vTarget, const dtQueryFilter& filter);
+
+  /// \brief Discards the request. The ID becomes invalid.
+  void CancelPathRequest(ezRecastPathRequestId id);
+
+  /// \brief Returns the state of the request. Once it is finished, the result is written to \a out_Result and the ID becomes invalid.
+  ezRecastPathRequestState::Enum PollPathRequest(ezRecastPathRequestId id, ezRecastPathResult& out_Result);
+
+  /// \brief Sets how many search iterations (visited navmesh nodes) all path searches may use per frame in total.
+  ///
+  /// Searches that exceed the budget are continued in the next frame.
+  void SetPathSearchBudget(ezUInt32 uiMaxIterationsPerFrame) { m_uiPathSearchBudget = ezMath::Max(1u, uiMaxIterationsPerFrame); }
+  ezUInt32 GetPathSearchBudget() const { return m_uiPathSearchBudget; }
+
+  ///@}
+
 private:
   void UpdateNavMesh(const UpdateContext& ctxt);
+  void StartPathSearches(const UpdateContext& ctxt);
+  void FinishPathSearches(const UpdateContext& ctxt);
   void ResourceEventHandler(const ezResourceEvent& e);
 
+  struct PathRequest
+  {
+    ezEnum<ezRecastPathRequestState> m_State;
+    ezRecastPathResult m_Result;
+  };
+
+  struct PathSearchJob
+  {
+    ezRecastPathRequestId m_Id;
+    ezEnum<ezRecastPathRequestState> m_State;
+    bool m_bSearchStarted = false;
+    dtPolyRef m_TargetPoly = 0;
+    dtQueryFilter m_Filter;
+    ezRecastPathResult m_Result;
+  };
+
+  /// \brief Each worker owns a query object, which keeps the state of the sliced search at the front of its queue across frames.
+  struct PathSearchWorker
+  {
+    ezUniquePtr<dtNavMeshQuery> m_pQuery;
+    ezDeque<PathSearchJob> m_Queue;
+    ezDynamicArray<PathSearchJob> m_Finished;
+  };
+
+  friend class ezRecastPathSearchTask;
+  void ProcessPathSearches(ezUInt32 uiWorker, ezUInt32 uiIterationBudget);
+  void CreatePathSearchWorkers();
+  void ClearPathSearches();
+
   const dtNavMesh* m_pDetourNavMesh = nullptr;
+  ezUInt32 m_uiNavMeshRevision = 0;
   ezRecastNavMeshResourceHandle m_hNavMesh;
   ezUniquePtr<ezNavMeshPointOfInterestGraph> m_pNavMeshPointsOfInterest;
+
+  ezUniquePtr<dtNavMeshQuery> m_pMainThreadQuery;
+  ezIdTable<ezRecastPathRequestId, PathRequest> m_PathRequests;
+  ezDynamicArray<PathSearchJob> m_NewPathSearches;
+  ezDynamicArray<ezUniquePtr<PathSearchWorker>> m_PathSearchWorkers;
+  ezSharedPtr<ezTask> m_pPathSearchTask;
+  ezTaskGroupID m_PathSearchTaskGroup;
+  ezUInt32 m_uiPathSearchBudget = 1024 * 16;
 };
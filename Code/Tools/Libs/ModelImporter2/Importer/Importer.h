@@ -19,6 +19,9 @@ namespace ezModelImporter2
     bool m_bImportSkinningData = false;
     bool m_bRecomputeNormals = false;
     bool m_bRecomputeTangents = false;
+    bool m_bOptimizeMesh = false;      ///< Reorders triangles and vertices for the vertex cache, overdraw and vertex fetch, see ezMeshOptimizer.
+    bool m_bQuantizeVertices = false; ///< Only used together with m_bOptimizeMesh.
+    ezUInt32 m_uiNumLods = 1;         ///< If larger than one, simplified LODs are generated for the mesh, see ezMeshOptimizer::GenerateLods().
     ezMat3 m_RootTransform = ezMat3::IdentityMatrix();
 
     ezMeshResourceDescriptor* m_pMeshOutput = nullptr;
@@ -5,6 +5,7 @@
 
 #include <RendererCore/AnimationSystem/EditableSkeleton.h>
 #include <RendererCore/Meshes/MeshBufferResource.h>
+#include <RendererCore/Meshes/MeshOptimizer.h>
 #include <RendererCore/Meshes/MeshResourceDescriptor.h>
 #include <assimp/DefaultLogger.hpp>
 #include <assimp/LogStream.hpp>
@@ -118,6 +119,52 @@ namespace ezModelImporter2
           // do not return failure here, because we can still continue
         }
       }
+
+      if (m_Options.m_uiNumLods > 1)
+      {
+        ezMeshOptimizer::LodOptions lodOpt;
+        lodOpt.m_uiNumLods = m_Options.m_uiNumLods;
+
+        if (ezMeshOptimizer::GenerateLods(*m_Options.m_pMeshOutput, lodOpt).Failed())
+        {
+          ezLog::Error("Generating the mesh LODs failed.");
+          // do not return failure here, because we can still continue
+        }
+        else
+        {
+          const auto& subMeshes = m_Options.m_pMeshOutput->GetAllSubMeshes();
+
+          for (const auto& lod : m_Options.m_pMeshOutput->GetLods())
+          {
+            ezUInt32 uiNumTriangles = 0;
+            for (ezUInt32 i = 0; i < lod.m_uiSubMeshCount; ++i)
+            {
+              uiNumTriangles += subMeshes[lod.m_uiFirstSubMesh + i].m_uiPrimitiveCount;
+            }
+
+            ezLog::Info("Mesh LOD: {} triangles, error {}, used below {} screen coverage", uiNumTriangles, ezArgF(lod.m_fError, 4), ezArgF(lod.m_fMaxScreenCoverage, 3));
+          }
+        }
+      }
+
+      if (m_Options.m_bOptimizeMesh)
+      {
+        ezMeshOptimizer::Options opt;
+        opt.m_bQuantizeVertices = m_Options.m_bQuantizeVertices;
+
+        ezMeshOptimizer::Statistics before, after;
+        if (ezMeshOptimizer::Optimize(*m_Options.m_pMeshOutput, opt, &before, &after).Failed())
+        {
+          ezLog::Error("Optimizing the mesh failed.");
+          // do not return failure here, because we can still continue
+        }
+        else
+        {
+          m_Options.m_pMeshOutput->ComputeBounds();
+
+          ezLog::Info("Mesh optimization: ACMR {} -> {}, ATVR {} -> {}, vertex size {} -> {} bytes", ezArgF(before.GetACMR(), 3), ezArgF(after.GetACMR(), 3), ezArgF(before.GetATVR(), 3), ezArgF(after.GetATVR(), 3), before.m_uiVertexSize, after.m_uiVertexSize);
+        }
+      }
     }
 
     return EZ_SUCCESS;
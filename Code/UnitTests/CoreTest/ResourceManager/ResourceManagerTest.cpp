@@ -1,6 +1,8 @@
 #include <CoreTest/CoreTestPCH.h>
 
 #include <Core/ResourceManager/ResourceManager.h>
+#include <Foundation/Threading/TaskSystem.h>
+#include <Foundation/Time/Stopwatch.h>
 #include <Foundation/Types/ScopeExit.h>
 
 EZ_CREATE_SIMPLE_TEST_GROUP(ResourceManager);
@@ -111,6 +113,7 @@ namespace
       ld.m_pCustomLoaderData = pData;
       ld.m_pDataStream = &pData->m_Reader;
       ld.m_sResourceDescription = pResource->GetResourceID();
+      ld.m_uiDataSize = pData->m_StreamData.GetStorageSize64();
 
       return ld;
     }
@@ -286,3 +289,294 @@ EZ_CREATE_SIMPLE_TEST(ResourceManager, NestedLoading)
     EZ_TEST_INT(ezResourceManager::GetAllResourcesOfType<TestResource>()->GetCount(), 0);
   }
 }
+
+EZ_CREATE_SIMPLE_TEST(ResourceManager, ConcurrentAcquire)
+{
+  TestResourceTypeLoader TypeLoader;
+  ezResourceManager::SetResourceTypeLoader<TestResource>(&TypeLoader);
+  EZ_SCOPE_EXIT(ezResourceManager::SetResourceTypeLoader<TestResource>(nullptr));
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Acquire and release from all worker threads")
+  {
+    const ezUInt32 uiNumResources = 64;
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEBUG)
+    const ezUInt32 uiNumAcquires = 100000;
+#else
+    const ezUInt32 uiNumAcquires = 2000000;
+#endif
+
+    ezDynamicArray<TestResourceHandle> hResources;
+
+    ezStringBuilder sResourceID;
+    for (ezUInt32 i = 0; i < uiNumResources; ++i)
+    {
+      sResourceID.Format("Acquire-{}", i);
+      hResources.PushBack(ezResourceManager::LoadResource<TestResource>(sResourceID));
+
+      ezResourceLock<TestResource> pTestResource(hResources[i], ezResourceAcquireMode::BlockTillLoaded);
+      EZ_TEST_BOOL(pTestResource.GetAcquireResult() == ezResourceAcquireResult::Final);
+    }
+
+    ezAtomicInteger32 iNumFinal;
+
+    ezStopwatch sw;
+
+    ezTaskSystem::ParallelForIndexed(0, uiNumAcquires, [&](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) {
+      ezInt32 iFinal = 0;
+
+      for (ezUInt32 i = uiStartIndex; i < uiEndIndex; ++i)
+      {
+        // copying the handle changes the reference count, like render data that stores the handles
+        TestResourceHandle hResource = hResources[i % uiNumResources];
+
+        ezResourceLock<TestResource> pTestResource(hResource, ezResourceAcquireMode::AllowLoadingFallback);
+        if (pTestResource.GetAcquireResult() == ezResourceAcquireResult::Final)
+        {
+          ++iFinal;
+        }
+      }
+
+      iNumFinal.Add(iFinal);
+    });
+
+    const ezTime tAcquire = sw.GetRunningTotal();
+    ezTestFramework::Output(ezTestOutput::Duration, "%u acquires of loaded resources from all worker threads: %.2fms", uiNumAcquires, tAcquire.GetMilliseconds());
+
+    EZ_TEST_INT(iNumFinal, uiNumAcquires);
+
+    for (ezUInt32 i = 0; i < uiNumResources; ++i)
+    {
+      ezResourceLock<TestResource> pTestResource(hResources[i], ezResourceAcquireMode::PointerOnly);
+      EZ_TEST_INT(pTestResource->GetReferenceCount(), 1);
+    }
+
+    hResources.Clear();
+
+    while (ezResourceManager::IsAnyLoadingInProgress())
+    {
+      ezThreadUtils::Sleep(ezTime::Milliseconds(100));
+    }
+
+    ezResourceManager::FreeAllUnusedResources();
+
+    EZ_TEST_INT(ezResourceManager::GetAllResourcesOfType<TestResource>()->GetCount(), 0);
+  }
+}
+
+EZ_CREATE_SIMPLE_TEST(ResourceManager, StreamingBudget)
+{
+  TestResourceTypeLoader TypeLoader;
+  ezResourceManager::SetResourceTypeLoader<TestResource>(&TypeLoader);
+  EZ_SCOPE_EXIT(ezResourceManager::SetResourceTypeLoader<TestResource>(nullptr));
+
+  const ezResourceStreamingSettings defaultSettings = ezResourceManager::GetStreamingSettings();
+  EZ_SCOPE_EXIT(ezResourceManager::SetStreamingSettings(defaultSettings));
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Load with minimal budgets")
+  {
+    // only one resource at a time may be read and the decode budget is smaller than a single resource
+    ezResourceStreamingSettings settings;
+    settings.m_uiMaxIoRequestsInFlight = 1;
+    settings.m_uiMaxDecodeRequestsInFlight = 1;
+    settings.m_uiMaxDecodeBytesInFlight = 1;
+    ezResourceManager::SetStreamingSettings(settings);
+
+    const ezUInt64 uiFinishedBefore = ezResourceManager::GetStreamingStats().m_uiNumRequestsFinished;
+
+    const ezUInt32 uiNumResources = 50;
+
+    ezDynamicArray<TestResourceHandle> hResources;
+
+    ezStringBuilder sResourceID;
+    for (ezUInt32 i = 0; i < uiNumResources; ++i)
+    {
+      sResourceID.Format("Streaming-{}", i);
+      hResources.PushBack(ezResourceManager::LoadResource<TestResource>(sResourceID));
+      ezResourceManager::PreloadResource(hResources[i]);
+    }
+
+    while (ezResourceManager::IsAnyLoadingInProgress())
+    {
+      ezThreadUtils::Sleep(ezTime::Milliseconds(10));
+    }
+
+    for (ezUInt32 i = 0; i < uiNumResources; ++i)
+    {
+      EZ_TEST_BOOL(ezResourceManager::GetLoadingState(hResources[i]) == ezResourceState::Loaded);
+    }
+
+    const ezResourceStreamingStats stats = ezResourceManager::GetStreamingStats();
+    EZ_TEST_INT(stats.m_uiQueueDepth, 0);
+    EZ_TEST_INT(stats.m_uiIoRequestsInFlight, 0);
+    EZ_TEST_INT(stats.m_uiDecodeRequestsInFlight, 0);
+    EZ_TEST_INT(stats.m_uiDecodeBytesInFlight, 0);
+    EZ_TEST_INT(stats.m_uiNumRequestsFinished - uiFinishedBefore, uiNumResources);
+
+    hResources.Clear();
+    ezResourceManager::FreeAllUnusedResources();
+
+    EZ_TEST_INT(ezResourceManager::GetAllResourcesOfType<TestResource>()->GetCount(), 0);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Blocking acquire ignores budgets")
+  {
+    ezResourceStreamingSettings settings;
+    settings.m_uiMaxIoRequestsInFlight = 1;
+    ezResourceManager::SetStreamingSettings(settings);
+
+    const ezUInt32 uiNumResources = 50;
+
+    ezDynamicArray<TestResourceHandle> hResources;
+
+    ezStringBuilder sResourceID;
+    for (ezUInt32 i = 0; i < uiNumResources; ++i)
+    {
+      sResourceID.Format("StreamingBlocking-{}", i);
+      hResources.PushBack(ezResourceManager::LoadResource<TestResource>(sResourceID));
+      ezResourceManager::PreloadResource(hResources[i]);
+    }
+
+    // the last resource is queued last, blocking on it moves it ahead of all others
+    {
+      ezResourceLock<TestResource> pTestResource(hResources.PeekBack(), ezResourceAcquireMode::BlockTillLoaded);
+      EZ_TEST_BOOL(pTestResource.GetAcquireResult() == ezResourceAcquireResult::Final);
+    }
+
+    while (ezResourceManager::IsAnyLoadingInProgress())
+    {
+      ezThreadUtils::Sleep(ezTime::Milliseconds(10));
+    }
+
+    hResources.Clear();
+    ezResourceManager::FreeAllUnusedResources();
+
+    EZ_TEST_INT(ezResourceManager::GetAllResourcesOfType<TestResource>()->GetCount(), 0);
+  }
+}
+
+EZ_CREATE_SIMPLE_TEST(ResourceManager, MemoryBudget)
+{
+  TestResourceTypeLoader TypeLoader;
+  ezResourceManager::SetResourceTypeLoader<TestResource>(&TypeLoader);
+  EZ_SCOPE_EXIT(ezResourceManager::SetResourceTypeLoader<TestResource>(nullptr));
+  EZ_SCOPE_EXIT(ezResourceManager::SetMemoryBudgetForResourceType<TestResource>(ezResourceMemoryBudget()));
+
+  ezUInt32 uiNumExceeded = 0;
+  ezUInt32 uiNumRelieved = 0;
+
+  ezEventSubscriptionID eventSubscription = ezResourceManager::GetManagerEvents().AddEventHandler([&](const ezResourceManagerEvent& e) {
+    if (e.m_pResourceType != ezGetStaticRTTI<TestResource>())
+      return;
+
+    if (e.m_Type == ezResourceManagerEvent::Type::MemoryBudgetExceeded)
+      ++uiNumExceeded;
+    else if (e.m_Type == ezResourceManagerEvent::Type::MemoryBudgetRelieved)
+      ++uiNumRelieved;
+  });
+  EZ_SCOPE_EXIT(ezResourceManager::GetManagerEvents().RemoveEventHandler(eventSubscription));
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Evict unused resources")
+  {
+    const ezUInt32 uiNumResources = 50;
+    const ezUInt32 uiNumReferenced = 5;
+
+    ezDynamicArray<TestResourceHandle> hResources;
+
+    ezStringBuilder sResourceID;
+    for (ezUInt32 i = 0; i < uiNumResources; ++i)
+    {
+      sResourceID.Format("Budget-{}", i);
+      hResources.PushBack(ezResourceManager::LoadResource<TestResource>(sResourceID));
+      ezResourceManager::PreloadResource(hResources[i]);
+    }
+
+    while (ezResourceManager::IsAnyLoadingInProgress())
+    {
+      ezThreadUtils::Sleep(ezTime::Milliseconds(10));
+    }
+
+    const ezUInt64 uiResourceSize = sizeof(TestResource);
+    EZ_TEST_INT(ezResourceManager::GetMemoryUsage(ezGetStaticRTTI<TestResource>()).m_uiMemoryCPU, uiNumResources * uiResourceSize);
+
+    hResources.SetCount(uiNumReferenced);
+
+    // nothing happens as long as the budget isn't exceeded
+    ezResourceMemoryBudget budget;
+    budget.m_uiMaxMemoryCPU = uiNumResources * uiResourceSize;
+    budget.m_fEvictionTarget = 0.5f;
+    ezResourceManager::SetMemoryBudgetForResourceType<TestResource>(budget);
+
+    EZ_TEST_INT(ezResourceManager::EnforceMemoryBudgets(), 0);
+    EZ_TEST_INT(uiNumExceeded, 0);
+
+    budget.m_uiMaxMemoryCPU = 20 * uiResourceSize;
+    ezResourceManager::SetMemoryBudgetForResourceType<TestResource>(budget);
+
+    EZ_TEST_BOOL(ezResourceManager::EnforceMemoryBudgets() > 0);
+    EZ_TEST_INT(uiNumExceeded, 1);
+    EZ_TEST_INT(uiNumRelieved, 1);
+
+    EZ_TEST_BOOL(ezResourceManager::GetMemoryUsage(ezGetStaticRTTI<TestResource>()).m_uiMemoryCPU <= 10 * uiResourceSize);
+    EZ_TEST_BOOL(ezResourceManager::GetAllResourcesOfType<TestResource>()->GetCount() >= uiNumReferenced);
+
+    for (ezUInt32 i = 0; i < uiNumReferenced; ++i)
+    {
+      ezResourceLock<TestResource> pTestResource(hResources[i], ezResourceAcquireMode::AllowLoadingFallback);
+      EZ_TEST_BOOL(pTestResource.GetAcquireResult() == ezResourceAcquireResult::Final);
+    }
+
+    // referenced resources can't be evicted, the budget stays exceeded without sending further events
+    budget.m_uiMaxMemoryCPU = 2 * uiResourceSize;
+    ezResourceManager::SetMemoryBudgetForResourceType<TestResource>(budget);
+
+    ezResourceManager::EnforceMemoryBudgets();
+    ezResourceManager::EnforceMemoryBudgets();
+    EZ_TEST_INT(uiNumExceeded, 2);
+    EZ_TEST_INT(uiNumRelieved, 1);
+    EZ_TEST_INT(ezResourceManager::GetAllResourcesOfType<TestResource>()->GetCount(), uiNumReferenced);
+
+    hResources.Clear();
+    ezResourceManager::EnforceMemoryBudgets();
+    EZ_TEST_INT(uiNumRelieved, 2);
+
+    ezResourceManager::FreeAllUnusedResources();
+    EZ_TEST_INT(ezResourceManager::GetAllResourcesOfType<TestResource>()->GetCount(), 0);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Prevent eviction")
+  {
+    const ezUInt32 uiNumResources = 10;
+    const ezUInt64 uiResourceSize = sizeof(TestResource);
+
+    ezDynamicArray<TestResourceHandle> hResources;
+
+    ezStringBuilder sResourceID;
+    for (ezUInt32 i = 0; i < uiNumResources; ++i)
+    {
+      sResourceID.Format("BudgetPrevent-{}", i);
+      hResources.PushBack(ezResourceManager::LoadResource<TestResource>(sResourceID));
+
+      // blocking acquires raise the priority to critical, that must not prevent eviction
+      ezResourceLock<TestResource> pTestResource(hResources[i], ezResourceAcquireMode::BlockTillLoaded);
+      EZ_TEST_BOOL(pTestResource->GetPriority() == ezResourcePriority::Critical);
+    }
+
+    ezResourceManager::SetPreventEviction(hResources[0], true);
+
+    ezResourceMemoryBudget budget;
+    budget.m_uiMaxMemoryCPU = 2 * uiResourceSize;
+    budget.m_fEvictionTarget = 0.5f;
+    ezResourceManager::SetMemoryBudgetForResourceType<TestResource>(budget);
+
+    hResources.Clear();
+
+    EZ_TEST_BOOL(ezResourceManager::EnforceMemoryBudgets() > 0);
+    EZ_TEST_INT(ezResourceManager::GetAllResourcesOfType<TestResource>()->GetCount(), 1);
+    EZ_TEST_INT(ezResourceManager::GetMemoryUsage(ezGetStaticRTTI<TestResource>()).m_uiMemoryCPU, uiResourceSize);
+
+    // the flag only affects the budgets
+    ezResourceManager::FreeAllUnusedResources();
+    EZ_TEST_INT(ezResourceManager::GetAllResourcesOfType<TestResource>()->GetCount(), 0);
+  }
+}
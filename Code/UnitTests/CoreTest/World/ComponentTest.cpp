@@ -526,3 +526,102 @@ EZ_CREATE_SIMPLE_TEST(World, Components)
     EZ_TEST_INT(TestComponent::s_iSimulationStartedCounter, 1);
   }
 }
+
+namespace
+{
+  class ParallelTestComponent;
+
+  class ParallelTestComponentManager : public ezComponentManager<ParallelTestComponent, ezBlockStorageType::FreeList>
+  {
+  public:
+    ParallelTestComponentManager(ezWorld* pWorld)
+      : ezComponentManager<ParallelTestComponent, ezBlockStorageType::FreeList>(pWorld)
+    {
+    }
+
+    virtual void Initialize() override
+    {
+      auto writeA = EZ_CREATE_MODULE_UPDATE_FUNCTION_DESC(ParallelTestComponentManager::WriteA, this);
+      writeA.m_WritesTo.PushBack(ezMakeHashedString("A"));
+      writeA.m_fPriority = 50.0f;
+
+      auto writeB = EZ_CREATE_MODULE_UPDATE_FUNCTION_DESC(ParallelTestComponentManager::WriteB, this);
+      writeB.m_WritesTo.PushBack(ezMakeHashedString("B"));
+      writeB.m_fPriority = 40.0f;
+
+      auto readAB = EZ_CREATE_MODULE_UPDATE_FUNCTION_DESC(ParallelTestComponentManager::ReadAB, this);
+      readAB.m_ReadsFrom.PushBack(ezMakeHashedString("A"));
+      readAB.m_ReadsFrom.PushBack(ezMakeHashedString("B"));
+      readAB.m_fPriority = 30.0f;
+
+      auto readC = EZ_CREATE_MODULE_UPDATE_FUNCTION_DESC(ParallelTestComponentManager::ReadC, this);
+      readC.m_ReadsFrom.PushBack(ezMakeHashedString("C"));
+      readC.m_fPriority = 25.0f;
+
+      auto undeclared = EZ_CREATE_MODULE_UPDATE_FUNCTION_DESC(ParallelTestComponentManager::Undeclared, this);
+      undeclared.m_fPriority = 20.0f;
+
+      auto writeA2 = EZ_CREATE_MODULE_UPDATE_FUNCTION_DESC(ParallelTestComponentManager::WriteA2, this);
+      writeA2.m_WritesTo.PushBack(ezMakeHashedString("A"));
+      writeA2.m_fPriority = 10.0f;
+
+      this->RegisterUpdateFunction(writeA2);
+      this->RegisterUpdateFunction(undeclared);
+      this->RegisterUpdateFunction(readC);
+      this->RegisterUpdateFunction(readAB);
+      this->RegisterUpdateFunction(writeB);
+      this->RegisterUpdateFunction(writeA);
+    }
+
+    void WriteA(const ezWorldModule::UpdateContext& context) { s_Order[0] = s_Counter.Increment(); }
+    void WriteB(const ezWorldModule::UpdateContext& context) { s_Order[1] = s_Counter.Increment(); }
+    void ReadAB(const ezWorldModule::UpdateContext& context) { s_Order[2] = s_Counter.Increment(); }
+    void ReadC(const ezWorldModule::UpdateContext& context) { s_Order[3] = s_Counter.Increment(); }
+    void Undeclared(const ezWorldModule::UpdateContext& context) { s_Order[4] = s_Counter.Increment(); }
+    void WriteA2(const ezWorldModule::UpdateContext& context) { s_Order[5] = s_Counter.Increment(); }
+
+    static ezAtomicInteger32 s_Counter;
+    static ezInt32 s_Order[6];
+  };
+
+  ezAtomicInteger32 ParallelTestComponentManager::s_Counter;
+  ezInt32 ParallelTestComponentManager::s_Order[6];
+
+  class ParallelTestComponent : public ezComponent
+  {
+    EZ_DECLARE_COMPONENT_TYPE(ParallelTestComponent, ezComponent, ParallelTestComponentManager);
+  };
+
+  EZ_BEGIN_COMPONENT_TYPE(ParallelTestComponent, 1, ezComponentMode::Static)
+  EZ_END_COMPONENT_TYPE
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST(World, ParallelUpdateFunctions)
+{
+  ezWorldDesc worldDesc("Test");
+  ezWorld world(worldDesc);
+  EZ_LOCK(world.GetWriteMarker());
+
+  world.GetOrCreateComponentManager<ParallelTestComponentManager>();
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Conflicting functions keep their order")
+  {
+    for (ezUInt32 uiFrame = 0; uiFrame < 10; ++uiFrame)
+    {
+      ParallelTestComponentManager::s_Counter = 0;
+      world.Update();
+
+      const ezInt32* order = ParallelTestComponentManager::s_Order;
+      EZ_TEST_INT(ParallelTestComponentManager::s_Counter, 6);
+
+      // WriteA, WriteB and ReadC may run in any order, but ReadAB must see the results of both writers
+      EZ_TEST_BOOL(order[2] > order[0]);
+      EZ_TEST_BOOL(order[2] > order[1]);
+
+      // functions without declarations act as a barrier
+      EZ_TEST_BOOL(order[4] > order[2]);
+      EZ_TEST_BOOL(order[4] > order[3]);
+      EZ_TEST_BOOL(order[5] > order[4]);
+    }
+  }
+}
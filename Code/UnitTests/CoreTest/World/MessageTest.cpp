@@ -2,7 +2,9 @@
 
 #include <Core/World/World.h>
 #include <Foundation/Memory/FrameAllocator.h>
+#include <Foundation/Threading/TaskSystem.h>
 #include <Foundation/Time/Clock.h>
+#include <Foundation/Time/Stopwatch.h>
 
 namespace
 {
@@ -235,4 +237,44 @@ EZ_CREATE_SIMPLE_TEST(World, Messaging)
 
     ezFrameAllocator::Reset();
   }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Posting from multiple threads")
+  {
+    ResetComponents(*pRoot);
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEBUG)
+    const ezUInt32 uiNumMessages = 100000;
+#else
+    const ezUInt32 uiNumMessages = 1000000;
+#endif
+
+    const ezGameObjectHandle hRoot = pRoot->GetHandle();
+    const ezComponentHandle hComponent = pRoot->GetComponents()[0]->GetHandle();
+
+    ezStopwatch sw;
+
+    ezTaskSystem::ParallelForIndexed(0, uiNumMessages, [&](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) {
+      for (ezUInt32 i = uiStartIndex; i < uiEndIndex; ++i)
+      {
+        TestMessage1 msg;
+        msg.m_iValue = 1;
+
+        if (i % 2 == 0)
+          world.PostMessage(hRoot, msg, ezTime::Zero(), ezObjectMsgQueueType::NextFrame);
+        else
+          world.PostMessage(hComponent, msg, ezTime::Zero(), ezObjectMsgQueueType::NextFrame);
+      }
+    });
+
+    const ezTime tPost = sw.GetRunningTotal();
+    ezTestFramework::Output(ezTestOutput::Duration, "Posting %u messages from all worker threads: %.2fms", uiNumMessages, tPost.GetMilliseconds());
+
+    world.Update();
+
+    TestComponentMsg* pComponent2 = nullptr;
+    pRoot->TryGetComponentOfBaseType(pComponent2);
+    EZ_TEST_INT(pComponent2->m_iSomeData, 1 + uiNumMessages);
+
+    ezFrameAllocator::Reset();
+  }
 }
@@ -1,12 +1,16 @@
 #include <CoreTest/CoreTestPCH.h>
 
 #include <Core/Messages/UpdateLocalBoundsMessage.h>
+#include <Core/World/SpatialSystem_Bvh.h>
+#include <Core/World/SpatialSystem_RegularGrid.h>
 #include <Core/World/World.h>
 #include <Foundation/Containers/HashSet.h>
 #include <Foundation/IO/FileSystem/DataDirTypeFolder.h>
 #include <Foundation/IO/FileSystem/FileSystem.h>
 #include <Foundation/IO/FileSystem/FileWriter.h>
+#include <Foundation/Math/Random.h>
 #include <Foundation/Profiling/Profiling.h>
+#include <Foundation/Time/Stopwatch.h>
 #include <Foundation/Utilities/GraphicsUtils.h>
 
 namespace
@@ -58,10 +62,11 @@ namespace
   // clang-format on
 } // namespace
 
-EZ_CREATE_SIMPLE_TEST(World, SpatialSystem)
+static void TestSpatialSystem(ezUniquePtr<ezSpatialSystem> pSpatialSystem)
 {
   ezWorldDesc worldDesc("Test");
   worldDesc.m_uiRandomNumberGeneratorSeed = 5;
+  worldDesc.m_pSpatialSystem = std::move(pSpatialSystem);
 
   ezWorld world(worldDesc);
   EZ_LOCK(world.GetWriteMarker());
@@ -326,3 +331,225 @@ EZ_CREATE_SIMPLE_TEST(World, SpatialSystem)
     world.Update();
   }
 }
+
+EZ_CREATE_SIMPLE_TEST(World, SpatialSystem)
+{
+  // without a spatial system in the world desc, the world creates a regular grid
+  TestSpatialSystem(ezUniquePtr<ezSpatialSystem>());
+}
+
+EZ_CREATE_SIMPLE_TEST(World, SpatialSystemBvh)
+{
+  TestSpatialSystem(EZ_NEW(ezFoundation::GetAlignedAllocator(), ezSpatialSystem_Bvh));
+}
+
+namespace
+{
+  struct BenchmarkScene
+  {
+    ezDynamicArray<ezSimdBBoxSphere> m_Bounds;
+    ezDynamicArray<ezVec3> m_SmallMoves;
+    ezDynamicArray<ezVec3> m_LargeMoves;
+    ezDynamicArray<ezBoundingSphere> m_Spheres;
+    ezDynamicArray<ezBoundingBox> m_Boxes;
+    ezDynamicArray<ezFrustum> m_Frustums;
+  };
+
+  ezVec3 RandomVector(ezRandom& ref_rng, const ezVec3& vHalfExtents)
+  {
+    return ezVec3(ref_rng.FloatMinMax(-vHalfExtents.x, vHalfExtents.x), ref_rng.FloatMinMax(-vHalfExtents.y, vHalfExtents.y), ref_rng.FloatMinMax(-vHalfExtents.z, vHalfExtents.z));
+  }
+
+  /// A uniform scene has small objects evenly distributed over a large area. A non-uniform scene has most objects in a few dense clusters,
+  /// some scattered over a much larger area and a few very large objects.
+  void CreateBenchmarkScene(bool bUniform, ezUInt32 uiNumObjects, ezUInt32 uiNumQueries, BenchmarkScene& out_scene)
+  {
+    ezRandom rng;
+    rng.Initialize(bUniform ? 17 : 23);
+
+    ezHybridArray<ezVec3, 16> clusterCenters;
+    for (ezUInt32 i = 0; i < 16; ++i)
+    {
+      clusterCenters.PushBack(RandomVector(rng, ezVec3(10000, 10000, 200)));
+    }
+
+    for (ezUInt32 i = 0; i < uiNumObjects; ++i)
+    {
+      ezVec3 vCenter;
+      float fRadius = rng.FloatMinMax(0.5f, 5.0f);
+
+      if (bUniform)
+      {
+        vCenter = RandomVector(rng, ezVec3(2000, 2000, 100));
+      }
+      else
+      {
+        const ezUInt32 uiType = rng.UIntInRange(100);
+        if (uiType < 90)
+        {
+          vCenter = clusterCenters[rng.UIntInRange(clusterCenters.GetCount())] + RandomVector(rng, ezVec3(50, 50, 20));
+        }
+        else
+        {
+          vCenter = RandomVector(rng, ezVec3(10000, 10000, 200));
+
+          if (uiType == 99)
+          {
+            fRadius *= 100.0f;
+          }
+        }
+      }
+
+      // spherical objects, the sphere is inside of the box so both systems can find them precisely
+      out_scene.m_Bounds.PushBack(ezSimdBBoxSphere(ezSimdConversion::ToVec3(vCenter), ezSimdVec4f(fRadius), fRadius));
+      out_scene.m_SmallMoves.PushBack(RandomVector(rng, ezVec3(0.5f)));
+      out_scene.m_LargeMoves.PushBack(RandomVector(rng, ezVec3(50.0f)));
+    }
+
+    // queries are placed at objects, so that they hit the dense areas of the non-uniform scene
+    for (ezUInt32 i = 0; i < uiNumQueries; ++i)
+    {
+      const ezVec3 vPos = ezSimdConversion::ToVec3(out_scene.m_Bounds[rng.UIntInRange(uiNumObjects)].m_CenterAndRadius);
+
+      out_scene.m_Spheres.PushBack(ezBoundingSphere(vPos, 20.0f));
+      out_scene.m_Boxes.PushBack(ezBoundingBox(vPos - ezVec3(20.0f), vPos + ezVec3(20.0f)));
+
+      if (i % 100 == 0)
+      {
+        const ezVec3 vDir = ezVec3(rng.FloatMinMax(-1, 1), rng.FloatMinMax(-1, 1), 0.0f).GetNormalized();
+
+        ezMat4 lookAt = ezGraphicsUtils::CreateLookAtViewMatrix(vPos, vPos + vDir, ezVec3::UnitZAxis());
+        ezMat4 projection = ezGraphicsUtils::CreatePerspectiveProjectionMatrixFromFovX(ezAngle::Degree(80.0f), 1.0f, 1.0f, 1000.0f);
+
+        out_scene.m_Frustums.ExpandAndGetRef().SetFrustum(projection * lookAt);
+      }
+    }
+  }
+
+  void RunBenchmark(ezSpatialSystem& ref_spatialSystem, const char* szName, const char* szSceneName, const BenchmarkScene& scene, ezUInt32* out_pNumFound)
+  {
+    const ezUInt32 uiNumObjects = scene.m_Bounds.GetCount();
+    const ezUInt32 uiCategoryBitmask = ezDefaultSpatialDataCategories::RenderStatic.GetBitmask();
+
+    ezSpatialSystem::QueryParams queryParams;
+    queryParams.m_uiCategoryBitmask = uiCategoryBitmask;
+
+    ezDynamicArray<ezSpatialDataHandle> handles;
+    handles.SetCountUninitialized(uiNumObjects);
+
+    ezDynamicArray<ezSimdBBoxSphere> bounds = scene.m_Bounds;
+
+    ezStopwatch sw;
+
+    for (ezUInt32 i = 0; i < uiNumObjects; ++i)
+    {
+      handles[i] = ref_spatialSystem.CreateSpatialData(bounds[i], nullptr, uiCategoryBitmask, ezTagSet());
+    }
+
+    ref_spatialSystem.StartNewFrame();
+
+    const ezTime tCreate = sw.Checkpoint();
+
+    for (ezUInt32 i = 0; i < uiNumObjects; ++i)
+    {
+      const ezVec3& vMove = scene.m_SmallMoves[i];
+      bounds[i].m_CenterAndRadius += ezSimdVec4f(vMove.x, vMove.y, vMove.z, 0.0f);
+      ref_spatialSystem.UpdateSpatialDataBounds(handles[i], bounds[i]);
+    }
+
+    ref_spatialSystem.StartNewFrame();
+
+    const ezTime tSmallMoves = sw.Checkpoint();
+
+    for (ezUInt32 i = 0; i < uiNumObjects; ++i)
+    {
+      const ezVec3& vMove = scene.m_LargeMoves[i];
+      bounds[i].m_CenterAndRadius += ezSimdVec4f(vMove.x, vMove.y, vMove.z, 0.0f);
+      ref_spatialSystem.UpdateSpatialDataBounds(handles[i], bounds[i]);
+    }
+
+    ref_spatialSystem.StartNewFrame();
+
+    const ezTime tLargeMoves = sw.Checkpoint();
+
+    ezUInt32 uiNumInSpheres = 0;
+    for (const ezBoundingSphere& sphere : scene.m_Spheres)
+    {
+      ref_spatialSystem.FindObjectsInSphere(sphere, queryParams, [&](ezGameObject*) {
+        ++uiNumInSpheres;
+        return ezVisitorExecution::Continue;
+      });
+    }
+
+    const ezTime tSpheres = sw.Checkpoint();
+
+    ezUInt32 uiNumInBoxes = 0;
+    for (const ezBoundingBox& box : scene.m_Boxes)
+    {
+      ref_spatialSystem.FindObjectsInBox(box, queryParams, [&](ezGameObject*) {
+        ++uiNumInBoxes;
+        return ezVisitorExecution::Continue;
+      });
+    }
+
+    const ezTime tBoxes = sw.Checkpoint();
+
+    ezUInt32 uiNumVisible = 0;
+    ezDynamicArray<const ezGameObject*> visibleObjects;
+    for (const ezFrustum& frustum : scene.m_Frustums)
+    {
+      visibleObjects.Clear();
+      ref_spatialSystem.FindVisibleObjects(frustum, queryParams, visibleObjects);
+      uiNumVisible += visibleObjects.GetCount();
+    }
+
+    const ezTime tFrustums = sw.Checkpoint();
+
+    out_pNumFound[0] = uiNumInSpheres;
+    out_pNumFound[1] = uiNumInBoxes;
+    out_pNumFound[2] = uiNumVisible;
+
+    ezTestFramework::Output(ezTestOutput::Duration, "%s, %s scene, %u objects: create %.2fms, small moves %.2fms, large moves %.2fms", szName, szSceneName, uiNumObjects,
+      tCreate.GetMilliseconds(), tSmallMoves.GetMilliseconds(), tLargeMoves.GetMilliseconds());
+    ezTestFramework::Output(ezTestOutput::Duration, "%s, %s scene: %u sphere queries %.2fms, %u box queries %.2fms, %u frustum queries %.2fms (%u visible)", szName, szSceneName,
+      scene.m_Spheres.GetCount(), tSpheres.GetMilliseconds(), scene.m_Boxes.GetCount(), tBoxes.GetMilliseconds(), scene.m_Frustums.GetCount(), tFrustums.GetMilliseconds(), uiNumVisible);
+  }
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST(World, SpatialSystemPerformance)
+{
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEBUG)
+  const ezUInt32 uiNumObjects = 10000;
+  const ezUInt32 uiNumQueries = 1000;
+#else
+  const ezUInt32 uiNumObjects = 100000;
+  const ezUInt32 uiNumQueries = 10000;
+#endif
+
+  for (bool bUniform : {true, false})
+  {
+    EZ_TEST_BLOCK(ezTestBlock::Enabled, bUniform ? "Uniform Scene" : "Non-uniform Scene")
+    {
+      BenchmarkScene scene;
+      CreateBenchmarkScene(bUniform, uiNumObjects, uiNumQueries, scene);
+
+      ezUInt32 numFoundGrid[3] = {};
+      ezUInt32 numFoundBvh[3] = {};
+
+      {
+        ezUniquePtr<ezSpatialSystem> pGrid = EZ_NEW(ezFoundation::GetAlignedAllocator(), ezSpatialSystem_RegularGrid);
+        RunBenchmark(*pGrid, "Regular Grid", bUniform ? "uniform" : "non-uniform", scene, numFoundGrid);
+      }
+
+      {
+        ezUniquePtr<ezSpatialSystem> pBvh = EZ_NEW(ezFoundation::GetAlignedAllocator(), ezSpatialSystem_Bvh);
+        RunBenchmark(*pBvh, "BVH", bUniform ? "uniform" : "non-uniform", scene, numFoundBvh);
+      }
+
+      // both systems test the bounding spheres of the objects, so they must find exactly the same objects
+      EZ_TEST_INT(numFoundGrid[0], numFoundBvh[0]);
+      EZ_TEST_INT(numFoundGrid[1], numFoundBvh[1]);
+      EZ_TEST_INT(numFoundGrid[2], numFoundBvh[2]);
+    }
+  }
+}
@@ -1,6 +1,9 @@
 #include <CoreTest/CoreTestPCH.h>
 
 #include <Core/World/World.h>
+#include <Core/WorldSerializer/WorldReader.h>
+#include <Core/WorldSerializer/WorldWriter.h>
+#include <Foundation/IO/MemoryStream.h>
 #include <Foundation/Time/Clock.h>
 #include <Foundation/Time/Stopwatch.h>
 
@@ -115,6 +118,42 @@ namespace
     }
   }
 
+  /// Writes a small 'projectile' prefab with one root object and a few children, all with a component.
+  void CreatePrefab(ezWorldReader& reader, ezDefaultMemoryStreamStorage& storage)
+  {
+    ezWorldDesc worldDesc("Prefab");
+    ezWorld world(worldDesc);
+    EZ_LOCK(world.GetWriteMarker());
+
+    ezTestComponentManager* pMan = world.GetOrCreateComponentManager<ezTestComponentManager>();
+
+    ezGameObjectDesc gd;
+    gd.m_bDynamic = true;
+    gd.m_LocalPosition.Set(1, 0, 0);
+
+    ezGameObject* pRoot;
+    gd.m_hParent = world.CreateObject(gd, pRoot);
+
+    ezTestComponent* pComp;
+    pMan->CreateComponent(pRoot, pComp);
+
+    for (ezUInt32 i = 0; i < 4; ++i)
+    {
+      gd.m_LocalPosition.Set(0, (float)i, 0);
+
+      ezGameObject* pChild;
+      world.CreateObject(gd, pChild);
+      pMan->CreateComponent(pChild, pComp);
+    }
+
+    ezMemoryStreamWriter writer(&storage);
+    ezWorldWriter ww;
+    ww.WriteWorld(writer, world);
+
+    ezMemoryStreamReader memReader(&storage);
+    EZ_TEST_BOOL(reader.ReadWorldDescription(memReader).Succeeded());
+  }
+
 } // namespace
 
 
@@ -289,3 +328,96 @@ EZ_CREATE_SIMPLE_TEST(World, Profile_Update)
     }
   }
 }
+
+EZ_CREATE_SIMPLE_TEST(World, Profile_PrefabInstantiation)
+{
+  ezDefaultMemoryStreamStorage storage;
+  ezWorldReader reader;
+  CreatePrefab(reader, storage);
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "InstantiatePrefabs")
+  {
+    ezWorldDesc worldDesc("Test");
+    ezWorld world(worldDesc);
+    EZ_LOCK(world.GetWriteMarker());
+
+    ezHybridArray<ezTransform, 8> transforms;
+    for (ezUInt32 i = 0; i < 8; ++i)
+    {
+      transforms.ExpandAndGetRef().SetIdentity();
+      transforms.PeekBack().m_vPosition.Set(i * 10.0f, 0, 0);
+    }
+
+    ezDynamicArray<ezGameObject*> rootObjects;
+    ezDynamicArray<ezGameObject*> childObjects;
+
+    ezPrefabInstantiationOptions options;
+    options.m_pCreatedRootObjectsOut = &rootObjects;
+    options.m_pCreatedChildObjectsOut = &childObjects;
+
+    reader.InstantiatePrefabs(world, transforms, options);
+
+    EZ_TEST_INT(rootObjects.GetCount(), 8);
+    EZ_TEST_INT(childObjects.GetCount(), 8 * 4);
+    EZ_TEST_INT(world.GetObjectCount(), 8 * 5);
+    EZ_TEST_INT(world.GetOrCreateComponentManager<ezTestComponentManager>()->GetComponentCount(), 8 * 5);
+
+    for (ezUInt32 i = 0; i < 8; ++i)
+    {
+      EZ_TEST_VEC3(rootObjects[i]->GetLocalPosition(), ezVec3(i * 10.0f + 1.0f, 0, 0), 0.001f);
+      EZ_TEST_INT(rootObjects[i]->GetChildCount(), 4);
+      EZ_TEST_INT(rootObjects[i]->GetComponents().GetCount(), 1);
+
+      for (ezUInt32 c = 0; c < 4; ++c)
+      {
+        EZ_TEST_BOOL(childObjects[i * 4 + c]->GetParent() == rootObjects[i]);
+      }
+    }
+  }
+
+  EZ_TEST_BLOCK(EnableInRelease, "Spawn rate")
+  {
+    constexpr ezUInt32 uiNumInstances = 10000;
+
+    ezDynamicArray<ezTransform> transforms;
+    transforms.SetCountUninitialized(uiNumInstances);
+    for (ezUInt32 i = 0; i < uiNumInstances; ++i)
+    {
+      transforms[i].SetIdentity();
+      transforms[i].m_vPosition.Set((float)(i % 100), (float)(i / 100), 0);
+    }
+
+    ezPrefabInstantiationOptions options;
+
+    {
+      ezWorldDesc worldDesc("Test");
+      ezWorld world(worldDesc);
+      EZ_LOCK(world.GetWriteMarker());
+
+      ezStopwatch sw;
+
+      for (const ezTransform& t : transforms)
+      {
+        reader.InstantiatePrefab(world, t, options);
+      }
+
+      const ezTime tDiff = sw.Checkpoint();
+      ezTestFramework::Output(ezTestOutput::Duration, "Instantiating %u prefabs one by one: %.2fms", uiNumInstances, tDiff.GetMilliseconds());
+    }
+
+    {
+      ezWorldDesc worldDesc("Test");
+      ezWorld world(worldDesc);
+      EZ_LOCK(world.GetWriteMarker());
+
+      ezStopwatch sw;
+
+      reader.InstantiatePrefabs(world, transforms, options);
+
+      const ezTime tDiff = sw.Checkpoint();
+      ezTestFramework::Output(ezTestOutput::Duration, "Instantiating %u prefabs batched: %.2fms", uiNumInstances, tDiff.GetMilliseconds());
+
+      EZ_TEST_INT(world.GetObjectCount(), uiNumInstances * 5);
+    }
+  }
+}
@@ -1,6 +1,7 @@
 #include <FoundationTest/FoundationTestPCH.h>
 
 #include <Foundation/Containers/DynamicArray.h>
+#include <Foundation/Time/Stopwatch.h>
 
 namespace
 {
@@ -52,4 +53,125 @@ EZ_CREATE_SIMPLE_TEST(Algorithm, Sorting)
       EZ_TEST_BOOL(a2[i - 1] >= a2[i]);
     }
   }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "FloatToRadixKey")
+  {
+    const float values[] = {-ezMath::Infinity<float>(), -1000.0f, -1.5f, -1.0f, -0.0001f, 0.0f, 0.0001f, 1.0f, 1.5f, 1000.0f, ezMath::Infinity<float>()};
+
+    for (ezUInt32 i = 1; i < EZ_ARRAY_SIZE(values); ++i)
+    {
+      EZ_TEST_BOOL(ezSorting::FloatToRadixKey(values[i - 1]) < ezSorting::FloatToRadixKey(values[i]));
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "RadixSort")
+  {
+    struct Element
+    {
+      EZ_DECLARE_POD_TYPE();
+
+      float m_fValue;
+      ezUInt32 m_uiIndex;
+    };
+
+    ezDynamicArray<Element> elements;
+    ezDynamicArray<Element> scratch;
+
+    for (ezUInt32 i = 0; i < 5000; ++i)
+    {
+      // few distinct values, to check that the sort is stable
+      elements.PushBack({(float)(rand() % 200) - 100.0f, i});
+    }
+
+    scratch.SetCount(elements.GetCount());
+
+    ezSorting::RadixSort(elements.GetArrayPtr(), scratch.GetArrayPtr(), [](const Element& e) { return ezSorting::FloatToRadixKey(e.m_fValue); });
+
+    for (ezUInt32 i = 1; i < elements.GetCount(); ++i)
+    {
+      EZ_TEST_BOOL(elements[i - 1].m_fValue <= elements[i].m_fValue);
+
+      if (elements[i - 1].m_fValue == elements[i].m_fValue)
+      {
+        EZ_TEST_BOOL(elements[i - 1].m_uiIndex < elements[i].m_uiIndex);
+      }
+    }
+
+    // descending
+    ezSorting::RadixSort(elements.GetArrayPtr(), scratch.GetArrayPtr(), [](const Element& e) { return ~ezSorting::FloatToRadixKey(e.m_fValue); });
+
+    for (ezUInt32 i = 1; i < elements.GetCount(); ++i)
+    {
+      EZ_TEST_BOOL(elements[i - 1].m_fValue >= elements[i].m_fValue);
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "RadixSort - Integers")
+  {
+    ezDynamicArray<ezUInt32> a2;
+    ezDynamicArray<ezUInt32> scratch;
+
+    for (ezUInt32 i = 0; i < a1.GetCount(); ++i)
+    {
+      a2.PushBack(static_cast<ezUInt32>(a1[i]) * 40000u);
+    }
+
+    a2.PushBack(0);
+    a2.PushBack(0xFFFFFFFFu);
+
+    scratch.SetCount(a2.GetCount());
+
+    ezSorting::RadixSort(a2.GetArrayPtr(), scratch.GetArrayPtr(), [](ezUInt32 i) { return i; });
+
+    for (ezUInt32 i = 1; i < a2.GetCount(); ++i)
+    {
+      EZ_TEST_BOOL(a2[i - 1] <= a2[i]);
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::DisabledNoWarning, "RadixSort - Performance")
+  {
+    // same layout as the sort data of blended particles: distance and index
+    struct Element
+    {
+      EZ_DECLARE_POD_TYPE();
+
+      float m_fValue;
+      ezUInt32 m_uiIndex;
+    };
+
+    for (ezUInt32 uiNumElements : {10000u, 100000u})
+    {
+      ezDynamicArray<Element> source;
+      source.SetCountUninitialized(uiNumElements);
+
+      for (ezUInt32 i = 0; i < uiNumElements; ++i)
+      {
+        source[i] = {(float)rand() / (float)RAND_MAX * 1000.0f, i};
+      }
+
+      ezDynamicArray<Element> elements;
+      ezDynamicArray<Element> scratch;
+      scratch.SetCountUninitialized(uiNumElements);
+
+      constexpr ezUInt32 uiNumRuns = 20;
+
+      ezStopwatch sw;
+      for (ezUInt32 r = 0; r < uiNumRuns; ++r)
+      {
+        elements = source;
+        ezSorting::QuickSort(elements, [](const Element& a, const Element& b) { return a.m_fValue > b.m_fValue; });
+      }
+      const ezTime tQuickSort = sw.Checkpoint() / uiNumRuns;
+
+      for (ezUInt32 r = 0; r < uiNumRuns; ++r)
+      {
+        elements = source;
+        ezSorting::RadixSort(elements.GetArrayPtr(), scratch.GetArrayPtr(), [](const Element& e) { return ~ezSorting::FloatToRadixKey(e.m_fValue); });
+      }
+      const ezTime tRadixSort = sw.Checkpoint() / uiNumRuns;
+
+      ezTestFramework::Output(ezTestOutput::Duration, "Sorting %u elements: QuickSort %.3fms, RadixSort %.3fms", uiNumElements, tQuickSort.GetMilliseconds(), tRadixSort.GetMilliseconds());
+    }
+  }
 }
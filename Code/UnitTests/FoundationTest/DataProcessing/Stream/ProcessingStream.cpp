@@ -6,6 +6,8 @@
 #include <Foundation/DataProcessing/Stream/ProcessingStreamIterator.h>
 #include <Foundation/DataProcessing/Stream/ProcessingStreamProcessor.h>
 #include <Foundation/Reflection/Reflection.h>
+#include <Foundation/SimdMath/SimdVec4f.h>
+#include <Foundation/Time/Stopwatch.h>
 
 EZ_CREATE_SIMPLE_TEST_GROUP(DataProcessing);
 
@@ -22,6 +24,7 @@ public:
   }
 
   void SetStreamName(ezHashedString StreamName) { m_StreamName = StreamName; }
+  void SetParallel(bool bParallel) { m_bParallel = bParallel; }
 
 protected:
   virtual ezResult UpdateStreamBindings() override
@@ -33,9 +36,13 @@ protected:
 
   virtual void InitializeElements(ezUInt64 uiStartIndex, ezUInt64 uiNumElements) override {}
 
-  virtual void Process(ezUInt64 uiNumElements) override
+  virtual void Process(ezUInt64 uiNumElements) override { ProcessRange(0, uiNumElements); }
+
+  virtual bool SupportsParallelProcessing() const override { return m_bParallel; }
+
+  virtual void ProcessRange(ezUInt64 uiStartIndex, ezUInt64 uiNumElements) override
   {
-    ezProcessingStreamIterator<float> streamIterator(m_pStream, uiNumElements, 0);
+    ezProcessingStreamIterator<float> streamIterator(m_pStream, uiNumElements, uiStartIndex);
 
     while (!streamIterator.HasReachedEnd())
     {
@@ -47,11 +54,101 @@ protected:
 
   ezHashedString m_StreamName;
   ezProcessingStream* m_pStream;
+  bool m_bParallel = false;
+};
+
+// Multiply processor, never runs in parallel
+
+class DoubleStreamProcessor : public ezProcessingStreamProcessor
+{
+  EZ_ADD_DYNAMIC_REFLECTION(DoubleStreamProcessor, ezProcessingStreamProcessor);
+
+public:
+  void SetStreamName(ezHashedString StreamName) { m_StreamName = StreamName; }
+
+protected:
+  virtual ezResult UpdateStreamBindings() override
+  {
+    m_pStream = m_pStreamGroup->GetStreamByName(m_StreamName);
+
+    return m_pStream ? EZ_SUCCESS : EZ_FAILURE;
+  }
+
+  virtual void InitializeElements(ezUInt64 uiStartIndex, ezUInt64 uiNumElements) override {}
+
+  virtual void Process(ezUInt64 uiNumElements) override
+  {
+    ezProcessingStreamIterator<float> streamIterator(m_pStream, uiNumElements, 0);
+
+    while (!streamIterator.HasReachedEnd())
+    {
+      streamIterator.Current() *= 2.0f;
+
+      streamIterator.Advance();
+    }
+  }
+
+  ezHashedString m_StreamName;
+  ezProcessingStream* m_pStream = nullptr;
+};
+
+// Integrates a velocity stream into a position stream, same as a typical particle behavior
+
+class IntegrateStreamProcessor : public ezProcessingStreamProcessor
+{
+  EZ_ADD_DYNAMIC_REFLECTION(IntegrateStreamProcessor, ezProcessingStreamProcessor);
+
+public:
+  bool m_bParallel = false;
+
+protected:
+  virtual ezResult UpdateStreamBindings() override
+  {
+    m_pPosition = m_pStreamGroup->GetStreamByName("Position");
+    m_pVelocity = m_pStreamGroup->GetStreamByName("Velocity");
+
+    return (m_pPosition && m_pVelocity) ? EZ_SUCCESS : EZ_FAILURE;
+  }
+
+  virtual void InitializeElements(ezUInt64 uiStartIndex, ezUInt64 uiNumElements) override {}
+
+  virtual void Process(ezUInt64 uiNumElements) override { ProcessRange(0, uiNumElements); }
+
+  virtual bool SupportsParallelProcessing() const override { return m_bParallel; }
+
+  virtual void ProcessRange(ezUInt64 uiStartIndex, ezUInt64 uiNumElements) override
+  {
+    const ezSimdFloat fDamping = 0.99f;
+    const ezSimdFloat tDiff = 1.0f / 60.0f;
+    const ezSimdVec4f vGravity(0.0f, 0.0f, -10.0f / 60.0f, 0.0f);
+
+    ezProcessingStreamIterator<ezSimdVec4f> itPosition(m_pPosition, uiNumElements, uiStartIndex);
+    ezProcessingStreamIterator<ezSimdVec4f> itVelocity(m_pVelocity, uiNumElements, uiStartIndex);
+
+    while (!itPosition.HasReachedEnd())
+    {
+      ezSimdVec4f& vel = itVelocity.Current();
+      vel = vel * fDamping + vGravity;
+      itPosition.Current() += vel * tDiff;
+
+      itPosition.Advance();
+      itVelocity.Advance();
+    }
+  }
+
+  ezProcessingStream* m_pPosition = nullptr;
+  ezProcessingStream* m_pVelocity = nullptr;
 };
 
+EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(IntegrateStreamProcessor, 1, ezRTTIDefaultAllocator<IntegrateStreamProcessor>)
+EZ_END_DYNAMIC_REFLECTED_TYPE;
+
 EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(AddOneStreamProcessor, 1, ezRTTIDefaultAllocator<AddOneStreamProcessor>)
 EZ_END_DYNAMIC_REFLECTED_TYPE;
 
+EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(DoubleStreamProcessor, 1, ezRTTIDefaultAllocator<DoubleStreamProcessor>)
+EZ_END_DYNAMIC_REFLECTED_TYPE;
+
 EZ_CREATE_SIMPLE_TEST(DataProcessing, ProcessingStream)
 {
   ezProcessingStreamGroup Group;
@@ -157,3 +254,115 @@ EZ_CREATE_SIMPLE_TEST(DataProcessing, ProcessingStream)
     }
   }
 }
+
+EZ_CREATE_SIMPLE_TEST(DataProcessing, ParallelProcessing)
+{
+  constexpr ezUInt32 uiNumElements = 100 * 1000;
+
+  ezProcessingStreamGroup Group;
+  ezProcessingStream* pStream = Group.AddStream("Stream1", ezProcessingStream::DataType::Float);
+
+  ezProcessingStreamSpawnerZeroInitialized* pSpawner = EZ_DEFAULT_NEW(ezProcessingStreamSpawnerZeroInitialized);
+  pSpawner->SetStreamName(pStream->GetName());
+  Group.AddProcessor(pSpawner);
+
+  // two parallel processors, followed by a serial one and another parallel one
+  // the result is only correct, if the parallel runs are executed in the right order relative to the serial processor
+  AddOneStreamProcessor* pAdd[3];
+  for (ezUInt32 i = 0; i < 3; ++i)
+  {
+    pAdd[i] = EZ_DEFAULT_NEW(AddOneStreamProcessor);
+    pAdd[i]->SetStreamName(pStream->GetName());
+    pAdd[i]->SetParallel(true);
+    pAdd[i]->m_fPriority = (i < 2) ? 0.0f : 2.0f;
+  }
+
+  DoubleStreamProcessor* pDouble = EZ_DEFAULT_NEW(DoubleStreamProcessor);
+  pDouble->SetStreamName(pStream->GetName());
+  pDouble->m_fPriority = 1.0f;
+
+  Group.AddProcessor(pAdd[0]);
+  Group.AddProcessor(pAdd[1]);
+  Group.AddProcessor(pDouble);
+  Group.AddProcessor(pAdd[2]);
+
+  Group.SetSize(uiNumElements);
+  Group.InitializeElements(uiNumElements);
+
+  // spawns the elements at the end
+  Group.Process();
+  EZ_TEST_INT(Group.GetNumActiveElements(), uiNumElements);
+
+  auto CheckValues = [&](float fExpected) {
+    const float* pData = pStream->GetData<float>();
+    ezUInt32 uiNumWrong = 0;
+
+    for (ezUInt32 i = 0; i < uiNumElements; ++i)
+    {
+      if (pData[i] != fExpected)
+        ++uiNumWrong;
+    }
+
+    EZ_TEST_INT(uiNumWrong, 0);
+  };
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Serial")
+  {
+    Group.SetParallelProcessing(uiNumElements + 1, 1024);
+
+    Group.Process();
+    CheckValues((0.0f + 2.0f) * 2.0f + 1.0f);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Parallel")
+  {
+    Group.SetParallelProcessing(1, 1024);
+
+    Group.Process();
+    CheckValues((5.0f + 2.0f) * 2.0f + 1.0f);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Remove Elements")
+  {
+    Group.RemoveElement(0);
+    Group.Process();
+
+    EZ_TEST_INT(Group.GetNumActiveElements(), uiNumElements - 1);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::DisabledNoWarning, "Performance")
+  {
+    for (ezUInt32 uiNumParticles : {10000u, 100000u, 1000000u})
+    {
+      ezProcessingStreamGroup Group2;
+      Group2.AddStream("Position", ezProcessingStream::DataType::Float4);
+      Group2.AddStream("Velocity", ezProcessingStream::DataType::Float4);
+
+      IntegrateStreamProcessor* pIntegrate = EZ_DEFAULT_NEW(IntegrateStreamProcessor);
+      Group2.AddProcessor(pIntegrate);
+
+      Group2.SetSize(uiNumParticles);
+      Group2.InitializeElements(uiNumParticles);
+      Group2.Process();
+
+      for (bool bParallel : {false, true})
+      {
+        pIntegrate->m_bParallel = bParallel;
+        Group2.SetParallelProcessing(bParallel ? 16 * 1024 : uiNumParticles + 1, 4 * 1024);
+
+        constexpr ezUInt32 uiNumFrames = 100;
+        ezStopwatch sw;
+
+        for (ezUInt32 i = 0; i < uiNumFrames; ++i)
+        {
+          Group2.Process();
+        }
+
+        const double fMilliseconds = sw.GetRunningTotal().GetMilliseconds() / uiNumFrames;
+
+        ezTestFramework::Output(ezTestOutput::Duration, "%u particles, %s: %.3fms per frame, %.0f particles/ms", uiNumParticles,
+          bParallel ? "parallel" : "serial", fMilliseconds, uiNumParticles / ezMath::Max(fMilliseconds, 0.001));
+      }
+    }
+  }
+}
@@ -0,0 +1,307 @@
+#include <FoundationTest/FoundationTestPCH.h>
+
+// NOTE: always save as Unicode UTF-8 with signature
+
+#include <Foundation/IO/JSONDocument.h>
+#include <Foundation/IO/JSONReader.h>
+#include <Foundation/IO/MemoryStream.h>
+#include <Foundation/Time/Stopwatch.h>
+
+namespace
+{
+  void GenerateDocument(ezUInt32 uiTargetSize, ezStringBuilder& out_sText)
+  {
+    out_sText.Clear();
+    out_sText.Append("{\n  \"name\": \"generated\",\n  \"items\": [\n");
+
+    ezStringBuilder sItem;
+    for (ezUInt32 i = 0; out_sText.GetElementCount() < uiTargetSize; ++i)
+    {
+      sItem.Format("    {{ \"id\": {0}, \"name\": \"Item number {0} with a somewhat longer name\", \"position\": [{1}, {2}, -{3}.5e-2], \"enabled\": {4}, \"parent\": null, \"tags\": [\"first\", \"se\\\"cond\"] }},\n", i, i * 0.25, i % 100, i % 7, (i % 2) == 0 ? "true" : "false");
+      out_sText.Append(sItem.GetView());
+    }
+
+    out_sText.Append("    {}\n  ]\n}\n");
+  }
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST(IO, JSONDocument)
+{
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Values")
+  {
+    const char* szText = R"(
+// a comment
+{
+  "null": null, /* another comment */
+  "bool1": true,
+  "bool2": false,
+  "int": -42,
+  "zero": 0,
+  "large": 1234567890123456789,
+  "float": 3.5,
+  "exp": -1.25E2,
+  "string": "Hello World",
+  "empty": "",
+  "object": { "a": 1, "b": [2, 3] },
+  "array": [1, "two", [], {}, null]
+}
+)";
+
+    ezJSONDocument doc;
+    EZ_TEST_BOOL(doc.Parse(szText).Succeeded());
+
+    const ezJSONDocument::Value root = doc.GetRoot();
+    EZ_TEST_BOOL(root.IsObject());
+    EZ_TEST_INT(root.GetCount(), 13);
+
+    EZ_TEST_BOOL(root.FindMember("null").IsNull());
+    EZ_TEST_BOOL(root.FindMember("bool1").GetBool(false) == true);
+    EZ_TEST_BOOL(root.FindMember("bool2").GetBool(true) == false);
+
+    EZ_TEST_BOOL(root.FindMember("int").IsInteger());
+    EZ_TEST_INT(root.FindMember("int").GetInt64(), -42);
+    EZ_TEST_DOUBLE(root.FindMember("int").GetDouble(), -42.0, 0.0);
+    EZ_TEST_INT(root.FindMember("zero").GetInt64(1), 0);
+    EZ_TEST_BOOL(root.FindMember("large").GetInt64() == 1234567890123456789ll);
+
+    EZ_TEST_BOOL(!root.FindMember("float").IsInteger());
+    EZ_TEST_DOUBLE(root.FindMember("float").GetDouble(), 3.5, 0.0);
+    EZ_TEST_INT(root.FindMember("float").GetInt64(), 3);
+    EZ_TEST_DOUBLE(root.FindMember("exp").GetDouble(), -125.0, 0.0);
+    EZ_TEST_STRING(ezString(root.FindMember("exp").GetRawString()), "-1.25E2");
+
+    ezStringBuilder sTemp;
+    EZ_TEST_STRING(ezString(root.FindMember("string").GetString(sTemp)), "Hello World");
+    EZ_TEST_BOOL(!root.FindMember("string").HasEscapeSequences());
+    EZ_TEST_BOOL(root.FindMember("empty").IsString());
+    EZ_TEST_BOOL(root.FindMember("empty").GetString(sTemp).IsEmpty());
+
+    // accessing values with the wrong type returns the fallback
+    EZ_TEST_INT(root.FindMember("string").GetInt64(7), 7);
+    EZ_TEST_DOUBLE(root.FindMember("bool1").GetDouble(2.0), 2.0, 0.0);
+    EZ_TEST_BOOL(root.FindMember("int").GetBool(true));
+    EZ_TEST_INT(root.FindMember("int").GetCount(), 0);
+
+    // missing members
+    EZ_TEST_BOOL(!root.FindMember("missing").IsValid());
+    EZ_TEST_BOOL(!root.FindMember("missing").FindMember("a").IsValid());
+    EZ_TEST_BOOL(!root.FindMember("array").FindMember("a").IsValid());
+
+    const ezJSONDocument::Value object = root.FindMember("object");
+    EZ_TEST_INT(object.GetCount(), 2);
+    EZ_TEST_INT(object.FindMember("a").GetInt64(), 1);
+    EZ_TEST_INT(object.FindMember("b").GetCount(), 2);
+    EZ_TEST_INT(object.FindMember("b").GetElement(1).GetInt64(), 3);
+    EZ_TEST_BOOL(!object.FindMember("b").GetElement(2).IsValid());
+
+    const ezJSONDocument::Value array = root.FindMember("array");
+    EZ_TEST_INT(array.GetCount(), 5);
+    EZ_TEST_BOOL(array.GetElement(0).IsNumber());
+    EZ_TEST_STRING(ezString(array.GetElement(1).GetString(sTemp)), "two");
+    EZ_TEST_BOOL(array.GetElement(2).IsArray());
+    EZ_TEST_INT(array.GetElement(2).GetCount(), 0);
+    EZ_TEST_BOOL(!array.GetElement(2).GetFirstChild().IsValid());
+    EZ_TEST_BOOL(array.GetElement(3).IsObject());
+    EZ_TEST_BOOL(array.GetElement(4).IsNull());
+    EZ_TEST_BOOL(!array.GetElement(0).GetMemberName().IsValid());
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Iteration")
+  {
+    const char* szText = R"({ "a": { "x": [1, 2, { "y": 3 }] }, "b": [[], [4]], "c": "end" })";
+
+    ezJSONDocument doc;
+    EZ_TEST_BOOL(doc.Parse(szText).Succeeded());
+
+    // the root, 3 member names, 8 values in "a", 4 in "b" and 1 in "c"
+    EZ_TEST_INT(doc.GetNumValues(), 1 + 3 + 8 + 4 + 1);
+
+    const char* szNames[] = {"a", "b", "c"};
+    ezUInt32 uiMember = 0;
+
+    ezStringBuilder sTemp;
+    for (auto member = doc.GetRoot().GetFirstChild(); member.IsValid(); member = member.GetNextSibling())
+    {
+      EZ_TEST_STRING(ezString(member.GetMemberName().GetString(sTemp)), szNames[uiMember]);
+      ++uiMember;
+    }
+
+    EZ_TEST_INT(uiMember, 3);
+
+    const auto x = doc.GetRoot().FindMember("a").FindMember("x");
+    ezUInt32 uiElement = 0;
+    for (auto element = x.GetFirstChild(); element.IsValid(); element = element.GetNextSibling())
+    {
+      ++uiElement;
+    }
+
+    EZ_TEST_INT(uiElement, 3);
+    EZ_TEST_INT(x.GetElement(2).FindMember("y").GetInt64(), 3);
+    EZ_TEST_BOOL(!x.GetElement(2).FindMember("y").GetNextSibling().IsValid());
+    EZ_TEST_INT(doc.GetRoot().FindMember("b").GetElement(1).GetElement(0).GetInt64(), 4);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Top level values")
+  {
+    ezJSONDocument doc;
+
+    EZ_TEST_BOOL(doc.Parse("  [1, 2]  ").Succeeded());
+    EZ_TEST_INT(doc.GetRoot().GetCount(), 2);
+
+    EZ_TEST_BOOL(doc.Parse("\"text\"").Succeeded());
+    EZ_TEST_STRING(ezString(doc.GetRoot().GetRawString()), "text");
+
+    EZ_TEST_BOOL(doc.Parse("12.5").Succeeded());
+    EZ_TEST_DOUBLE(doc.GetRoot().GetDouble(), 12.5, 0.0);
+    EZ_TEST_BOOL(!doc.GetRoot().GetNextSibling().IsValid());
+
+    EZ_TEST_BOOL(doc.Parse("  // nothing\n  ").Succeeded());
+    EZ_TEST_BOOL(!doc.GetRoot().IsValid());
+
+    doc.Clear();
+    EZ_TEST_BOOL(!doc.GetRoot().IsValid());
+    EZ_TEST_INT(doc.GetNumValues(), 0);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Escape sequences")
+  {
+    // long enough that the escape sequences are found by the vectorized search
+    const char* szText = R"(["quote \" backslash \\ slash \/ controls \b\f\n\r\t end", "\u00e4\u00F6\u00fc \u20AC \ud83d\ude00", "long text without any escape sequences, just to have more than 16 characters in a row"])";
+
+    ezJSONDocument doc;
+    EZ_TEST_BOOL(doc.Parse(szText).Succeeded());
+
+    ezStringBuilder sTemp;
+
+    EZ_TEST_BOOL(doc.GetRoot().GetElement(0).HasEscapeSequences());
+    EZ_TEST_STRING(ezString(doc.GetRoot().GetElement(0).GetString(sTemp)), "quote \" backslash \\ slash / controls \b\f\n\r\t end");
+    EZ_TEST_STRING(ezString(doc.GetRoot().GetElement(1).GetString(sTemp)), u8"äöü € \U0001F600");
+    EZ_TEST_BOOL(!doc.GetRoot().GetElement(2).HasEscapeSequences());
+    EZ_TEST_STRING(ezString(doc.GetRoot().GetElement(2).GetString(sTemp)), "long text without any escape sequences, just to have more than 16 characters in a row");
+
+    EZ_TEST_BOOL(doc.Parse(R"({ "esc\"aped": 1 })").Succeeded());
+    EZ_TEST_INT(doc.GetRoot().FindMember("esc\"aped").GetInt64(), 1);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Integer range")
+  {
+    const char* szText = R"([9223372036854775807, -9223372036854775808, 12345678901234567890, -12345678901234567890, 1e30, -1e30, 2.5e18])";
+
+    ezJSONDocument doc;
+    EZ_TEST_BOOL(doc.Parse(szText).Succeeded());
+
+    const ezJSONDocument::Value root = doc.GetRoot();
+    EZ_TEST_BOOL(root.GetElement(0).GetInt64() == ezMath::MaxValue<ezInt64>());
+    EZ_TEST_BOOL(root.GetElement(1).GetInt64() == ezMath::MinValue<ezInt64>());
+    EZ_TEST_BOOL(root.GetElement(2).GetInt64() == ezMath::MaxValue<ezInt64>());
+    EZ_TEST_BOOL(root.GetElement(3).GetInt64() == ezMath::MinValue<ezInt64>());
+    EZ_TEST_BOOL(root.GetElement(4).GetInt64() == ezMath::MaxValue<ezInt64>());
+    EZ_TEST_BOOL(root.GetElement(5).GetInt64() == ezMath::MinValue<ezInt64>());
+    EZ_TEST_BOOL(root.GetElement(6).GetInt64() == 2500000000000000000ll);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Invalid documents")
+  {
+    const char* szInvalid[] = {
+      "{",
+      "[1, 2",
+      "[1, 2,]",
+      "{ \"a\": 1, }",
+      "{ \"a\" 1 }",
+      "{ a: 1 }",
+      "{ \"a\": 1 ] ",
+      "[1] [2]",
+      "[01]",
+      "[-]",
+      "[1.]",
+      "[1e]",
+      "[.5]",
+      "[tru]",
+      "[nul]",
+      "[True]",
+      "[\"unterminated]",
+      "[\"bad escape \\x\"]",
+      "[\"bad unicode \\u12G4\"]",
+      "[\"short unicode \\u12\"]",
+      "[\"raw\nnewline\"]",
+      "[\"a raw tab after more than sixteen characters\t\"]",
+      "/* unterminated comment",
+      "[1] /",
+    };
+
+    ezJSONDocument doc;
+    ezMuteLog log;
+
+    for (const char* szText : szInvalid)
+    {
+      EZ_TEST_BOOL_MSG(doc.Parse(szText, &log).Failed(), "%s", szText);
+      EZ_TEST_BOOL(!doc.GetRoot().IsValid());
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Stream and ConvertToVariant")
+  {
+    ezStringBuilder sText;
+    GenerateDocument(16 * 1024, sText);
+
+    ezRawMemoryStreamReader reader1(sText.GetData(), sText.GetElementCount());
+    ezJSONDocument doc;
+    EZ_TEST_BOOL(doc.Parse(reader1).Succeeded());
+
+    ezRawMemoryStreamReader reader2(sText.GetData(), sText.GetElementCount());
+    ezJSONReader jsonReader;
+    EZ_TEST_BOOL(jsonReader.Parse(reader2).Succeeded());
+
+    const ezVariant result = doc.GetRoot().ConvertToVariant();
+    EZ_TEST_BOOL(result.IsA<ezVariantDictionary>());
+    EZ_TEST_BOOL(result == ezVariant(jsonReader.GetTopLevelObject()));
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Performance")
+  {
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEBUG)
+    const ezUInt32 uiSize = 8 * 1024 * 1024;
+#else
+    const ezUInt32 uiSize = 128 * 1024 * 1024;
+#endif
+
+    ezStringBuilder sText;
+    GenerateDocument(uiSize, sText);
+
+    const double fMegaBytes = sText.GetElementCount() / (1024.0 * 1024.0);
+
+    ezJSONDocument doc;
+
+    ezStopwatch sw;
+    EZ_TEST_BOOL(doc.Parse(sText).Succeeded());
+    const ezTime tParse = sw.Checkpoint();
+
+    // touch every item, like a loader would
+    double fSum = 0.0;
+    for (auto item = doc.GetRoot().FindMember("items").GetFirstChild(); item.IsValid(); item = item.GetNextSibling())
+    {
+      fSum += item.FindMember("position").GetElement(0).GetDouble();
+    }
+
+    const ezTime tAccess = sw.Checkpoint();
+    EZ_TEST_BOOL(fSum > 0.0);
+
+    ezTestFramework::Output(ezTestOutput::Duration, "ezJSONDocument: %.1f MB, %u values, parsed in %.2fms (%.0f MB/s), accessed in %.2fms", fMegaBytes, doc.GetNumValues(), tParse.GetMilliseconds(), fMegaBytes / tParse.GetSeconds(), tAccess.GetMilliseconds());
+
+    // ezJSONReader is much slower, only compare with a part of the document
+    GenerateDocument(uiSize / 16, sText);
+    const double fReaderMegaBytes = sText.GetElementCount() / (1024.0 * 1024.0);
+
+    sw.StopAndReset();
+    sw.Resume();
+    EZ_TEST_BOOL(doc.Parse(sText).Succeeded());
+    const ezTime tDocument = sw.Checkpoint();
+
+    ezRawMemoryStreamReader reader(sText.GetData(), sText.GetElementCount());
+    ezJSONReader jsonReader;
+    EZ_TEST_BOOL(jsonReader.Parse(reader).Succeeded());
+    const ezTime tReader = sw.Checkpoint();
+
+    ezTestFramework::Output(ezTestOutput::Duration, "%.1f MB: ezJSONDocument %.2fms (%.0f MB/s), ezJSONReader %.2fms (%.0f MB/s)", fReaderMegaBytes, tDocument.GetMilliseconds(), fReaderMegaBytes / tDocument.GetSeconds(), tReader.GetMilliseconds(), fReaderMegaBytes / tReader.GetSeconds());
+  }
+}
@@ -2,7 +2,12 @@
 
 #include <Foundation/Memory/CommonAllocators.h>
 #include <Foundation/Memory/LargeBlockAllocator.h>
+#include <Foundation/Memory/PageAllocator.h>
+#include <Foundation/Memory/Policies/AlignedAllocation.h>
+#include <Foundation/Memory/Policies/ProxyAllocation.h>
 #include <Foundation/Memory/StackAllocator.h>
+#include <Foundation/Threading/TaskSystem.h>
+#include <Foundation/Time/Stopwatch.h>
 
 struct EZ_ALIGN(NonAlignedVector, EZ_ALIGNMENT_MINIMUM)
 {
@@ -241,3 +246,308 @@ EZ_CREATE_SIMPLE_TEST(Memory, Allocator)
     EZ_TEST_BOOL(ezConstructionCounter::HasDestructed(50));
   }
 }
+
+namespace
+{
+  using TrackedTestAllocator = ezAllocator<ezMemoryPolicies::ezHeapAllocation, ezMemoryTrackingFlags::RegisterAllocator | ezMemoryTrackingFlags::EnableAllocationTracking>;
+  using StackTracedTestAllocator = ezAllocator<ezMemoryPolicies::ezHeapAllocation, ezMemoryTrackingFlags::All>;
+  using UntrackedTestAllocator = ezAllocator<ezMemoryPolicies::ezHeapAllocation, ezMemoryTrackingFlags::None>;
+
+  /// Allocates and frees small blocks from many tasks at once and returns the duration.
+  ezTime AllocateInParallel(ezAllocatorBase* pAllocator, ezUInt32 uiNumTasks, ezUInt32 uiAllocationsPerTask)
+  {
+    ezStopwatch sw;
+
+    ezTaskSystem::ParallelForIndexed(
+      0, uiNumTasks,
+      [pAllocator, uiAllocationsPerTask](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) {
+        void* allocations[16];
+
+        for (ezUInt32 uiTask = uiStartIndex; uiTask < uiEndIndex; ++uiTask)
+        {
+          for (ezUInt32 i = 0; i < uiAllocationsPerTask; i += EZ_ARRAY_SIZE(allocations))
+          {
+            for (ezUInt32 j = 0; j < EZ_ARRAY_SIZE(allocations); ++j)
+            {
+              allocations[j] = pAllocator->Allocate(16 + ((i + j) % 16) * 16, 8);
+            }
+
+            for (ezUInt32 j = 0; j < EZ_ARRAY_SIZE(allocations); ++j)
+            {
+              pAllocator->Deallocate(allocations[j]);
+            }
+          }
+        }
+      },
+      "AllocateInParallel");
+
+    return sw.GetRunningTotal();
+  }
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST(Memory, MemoryTracker)
+{
+  const ezMemoryTracker::TrackingSettings defaultSettings = ezMemoryTracker::GetTrackingSettings();
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Parallel Tracking")
+  {
+    TrackedTestAllocator allocator("TrackedTestAllocator", nullptr);
+
+    const ezUInt32 uiNumTasks = 64;
+    const ezUInt32 uiAllocationsPerTask = 1024;
+    AllocateInParallel(&allocator, uiNumTasks, uiAllocationsPerTask);
+
+    ezAllocatorBase::Stats stats = allocator.GetStats();
+    EZ_TEST_INT(stats.m_uiNumAllocations, uiNumTasks * uiAllocationsPerTask);
+    EZ_TEST_INT(stats.m_uiNumDeallocations, uiNumTasks * uiAllocationsPerTask);
+    EZ_TEST_INT(stats.m_uiAllocationSize, 0);
+
+    void* pMem = allocator.Allocate(100, 8);
+    EZ_TEST_INT(allocator.AllocatedSize(pMem), 100);
+
+    stats = allocator.GetStats();
+    EZ_TEST_INT(stats.m_uiAllocationSize, 100);
+    EZ_TEST_INT(stats.m_uiNumAllocations - stats.m_uiNumDeallocations, 1);
+
+    allocator.Deallocate(pMem);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Sampling")
+  {
+    ezMemoryTracker::TrackingSettings settings;
+    settings.m_uiSampleInterval = 4;
+    settings.m_uiAlwaysSampledSize = 1024;
+    settings.m_bMeasureAllocationTime = false;
+    ezMemoryTracker::SetTrackingSettings(settings);
+
+    {
+      StackTracedTestAllocator allocator("SampledTestAllocator", nullptr);
+
+      void* smallAllocations[16];
+      for (ezUInt32 i = 0; i < EZ_ARRAY_SIZE(smallAllocations); ++i)
+      {
+        smallAllocations[i] = allocator.Allocate(32, 8);
+      }
+
+      void* pLarge = allocator.Allocate(2048, 8);
+
+      // sampling only skips stack traces, sizes are known for every allocation
+      EZ_TEST_INT(allocator.AllocatedSize(pLarge), 2048);
+      for (ezUInt32 i = 0; i < EZ_ARRAY_SIZE(smallAllocations); ++i)
+      {
+        EZ_TEST_INT(allocator.AllocatedSize(smallAllocations[i]), 32);
+      }
+
+      ezAllocatorBase::Stats stats = allocator.GetStats();
+      EZ_TEST_INT(stats.m_uiNumAllocations, 17);
+      EZ_TEST_INT(stats.m_uiAllocationSize, 2048 + 16 * 32);
+      EZ_TEST_BOOL(stats.m_PerFrameAllocationTime.IsZero());
+
+      // policies that rely on the allocated size of the parent allocator work for unsampled allocations as well
+      {
+        ezAllocator<ezMemoryPolicies::ezAlignedAllocation<ezMemoryPolicies::ezProxyAllocation>, ezMemoryTrackingFlags::None> alignedAllocator("SampledAlignedTestAllocator", &allocator);
+
+        for (ezUInt32 i = 0; i < 8; ++i)
+        {
+          void* pAligned = alignedAllocator.Allocate(48, 64);
+          EZ_TEST_BOOL(ezMemoryUtils::IsAligned(pAligned, 64));
+          EZ_TEST_INT(alignedAllocator.AllocatedSize(pAligned), 48);
+          alignedAllocator.Deallocate(pAligned);
+        }
+      }
+
+      for (ezUInt32 i = 0; i < EZ_ARRAY_SIZE(smallAllocations); ++i)
+      {
+        allocator.Deallocate(smallAllocations[i]);
+      }
+      allocator.Deallocate(pLarge);
+
+      // 16 small, 1 large and 8 aligned allocations
+      stats = allocator.GetStats();
+      EZ_TEST_INT(stats.m_uiNumDeallocations, 25);
+      EZ_TEST_INT(stats.m_uiAllocationSize, 0);
+    }
+
+    ezMemoryTracker::SetTrackingSettings(defaultSettings);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::DisabledNoWarning, "Parallel Allocation Performance")
+  {
+    const ezUInt32 uiNumTasks = 256;
+    const ezUInt32 uiAllocationsPerTask = 16 * 1024;
+    const double fNumAllocations = uiNumTasks * uiAllocationsPerTask;
+
+    auto Measure = [&](ezAllocatorBase* pAllocator, const char* szName) {
+      const ezTime t = AllocateInParallel(pAllocator, uiNumTasks, uiAllocationsPerTask);
+      ezTestFramework::Output(ezTestOutput::Duration, "%s: %.0f allocations/ms", szName, fNumAllocations / t.GetMilliseconds());
+    };
+
+    {
+      UntrackedTestAllocator allocator("UntrackedTestAllocator", nullptr);
+      Measure(&allocator, "Untracked");
+    }
+
+    {
+      TrackedTestAllocator allocator("TrackedTestAllocator", nullptr);
+      Measure(&allocator, "Tracked");
+    }
+
+    {
+      ezMemoryTracker::TrackingSettings settings;
+      settings.m_bMeasureAllocationTime = false;
+      ezMemoryTracker::SetTrackingSettings(settings);
+
+      TrackedTestAllocator allocator("TrackedTestAllocator", nullptr);
+      Measure(&allocator, "Tracked without timing");
+    }
+
+    {
+      StackTracedTestAllocator allocator("StackTracedTestAllocator", nullptr);
+      Measure(&allocator, "Tracked with stack traces, without timing");
+    }
+
+    {
+      ezMemoryTracker::TrackingSettings settings;
+      settings.m_uiSampleInterval = 64;
+      settings.m_bMeasureAllocationTime = false;
+      ezMemoryTracker::SetTrackingSettings(settings);
+
+      StackTracedTestAllocator allocator("SampledTestAllocator", nullptr);
+      Measure(&allocator, "Tracked with stack traces, 1 in 64 sampled");
+    }
+
+    ezMemoryTracker::SetTrackingSettings(defaultSettings);
+  }
+}
+
+EZ_CREATE_SIMPLE_TEST(Memory, ThreadCachingAllocator)
+{
+  using TrackedThreadCachingTestAllocator = ezAllocator<ezMemoryPolicies::ezThreadCachingAllocation, ezMemoryTrackingFlags::RegisterAllocator | ezMemoryTrackingFlags::EnableAllocationTracking>;
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Sizes and Alignment")
+  {
+    TrackedThreadCachingTestAllocator allocator("ThreadCachingTestAllocator", nullptr);
+
+    const size_t sizes[] = {1, 8, 16, 17, 100, 128, 129, 1000, 4096, 8192, 8193, 100000};
+    const size_t alignments[] = {8, 16, 32, 64, 128, 4096};
+
+    ezDynamicArray<ezArrayPtr<ezUInt8>> allocations;
+    for (size_t uiSize : sizes)
+    {
+      for (size_t uiAlign : alignments)
+      {
+        ezUInt8* pMem = static_cast<ezUInt8*>(allocator.Allocate(uiSize, uiAlign));
+        EZ_TEST_BOOL(ezMemoryUtils::IsAligned(pMem, uiAlign));
+
+        ezMemoryUtils::PatternFill(pMem, static_cast<ezUInt8>(allocations.GetCount()), static_cast<ezUInt32>(uiSize));
+        allocations.PushBack(ezArrayPtr<ezUInt8>(pMem, static_cast<ezUInt32>(uiSize)));
+      }
+    }
+
+    // no allocation may overlap with another one
+    for (ezUInt32 i = 0; i < allocations.GetCount(); ++i)
+    {
+      bool bPatternIntact = true;
+      for (ezUInt8 value : allocations[i])
+      {
+        bPatternIntact &= (value == static_cast<ezUInt8>(i));
+      }
+      EZ_TEST_BOOL(bPatternIntact);
+    }
+
+    ezAllocatorBase::Stats stats = allocator.GetStats();
+    EZ_TEST_INT(stats.m_uiNumAllocations - stats.m_uiNumDeallocations, allocations.GetCount());
+    EZ_TEST_BOOL(stats.m_uiReservedSize >= stats.m_uiAllocationSize + stats.m_uiCachedSize);
+
+    for (auto allocation : allocations)
+    {
+      allocator.Deallocate(allocation.GetPtr());
+    }
+
+    stats = allocator.GetStats();
+    EZ_TEST_INT(stats.m_uiAllocationSize, 0);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Large Allocations")
+  {
+    TrackedThreadCachingTestAllocator allocator("ThreadCachingTestAllocator", nullptr);
+
+    const size_t uiPageSize = ezSystemInformation::Get().GetMemoryPageSize();
+    const ezUInt64 uiNumPageAllocations = ezMemoryTracker::GetAllocatorStats(ezPageAllocator::GetId()).m_uiNumAllocations;
+
+    const size_t sizes[] = {8193, 10000, 20000, 65536, 100000};
+    for (size_t uiSize : sizes)
+    {
+      const ezUInt64 uiReservedSize = allocator.GetStats().m_uiReservedSize;
+
+      void* pMem = allocator.Allocate(uiSize, 16);
+      EZ_TEST_BOOL(ezMemoryUtils::IsAligned(pMem, 16));
+      ezMemoryUtils::PatternFill(static_cast<ezUInt8*>(pMem), 0xAB, static_cast<ezUInt32>(uiSize));
+
+#if EZ_DISABLED(EZ_USE_THREAD_CACHING_ALLOCATIONS)
+      // only rounded up to the page size, not to a whole span
+      // (the reserved size is shared by all allocators with this policy, so this only works while no other thread uses it)
+      EZ_TEST_INT(allocator.GetStats().m_uiReservedSize - uiReservedSize, ezMemoryUtils::AlignSize<size_t>(uiSize + 16, uiPageSize));
+#endif
+
+      // the allocation is only tracked by the allocator that handed it out
+      EZ_TEST_INT(allocator.GetStats().m_uiAllocationSize, uiSize);
+      EZ_TEST_INT(ezMemoryTracker::GetAllocatorStats(ezPageAllocator::GetId()).m_uiNumAllocations, uiNumPageAllocations);
+
+      allocator.Deallocate(pMem);
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Cross Thread Deallocation")
+  {
+    TrackedThreadCachingTestAllocator allocator("ThreadCachingTestAllocator", nullptr);
+
+    AllocateInParallel(&allocator, 64, 1024);
+
+    // allocate on this thread and free on the worker threads, so that blocks move between the thread caches
+    ezDynamicArray<void*> allocations;
+    for (ezUInt32 i = 0; i < 16 * 1024; ++i)
+    {
+      allocations.PushBack(allocator.Allocate(16 + (i % 64) * 16, 16));
+    }
+
+    ezTaskSystem::ParallelForIndexed(
+      0, allocations.GetCount(),
+      [&](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) {
+        for (ezUInt32 i = uiStartIndex; i < uiEndIndex; ++i)
+        {
+          allocator.Deallocate(allocations[i]);
+        }
+      },
+      "FreeOnWorkerThreads");
+
+    const ezAllocatorBase::Stats stats = allocator.GetStats();
+    EZ_TEST_INT(stats.m_uiAllocationSize, 0);
+    EZ_TEST_INT(stats.m_uiNumAllocations, stats.m_uiNumDeallocations);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::DisabledNoWarning, "Performance compared to Heap")
+  {
+    const ezUInt32 uiNumTasks = 256;
+    const ezUInt32 uiAllocationsPerTask = 16 * 1024;
+    const double fNumAllocations = uiNumTasks * uiAllocationsPerTask;
+
+    auto Measure = [&](ezAllocatorBase* pAllocator, const char* szName) {
+      const ezTime t = AllocateInParallel(pAllocator, uiNumTasks, uiAllocationsPerTask);
+      ezTestFramework::Output(ezTestOutput::Duration, "%s: %.0f allocations/ms", szName, fNumAllocations / t.GetMilliseconds());
+    };
+
+    {
+      UntrackedTestAllocator allocator("UntrackedTestAllocator", nullptr);
+      Measure(&allocator, "Heap");
+    }
+
+    {
+      ezAllocator<ezMemoryPolicies::ezThreadCachingAllocation, ezMemoryTrackingFlags::None> allocator("UntrackedThreadCachingTestAllocator", nullptr);
+      Measure(&allocator, "Thread Caching Heap");
+
+      const ezAllocatorBase::Stats stats = allocator.GetStats();
+      ezTestFramework::Output(ezTestOutput::Details, "Thread Caching Heap: %llu KB reserved, %llu KB cached", stats.m_uiReservedSize / 1024, stats.m_uiCachedSize / 1024);
+    }
+  }
+}
@@ -0,0 +1,206 @@
+#include <FoundationTest/FoundationTestPCH.h>
+
+#include <Foundation/IO/MemoryStream.h>
+#include <Foundation/Serialization/AbstractObjectGraph.h>
+#include <Foundation/Serialization/DdlSerializer.h>
+#include <Foundation/Time/Stopwatch.h>
+
+namespace
+{
+  void CreateGraph(ezUInt32 uiNumNodes, ezAbstractObjectGraph& out_graph)
+  {
+    ezStringBuilder sName;
+
+    for (ezUInt32 i = 0; i < uiNumNodes; ++i)
+    {
+      ezUuid guid;
+      guid.CreateNewUuid();
+
+      sName.Format("Node{0}", i);
+      ezAbstractObjectNode* pNode = out_graph.AddNode(guid, (i % 3) == 0 ? "ezGameObject" : "ezMeshComponent", i % 4, i == 0 ? "root" : nullptr);
+
+      pNode->AddProperty("Name", sName.GetData());
+      pNode->AddProperty("Active", (i % 2) == 0);
+      pNode->AddProperty("Index", i);
+      pNode->AddProperty("Weight", -0.5 * i);
+      pNode->AddProperty("Position", ezVec3(1.0f * i, 2.0f, 3.5f));
+      pNode->AddProperty("Rotation", ezQuat::IdentityQuaternion());
+      pNode->AddProperty("Color", ezColorGammaUB(10, 20, 30, 40));
+      pNode->AddProperty("Transform", ezTransform(ezVec3(1, 2, 3)));
+      pNode->AddProperty("Empty", ezVariant());
+
+      ezVariantArray positions;
+      for (ezUInt32 j = 0; j < 8; ++j)
+      {
+        positions.PushBack(ezVec3(1.0f * j, 2.0f * i, 0.0f));
+      }
+      pNode->AddProperty("Positions", positions);
+
+      ezVariantArray mixed;
+      mixed.PushBack(1.0f);
+      mixed.PushBack("two");
+      mixed.PushBack(ezVariantArray());
+      pNode->AddProperty("Mixed", mixed);
+
+      // only one member, so that the text of both graphs doesn't depend on the order in the hash table
+      ezVariantDictionary dictionary;
+      dictionary.Insert("Key", ezAngle::Degree(45.0f));
+      pNode->AddProperty("Dictionary", dictionary);
+
+      ezDataBuffer data;
+      data.PushBack(1);
+      data.PushBack(2);
+      data.PushBack(static_cast<ezUInt8>(i));
+      pNode->AddProperty("Data", data);
+    }
+  }
+
+  void WriteText(const ezAbstractObjectGraph& graph, ezStringBuilder& out_sText)
+  {
+    ezContiguousMemoryStreamStorage storage;
+    ezMemoryStreamWriter writer(&storage);
+    ezAbstractGraphDdlSerializer::Write(writer, &graph);
+
+    out_sText.SetSubString_ElementCount((const char*)storage.GetData(), storage.GetStorageSize32());
+  }
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST(Serialization, BinaryDdl)
+{
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Read / Write")
+  {
+    ezAbstractObjectGraph graph;
+    CreateGraph(16, graph);
+
+    // string views are written as strings, like in the text format
+    graph.GetNodeByName("root")->AddProperty("View", ezStringView("view"));
+
+    ezDefaultMemoryStreamStorage storage;
+    ezMemoryStreamWriter writer(&storage);
+    ezMemoryStreamReader reader(&storage);
+    ezAbstractGraphDdlSerializer::WriteBinary(writer, &graph);
+
+    ezAbstractObjectGraph graph2;
+    EZ_TEST_BOOL(ezAbstractGraphDdlSerializer::Read(reader, &graph2).Succeeded());
+
+    EZ_TEST_INT(graph2.GetAllNodes().GetCount(), 16);
+    EZ_TEST_BOOL(graph2.GetNodeByName("root") != nullptr);
+    EZ_TEST_BOOL(graph2.GetNodeByName("root")->FindProperty("View")->m_Value == ezVariant("view"));
+
+    ezStringBuilder sText, sText2;
+    WriteText(graph, sText);
+    WriteText(graph2, sText2);
+    EZ_TEST_BOOL(sText == sText2);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Documents")
+  {
+    ezAbstractObjectGraph header, objects, types;
+    CreateGraph(1, header);
+    CreateGraph(32, objects);
+    CreateGraph(4, types);
+
+    ezDefaultMemoryStreamStorage storage;
+    ezMemoryStreamWriter writer(&storage);
+    ezAbstractGraphDdlSerializer::WriteDocumentBinary(writer, &header, &objects, &types);
+
+    {
+      ezMemoryStreamReader reader(&storage);
+
+      ezUniquePtr<ezAbstractObjectGraph> pHeader, pObjects, pTypes;
+      EZ_TEST_BOOL(ezAbstractGraphDdlSerializer::ReadDocument(reader, pHeader, pObjects, pTypes, false).Succeeded());
+
+      EZ_TEST_INT(pHeader->GetAllNodes().GetCount(), 1);
+      EZ_TEST_INT(pObjects->GetAllNodes().GetCount(), 32);
+      EZ_TEST_INT(pTypes->GetAllNodes().GetCount(), 4);
+    }
+
+    {
+      ezMemoryStreamReader reader(&storage);
+
+      ezAbstractObjectGraph header2;
+      EZ_TEST_BOOL(ezAbstractGraphDdlSerializer::ReadHeader(reader, &header2).Succeeded());
+
+      ezStringBuilder sText, sText2;
+      WriteText(header, sText);
+      WriteText(header2, sText2);
+      EZ_TEST_BOOL(sText == sText2);
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Corrupted data")
+  {
+    ezAbstractObjectGraph graph;
+    CreateGraph(4, graph);
+
+    ezContiguousMemoryStreamStorage storage;
+    ezMemoryStreamWriter writer(&storage);
+    ezAbstractGraphDdlSerializer::WriteBinary(writer, &graph);
+
+    ezMuteLog log;
+    ezLogSystemScope logScope(&log);
+
+    // cutting off the data anywhere after the signature must fail gracefully
+    for (ezUInt32 uiSize : {12u, 40u, storage.GetStorageSize32() / 2, storage.GetStorageSize32() - 1})
+    {
+      ezRawMemoryStreamReader reader(storage.GetData(), uiSize);
+
+      ezAbstractObjectGraph graph2;
+      EZ_TEST_BOOL(ezAbstractGraphDdlSerializer::Read(reader, &graph2).Failed());
+    }
+
+    // string table sizes that exceed the data that follows must be rejected before anything is allocated
+    // (signature, version and payload size come first, then the number of strings and the size of the string data)
+    const ezUInt32 uiStringTableOffset = 8 + sizeof(ezUInt32) + sizeof(ezUInt64);
+    for (ezUInt32 uiField : {0u, 1u})
+    {
+      ezDynamicArray<ezUInt8> data;
+      data.PushBackRange(ezArrayPtr<const ezUInt8>(storage.GetData(), storage.GetStorageSize32()));
+
+      const ezUInt32 uiHugeValue = 0xFFFFFFF0u;
+      ezMemoryUtils::RawByteCopy(data.GetData() + uiStringTableOffset + uiField * sizeof(ezUInt32), &uiHugeValue, sizeof(ezUInt32));
+
+      ezRawMemoryStreamReader reader(data.GetData(), data.GetCount());
+
+      ezAbstractObjectGraph graph2;
+      EZ_TEST_BOOL(ezAbstractGraphDdlSerializer::Read(reader, &graph2).Failed());
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Performance")
+  {
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEBUG)
+    const ezUInt32 uiNumNodes = 1000;
+#else
+    const ezUInt32 uiNumNodes = 20000;
+#endif
+
+    ezAbstractObjectGraph graph;
+    CreateGraph(uiNumNodes, graph);
+
+    ezDefaultMemoryStreamStorage storageText, storageBinary;
+    ezMemoryStreamWriter writerText(&storageText);
+    ezMemoryStreamWriter writerBinary(&storageBinary);
+
+    ezStopwatch sw;
+    ezAbstractGraphDdlSerializer::Write(writerText, &graph);
+    const ezTime tWriteText = sw.Checkpoint();
+    ezAbstractGraphDdlSerializer::WriteBinary(writerBinary, &graph);
+    const ezTime tWriteBinary = sw.Checkpoint();
+
+    ezMemoryStreamReader readerText(&storageText);
+    ezMemoryStreamReader readerBinary(&storageBinary);
+    ezAbstractObjectGraph graphText, graphBinary;
+
+    sw.Checkpoint();
+    EZ_TEST_BOOL(ezAbstractGraphDdlSerializer::Read(readerText, &graphText).Succeeded());
+    const ezTime tReadText = sw.Checkpoint();
+    EZ_TEST_BOOL(ezAbstractGraphDdlSerializer::Read(readerBinary, &graphBinary).Succeeded());
+    const ezTime tReadBinary = sw.Checkpoint();
+
+    EZ_TEST_INT(graphBinary.GetAllNodes().GetCount(), uiNumNodes);
+
+    ezTestFramework::Output(ezTestOutput::Duration, "Text DDL: %u nodes, %.1f KB, write %.2fms, read %.2fms", uiNumNodes, storageText.GetStorageSize64() / 1024.0, tWriteText.GetMilliseconds(), tReadText.GetMilliseconds());
+    ezTestFramework::Output(ezTestOutput::Duration, "Binary DDL: %u nodes, %.1f KB, write %.2fms, read %.2fms", uiNumNodes, storageBinary.GetStorageSize64() / 1024.0, tWriteBinary.GetMilliseconds(), tReadBinary.GetMilliseconds());
+  }
+}
@@ -7,6 +7,7 @@
 #include <Foundation/Serialization/DdlSerializer.h>
 #include <Foundation/Serialization/ReflectionSerializer.h>
 #include <Foundation/Serialization/RttiConverter.h>
+#include <Foundation/Time/Stopwatch.h>
 #include <FoundationTest/Reflection/ReflectionTestClasses.h>
 
 EZ_CREATE_SIMPLE_TEST_GROUP(Serialization);
@@ -101,6 +102,30 @@ void TestSerialize(T* pObject)
     EZ_TEST_BOOL(sData == sData2);
   }
 
+  {
+    // the binary DDL format must read back the same graph as the text format
+    ezContiguousMemoryStreamStorage storage;
+    ezMemoryStreamWriter writer(&storage);
+    ezMemoryStreamReader reader(&storage);
+
+    ezAbstractGraphDdlSerializer::WriteBinary(writer, &graph);
+
+    ezAbstractObjectGraph graph2;
+    EZ_TEST_BOOL(ezAbstractGraphDdlSerializer::Read(reader, &graph2).Succeeded());
+
+    ezContiguousMemoryStreamStorage storageText, storageText2;
+    ezMemoryStreamWriter writerText(&storageText);
+    ezMemoryStreamWriter writerText2(&storageText2);
+    ezAbstractGraphDdlSerializer::Write(writerText, &graph);
+    ezAbstractGraphDdlSerializer::Write(writerText2, &graph2);
+
+    ezStringBuilder sData, sData2;
+    sData.SetSubString_ElementCount((const char*)storageText.GetData(), storageText.GetStorageSize32());
+    sData2.SetSubString_ElementCount((const char*)storageText2.GetData(), storageText2.GetStorageSize32());
+
+    EZ_TEST_BOOL(sData == sData2);
+  }
+
   {
     ezContiguousMemoryStreamStorage storage;
     ezMemoryStreamWriter writer(&storage);
@@ -331,3 +356,89 @@ EZ_CREATE_SIMPLE_TEST(Serialization, RttiConverter)
     }
   }
 }
+
+EZ_CREATE_SIMPLE_TEST(Serialization, SerializationPlan)
+{
+  const ezRTTI* pRtti = ezGetStaticRTTI<ezTestClass2>();
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "FindPropertyByName")
+  {
+    EZ_TEST_BOOL(pRtti->FindPropertyByName("Text") != nullptr);
+    EZ_TEST_BOOL(pRtti->FindPropertyByName("Color") != nullptr);
+    EZ_TEST_BOOL(pRtti->FindPropertyByName("Color", false) == nullptr);
+    EZ_TEST_BOOL(pRtti->FindPropertyByName("MyVector") == nullptr);
+    EZ_TEST_STRING(pRtti->FindPropertyByName("SubVector")->GetPropertyName(), "SubVector");
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Plan")
+  {
+    const ezSerializationPlan& plan = pRtti->GetSerializationPlan();
+    EZ_TEST_BOOL(&plan == &pRtti->GetSerializationPlan());
+
+    ezHybridArray<ezAbstractProperty*, 32> properties;
+    pRtti->GetAllProperties(properties);
+    EZ_TEST_INT(plan.GetProperties().GetCount(), properties.GetCount());
+
+    for (ezUInt32 i = 0; i < properties.GetCount(); ++i)
+    {
+      const ezSerializationPlan::Property& prop = plan.GetProperties()[i];
+      EZ_TEST_BOOL(prop.m_pProperty == properties[i]);
+
+      const bool bExpectDirect = ezStringUtils::IsEqual(prop.m_pProperty->GetPropertyName(), "Color") || ezStringUtils::IsEqual(prop.m_pProperty->GetPropertyName(), "Time");
+      EZ_TEST_BOOL(prop.HasDirectAccess() == bExpectDirect);
+    }
+
+    ezTestClass2 source;
+    source.m_Color = ezColor::Red;
+    source.m_Time = ezTime::Seconds(3);
+
+    ezTestClass2 target;
+    for (const ezSerializationPlan::Property& prop : plan.GetProperties())
+    {
+      if (prop.HasDirectAccess())
+      {
+        const ezVariant value = prop.ReadDirect(&source);
+        EZ_TEST_BOOL(value == ezReflectionUtils::GetMemberPropertyValue(static_cast<const ezAbstractMemberProperty*>(prop.m_pProperty), &source));
+        prop.WriteDirect(&target, value);
+      }
+    }
+
+    EZ_TEST_BOOL(target.m_Color == ezColor::Red);
+    EZ_TEST_BOOL(target.m_Time == ezTime::Seconds(3));
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::DisabledNoWarning, "Write Performance")
+  {
+    constexpr ezUInt32 uiNumObjects = 100000;
+
+    ezDynamicArray<ezTestClass2> objects;
+    objects.SetCount(uiNumObjects);
+
+    ezAbstractObjectGraph graph;
+    TestContext context;
+    ezRttiConverterWriter conv(&graph, &context, true, true);
+
+    ezStopwatch sw;
+
+    for (ezUInt32 i = 0; i < uiNumObjects; ++i)
+    {
+      ezUuid guid;
+      guid.CreateNewUuid();
+      context.RegisterObject(guid, pRtti, &objects[i]);
+      conv.AddObjectToGraph(pRtti, &objects[i]);
+    }
+
+    ezTestFramework::Output(ezTestOutput::Duration, "Writing %u objects: %.2fms", uiNumObjects, sw.GetRunningTotal().GetMilliseconds());
+
+    sw.StopAndReset();
+    sw.Resume();
+
+    for (ezUInt32 i = 0; i < uiNumObjects; ++i)
+    {
+      ezTestClass2 clone;
+      ezReflectionSerializer::Clone(&objects[i], &clone, pRtti);
+    }
+
+    ezTestFramework::Output(ezTestOutput::Duration, "Cloning %u objects: %.2fms", uiNumObjects, sw.GetRunningTotal().GetMilliseconds());
+  }
+}
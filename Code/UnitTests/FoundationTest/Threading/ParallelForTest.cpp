@@ -74,6 +74,38 @@ EZ_CREATE_SIMPLE_TEST(Threading, ParallelFor)
     EZ_TEST_INT(uiNumbersSum, uiNumbersCheckSum);
   }
 
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Parallel For (Indexed, Start Index)")
+  {
+    // reset
+    ResetSharedVariables();
+
+    // skip the first slice, the ranges passed to the callback must be offset by the start index
+    const ezUInt32 uiStartIndex = ::s_uiTaskItemSliceSize;
+    const ezUInt32 uiNumItems = ::s_uiTotalNumberOfTaskItems - uiStartIndex;
+
+    ezTaskSystem::ParallelForIndexed(
+      uiStartIndex, uiNumItems,
+      [&dataAccessMutex, &uiRangesEncounteredCheck, &uiNumbersSum, &numbers, uiStartIndex](ezUInt32 uiSliceStartIndex, ezUInt32 uiSliceEndIndex) {
+        EZ_LOCK(dataAccessMutex);
+
+        EZ_TEST_BOOL(uiSliceStartIndex >= uiStartIndex);
+        EZ_TEST_BOOL(uiSliceEndIndex <= ::s_uiTotalNumberOfTaskItems);
+        EZ_TEST_INT(uiSliceEndIndex - uiSliceStartIndex, ::s_uiTaskItemSliceSize);
+
+        uiRangesEncounteredCheck |= 1 << (uiSliceStartIndex / ::s_uiTaskItemSliceSize);
+
+        for (ezUInt32 uiIndex = uiSliceStartIndex; uiIndex < uiSliceEndIndex; ++uiIndex)
+        {
+          uiNumbersSum += numbers[uiIndex];
+        }
+      },
+      "ParallelForIndexed Start Index Test", parallelForParams);
+
+    // the first slice holds the numbers 1 to s_uiTaskItemSliceSize
+    EZ_TEST_INT(uiRangesEncounteredCheck, 0b1110);
+    EZ_TEST_INT(uiNumbersSum, uiNumbersCheckSum - (::s_uiTaskItemSliceSize * (::s_uiTaskItemSliceSize + 1)) / 2);
+  }
+
   EZ_TEST_BLOCK(ezTestBlock::Enabled, "Parallel For (Array)")
   {
     // reset
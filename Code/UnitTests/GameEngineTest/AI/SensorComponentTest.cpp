@@ -0,0 +1,217 @@
+#include <GameEngineTest/GameEngineTestPCH.h>
+
+#ifdef BUILDSYSTEM_ENABLE_JOLT_SUPPORT
+
+#  include <Core/Interfaces/PhysicsWorldModule.h>
+#  include <Core/World/World.h>
+#  include <Foundation/Math/Random.h>
+#  include <GameEngine/AI/SensorComponent.h>
+#  include <GameEngine/Gameplay/MarkerComponent.h>
+
+EZ_CREATE_SIMPLE_TEST_GROUP(AI);
+
+namespace SensorComponentTestDetail
+{
+  static const char* s_szTargetCategory = "SensorTestTarget";
+
+  static ezGameObject* CreateTarget(ezWorld& world, const ezVec3& vPosition)
+  {
+    ezGameObjectDesc desc;
+    desc.m_LocalPosition = vPosition;
+
+    ezGameObject* pObject = nullptr;
+    world.CreateObject(desc, pObject);
+
+    ezMarkerComponent* pMarker = nullptr;
+    ezMarkerComponent::CreateComponent(pObject, pMarker);
+    pMarker->SetMarkerType(s_szTargetCategory);
+
+    return pObject;
+  }
+
+  static ezSensorSphereComponent* CreateSensor(ezWorld& world, const ezVec3& vPosition, float fRadius)
+  {
+    ezGameObjectDesc desc;
+    desc.m_LocalPosition = vPosition;
+
+    ezGameObject* pObject = nullptr;
+    world.CreateObject(desc, pObject);
+
+    ezSensorSphereComponent* pSensor = nullptr;
+    ezSensorSphereComponent::CreateComponent(pObject, pSensor);
+    pSensor->m_fRadius = fRadius;
+    pSensor->SetSpatialCategory(s_szTargetCategory);
+    pSensor->SetUpdateRate(ezUpdateRate::EveryFrame);
+
+    return pSensor;
+  }
+
+  static ezGameObjectHandle CreateOccluder(ezWorld& world, ezPhysicsWorldModuleInterface* pModule, const ezVec3& vPosition, const ezVec3& vSize)
+  {
+    ezGameObjectDesc desc;
+    desc.m_LocalPosition = vPosition;
+
+    ezGameObject* pObject = nullptr;
+    ezGameObjectHandle hObject = world.CreateObject(desc, pObject);
+    pModule->AddStaticCollisionBox(pObject, vSize);
+
+    return hObject;
+  }
+
+  /// Computes the objects that a sensor should detect on a single thread, with one raycast per target and the same query parameters as the sensor
+  /// world module.
+  static void ComputeExpectedObjects(const ezSensorComponent* pSensor, const ezPhysicsWorldModuleInterface* pModule, ezDynamicArray<ezGameObjectHandle>& out_Objects)
+  {
+    out_Objects.Clear();
+
+    ezDynamicArray<ezGameObject*> objectsInVolume;
+    pSensor->GetObjectsInSensorVolume(objectsInVolume);
+
+    ezPhysicsQueryParameters params(pSensor->m_uiCollisionLayer);
+    params.m_bIgnoreInitialOverlap = true;
+    params.m_ShapeTypes = ezPhysicsShapeType::Default;
+    params.m_ShapeTypes.Remove(ezPhysicsShapeType::Rope);
+    params.m_ShapeTypes.Remove(ezPhysicsShapeType::Ragdoll);
+
+    const ezVec3 vSensorPos = pSensor->GetOwner()->GetGlobalPosition();
+
+    for (ezGameObject* pObject : objectsInVolume)
+    {
+      ezVec3 vDir = pObject->GetGlobalPosition() - vSensorPos;
+      const float fDistance = vDir.GetLengthAndNormalize();
+
+      ezPhysicsCastResult result;
+      if (fDistance > 0.0f && pModule->Raycast(result, vSensorPos, vDir, fDistance, params, ezPhysicsHitCollection::Any))
+        continue;
+
+      out_Objects.PushBack(pObject->GetHandle());
+    }
+
+    out_Objects.Sort();
+  }
+
+  static bool IsDetected(const ezSensorComponent* pSensor, ezGameObjectHandle hObject)
+  {
+    return pSensor->GetLastDetectedObjects().IndexOf(hObject) != ezInvalidIndex;
+  }
+} // namespace SensorComponentTestDetail
+
+EZ_CREATE_SIMPLE_TEST(AI, Sensors)
+{
+  using namespace SensorComponentTestDetail;
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Parallel vs Serial")
+  {
+    ezWorldDesc worldDesc("SensorsParallel");
+    ezWorld world(worldDesc);
+    EZ_LOCK(world.GetWriteMarker());
+
+    world.SetWorldSimulationEnabled(true);
+    world.GetClock().SetFixedTimeStep(ezTime::Milliseconds(10));
+
+    ezPhysicsWorldModuleInterface* pModule = world.GetOrCreateModule<ezPhysicsWorldModuleInterface>();
+    if (!EZ_TEST_BOOL(pModule != nullptr))
+      return;
+
+    const float fLevelSize = 64.0f;
+
+    ezRandom rng;
+    rng.Initialize(42);
+
+    // walls that block the view of some sensors
+    for (ezUInt32 i = 0; i < 24; ++i)
+    {
+      const ezVec3 vPos(rng.FloatMinMax(0.0f, fLevelSize), rng.FloatMinMax(0.0f, fLevelSize), 1.0f);
+      const ezVec3 vSize = (i % 2) == 0 ? ezVec3(6.0f, 0.5f, 4.0f) : ezVec3(0.5f, 6.0f, 4.0f);
+      CreateOccluder(world, pModule, vPos, vSize);
+    }
+
+    for (ezUInt32 i = 0; i < 200; ++i)
+    {
+      CreateTarget(world, ezVec3(rng.FloatMinMax(0.0f, fLevelSize), rng.FloatMinMax(0.0f, fLevelSize), 1.0f));
+    }
+
+    // more sensors than the bin size of the parallel for, so that they are distributed across several tasks
+    ezHybridArray<ezSensorSphereComponent*, 64> sensors;
+    for (ezUInt32 i = 0; i < 64; ++i)
+    {
+      sensors.PushBack(CreateSensor(world, ezVec3(rng.FloatMinMax(0.0f, fLevelSize), rng.FloatMinMax(0.0f, fLevelSize), 1.0f), 15.0f));
+    }
+
+    // the first update adds the physics bodies, the following ones run the sensors against them
+    for (ezUInt32 i = 0; i < 4; ++i)
+    {
+      world.Update();
+    }
+
+    ezUInt32 uiNumDetected = 0;
+    ezDynamicArray<ezGameObjectHandle> expectedObjects;
+
+    for (const ezSensorSphereComponent* pSensor : sensors)
+    {
+      ComputeExpectedObjects(pSensor, pModule, expectedObjects);
+
+      const ezArrayPtr<ezGameObjectHandle> detectedObjects = pSensor->GetLastDetectedObjects();
+      if (EZ_TEST_INT(detectedObjects.GetCount(), expectedObjects.GetCount()))
+      {
+        for (ezUInt32 i = 0; i < expectedObjects.GetCount(); ++i)
+        {
+          EZ_TEST_BOOL(detectedObjects[i] == expectedObjects[i]);
+        }
+      }
+
+      uiNumDetected += detectedObjects.GetCount();
+    }
+
+    EZ_TEST_BOOL(uiNumDetected > 0);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Visibility Cache")
+  {
+    ezWorldDesc worldDesc("SensorsCache");
+    ezWorld world(worldDesc);
+    EZ_LOCK(world.GetWriteMarker());
+
+    world.SetWorldSimulationEnabled(true);
+    world.GetClock().SetFixedTimeStep(ezTime::Milliseconds(10));
+
+    ezPhysicsWorldModuleInterface* pModule = world.GetOrCreateModule<ezPhysicsWorldModuleInterface>();
+    if (!EZ_TEST_BOOL(pModule != nullptr))
+      return;
+
+    ezSensorWorldModule* pSensorModule = world.GetOrCreateModule<ezSensorWorldModule>();
+    pSensorModule->SetVisibilityCacheDuration(ezTime::Seconds(1));
+
+    const ezSensorSphereComponent* pSensor = CreateSensor(world, ezVec3(0, 0, 1), 10.0f);
+    ezGameObject* pTarget = CreateTarget(world, ezVec3(6, 0, 1));
+    const ezGameObjectHandle hTarget = pTarget->GetHandle();
+
+    world.Update();
+    world.Update();
+    EZ_TEST_BOOL(IsDetected(pSensor, hTarget));
+
+    // nothing moved, so the cached result is used and the new occluder goes unnoticed
+    const ezGameObjectHandle hOccluder = CreateOccluder(world, pModule, ezVec3(3, 0, 1), ezVec3(1, 4, 4));
+    world.Update();
+    world.Update();
+    EZ_TEST_BOOL(IsDetected(pSensor, hTarget));
+
+    // the target moved, so the visibility is tested again
+    pTarget->SetLocalPosition(ezVec3(6, 0.5f, 1));
+    world.Update();
+    EZ_TEST_BOOL(!IsDetected(pSensor, hTarget));
+
+    // the occluder is gone, but the target is static again, so the cached result is still used
+    world.DeleteObjectNow(hOccluder);
+    world.Update();
+    EZ_TEST_BOOL(!IsDetected(pSensor, hTarget));
+
+    // once the cached result is older than the cache duration, the visibility is tested again
+    world.GetClock().SetFixedTimeStep(ezTime::Seconds(2));
+    world.Update();
+    world.GetClock().SetFixedTimeStep(ezTime::Milliseconds(10));
+    EZ_TEST_BOOL(IsDetected(pSensor, hTarget));
+  }
+}
+
+#endif
@@ -0,0 +1,224 @@
+#include <GameEngineTest/GameEngineTestPCH.h>
+
+#ifdef BUILDSYSTEM_ENABLE_EMBREE_SUPPORT
+
+#  include <BakingPlugin/Tasks/SkyVisibilityTask.h>
+#  include <BakingPlugin/Tracer/TracerEmbree.h>
+#  include <Foundation/Math/Random.h>
+#  include <Foundation/Time/Stopwatch.h>
+#  include <GameEngineTest/TestClass/SyntheticGeometry.h>
+#  include <RendererCore/BakedProbes/BakingInterface.h>
+
+EZ_CREATE_SIMPLE_TEST_GROUP(Baking);
+
+namespace TracerEmbreeTestDetail
+{
+  using namespace ezSyntheticGeometry;
+
+  /// Creates a flat level of the given size with a regular pattern of boxes of different heights on it.
+  static void CreateSyntheticScene(float fLevelSize, ezDynamicArray<ezVec3>& out_Vertices, ezDynamicArray<ezUInt32>& out_Indices)
+  {
+    out_Vertices.Clear();
+    out_Indices.Clear();
+
+    AddQuad(out_Vertices, out_Indices, ezVec3(0, 0, 0), ezVec3(fLevelSize, 0, 0), ezVec3(fLevelSize, fLevelSize, 0), ezVec3(0, fLevelSize, 0));
+
+    const float fCellSize = 8.0f;
+    const ezUInt32 uiNumCells = static_cast<ezUInt32>(fLevelSize / fCellSize);
+
+    for (ezUInt32 y = 1; y < uiNumCells; y += 2)
+    {
+      for (ezUInt32 x = 1; x < uiNumCells; x += 2)
+      {
+        const ezVec3 vMin(x * fCellSize + 1.0f, y * fCellSize + 1.0f, 0.0f);
+        const ezVec3 vMax(vMin.x + 4.0f, vMin.y + 4.0f, 2.0f + ((x + y) % 5) * 2.0f);
+
+        AddBox(out_Vertices, out_Indices, vMin, vMax);
+      }
+    }
+  }
+
+  static void CreateRandomRays(ezRandom& rng, float fLevelSize, ezUInt32 uiNumRays, ezDynamicArray<ezTracerInterface::Ray>& out_Rays)
+  {
+    out_Rays.SetCountUninitialized(uiNumRays);
+
+    for (auto& ray : out_Rays)
+    {
+      ray.m_vStartPos = ezVec3(rng.FloatMinMax(0.0f, fLevelSize), rng.FloatMinMax(0.0f, fLevelSize), rng.FloatMinMax(0.1f, 12.0f));
+      ray.m_vDir = ezVec3::CreateRandomDirection(rng);
+      ray.m_fDistance = rng.FloatMinMax(1.0f, fLevelSize);
+    }
+  }
+} // namespace TracerEmbreeTestDetail
+
+EZ_CREATE_SIMPLE_TEST(Baking, TracerEmbree)
+{
+  using namespace TracerEmbreeTestDetail;
+
+  const float fLevelSize = 128.0f;
+
+  ezDynamicArray<ezVec3> vertices;
+  ezDynamicArray<ezUInt32> indices;
+  CreateSyntheticScene(fLevelSize, vertices, indices);
+
+  ezTracerEmbree tracer;
+  if (!EZ_TEST_BOOL(tracer.BuildScene(vertices, indices).Succeeded()))
+    return;
+
+  ezRandom rng;
+  rng.Initialize(42);
+
+  ezDynamicArray<ezTracerInterface::Ray> rays;
+  CreateRandomRays(rng, fLevelSize, 10000, rays);
+
+  const ezUInt32 packetSizes[] = {4, 8, 16};
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Known Rays")
+  {
+    ezTracerInterface::Ray knownRays[2];
+
+    // straight up in the middle of an empty cell
+    knownRays[0].m_vStartPos = ezVec3(4.0f, 4.0f, 1.0f);
+    knownRays[0].m_vDir = ezVec3(0, 0, 1);
+    knownRays[0].m_fDistance = 100.0f;
+
+    // straight down onto the ground
+    knownRays[1].m_vStartPos = ezVec3(4.0f, 4.0f, 1.0f);
+    knownRays[1].m_vDir = ezVec3(0, 0, -1);
+    knownRays[1].m_fDistance = 100.0f;
+
+    for (ezUInt32 uiPacketSize : {1u, 4u})
+    {
+      tracer.SetPacketSize(uiPacketSize);
+
+      bool occluded[2] = {};
+      tracer.TraceOcclusion(ezMakeArrayPtr(knownRays), ezMakeArrayPtr(occluded));
+      EZ_TEST_BOOL(!occluded[0]);
+      EZ_TEST_BOOL(occluded[1]);
+
+      ezTracerInterface::Hit hits[2];
+      tracer.TraceRays(ezMakeArrayPtr(knownRays), ezMakeArrayPtr(hits));
+      EZ_TEST_FLOAT(hits[0].m_fDistance, -1.0f, 0.0f);
+      EZ_TEST_FLOAT(hits[1].m_fDistance, 1.0f, 0.001f);
+      EZ_TEST_VEC3(hits[1].m_vNormal, ezVec3(0, 0, 1), 0.001f);
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "TraceOcclusion Packets vs Single Rays")
+  {
+    ezDynamicArray<bool> singleOccluded;
+    singleOccluded.SetCount(rays.GetCount());
+
+    tracer.SetPacketSize(1);
+    tracer.TraceOcclusion(rays, singleOccluded);
+
+    ezUInt32 uiNumOccluded = 0;
+    for (bool bOccluded : singleOccluded)
+    {
+      uiNumOccluded += bOccluded ? 1 : 0;
+    }
+
+    // the scene has to be a meaningful mix of hits and misses
+    EZ_TEST_BOOL(uiNumOccluded > rays.GetCount() / 10);
+    EZ_TEST_BOOL(uiNumOccluded < rays.GetCount() - rays.GetCount() / 10);
+
+    for (ezUInt32 uiPacketSize : packetSizes)
+    {
+      ezDynamicArray<bool> packetOccluded;
+      packetOccluded.SetCount(rays.GetCount());
+
+      tracer.SetPacketSize(uiPacketSize);
+      tracer.TraceOcclusion(rays, packetOccluded);
+
+      ezUInt32 uiNumMismatches = 0;
+      for (ezUInt32 i = 0; i < rays.GetCount(); ++i)
+      {
+        uiNumMismatches += (packetOccluded[i] != singleOccluded[i]) ? 1 : 0;
+      }
+
+      EZ_TEST_INT(uiNumMismatches, 0);
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "TraceRays Packets vs Single Rays")
+  {
+    ezDynamicArray<ezTracerInterface::Hit> singleHits;
+    singleHits.SetCountUninitialized(rays.GetCount());
+
+    ezDynamicArray<bool> singleOccluded;
+    singleOccluded.SetCount(rays.GetCount());
+
+    tracer.SetPacketSize(1);
+    tracer.TraceRays(rays, singleHits);
+    tracer.TraceOcclusion(rays, singleOccluded);
+
+    // a ray is occluded exactly when it has a closest hit
+    for (ezUInt32 i = 0; i < rays.GetCount(); ++i)
+    {
+      EZ_TEST_BOOL(singleOccluded[i] == (singleHits[i].m_fDistance >= 0.0f));
+    }
+
+    for (ezUInt32 uiPacketSize : packetSizes)
+    {
+      ezDynamicArray<ezTracerInterface::Hit> packetHits;
+      packetHits.SetCountUninitialized(rays.GetCount());
+
+      tracer.SetPacketSize(uiPacketSize);
+      tracer.TraceRays(rays, packetHits);
+
+      for (ezUInt32 i = 0; i < rays.GetCount(); ++i)
+      {
+        EZ_TEST_FLOAT(packetHits[i].m_fDistance, singleHits[i].m_fDistance, 0.001f);
+        EZ_TEST_VEC3(packetHits[i].m_vPosition, singleHits[i].m_vPosition, 0.001f);
+        EZ_TEST_VEC3(packetHits[i].m_vNormal, singleHits[i].m_vNormal, 0.001f);
+      }
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Sky Visibility Bake")
+  {
+    // a grid of probes in two layers, one between the boxes and one above most of them
+    ezDynamicArray<ezVec3> probePositions;
+    for (float z : {1.0f, 7.0f})
+    {
+      for (float y = 2.0f; y < fLevelSize; y += 4.0f)
+      {
+        for (float x = 2.0f; x < fLevelSize; x += 4.0f)
+        {
+          probePositions.PushBack(ezVec3(x, y, z));
+        }
+      }
+    }
+
+    ezBakingSettings settings;
+    settings.m_uiNumSamplesPerProbe = 128;
+    settings.m_fMaxRayDistance = 1000.0f;
+
+    tracer.SetPacketSize(1);
+    ezBakingInternal::SkyVisibilityTask singleRaysTask(settings, tracer, probePositions);
+
+    ezStopwatch sw;
+    singleRaysTask.Execute();
+    const ezTime tSingleRays = sw.Checkpoint();
+
+    tracer.SetPacketSize(0);
+    ezBakingInternal::SkyVisibilityTask packetsTask(settings, tracer, probePositions);
+
+    packetsTask.Execute();
+    const ezTime tPackets = sw.Checkpoint();
+
+    ezTestFramework::Output(ezTestOutput::Duration, "Sky visibility of %u probes with %u samples each: single rays %.2fms, packets %.2fms",
+      probePositions.GetCount(), settings.m_uiNumSamplesPerProbe, tSingleRays.GetMilliseconds(), tPackets.GetMilliseconds());
+
+    EZ_TEST_BOOL(!singleRaysTask.WasCanceled());
+    EZ_TEST_BOOL(!packetsTask.WasCanceled());
+
+    if (EZ_TEST_INT(packetsTask.GetSkyVisibility().GetCount(), probePositions.GetCount()) &&
+        EZ_TEST_INT(singleRaysTask.GetSkyVisibility().GetCount(), probePositions.GetCount()))
+    {
+      EZ_TEST_BOOL(packetsTask.GetSkyVisibility() == singleRaysTask.GetSkyVisibility());
+    }
+  }
+}
+
+#endif
@@ -7,6 +7,8 @@
 #include <Foundation/Strings/StringConversion.h>
 #include <Foundation/System/MiniDumpUtils.h>
 #include <Foundation/System/Process.h>
+#include <Foundation/Threading/TaskSystem.h>
+#include <Foundation/Time/Stopwatch.h>
 #include <RendererCore/Components/SkyBoxComponent.h>
 #include <RendererCore/RenderContext/RenderContext.h>
 #include <RendererCore/RenderWorld/RenderWorld.h>
@@ -205,6 +207,7 @@ void ezGameEngineTestBasics::SetupSubTests()
   AddSubTest("Skybox", SubTests::Skybox);
   AddSubTest("Debug Rendering", SubTests::DebugRendering);
   AddSubTest("Debug Rendering - No Lines", SubTests::DebugRendering2);
+  AddSubTest("Debug Rendering - Performance", SubTests::DebugRenderingPerformance);
   AddSubTest("Load Scene", SubTests::LoadScene);
 }
 
@@ -226,7 +229,7 @@ ezResult ezGameEngineTestBasics::InitializeSubTest(ezInt32 iIdentifier)
     return EZ_SUCCESS;
   }
 
-  if (iIdentifier == SubTests::DebugRendering || iIdentifier == SubTests::DebugRendering2)
+  if (iIdentifier == SubTests::DebugRendering || iIdentifier == SubTests::DebugRendering2 || iIdentifier == SubTests::DebugRenderingPerformance)
   {
     m_pOwnApplication->SubTestDebugRenderingSetup();
     return EZ_SUCCESS;
@@ -257,6 +260,9 @@ ezTestAppRun ezGameEngineTestBasics::RunSubTest(ezInt32 iIdentifier, ezUInt32 ui
   if (iIdentifier == SubTests::DebugRendering2)
     return m_pOwnApplication->SubTestDebugRenderingExec2(m_iFrame);
 
+  if (iIdentifier == SubTests::DebugRenderingPerformance)
+    return m_pOwnApplication->SubTestDebugRenderingPerformanceExec(m_iFrame);
+
   if (iIdentifier == SubTests::LoadScene)
     return m_pOwnApplication->SubTestLoadSceneExec(m_iFrame);
 
@@ -537,6 +543,95 @@ ezTestAppRun ezGameEngineTestApplication_Basics::SubTestDebugRenderingExec2(ezIn
   return ezTestAppRun::Quit;
 }
 
+ezTestAppRun ezGameEngineTestApplication_Basics::SubTestDebugRenderingPerformanceExec(ezInt32 iCurFrame)
+{
+  constexpr ezUInt32 uiNumPrimitives = 100000;
+  constexpr ezInt32 iNumFramesPerMode = 4;
+
+  {
+    auto pCamera = ezDynamicCast<ezGameState*>(GetActiveGameState())->GetMainCamera();
+    pCamera->SetCameraMode(ezCameraMode::PerspectiveFixedFovY, 100.0f, 0.1f, 1000.0f);
+    ezVec3 pos;
+    pos.SetZero();
+    pCamera->LookAt(pos, pos + ezVec3(1, 0, 0), ezVec3(0, 0, 1));
+  }
+
+  static ezTime s_tDrawMainThread;
+  static ezTime s_tDrawParallel;
+  static ezTime s_tFrame;
+
+  if (iCurFrame == 0)
+  {
+    s_tDrawMainThread.SetZero();
+    s_tDrawParallel.SetZero();
+    s_tFrame.SetZero();
+  }
+
+  const ezWorld* pWorld = m_pWorld.Borrow();
+
+  auto drawPrimitives = [pWorld](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) {
+    for (ezUInt32 i = uiStartIndex; i < uiEndIndex; ++i)
+    {
+      // a wall of small shapes in front of the camera
+      const ezVec3 vPos(50.0f, (float)(i % 400) * 0.25f - 50.0f, (float)(i / 400) * 0.25f - 30.0f);
+      const float fGray = (float)(i % 7 + 1) / 7.0f;
+      const ezColor color(fGray, fGray, fGray);
+
+      switch (i % 4)
+      {
+        case 0:
+        {
+          const ezDebugRenderer::Line line(vPos, vPos + ezVec3(0, 0.1f, 0.1f));
+          ezDebugRenderer::DrawLines(pWorld, ezMakeArrayPtr(&line, 1), color);
+          break;
+        }
+
+        case 1:
+          ezDebugRenderer::DrawLineBox(pWorld, ezBoundingBox(vPos - ezVec3(0.1f), vPos + ezVec3(0.1f)), color);
+          break;
+
+        case 2:
+          ezDebugRenderer::DrawLineSphere(pWorld, ezBoundingSphere(vPos, 0.1f), color);
+          break;
+
+        case 3:
+          ezDebugRenderer::DrawCross(pWorld, vPos, 0.2f, color);
+          break;
+      }
+    }
+  };
+
+  // first only draw from the main thread, then from all worker threads at once
+  const bool bParallel = iCurFrame >= iNumFramesPerMode;
+
+  ezStopwatch sw;
+
+  if (bParallel)
+  {
+    ezTaskSystem::ParallelForIndexed(0, uiNumPrimitives, drawPrimitives);
+    s_tDrawParallel += sw.Checkpoint();
+  }
+  else
+  {
+    drawPrimitives(0, uiNumPrimitives);
+    s_tDrawMainThread += sw.Checkpoint();
+  }
+
+  if (Run() == ezApplication::Execution::Quit)
+    return ezTestAppRun::Quit;
+
+  s_tFrame += sw.Checkpoint();
+
+  if (iCurFrame < 2 * iNumFramesPerMode - 1)
+    return ezTestAppRun::Continue;
+
+  ezTestFramework::Output(ezTestOutput::Duration, "Drawing %u debug primitives from the main thread: %.2fms", uiNumPrimitives, s_tDrawMainThread.GetMilliseconds() / iNumFramesPerMode);
+  ezTestFramework::Output(ezTestOutput::Duration, "Drawing %u debug primitives from all worker threads: %.2fms", uiNumPrimitives, s_tDrawParallel.GetMilliseconds() / iNumFramesPerMode);
+  ezTestFramework::Output(ezTestOutput::Duration, "Rendering %u debug primitives: %.2fms per frame", uiNumPrimitives, s_tFrame.GetMilliseconds() / (2 * iNumFramesPerMode));
+
+  return ezTestAppRun::Quit;
+}
+
 //////////////////////////////////////////////////////////////////////////
 
 void ezGameEngineTestApplication_Basics::SubTestLoadSceneSetup()
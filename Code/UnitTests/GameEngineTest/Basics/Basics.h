@@ -20,6 +20,8 @@ public:
 
   ezTestAppRun SubTestDebugRenderingExec2(ezInt32 iCurFrame);
 
+  ezTestAppRun SubTestDebugRenderingPerformanceExec(ezInt32 iCurFrame);
+
   void SubTestLoadSceneSetup();
   ezTestAppRun SubTestLoadSceneExec(ezInt32 iCurFrame);
 };
@@ -39,6 +41,7 @@ private:
     Skybox,
     DebugRendering,
     DebugRendering2,
+    DebugRenderingPerformance,
     LoadScene,
   };
 
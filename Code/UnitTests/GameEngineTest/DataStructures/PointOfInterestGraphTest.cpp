@@ -0,0 +1,188 @@
+#include <GameEngineTest/GameEngineTestPCH.h>
+
+#include <Foundation/Algorithm/Sorting.h>
+#include <Foundation/Math/Random.h>
+#include <Foundation/Time/Stopwatch.h>
+#include <GameEngine/AI/PointOfInterestGraph.h>
+#include <Utilities/DataStructures/DynamicOctree.h>
+
+namespace
+{
+  struct TestPoint
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezVec3 m_vPosition;
+  };
+
+  void FindPointsBruteForce(const ezPointOfInterestGraph<TestPoint>& graph, const ezVec3& vPosition, float fRadius, ezDynamicArray<ezUInt32>& out_Points)
+  {
+    out_Points.Clear();
+
+    for (ezUInt32 i = 0; i < graph.GetPoints().GetCount(); ++i)
+    {
+      if ((graph.GetPoints()[i].m_vPosition - vPosition).GetLengthSquared() <= fRadius * fRadius)
+      {
+        out_Points.PushBack(i);
+      }
+    }
+  }
+
+  ezVec3 RandomPosition(ezRandom& ref_rng, const ezVec3& vHalfExtents)
+  {
+    return ezVec3(ref_rng.FloatMinMax(-vHalfExtents.x, vHalfExtents.x), ref_rng.FloatMinMax(-vHalfExtents.y, vHalfExtents.y), ref_rng.FloatMinMax(-vHalfExtents.z, vHalfExtents.z));
+  }
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST(DataStructures, PointOfInterestGraph)
+{
+  ezRandom rng;
+  rng.Initialize(42);
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "FindPointsOfInterest")
+  {
+    const ezVec3 vHalfExtents(50, 50, 10);
+
+    ezPointOfInterestGraph<TestPoint> graph;
+    graph.Initialize(ezVec3::ZeroVector(), vHalfExtents, 2.0f);
+
+    for (ezUInt32 i = 0; i < 2000; ++i)
+    {
+      // some points are outside of the bounds, those must be found as well
+      const ezVec3 vPos = RandomPosition(rng, vHalfExtents * 1.2f);
+      graph.AddPoint(vPos).m_vPosition = vPos;
+    }
+
+    ezDynamicArray<ezUInt32> points, expected;
+
+    for (ezUInt32 i = 0; i < 500; ++i)
+    {
+      const ezVec3 vPos = RandomPosition(rng, vHalfExtents * 1.3f);
+      const float fRadius = rng.FloatMinMax(0.0f, 20.0f);
+
+      points.Clear();
+      graph.FindPointsOfInterest(vPos, fRadius, points);
+      FindPointsBruteForce(graph, vPos, fRadius, expected);
+
+      ezSorting::QuickSort(points, ezCompareHelper<ezUInt32>());
+      EZ_TEST_BOOL(points == expected);
+    }
+
+    // points added after a query are sorted in on the next query
+    graph.AddPoint(ezVec3(1, 2, 3)).m_vPosition = ezVec3(1, 2, 3);
+
+    points.Clear();
+    graph.FindPointsOfInterest(ezVec3(1, 2, 3), 0.0f, points);
+    EZ_TEST_BOOL(points.Contains(graph.GetPoints().GetCount() - 1));
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Batched queries")
+  {
+    const ezVec3 vHalfExtents(100, 100, 20);
+
+    ezPointOfInterestGraph<TestPoint> graph;
+    graph.Initialize(ezVec3::ZeroVector(), vHalfExtents);
+
+    for (ezUInt32 i = 0; i < 5000; ++i)
+    {
+      const ezVec3 vPos = RandomPosition(rng, vHalfExtents);
+      graph.AddPoint(vPos).m_vPosition = vPos;
+    }
+
+    ezDynamicArray<ezBoundingSphere> queries;
+    for (ezUInt32 i = 0; i < 300; ++i)
+    {
+      queries.PushBack(ezBoundingSphere(RandomPosition(rng, vHalfExtents), rng.FloatMinMax(0.0f, 15.0f)));
+    }
+
+    ezDynamicArray<ezUInt32> points, expected;
+    ezDynamicArray<ezPointOfInterestGraph<TestPoint>::QueryResult> results;
+    graph.FindPointsOfInterest(queries, points, results);
+
+    EZ_TEST_INT(results.GetCount(), queries.GetCount());
+
+    for (ezUInt32 i = 0; i < queries.GetCount(); ++i)
+    {
+      FindPointsBruteForce(graph, queries[i].m_vCenter, queries[i].m_fRadius, expected);
+
+      ezArrayPtr<ezUInt32> found = points.GetArrayPtr().GetSubArray(results[i].m_uiFirstPoint, results[i].m_uiNumPoints);
+      ezSorting::QuickSort(found, ezCompareHelper<ezUInt32>());
+
+      EZ_TEST_BOOL(found == expected.GetArrayPtr());
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Performance")
+  {
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEBUG)
+    const ezUInt32 uiNumPoints = 10000;
+    const ezUInt32 uiNumQueries = 1000;
+#else
+    const ezUInt32 uiNumPoints = 100000;
+    const ezUInt32 uiNumQueries = 10000;
+#endif
+
+    const ezVec3 vHalfExtents(500, 500, 50);
+    const float fRadius = 10.0f;
+
+    ezPointOfInterestGraph<TestPoint> graph;
+    graph.Initialize(ezVec3::ZeroVector(), vHalfExtents);
+
+    // the octree that used to be used by the graph, for comparison
+    ezDynamicOctree octree;
+    octree.CreateTree(ezVec3::ZeroVector(), vHalfExtents, 1.0f);
+
+    for (ezUInt32 i = 0; i < uiNumPoints; ++i)
+    {
+      const ezVec3 vPos = RandomPosition(rng, vHalfExtents);
+      graph.AddPoint(vPos).m_vPosition = vPos;
+      octree.InsertObject(vPos, ezVec3::ZeroVector(), 0, i, nullptr, true).IgnoreResult();
+    }
+
+    ezDynamicArray<ezBoundingSphere> queries;
+    for (ezUInt32 i = 0; i < uiNumQueries; ++i)
+    {
+      queries.PushBack(ezBoundingSphere(RandomPosition(rng, vHalfExtents), fRadius));
+    }
+
+    ezDynamicArray<ezUInt32> points;
+    ezDynamicArray<ezPointOfInterestGraph<TestPoint>::QueryResult> results;
+
+    // sorts the points
+    graph.FindPointsOfInterest(ezVec3::ZeroVector(), 0.0f, points);
+
+    ezStopwatch sw;
+
+    ezUInt32 uiNumFoundOctree = 0;
+    for (const ezBoundingSphere& query : queries)
+    {
+      auto cb = [](void* pPassThrough, ezDynamicTreeObjectConst) -> bool {
+        ++(*static_cast<ezUInt32*>(pPassThrough));
+        return true;
+      };
+
+      octree.FindObjectsInRange(query.m_vCenter, query.m_fRadius, cb, &uiNumFoundOctree);
+    }
+
+    const ezTime tOctree = sw.Checkpoint();
+
+    ezUInt32 uiNumFoundSingle = 0;
+    for (const ezBoundingSphere& query : queries)
+    {
+      points.Clear();
+      graph.FindPointsOfInterest(query.m_vCenter, query.m_fRadius, points);
+      uiNumFoundSingle += points.GetCount();
+    }
+
+    const ezTime tSingle = sw.Checkpoint();
+
+    graph.FindPointsOfInterest(queries, points, results);
+
+    const ezTime tBatched = sw.Checkpoint();
+
+    EZ_TEST_INT(points.GetCount(), uiNumFoundSingle);
+
+    ezTestFramework::Output(ezTestOutput::Duration, "%u radius queries in %u points, octree: %.2fms (%u candidates)", uiNumQueries, uiNumPoints, tOctree.GetMilliseconds(), uiNumFoundOctree);
+    ezTestFramework::Output(ezTestOutput::Duration, "%u radius queries in %u points, cells: %.2fms, batched: %.2fms (%u points)", uiNumQueries, uiNumPoints, tSingle.GetMilliseconds(), tBatched.GetMilliseconds(), uiNumFoundSingle);
+  }
+}
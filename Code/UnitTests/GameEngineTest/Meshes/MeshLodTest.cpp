@@ -0,0 +1,193 @@
+#include <GameEngineTest/GameEngineTestPCH.h>
+
+#include <Core/Graphics/Geometry.h>
+#include <Foundation/IO/MemoryStream.h>
+#include <Foundation/Time/Stopwatch.h>
+#include <RendererCore/Meshes/MeshOptimizer.h>
+#include <RendererCore/Meshes/MeshResourceDescriptor.h>
+
+namespace
+{
+  void CreateSphere(ezUInt8 uiSubDivisions, ezMeshResourceDescriptor& out_Mesh)
+  {
+    ezGeometry geom;
+    geom.AddGeodesicSphere(1.0f, uiSubDivisions);
+
+    out_Mesh.MeshBufferDesc().AddCommonStreams();
+    out_Mesh.MeshBufferDesc().AllocateStreamsFromGeometry(geom, ezGALPrimitiveTopology::Triangles);
+    out_Mesh.AddSubMesh(out_Mesh.MeshBufferDesc().GetPrimitiveCount(), 0, 0);
+    out_Mesh.ComputeBounds();
+  }
+
+  ezUInt32 GetNumLodTriangles(const ezMeshResourceDescriptor& mesh, ezUInt32 uiLod)
+  {
+    const auto& lod = mesh.GetLods()[uiLod];
+
+    ezUInt32 uiNumTriangles = 0;
+    for (ezUInt32 i = 0; i < lod.m_uiSubMeshCount; ++i)
+    {
+      uiNumTriangles += mesh.GetAllSubMeshes()[lod.m_uiFirstSubMesh + i].m_uiPrimitiveCount;
+    }
+
+    return uiNumTriangles;
+  }
+
+  bool AreIndicesValid(const ezMeshBufferResourceDescriptor& mb)
+  {
+    for (ezUInt32 i = 0; i < mb.GetPrimitiveCount() * 3; ++i)
+    {
+      const ezUInt32 uiIndex = mb.Uses32BitIndices() ? reinterpret_cast<const ezUInt32*>(mb.GetIndexBufferData().GetPtr())[i] : reinterpret_cast<const ezUInt16*>(mb.GetIndexBufferData().GetPtr())[i];
+
+      if (uiIndex >= mb.GetVertexCount())
+        return false;
+    }
+
+    return true;
+  }
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST(Meshes, MeshLods)
+{
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "No LODs")
+  {
+    ezMeshResourceDescriptor desc;
+    CreateSphere(2, desc);
+
+    EZ_TEST_INT(desc.GetLods().GetCount(), 1);
+    EZ_TEST_INT(desc.GetLods()[0].m_uiSubMeshCount, 1);
+    EZ_TEST_INT(desc.GetNumPrimitivesOfFirstLod(), desc.MeshBufferDesc().GetPrimitiveCount());
+    EZ_TEST_INT(desc.GetSubMeshes().GetCount(), desc.GetAllSubMeshes().GetCount());
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "GenerateLods")
+  {
+    ezMeshResourceDescriptor desc;
+    CreateSphere(4, desc);
+
+    const ezUInt32 uiNumTriangles = desc.MeshBufferDesc().GetPrimitiveCount();
+
+    ezMeshOptimizer::LodOptions opt;
+    opt.m_uiNumLods = 4;
+    EZ_TEST_BOOL(ezMeshOptimizer::GenerateLods(desc, opt).Succeeded());
+
+    const auto& lods = desc.GetLods();
+    EZ_TEST_BOOL(lods.GetCount() >= 2);
+    EZ_TEST_BOOL(lods.GetCount() <= opt.m_uiNumLods);
+
+    // the full detail triangles are unchanged at the start of the index buffer
+    EZ_TEST_INT(desc.GetNumPrimitivesOfFirstLod(), uiNumTriangles);
+    EZ_TEST_INT(GetNumLodTriangles(desc, 0), uiNumTriangles);
+    EZ_TEST_INT(desc.GetSubMeshes().GetCount(), 1);
+    EZ_TEST_BOOL(AreIndicesValid(desc.MeshBufferDesc()));
+
+    for (ezUInt32 uiLod = 1; uiLod < lods.GetCount(); ++uiLod)
+    {
+      EZ_TEST_BOOL(GetNumLodTriangles(desc, uiLod) < GetNumLodTriangles(desc, uiLod - 1));
+      EZ_TEST_BOOL(lods[uiLod].m_fError >= lods[uiLod - 1].m_fError);
+      EZ_TEST_BOOL(lods[uiLod].m_fError <= opt.m_fMaxError);
+      EZ_TEST_BOOL(lods[uiLod].m_fMaxScreenCoverage <= lods[uiLod - 1].m_fMaxScreenCoverage);
+      EZ_TEST_INT(lods[uiLod].m_uiSubMeshCount, 1);
+
+      const auto& subMesh = desc.GetAllSubMeshes()[lods[uiLod].m_uiFirstSubMesh];
+      EZ_TEST_BOOL(subMesh.m_uiFirstPrimitive + subMesh.m_uiPrimitiveCount <= desc.MeshBufferDesc().GetPrimitiveCount());
+
+      ezTestFramework::Output(ezTestOutput::Message, "LOD %u: %u triangles, error %.5f, screen coverage %.4f", uiLod, GetNumLodTriangles(desc, uiLod), lods[uiLod].m_fError, lods[uiLod].m_fMaxScreenCoverage);
+    }
+
+    // generating the LODs again replaces the old ones
+    const ezUInt32 uiNumLods = lods.GetCount();
+    const ezUInt32 uiNumAllTriangles = desc.MeshBufferDesc().GetPrimitiveCount();
+    EZ_TEST_BOOL(ezMeshOptimizer::GenerateLods(desc, opt).Succeeded());
+    EZ_TEST_INT(desc.GetLods().GetCount(), uiNumLods);
+    EZ_TEST_INT(desc.MeshBufferDesc().GetPrimitiveCount(), uiNumAllTriangles);
+
+    // LODs are preserved by the optimizer
+    EZ_TEST_BOOL(ezMeshOptimizer::Optimize(desc, ezMeshOptimizer::Options()).Succeeded());
+    EZ_TEST_INT(desc.GetLods().GetCount(), uiNumLods);
+    EZ_TEST_INT(desc.GetNumPrimitivesOfFirstLod(), uiNumTriangles);
+    EZ_TEST_BOOL(AreIndicesValid(desc.MeshBufferDesc()));
+
+    ezDefaultMemoryStreamStorage storage;
+    ezMemoryStreamWriter writer(&storage);
+    desc.Save(writer);
+
+    ezMeshResourceDescriptor desc2;
+    ezMemoryStreamReader reader(&storage);
+    EZ_TEST_BOOL(desc2.Load(reader).Succeeded());
+
+    EZ_TEST_INT(desc2.GetLods().GetCount(), uiNumLods);
+    EZ_TEST_INT(desc2.GetAllSubMeshes().GetCount(), desc.GetAllSubMeshes().GetCount());
+    EZ_TEST_INT(desc2.GetNumPrimitivesOfFirstLod(), uiNumTriangles);
+
+    for (ezUInt32 uiLod = 0; uiLod < uiNumLods; ++uiLod)
+    {
+      EZ_TEST_INT(desc2.GetLods()[uiLod].m_uiFirstSubMesh, desc.GetLods()[uiLod].m_uiFirstSubMesh);
+      EZ_TEST_INT(desc2.GetLods()[uiLod].m_uiSubMeshCount, desc.GetLods()[uiLod].m_uiSubMeshCount);
+      EZ_TEST_FLOAT(desc2.GetLods()[uiLod].m_fMaxScreenCoverage, desc.GetLods()[uiLod].m_fMaxScreenCoverage, 0.0f);
+      EZ_TEST_FLOAT(desc2.GetLods()[uiLod].m_fError, desc.GetLods()[uiLod].m_fError, 0.0f);
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Simplify plane")
+  {
+    // a flat grid can be simplified without any error, only its border has to stay
+    const ezUInt32 uiSize = 16;
+
+    ezDynamicArray<ezVec3> positions;
+    for (ezUInt32 y = 0; y < uiSize; ++y)
+    {
+      for (ezUInt32 x = 0; x < uiSize; ++x)
+      {
+        positions.PushBack(ezVec3((float)x, (float)y, 0.0f));
+      }
+    }
+
+    ezDynamicArray<ezUInt32> indices;
+    for (ezUInt32 y = 0; y < uiSize - 1; ++y)
+    {
+      for (ezUInt32 x = 0; x < uiSize - 1; ++x)
+      {
+        const ezUInt32 v = y * uiSize + x;
+        indices.PushBackRange(ezArrayPtr<const ezUInt32>({v, v + 1, v + uiSize + 1, v, v + uiSize + 1, v + uiSize}));
+      }
+    }
+
+    const ezUInt32 uiNumTriangles = indices.GetCount() / 3;
+
+    ezDynamicArray<ezUInt32> simplified;
+    const float fError = ezMeshOptimizer::Simplify(indices, positions, uiNumTriangles / 4, 0.01f, simplified);
+
+    EZ_TEST_FLOAT(fError, 0.0f, 0.0001f);
+    EZ_TEST_BOOL(simplified.GetCount() / 3 <= uiNumTriangles / 2);
+    EZ_TEST_INT(simplified.GetCount() % 3, 0);
+
+    // the area must not change and no triangle may flip
+    float fArea = 0.0f;
+    for (ezUInt32 t = 0; t < simplified.GetCount(); t += 3)
+    {
+      const ezVec3 vNormal = (positions[simplified[t + 1]] - positions[simplified[t]]).CrossRH(positions[simplified[t + 2]] - positions[simplified[t]]);
+      EZ_TEST_BOOL(vNormal.z > 0.0f);
+      fArea += vNormal.z * 0.5f;
+    }
+
+    EZ_TEST_FLOAT(fArea, (float)((uiSize - 1) * (uiSize - 1)), 0.001f);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Performance")
+  {
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEBUG)
+    const ezUInt8 uiSubDivisions = 5;
+#else
+    const ezUInt8 uiSubDivisions = 7;
+#endif
+
+    ezMeshResourceDescriptor desc;
+    CreateSphere(uiSubDivisions, desc);
+
+    ezStopwatch sw;
+    EZ_TEST_BOOL(ezMeshOptimizer::GenerateLods(desc, ezMeshOptimizer::LodOptions()).Succeeded());
+    const ezTime tDiff = sw.Checkpoint();
+
+    ezTestFramework::Output(ezTestOutput::Duration, "Generating %u LODs for %u triangles: %.2fms", desc.GetLods().GetCount(), desc.GetNumPrimitivesOfFirstLod(), tDiff.GetMilliseconds());
+  }
+}
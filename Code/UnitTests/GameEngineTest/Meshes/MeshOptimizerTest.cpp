@@ -0,0 +1,260 @@
+#include <GameEngineTest/GameEngineTestPCH.h>
+
+#include <Foundation/Math/Random.h>
+#include <Foundation/Time/Stopwatch.h>
+#include <RendererCore/Meshes/MeshBufferUtils.h>
+#include <RendererCore/Meshes/MeshOptimizer.h>
+#include <RendererCore/Meshes/MeshResourceDescriptor.h>
+
+EZ_CREATE_SIMPLE_TEST_GROUP(Meshes);
+
+namespace
+{
+  /// Creates a flat grid with the vertex (x, y) at position (x, y, 0) and the triangles in random order.
+  void CreateShuffledGrid(ezUInt32 uiSize, ezMeshResourceDescriptor& out_Mesh)
+  {
+    ezMeshBufferResourceDescriptor& mb = out_Mesh.MeshBufferDesc();
+    mb.AddStream(ezGALVertexAttributeSemantic::Position, ezGALResourceFormat::XYZFloat);
+    mb.AddStream(ezGALVertexAttributeSemantic::TexCoord0, ezGALResourceFormat::UVFloat);
+    mb.AddStream(ezGALVertexAttributeSemantic::Normal, ezGALResourceFormat::XYZFloat);
+
+    const ezUInt32 uiNumQuads = (uiSize - 1) * (uiSize - 1);
+    mb.AllocateStreams(uiSize * uiSize, ezGALPrimitiveTopology::Triangles, uiNumQuads * 2);
+
+    for (ezUInt32 y = 0; y < uiSize; ++y)
+    {
+      for (ezUInt32 x = 0; x < uiSize; ++x)
+      {
+        const ezUInt32 v = y * uiSize + x;
+        mb.SetVertexData<ezVec3>(0, v, ezVec3((float)x, (float)y, 0.0f));
+        mb.SetVertexData<ezVec2>(1, v, ezVec2((float)x / (uiSize - 1), (float)y / (uiSize - 1)));
+        mb.SetVertexData<ezVec3>(2, v, ezVec3(0, 0, 1));
+      }
+    }
+
+    ezDynamicArray<ezUInt32> quadOrder;
+    quadOrder.SetCountUninitialized(uiNumQuads);
+    for (ezUInt32 i = 0; i < uiNumQuads; ++i)
+    {
+      quadOrder[i] = i;
+    }
+
+    ezRandom rng;
+    rng.Initialize(42);
+
+    for (ezUInt32 i = uiNumQuads - 1; i > 0; --i)
+    {
+      ezMath::Swap(quadOrder[i], quadOrder[rng.UIntInRange(i + 1)]);
+    }
+
+    for (ezUInt32 i = 0; i < uiNumQuads; ++i)
+    {
+      const ezUInt32 x = quadOrder[i] % (uiSize - 1);
+      const ezUInt32 y = quadOrder[i] / (uiSize - 1);
+      const ezUInt32 v = y * uiSize + x;
+
+      mb.SetTriangleIndices(i * 2 + 0, v, v + 1, v + uiSize + 1);
+      mb.SetTriangleIndices(i * 2 + 1, v, v + uiSize + 1, v + uiSize);
+    }
+
+    out_Mesh.AddSubMesh(uiNumQuads * 2, 0, 0);
+    out_Mesh.ComputeBounds();
+  }
+
+  void GetIndices(const ezMeshBufferResourceDescriptor& mb, ezDynamicArray<ezUInt32>& out_Indices)
+  {
+    out_Indices.Clear();
+
+    for (ezUInt32 i = 0; i < mb.GetPrimitiveCount() * 3; ++i)
+    {
+      if (mb.Uses32BitIndices())
+        out_Indices.PushBack(reinterpret_cast<const ezUInt32*>(mb.GetIndexBufferData().GetPtr())[i]);
+      else
+        out_Indices.PushBack(reinterpret_cast<const ezUInt16*>(mb.GetIndexBufferData().GetPtr())[i]);
+    }
+  }
+
+  /// Returns every triangle as a number that doesn't depend on the vertex order, only on the grid positions and the winding.
+  void GetSortedGridTriangles(ezMeshBufferResourceDescriptor& mb, ezUInt32 uiSize, ezDynamicArray<ezUInt64>& out_Triangles)
+  {
+    ezDynamicArray<ezUInt32> indices;
+    GetIndices(mb, indices);
+
+    const ezVertexStreamInfo& positionStream = mb.GetVertexDeclaration().m_VertexStreams[0];
+
+    out_Triangles.Clear();
+
+    for (ezUInt32 t = 0; t < indices.GetCount() / 3; ++t)
+    {
+      ezUInt64 gridIndices[3];
+
+      for (ezUInt32 i = 0; i < 3; ++i)
+      {
+        ezVec3 vPos;
+        ezMeshBufferUtils::DecodeToVec3(mb.GetVertexData(0, indices[t * 3 + i]), positionStream.m_Format, vPos).IgnoreResult();
+
+        gridIndices[i] = (ezUInt64)ezMath::Round(vPos.y) * uiSize + (ezUInt64)ezMath::Round(vPos.x);
+      }
+
+      // rotate the smallest index to the front, that keeps the winding
+      while (gridIndices[0] > gridIndices[1] || gridIndices[0] > gridIndices[2])
+      {
+        const ezUInt64 first = gridIndices[0];
+        gridIndices[0] = gridIndices[1];
+        gridIndices[1] = gridIndices[2];
+        gridIndices[2] = first;
+      }
+
+      const ezUInt64 uiNumVertices = uiSize * uiSize;
+      out_Triangles.PushBack((gridIndices[0] * uiNumVertices + gridIndices[1]) * uiNumVertices + gridIndices[2]);
+    }
+
+    out_Triangles.Sort();
+  }
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST(Meshes, MeshOptimizer)
+{
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "SimulateVertexCache")
+  {
+    const ezUInt32 quad[] = {0, 1, 2, 0, 2, 3};
+    EZ_TEST_INT(ezMeshOptimizer::SimulateVertexCache(ezMakeArrayPtr(quad), 4), 4);
+
+    // with a cache of size 3, vertex 1 is evicted by the time the last triangle uses it again
+    const ezUInt32 strip[] = {0, 1, 2, 2, 3, 4, 4, 1, 0};
+    EZ_TEST_INT(ezMeshOptimizer::SimulateVertexCache(ezMakeArrayPtr(strip), 5, 3), 7);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "OptimizeVertexFetch")
+  {
+    ezUInt32 indices[] = {3, 1, 4, 1, 4, 2};
+
+    ezDynamicArray<ezUInt32> remap;
+    ezMeshOptimizer::OptimizeVertexFetch(ezMakeArrayPtr(indices), 6, remap);
+
+    const ezUInt32 expectedIndices[] = {0, 1, 2, 1, 2, 3};
+    EZ_TEST_BOOL(ezMakeArrayPtr(indices) == ezMakeArrayPtr(expectedIndices));
+
+    // unused vertices 0 and 5 go to the end
+    const ezUInt32 expectedRemap[] = {4, 1, 3, 0, 2, 5};
+    EZ_TEST_BOOL(remap.GetArrayPtr() == ezMakeArrayPtr(expectedRemap));
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Optimize")
+  {
+    const ezUInt32 uiSize = 64;
+
+    ezMeshResourceDescriptor mesh;
+    CreateShuffledGrid(uiSize, mesh);
+
+    ezDynamicArray<ezUInt64> trianglesBefore;
+    GetSortedGridTriangles(mesh.MeshBufferDesc(), uiSize, trianglesBefore);
+
+    ezMeshOptimizer::Statistics before, after;
+    EZ_TEST_BOOL(ezMeshOptimizer::Optimize(mesh, ezMeshOptimizer::Options(), &before, &after).Succeeded());
+
+    EZ_TEST_INT(before.m_uiNumTriangles, after.m_uiNumTriangles);
+    EZ_TEST_INT(before.m_uiNumVertices, after.m_uiNumVertices);
+    EZ_TEST_BOOL(before.GetACMR() > 2.0f);
+    EZ_TEST_BOOL(after.GetACMR() < 1.0f);
+    EZ_TEST_BOOL(after.GetATVR() < before.GetATVR());
+
+    // the same triangles are still there, with the same winding
+    ezDynamicArray<ezUInt64> trianglesAfter;
+    GetSortedGridTriangles(mesh.MeshBufferDesc(), uiSize, trianglesAfter);
+    EZ_TEST_BOOL(trianglesBefore == trianglesAfter);
+
+    // the vertices are in the order of their first use
+    ezDynamicArray<ezUInt32> indices;
+    GetIndices(mesh.MeshBufferDesc(), indices);
+
+    ezUInt32 uiNextVertex = 0;
+    bool bFirstUseOrder = true;
+    for (ezUInt32 uiIndex : indices)
+    {
+      if (uiIndex == uiNextVertex)
+        ++uiNextVertex;
+      else if (uiIndex > uiNextVertex)
+        bFirstUseOrder = false;
+    }
+
+    EZ_TEST_BOOL(bFirstUseOrder);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "QuantizeVertices")
+  {
+    const ezUInt32 uiSize = 32;
+
+    ezMeshResourceDescriptor mesh;
+    CreateShuffledGrid(uiSize, mesh);
+
+    ezMeshBufferResourceDescriptor& mb = mesh.MeshBufferDesc();
+    const ezUInt32 uiVertexSizeBefore = mb.GetVertexDataSize();
+
+    ezDynamicArray<ezUInt64> trianglesBefore;
+    GetSortedGridTriangles(mb, uiSize, trianglesBefore);
+
+    EZ_TEST_BOOL(ezMeshOptimizer::QuantizeVertices(mb).Succeeded());
+
+    EZ_TEST_BOOL(mb.GetVertexDeclaration().m_VertexStreams[0].m_Format == ezGALResourceFormat::RGBAHalf);
+    EZ_TEST_BOOL(mb.GetVertexDataSize() < uiVertexSizeBefore);
+    EZ_TEST_INT(mb.GetVertexCount(), uiSize * uiSize);
+
+    for (ezUInt32 v = 0; v < mb.GetVertexCount(); ++v)
+    {
+      ezVec3 vPos, vNormal;
+      ezVec2 vTexCoord;
+      EZ_TEST_BOOL(ezMeshBufferUtils::DecodeToVec3(mb.GetVertexData(0, v), mb.GetVertexDeclaration().m_VertexStreams[0].m_Format, vPos).Succeeded());
+      EZ_TEST_BOOL(ezMeshBufferUtils::DecodeTexCoord(mb.GetVertexData(1, v), mb.GetVertexDeclaration().m_VertexStreams[1].m_Format, vTexCoord).Succeeded());
+      EZ_TEST_BOOL(ezMeshBufferUtils::DecodeNormal(mb.GetVertexData(2, v), mb.GetVertexDeclaration().m_VertexStreams[2].m_Format, vNormal).Succeeded());
+
+      EZ_TEST_VEC3(vPos, ezVec3((float)(v % uiSize), (float)(v / uiSize), 0.0f), 0.01f);
+      EZ_TEST_VEC2(vTexCoord, ezVec2((float)(v % uiSize), (float)(v / uiSize)) / (float)(uiSize - 1), 0.001f);
+      EZ_TEST_VEC3(vNormal, ezVec3(0, 0, 1), 0.01f);
+    }
+
+    ezDynamicArray<ezUInt64> trianglesAfter;
+    GetSortedGridTriangles(mb, uiSize, trianglesAfter);
+    EZ_TEST_BOOL(trianglesBefore == trianglesAfter);
+
+    // the bounds can still be computed from the quantized positions
+    EZ_TEST_FLOAT(mb.ComputeBounds().GetBox().m_vMax.x, (float)(uiSize - 1), 0.01f);
+
+    // CPU side users like the navmesh generation decode the quantized positions
+    ezDynamicArray<ezVec3> positions;
+    ezDynamicArray<ezVec3> normals;
+    EZ_TEST_BOOL(ezMeshBufferUtils::DecodePositions(mb, positions).Succeeded());
+    EZ_TEST_BOOL(ezMeshBufferUtils::DecodeNormals(mb, normals).Succeeded());
+    EZ_TEST_INT(positions.GetCount(), mb.GetVertexCount());
+    EZ_TEST_INT(normals.GetCount(), mb.GetVertexCount());
+
+    for (ezUInt32 v = 0; v < positions.GetCount(); ++v)
+    {
+      EZ_TEST_VEC3(positions[v], ezVec3((float)(v % uiSize), (float)(v / uiSize), 0.0f), 0.01f);
+      EZ_TEST_VEC3(normals[v], ezVec3(0, 0, 1), 0.01f);
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Optimization Performance")
+  {
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEBUG)
+    const ezUInt32 uiSize = 128;
+#else
+    const ezUInt32 uiSize = 512;
+#endif
+
+    ezMeshResourceDescriptor mesh;
+    CreateShuffledGrid(uiSize, mesh);
+
+    ezStopwatch sw;
+
+    ezMeshOptimizer::Statistics before, after;
+    EZ_TEST_BOOL(ezMeshOptimizer::Optimize(mesh, ezMeshOptimizer::Options(), &before, &after).Succeeded());
+
+    const ezTime tDiff = sw.Checkpoint();
+
+    ezTestFramework::Output(ezTestOutput::Duration, "%u triangles: ACMR %.3f -> %.3f, ATVR %.3f -> %.3f in %.2fms", after.m_uiNumTriangles, before.GetACMR(), after.GetACMR(), before.GetATVR(), after.GetATVR(), tDiff.GetMilliseconds());
+
+    EZ_TEST_BOOL(after.GetACMR() < before.GetACMR());
+  }
+}
@@ -0,0 +1,501 @@
+#include <GameEngineTest/GameEngineTestPCH.h>
+
+#ifdef BUILDSYSTEM_ENABLE_RECAST_SUPPORT
+
+#  include <Foundation/IO/MemoryStream.h>
+#  include <Foundation/Math/Random.h>
+#  include <Foundation/Time/Time.h>
+#  include <Foundation/Utilities/Progress.h>
+#  include <GameEngineTest/TestClass/SyntheticGeometry.h>
+#  include <RecastPlugin/Components/RecastAgentComponent.h>
+#  include <RecastPlugin/NavMeshBuilder/NavMeshBuilder.h>
+#  include <RecastPlugin/Resources/RecastNavMeshResource.h>
+#  include <RecastPlugin/Utils/RcMath.h>
+#  include <RecastPlugin/WorldModule/RecastWorldModule.h>
+
+EZ_CREATE_SIMPLE_TEST_GROUP(Navigation);
+
+namespace RecastNavMeshBuilderTestDetail
+{
+  using namespace ezSyntheticGeometry;
+
+  /// Creates a flat level of the given size with a regular pattern of pillars on it.
+  /// The pillar with index uiMovedPillar is shifted, to simulate a local change of the level.
+  static void CreateSyntheticLevel(
+    float fLevelSize, ezUInt32 uiMovedPillar, ezDynamicArray<ezVec3>& out_Vertices, ezDynamicArray<ezUInt32>& out_Indices)
+  {
+    out_Vertices.Clear();
+    out_Indices.Clear();
+
+    const float fCellSize = 8.0f;
+    const ezUInt32 uiNumCells = static_cast<ezUInt32>(fLevelSize / fCellSize);
+
+    ezUInt32 uiPillar = 0;
+
+    for (ezUInt32 y = 0; y < uiNumCells; ++y)
+    {
+      for (ezUInt32 x = 0; x < uiNumCells; ++x)
+      {
+        const float fX = x * fCellSize;
+        const float fY = y * fCellSize;
+
+        // ground, clockwise when seen from above
+        AddQuad(out_Vertices, out_Indices, ezVec3(fX, fY, 0), ezVec3(fX + fCellSize, fY, 0), ezVec3(fX + fCellSize, fY + fCellSize, 0),
+          ezVec3(fX, fY + fCellSize, 0));
+
+        if ((x % 2) == 1 && (y % 2) == 1)
+        {
+          const float fShift = (uiPillar == uiMovedPillar) ? 3.0f : 0.0f;
+          AddBox(out_Vertices, out_Indices, ezVec3(fX + 1.0f + fShift, fY + 1.0f, 0), ezVec3(fX + 3.0f + fShift, fY + 3.0f, 4.0f));
+          ++uiPillar;
+        }
+      }
+    }
+  }
+
+  /// Returns a position on the ground of the synthetic level, which is never blocked by a pillar.
+  static ezVec3 GetRandomFreePosition(ezRandom& rng, float fLevelSize)
+  {
+    const ezUInt32 uiNumCells = static_cast<ezUInt32>(fLevelSize / 8.0f);
+    return ezVec3(rng.UIntInRange(uiNumCells) * 8.0f + 6.0f, rng.UIntInRange(uiNumCells) * 8.0f + 6.0f, 0.0f);
+  }
+} // namespace RecastNavMeshBuilderTestDetail
+
+EZ_CREATE_SIMPLE_TEST(Navigation, RecastNavMeshBuilder)
+{
+  using namespace RecastNavMeshBuilderTestDetail;
+
+  const float fLevelSize = 256.0f;
+
+  ezRecastConfig config;
+  config.m_fTileSize = 32.0f;
+
+  ezDynamicArray<ezVec3> vertices;
+  ezDynamicArray<ezUInt32> indices;
+  CreateSyntheticLevel(fLevelSize, ezInvalidIndex, vertices, indices);
+
+  ezRecastNavMeshResourceDescriptor fullBuild;
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Full Build")
+  {
+    ezRecastNavMeshBuilder builder;
+    ezProgress progress;
+
+    const ezTime tStart = ezTime::Now();
+    EZ_TEST_BOOL(builder.Build(config, vertices, indices, fullBuild, progress).Succeeded());
+    const ezTime tDiff = ezTime::Now() - tStart;
+
+    ezTestFramework::Output(ezTestOutput::Duration, "Full navmesh build (%u tiles): %.2fms", builder.GetNumTilesGenerated(), tDiff.GetMilliseconds());
+
+    // 256m / 32m = 8 tiles per axis
+    EZ_TEST_INT(fullBuild.m_Tiles.GetCount(), 64);
+    EZ_TEST_INT(builder.GetNumTilesGenerated(), 64);
+    EZ_TEST_FLOAT(fullBuild.m_fTileWorldSize, 32.0f, 0.01f);
+
+    for (const auto& tile : fullBuild.m_Tiles)
+    {
+      EZ_TEST_BOOL(!tile.m_DetourTileData.IsEmpty());
+      EZ_TEST_BOOL(tile.m_uiInputHash != 0);
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Single Tile")
+  {
+    ezRecastConfig singleTileConfig = config;
+    singleTileConfig.m_fTileSize = 0.0f;
+
+    ezRecastNavMeshBuilder builder;
+    ezProgress progress;
+    ezRecastNavMeshResourceDescriptor desc;
+
+    const ezTime tStart = ezTime::Now();
+    EZ_TEST_BOOL(builder.Build(singleTileConfig, vertices, indices, desc, progress).Succeeded());
+    const ezTime tDiff = ezTime::Now() - tStart;
+
+    ezTestFramework::Output(ezTestOutput::Duration, "Single tile navmesh build: %.2fms", tDiff.GetMilliseconds());
+
+    EZ_TEST_INT(desc.m_Tiles.GetCount(), 1);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Serialization")
+  {
+    ezDefaultMemoryStreamStorage storage;
+    ezMemoryStreamWriter writer(&storage);
+    EZ_TEST_BOOL(fullBuild.Serialize(writer).Succeeded());
+
+    ezMemoryStreamReader reader(&storage);
+    ezRecastNavMeshResourceDescriptor desc;
+    EZ_TEST_BOOL(desc.Deserialize(reader).Succeeded());
+
+    EZ_TEST_INT(desc.m_Tiles.GetCount(), fullBuild.m_Tiles.GetCount());
+    EZ_TEST_FLOAT(desc.m_fTileWorldSize, fullBuild.m_fTileWorldSize, 0.0f);
+    EZ_TEST_VEC3(desc.m_vTileGridOrigin, fullBuild.m_vTileGridOrigin, 0.0f);
+
+    for (const auto& tile : fullBuild.m_Tiles)
+    {
+      const ezUInt32 uiTile = desc.FindTile(tile.m_iTileX, tile.m_iTileY);
+      if (EZ_TEST_BOOL(uiTile != ezInvalidIndex))
+      {
+        EZ_TEST_BOOL(desc.m_Tiles[uiTile].m_uiInputHash == tile.m_uiInputHash);
+        EZ_TEST_BOOL(desc.m_Tiles[uiTile].m_DetourTileData == tile.m_DetourTileData);
+      }
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Rebuild Tiles Limit")
+  {
+    ezWorldGeoExtractionUtil::MeshObjectList worldGeo;
+    ezRecastNavMeshBuilder builder;
+    ezProgress progress;
+    ezDynamicArray<ezRecastNavMeshTile> tiles;
+
+    // one tile, which became empty
+    ezBoundingBox area;
+    area.SetCenterAndHalfExtents(ezVec3(48, 48, 0), ezVec3(1.0f));
+    EZ_TEST_BOOL(builder.RebuildTiles(config, worldGeo, area, fullBuild, tiles, progress).Succeeded());
+    EZ_TEST_INT(tiles.GetCount(), 1);
+
+    // far more tiles than the navmesh can hold
+    area.SetCenterAndHalfExtents(ezVec3(0.0f), ezVec3(100000.0f));
+    EZ_TEST_BOOL(builder.RebuildTiles(config, worldGeo, area, fullBuild, tiles, progress).Failed());
+    EZ_TEST_BOOL(tiles.IsEmpty());
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Incremental Build")
+  {
+    // nothing changed -> every tile is reused
+    {
+      ezRecastNavMeshBuilder builder;
+      ezProgress progress;
+      ezRecastNavMeshResourceDescriptor desc;
+
+      EZ_TEST_BOOL(builder.Build(config, vertices, indices, desc, progress, &fullBuild).Succeeded());
+      EZ_TEST_INT(builder.GetNumTilesGenerated(), 0);
+      EZ_TEST_INT(desc.m_Tiles.GetCount(), 64);
+
+      fullBuild = std::move(desc);
+    }
+
+    // a single pillar moved -> only the tiles around it are generated again
+    {
+      CreateSyntheticLevel(fLevelSize, 20, vertices, indices);
+
+      ezRecastNavMeshBuilder builder;
+      ezProgress progress;
+      ezRecastNavMeshResourceDescriptor desc;
+
+      const ezTime tStart = ezTime::Now();
+      EZ_TEST_BOOL(builder.Build(config, vertices, indices, desc, progress, &fullBuild).Succeeded());
+      const ezTime tDiff = ezTime::Now() - tStart;
+
+      ezTestFramework::Output(ezTestOutput::Duration, "Incremental navmesh build (%u tiles): %.2fms", builder.GetNumTilesGenerated(), tDiff.GetMilliseconds());
+
+      EZ_TEST_BOOL(builder.GetNumTilesGenerated() > 0);
+      EZ_TEST_BOOL(builder.GetNumTilesGenerated() <= 4);
+      EZ_TEST_INT(desc.m_Tiles.GetCount(), 64);
+    }
+  }
+}
+
+EZ_CREATE_SIMPLE_TEST(Navigation, RecastPathQueries)
+{
+  using namespace RecastNavMeshBuilderTestDetail;
+
+  const float fLevelSize = 256.0f;
+  const ezUInt32 uiNumAgents = 5000;
+
+  ezRecastNavMeshResourceHandle hNavMesh;
+  {
+    ezDynamicArray<ezVec3> vertices;
+    ezDynamicArray<ezUInt32> indices;
+    CreateSyntheticLevel(fLevelSize, ezInvalidIndex, vertices, indices);
+
+    ezRecastNavMeshBuilder builder;
+    ezProgress progress;
+    ezRecastNavMeshResourceDescriptor desc;
+
+    EZ_TEST_BOOL(builder.Build(ezRecastConfig(), vertices, indices, desc, progress).Succeeded());
+
+    hNavMesh = ezResourceManager::GetOrCreateResource<ezRecastNavMeshResource>("RecastPathQueriesTestNavMesh", std::move(desc));
+  }
+
+  ezRandom rng;
+  rng.Initialize(42);
+
+  ezDynamicArray<ezVec3> startPositions;
+  ezDynamicArray<ezVec3> targetPositions;
+
+  for (ezUInt32 i = 0; i < uiNumAgents; ++i)
+  {
+    startPositions.PushBack(GetRandomFreePosition(rng, fLevelSize));
+    targetPositions.PushBack(GetRandomFreePosition(rng, fLevelSize));
+  }
+
+  ezWorldDesc worldDesc("RecastPathQueries");
+  ezWorld world(worldDesc);
+  EZ_LOCK(world.GetWriteMarker());
+
+  ezRecastWorldModule* pModule = world.GetOrCreateModule<ezRecastWorldModule>();
+  pModule->SetNavMeshResource(hNavMesh);
+
+  // picks up the navmesh and creates the query objects
+  world.Update();
+
+  if (!EZ_TEST_BOOL(pModule->GetNavMeshQuery() != nullptr))
+    return;
+
+  const dtQueryFilter filter;
+  ezUInt32 uiNumSyncPaths = 0;
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Synchronous")
+  {
+    // what every agent did before: one findPath call per agent on the main thread
+    dtNavMeshQuery query;
+    query.init(pModule->GetDetourNavMesh(), 2048);
+
+    const ezVec3 vExtents(0.01f, 1.0f, 0.01f);
+    dtPolyRef corridor[256];
+
+    const ezTime tStart = ezTime::Now();
+
+    for (ezUInt32 i = 0; i < uiNumAgents; ++i)
+    {
+      ezRcPos rcStart = startPositions[i];
+      ezRcPos rcTarget = targetPositions[i];
+      ezRcPos rcStartOnNavMesh, rcTargetOnNavMesh;
+      dtPolyRef startPoly = 0, targetPoly = 0;
+      int iCorridorLength = 0;
+
+      query.findNearestPoly(rcStart, &vExtents.x, &filter, &startPoly, rcStartOnNavMesh);
+      query.findNearestPoly(rcTarget, &vExtents.x, &filter, &targetPoly, rcTargetOnNavMesh);
+
+      if (dtStatusSucceed(query.findPath(startPoly, targetPoly, rcStartOnNavMesh, rcTarget, &filter, corridor, &iCorridorLength, 256)) &&
+          iCorridorLength > 0 && corridor[iCorridorLength - 1] == targetPoly)
+      {
+        ++uiNumSyncPaths;
+      }
+    }
+
+    const ezTime tDiff = ezTime::Now() - tStart;
+    ezTestFramework::Output(ezTestOutput::Duration, "Synchronous path search for %u agents: %.2fms", uiNumAgents, tDiff.GetMilliseconds());
+
+    EZ_TEST_INT(uiNumSyncPaths, uiNumAgents);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Batched")
+  {
+    pModule->SetPathSearchBudget(1024 * 1024);
+
+    ezDynamicArray<ezRecastPathRequestId> requests;
+    for (ezUInt32 i = 0; i < uiNumAgents; ++i)
+    {
+      requests.PushBack(pModule->RequestPath(startPositions[i], targetPositions[i], filter));
+    }
+
+    const ezTime tStart = ezTime::Now();
+
+    ezUInt32 uiNumFrames = 0;
+    ezUInt32 uiNumFinished = 0;
+    ezUInt32 uiNumSucceeded = 0;
+    ezRecastPathResult result;
+
+    while (uiNumFinished < uiNumAgents && uiNumFrames < 1000)
+    {
+      world.Update();
+      ++uiNumFrames;
+
+      for (auto& id : requests)
+      {
+        if (id.IsInvalidated())
+          continue;
+
+        const ezRecastPathRequestState::Enum state = pModule->PollPathRequest(id, result);
+        if (state == ezRecastPathRequestState::Pending)
+          continue;
+
+        id.Invalidate();
+        ++uiNumFinished;
+
+        if (state == ezRecastPathRequestState::Succeeded)
+        {
+          ++uiNumSucceeded;
+        }
+      }
+    }
+
+    const ezTime tDiff = ezTime::Now() - tStart;
+    ezTestFramework::Output(ezTestOutput::Duration, "Batched path search for %u agents: %.2fms, %u frames", uiNumAgents, tDiff.GetMilliseconds(), uiNumFrames);
+
+    EZ_TEST_INT(uiNumFinished, uiNumAgents);
+    EZ_TEST_INT(uiNumSucceeded, uiNumSyncPaths);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Budget")
+  {
+    // with a tiny budget, the searches have to be spread across several frames
+    pModule->SetPathSearchBudget(64);
+
+    const ezRecastPathRequestId id = pModule->RequestPath(ezVec3(6, 6, 0), ezVec3(fLevelSize - 2.0f, fLevelSize - 2.0f, 0), filter);
+
+    ezRecastPathResult result;
+    EZ_TEST_INT(pModule->PollPathRequest(id, result), ezRecastPathRequestState::Pending);
+
+    ezUInt32 uiNumFrames = 0;
+    ezRecastPathRequestState::Enum state = ezRecastPathRequestState::Pending;
+
+    while (state == ezRecastPathRequestState::Pending && uiNumFrames < 1000)
+    {
+      world.Update();
+      ++uiNumFrames;
+
+      state = pModule->PollPathRequest(id, result);
+    }
+
+    EZ_TEST_INT(state, ezRecastPathRequestState::Succeeded);
+    EZ_TEST_BOOL(uiNumFrames > 1);
+    EZ_TEST_BOOL(!result.m_Corridor.IsEmpty());
+
+    // the result can only be retrieved once
+    EZ_TEST_INT(pModule->PollPathRequest(id, result), ezRecastPathRequestState::Invalid);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Cancel")
+  {
+    const ezRecastPathRequestId id = pModule->RequestPath(ezVec3(6, 6, 0), ezVec3(14, 14, 0), filter);
+    pModule->CancelPathRequest(id);
+
+    world.Update();
+
+    ezRecastPathResult result;
+    EZ_TEST_INT(pModule->PollPathRequest(id, result), ezRecastPathRequestState::Invalid);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Invalid Positions")
+  {
+    pModule->SetPathSearchBudget(1024 * 16);
+
+    const ezRecastPathRequestId id0 = pModule->RequestPath(ezVec3(-100, -100, 0), ezVec3(6, 6, 0), filter);
+    const ezRecastPathRequestId id1 = pModule->RequestPath(ezVec3(6, 6, 0), ezVec3(6, 6, 50), filter);
+
+    world.Update();
+
+    ezRecastPathResult result;
+    EZ_TEST_INT(pModule->PollPathRequest(id0, result), ezRecastPathRequestState::StartNotOnNavMesh);
+    EZ_TEST_INT(pModule->PollPathRequest(id1, result), ezRecastPathRequestState::TargetNotOnNavMesh);
+  }
+}
+
+EZ_CREATE_SIMPLE_TEST(Navigation, RecastAgentNavMeshUnload)
+{
+  using namespace RecastNavMeshBuilderTestDetail;
+
+  const float fLevelSize = 64.0f;
+
+  auto CreateNavMesh = [&]() -> ezRecastNavMeshResourceHandle {
+    ezDynamicArray<ezVec3> vertices;
+    ezDynamicArray<ezUInt32> indices;
+    CreateSyntheticLevel(fLevelSize, ezInvalidIndex, vertices, indices);
+
+    ezRecastNavMeshBuilder builder;
+    ezProgress progress;
+    ezRecastNavMeshResourceDescriptor desc;
+
+    EZ_TEST_BOOL(builder.Build(ezRecastConfig(), vertices, indices, desc, progress).Succeeded());
+
+    return ezResourceManager::GetOrCreateResource<ezRecastNavMeshResource>("RecastAgentNavMeshUnloadTestNavMesh", std::move(desc));
+  };
+
+  ezRecastNavMeshResourceHandle hNavMesh = CreateNavMesh();
+
+  ezWorldDesc worldDesc("RecastAgentNavMeshUnload");
+  ezWorld world(worldDesc);
+  EZ_LOCK(world.GetWriteMarker());
+
+  world.SetWorldSimulationEnabled(true);
+  world.GetClock().SetFixedTimeStep(ezTime::Milliseconds(20));
+
+  ezRecastWorldModule* pModule = world.GetOrCreateModule<ezRecastWorldModule>();
+  pModule->SetNavMeshResource(hNavMesh);
+
+  const ezVec3 vStart(6, 6, 0);
+  const ezVec3 vTarget(fLevelSize - 2.0f, fLevelSize - 2.0f, 0);
+
+  ezGameObject* pAgentObject = nullptr;
+  {
+    ezGameObjectDesc desc;
+    desc.m_LocalPosition = vStart;
+    world.CreateObject(desc, pAgentObject);
+  }
+
+  ezRcAgentComponent* pAgent = nullptr;
+  ezRcAgentComponent::CreateComponent(pAgentObject, pAgent);
+
+  // starts the simulation of the agent, which clears any previous target
+  world.Update();
+
+  pAgent->SetTargetPosition(vTarget);
+
+  auto WaitForPath = [&]() {
+    for (ezUInt32 uiFrame = 0; uiFrame < 100 && pAgent->GetPathToTargetState() != ezAgentPathFindingState::HasTargetAndValidPath; ++uiFrame)
+    {
+      world.Update();
+    }
+
+    return pAgent->GetPathToTargetState() == ezAgentPathFindingState::HasTargetAndValidPath;
+  };
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Move")
+  {
+    EZ_TEST_BOOL(WaitForPath());
+
+    for (ezUInt32 uiFrame = 0; uiFrame < 10; ++uiFrame)
+    {
+      world.Update();
+    }
+
+    EZ_TEST_BOOL((pAgentObject->GetGlobalPosition() - vStart).GetLength() > 0.1f);
+    EZ_TEST_INT(pAgent->GetPathToTargetState(), ezAgentPathFindingState::HasTargetAndValidPath);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Unload while moving")
+  {
+    // the module drops its queries right away, the agents update before it picks up a new navmesh
+    pModule->SetNavMeshResource(ezRecastNavMeshResourceHandle());
+    world.Update();
+
+    // unloading the resource itself must not bring the agent back either
+    hNavMesh.Invalidate();
+    ezResourceManager::FreeAllUnusedResources();
+
+    const ezVec3 vPosition = pAgentObject->GetGlobalPosition();
+
+    for (ezUInt32 uiFrame = 0; uiFrame < 5; ++uiFrame)
+    {
+      world.Update();
+    }
+
+    // the agent stops, but keeps its target until a navmesh is available again
+    EZ_TEST_VEC3(pAgentObject->GetGlobalPosition(), vPosition, 0.0f);
+    EZ_TEST_INT(pAgent->GetPathToTargetState(), ezAgentPathFindingState::HasTargetWaitingForPath);
+    EZ_TEST_VEC3(pAgent->GetTargetPosition(), vTarget, 0.0f);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Reload")
+  {
+    hNavMesh = CreateNavMesh();
+    pModule->SetNavMeshResource(hNavMesh);
+
+    const ezVec3 vPosition = pAgentObject->GetGlobalPosition();
+
+    EZ_TEST_BOOL(WaitForPath());
+
+    for (ezUInt32 uiFrame = 0; uiFrame < 10; ++uiFrame)
+    {
+      world.Update();
+    }
+
+    EZ_TEST_BOOL((pAgentObject->GetGlobalPosition() - vPosition).GetLength() > 0.1f);
+  }
+}
+
+#endif
@@ -0,0 +1,191 @@
+#include <GameEngineTest/GameEngineTestPCH.h>
+
+#ifdef BUILDSYSTEM_ENABLE_JOLT_SUPPORT
+
+#  include <Core/Interfaces/PhysicsWorldModule.h>
+#  include <Core/World/World.h>
+#  include <Foundation/Math/Random.h>
+#  include <Foundation/Time/Time.h>
+
+EZ_CREATE_SIMPLE_TEST_GROUP(Physics);
+
+namespace JoltQueriesTestDetail
+{
+  /// Creates a ground plate with a regular pattern of static boxes on it.
+  static void CreateSyntheticLevel(ezWorld& world, ezPhysicsWorldModuleInterface* pModule, float fLevelSize)
+  {
+    ezGameObjectDesc desc;
+    desc.m_LocalPosition.Set(fLevelSize * 0.5f, fLevelSize * 0.5f, -0.5f);
+
+    ezGameObject* pObject = nullptr;
+    world.CreateObject(desc, pObject);
+    pModule->AddStaticCollisionBox(pObject, ezVec3(fLevelSize, fLevelSize, 1.0f));
+
+    for (float y = 4.0f; y < fLevelSize; y += 8.0f)
+    {
+      for (float x = 4.0f; x < fLevelSize; x += 8.0f)
+      {
+        desc.m_LocalPosition.Set(x, y, 2.0f);
+        world.CreateObject(desc, pObject);
+        pModule->AddStaticCollisionBox(pObject, ezVec3(2.0f, 2.0f, 4.0f));
+      }
+    }
+  }
+
+  static void CreateRandomRays(ezRandom& rng, float fLevelSize, ezUInt32 uiNumRays, ezDynamicArray<ezPhysicsRaycastRequest>& out_Rays)
+  {
+    out_Rays.SetCountUninitialized(uiNumRays);
+
+    for (ezPhysicsRaycastRequest& ray : out_Rays)
+    {
+      ray.m_vStart.Set((float)rng.DoubleMinMax(0.0, fLevelSize), (float)rng.DoubleMinMax(0.0, fLevelSize), (float)rng.DoubleMinMax(0.5, 6.0));
+      ray.m_vDir.Set((float)rng.DoubleMinMax(-1.0, 1.0), (float)rng.DoubleMinMax(-1.0, 1.0), (float)rng.DoubleMinMax(-1.0, 0.1));
+      ray.m_vDir.NormalizeIfNotZero(ezVec3(0, 0, -1)).IgnoreResult();
+      ray.m_fDistance = 20.0f;
+    }
+  }
+} // namespace JoltQueriesTestDetail
+
+EZ_CREATE_SIMPLE_TEST(Physics, JoltBatchedQueries)
+{
+  using namespace JoltQueriesTestDetail;
+
+  const float fLevelSize = 256.0f;
+
+  ezWorldDesc worldDesc("JoltBatchedQueries");
+  ezWorld world(worldDesc);
+  EZ_LOCK(world.GetWriteMarker());
+
+  // the Jolt plugin is linked, so it provides the physics implementation
+  ezPhysicsWorldModuleInterface* pModule = world.GetOrCreateModule<ezPhysicsWorldModuleInterface>();
+  if (!EZ_TEST_BOOL(pModule != nullptr))
+    return;
+
+  CreateSyntheticLevel(world, pModule, fLevelSize);
+
+  // creates and adds all bodies
+  world.Update();
+
+  ezRandom rng;
+  rng.Initialize(42);
+
+  const ezPhysicsQueryParameters params(0);
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Raycast Batch")
+  {
+    ezDynamicArray<ezPhysicsRaycastRequest> rays;
+    CreateRandomRays(rng, fLevelSize, 2000, rays);
+
+    ezDynamicArray<ezPhysicsCastResult> results;
+    ezDynamicArray<bool> hits;
+    results.SetCount(rays.GetCount());
+    hits.SetCount(rays.GetCount());
+
+    const ezUInt32 uiNumHits = pModule->RaycastBatch(rays, results, hits, params);
+    EZ_TEST_BOOL(uiNumHits > 0);
+
+    ezUInt32 uiNumSingleHits = 0;
+    for (ezUInt32 i = 0; i < rays.GetCount(); ++i)
+    {
+      ezPhysicsCastResult result;
+      const bool bHit = pModule->Raycast(result, rays[i].m_vStart, rays[i].m_vDir, rays[i].m_fDistance, params);
+      EZ_TEST_BOOL(bHit == hits[i]);
+
+      if (bHit)
+      {
+        ++uiNumSingleHits;
+
+        if (hits[i])
+        {
+          EZ_TEST_FLOAT(result.m_fDistance, results[i].m_fDistance, 0.001f);
+          EZ_TEST_VEC3(result.m_vNormal, results[i].m_vNormal, 0.001f);
+        }
+      }
+    }
+
+    EZ_TEST_INT(uiNumHits, uiNumSingleHits);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Sphere Sweep Batch")
+  {
+    ezDynamicArray<ezPhysicsRaycastRequest> rays;
+    CreateRandomRays(rng, fLevelSize, 500, rays);
+
+    ezDynamicArray<ezPhysicsSweepSphereRequest> sweeps;
+    for (const ezPhysicsRaycastRequest& ray : rays)
+    {
+      ezPhysicsSweepSphereRequest& sweep = sweeps.ExpandAndGetRef();
+      sweep.m_vStart = ray.m_vStart + ezVec3(0, 0, 1);
+      sweep.m_vDir = ray.m_vDir;
+      sweep.m_fDistance = ray.m_fDistance;
+      sweep.m_fSphereRadius = 0.25f;
+    }
+
+    ezDynamicArray<ezPhysicsCastResult> results;
+    ezDynamicArray<bool> hits;
+    results.SetCount(sweeps.GetCount());
+    hits.SetCount(sweeps.GetCount());
+
+    const ezUInt32 uiNumHits = pModule->SweepTestSphereBatch(sweeps, results, hits, params);
+
+    ezUInt32 uiNumSingleHits = 0;
+    for (ezUInt32 i = 0; i < sweeps.GetCount(); ++i)
+    {
+      ezPhysicsCastResult result;
+      const bool bHit = pModule->SweepTestSphere(result, sweeps[i].m_fSphereRadius, sweeps[i].m_vStart, sweeps[i].m_vDir, sweeps[i].m_fDistance, params);
+      EZ_TEST_BOOL(bHit == hits[i]);
+
+      uiNumSingleHits += bHit ? 1 : 0;
+    }
+
+    EZ_TEST_INT(uiNumHits, uiNumSingleHits);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Raycast Performance")
+  {
+#  if EZ_ENABLED(EZ_COMPILE_FOR_DEBUG)
+    const ezUInt32 uiNumRays = 5000;
+    const ezUInt32 uiNumFrames = 1;
+#  else
+    const ezUInt32 uiNumRays = 20000;
+    const ezUInt32 uiNumFrames = 3;
+#  endif
+
+    ezDynamicArray<ezPhysicsRaycastRequest> rays;
+    CreateRandomRays(rng, fLevelSize, uiNumRays, rays);
+
+    ezDynamicArray<ezPhysicsCastResult> results;
+    ezDynamicArray<bool> hits;
+    results.SetCount(rays.GetCount());
+    hits.SetCount(rays.GetCount());
+
+    // what every caller did before: one virtual call per ray on the calling thread
+    ezTime tSingle;
+    for (ezUInt32 uiFrame = 0; uiFrame < uiNumFrames; ++uiFrame)
+    {
+      const ezTime tStart = ezTime::Now();
+
+      for (ezUInt32 i = 0; i < uiNumRays; ++i)
+      {
+        hits[i] = pModule->Raycast(results[i], rays[i].m_vStart, rays[i].m_vDir, rays[i].m_fDistance, params);
+      }
+
+      tSingle += ezTime::Now() - tStart;
+    }
+
+    ezTime tBatch;
+    for (ezUInt32 uiFrame = 0; uiFrame < uiNumFrames; ++uiFrame)
+    {
+      const ezTime tStart = ezTime::Now();
+
+      pModule->RaycastBatch(rays, results, hits, params);
+
+      tBatch += ezTime::Now() - tStart;
+    }
+
+    ezTestFramework::Output(ezTestOutput::Duration, "%u rays per frame, single: %.2fms, batched: %.2fms", uiNumRays,
+      tSingle.GetMilliseconds() / uiNumFrames, tBatch.GetMilliseconds() / uiNumFrames);
+  }
+}
+
+#endif
@@ -0,0 +1,257 @@
+#include <GameEngineTest/GameEngineTestPCH.h>
+
+#include <Foundation/CodeUtils/Expression/ExpressionByteCode.h>
+#include <Foundation/IO/MemoryStream.h>
+#include <ProcGenPlugin/Components/Implementation/PlacementCache.h>
+#include <ProcGenPlugin/Components/VolumeCollection.h>
+#include <ProcGenPlugin/Tasks/PlacementData.h>
+
+namespace
+{
+  using namespace ezProcGenInternal;
+
+  using TransformArray = ezDynamicArray<PlacementTransform, ezAlignedAllocatorWrapper>;
+
+  void CreateTransforms(ezUInt32 uiCount, ezUInt32 uiSeed, TransformArray& out_Transforms)
+  {
+    out_Transforms.Clear();
+
+    for (ezUInt32 i = 0; i < uiCount; ++i)
+    {
+      PlacementTransform& transform = out_Transforms.ExpandAndGetRef();
+      ezMemoryUtils::ZeroFill(&transform, 1);
+      transform.m_Transform = ezSimdTransform(ezSimdVec4f((float)i, (float)uiSeed, 0.0f));
+      transform.m_uiObjectIndex = static_cast<ezUInt8>(uiSeed);
+      transform.m_uiPointIndex = static_cast<ezUInt16>(i);
+    }
+  }
+
+  bool IsCached(PlacementCache& cache, ezUInt64 uiKey, ezUInt32 uiExpectedCount, ezUInt32 uiExpectedSeed)
+  {
+    TransformArray transforms;
+    if (!cache.Lookup(uiKey, transforms))
+      return false;
+
+    TransformArray expected;
+    CreateTransforms(uiExpectedCount, uiExpectedSeed, expected);
+
+    return transforms.GetCount() == expected.GetCount() &&
+           ezMemoryUtils::IsEqual(reinterpret_cast<const ezUInt8*>(transforms.GetData()), reinterpret_cast<const ezUInt8*>(expected.GetData()),
+             expected.GetCount() * sizeof(PlacementTransform));
+  }
+
+  void InitPlacementData(const ezSharedPtr<const PlacementOutput>& pOutput, PlacementData& out_Data)
+  {
+    out_Data.Clear();
+    out_Data.m_pOutput = pOutput;
+    out_Data.m_iTileSeed = 42;
+    out_Data.m_TileBoundingBox = ezBoundingBox(ezVec3(0, 0, -10), ezVec3(16, 16, 10));
+
+    ezVolumeCollection& volumes = out_Data.m_VolumeCollections.ExpandAndGetRef();
+    volumes.AddSphere(ezSimdTransform(ezSimdVec4f(8, 8, 0)), 4.0f, ezProcGenBlendMode::Set, 0.0f, 1.0f, 0.5f);
+  }
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST_GROUP(ProcGen);
+
+EZ_CREATE_SIMPLE_TEST(ProcGen, PlacementCache)
+{
+  TransformArray transforms;
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Store and Lookup")
+  {
+    PlacementCache cache;
+
+    CreateTransforms(10, 1, transforms);
+    cache.Store(1, transforms);
+
+    EZ_TEST_INT(cache.GetCount(), 1);
+    EZ_TEST_BOOL(IsCached(cache, 1, 10, 1));
+    EZ_TEST_BOOL(!IsCached(cache, 2, 10, 1));
+
+    // storing the same key again replaces the previous result
+    const ezUInt64 uiUsage = cache.GetMemoryUsage();
+    CreateTransforms(20, 2, transforms);
+    cache.Store(1, transforms);
+
+    EZ_TEST_INT(cache.GetCount(), 1);
+    EZ_TEST_BOOL(IsCached(cache, 1, 20, 2));
+    EZ_TEST_INT(cache.GetMemoryUsage(), uiUsage + 10 * sizeof(PlacementTransform));
+
+    cache.Clear();
+    EZ_TEST_INT(cache.GetCount(), 0);
+    EZ_TEST_INT(cache.GetMemoryUsage(), 0);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "LRU Eviction")
+  {
+    PlacementCache cache;
+
+    CreateTransforms(10, 1, transforms);
+    cache.Store(1, transforms);
+    const ezUInt64 uiEntryUsage = cache.GetMemoryUsage();
+
+    // room for exactly three entries of the same size
+    cache.SetMemoryBudget(uiEntryUsage * 3);
+
+    CreateTransforms(10, 2, transforms);
+    cache.Store(2, transforms);
+    CreateTransforms(10, 3, transforms);
+    cache.Store(3, transforms);
+    EZ_TEST_INT(cache.GetCount(), 3);
+
+    // the lookup makes key 1 the most recently used entry, so key 2 is the oldest now
+    EZ_TEST_BOOL(IsCached(cache, 1, 10, 1));
+
+    CreateTransforms(10, 4, transforms);
+    cache.Store(4, transforms);
+
+    EZ_TEST_INT(cache.GetCount(), 3);
+    EZ_TEST_BOOL(!IsCached(cache, 2, 10, 2));
+    EZ_TEST_BOOL(IsCached(cache, 3, 10, 3));
+    EZ_TEST_BOOL(IsCached(cache, 1, 10, 1));
+    EZ_TEST_BOOL(IsCached(cache, 4, 10, 4));
+
+    // 4 is the most recently used entry now, 3 is the oldest
+    CreateTransforms(10, 5, transforms);
+    cache.Store(5, transforms);
+    EZ_TEST_BOOL(!IsCached(cache, 3, 10, 3));
+    EZ_TEST_BOOL(IsCached(cache, 5, 10, 5));
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Memory Budget")
+  {
+    PlacementCache cache;
+    cache.SetMemoryBudget(64 * 1024);
+
+    for (ezUInt32 i = 1; i <= 100; ++i)
+    {
+      CreateTransforms(i, i, transforms);
+      cache.Store(i, transforms);
+
+      EZ_TEST_BOOL(cache.GetMemoryUsage() <= cache.GetMemoryBudget());
+    }
+
+    // the most recent entry always survives, the oldest ones are gone
+    EZ_TEST_BOOL(IsCached(cache, 100, 100, 100));
+    EZ_TEST_BOOL(!IsCached(cache, 1, 1, 1));
+
+    // a result that is larger than the whole budget is not kept
+    CreateTransforms(64 * 1024 / sizeof(PlacementTransform) + 1, 1, transforms);
+    cache.Store(1000, transforms);
+    EZ_TEST_BOOL(!IsCached(cache, 1000, transforms.GetCount(), 1));
+    EZ_TEST_BOOL(cache.GetMemoryUsage() <= cache.GetMemoryBudget());
+
+    // reducing the budget evicts immediately
+    cache.SetMemoryBudget(0);
+    EZ_TEST_INT(cache.GetCount(), 0);
+    EZ_TEST_INT(cache.GetMemoryUsage(), 0);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Save and Load")
+  {
+    PlacementCache cache;
+
+    for (ezUInt32 i = 1; i <= 5; ++i)
+    {
+      CreateTransforms(i * 3, i, transforms);
+      cache.Store(i, transforms);
+    }
+
+    // make key 1 the most recently used entry, the order has to survive the round-trip
+    EZ_TEST_BOOL(IsCached(cache, 1, 3, 1));
+
+    ezContiguousMemoryStreamStorage storage;
+    {
+      ezMemoryStreamWriter writer(&storage);
+      EZ_TEST_BOOL(cache.Save(writer).Succeeded());
+    }
+
+    PlacementCache loadedCache;
+    {
+      ezMemoryStreamReader reader(&storage);
+      EZ_TEST_BOOL(loadedCache.Load(reader).Succeeded());
+    }
+
+    EZ_TEST_INT(loadedCache.GetCount(), cache.GetCount());
+    EZ_TEST_INT(loadedCache.GetMemoryUsage(), cache.GetMemoryUsage());
+
+    // evicting a single entry has to remove the least recently used one, which is key 2
+    loadedCache.SetMemoryBudget(loadedCache.GetMemoryUsage() - 1);
+    EZ_TEST_INT(loadedCache.GetCount(), 4);
+    EZ_TEST_BOOL(!IsCached(loadedCache, 2, 6, 2));
+
+    for (ezUInt32 i : {1, 3, 4, 5})
+    {
+      EZ_TEST_BOOL(IsCached(loadedCache, i, i * 3, i));
+    }
+
+    // truncated data fails and leaves an empty cache behind
+    {
+      ezRawMemoryStreamReader reader(storage.GetData(), storage.GetStorageSize64() - 8);
+      EZ_TEST_BOOL(loadedCache.Load(reader).Failed());
+      EZ_TEST_INT(loadedCache.GetCount(), 0);
+      EZ_TEST_INT(loadedCache.GetMemoryUsage(), 0);
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Key Stability")
+  {
+    ezSharedPtr<PlacementOutput> pOutput = EZ_DEFAULT_NEW(PlacementOutput);
+    pOutput->m_uiContentHash = 0x1234;
+
+    PlacementData data;
+    InitPlacementData(pOutput, data);
+    const ezUInt64 uiKey = PlacementCache::ComputeKey(data);
+    EZ_TEST_BOOL(uiKey != 0);
+
+    // the same input always produces the same key
+    {
+      PlacementData data2;
+      InitPlacementData(pOutput, data2);
+      EZ_TEST_BOOL(PlacementCache::ComputeKey(data2) == uiKey);
+    }
+
+    // any change of the input produces a different key
+    {
+      PlacementData data2;
+      InitPlacementData(pOutput, data2);
+      data2.m_iTileSeed = 43;
+      EZ_TEST_BOOL(PlacementCache::ComputeKey(data2) != uiKey);
+    }
+
+    {
+      PlacementData data2;
+      InitPlacementData(pOutput, data2);
+      data2.m_TileBoundingBox.Translate(ezVec3(16, 0, 0));
+      EZ_TEST_BOOL(PlacementCache::ComputeKey(data2) != uiKey);
+    }
+
+    {
+      PlacementData data2;
+      InitPlacementData(pOutput, data2);
+      data2.m_VolumeCollections[0].AddBox(ezSimdTransform::IdentityTransform(), ezVec3(2.0f), ezProcGenBlendMode::Add, 0.0f, 1.0f, ezVec3(0.5f));
+      EZ_TEST_BOOL(PlacementCache::ComputeKey(data2) != uiKey);
+    }
+
+    {
+      PlacementData data2;
+      InitPlacementData(pOutput, data2);
+      data2.m_GlobalToLocalBoxTransforms.PushBack(ezSimdMat4f::IdentityMatrix());
+      EZ_TEST_BOOL(PlacementCache::ComputeKey(data2) != uiKey);
+    }
+
+    {
+      ezSharedPtr<PlacementOutput> pOtherOutput = EZ_DEFAULT_NEW(PlacementOutput);
+      pOtherOutput->m_uiContentHash = 0x5678;
+
+      PlacementData data2;
+      InitPlacementData(pOtherOutput, data2);
+      EZ_TEST_BOOL(PlacementCache::ComputeKey(data2) != uiKey);
+
+      // outputs without a content hash can't be cached
+      pOtherOutput->m_uiContentHash = 0;
+      EZ_TEST_INT(PlacementCache::ComputeKey(data2), 0);
+    }
+  }
+}
@@ -0,0 +1,133 @@
+#include <GameEngineTest/GameEngineTestPCH.h>
+
+#include <Foundation/Time/Stopwatch.h>
+#include <GameEngine/Terrain/HeightfieldComponent.h>
+#include <RendererCore/Meshes/MeshResourceDescriptor.h>
+#include <Texture/Image/Image.h>
+
+EZ_CREATE_SIMPLE_TEST_GROUP(Terrain);
+
+namespace
+{
+  void CreateHeightmap(ezUInt32 uiSize, ezImage& out_Heightmap)
+  {
+    ezImageHeader header;
+    header.SetImageFormat(ezImageFormat::R32G32B32A32_FLOAT);
+    header.SetWidth(uiSize);
+    header.SetHeight(uiSize);
+    out_Heightmap.ResetAndAlloc(header);
+
+    ezColor* pPixels = out_Heightmap.GetPixelPointer<ezColor>();
+
+    for (ezUInt32 y = 0; y < uiSize; ++y)
+    {
+      for (ezUInt32 x = 0; x < uiSize; ++x)
+      {
+        const float fX = (float)x / uiSize;
+        const float fY = (float)y / uiSize;
+        const float fHeight = 0.5f + 0.25f * ezMath::Sin(ezAngle::Radian(fX * 20.0f)) * ezMath::Cos(ezAngle::Radian(fY * 13.0f));
+
+        pPixels[y * uiSize + x] = ezColor(fHeight, fHeight, fHeight, 1.0f);
+      }
+    }
+  }
+
+  ezUInt32 BuildAllChunkMeshes(const ezImage& heightmap, const ezHeightfieldMeshSettings& settings, ezUInt32 uiLod)
+  {
+    const ezVec2U32 vNumChunks = settings.GetNumChunks();
+
+    ezUInt32 uiNumTriangles = 0;
+
+    for (ezUInt32 uiChunk = 0; uiChunk < vNumChunks.x * vNumChunks.y; ++uiChunk)
+    {
+      ezMeshResourceDescriptor desc;
+      settings.BuildChunkMesh(heightmap, uiChunk, uiLod, desc);
+
+      uiNumTriangles += desc.MeshBufferDesc().GetPrimitiveCount();
+    }
+
+    return uiNumTriangles;
+  }
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST(Terrain, Heightfield)
+{
+  ezImage heightmap;
+  CreateHeightmap(256, heightmap);
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Chunks and LODs")
+  {
+    ezHeightfieldMeshSettings settings;
+    settings.m_vTesselation = ezVec2U32(128);
+    settings.m_vNumChunks = ezVec2U32(4);
+    settings.m_uiNumLods = 4;
+
+    EZ_TEST_INT(settings.GetNumChunks().x, 4);
+    EZ_TEST_INT(settings.GetNumChunks().y, 4);
+    EZ_TEST_INT(settings.GetNumCellsPerChunk().x, 32);
+    EZ_TEST_INT(settings.GetNumLods(), 4);
+
+    // 4 chunks with 32 cells cover 128 cells, 48 chunk edges touch another chunk and have skirts
+    EZ_TEST_INT(BuildAllChunkMeshes(heightmap, settings, 0), 128 * 128 * 2 + 48 * 32 * 2);
+    EZ_TEST_INT(BuildAllChunkMeshes(heightmap, settings, 3), 16 * 16 * 2 + 48 * 4 * 2);
+
+    const ezBoundingBox totalBounds(ezVec3(-100.0f, -100.0f, -50.0f), ezVec3(100.0f, 100.0f, 0.0f));
+
+    for (ezUInt32 uiLod = 0; uiLod < settings.GetNumLods(); ++uiLod)
+    {
+      ezMeshResourceDescriptor desc;
+      settings.BuildChunkMesh(heightmap, 5, uiLod, desc);
+
+      const ezBoundingBox bounds = desc.GetBounds().GetBox();
+      EZ_TEST_BOOL(totalBounds.Contains(bounds));
+      EZ_TEST_FLOAT(bounds.GetHalfExtents().x, 25.0f, 0.001f);
+      EZ_TEST_FLOAT(bounds.GetHalfExtents().y, 25.0f, 0.001f);
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Uneven chunks")
+  {
+    ezHeightfieldMeshSettings settings;
+    settings.m_vTesselation = ezVec2U32(100, 10);
+    settings.m_vNumChunks = ezVec2U32(3);
+    settings.m_uiNumLods = 8;
+
+    // too few cells for 8 LODs, the coarsest LOD has at least two cells per chunk
+    EZ_TEST_INT(settings.GetNumLods(), 2);
+    EZ_TEST_INT(settings.GetNumCellsPerChunk().x, 34);
+    EZ_TEST_INT(settings.GetNumCellsPerChunk().y, 4);
+    EZ_TEST_INT(settings.GetNumChunks().x, 3);
+    EZ_TEST_INT(settings.GetNumChunks().y, 3);
+
+    for (ezUInt32 uiLod = 0; uiLod < settings.GetNumLods(); ++uiLod)
+    {
+      EZ_TEST_BOOL(BuildAllChunkMeshes(heightmap, settings, uiLod) > 0);
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Generation Performance")
+  {
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEBUG)
+    const ezUInt32 uiMaxTesselation = 512;
+#else
+    const ezUInt32 uiMaxTesselation = 2048;
+#endif
+
+    for (ezUInt32 uiTesselation = 256; uiTesselation <= uiMaxTesselation; uiTesselation *= 2)
+    {
+      ezHeightfieldMeshSettings settings;
+      settings.m_vTesselation = ezVec2U32(uiTesselation);
+      settings.m_vNumChunks = ezVec2U32(8);
+      settings.m_uiNumLods = 4;
+
+      for (ezUInt32 uiLod = 0; uiLod < settings.GetNumLods(); ++uiLod)
+      {
+        ezStopwatch sw;
+        const ezUInt32 uiNumTriangles = BuildAllChunkMeshes(heightmap, settings, uiLod);
+        const ezTime tDiff = sw.Checkpoint();
+
+        ezTestFramework::Output(ezTestOutput::Duration, "Tesselation %u, LOD %u: %u triangles in %.2fms", uiTesselation, uiLod, uiNumTriangles, tDiff.GetMilliseconds());
+      }
+    }
+  }
+}
@@ -0,0 +1,40 @@
+#include <GameEngineTest/GameEngineTestPCH.h>
+
+#include "SyntheticGeometry.h"
+
+namespace ezSyntheticGeometry
+{
+  void AddQuad(ezDynamicArray<ezVec3>& inout_Vertices, ezDynamicArray<ezUInt32>& inout_Indices, const ezVec3& v0, const ezVec3& v1,
+    const ezVec3& v2, const ezVec3& v3)
+  {
+    const ezUInt32 uiFirst = inout_Vertices.GetCount();
+    inout_Vertices.PushBack(v0);
+    inout_Vertices.PushBack(v1);
+    inout_Vertices.PushBack(v2);
+    inout_Vertices.PushBack(v3);
+
+    inout_Indices.PushBack(uiFirst + 0);
+    inout_Indices.PushBack(uiFirst + 1);
+    inout_Indices.PushBack(uiFirst + 2);
+    inout_Indices.PushBack(uiFirst + 0);
+    inout_Indices.PushBack(uiFirst + 2);
+    inout_Indices.PushBack(uiFirst + 3);
+  }
+
+  void AddBox(ezDynamicArray<ezVec3>& inout_Vertices, ezDynamicArray<ezUInt32>& inout_Indices, const ezVec3& vMin, const ezVec3& vMax)
+  {
+    // top
+    AddQuad(inout_Vertices, inout_Indices, ezVec3(vMin.x, vMin.y, vMax.z), ezVec3(vMax.x, vMin.y, vMax.z), ezVec3(vMax.x, vMax.y, vMax.z),
+      ezVec3(vMin.x, vMax.y, vMax.z));
+
+    // sides (only used as obstacles, so their winding does not matter)
+    AddQuad(inout_Vertices, inout_Indices, ezVec3(vMin.x, vMin.y, vMin.z), ezVec3(vMax.x, vMin.y, vMin.z), ezVec3(vMax.x, vMin.y, vMax.z),
+      ezVec3(vMin.x, vMin.y, vMax.z));
+    AddQuad(inout_Vertices, inout_Indices, ezVec3(vMin.x, vMax.y, vMin.z), ezVec3(vMax.x, vMax.y, vMin.z), ezVec3(vMax.x, vMax.y, vMax.z),
+      ezVec3(vMin.x, vMax.y, vMax.z));
+    AddQuad(inout_Vertices, inout_Indices, ezVec3(vMin.x, vMin.y, vMin.z), ezVec3(vMin.x, vMax.y, vMin.z), ezVec3(vMin.x, vMax.y, vMax.z),
+      ezVec3(vMin.x, vMin.y, vMax.z));
+    AddQuad(inout_Vertices, inout_Indices, ezVec3(vMax.x, vMin.y, vMin.z), ezVec3(vMax.x, vMax.y, vMin.z), ezVec3(vMax.x, vMax.y, vMax.z),
+      ezVec3(vMax.x, vMin.y, vMax.z));
+  }
+} // namespace ezSyntheticGeometry
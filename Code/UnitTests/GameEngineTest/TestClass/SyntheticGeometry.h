@@ -0,0 +1,15 @@
+#pragma once
+
+#include <Foundation/Containers/DynamicArray.h>
+#include <Foundation/Math/Vec3.h>
+
+/// \brief Helpers to build simple triangle soups for tests, e.g. as input for navmesh generation or ray tracing.
+namespace ezSyntheticGeometry
+{
+  /// \brief Adds the quad v0, v1, v2, v3 as the two triangles (v0, v1, v2) and (v0, v2, v3).
+  void AddQuad(ezDynamicArray<ezVec3>& inout_Vertices, ezDynamicArray<ezUInt32>& inout_Indices, const ezVec3& v0, const ezVec3& v1,
+    const ezVec3& v2, const ezVec3& v3);
+
+  /// \brief Adds the top and the four sides of an axis aligned box. The bottom is left out, the boxes are meant to stand on the ground.
+  void AddBox(ezDynamicArray<ezVec3>& inout_Vertices, ezDynamicArray<ezUInt32>& inout_Indices, const ezVec3& vMin, const ezVec3& vMax);
+} // namespace ezSyntheticGeometry